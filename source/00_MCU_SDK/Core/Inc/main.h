@@ -60,11 +60,22 @@ struct hal_capture_tim_ifc
   uint32_t engaged_channels;
 };
 
+struct hal_iic_bus_pins
+{
+  GPIO_TypeDef* const scl_port;
+  uint16_t scl_pin;
+  GPIO_TypeDef* const sda_port;
+  uint16_t sda_pin;
+};
+
 /* USER CODE END EFP */
 
 /* Private defines -----------------------------------------------------------*/
 #define LED_Pin GPIO_PIN_13
 #define LED_GPIO_Port GPIOC
+#define BARO_INT_Pin GPIO_PIN_0
+#define BARO_INT_GPIO_Port GPIOB
+#define BARO_INT_EXTI_IRQn EXTI0_IRQn
 #define GPS_TX_Pin GPIO_PIN_2
 #define GPS_TX_GPIO_Port GPIOA
 #define GPS_RX_Pin GPIO_PIN_3
@@ -77,12 +88,17 @@ struct hal_capture_tim_ifc
 #define ESP_TX_GPIO_Port GPIOA
 #define ESP_RX_Pin GPIO_PIN_12
 #define ESP_RX_GPIO_Port GPIOA
+#define IIC1_SCL_Pin GPIO_PIN_8
+#define IIC1_SCL_GPIO_Port GPIOB
+#define IIC1_SDA_Pin GPIO_PIN_9
+#define IIC1_SDA_GPIO_Port GPIOB
 
 /* USER CODE BEGIN Private defines */
 
 size_t get_uart_ifcs(UART_HandleTypeDef* const * * const uart_ifcs_buffer);
 size_t get_gpio_pins(GPIO_TypeDef* const ** const port, uint16_t const ** pin);
 size_t get_iic_ifcs(I2C_HandleTypeDef* const ** const iic_ifcs_buffer);
+size_t get_iic_bus_pins(struct hal_iic_bus_pins const ** iic_bus_pins);
 void get_base_tim_ifc(TIM_HandleTypeDef * *hw_inst);
 size_t get_ic_tim_ifcs(struct hal_capture_tim_ifc ** hw_tim_ifcs);
 
@@ -81,7 +81,7 @@ static void MX_USART6_UART_Init(void);
 /* Private user code ---------------------------------------------------------*/
 /* USER CODE BEGIN 0 */
 
-static UART_HandleTypeDef *const l_uart_ifcs[] = {&huart1, &huart6};
+static UART_HandleTypeDef *const l_uart_ifcs[] = {&huart1, &huart6, &huart2};
 size_t get_uart_ifcs(UART_HandleTypeDef *const **const uart_ifcs_buffer)
 {
   *uart_ifcs_buffer = l_uart_ifcs;
@@ -97,8 +97,20 @@ size_t get_iic_ifcs(I2C_HandleTypeDef *const **const iic_ifcs_buffer)
   return ARRAY_SIZE(l_iic_ifcs);
 }
 
-static GPIO_TypeDef *const l_hw_ports[] = {LED_GPIO_Port};
-static uint16_t const l_hw_pins[] = {LED_Pin};
+/* Same order as l_iic_ifcs, used to clock out a stuck bus */
+static struct hal_iic_bus_pins const l_iic_bus_pins[] = {
+    {IIC1_SCL_GPIO_Port, IIC1_SCL_Pin, IIC1_SDA_GPIO_Port, IIC1_SDA_Pin}};
+size_t get_iic_bus_pins(struct hal_iic_bus_pins const **iic_bus_pins)
+{
+  ARRAY_EQUAL_LENGTHS(l_iic_ifcs, l_iic_bus_pins);
+
+  *iic_bus_pins = l_iic_bus_pins;
+
+  return ARRAY_SIZE(l_iic_bus_pins);
+}
+
+static GPIO_TypeDef *const l_hw_ports[] = {LED_GPIO_Port, BARO_INT_GPIO_Port};
+static uint16_t const l_hw_pins[] = {LED_Pin, BARO_INT_Pin};
 size_t get_gpio_pins(GPIO_TypeDef *const **const port, uint16_t const **pin)
 {
   ARRAY_EQUAL_LENGTHS(l_hw_ports, l_hw_pins);
@@ -673,11 +685,11 @@ static void MX_GPIO_Init(void)
   GPIO_InitStruct.Pull = GPIO_NOPULL;
   HAL_GPIO_Init(GPIOA, &GPIO_InitStruct);
 
-  /*Configure GPIO pin : PB0 */
-  GPIO_InitStruct.Pin = GPIO_PIN_0;
-  GPIO_InitStruct.Mode = GPIO_MODE_IT_RISING_FALLING;
+  /*Configure GPIO pin : BARO_INT_Pin */
+  GPIO_InitStruct.Pin = BARO_INT_Pin;
+  GPIO_InitStruct.Mode = GPIO_MODE_IT_RISING;
   GPIO_InitStruct.Pull = GPIO_PULLDOWN;
-  HAL_GPIO_Init(GPIOB, &GPIO_InitStruct);
+  HAL_GPIO_Init(BARO_INT_GPIO_Port, &GPIO_InitStruct);
 
   /*Configure GPIO pins : PB2 PB10 PB12 PB13
                            PB14 PB15 PB7 */
@@ -687,6 +699,10 @@ static void MX_GPIO_Init(void)
   GPIO_InitStruct.Pull = GPIO_NOPULL;
   HAL_GPIO_Init(GPIOB, &GPIO_InitStruct);
 
+  /* EXTI interrupt init*/
+  HAL_NVIC_SetPriority(EXTI0_IRQn, 3, 0);
+  HAL_NVIC_EnableIRQ(EXTI0_IRQn);
+
   /* USER CODE BEGIN MX_GPIO_Init_2 */
   /* USER CODE END MX_GPIO_Init_2 */
 }
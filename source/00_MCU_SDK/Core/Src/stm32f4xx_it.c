@@ -22,6 +22,8 @@
 #include "stm32f4xx_it.h"
 /* Private includes ----------------------------------------------------------*/
 /* USER CODE BEGIN Includes */
+#include "su_profiler/su_profiler.h"
+#include "su_trace/su_trace.h"
 /* USER CODE END Includes */
 
 /* Private typedef -----------------------------------------------------------*/
@@ -64,6 +66,7 @@ extern DMA_HandleTypeDef hdma_usart2_rx;
 extern DMA_HandleTypeDef hdma_usart6_rx;
 extern DMA_HandleTypeDef hdma_usart6_tx;
 extern UART_HandleTypeDef huart1;
+extern UART_HandleTypeDef huart2;
 extern UART_HandleTypeDef huart6;
 /* USER CODE BEGIN EV */
 
@@ -93,7 +96,8 @@ void NMI_Handler(void)
 void HardFault_Handler(void)
 {
   /* USER CODE BEGIN HardFault_IRQn 0 */
-
+  SU_TRACE(SU_TRACE_FAULT, 0U);
+  su_trace_freeze(); // Kept over a warm reset and sent after the next boot
   /* USER CODE END HardFault_IRQn 0 */
   while (1)
   {
@@ -207,6 +211,22 @@ void SysTick_Handler(void)
 /* please refer to the startup file (startup_stm32f4xx.s).                    */
 /******************************************************************************/
 
+/**
+  * @brief This function handles EXTI line0 interrupt.
+  */
+void EXTI0_IRQHandler(void)
+{
+  /* USER CODE BEGIN EXTI0_IRQn 0 */
+  SU_TRACE(SU_TRACE_ISR_ENTER, EXTI0_IRQn);
+  SU_PROF_ENTER(SU_PROF_ISR_EXTI0);
+  /* USER CODE END EXTI0_IRQn 0 */
+  HAL_GPIO_EXTI_IRQHandler(BARO_INT_Pin);
+  /* USER CODE BEGIN EXTI0_IRQn 1 */
+  SU_PROF_EXIT(SU_PROF_ISR_EXTI0);
+  SU_TRACE(SU_TRACE_ISR_EXIT, EXTI0_IRQn);
+  /* USER CODE END EXTI0_IRQn 1 */
+}
+
 /**
   * @brief This function handles DMA1 stream5 global interrupt.
   */
@@ -227,11 +247,13 @@ void DMA1_Stream5_IRQHandler(void)
 void TIM2_IRQHandler(void)
 {
   /* USER CODE BEGIN TIM2_IRQn 0 */
-
+  SU_TRACE(SU_TRACE_ISR_ENTER, TIM2_IRQn);
+  SU_PROF_ENTER(SU_PROF_ISR_TIM2);
   /* USER CODE END TIM2_IRQn 0 */
   HAL_TIM_IRQHandler(&htim2);
   /* USER CODE BEGIN TIM2_IRQn 1 */
-
+  SU_PROF_EXIT(SU_PROF_ISR_TIM2);
+  SU_TRACE(SU_TRACE_ISR_EXIT, TIM2_IRQn);
   /* USER CODE END TIM2_IRQn 1 */
 }
 
@@ -277,6 +299,20 @@ void USART1_IRQHandler(void)
   /* USER CODE END USART1_IRQn 1 */
 }
 
+/**
+  * @brief This function handles USART2 global interrupt.
+  */
+void USART2_IRQHandler(void)
+{
+  /* USER CODE BEGIN USART2_IRQn 0 */
+
+  /* USER CODE END USART2_IRQn 0 */
+  HAL_UART_IRQHandler(&huart2);
+  /* USER CODE BEGIN USART2_IRQn 1 */
+
+  /* USER CODE END USART2_IRQn 1 */
+}
+
 /**
   * @brief This function handles DMA2 stream1 global interrupt.
   */
@@ -325,11 +361,13 @@ void DMA2_Stream6_IRQHandler(void)
 void DMA2_Stream7_IRQHandler(void)
 {
   /* USER CODE BEGIN DMA2_Stream7_IRQn 0 */
-
+  SU_TRACE(SU_TRACE_ISR_ENTER, DMA2_Stream7_IRQn);
+  SU_PROF_ENTER(SU_PROF_ISR_DMA2_S7);
   /* USER CODE END DMA2_Stream7_IRQn 0 */
   HAL_DMA_IRQHandler(&hdma_usart1_tx);
   /* USER CODE BEGIN DMA2_Stream7_IRQn 1 */
-
+  SU_PROF_EXIT(SU_PROF_ISR_DMA2_S7);
+  SU_TRACE(SU_TRACE_ISR_EXIT, DMA2_Stream7_IRQn);
   /* USER CODE END DMA2_Stream7_IRQn 1 */
 }
 
@@ -0,0 +1,816 @@
+#include "mp_host_bmp388.h"
+
+#include "math.h"
+#include "mp_host_clock/mp_host_clock.h"
+#include "mp_host_gpio/mp_host_gpio.h"
+#include "string.h"
+
+/* Register map of the datasheet, kept apart from the driver definitions so
+   the model checks the driver instead of sharing its mistakes */
+#define REG_CHIP_ID      (0x00U)
+#define REG_ERR          (0x02U)
+#define REG_STATUS       (0x03U)
+#define REG_DATA_PRES    (0x04U)
+#define REG_DATA_TEMP    (0x07U)
+#define REG_SENS_TIME    (0x0CU)
+#define REG_EVENT        (0x10U)
+#define REG_INT_STATUS   (0x11U)
+#define REG_FIFO_LENGTH  (0x12U)
+#define REG_FIFO_DATA    (0x14U)
+#define REG_FIFO_WM      (0x15U)
+#define REG_FIFO_CONFIG1 (0x17U)
+#define REG_FIFO_CONFIG2 (0x18U)
+#define REG_INT_CTRL     (0x19U)
+#define REG_IF_CONF      (0x1AU)
+#define REG_PWR_CTRL     (0x1BU)
+#define REG_OSR          (0x1CU)
+#define REG_ODR          (0x1DU)
+#define REG_CONFIG       (0x1FU)
+#define REG_CALIB        (0x31U)
+#define REG_CMD          (0x7EU)
+#define REG_CNT          (0x80U)
+
+#define CHIP_ID          (0x50U)
+#define ERR_CMD          (0x02U)
+#define ERR_CONF         (0x04U)
+#define STATUS_CMD_RDY   (0x10U)
+#define STATUS_DRDY_PRES (0x20U)
+#define STATUS_DRDY_TEMP (0x40U)
+#define INT_FWM          (0x01U)
+#define INT_FFULL        (0x02U)
+#define INT_DRDY         (0x08U)
+#define INT_CTRL_LEVEL   (0x02U)
+#define INT_CTRL_LATCH   (0x04U)
+#define PWR_PRES_EN      (0x01U)
+#define PWR_TEMP_EN      (0x02U)
+#define PWR_MODE_MSK     (0x30U)
+#define PWR_MODE_NORMAL  (0x30U)
+#define FIFO_MODE        (0x01U)
+#define FIFO_STOP_FULL   (0x02U)
+#define FIFO_TIME_EN     (0x04U)
+#define FIFO_PRES_EN     (0x08U)
+#define FIFO_TEMP_EN     (0x10U)
+#define FIFO_FILTERED    (0x08U)
+#define ODR_MAX          (17U)
+
+#define CMD_FIFO_FLUSH   (0xB0U)
+#define CMD_SOFT_RESET   (0xB6U)
+#define CMD_EXT_MODE_EN  (0x34U)
+
+#define FIFO_SIZE        (512U)
+#define FIFO_FRAME_MAX   (7U)
+#define FRAME_PRES_TEMP  (0x94U)
+#define FRAME_TEMP       (0x90U)
+#define FRAME_PRES       (0x84U)
+#define FRAME_TIME       (0xA0U)
+#define FRAME_EMPTY      (0x80U)
+
+/// Start-up time after a power on or a soft reset, the sensor does not acknowledge meanwhile
+#define BOOT_NS          (2000000U)
+/// Period of the 24 bit sensor time counter
+#define TIME_TICK_NS     (39062.5)
+/// Conversion time terms of the datasheet
+#define CONV_BASE_US     (234U)
+#define CONV_PRES_US     (392U)
+#define CONV_TEMP_US     (163U)
+#define CONV_OSR_US      (2020U)
+/// Output data rate 0, the period doubles for each step
+#define ODR_BASE_NS      (5000000ULL)
+
+#define RAW_MAX          (0xFFFFFFU)
+#define NEWTON_STEPS     (6U)
+
+/// Calibration NVM of a sensor, t1 t2 t3 p1 p2 p3 p4 p5 p6 p7 p8 p9 p10 p11 little endian
+static const uint8_t g_nvm[21] = { 0x48U, 0x6BU, 0xFFU, 0x4AU, 0xF9U, 0x3CU, 0xFBU,
+                                   0xFFU, 0xF2U, 0x23U, 0x01U, 0xF6U, 0x60U, 0xA7U,
+                                   0x76U, 0x03U, 0xFCU, 0x9CU, 0x0FU, 0x0CU, 0xD9U };
+
+typedef struct
+{
+    double t1, t2, t3;
+    double p1, p2, p3, p4, p5, p6, p7, p8, p9, p10, p11;
+} host_bmp388_calib_t;
+
+typedef struct
+{
+    bool_t                        is_attached;
+    uint8_t                       port;
+    uint8_t                       dev_addr;
+    gpio_pins_t                   int_pin;
+    uint8_t                       regs[REG_CNT];
+    uint8_t                       ptr; // Register pointer of the plain transfers
+    uint64_t                      power_on_ns;
+    uint64_t                      boot_end_ns;
+    uint64_t                      conv_start_ns;
+    mp_host_event_t               conv_event;
+    mp_host_event_t               int_event;
+    double                        iir_pres; // Filtered raw values, negative before the first
+    double                        iir_temp;
+    uint32_t                      raw_pres; // Unfiltered raw values of the last conversion
+    uint32_t                      raw_temp;
+    uint8_t                       fifo[FIFO_SIZE];
+    uint32_t                      fifo_len;
+    uint32_t                      fifo_skip; // Conversions left before the next subsampled frame
+    bool_t                        is_time_frame_sent;
+    host_bmp388_calib_t           calib;
+    const mp_host_bmp388_point_t* pt_profile;
+    size_t                        profile_cnt;
+    mp_host_bmp388_stats_t        stats;
+} host_bmp388_t;
+
+static host_bmp388_t g_bmp;
+
+static void decode_calib(host_bmp388_calib_t* ppt_calib)
+{
+    const uint8_t* pt_nvm = g_nvm;
+
+    ppt_calib->t1  = (double)(uint16_t)(pt_nvm[0] | (pt_nvm[1] << 8)) * 256.0;
+    ppt_calib->t2  = (double)(uint16_t)(pt_nvm[2] | (pt_nvm[3] << 8)) / 1073741824.0;
+    ppt_calib->t3  = (double)(int8_t)pt_nvm[4] / 281474976710656.0;
+    ppt_calib->p1  = ((double)(int16_t)(pt_nvm[5] | (pt_nvm[6] << 8)) - 16384.0) / 1048576.0;
+    ppt_calib->p2  = ((double)(int16_t)(pt_nvm[7] | (pt_nvm[8] << 8)) - 16384.0) / 536870912.0;
+    ppt_calib->p3  = (double)(int8_t)pt_nvm[9] / 4294967296.0;
+    ppt_calib->p4  = (double)(int8_t)pt_nvm[10] / 137438953472.0;
+    ppt_calib->p5  = (double)(uint16_t)(pt_nvm[11] | (pt_nvm[12] << 8)) * 8.0;
+    ppt_calib->p6  = (double)(uint16_t)(pt_nvm[13] | (pt_nvm[14] << 8)) / 64.0;
+    ppt_calib->p7  = (double)(int8_t)pt_nvm[15] / 256.0;
+    ppt_calib->p8  = (double)(int8_t)pt_nvm[16] / 32768.0;
+    ppt_calib->p9  = (double)(int16_t)(pt_nvm[17] | (pt_nvm[18] << 8)) / 281474976710656.0;
+    ppt_calib->p10 = (double)(int8_t)pt_nvm[19] / 281474976710656.0;
+    ppt_calib->p11 = (double)(int8_t)pt_nvm[20] / 36893488147419103232.0;
+}
+
+static double compensate_temp(double p_raw)
+{
+    double d = p_raw - g_bmp.calib.t1;
+
+    return (d * g_bmp.calib.t2) + (d * d * g_bmp.calib.t3);
+}
+
+/// Slope and offset of the pressure polynomial at a temperature, as the datasheet splits it
+static void pres_terms(double p_t, double* ppt_offset, double* ppt_sens)
+{
+    const host_bmp388_calib_t* pt_c = &g_bmp.calib;
+    double                     t2   = p_t * p_t;
+    double                     t3   = t2 * p_t;
+
+    *ppt_offset = pt_c->p5 + (pt_c->p6 * p_t) + (pt_c->p7 * t2) + (pt_c->p8 * t3);
+    *ppt_sens   = pt_c->p1 + (pt_c->p2 * p_t) + (pt_c->p3 * t2) + (pt_c->p4 * t3);
+}
+
+static uint32_t to_raw(double p_raw)
+{
+    if (p_raw < 0.0)
+    {
+        return 0U;
+    }
+
+    return (p_raw > (double)RAW_MAX) ? RAW_MAX : (uint32_t)lround(p_raw);
+}
+
+/**
+ * @brief This function inverts the compensation of the datasheet, the raw
+ * values a sensor with this NVM measures in the given air. Both polynomials
+ * are monotonic over the range, Newton converges in a few steps.
+ */
+static void air_to_raw(double p_pres_pa, double p_temp_c, uint32_t* ppt_raw_pres,
+                       uint32_t* ppt_raw_temp)
+{
+    const host_bmp388_calib_t* pt_c   = &g_bmp.calib;
+    double                     d      = p_temp_c / pt_c->t2;
+    double                     t_lin  = 0.0;
+    double                     offset = 0.0;
+    double                     sens   = 0.0;
+    double                     quad   = 0.0;
+    double                     raw    = 0.0;
+
+    for (uint32_t i = 0U; i < NEWTON_STEPS; i++)
+    {
+        d -= ((d * pt_c->t2) + (d * d * pt_c->t3) - p_temp_c) / (pt_c->t2 + (2.0 * d * pt_c->t3));
+    }
+    *ppt_raw_temp = to_raw(pt_c->t1 + d);
+
+    // The driver compensates the pressure with the temperature it gets from the rounded value
+    t_lin = compensate_temp((double)*ppt_raw_temp);
+    pres_terms(t_lin, &offset, &sens);
+    quad = pt_c->p9 + (pt_c->p10 * t_lin);
+    raw  = (p_pres_pa - offset) / sens;
+    for (uint32_t i = 0U; i < NEWTON_STEPS; i++)
+    {
+        double sq = raw * raw;
+        double f  = offset + (raw * sens) + (sq * quad) + (sq * raw * pt_c->p11) - p_pres_pa;
+        double df = sens + (2.0 * raw * quad) + (3.0 * sq * pt_c->p11);
+
+        raw -= f / df;
+    }
+    *ppt_raw_pres = to_raw(raw);
+}
+
+/// Pressure of the standard atmosphere at an altitude above the mean sea level
+float mp_host_bmp388_altitude_to_pa(float p_altitude_m)
+{
+    return (float)(101325.0 * pow(1.0 - (2.25577e-5 * (double)p_altitude_m), 5.25588));
+}
+
+/// Air at the sensor now, interpolated between the points of the profile
+static void get_air(double* ppt_pres_pa, double* ppt_temp_c)
+{
+    double now_ms = (double)mp_host_clock_now_ns() / 1e6;
+    double alt    = MP_HOST_BMP388_DEFAULT_ALT_M;
+    double temp   = MP_HOST_BMP388_DEFAULT_TEMP_C;
+
+    if (g_bmp.profile_cnt > 0U)
+    {
+        const mp_host_bmp388_point_t* pt_pts = g_bmp.pt_profile;
+        size_t                        i      = 0U;
+
+        while ((i < g_bmp.profile_cnt) && ((double)pt_pts[i].t_ms <= now_ms))
+        {
+            i++;
+        }
+        if (i == 0U)
+        {
+            alt  = pt_pts[0].altitude_m;
+            temp = pt_pts[0].temperature_c;
+        }
+        else if (i == g_bmp.profile_cnt)
+        {
+            alt  = pt_pts[i - 1U].altitude_m;
+            temp = pt_pts[i - 1U].temperature_c;
+        }
+        else
+        {
+            double k = (now_ms - (double)pt_pts[i - 1U].t_ms)
+                       / (double)(pt_pts[i].t_ms - pt_pts[i - 1U].t_ms);
+
+            const mp_host_bmp388_point_t* pt_from = &pt_pts[i - 1U];
+
+            alt  = pt_from->altitude_m + (k * (pt_pts[i].altitude_m - pt_from->altitude_m));
+            temp = pt_from->temperature_c
+                   + (k * (pt_pts[i].temperature_c - pt_from->temperature_c));
+        }
+    }
+
+    *ppt_pres_pa = (double)mp_host_bmp388_altitude_to_pa((float)alt);
+    *ppt_temp_c  = temp;
+}
+
+static uint64_t conv_ns(void)
+{
+    uint8_t  pwr = g_bmp.regs[REG_PWR_CTRL];
+    uint8_t  osr = g_bmp.regs[REG_OSR];
+    uint64_t us  = CONV_BASE_US;
+
+    if ((pwr & PWR_PRES_EN) != 0U)
+    {
+        us += CONV_PRES_US + ((uint64_t)CONV_OSR_US << (osr & 0x07U));
+    }
+    if ((pwr & PWR_TEMP_EN) != 0U)
+    {
+        us += CONV_TEMP_US + ((uint64_t)CONV_OSR_US << ((osr >> 3U) & 0x07U));
+    }
+
+    return us * 1000U;
+}
+
+/// The normal mode needs a valid rate that leaves the time for the conversion
+static bool_t is_config_valid(void)
+{
+    uint8_t odr = g_bmp.regs[REG_ODR] & 0x1FU;
+
+    return ((odr <= ODR_MAX) && (conv_ns() <= (ODR_BASE_NS << odr))) ? TRUE : FALSE;
+}
+
+static void set_int_pin(bool_t p_is_active)
+{
+    bool_t is_high = ((g_bmp.regs[REG_INT_CTRL] & INT_CTRL_LEVEL) != 0U) ? TRUE : FALSE;
+
+    if (g_bmp.int_pin < GP_PIN_CNT)
+    {
+        (void)mp_host_gpio_set_input(g_bmp.int_pin, (p_is_active == TRUE) ? is_high : !is_high);
+    }
+}
+
+static void int_pulse_end(void* ppt_ctx)
+{
+    UNUSED(ppt_ctx);
+
+    set_int_pin(FALSE);
+}
+
+/// Sets interrupt flags, the enabled ones drive the INT pin
+static void raise_int(uint8_t p_flags)
+{
+    // The enable bits of INT_CTRL are the status bits shifted by 3
+    uint8_t enabled = (uint8_t)(g_bmp.regs[REG_INT_CTRL] >> 3U) & (INT_FWM | INT_FFULL | INT_DRDY);
+
+    g_bmp.regs[REG_INT_STATUS] |= p_flags;
+    if ((p_flags & enabled) == 0U)
+    {
+        return;
+    }
+    set_int_pin(TRUE);
+    if ((g_bmp.regs[REG_INT_CTRL] & INT_CTRL_LATCH) == 0U)
+    {
+        mp_host_event_schedule(&g_bmp.int_event,
+                               mp_host_clock_now_ns() + MP_HOST_BMP388_INT_PULSE_NS);
+    }
+}
+
+static void put_raw(uint8_t* ppt_reg, uint32_t p_raw)
+{
+    ppt_reg[0] = (uint8_t)p_raw;
+    ppt_reg[1] = (uint8_t)(p_raw >> 8U);
+    ppt_reg[2] = (uint8_t)(p_raw >> 16U);
+}
+
+/// Drops the oldest frames until the given size fits
+static void fifo_make_room(uint32_t p_len)
+{
+    while ((g_bmp.fifo_len + p_len) > FIFO_SIZE)
+    {
+        uint8_t  header = g_bmp.fifo[0];
+        uint32_t frame  = (header == FRAME_PRES_TEMP) ? 7U : 4U;
+
+        memmove(g_bmp.fifo, &g_bmp.fifo[frame], g_bmp.fifo_len - frame);
+        g_bmp.fifo_len -= frame;
+        g_bmp.stats.fifo_drop_cnt++;
+    }
+}
+
+static void fifo_push(uint32_t p_raw_pres, uint32_t p_raw_temp)
+{
+    uint8_t  cfg   = g_bmp.regs[REG_FIFO_CONFIG1];
+    uint8_t  frame[FIFO_FRAME_MAX];
+    uint32_t len   = 1U;
+    uint32_t wm    = g_bmp.regs[REG_FIFO_WM] | ((g_bmp.regs[REG_FIFO_WM + 1U] & 0x01U) << 8U);
+    uint8_t  flags = 0U;
+
+    if (((cfg & FIFO_MODE) == 0U) || ((cfg & (FIFO_PRES_EN | FIFO_TEMP_EN)) == 0U))
+    {
+        return;
+    }
+    if (g_bmp.fifo_skip > 0U)
+    {
+        g_bmp.fifo_skip--;
+        return;
+    }
+    g_bmp.fifo_skip = (1U << (g_bmp.regs[REG_FIFO_CONFIG2] & 0x07U)) - 1U;
+
+    frame[0] = ((cfg & FIFO_PRES_EN) == 0U)   ? FRAME_TEMP
+               : ((cfg & FIFO_TEMP_EN) == 0U) ? FRAME_PRES
+                                              : FRAME_PRES_TEMP;
+    if ((cfg & FIFO_TEMP_EN) != 0U)
+    {
+        put_raw(&frame[len], p_raw_temp);
+        len += 3U;
+    }
+    if ((cfg & FIFO_PRES_EN) != 0U)
+    {
+        put_raw(&frame[len], p_raw_pres);
+        len += 3U;
+    }
+
+    if ((g_bmp.fifo_len + len) > FIFO_SIZE)
+    {
+        if ((cfg & FIFO_STOP_FULL) != 0U)
+        {
+            g_bmp.stats.fifo_drop_cnt++;
+            return;
+        }
+        fifo_make_room(len);
+    }
+    memcpy(&g_bmp.fifo[g_bmp.fifo_len], frame, len);
+    g_bmp.fifo_len           += len;
+    g_bmp.is_time_frame_sent  = FALSE;
+
+    if ((wm > 0U) && (g_bmp.fifo_len >= wm))
+    {
+        flags |= INT_FWM;
+    }
+    if ((g_bmp.fifo_len + FIFO_FRAME_MAX) > FIFO_SIZE)
+    {
+        flags |= INT_FFULL;
+    }
+    if (flags != 0U)
+    {
+        raise_int(flags);
+    }
+}
+
+static uint8_t fifo_pop(void)
+{
+    uint8_t byte = FRAME_EMPTY;
+
+    // A read past the last frame gets the sensor time once
+    if ((g_bmp.fifo_len == 0U) && ((g_bmp.regs[REG_FIFO_CONFIG1] & FIFO_TIME_EN) != 0U)
+        && (g_bmp.is_time_frame_sent == FALSE))
+    {
+        uint32_t ticks = (uint32_t)((double)(mp_host_clock_now_ns() - g_bmp.power_on_ns)
+                                    / TIME_TICK_NS);
+
+        g_bmp.fifo[0] = FRAME_TIME;
+        put_raw(&g_bmp.fifo[1], ticks & RAW_MAX);
+        g_bmp.fifo_len           = 4U;
+        g_bmp.is_time_frame_sent = TRUE;
+    }
+    if (g_bmp.fifo_len > 0U)
+    {
+        byte = g_bmp.fifo[0];
+        memmove(g_bmp.fifo, &g_bmp.fifo[1], g_bmp.fifo_len - 1U);
+        g_bmp.fifo_len--;
+        if ((byte == FRAME_PRES_TEMP) || (byte == FRAME_PRES) || (byte == FRAME_TEMP))
+        {
+            g_bmp.stats.sample_cnt++;
+        }
+    }
+
+    return byte;
+}
+
+static double iir(double p_state, uint32_t p_raw)
+{
+    double coeff = (double)((1U << ((g_bmp.regs[REG_CONFIG] >> 1U) & 0x07U)) - 1U);
+
+    // The filter starts from the first sample
+    if (p_state < 0.0)
+    {
+        return (double)p_raw;
+    }
+
+    return ((p_state * coeff) + (double)p_raw) / (coeff + 1.0);
+}
+
+/**
+ * @brief This function ends a conversion. The data registers get the
+ * filtered sample of the air at this time, the FIFO the filtered or the
+ * unfiltered one, and the next conversion of the normal mode is scheduled on
+ * the grid of the output data rate.
+ */
+static void conv_done(void* ppt_ctx)
+{
+    UNUSED(ppt_ctx);
+
+    uint8_t* pt_regs = g_bmp.regs;
+    uint8_t  pwr     = pt_regs[REG_PWR_CTRL];
+    bool_t   is_fifo = ((pt_regs[REG_FIFO_CONFIG1] & FIFO_MODE) != 0U) ? TRUE : FALSE;
+    double   pres    = 0.0;
+    double   temp    = 0.0;
+
+    get_air(&pres, &temp);
+    air_to_raw(pres, temp, &g_bmp.raw_pres, &g_bmp.raw_temp);
+    g_bmp.stats.conv_cnt++;
+
+    if ((pwr & PWR_TEMP_EN) != 0U)
+    {
+        g_bmp.iir_temp = iir(g_bmp.iir_temp, g_bmp.raw_temp);
+        put_raw(&pt_regs[REG_DATA_TEMP], to_raw(g_bmp.iir_temp));
+        pt_regs[REG_STATUS] |= STATUS_DRDY_TEMP;
+    }
+    if ((pwr & PWR_PRES_EN) != 0U)
+    {
+        if ((is_fifo == FALSE) && ((pt_regs[REG_STATUS] & STATUS_DRDY_PRES) != 0U))
+        {
+            g_bmp.stats.lost_cnt++;
+        }
+        g_bmp.iir_pres = iir(g_bmp.iir_pres, g_bmp.raw_pres);
+        put_raw(&pt_regs[REG_DATA_PRES], to_raw(g_bmp.iir_pres));
+        pt_regs[REG_STATUS] |= STATUS_DRDY_PRES;
+    }
+
+    if ((pt_regs[REG_FIFO_CONFIG2] & FIFO_FILTERED) != 0U)
+    {
+        fifo_push(to_raw(g_bmp.iir_pres), to_raw(g_bmp.iir_temp));
+    }
+    else
+    {
+        fifo_push(g_bmp.raw_pres, g_bmp.raw_temp);
+    }
+    raise_int(INT_DRDY);
+
+    if ((pwr & PWR_MODE_MSK) == PWR_MODE_NORMAL)
+    {
+        g_bmp.conv_start_ns += ODR_BASE_NS << (pt_regs[REG_ODR] & 0x1FU);
+        mp_host_event_schedule(&g_bmp.conv_event, g_bmp.conv_start_ns + conv_ns());
+    }
+    else
+    {
+        // The forced mode goes back to sleep after its conversion
+        pt_regs[REG_PWR_CTRL] &= (uint8_t)~PWR_MODE_MSK;
+    }
+}
+
+static void reset_regs(void)
+{
+    memset(g_bmp.regs, 0, sizeof(g_bmp.regs));
+    g_bmp.regs[REG_CHIP_ID]          = CHIP_ID;
+    g_bmp.regs[REG_STATUS]           = STATUS_CMD_RDY;
+    g_bmp.regs[REG_DATA_PRES + 2U]   = 0x80U;
+    g_bmp.regs[REG_DATA_TEMP + 2U]   = 0x80U;
+    g_bmp.regs[REG_EVENT]            = 0x01U; // Power on detected
+    g_bmp.regs[REG_FIFO_WM]          = 0x01U;
+    g_bmp.regs[REG_FIFO_CONFIG1]     = FIFO_STOP_FULL;
+    g_bmp.regs[REG_FIFO_CONFIG2]     = 0x02U;
+    g_bmp.regs[REG_INT_CTRL]         = INT_CTRL_LEVEL;
+    g_bmp.regs[REG_OSR]              = 0x02U;
+    memcpy(&g_bmp.regs[REG_CALIB], g_nvm, sizeof(g_nvm));
+
+    mp_host_event_cancel(&g_bmp.conv_event);
+    mp_host_event_cancel(&g_bmp.int_event);
+    set_int_pin(FALSE);
+    g_bmp.ptr                = 0U;
+    g_bmp.iir_pres           = -1.0;
+    g_bmp.iir_temp           = -1.0;
+    g_bmp.fifo_len           = 0U;
+    g_bmp.fifo_skip          = 0U;
+    g_bmp.is_time_frame_sent = FALSE;
+    g_bmp.power_on_ns        = mp_host_clock_now_ns();
+    g_bmp.boot_end_ns        = g_bmp.power_on_ns + BOOT_NS;
+}
+
+static void write_pwr_ctrl(uint8_t p_value)
+{
+    uint8_t mode = p_value & PWR_MODE_MSK;
+
+    g_bmp.regs[REG_PWR_CTRL] = p_value & (PWR_MODE_MSK | PWR_PRES_EN | PWR_TEMP_EN);
+    if (mode == 0U)
+    {
+        mp_host_event_cancel(&g_bmp.conv_event);
+        return;
+    }
+    if ((mode == PWR_MODE_NORMAL) && (is_config_valid() == FALSE))
+    {
+        // The sensor refuses the normal mode and stays asleep
+        g_bmp.regs[REG_ERR]      |= ERR_CONF;
+        g_bmp.regs[REG_PWR_CTRL] &= (uint8_t)~PWR_MODE_MSK;
+        mp_host_event_cancel(&g_bmp.conv_event);
+        return;
+    }
+    // A running normal mode keeps its grid
+    if ((mode != PWR_MODE_NORMAL) || (g_bmp.conv_event.is_scheduled == FALSE))
+    {
+        g_bmp.conv_start_ns = mp_host_clock_now_ns();
+        mp_host_event_schedule(&g_bmp.conv_event, g_bmp.conv_start_ns + conv_ns());
+    }
+}
+
+static void write_reg(uint8_t p_reg, uint8_t p_value)
+{
+    switch (p_reg)
+    {
+        case REG_CMD:
+            if (p_value == CMD_SOFT_RESET)
+            {
+                reset_regs();
+            }
+            else if (p_value == CMD_FIFO_FLUSH)
+            {
+                g_bmp.fifo_len = 0U;
+            }
+            else if (p_value != CMD_EXT_MODE_EN)
+            {
+                g_bmp.regs[REG_ERR] |= ERR_CMD;
+            }
+            break;
+        case REG_PWR_CTRL:
+            write_pwr_ctrl(p_value);
+            break;
+        case REG_FIFO_WM:
+        case REG_FIFO_WM + 1U:
+        case REG_FIFO_CONFIG1:
+        case REG_FIFO_CONFIG2:
+        case REG_INT_CTRL:
+        case REG_IF_CONF:
+        case REG_CONFIG:
+            g_bmp.regs[p_reg] = p_value;
+            break;
+        case REG_OSR:
+        case REG_ODR:
+            g_bmp.regs[p_reg] = p_value;
+            if (((g_bmp.regs[REG_PWR_CTRL] & PWR_MODE_MSK) == PWR_MODE_NORMAL)
+                && (is_config_valid() == FALSE))
+            {
+                g_bmp.regs[REG_ERR]      |= ERR_CONF;
+                g_bmp.regs[REG_PWR_CTRL] &= (uint8_t)~PWR_MODE_MSK;
+                mp_host_event_cancel(&g_bmp.conv_event);
+            }
+            break;
+        default:
+            // Read only or reserved
+            break;
+    }
+}
+
+/**
+ * @brief This function reads registers from an address on, the address
+ * increments except on the FIFO data. The status registers are cleared on
+ * read and a read of the data registers consumes the sample.
+ */
+static void read_regs(uint8_t p_reg, uint8_t* ppt_data, size_t p_len)
+{
+    uint8_t* pt_regs      = g_bmp.regs;
+    uint32_t ticks        = (uint32_t)((double)(mp_host_clock_now_ns() - g_bmp.power_on_ns)
+                                / TIME_TICK_NS);
+    bool_t   is_pres_read = FALSE;
+    bool_t   is_temp_read = FALSE;
+    bool_t   is_int_read  = FALSE;
+    uint8_t  reg          = p_reg;
+
+    put_raw(&pt_regs[REG_SENS_TIME], ticks & RAW_MAX);
+    pt_regs[REG_FIFO_LENGTH]      = (uint8_t)g_bmp.fifo_len;
+    pt_regs[REG_FIFO_LENGTH + 1U] = (uint8_t)(g_bmp.fifo_len >> 8U);
+
+    for (size_t i = 0U; i < p_len; i++)
+    {
+        if (reg == REG_FIFO_DATA)
+        {
+            ppt_data[i] = fifo_pop();
+            continue;
+        }
+        ppt_data[i]   = (reg < REG_CNT) ? pt_regs[reg] : 0U;
+        is_pres_read |= ((reg >= REG_DATA_PRES) && (reg < (REG_DATA_PRES + 3U))) ? TRUE : FALSE;
+        is_temp_read |= ((reg >= REG_DATA_TEMP) && (reg < (REG_DATA_TEMP + 3U))) ? TRUE : FALSE;
+        is_int_read  |= (reg == REG_INT_STATUS) ? TRUE : FALSE;
+        if ((reg == REG_ERR) || (reg == REG_EVENT))
+        {
+            pt_regs[reg] = 0U;
+        }
+        reg++;
+    }
+
+    if (is_pres_read == TRUE)
+    {
+        if ((pt_regs[REG_STATUS] & STATUS_DRDY_PRES) != 0U)
+        {
+            g_bmp.stats.sample_cnt++;
+        }
+        else
+        {
+            g_bmp.stats.stale_cnt++;
+        }
+        pt_regs[REG_STATUS] &= (uint8_t)~STATUS_DRDY_PRES;
+    }
+    if (is_temp_read == TRUE)
+    {
+        pt_regs[REG_STATUS] &= (uint8_t)~STATUS_DRDY_TEMP;
+    }
+    if (is_int_read == TRUE)
+    {
+        pt_regs[REG_INT_STATUS] = 0U;
+        if ((pt_regs[REG_INT_CTRL] & INT_CTRL_LATCH) != 0U)
+        {
+            set_int_pin(FALSE);
+        }
+    }
+}
+
+static bool_t is_booted(void)
+{
+    return (mp_host_clock_now_ns() >= g_bmp.boot_end_ns) ? TRUE : FALSE;
+}
+
+/// A burst write sends the first value, then pairs of a register address and a value
+static response_status_t write_burst(uint8_t p_reg, const uint8_t* ppt_data, size_t p_len)
+{
+    if (is_booted() == FALSE)
+    {
+        return RET_ERROR;
+    }
+    write_reg(p_reg, ppt_data[0]);
+    for (size_t i = 1U; (i + 1U) < p_len; i += 2U)
+    {
+        write_reg(ppt_data[i], ppt_data[i + 1U]);
+    }
+
+    return RET_OK;
+}
+
+static response_status_t model_write(void* ppt_ctx, const uint8_t* ppt_data, size_t p_len)
+{
+    UNUSED(ppt_ctx);
+
+    if (is_booted() == FALSE)
+    {
+        return RET_ERROR;
+    }
+    g_bmp.ptr = ppt_data[0];
+
+    return (p_len > 1U) ? write_burst(ppt_data[0], &ppt_data[1], p_len - 1U) : RET_OK;
+}
+
+static response_status_t model_read(void* ppt_ctx, uint8_t* ppt_data, size_t p_len)
+{
+    UNUSED(ppt_ctx);
+
+    if (is_booted() == FALSE)
+    {
+        return RET_ERROR;
+    }
+    read_regs(g_bmp.ptr, ppt_data, p_len);
+
+    return RET_OK;
+}
+
+static response_status_t model_mem_write(void* ppt_ctx, uint16_t p_mem_addr, uint8_t p_mem_size,
+                                         const uint8_t* ppt_data, size_t p_len)
+{
+    UNUSED(ppt_ctx);
+
+    if (p_mem_size != HW_IIC_MEM_SZ_8BIT)
+    {
+        return RET_ERROR;
+    }
+
+    return write_burst((uint8_t)p_mem_addr, ppt_data, p_len);
+}
+
+static response_status_t model_mem_read(void* ppt_ctx, uint16_t p_mem_addr, uint8_t p_mem_size,
+                                        uint8_t* ppt_data, size_t p_len)
+{
+    UNUSED(ppt_ctx);
+
+    if ((p_mem_size != HW_IIC_MEM_SZ_8BIT) || (is_booted() == FALSE))
+    {
+        return RET_ERROR;
+    }
+    read_regs((uint8_t)p_mem_addr, ppt_data, p_len);
+
+    return RET_OK;
+}
+
+static const mp_host_iic_model_t g_bmp388_model = {
+    .write     = model_write,
+    .read      = model_read,
+    .mem_write = model_mem_write,
+    .mem_read  = model_mem_read,
+};
+
+/**
+ * @brief This function powers a simulated BMP388 on a bus, it boots at the
+ * current simulated time. The registers follow the datasheet, the conversions
+ * take the time of the oversampling and the pressure follows the profile.
+ * @param[in] p_int_pin Input pin wired to the INT pin, GP_PIN_CNT for none.
+ * @return Result of the execution status.
+ */
+response_status_t mp_host_bmp388_attach(iic_comm_port_t p_port, uint8_t p_dev_addr,
+                                        gpio_pins_t p_int_pin)
+{
+    ASSERT_AND_RETURN((p_int_pin < GP_OUT_PIN_CNT) || (p_int_pin > GP_PIN_CNT), RET_PARAM_ERROR);
+
+    response_status_t ret_val = RET_OK;
+
+    if (g_bmp.is_attached == TRUE)
+    {
+        mp_host_iic_detach((iic_comm_port_t)g_bmp.port, g_bmp.dev_addr);
+    }
+    mp_host_event_init(&g_bmp.conv_event, conv_done, NULL);
+    mp_host_event_init(&g_bmp.int_event, int_pulse_end, NULL);
+    ret_val = mp_host_iic_attach(p_port, p_dev_addr, &g_bmp388_model, &g_bmp);
+    if (ret_val != RET_OK)
+    {
+        g_bmp.is_attached = FALSE;
+        return ret_val;
+    }
+
+    g_bmp.is_attached = TRUE;
+    g_bmp.port        = (uint8_t)p_port;
+    g_bmp.dev_addr    = p_dev_addr;
+    g_bmp.int_pin     = p_int_pin;
+    memset(&g_bmp.stats, 0, sizeof(g_bmp.stats));
+    decode_calib(&g_bmp.calib);
+    reset_regs();
+
+    return RET_OK;
+}
+
+/**
+ * @brief This function scripts the air around the sensor, the points are
+ * sorted by time and kept by the caller. Before the first point and after the
+ * last one the air holds.
+ * @return Result of the execution status.
+ */
+response_status_t mp_host_bmp388_set_profile(const mp_host_bmp388_point_t* ppt_points,
+                                             size_t                        p_cnt)
+{
+    ASSERT_AND_RETURN((ppt_points == NULL) && (p_cnt > 0U), RET_PARAM_ERROR);
+
+    for (size_t i = 1U; i < p_cnt; i++)
+    {
+        if (ppt_points[i].t_ms <= ppt_points[i - 1U].t_ms)
+        {
+            return RET_PARAM_ERROR;
+        }
+    }
+    g_bmp.pt_profile  = ppt_points;
+    g_bmp.profile_cnt = p_cnt;
+
+    return RET_OK;
+}
+
+void mp_host_bmp388_get_stats(mp_host_bmp388_stats_t* ppt_stats)
+{
+    ASSERT_AND_RETURN(ppt_stats == NULL, );
+
+    *ppt_stats = g_bmp.stats;
+    mp_host_iic_get_dev_stats((iic_comm_port_t)g_bmp.port, g_bmp.dev_addr, &ppt_stats->bus);
+}
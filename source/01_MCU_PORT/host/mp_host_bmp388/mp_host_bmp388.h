@@ -0,0 +1,38 @@
+#ifndef MP_HOST_BMP388_H
+#define MP_HOST_BMP388_H
+
+#include "ha_gpio/ha_gpio.h"
+#include "mp_host_iic/mp_host_iic.h"
+
+/// Air of the sensor without a profile
+#define MP_HOST_BMP388_DEFAULT_ALT_M  (0.0F)
+#define MP_HOST_BMP388_DEFAULT_TEMP_C (25.0F)
+/// Width of the INT pin pulse in the non-latched mode
+#define MP_HOST_BMP388_INT_PULSE_NS   (10000U)
+
+/// A point of the scripted flight, the air in between is interpolated
+typedef struct
+{
+    uint32_t t_ms; // Simulated time of the point
+    float    altitude_m;
+    float    temperature_c;
+} mp_host_bmp388_point_t;
+
+typedef struct
+{
+    uint32_t            conv_cnt;      // Conversions completed
+    uint32_t            sample_cnt;    // New samples read, from the data registers or the FIFO
+    uint32_t            stale_cnt;     // Data register reads without a new sample
+    uint32_t            lost_cnt;      // Samples replaced by the next one before being read
+    uint32_t            fifo_drop_cnt; // FIFO frames dropped on a full FIFO
+    mp_host_iic_stats_t bus;           // Transfers to the sensor, probes included
+} mp_host_bmp388_stats_t;
+
+response_status_t mp_host_bmp388_attach(iic_comm_port_t p_port, uint8_t p_dev_addr,
+                                        gpio_pins_t p_int_pin);
+response_status_t mp_host_bmp388_set_profile(const mp_host_bmp388_point_t* ppt_points,
+                                             size_t                        p_cnt);
+float             mp_host_bmp388_altitude_to_pa(float p_altitude_m);
+void              mp_host_bmp388_get_stats(mp_host_bmp388_stats_t* ppt_stats);
+
+#endif // MP_HOST_BMP388_H
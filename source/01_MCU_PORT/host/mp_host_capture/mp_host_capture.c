@@ -0,0 +1,169 @@
+#include "mp_host_capture.h"
+
+#include "mp_host_clock/mp_host_clock.h"
+
+typedef struct
+{
+    bool_t                   is_armed;
+    bool_t                   is_one_shot;
+    uint32_t                 last_value;
+    timer_capture_callback_t pt_cb;
+    mp_host_event_t          pwm_event;
+    uint32_t                 pwm_width_us;
+    uint32_t                 pwm_period_us;
+} host_capture_ch_t;
+
+typedef struct st_host_ic_driver
+{
+    timer_capture_driver_t base;
+    host_capture_ch_t      channels[INPUT_CAPTURE_CHANNEL_CNT];
+} host_ic_driver_t;
+
+static host_ic_driver_t g_ic_drv;
+
+/// Falling edge of a generated pulse, the next one follows a period later
+static void pwm_irq(void* ppt_ctx)
+{
+    host_capture_ch_t* pt_ch = (host_capture_ch_t*)ppt_ctx;
+
+    mp_host_event_schedule(&pt_ch->pwm_event,
+                           mp_host_clock_now_ns() + ((uint64_t)pt_ch->pwm_period_us * 1000U));
+    (void)mp_host_capture_inject((input_capture_channel_t)(pt_ch - g_ic_drv.channels),
+                                 pt_ch->pwm_width_us);
+}
+
+static response_status_t init(void)
+{
+    g_ic_drv.base.hw_inst_cnt = INPUT_CAPTURE_CHANNEL_CNT;
+    for (uint32_t i = 0U; i < INPUT_CAPTURE_CHANNEL_CNT; i++)
+    {
+        if (g_ic_drv.channels[i].pwm_event.pt_handler == NULL)
+        {
+            mp_host_event_init(&g_ic_drv.channels[i].pwm_event, pwm_irq, &g_ic_drv.channels[i]);
+        }
+    }
+
+    return RET_OK;
+}
+
+/// All capture kinds are served with the injected values, the source knows what is measured
+static response_status_t arm(mp_timer_capture_channels_t p_chnl, mp_timer_capture_mode_t p_mode)
+{
+    ASSERT_AND_RETURN(p_chnl >= INPUT_CAPTURE_CHANNEL_CNT, RET_PARAM_ERROR);
+
+    g_ic_drv.channels[p_chnl].is_armed    = TRUE;
+    g_ic_drv.channels[p_chnl].is_one_shot = (p_mode == IC_ONE_SHOT_CAPTURE) ? TRUE : FALSE;
+    mp_host_clock_spend_ns(MP_HOST_CALL_NS);
+
+    return RET_OK;
+}
+
+static response_status_t arm_edge(mp_timer_capture_channels_t p_chnl,
+                                  mp_timer_capture_type_t p_type, mp_timer_capture_mode_t p_mode)
+{
+    UNUSED(p_type);
+
+    return arm(p_chnl, p_mode);
+}
+
+static response_status_t register_callback(mp_timer_capture_channels_t p_chnl,
+                                           timer_capture_callback_t    ppt_cb)
+{
+    ASSERT_AND_RETURN(p_chnl >= INPUT_CAPTURE_CHANNEL_CNT, RET_PARAM_ERROR);
+
+    g_ic_drv.channels[p_chnl].pt_cb = ppt_cb;
+
+    return RET_OK;
+}
+
+static response_status_t get_data(mp_timer_capture_channels_t p_chnl, uint32_t* ppt_value)
+{
+    ASSERT_AND_RETURN((p_chnl >= INPUT_CAPTURE_CHANNEL_CNT) || (ppt_value == NULL),
+                      RET_PARAM_ERROR);
+
+    *ppt_value = g_ic_drv.channels[p_chnl].last_value;
+
+    return RET_OK;
+}
+
+static response_status_t stop(mp_timer_capture_channels_t p_chnl)
+{
+    ASSERT_AND_RETURN(p_chnl >= INPUT_CAPTURE_CHANNEL_CNT, RET_PARAM_ERROR);
+
+    g_ic_drv.channels[p_chnl].is_armed = FALSE;
+
+    return RET_OK;
+}
+
+static struct st_ic_driver_ifc g_interface = {
+    .init              = init,
+    .capture_pulse     = arm,
+    .capture_frequency = arm,
+    .capture_pwm       = arm,
+    .capture_edge      = arm_edge,
+    .register_callback = register_callback,
+    .get_data          = get_data,
+    .stop_capture      = stop,
+};
+
+timer_capture_driver_t* timer_capture_driver_register(void)
+{
+    g_ic_drv.base.api = &g_interface;
+    return &g_ic_drv.base;
+}
+
+/**
+ * @brief This function completes a capture on a channel, as the capture
+ * interrupt of the target. A one-shot request is disarmed by it.
+ * @return TRUE if the channel was armed and the value delivered to a callback.
+ */
+bool_t mp_host_capture_inject(input_capture_channel_t p_chnl, uint32_t p_value)
+{
+    ASSERT_AND_RETURN(p_chnl >= INPUT_CAPTURE_CHANNEL_CNT, FALSE);
+
+    host_capture_ch_t* pt_ch = &g_ic_drv.channels[p_chnl];
+
+    if (pt_ch->is_armed == FALSE)
+    {
+        return FALSE;
+    }
+    pt_ch->last_value = p_value;
+    pt_ch->is_armed   = (pt_ch->is_one_shot == TRUE) ? FALSE : TRUE;
+    if (pt_ch->pt_cb == NULL)
+    {
+        return FALSE;
+    }
+    pt_ch->pt_cb(p_chnl, p_value);
+
+    return TRUE;
+}
+
+/**
+ * @brief This function generates pulses of a fixed width on a channel, e.g.
+ * a receiver at its neutral stick position. A null period stops it.
+ * @return Result of the execution status.
+ */
+response_status_t mp_host_capture_set_pwm(input_capture_channel_t p_chnl, uint32_t p_width_us,
+                                          uint32_t p_period_us)
+{
+    ASSERT_AND_RETURN(p_chnl >= INPUT_CAPTURE_CHANNEL_CNT, RET_PARAM_ERROR);
+    ASSERT_AND_RETURN((p_period_us != 0U) && (p_width_us >= p_period_us), RET_PARAM_ERROR);
+
+    host_capture_ch_t* pt_ch = &g_ic_drv.channels[p_chnl];
+
+    if (pt_ch->pwm_event.pt_handler == NULL)
+    {
+        mp_host_event_init(&pt_ch->pwm_event, pwm_irq, pt_ch);
+    }
+    pt_ch->pwm_width_us  = p_width_us;
+    pt_ch->pwm_period_us = p_period_us;
+    if (p_period_us == 0U)
+    {
+        mp_host_event_cancel(&pt_ch->pwm_event);
+        return RET_OK;
+    }
+    mp_host_event_schedule(&pt_ch->pwm_event,
+                           mp_host_clock_now_ns() + ((uint64_t)p_width_us * 1000U));
+
+    return RET_OK;
+}
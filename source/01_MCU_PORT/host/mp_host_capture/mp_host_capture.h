@@ -0,0 +1,11 @@
+#ifndef MP_HOST_CAPTURE_H
+#define MP_HOST_CAPTURE_H
+
+#include "ha_input_capture/ha_input_capture.h"
+#include "mp_timer/mp_timer_capture.h"
+
+bool_t            mp_host_capture_inject(input_capture_channel_t p_chnl, uint32_t p_value);
+response_status_t mp_host_capture_set_pwm(input_capture_channel_t p_chnl, uint32_t p_width_us,
+                                          uint32_t p_period_us);
+
+#endif // MP_HOST_CAPTURE_H
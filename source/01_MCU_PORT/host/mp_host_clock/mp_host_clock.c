@@ -0,0 +1,338 @@
+#define _GNU_SOURCE // setitimer and sigaction
+
+#include "mp_host_clock.h"
+
+#include "errno.h"
+#include "signal.h"
+#include "stdio.h"
+#include "stdlib.h"
+#include "string.h"
+#include "sys/time.h"
+#include "time.h"
+
+typedef struct
+{
+    uint64_t              now_ns;
+    mp_host_event_t*      pt_head; // Scheduled events, the earliest first
+    uint32_t              mask_depth;
+    bool_t                is_in_irq;
+    bool_t                is_irq_taken; // Since the last sleep, ends the next sleep at once
+    uint64_t              end_ns;
+    void                  (*pt_on_end)(void);
+    bool_t                is_realtime;
+    struct timespec       wall_start;
+    mp_host_clock_stats_t stats;
+} host_clock_t;
+
+static host_clock_t g_clock = { .end_ns = UINT64_MAX };
+
+/// Calls into the clock in progress, the spin guard does not touch the clock meanwhile
+static volatile sig_atomic_t g_clock_busy = 0;
+/// Calls into the clock since the start, the spin guard tells a stalled core by it
+static volatile sig_atomic_t g_clock_calls = 0;
+
+#define CLOCK_ENTER()    \
+    do                   \
+    {                    \
+        g_clock_busy++;  \
+        g_clock_calls++; \
+    } while (0)
+#define CLOCK_EXIT() (g_clock_busy--)
+
+static void check_end(void)
+{
+    if ((g_clock.now_ns >= g_clock.end_ns) && (g_clock.pt_on_end != NULL))
+    {
+        void (*pt_on_end)(void) = g_clock.pt_on_end;
+
+        g_clock.pt_on_end = NULL;
+        pt_on_end();
+    }
+}
+
+/// Waits until the wall clock caught up with the simulated time
+static void pace(void)
+{
+    struct timespec due = g_clock.wall_start;
+
+    if (g_clock.is_realtime == FALSE)
+    {
+        return;
+    }
+    due.tv_sec  += (time_t)(g_clock.now_ns / 1000000000ULL);
+    due.tv_nsec += (long)(g_clock.now_ns % 1000000000ULL);
+    if (due.tv_nsec >= 1000000000L)
+    {
+        due.tv_sec++;
+        due.tv_nsec -= 1000000000L;
+    }
+    // The spin guard interrupts the wait
+    while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &due, NULL) == EINTR)
+    {
+    }
+}
+
+/* Serves the due interrupts in time order, an interrupt does not preempt
+   another one and masked interrupts stay pending */
+static void serve_due(void)
+{
+    while ((g_clock.mask_depth == 0U) && (g_clock.is_in_irq == FALSE) && (g_clock.pt_head != NULL)
+           && (g_clock.pt_head->due_ns <= g_clock.now_ns))
+    {
+        mp_host_event_t* pt_event = g_clock.pt_head;
+
+        g_clock.pt_head        = pt_event->pt_next;
+        pt_event->is_scheduled = FALSE;
+        pt_event->pt_next      = NULL;
+
+        g_clock.is_in_irq = TRUE;
+        pt_event->pt_handler(pt_event->pt_ctx);
+        g_clock.is_in_irq    = FALSE;
+        g_clock.is_irq_taken = TRUE;
+        g_clock.stats.irq_cnt++;
+    }
+}
+
+/**
+ * @brief This function restarts the simulated time at 0 and drops every
+ * scheduled event, the end of the run and the pacing are kept.
+ */
+void mp_host_clock_reset(void)
+{
+    CLOCK_ENTER();
+    while (g_clock.pt_head != NULL)
+    {
+        mp_host_event_cancel(g_clock.pt_head);
+    }
+    g_clock.now_ns       = 0U;
+    g_clock.mask_depth   = 0U;
+    g_clock.is_in_irq    = FALSE;
+    g_clock.is_irq_taken = FALSE;
+    memset(&g_clock.stats, 0, sizeof(g_clock.stats));
+    (void)clock_gettime(CLOCK_MONOTONIC, &g_clock.wall_start);
+    CLOCK_EXIT();
+}
+
+uint64_t mp_host_clock_now_ns(void)
+{
+    return g_clock.now_ns;
+}
+
+/**
+ * @brief This function lets the core work for a while. The interrupts due
+ * meanwhile are served at their time, unless masked or already in one.
+ * @param[in] p_ns Duration of the work.
+ */
+void mp_host_clock_spend_ns(uint64_t p_ns)
+{
+    uint64_t end_ns = g_clock.now_ns + p_ns;
+
+    CLOCK_ENTER();
+    while ((g_clock.mask_depth == 0U) && (g_clock.is_in_irq == FALSE) && (g_clock.pt_head != NULL)
+           && (g_clock.pt_head->due_ns <= end_ns))
+    {
+        if (g_clock.pt_head->due_ns > g_clock.now_ns)
+        {
+            g_clock.now_ns = g_clock.pt_head->due_ns;
+        }
+        check_end();
+        serve_due();
+    }
+    if (end_ns > g_clock.now_ns)
+    {
+        g_clock.now_ns = end_ns;
+    }
+    check_end();
+    serve_due();
+    CLOCK_EXIT();
+}
+
+/// Lets the time jump to the next interrupt and serves it, the end of the run without any
+static void wait_next_irq(void)
+{
+    if (g_clock.pt_head == NULL)
+    {
+        if ((g_clock.pt_on_end == NULL) || (g_clock.end_ns == UINT64_MAX))
+        {
+            (void)fprintf(stderr, "host: sleeping without a pending interrupt\n");
+            abort();
+        }
+        g_clock.stats.sleep_ns += g_clock.end_ns - g_clock.now_ns;
+        g_clock.now_ns          = g_clock.end_ns;
+        check_end();
+        return;
+    }
+    if (g_clock.pt_head->due_ns > g_clock.now_ns)
+    {
+        g_clock.stats.sleep_ns += g_clock.pt_head->due_ns - g_clock.now_ns;
+        g_clock.now_ns          = g_clock.pt_head->due_ns;
+        pace();
+    }
+    check_end();
+    serve_due();
+}
+
+/**
+ * @brief This function sleeps until the next interrupt, the time jumps to it.
+ * An interrupt taken since the last sleep or one pending while masked ends
+ * the sleep at once. Without any scheduled event nothing could wake the core,
+ * the run ends.
+ */
+void mp_host_clock_sleep(void)
+{
+    CLOCK_ENTER();
+    if (g_clock.is_irq_taken == FALSE)
+    {
+        wait_next_irq();
+    }
+    g_clock.is_irq_taken = FALSE;
+    CLOCK_EXIT();
+}
+
+/// Masks the interrupts, calls nest
+void mp_host_clock_irq_mask(void)
+{
+    g_clock.mask_depth++;
+}
+
+/// Unmasks the interrupts, the pending ones are served at once
+void mp_host_clock_irq_unmask(void)
+{
+    if (g_clock.mask_depth > 0U)
+    {
+        g_clock.mask_depth--;
+    }
+    CLOCK_ENTER();
+    serve_due();
+    CLOCK_EXIT();
+}
+
+/**
+ * @brief This function sets when the run ends, the callback is called once
+ * the simulated time reaches it and usually does not return.
+ */
+void mp_host_clock_set_end(uint64_t p_end_ns, void (*ppt_on_end)(void))
+{
+    g_clock.end_ns    = p_end_ns;
+    g_clock.pt_on_end = ppt_on_end;
+}
+
+/// TRUE keeps the simulated time behind the wall clock, e.g. for a terminal on a pty
+void mp_host_clock_set_realtime(bool_t p_is_realtime)
+{
+    g_clock.is_realtime = p_is_realtime;
+    (void)clock_gettime(CLOCK_MONOTONIC, &g_clock.wall_start);
+    g_clock.wall_start.tv_sec  -= (time_t)(g_clock.now_ns / 1000000000ULL);
+    g_clock.wall_start.tv_nsec -= (long)(g_clock.now_ns % 1000000000ULL);
+    if (g_clock.wall_start.tv_nsec < 0)
+    {
+        g_clock.wall_start.tv_sec--;
+        g_clock.wall_start.tv_nsec += 1000000000L;
+    }
+}
+
+void mp_host_clock_get_stats(mp_host_clock_stats_t* ppt_stats)
+{
+    ASSERT_AND_RETURN(ppt_stats == NULL, );
+
+    *ppt_stats = g_clock.stats;
+}
+
+void mp_host_event_init(mp_host_event_t* ppt_event, mp_host_irq_handler_t ppt_handler,
+                        void* ppt_ctx)
+{
+    ASSERT_AND_RETURN((ppt_event == NULL) || (ppt_handler == NULL), );
+
+    memset(ppt_event, 0, sizeof(*ppt_event));
+    ppt_event->pt_handler = ppt_handler;
+    ppt_event->pt_ctx     = ppt_ctx;
+}
+
+/**
+ * @brief This function raises the interrupt of an event at the given time, a
+ * scheduled event is moved. A time already passed raises it as soon as the
+ * interrupts are served. Events due at the same time keep their order.
+ */
+void mp_host_event_schedule(mp_host_event_t* ppt_event, uint64_t p_due_ns)
+{
+    ASSERT_AND_RETURN((ppt_event == NULL) || (ppt_event->pt_handler == NULL), );
+
+    mp_host_event_t** ppt_link = &g_clock.pt_head;
+
+    CLOCK_ENTER();
+    mp_host_event_cancel(ppt_event);
+    while ((*ppt_link != NULL) && ((*ppt_link)->due_ns <= p_due_ns))
+    {
+        ppt_link = &(*ppt_link)->pt_next;
+    }
+    ppt_event->due_ns       = p_due_ns;
+    ppt_event->pt_next      = *ppt_link;
+    ppt_event->is_scheduled = TRUE;
+    *ppt_link               = ppt_event;
+    CLOCK_EXIT();
+}
+
+void mp_host_event_cancel(mp_host_event_t* ppt_event)
+{
+    ASSERT_AND_RETURN(ppt_event == NULL, );
+
+    mp_host_event_t** ppt_link = &g_clock.pt_head;
+
+    if (ppt_event->is_scheduled == FALSE)
+    {
+        return;
+    }
+    CLOCK_ENTER();
+    while ((*ppt_link != NULL) && (*ppt_link != ppt_event))
+    {
+        ppt_link = &(*ppt_link)->pt_next;
+    }
+    if (*ppt_link != NULL)
+    {
+        *ppt_link = ppt_event->pt_next;
+    }
+    ppt_event->is_scheduled = FALSE;
+    ppt_event->pt_next      = NULL;
+    CLOCK_EXIT();
+}
+
+/* A core spinning on a flag never calls into the port, the interrupt it
+   waits for is raised by the tick once the clock saw no call for a period */
+static void spin_tick(int p_signal)
+{
+    static sig_atomic_t last_calls = -1;
+
+    UNUSED(p_signal);
+    if ((g_clock_busy == 0) && (g_clock_calls == last_calls) && (g_clock.mask_depth == 0U)
+        && (g_clock.is_in_irq == FALSE))
+    {
+        g_clock_busy++;
+        wait_next_irq();
+        g_clock_busy--;
+    }
+    last_calls = g_clock_calls;
+}
+
+/**
+ * @brief This function starts the spin guard, a wall clock tick of the given
+ * period. Without it a loop that polls memory only stalls the simulated time.
+ * @return Result of the execution status.
+ */
+response_status_t mp_host_clock_start_spin_guard(uint32_t p_period_us)
+{
+    ASSERT_AND_RETURN(p_period_us == 0U, RET_PARAM_ERROR);
+
+    struct sigaction action = { .sa_handler = spin_tick, .sa_flags = SA_RESTART };
+    struct itimerval period = { 0 };
+
+    period.it_interval.tv_sec  = (time_t)(p_period_us / 1000000U);
+    period.it_interval.tv_usec = (suseconds_t)(p_period_us % 1000000U);
+    period.it_value            = period.it_interval;
+    (void)sigemptyset(&action.sa_mask);
+    if ((sigaction(SIGALRM, &action, NULL) != 0) || (setitimer(ITIMER_REAL, &period, NULL) != 0))
+    {
+        return RET_ERROR;
+    }
+
+    return RET_OK;
+}
@@ -0,0 +1,46 @@
+#ifndef MP_HOST_CLOCK_H
+#define MP_HOST_CLOCK_H
+
+#include "su_common.h"
+
+/// Core clock of the target, the cycle counter of the host port runs at it
+#define MP_HOST_CPU_HZ  (80000000U)
+/// Time a call into the port takes, keeps loops that poll the hardware moving
+#define MP_HOST_CALL_NS (250U)
+
+typedef void (*mp_host_irq_handler_t)(void* ppt_ctx);
+
+/// A simulated interrupt source, the owner keeps it alive while it is scheduled
+typedef struct st_mp_host_event
+{
+    uint64_t                 due_ns;
+    mp_host_irq_handler_t    pt_handler;
+    void*                    pt_ctx;
+    bool_t                   is_scheduled;
+    struct st_mp_host_event* pt_next;
+} mp_host_event_t;
+
+typedef struct
+{
+    uint64_t irq_cnt;  // Interrupts served
+    uint64_t sleep_ns; // Time the core slept waiting for an interrupt
+} mp_host_clock_stats_t;
+
+void     mp_host_clock_reset(void);
+uint64_t mp_host_clock_now_ns(void);
+void     mp_host_clock_spend_ns(uint64_t p_ns);
+void     mp_host_clock_sleep(void);
+void     mp_host_clock_irq_mask(void);
+void     mp_host_clock_irq_unmask(void);
+void     mp_host_clock_set_end(uint64_t p_end_ns, void (*ppt_on_end)(void));
+void     mp_host_clock_set_realtime(bool_t p_is_realtime);
+void     mp_host_clock_get_stats(mp_host_clock_stats_t* ppt_stats);
+
+response_status_t mp_host_clock_start_spin_guard(uint32_t p_period_us);
+
+void mp_host_event_init(mp_host_event_t* ppt_event, mp_host_irq_handler_t ppt_handler,
+                        void* ppt_ctx);
+void mp_host_event_schedule(mp_host_event_t* ppt_event, uint64_t p_due_ns);
+void mp_host_event_cancel(mp_host_event_t* ppt_event);
+
+#endif // MP_HOST_CLOCK_H
@@ -0,0 +1,137 @@
+#include "mp_host_gpio.h"
+
+#include "mp_host_clock/mp_host_clock.h"
+
+typedef struct
+{
+    bool_t          level;
+    uint32_t        toggle_cnt; // Level changes, driven or applied
+    mp_host_event_t edge_event;
+} host_gpio_pin_t;
+
+typedef struct st_host_gpio_driver
+{
+    gpio_driver_t   base;
+    host_gpio_pin_t pins[GP_PIN_CNT];
+    void            (*pt_irq_callback)(uint8_t);
+} host_gpio_driver_t;
+
+static host_gpio_driver_t g_gpio_drv;
+
+static void set_level(uint8_t p_pin, bool_t p_level)
+{
+    if (g_gpio_drv.pins[p_pin].level != p_level)
+    {
+        g_gpio_drv.pins[p_pin].level = p_level;
+        g_gpio_drv.pins[p_pin].toggle_cnt++;
+    }
+}
+
+static void edge_irq(void* ppt_ctx)
+{
+    host_gpio_pin_t* pt_pin = (host_gpio_pin_t*)ppt_ctx;
+
+    if (g_gpio_drv.pt_irq_callback != NULL)
+    {
+        g_gpio_drv.pt_irq_callback((uint8_t)(pt_pin - g_gpio_drv.pins));
+    }
+}
+
+static response_status_t init(void)
+{
+    g_gpio_drv.base.hw_pin_cnt = GP_PIN_CNT;
+    for (uint32_t i = 0U; i < GP_PIN_CNT; i++)
+    {
+        mp_host_event_init(&g_gpio_drv.pins[i].edge_event, edge_irq, &g_gpio_drv.pins[i]);
+    }
+
+    return RET_OK;
+}
+
+static response_status_t write(uint8_t p_pin, bool_t p_value)
+{
+    ASSERT_AND_RETURN(p_pin >= GP_PIN_CNT, RET_PARAM_ERROR);
+
+    set_level(p_pin, p_value);
+    mp_host_clock_spend_ns(MP_HOST_CALL_NS);
+
+    return RET_OK;
+}
+
+static response_status_t read(uint8_t p_pin, bool_t* ppt_value)
+{
+    ASSERT_AND_RETURN(p_pin >= GP_PIN_CNT, RET_PARAM_ERROR);
+    ASSERT_AND_RETURN(ppt_value == NULL, RET_PARAM_ERROR);
+
+    *ppt_value = g_gpio_drv.pins[p_pin].level;
+    mp_host_clock_spend_ns(MP_HOST_CALL_NS);
+
+    return RET_OK;
+}
+
+static response_status_t toggle(uint8_t p_pin)
+{
+    ASSERT_AND_RETURN(p_pin >= GP_PIN_CNT, RET_PARAM_ERROR);
+
+    set_level(p_pin, (g_gpio_drv.pins[p_pin].level == TRUE) ? FALSE : TRUE);
+    mp_host_clock_spend_ns(MP_HOST_CALL_NS);
+
+    return RET_OK;
+}
+
+static response_status_t register_irq_callback(void (*ppt_callback)(uint8_t))
+{
+    ASSERT_AND_RETURN(ppt_callback == NULL, RET_PARAM_ERROR);
+
+    g_gpio_drv.pt_irq_callback = ppt_callback;
+
+    return RET_OK;
+}
+
+static struct st_gpio_driver_ifc g_interface = { .init                  = init,
+                                                 .write                 = write,
+                                                 .read                  = read,
+                                                 .toggle                = toggle,
+                                                 .register_irq_callback = register_irq_callback };
+
+gpio_driver_t* gpio_driver_register(void)
+{
+    g_gpio_drv.base.api = &g_interface;
+    return (struct st_gpio_driver*)&g_gpio_drv;
+}
+
+/**
+ * @brief This function drives an input pin from outside, a rising edge
+ * raises the pin interrupt as the EXTI line of the target does.
+ * @return Result of the execution status.
+ */
+response_status_t mp_host_gpio_set_input(gpio_pins_t p_pin, bool_t p_level)
+{
+    ASSERT_AND_RETURN((p_pin < GP_OUT_PIN_CNT) || (p_pin >= GP_PIN_CNT), RET_PARAM_ERROR);
+
+    if (g_gpio_drv.pins[p_pin].level != p_level)
+    {
+        set_level((uint8_t)p_pin, p_level);
+        if (p_level == TRUE)
+        {
+            mp_host_event_schedule(&g_gpio_drv.pins[p_pin].edge_event, mp_host_clock_now_ns());
+        }
+    }
+
+    return RET_OK;
+}
+
+/// Level of a pin, what the application drives on an output pin
+bool_t mp_host_gpio_get(gpio_pins_t p_pin)
+{
+    ASSERT_AND_RETURN(p_pin >= GP_PIN_CNT, FALSE);
+
+    return g_gpio_drv.pins[p_pin].level;
+}
+
+uint32_t mp_host_gpio_get_toggle_cnt(gpio_pins_t p_pin)
+{
+    ASSERT_AND_RETURN(p_pin >= GP_PIN_CNT, 0U);
+
+    return g_gpio_drv.pins[p_pin].toggle_cnt;
+}
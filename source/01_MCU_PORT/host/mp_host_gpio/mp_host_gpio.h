@@ -0,0 +1,11 @@
+#ifndef MP_HOST_GPIO_H
+#define MP_HOST_GPIO_H
+
+#include "ha_gpio/ha_gpio.h"
+#include "mp_gpio/mp_gpio.h"
+
+response_status_t mp_host_gpio_set_input(gpio_pins_t p_pin, bool_t p_level);
+bool_t            mp_host_gpio_get(gpio_pins_t p_pin);
+uint32_t          mp_host_gpio_get_toggle_cnt(gpio_pins_t p_pin);
+
+#endif // MP_HOST_GPIO_H
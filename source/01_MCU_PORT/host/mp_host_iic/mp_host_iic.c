@@ -0,0 +1,280 @@
+#include "mp_host_iic.h"
+
+#include "mp_host_clock/mp_host_clock.h"
+#include "string.h"
+
+/// 7 bit addresses
+#define IIC_DEV_ADDR_CNT (128U)
+/// SCL periods of a start, repeated start or stop condition
+#define IIC_COND_CLOCKS  (1U)
+/// Data bits and the acknowledge
+#define IIC_BYTE_CLOCKS  (9U)
+
+typedef struct
+{
+    const mp_host_iic_model_t* pt_model;
+    void*                      pt_ctx;
+    mp_host_iic_stats_t        stats; // Transfers to this address only
+} host_iic_dev_t;
+
+typedef struct st_host_iic_driver
+{
+    iic_driver_t        base;
+    host_iic_dev_t      devs[IIC_PORT_CNT][IIC_DEV_ADDR_CNT];
+    mp_host_iic_stats_t stats[IIC_PORT_CNT];
+} host_iic_driver_t;
+
+static host_iic_driver_t g_iic_drv;
+
+/**
+ * @brief This function holds the bus for a transfer, the interrupts due
+ * meanwhile are served as the core polls the peripheral.
+ * @return The device at the address, NULL if it does not acknowledge.
+ */
+static const host_iic_dev_t* bus_xfer(uint8_t p_port, uint8_t p_dev_addr, uint32_t p_byte_cnt,
+                                      uint32_t p_cond_cnt)
+{
+    host_iic_dev_t*      pt_dev   = &g_iic_drv.devs[p_port][p_dev_addr & 0x7FU];
+    mp_host_iic_stats_t* pt_stats = &g_iic_drv.stats[p_port];
+    uint64_t             clocks   = 0U;
+    uint64_t             bus_ns   = 0U;
+
+    // Without an acknowledge the master stops after the address
+    if (pt_dev->pt_model == NULL)
+    {
+        p_byte_cnt = 1U;
+        p_cond_cnt = 2U;
+    }
+    clocks = ((uint64_t)p_byte_cnt * IIC_BYTE_CLOCKS) + ((uint64_t)p_cond_cnt * IIC_COND_CLOCKS);
+    bus_ns = (clocks * 1000000000U) / MP_HOST_IIC_BUS_HZ;
+
+    pt_stats->xfer_cnt++;
+    pt_stats->byte_cnt += p_byte_cnt;
+    pt_stats->bus_ns   += bus_ns;
+    pt_dev->stats.xfer_cnt++;
+    pt_dev->stats.byte_cnt += p_byte_cnt;
+    pt_dev->stats.bus_ns   += bus_ns;
+    mp_host_clock_spend_ns(MP_HOST_CALL_NS + bus_ns);
+
+    return (pt_dev->pt_model != NULL) ? pt_dev : NULL;
+}
+
+static response_status_t xfer_result(uint8_t p_port, uint8_t p_dev_addr,
+                                     response_status_t p_ret_val)
+{
+    if (p_ret_val != RET_OK)
+    {
+        g_iic_drv.stats[p_port].nack_cnt++;
+        g_iic_drv.devs[p_port][p_dev_addr & 0x7FU].stats.nack_cnt++;
+    }
+
+    return p_ret_val;
+}
+
+static response_status_t init(void)
+{
+    g_iic_drv.base.hw_inst_cnt = IIC_PORT_CNT;
+
+    return RET_OK;
+}
+
+static response_status_t master_write(uint8_t p_port, uint8_t p_dev_addr,
+                                      const uint8_t* ppt_data, size_t p_len,
+                                      timeout_t p_timeout_ms)
+{
+    ASSERT_AND_RETURN(p_port >= IIC_PORT_CNT, RET_NOT_SUPPORTED);
+    ASSERT_AND_RETURN((ppt_data == NULL) || (p_len == 0U), RET_PARAM_ERROR);
+    UNUSED(p_timeout_ms);
+
+    const host_iic_dev_t* pt_dev = bus_xfer(p_port, p_dev_addr, 1U + (uint32_t)p_len, 2U);
+
+    if ((pt_dev == NULL) || (pt_dev->pt_model->write == NULL))
+    {
+        return xfer_result(p_port, p_dev_addr, RET_ERROR);
+    }
+
+    return xfer_result(p_port,
+                       p_dev_addr,
+                       pt_dev->pt_model->write(pt_dev->pt_ctx, ppt_data, p_len));
+}
+
+static response_status_t master_read(uint8_t p_port, uint8_t p_dev_addr, uint8_t* const ppt_data,
+                                     size_t p_len, timeout_t p_timeout_ms)
+{
+    ASSERT_AND_RETURN(p_port >= IIC_PORT_CNT, RET_NOT_SUPPORTED);
+    ASSERT_AND_RETURN((ppt_data == NULL) || (p_len == 0U), RET_PARAM_ERROR);
+    UNUSED(p_timeout_ms);
+
+    const host_iic_dev_t* pt_dev = bus_xfer(p_port, p_dev_addr, 1U + (uint32_t)p_len, 2U);
+
+    if ((pt_dev == NULL) || (pt_dev->pt_model->read == NULL))
+    {
+        return xfer_result(p_port, p_dev_addr, RET_ERROR);
+    }
+
+    return xfer_result(p_port,
+                       p_dev_addr,
+                       pt_dev->pt_model->read(pt_dev->pt_ctx, ppt_data, p_len));
+}
+
+static response_status_t mem_write(uint8_t p_port, uint8_t p_dev_addr, uint16_t p_mem_addr,
+                                   uint8_t p_mem_size, const uint8_t* ppt_data, size_t p_len,
+                                   timeout_t p_timeout_ms)
+{
+    ASSERT_AND_RETURN(p_port >= IIC_PORT_CNT, RET_NOT_SUPPORTED);
+    ASSERT_AND_RETURN((ppt_data == NULL) || (p_len == 0U), RET_PARAM_ERROR);
+    ASSERT_AND_RETURN((p_mem_size != HW_IIC_MEM_SZ_8BIT) && (p_mem_size != HW_IIC_MEM_SZ_16BIT),
+                      RET_PARAM_ERROR);
+    UNUSED(p_timeout_ms);
+
+    const host_iic_dev_t* pt_dev =
+      bus_xfer(p_port, p_dev_addr, 1U + (uint32_t)p_mem_size + (uint32_t)p_len, 2U);
+
+    if ((pt_dev == NULL) || (pt_dev->pt_model->mem_write == NULL))
+    {
+        return xfer_result(p_port, p_dev_addr, RET_ERROR);
+    }
+
+    return xfer_result(
+      p_port,
+      p_dev_addr,
+      pt_dev->pt_model->mem_write(pt_dev->pt_ctx, p_mem_addr, p_mem_size, ppt_data, p_len));
+}
+
+static response_status_t mem_read(uint8_t p_port, uint8_t p_dev_addr, uint16_t p_mem_addr,
+                                  uint8_t p_mem_size, uint8_t* const ppt_data, size_t p_len,
+                                  timeout_t p_timeout_ms)
+{
+    ASSERT_AND_RETURN(p_port >= IIC_PORT_CNT, RET_NOT_SUPPORTED);
+    ASSERT_AND_RETURN((ppt_data == NULL) || (p_len == 0U), RET_PARAM_ERROR);
+    ASSERT_AND_RETURN((p_mem_size != HW_IIC_MEM_SZ_8BIT) && (p_mem_size != HW_IIC_MEM_SZ_16BIT),
+                      RET_PARAM_ERROR);
+    UNUSED(p_timeout_ms);
+
+    // Address and register, then a repeated start and the address again
+    const host_iic_dev_t* pt_dev =
+      bus_xfer(p_port, p_dev_addr, 2U + (uint32_t)p_mem_size + (uint32_t)p_len, 3U);
+
+    if ((pt_dev == NULL) || (pt_dev->pt_model->mem_read == NULL))
+    {
+        return xfer_result(p_port, p_dev_addr, RET_ERROR);
+    }
+
+    return xfer_result(
+      p_port,
+      p_dev_addr,
+      pt_dev->pt_model->mem_read(pt_dev->pt_ctx, p_mem_addr, p_mem_size, ppt_data, p_len));
+}
+
+/// Nine SCL pulses and a stop, a simulated device never holds the bus
+static response_status_t bus_recover(uint8_t p_port)
+{
+    ASSERT_AND_RETURN(p_port >= IIC_PORT_CNT, RET_NOT_SUPPORTED);
+
+    mp_host_clock_spend_ns((10ULL * 1000000000U) / MP_HOST_IIC_BUS_HZ);
+
+    return RET_OK;
+}
+
+static response_status_t dev_ready(uint8_t p_port, uint8_t p_dev_addr, uint32_t p_tries)
+{
+    ASSERT_AND_RETURN(p_port >= IIC_PORT_CNT, RET_NOT_SUPPORTED);
+
+    for (uint32_t i = 0U; i < p_tries; i++)
+    {
+        if (bus_xfer(p_port, p_dev_addr, 1U, 2U) != NULL)
+        {
+            return RET_OK;
+        }
+        (void)xfer_result(p_port, p_dev_addr, RET_ERROR);
+    }
+
+    return RET_ERROR;
+}
+
+static response_status_t dev_check(uint8_t p_port, uint8_t p_dev_addr, timeout_t p_timeout_ms)
+{
+    UNUSED(p_timeout_ms);
+
+    return dev_ready(p_port, p_dev_addr, IIC_DEVICE_CHECK_TRIES);
+}
+
+static response_status_t dev_probe(uint8_t p_port, uint8_t p_dev_addr, timeout_t p_timeout_ms)
+{
+    UNUSED(p_timeout_ms);
+
+    return dev_ready(p_port, p_dev_addr, IIC_DEVICE_PROBE_TRIES);
+}
+
+static struct st_iic_driver_ifc g_interface = {
+    .init        = init,
+    .write       = master_write,
+    .read        = master_read,
+    .mem_write   = mem_write,
+    .mem_read    = mem_read,
+    .bus_recover = bus_recover,
+    .dev_check   = dev_check,
+    .dev_probe   = dev_probe,
+};
+
+iic_driver_t* iic_driver_register(void)
+{
+    g_iic_drv.base.api = &g_interface;
+    return (iic_driver_t*)&g_iic_drv;
+}
+
+/**
+ * @brief This function puts a simulated device on a bus, a device already at
+ * the address is replaced.
+ * @param[in] ppt_ctx Passed to the callbacks of the model.
+ * @return Result of the execution status.
+ */
+response_status_t mp_host_iic_attach(iic_comm_port_t p_port, uint8_t p_dev_addr,
+                                     const mp_host_iic_model_t* ppt_model, void* ppt_ctx)
+{
+    ASSERT_AND_RETURN(p_port >= IIC_PORT_CNT, RET_PARAM_ERROR);
+    ASSERT_AND_RETURN(p_dev_addr >= IIC_DEV_ADDR_CNT, RET_PARAM_ERROR);
+    ASSERT_AND_RETURN(ppt_model == NULL, RET_PARAM_ERROR);
+
+    g_iic_drv.devs[p_port][p_dev_addr].pt_model = ppt_model;
+    g_iic_drv.devs[p_port][p_dev_addr].pt_ctx   = ppt_ctx;
+
+    return RET_OK;
+}
+
+void mp_host_iic_detach(iic_comm_port_t p_port, uint8_t p_dev_addr)
+{
+    ASSERT_AND_RETURN((p_port >= IIC_PORT_CNT) || (p_dev_addr >= IIC_DEV_ADDR_CNT), );
+
+    g_iic_drv.devs[p_port][p_dev_addr].pt_model = NULL;
+    g_iic_drv.devs[p_port][p_dev_addr].pt_ctx   = NULL;
+}
+
+void mp_host_iic_get_stats(iic_comm_port_t p_port, mp_host_iic_stats_t* ppt_stats)
+{
+    ASSERT_AND_RETURN((p_port >= IIC_PORT_CNT) || (ppt_stats == NULL), );
+
+    *ppt_stats = g_iic_drv.stats[p_port];
+}
+
+/// Use of a bus by the transfers to one address, probes and failed transfers included
+void mp_host_iic_get_dev_stats(iic_comm_port_t p_port, uint8_t p_dev_addr,
+                               mp_host_iic_stats_t* ppt_stats)
+{
+    ASSERT_AND_RETURN((p_port >= IIC_PORT_CNT) || (p_dev_addr >= IIC_DEV_ADDR_CNT), );
+    ASSERT_AND_RETURN(ppt_stats == NULL, );
+
+    *ppt_stats = g_iic_drv.devs[p_port][p_dev_addr].stats;
+}
+
+void mp_host_iic_reset_stats(void)
+{
+    memset(g_iic_drv.stats, 0, sizeof(g_iic_drv.stats));
+    for (uint32_t port = 0U; port < IIC_PORT_CNT; port++)
+    {
+        for (uint32_t addr = 0U; addr < IIC_DEV_ADDR_CNT; addr++)
+        {
+            memset(&g_iic_drv.devs[port][addr].stats, 0, sizeof(mp_host_iic_stats_t));
+        }
+    }
+}
@@ -0,0 +1,41 @@
+#ifndef MP_HOST_IIC_H
+#define MP_HOST_IIC_H
+
+#include "ha_iic/ha_iic.h"
+#include "mp_iic/mp_iic.h"
+
+/// SCL frequency of the simulated buses, as the target configures I2C1
+#define MP_HOST_IIC_BUS_HZ (100000U)
+
+/**
+ * @brief A simulated device on a host I2C bus. The callbacks run when the
+ * transfer ends on the bus, a NULL callback is not acknowledged. The
+ * memory address size is 0 for plain transfers.
+ */
+typedef struct st_mp_host_iic_model
+{
+    response_status_t (*write)(void* ppt_ctx, const uint8_t* ppt_data, size_t p_len);
+    response_status_t (*read)(void* ppt_ctx, uint8_t* ppt_data, size_t p_len);
+    response_status_t (*mem_write)(void* ppt_ctx, uint16_t p_mem_addr, uint8_t p_mem_size,
+                                   const uint8_t* ppt_data, size_t p_len);
+    response_status_t (*mem_read)(void* ppt_ctx, uint16_t p_mem_addr, uint8_t p_mem_size,
+                                  uint8_t* ppt_data, size_t p_len);
+} mp_host_iic_model_t;
+
+typedef struct
+{
+    uint32_t xfer_cnt; // Transfers started, probes included
+    uint32_t nack_cnt; // Transfers a device did not acknowledge or failed
+    uint64_t byte_cnt; // Bytes on the wire, addresses included
+    uint64_t bus_ns;   // Time the bus was busy
+} mp_host_iic_stats_t;
+
+response_status_t mp_host_iic_attach(iic_comm_port_t p_port, uint8_t p_dev_addr,
+                                     const mp_host_iic_model_t* ppt_model, void* ppt_ctx);
+void              mp_host_iic_detach(iic_comm_port_t p_port, uint8_t p_dev_addr);
+void              mp_host_iic_get_stats(iic_comm_port_t p_port, mp_host_iic_stats_t* ppt_stats);
+void              mp_host_iic_get_dev_stats(iic_comm_port_t p_port, uint8_t p_dev_addr,
+                                            mp_host_iic_stats_t* ppt_stats);
+void              mp_host_iic_reset_stats(void);
+
+#endif // MP_HOST_IIC_H
@@ -0,0 +1,321 @@
+#define _GNU_SOURCE // getopt_long
+
+#include "fcntl.h"
+#include "getopt.h"
+#include "mp_host_bmp388/mp_host_bmp388.h"
+#include "mp_host_capture/mp_host_capture.h"
+#include "mp_host_clock/mp_host_clock.h"
+#include "mp_host_iic/mp_host_iic.h"
+#include "mp_host_uart/mp_host_uart.h"
+#include "mp_replay/mp_replay.h"
+#include "stdio.h"
+#include "stdlib.h"
+#include "string.h"
+#include "time.h"
+#include "unistd.h"
+
+/// Frame period of a PWM receiver
+#define HOST_RC_PERIOD_US  (20000U)
+/// Wall time a core may spin without calling into the port before its interrupt is raised
+#define HOST_SPIN_GUARD_US (1000U)
+/// Wiring of the barometer on the board
+#define HOST_BARO_ADDR     (0x76U)
+#define HOST_BARO_INT_PIN  (GP_PIN_IN_1)
+/// Points a barometer profile holds
+#define HOST_BARO_PTS_MAX  (4096U)
+
+extern int app(void);
+
+typedef struct
+{
+    const char*      pt_name;
+    uart_comm_port_t port;
+} host_uart_name_t;
+
+static const host_uart_name_t g_uart_names[] = {
+    { "dbg", UART_DBG_PORT },
+    { "esp32", UART_ESP32_PORT },
+    { "rc", UART_RC_PORT },
+};
+
+static struct timespec g_wall_start;
+
+static void usage(const char* ppt_prog)
+{
+    (void)fprintf(stderr,
+                  "Runs the application on the simulated MCU port\n"
+                  "usage: %s [options]\n"
+                  "  --run-s N             stop after N simulated seconds\n"
+                  "  --realtime            keep the simulated time behind the wall clock\n"
+                  "  --replay FILE         serve the sensors from a recording of ps_recorder\n"
+                  "  --baro-profile FILE   fly the barometer along lines of T_S ALT_M TEMP_C\n"
+                  "  --uart-out PORT=FILE  send a port to a file, - for stdout\n"
+                  "  --uart-in PORT=FILE   receive a port from a file or a fifo\n"
+                  "  --uart-pty PORT       connect a port to a new pseudo terminal\n"
+                  "  --rc-pwm US           receiver pulses of US on all capture channels\n"
+                  "PORT is one of dbg, esp32 and rc, the dbg port goes to stdout by default\n",
+                  ppt_prog);
+}
+
+static void on_end(void)
+{
+    struct timespec       now;
+    mp_host_clock_stats_t stats;
+    uint64_t              sim_ns = mp_host_clock_now_ns();
+
+    (void)clock_gettime(CLOCK_MONOTONIC, &now);
+    mp_host_clock_get_stats(&stats);
+
+    double wall_s = (double)(now.tv_sec - g_wall_start.tv_sec)
+                    + ((double)(now.tv_nsec - g_wall_start.tv_nsec) / 1e9);
+    double sim_s  = (double)sim_ns / 1e9;
+
+    (void)fflush(stdout);
+    (void)fprintf(stderr,
+                  "host: %.3f s simulated in %.3f s, x%.1f, %llu interrupts, %.1f %% asleep\n",
+                  sim_s,
+                  wall_s,
+                  (wall_s > 0.0) ? (sim_s / wall_s) : 0.0,
+                  (unsigned long long)stats.irq_cnt,
+                  (sim_ns > 0U) ? ((double)stats.sleep_ns * 100.0 / (double)sim_ns) : 0.0);
+    exit(EXIT_SUCCESS);
+}
+
+static int find_uart(const char* ppt_name, size_t p_len)
+{
+    for (size_t i = 0U; i < ARRAY_SIZE(g_uart_names); i++)
+    {
+        if ((strlen(g_uart_names[i].pt_name) == p_len)
+            && (strncmp(g_uart_names[i].pt_name, ppt_name, p_len) == 0))
+        {
+            return (int)g_uart_names[i].port;
+        }
+    }
+    (void)fprintf(stderr, "host: unknown UART port %.*s\n", (int)p_len, ppt_name);
+
+    return -1;
+}
+
+/// Connects a port given as PORT=FILE, the input is kept idle or the output dropped on errors
+static bool_t attach_uart(const char* ppt_arg, bool_t p_is_out, int* ppt_fd_in, int* ppt_fd_out)
+{
+    const char* pt_sep = strchr(ppt_arg, '=');
+    int         port   = (pt_sep != NULL) ? find_uart(ppt_arg, (size_t)(pt_sep - ppt_arg)) : -1;
+    int         fd     = -1;
+
+    if (port < 0)
+    {
+        return FALSE;
+    }
+    if (p_is_out == TRUE)
+    {
+        fd = (strcmp(pt_sep + 1, "-") == 0)
+               ? STDOUT_FILENO
+               : open(pt_sep + 1, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+        ppt_fd_out[port] = fd;
+    }
+    else
+    {
+        fd = (strcmp(pt_sep + 1, "-") == 0) ? STDIN_FILENO : open(pt_sep + 1, O_RDONLY);
+        ppt_fd_in[port] = fd;
+    }
+    if (fd < 0)
+    {
+        perror(pt_sep + 1);
+        return FALSE;
+    }
+
+    return TRUE;
+}
+
+static bool_t load_replay(const char* ppt_path)
+{
+    FILE*    pt_file = fopen(ppt_path, "rb");
+    uint8_t* pt_rec  = NULL;
+    long     len     = 0;
+
+    if ((pt_file == NULL) || (fseek(pt_file, 0, SEEK_END) != 0) || ((len = ftell(pt_file)) <= 0)
+        || (fseek(pt_file, 0, SEEK_SET) != 0))
+    {
+        perror(ppt_path);
+        return FALSE;
+    }
+    // Kept for the whole run, the replay serves the reads from it
+    pt_rec = malloc((size_t)len);
+    if ((pt_rec == NULL) || (fread(pt_rec, 1U, (size_t)len, pt_file) != (size_t)len))
+    {
+        perror(ppt_path);
+        (void)fclose(pt_file);
+        return FALSE;
+    }
+    (void)fclose(pt_file);
+    if (mp_replay_load(pt_rec, (size_t)len) != RET_OK)
+    {
+        (void)fprintf(stderr, "host: %s is not a valid recording\n", ppt_path);
+        return FALSE;
+    }
+
+    return TRUE;
+}
+
+/// Reads the points of a barometer profile, one per line, # starts a comment
+static bool_t load_baro_profile(const char* ppt_path)
+{
+    static mp_host_bmp388_point_t points[HOST_BARO_PTS_MAX];
+    FILE*                         pt_file = fopen(ppt_path, "r");
+    char                          line[128];
+    size_t                        cnt = 0U;
+
+    if (pt_file == NULL)
+    {
+        perror(ppt_path);
+        return FALSE;
+    }
+    while (fgets(line, sizeof(line), pt_file) != NULL)
+    {
+        double t_s  = 0.0;
+        float  alt  = 0.0F;
+        float  temp = 0.0F;
+
+        if ((line[0] == '#') || (sscanf(line, "%lf %f %f", &t_s, &alt, &temp) != 3))
+        {
+            continue;
+        }
+        if (cnt == HOST_BARO_PTS_MAX)
+        {
+            (void)fprintf(stderr,
+                          "host: %s has more than %u points\n",
+                          ppt_path,
+                          HOST_BARO_PTS_MAX);
+            (void)fclose(pt_file);
+            return FALSE;
+        }
+        points[cnt].t_ms          = (uint32_t)(t_s * 1000.0);
+        points[cnt].altitude_m    = alt;
+        points[cnt].temperature_c = temp;
+        cnt++;
+    }
+    (void)fclose(pt_file);
+    if (mp_host_bmp388_set_profile(points, cnt) != RET_OK)
+    {
+        (void)fprintf(stderr, "host: the times of %s do not increase\n", ppt_path);
+        return FALSE;
+    }
+
+    return TRUE;
+}
+
+int main(int argc, char* argv[])
+{
+    static const struct option options[] = {
+        { "run-s", required_argument, NULL, 's' },
+        { "realtime", no_argument, NULL, 'r' },
+        { "replay", required_argument, NULL, 'p' },
+        { "baro-profile", required_argument, NULL, 'b' },
+        { "uart-out", required_argument, NULL, 'o' },
+        { "uart-in", required_argument, NULL, 'i' },
+        { "uart-pty", required_argument, NULL, 't' },
+        { "rc-pwm", required_argument, NULL, 'c' },
+        { "help", no_argument, NULL, 'h' },
+        { NULL, 0, NULL, 0 },
+    };
+    int         fd_in[UART_PORT_CNT]  = { -1, -1, -1 };
+    int         fd_out[UART_PORT_CNT] = { STDOUT_FILENO, -1, -1 };
+    bool_t      is_pty[UART_PORT_CNT] = { FALSE };
+    const char* pt_replay             = NULL;
+    const char* pt_baro               = NULL;
+    double      run_s                 = 0.0;
+    uint32_t    rc_pwm_us             = 0U;
+    bool_t      is_ok                 = TRUE;
+    int         opt                   = 0;
+
+    while ((opt = getopt_long(argc, argv, "h", options, NULL)) != -1)
+    {
+        switch (opt)
+        {
+            case 's':
+                run_s = strtod(optarg, NULL);
+                break;
+            case 'r':
+                mp_host_clock_set_realtime(TRUE);
+                break;
+            case 'p':
+                pt_replay = optarg;
+                break;
+            case 'b':
+                pt_baro = optarg;
+                break;
+            case 'o':
+                is_ok = (attach_uart(optarg, TRUE, fd_in, fd_out) == TRUE) ? is_ok : FALSE;
+                break;
+            case 'i':
+                is_ok = (attach_uart(optarg, FALSE, fd_in, fd_out) == TRUE) ? is_ok : FALSE;
+                break;
+            case 't':
+            {
+                int port = find_uart(optarg, strlen(optarg));
+
+                if (port < 0)
+                {
+                    is_ok = FALSE;
+                    break;
+                }
+                is_pty[port] = TRUE;
+                break;
+            }
+            case 'c':
+                rc_pwm_us = (uint32_t)strtoul(optarg, NULL, 10);
+                break;
+            default:
+                usage(argv[0]);
+                return (opt == 'h') ? EXIT_SUCCESS : EXIT_FAILURE;
+        }
+    }
+    if ((is_ok == FALSE) || (optind < argc))
+    {
+        usage(argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    (void)clock_gettime(CLOCK_MONOTONIC, &g_wall_start);
+    mp_host_clock_reset();
+    for (uint32_t i = 0U; i < UART_PORT_CNT; i++)
+    {
+        is_ok = (is_pty[i] == TRUE) ? (mp_host_uart_open_pty((uart_comm_port_t)i) == RET_OK)
+                                    : (mp_host_uart_attach((uart_comm_port_t)i, fd_in[i], fd_out[i])
+                                       == RET_OK);
+        if (is_ok == FALSE)
+        {
+            (void)fprintf(stderr, "host: cannot connect UART port %u\n", (unsigned)i);
+            return EXIT_FAILURE;
+        }
+    }
+    // A recording of the barometer replaces the model
+    (void)mp_host_bmp388_attach(IIC_PORT1, HOST_BARO_ADDR, HOST_BARO_INT_PIN);
+    if ((pt_baro != NULL) && (load_baro_profile(pt_baro) == FALSE))
+    {
+        return EXIT_FAILURE;
+    }
+    if ((pt_replay != NULL) && (load_replay(pt_replay) == FALSE))
+    {
+        return EXIT_FAILURE;
+    }
+    for (uint32_t i = 0U; (rc_pwm_us != 0U) && (i < INPUT_CAPTURE_CHANNEL_CNT); i++)
+    {
+        (void)mp_host_capture_set_pwm((input_capture_channel_t)i, rc_pwm_us, HOST_RC_PERIOD_US);
+    }
+    if (run_s > 0.0)
+    {
+        mp_host_clock_set_end((uint64_t)(run_s * 1e9), on_end);
+    }
+
+    if (mp_host_clock_start_spin_guard(HOST_SPIN_GUARD_US) != RET_OK)
+    {
+        perror("host: spin guard");
+        return EXIT_FAILURE;
+    }
+
+    (void)app();
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,270 @@
+#include "mp_host_timer.h"
+
+#include "mp_host_clock/mp_host_clock.h"
+#include "mp_timer/mp_timer_stats.h"
+#include "string.h"
+#include "su_common.h"
+#include "su_profiler/su_profiler.h"
+
+typedef struct
+{
+    mp_host_event_t  event;
+    uint32_t         compare; // Counter value of the next fire
+    void             (*pt_cb)(void);
+    mp_timer_stats_t stats;
+} host_timer_ch_t;
+
+typedef struct st_host_timer_driver
+{
+    timer_driver_t  base;
+    bool_t          is_ready;
+    host_timer_ch_t channels[TIMER_CNT];
+    void            (*alarm_cb)(void); // one-shot compare on the channel of TIMER_10US
+} host_timer_driver_t;
+
+static const uint32_t      g_periods_us[TIMER_CNT] = MP_HOST_TIMER_PERIODS_US;
+static host_timer_driver_t g_timer_drv;
+
+/// The counter of the target runs at 1 MHz, it wraps around as the 32 bit TIM2
+static uint32_t counter_now(void)
+{
+    return (uint32_t)(mp_host_clock_now_ns() / 1000U);
+}
+
+/// Time the counter matches a compare value, the next match for a passed value
+static uint64_t compare_due_ns(uint32_t p_compare)
+{
+    uint64_t now_us = mp_host_clock_now_ns() / 1000U;
+
+    return (now_us + (uint32_t)(p_compare - (uint32_t)now_us)) * 1000U;
+}
+
+static void channel_irq(void* ppt_ctx)
+{
+    host_timer_ch_t* pt_ch   = (host_timer_ch_t*)ppt_ctx;
+    uint32_t         idx     = (uint32_t)(pt_ch - g_timer_drv.channels);
+    uint32_t         counter = counter_now();
+
+    // The alarm is one-shot, the user reprograms it from the callback
+    if ((idx == TIMER_10US) && (g_timer_drv.alarm_cb != NULL))
+    {
+        (void)mp_timer_stats_on_fire(&pt_ch->stats, pt_ch->compare, counter, 0U);
+        g_timer_drv.alarm_cb();
+        return;
+    }
+
+    // Periods that already passed are skipped on the grid and counted as overruns
+    pt_ch->compare = mp_timer_stats_on_fire(&pt_ch->stats, pt_ch->compare, counter,
+                                            g_periods_us[idx]);
+    mp_host_event_schedule(&pt_ch->event, compare_due_ns(pt_ch->compare));
+
+    if (pt_ch->pt_cb != NULL)
+    {
+        pt_ch->pt_cb();
+    }
+}
+
+static response_status_t init(void)
+{
+    if (g_timer_drv.is_ready == FALSE)
+    {
+        for (uint32_t i = 0U; i < TIMER_CNT; i++)
+        {
+            mp_host_event_init(&g_timer_drv.channels[i].event,
+                               channel_irq,
+                               &g_timer_drv.channels[i]);
+        }
+        g_timer_drv.is_ready = TRUE;
+    }
+
+    return RET_OK;
+}
+
+static response_status_t start(mp_timer_id_t p_timer_id)
+{
+    ASSERT_AND_RETURN(g_timer_drv.is_ready == FALSE, RET_NOT_INITIALIZED);
+    ASSERT_AND_RETURN(p_timer_id >= TIMER_CNT, RET_PARAM_ERROR);
+
+    host_timer_ch_t* pt_ch = &g_timer_drv.channels[p_timer_id];
+
+    if ((p_timer_id == TIMER_10US) && (g_timer_drv.alarm_cb != NULL))
+    {
+        return RET_BUSY; // channel is used by the alarm
+    }
+
+    mp_timer_stats_restart(&pt_ch->stats);
+    pt_ch->compare = counter_now() + g_periods_us[p_timer_id];
+    mp_host_event_schedule(&pt_ch->event, compare_due_ns(pt_ch->compare));
+
+    return RET_OK;
+}
+
+static response_status_t stop(mp_timer_id_t p_timer_id)
+{
+    ASSERT_AND_RETURN(g_timer_drv.is_ready == FALSE, RET_NOT_INITIALIZED);
+    ASSERT_AND_RETURN(p_timer_id >= TIMER_CNT, RET_PARAM_ERROR);
+
+    mp_host_event_cancel(&g_timer_drv.channels[p_timer_id].event);
+
+    return RET_OK;
+}
+
+static response_status_t register_callback(mp_timer_id_t p_timer_id, void (*ppt_callback)(void))
+{
+    ASSERT_AND_RETURN(g_timer_drv.is_ready == FALSE, RET_NOT_INITIALIZED);
+    ASSERT_AND_RETURN(ppt_callback == NULL, RET_PARAM_ERROR);
+    ASSERT_AND_RETURN(p_timer_id >= TIMER_CNT, RET_NOT_SUPPORTED);
+
+    if ((p_timer_id == TIMER_10US) && (g_timer_drv.alarm_cb != NULL))
+    {
+        return RET_BUSY; // channel is used by the alarm
+    }
+    g_timer_drv.channels[p_timer_id].pt_cb = ppt_callback;
+
+    return RET_OK;
+}
+
+static response_status_t get_state(void)
+{
+    return RET_NOT_SUPPORTED;
+}
+
+static uint32_t get_cycles(void)
+{
+    mp_host_clock_spend_ns(MP_HOST_CALL_NS);
+
+    return (uint32_t)((mp_host_clock_now_ns() * (MP_HOST_CPU_HZ / 1000000U)) / 1000U);
+}
+
+/// The microseconds come from the cycle counter as on the target, they wrap with it
+static uint32_t get_cpu_time(mp_timer_unit_t p_time_unit)
+{
+    switch (p_time_unit)
+    {
+        case MP_TIMER_UNIT_MS:
+            mp_host_clock_spend_ns(MP_HOST_CALL_NS);
+            return (uint32_t)(mp_host_clock_now_ns() / 1000000U);
+        case MP_TIMER_UNIT_US:
+            return get_cycles() / (MP_HOST_CPU_HZ / 1000000U);
+        default:
+            return 0;
+    }
+}
+
+static void hard_delay(uint32_t p_delay, mp_timer_unit_t p_delay_unit)
+{
+    switch (p_delay_unit)
+    {
+        case MP_TIMER_UNIT_MS:
+            mp_host_clock_spend_ns((uint64_t)p_delay * 1000000U);
+            break;
+        case MP_TIMER_UNIT_US:
+            mp_host_clock_spend_ns((uint64_t)p_delay * 1000U);
+            break;
+        default:
+            break;
+    }
+}
+
+static uint32_t get_counter(void)
+{
+    ASSERT_AND_RETURN(g_timer_drv.is_ready == FALSE, 0U);
+
+    mp_host_clock_spend_ns(MP_HOST_CALL_NS);
+
+    return counter_now();
+}
+
+static response_status_t set_alarm(uint32_t p_deadline)
+{
+    ASSERT_AND_RETURN(g_timer_drv.is_ready == FALSE, RET_NOT_INITIALIZED);
+    ASSERT_AND_RETURN(g_timer_drv.alarm_cb == NULL, RET_NOT_INITIALIZED);
+
+    host_timer_ch_t* pt_ch   = &g_timer_drv.channels[TIMER_10US];
+    uint32_t         counter = counter_now();
+
+    // A passed or too close deadline would only match after a wrap around
+    pt_ch->compare = ((int32_t)(p_deadline - counter) < (int32_t)MP_TIMER_MIN_LEAD)
+                       ? (counter + MP_TIMER_MIN_LEAD)
+                       : p_deadline;
+    mp_host_event_schedule(&pt_ch->event, compare_due_ns(pt_ch->compare));
+
+    return RET_OK;
+}
+
+static void cancel_alarm(void)
+{
+    ASSERT_AND_RETURN(g_timer_drv.is_ready == FALSE, );
+
+    mp_host_event_cancel(&g_timer_drv.channels[TIMER_10US].event);
+}
+
+static response_status_t register_alarm_callback(void (*ppt_callback)(void))
+{
+    ASSERT_AND_RETURN(g_timer_drv.is_ready == FALSE, RET_NOT_INITIALIZED);
+    ASSERT_AND_RETURN(ppt_callback == NULL, RET_PARAM_ERROR);
+
+    if (g_timer_drv.channels[TIMER_10US].pt_cb != NULL)
+    {
+        return RET_BUSY; // channel is used by the periodic timer
+    }
+    g_timer_drv.alarm_cb = ppt_callback;
+
+    return RET_OK;
+}
+
+static response_status_t get_stats(mp_timer_id_t p_timer_id, ha_timer_stats_t* ppt_stats)
+{
+    ASSERT_AND_RETURN(p_timer_id >= TIMER_CNT, RET_PARAM_ERROR);
+    ASSERT_AND_RETURN(ppt_stats == NULL, RET_PARAM_ERROR);
+
+    *ppt_stats = g_timer_drv.channels[p_timer_id].stats.stats;
+
+    return RET_OK;
+}
+
+static void reset_stats(void)
+{
+    for (uint32_t i = 0U; i < TIMER_CNT; i++)
+    {
+        memset(&g_timer_drv.channels[i].stats.stats, 0, sizeof(ha_timer_stats_t));
+    }
+}
+
+/**
+ * @brief Sleeps with the interrupts masked as the target does, so the idle
+ * probe ends before the interrupt that woke the core is served.
+ */
+static void wait_for_interrupt(void)
+{
+    mp_host_clock_irq_mask();
+    SU_PROF_ENTER(SU_PROF_IDLE);
+    mp_host_clock_sleep();
+    SU_PROF_EXIT(SU_PROF_IDLE);
+    mp_host_clock_irq_unmask();
+}
+
+static struct st_timer_driver_ifc g_interface = {
+    .init                    = init,
+    .start                   = start,
+    .stop                    = stop,
+    .register_callback       = register_callback,
+    .get_state               = get_state,
+    .get_frequency           = NULL,
+    .hard_delay              = hard_delay,
+    .get_cpu_time            = get_cpu_time,
+    .get_counter             = get_counter,
+    .get_cycles              = get_cycles,
+    .set_alarm               = set_alarm,
+    .cancel_alarm            = cancel_alarm,
+    .register_alarm_callback = register_alarm_callback,
+    .wait_for_interrupt      = wait_for_interrupt,
+    .get_stats               = get_stats,
+    .reset_stats             = reset_stats,
+};
+
+timer_driver_t* timer_driver_register(void)
+{
+    g_timer_drv.base.api = &g_interface;
+    return (timer_driver_t*)&g_timer_drv;
+}
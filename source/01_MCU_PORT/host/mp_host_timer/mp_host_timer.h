@@ -0,0 +1,9 @@
+#ifndef MP_HOST_TIMER_H
+#define MP_HOST_TIMER_H
+
+#include "mp_timer/mp_timer_general.h"
+
+/// Compare periods of TIMER_10US to TIMER_100MS in ticks of 1 us, as the target configures them
+#define MP_HOST_TIMER_PERIODS_US { 10U, 1000U, 10000U, 100000U }
+
+#endif // MP_HOST_TIMER_H
@@ -0,0 +1,370 @@
+#define _GNU_SOURCE // posix_openpt, grantpt, unlockpt and ptsname
+
+#include "mp_host_uart.h"
+
+#include "errno.h"
+#include "fcntl.h"
+#include "mp_host_clock/mp_host_clock.h"
+#include "stdio.h"
+#include "stdlib.h"
+#include "string.h"
+#include "unistd.h"
+
+/// A start bit, 8 data bits and a stop bit
+#define UART_FRAME_BITS (10U)
+/// Bytes the line carries between two polls of the reception
+#define UART_RX_POLL_MAX                                                                       \
+    ((uint32_t)(((uint64_t)MP_HOST_UART_BAUD * MP_HOST_UART_RX_POLL_NS)                        \
+                / (UART_FRAME_BITS * 1000000000ULL)))
+
+typedef struct
+{
+    int                  fd_in;  // -1 keeps the line idle
+    int                  fd_out; // -1 drops what is sent
+    mp_host_event_t      tx_event;
+    const uint8_t*       pt_tx_buf;
+    size_t               tx_len;
+    bool_t               is_tx_busy;
+    dma_tx_evt_cb        pt_tx_cb;
+    mp_host_event_t      rx_event;
+    uint8_t*             pt_rx_buf;
+    size_t               rx_buf_sz;
+    size_t               rx_pos;
+    dma_rx_evt_cb        pt_rx_cb;
+    mp_host_uart_stats_t stats;
+} host_uart_port_t;
+
+typedef struct st_host_uart_driver
+{
+    uart_driver_t    base;
+    host_uart_port_t ports[UART_PORT_CNT];
+} host_uart_driver_t;
+
+static host_uart_driver_t g_uart_drv = {
+    .ports = { [0 ... UART_PORT_CNT - 1U] = { .fd_in = -1, .fd_out = -1 } }
+};
+
+static uint64_t wire_ns(size_t p_len)
+{
+    return ((uint64_t)p_len * UART_FRAME_BITS * 1000000000ULL) / MP_HOST_UART_BAUD;
+}
+
+static void port_write(host_uart_port_t* ppt_port, const uint8_t* ppt_data, size_t p_len)
+{
+    ppt_port->stats.tx_byte_cnt += p_len;
+    while ((ppt_port->fd_out >= 0) && (p_len > 0U))
+    {
+        ssize_t written = write(ppt_port->fd_out, ppt_data, p_len);
+
+        if (written < 0)
+        {
+            if (errno == EINTR)
+            {
+                continue;
+            }
+            if (errno != EAGAIN)
+            {
+                ppt_port->fd_out = -1; // A closed pipe leaves the line unconnected
+            }
+            break; // Nobody reads the terminal, the rest is lost as on the wire
+        }
+        ppt_data += written;
+        p_len    -= (size_t)written;
+    }
+}
+
+/// Reads what arrived without waiting, 0 if the line is idle
+static size_t port_read(host_uart_port_t* ppt_port, uint8_t* ppt_data, size_t p_len)
+{
+    ssize_t got = 0;
+
+    if ((ppt_port->fd_in < 0) || (p_len == 0U))
+    {
+        return 0U;
+    }
+    got = read(ppt_port->fd_in, ppt_data, p_len);
+    if (got <= 0)
+    {
+        if ((got == 0) || ((errno != EAGAIN) && (errno != EINTR)))
+        {
+            ppt_port->fd_in = -1; // End of the input
+        }
+        return 0U;
+    }
+    ppt_port->stats.rx_byte_cnt += (size_t)got;
+
+    return (size_t)got;
+}
+
+static void tx_irq(void* ppt_ctx)
+{
+    host_uart_port_t* pt_port = (host_uart_port_t*)ppt_ctx;
+    uint32_t          idx     = (uint32_t)(pt_port - g_uart_drv.ports);
+
+    // The bytes leave the buffer while the transmission runs, the user keeps it until now
+    port_write(pt_port, pt_port->pt_tx_buf, pt_port->tx_len);
+    pt_port->is_tx_busy = FALSE;
+    pt_port->stats.dma_tx_cnt++;
+    if (pt_port->pt_tx_cb != NULL)
+    {
+        pt_port->pt_tx_cb((mp_uart_ifc_idx_t)idx, MP_UART_DMA_TX_EVT_COMPLETE);
+    }
+}
+
+/* Moves what the line carried since the last poll into the circular buffer,
+   reported as the idle line interrupt of the target */
+static void rx_irq(void* ppt_ctx)
+{
+    host_uart_port_t* pt_port = (host_uart_port_t*)ppt_ctx;
+    uint32_t          idx     = (uint32_t)(pt_port - g_uart_drv.ports);
+    size_t            budget  = UART_RX_POLL_MAX;
+    size_t            got     = 0U;
+
+    while (budget > 0U)
+    {
+        size_t chunk = pt_port->rx_buf_sz - pt_port->rx_pos;
+
+        chunk = port_read(pt_port, &pt_port->pt_rx_buf[pt_port->rx_pos],
+                          (chunk < budget) ? chunk : budget);
+        if (chunk == 0U)
+        {
+            break;
+        }
+        pt_port->rx_pos = (pt_port->rx_pos + chunk) % pt_port->rx_buf_sz;
+        budget         -= chunk;
+        got            += chunk;
+    }
+    if ((got > 0U) && (pt_port->pt_rx_cb != NULL))
+    {
+        pt_port->pt_rx_cb((mp_uart_ifc_idx_t)idx, MP_UART_DMA_RX_EVT_DATA, pt_port->rx_pos);
+    }
+    if (pt_port->fd_in >= 0)
+    {
+        mp_host_event_schedule(&pt_port->rx_event,
+                               mp_host_clock_now_ns() + MP_HOST_UART_RX_POLL_NS);
+    }
+}
+
+static response_status_t init(void)
+{
+    g_uart_drv.base.hw_inst_cnt = UART_PORT_CNT;
+    for (uint32_t i = 0U; i < UART_PORT_CNT; i++)
+    {
+        mp_host_event_init(&g_uart_drv.ports[i].tx_event, tx_irq, &g_uart_drv.ports[i]);
+        mp_host_event_init(&g_uart_drv.ports[i].rx_event, rx_irq, &g_uart_drv.ports[i]);
+    }
+
+    return RET_OK;
+}
+
+/// Waits for the bytes as the HAL polls the receiver, the time runs while waiting
+static response_status_t receive(mp_uart_ifc_idx_t p_ifc_index, uint8_t* ppt_buffer,
+                                 size_t p_buffer_sz, timeout_t p_timeout_ms)
+{
+    ASSERT_AND_RETURN(p_ifc_index >= UART_PORT_CNT, RET_NOT_SUPPORTED);
+    ASSERT_AND_RETURN((ppt_buffer == NULL) || (p_buffer_sz == 0U), RET_PARAM_ERROR);
+
+    host_uart_port_t* pt_port  = &g_uart_drv.ports[p_ifc_index];
+    uint64_t          start_ns = mp_host_clock_now_ns();
+    size_t            got      = 0U;
+
+    while (got < p_buffer_sz)
+    {
+        size_t chunk = port_read(pt_port, &ppt_buffer[got], 1U);
+
+        if (chunk > 0U)
+        {
+            got += chunk;
+            mp_host_clock_spend_ns(wire_ns(chunk));
+            continue;
+        }
+        if ((pt_port->fd_in < 0)
+            || ((mp_host_clock_now_ns() - start_ns) >= ((uint64_t)p_timeout_ms * 1000000U)))
+        {
+            return RET_TIMEOUT;
+        }
+        mp_host_clock_spend_ns(wire_ns(1U));
+    }
+
+    return RET_OK;
+}
+
+/// Sends the bytes, the call returns once the last one left the line
+static response_status_t transmit(mp_uart_ifc_idx_t p_ifc_index, uint8_t* ppt_buffer,
+                                  size_t p_buffer_sz, timeout_t p_timeout_ms)
+{
+    ASSERT_AND_RETURN(p_ifc_index >= UART_PORT_CNT, RET_NOT_SUPPORTED);
+    ASSERT_AND_RETURN((ppt_buffer == NULL) || (p_buffer_sz == 0U), RET_PARAM_ERROR);
+    UNUSED(p_timeout_ms);
+
+    host_uart_port_t* pt_port = &g_uart_drv.ports[p_ifc_index];
+
+    if (pt_port->is_tx_busy == TRUE)
+    {
+        return RET_BUSY;
+    }
+    port_write(pt_port, ppt_buffer, p_buffer_sz);
+    mp_host_clock_spend_ns(wire_ns(p_buffer_sz));
+
+    return RET_OK;
+}
+
+static response_status_t dma_transmit_request(mp_uart_ifc_idx_t p_ifc_index, uint8_t* ppt_buffer,
+                                              size_t p_buffer_sz)
+{
+    ASSERT_AND_RETURN(p_ifc_index >= UART_PORT_CNT, RET_NOT_SUPPORTED);
+    ASSERT_AND_RETURN((ppt_buffer == NULL) || (p_buffer_sz == 0U), RET_PARAM_ERROR);
+
+    host_uart_port_t* pt_port = &g_uart_drv.ports[p_ifc_index];
+
+    if (pt_port->is_tx_busy == TRUE)
+    {
+        return RET_BUSY;
+    }
+    pt_port->pt_tx_buf  = ppt_buffer;
+    pt_port->tx_len     = p_buffer_sz;
+    pt_port->is_tx_busy = TRUE;
+    mp_host_event_schedule(&pt_port->tx_event, mp_host_clock_now_ns() + wire_ns(p_buffer_sz));
+    mp_host_clock_spend_ns(MP_HOST_CALL_NS);
+
+    return RET_OK;
+}
+
+/// The bytes of an aborted transmission are dropped, none of them was written out
+static response_status_t dma_transmit_abort(mp_uart_ifc_idx_t p_ifc_index)
+{
+    ASSERT_AND_RETURN(p_ifc_index >= UART_PORT_CNT, RET_NOT_SUPPORTED);
+
+    host_uart_port_t* pt_port = &g_uart_drv.ports[p_ifc_index];
+
+    mp_host_event_cancel(&pt_port->tx_event);
+    pt_port->is_tx_busy = FALSE;
+    if (pt_port->pt_tx_cb != NULL)
+    {
+        pt_port->pt_tx_cb(p_ifc_index, MP_UART_DMA_TX_EVT_ABORT);
+    }
+
+    return RET_OK;
+}
+
+static response_status_t dma_register_cb(mp_uart_ifc_idx_t p_ifc_index, dma_tx_evt_cb ppt_evt_cb)
+{
+    ASSERT_AND_RETURN(p_ifc_index >= UART_PORT_CNT, RET_NOT_SUPPORTED);
+
+    g_uart_drv.ports[p_ifc_index].pt_tx_cb = ppt_evt_cb;
+
+    return RET_OK;
+}
+
+static response_status_t dma_receive_start(mp_uart_ifc_idx_t p_ifc_index, uint8_t* ppt_buffer,
+                                           size_t p_buffer_sz)
+{
+    ASSERT_AND_RETURN(p_ifc_index >= UART_PORT_CNT, RET_NOT_SUPPORTED);
+    ASSERT_AND_RETURN((ppt_buffer == NULL) || (p_buffer_sz == 0U), RET_PARAM_ERROR);
+    ASSERT_AND_RETURN(p_buffer_sz > UINT16_MAX, RET_PARAM_ERROR);
+
+    host_uart_port_t* pt_port = &g_uart_drv.ports[p_ifc_index];
+
+    pt_port->pt_rx_buf = ppt_buffer;
+    pt_port->rx_buf_sz = p_buffer_sz;
+    pt_port->rx_pos    = 0U;
+    if (pt_port->fd_in >= 0)
+    {
+        mp_host_event_schedule(&pt_port->rx_event,
+                               mp_host_clock_now_ns() + MP_HOST_UART_RX_POLL_NS);
+    }
+
+    return RET_OK;
+}
+
+static response_status_t dma_register_rx_cb(mp_uart_ifc_idx_t p_ifc_index,
+                                            dma_rx_evt_cb     ppt_evt_cb)
+{
+    ASSERT_AND_RETURN(p_ifc_index >= UART_PORT_CNT, RET_NOT_SUPPORTED);
+
+    g_uart_drv.ports[p_ifc_index].pt_rx_cb = ppt_evt_cb;
+
+    return RET_OK;
+}
+
+static struct st_uart_driver_ifc g_interface = { .init                 = init,
+                                                 .receive              = receive,
+                                                 .transmit             = transmit,
+                                                 .dma_register_cb      = dma_register_cb,
+                                                 .dma_transmit_abort   = dma_transmit_abort,
+                                                 .dma_transmit_request = dma_transmit_request,
+                                                 .dma_receive_start    = dma_receive_start,
+                                                 .dma_register_rx_cb   = dma_register_rx_cb };
+
+uart_driver_t* uart_driver_register(void)
+{
+    g_uart_drv.base.api = &g_interface;
+    return (uart_driver_t*)&g_uart_drv;
+}
+
+/**
+ * @brief This function connects a port to host files. The input is read
+ * without blocking, a running DMA reception starts polling it.
+ * @param[in] p_fd_in Descriptor the port receives from, -1 for an idle line.
+ * @param[in] p_fd_out Descriptor the port sends to, -1 to drop the output.
+ * @return Result of the execution status.
+ */
+response_status_t mp_host_uart_attach(uart_comm_port_t p_port, int p_fd_in, int p_fd_out)
+{
+    ASSERT_AND_RETURN(p_port >= UART_PORT_CNT, RET_PARAM_ERROR);
+
+    host_uart_port_t* pt_port = &g_uart_drv.ports[p_port];
+
+    if (p_fd_in >= 0)
+    {
+        int flags = fcntl(p_fd_in, F_GETFL);
+
+        if ((flags < 0) || (fcntl(p_fd_in, F_SETFL, flags | O_NONBLOCK) < 0))
+        {
+            return RET_ERROR;
+        }
+    }
+    pt_port->fd_in  = p_fd_in;
+    pt_port->fd_out = p_fd_out;
+    if ((p_fd_in >= 0) && (pt_port->pt_rx_buf != NULL)
+        && (pt_port->rx_event.is_scheduled == FALSE))
+    {
+        mp_host_event_schedule(&pt_port->rx_event,
+                               mp_host_clock_now_ns() + MP_HOST_UART_RX_POLL_NS);
+    }
+
+    return RET_OK;
+}
+
+/**
+ * @brief This function connects a port to a new pseudo terminal, e.g. for a
+ * ground station or a terminal emulator. The path of the terminal to open is
+ * printed on stderr.
+ * @return Result of the execution status.
+ */
+response_status_t mp_host_uart_open_pty(uart_comm_port_t p_port)
+{
+    ASSERT_AND_RETURN(p_port >= UART_PORT_CNT, RET_PARAM_ERROR);
+
+    int fd = posix_openpt(O_RDWR | O_NOCTTY);
+
+    if (fd < 0)
+    {
+        return RET_ERROR;
+    }
+    if ((grantpt(fd) != 0) || (unlockpt(fd) != 0) || (ptsname(fd) == NULL))
+    {
+        (void)close(fd);
+        return RET_ERROR;
+    }
+    (void)fprintf(stderr, "host: UART port %u on %s\n", (unsigned)p_port, ptsname(fd));
+
+    return mp_host_uart_attach(p_port, fd, fd);
+}
+
+void mp_host_uart_get_stats(uart_comm_port_t p_port, mp_host_uart_stats_t* ppt_stats)
+{
+    ASSERT_AND_RETURN((p_port >= UART_PORT_CNT) || (ppt_stats == NULL), );
+
+    *ppt_stats = g_uart_drv.ports[p_port].stats;
+}
@@ -0,0 +1,22 @@
+#ifndef MP_HOST_UART_H
+#define MP_HOST_UART_H
+
+#include "mp_uart/mp_uart.h"
+
+/// Baud rate of the simulated ports, as the target configures all of its UARTs
+#define MP_HOST_UART_BAUD (115200U)
+/// Period the DMA reception polls its input, the idle line detection of the target
+#define MP_HOST_UART_RX_POLL_NS (1000000U)
+
+typedef struct
+{
+    uint64_t tx_byte_cnt; // Bytes sent, blocking and DMA
+    uint64_t rx_byte_cnt; // Bytes received, blocking and DMA
+    uint32_t dma_tx_cnt;  // DMA transmissions completed
+} mp_host_uart_stats_t;
+
+response_status_t mp_host_uart_attach(uart_comm_port_t p_port, int p_fd_in, int p_fd_out);
+response_status_t mp_host_uart_open_pty(uart_comm_port_t p_port);
+void              mp_host_uart_get_stats(uart_comm_port_t p_port, mp_host_uart_stats_t* ppt_stats);
+
+#endif // MP_HOST_UART_H
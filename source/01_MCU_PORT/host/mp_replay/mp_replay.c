@@ -0,0 +1,287 @@
+#include "mp_replay.h"
+
+#include "mp_host_capture/mp_host_capture.h"
+#include "mp_host_clock/mp_host_clock.h"
+#include "mp_host_iic/mp_host_iic.h"
+#include "string.h"
+
+/// Devices a recording can hold, sensors of the flight controller
+#define MP_REPLAY_MAX_DEVS (8U)
+
+typedef struct
+{
+    uint8_t port;
+    uint8_t dev_addr;
+} replay_dev_t;
+
+typedef struct
+{
+    su_rec_event_t    events[MP_REPLAY_MAX_EVENTS];
+    uint32_t          event_cnt;
+    bool_t            is_consumed[MP_REPLAY_MAX_EVENTS];
+    uint32_t          iic_cursor; // Oldest I2C read not yet served
+    uint32_t          capture_cursor;
+    uint64_t          start_ns; // Host time of the recorded time 0
+    mp_host_event_t   capture_event;
+    replay_dev_t      devs[MP_REPLAY_MAX_DEVS];
+    uint32_t          dev_cnt;
+    mp_replay_stats_t stats;
+} replay_t;
+
+static replay_t g_replay;
+
+/**
+ * @brief This function serves a read with the next recorded read of the same
+ * device and register. Reads of the other devices keep their own order, a
+ * recorded read the driver skipped is passed over.
+ */
+static response_status_t serve_read(uint8_t p_port, uint8_t p_dev_addr, uint16_t p_mem_addr,
+                                    uint8_t p_mem_size, uint8_t* const ppt_data, size_t p_len)
+{
+    for (uint32_t i = g_replay.iic_cursor; i < g_replay.event_cnt; i++)
+    {
+        const su_rec_event_t* pt_ev = &g_replay.events[i];
+
+        if ((g_replay.is_consumed[i] == TRUE) || (pt_ev->type != SU_REC_IIC_READ)
+            || (pt_ev->iic.port != p_port) || (pt_ev->iic.dev_addr != p_dev_addr))
+        {
+            continue;
+        }
+        if ((pt_ev->iic.mem_size != p_mem_size) || (pt_ev->iic.len != p_len)
+            || ((p_mem_size != 0U) && (pt_ev->iic.mem_addr != p_mem_addr)))
+        {
+            continue;
+        }
+
+        memcpy(ppt_data, pt_ev->iic.pt_data, p_len);
+        g_replay.is_consumed[i] = TRUE;
+        while ((g_replay.iic_cursor < g_replay.event_cnt)
+               && ((g_replay.is_consumed[g_replay.iic_cursor] == TRUE)
+                   || (g_replay.events[g_replay.iic_cursor].type != SU_REC_IIC_READ)))
+        {
+            g_replay.iic_cursor++;
+        }
+        g_replay.stats.iic_read_cnt++;
+        return RET_OK;
+    }
+
+    g_replay.stats.iic_miss_cnt++;
+
+    return RET_ERROR;
+}
+
+static response_status_t model_write(void* ppt_ctx, const uint8_t* ppt_data, size_t p_len)
+{
+    UNUSED(ppt_ctx);
+    UNUSED(ppt_data);
+    UNUSED(p_len);
+
+    g_replay.stats.iic_write_cnt++;
+
+    return RET_OK;
+}
+
+static response_status_t model_read(void* ppt_ctx, uint8_t* ppt_data, size_t p_len)
+{
+    const replay_dev_t* pt_dev = (const replay_dev_t*)ppt_ctx;
+
+    return serve_read(pt_dev->port, pt_dev->dev_addr, 0U, 0U, ppt_data, p_len);
+}
+
+static response_status_t model_mem_write(void* ppt_ctx, uint16_t p_mem_addr, uint8_t p_mem_size,
+                                         const uint8_t* ppt_data, size_t p_len)
+{
+    UNUSED(p_mem_addr);
+    UNUSED(p_mem_size);
+
+    return model_write(ppt_ctx, ppt_data, p_len);
+}
+
+static response_status_t model_mem_read(void* ppt_ctx, uint16_t p_mem_addr, uint8_t p_mem_size,
+                                        uint8_t* ppt_data, size_t p_len)
+{
+    const replay_dev_t* pt_dev = (const replay_dev_t*)ppt_ctx;
+
+    return serve_read(pt_dev->port, pt_dev->dev_addr, p_mem_addr, p_mem_size, ppt_data, p_len);
+}
+
+/// Every recorded device answers with its recorded reads and accepts any write
+static const mp_host_iic_model_t g_replay_model = {
+    .write     = model_write,
+    .read      = model_read,
+    .mem_write = model_mem_write,
+    .mem_read  = model_mem_read,
+};
+
+static void attach_dev(uint8_t p_port, uint8_t p_dev_addr)
+{
+    for (uint32_t i = 0U; i < g_replay.dev_cnt; i++)
+    {
+        if ((g_replay.devs[i].port == p_port) && (g_replay.devs[i].dev_addr == p_dev_addr))
+        {
+            return;
+        }
+    }
+    if ((g_replay.dev_cnt < MP_REPLAY_MAX_DEVS)
+        && (mp_host_iic_attach((iic_comm_port_t)p_port, p_dev_addr, &g_replay_model,
+                               &g_replay.devs[g_replay.dev_cnt])
+            == RET_OK))
+    {
+        g_replay.devs[g_replay.dev_cnt].port     = p_port;
+        g_replay.devs[g_replay.dev_cnt].dev_addr = p_dev_addr;
+        g_replay.dev_cnt++;
+    }
+}
+
+static void detach_devs(void)
+{
+    for (uint32_t i = 0U; i < g_replay.dev_cnt; i++)
+    {
+        mp_host_iic_detach((iic_comm_port_t)g_replay.devs[i].port, g_replay.devs[i].dev_addr);
+    }
+    g_replay.dev_cnt = 0U;
+}
+
+static uint64_t event_due_ns(const su_rec_event_t* ppt_ev)
+{
+    return g_replay.start_ns + ((uint64_t)ppt_ev->t_us * 1000U);
+}
+
+/// Moves the cursor to the next capture and schedules its interrupt
+static void schedule_capture(void)
+{
+    while ((g_replay.capture_cursor < g_replay.event_cnt)
+           && (g_replay.events[g_replay.capture_cursor].type != SU_REC_CAPTURE))
+    {
+        g_replay.capture_cursor++;
+    }
+    if (g_replay.capture_cursor < g_replay.event_cnt)
+    {
+        mp_host_event_schedule(&g_replay.capture_event,
+                               event_due_ns(&g_replay.events[g_replay.capture_cursor]));
+    }
+}
+
+/// The captures recorded at the same time are delivered by one interrupt
+static void capture_irq(void* ppt_ctx)
+{
+    UNUSED(ppt_ctx);
+
+    while ((g_replay.capture_cursor < g_replay.event_cnt)
+           && (event_due_ns(&g_replay.events[g_replay.capture_cursor]) <= mp_host_clock_now_ns()))
+    {
+        const su_rec_event_t* pt_ev = &g_replay.events[g_replay.capture_cursor];
+
+        if ((pt_ev->type == SU_REC_CAPTURE)
+            && (mp_host_capture_inject((input_capture_channel_t)pt_ev->capture.channel,
+                                       pt_ev->capture.value)
+                == TRUE))
+        {
+            g_replay.stats.capture_cnt++;
+        }
+        g_replay.capture_cursor++;
+    }
+    schedule_capture();
+}
+
+/***************************************************************************************************
+ * Replay control.
+ ***************************************************************************************************/
+
+/**
+ * @brief This function loads a recording of ps_recorder and rewinds the
+ * replay. Its devices are put on the host I2C buses and its captures are
+ * raised as capture interrupts, the recorded time 0 is now. The recording is
+ * not copied, it shall outlive the replay.
+ * @retval `RET_NOT_SUPPORTED` if it is not a recording of a known version.
+ * @retval `RET_NO_MEMORY` if it has more than MP_REPLAY_MAX_EVENTS records.
+ * @retval `RET_ERROR` if a record is cut off, the records before it are kept.
+ */
+response_status_t mp_replay_load(const uint8_t* ppt_rec, size_t p_len)
+{
+    ASSERT_AND_RETURN(ppt_rec == NULL, RET_PARAM_ERROR);
+
+    su_rec_reader_t   reader;
+    response_status_t ret_val = su_rec_reader_init(&reader, ppt_rec, p_len);
+
+    if (g_replay.capture_event.pt_handler == NULL)
+    {
+        mp_host_event_init(&g_replay.capture_event, capture_irq, NULL);
+    }
+    mp_host_event_cancel(&g_replay.capture_event);
+    detach_devs();
+    memset(g_replay.is_consumed, 0, sizeof(g_replay.is_consumed));
+    memset(&g_replay.stats, 0, sizeof(g_replay.stats));
+    g_replay.event_cnt      = 0U;
+    g_replay.iic_cursor     = 0U;
+    g_replay.capture_cursor = 0U;
+    g_replay.start_ns       = mp_host_clock_now_ns();
+
+    while (ret_val == RET_OK)
+    {
+        if (g_replay.event_cnt >= MP_REPLAY_MAX_EVENTS)
+        {
+            ret_val = RET_NO_MEMORY;
+            break;
+        }
+        ret_val = su_rec_read(&reader, &g_replay.events[g_replay.event_cnt]);
+        if (ret_val == RET_OK)
+        {
+            if (g_replay.events[g_replay.event_cnt].type == SU_REC_IIC_READ)
+            {
+                attach_dev(g_replay.events[g_replay.event_cnt].iic.port,
+                           g_replay.events[g_replay.event_cnt].iic.dev_addr);
+            }
+            g_replay.event_cnt++;
+        }
+    }
+    schedule_capture();
+
+    return (ret_val == RET_NOT_FOUND) ? RET_OK : ret_val;
+}
+
+/**
+ * @brief This function lets the host time run up to a replay time, the
+ * recorded captures up to it are delivered at their time.
+ * @return Number of captures delivered meanwhile.
+ */
+uint32_t mp_replay_run_until(uint32_t p_t_us)
+{
+    uint32_t prev_cnt = g_replay.stats.capture_cnt;
+    uint64_t end_ns   = g_replay.start_ns + ((uint64_t)p_t_us * 1000U);
+
+    if (end_ns > mp_host_clock_now_ns())
+    {
+        mp_host_clock_spend_ns(end_ns - mp_host_clock_now_ns());
+    }
+
+    return g_replay.stats.capture_cnt - prev_cnt;
+}
+
+/// Replay time, the recorded time the host is at
+uint32_t mp_replay_now_us(void)
+{
+    return (uint32_t)((mp_host_clock_now_ns() - g_replay.start_ns) / 1000U);
+}
+
+/// TRUE once the replay time passed the last record, unserved I2C reads do not hold it
+bool_t mp_replay_is_done(void)
+{
+    if (g_replay.event_cnt == 0U)
+    {
+        return TRUE;
+    }
+
+    return ((g_replay.capture_cursor >= g_replay.event_cnt)
+            && (mp_host_clock_now_ns()
+                >= event_due_ns(&g_replay.events[g_replay.event_cnt - 1U])))
+             ? TRUE
+             : FALSE;
+}
+
+void mp_replay_get_stats(mp_replay_stats_t* ppt_stats)
+{
+    ASSERT_AND_RETURN(ppt_stats == NULL, );
+
+    *ppt_stats = g_replay.stats;
+}
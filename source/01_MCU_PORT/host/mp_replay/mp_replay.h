@@ -0,0 +1,26 @@
+#ifndef MP_REPLAY_H
+#define MP_REPLAY_H
+
+#include "su_common.h"
+#include "su_rec/su_rec.h"
+
+/// Records a replay holds, about an hour of IMU, baro and receiver at 50 Hz
+#ifndef MP_REPLAY_MAX_EVENTS
+#define MP_REPLAY_MAX_EVENTS (1U << 20U)
+#endif
+
+typedef struct
+{
+    uint32_t iic_read_cnt;  // Reads served from the recording
+    uint32_t iic_miss_cnt;  // Reads without a recorded match, failed as not acknowledged
+    uint32_t iic_write_cnt; // Writes, accepted and dropped
+    uint32_t capture_cnt;   // Captures delivered to a callback
+} mp_replay_stats_t;
+
+response_status_t mp_replay_load(const uint8_t* ppt_rec, size_t p_len);
+uint32_t          mp_replay_run_until(uint32_t p_t_us);
+uint32_t          mp_replay_now_us(void);
+bool_t            mp_replay_is_done(void);
+void              mp_replay_get_stats(mp_replay_stats_t* ppt_stats);
+
+#endif // MP_REPLAY_H
@@ -12,7 +12,8 @@ typedef struct st_stm32_gpio_driver
     const uint16_t*       pin;
 } stm32_gpio_driver_t;
 
-static stm32_gpio_driver_t g_gpio_drv = { .base = { 0U }, .port = NULL, .pin = NULL };
+static stm32_gpio_driver_t g_gpio_drv    = { .base = { 0U }, .port = NULL, .pin = NULL };
+static void (*g_irq_callback)(uint8_t) = NULL;
 
 static response_status_t init(void)
 {
@@ -87,10 +88,42 @@ static response_status_t toggle(uint8_t p_pin)
     return RET_OK;
 }
 
-static struct st_gpio_driver_ifc g_interface = { .init   = init,
-                                                 .write  = write,
-                                                 .read   = read,
-                                                 .toggle = toggle };
+static response_status_t register_irq_callback(void (*ppt_callback)(uint8_t))
+{
+    ASSERT_AND_RETURN(ppt_callback == NULL, RET_PARAM_ERROR);
+
+    g_irq_callback = ppt_callback;
+
+    return RET_OK;
+}
+
+/**
+ * @brief HAL EXTI callback, EXTI lines are shared between ports so the line
+ * number is enough to find the registered pin. Output pins using the same
+ * line number are filtered out by the upper layer.
+ * @param[in] GPIO_Pin The pin mask of the EXTI line that triggered.
+ */
+void HAL_GPIO_EXTI_Callback(uint16_t GPIO_Pin)
+{
+    if ((g_irq_callback == NULL) || (g_gpio_drv.pin == NULL))
+    {
+        return;
+    }
+
+    for (uint16_t i = 0; i < g_gpio_drv.base.hw_pin_cnt; ++i)
+    {
+        if (g_gpio_drv.pin[i] == GPIO_Pin)
+        {
+            g_irq_callback((uint8_t)i);
+        }
+    }
+}
+
+static struct st_gpio_driver_ifc g_interface = { .init                  = init,
+                                                 .write                 = write,
+                                                 .read                  = read,
+                                                 .toggle                = toggle,
+                                                 .register_irq_callback = register_irq_callback };
 
 gpio_driver_t* gpio_driver_register(void)
 {
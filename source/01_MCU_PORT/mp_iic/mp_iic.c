@@ -10,8 +10,19 @@ typedef struct st_stm32_iic_driver
     I2C_HandleTypeDef* const * hw_insts;
 } stm32_iic_driver_t;
 
+#define IIC_RECOVERY_CLOCK_CNT  (9U)   // worst case, a slave in the middle of a byte and ACK
+#define IIC_RECOVERY_DELAY_LOOPS (100U) // half SCL period, about 5 us at 80 MHz
+
 static stm32_iic_driver_t g_iic_drv = { .base = { 0U }, .hw_insts = NULL };
 
+static void recovery_delay(void)
+{
+    for (volatile uint32_t i = 0U; i < IIC_RECOVERY_DELAY_LOOPS; i++)
+    {
+        ;
+    }
+}
+
 static response_status_t init(void)
 {
     response_status_t ret_val = RET_OK;
@@ -142,14 +153,94 @@ static response_status_t is_dev_ready(uint8_t p_ifc_index, uint8_t p_dev_addr,
     return translate_hal_status(hal_ret);
 }
 
+/**
+ * @brief This function releases a bus held by a slave. The peripheral is
+ * de-initialized, SCL is clocked as GPIO until the slave releases SDA, a STOP
+ * condition is generated and the peripheral is initialized again.
+ * @note based on i2c_generic_scl_recovery() of the linux kernel.
+ */
+static response_status_t bus_recover(uint8_t p_ifc_index)
+{
+    ASSERT_AND_RETURN(g_iic_drv.hw_insts == NULL, RET_NOT_INITIALIZED);
+    ASSERT_AND_RETURN(p_ifc_index >= g_iic_drv.base.hw_inst_cnt, RET_NOT_SUPPORTED);
+
+    struct hal_iic_bus_pins const * pt_pins       = NULL;
+    size_t                          pins_cnt      = get_iic_bus_pins(&pt_pins);
+    I2C_HandleTypeDef*              pt_i2c_handle = g_iic_drv.hw_insts[p_ifc_index];
+    GPIO_InitTypeDef                gpio_init     = { 0U };
+    HAL_StatusTypeDef               hal_ret       = HAL_OK;
+    GPIO_PinState                   sda_state     = GPIO_PIN_RESET;
+
+    ASSERT_AND_RETURN(pt_pins == NULL || p_ifc_index >= pins_cnt, RET_NOT_SUPPORTED);
+    pt_pins = &pt_pins[p_ifc_index];
+
+    (void)HAL_I2C_DeInit(pt_i2c_handle);
+
+    gpio_init.Mode  = GPIO_MODE_OUTPUT_OD;
+    gpio_init.Pull  = GPIO_NOPULL;
+    gpio_init.Speed = GPIO_SPEED_FREQ_HIGH;
+    HAL_GPIO_WritePin(pt_pins->scl_port, pt_pins->scl_pin, GPIO_PIN_SET);
+    HAL_GPIO_WritePin(pt_pins->sda_port, pt_pins->sda_pin, GPIO_PIN_SET);
+    gpio_init.Pin = pt_pins->scl_pin;
+    HAL_GPIO_Init(pt_pins->scl_port, &gpio_init);
+    gpio_init.Pin = pt_pins->sda_pin;
+    HAL_GPIO_Init(pt_pins->sda_port, &gpio_init);
+    recovery_delay();
+
+    for (uint8_t i = 0U; i < IIC_RECOVERY_CLOCK_CNT; i++)
+    {
+        sda_state = HAL_GPIO_ReadPin(pt_pins->sda_port, pt_pins->sda_pin);
+        if (sda_state == GPIO_PIN_SET)
+        {
+            break;
+        }
+        HAL_GPIO_WritePin(pt_pins->scl_port, pt_pins->scl_pin, GPIO_PIN_RESET);
+        recovery_delay();
+        HAL_GPIO_WritePin(pt_pins->scl_port, pt_pins->scl_pin, GPIO_PIN_SET);
+        recovery_delay();
+    }
+
+    /// STOP condition, SDA rising while SCL is high
+    HAL_GPIO_WritePin(pt_pins->sda_port, pt_pins->sda_pin, GPIO_PIN_RESET);
+    recovery_delay();
+    HAL_GPIO_WritePin(pt_pins->sda_port, pt_pins->sda_pin, GPIO_PIN_SET);
+    recovery_delay();
+    sda_state = HAL_GPIO_ReadPin(pt_pins->sda_port, pt_pins->sda_pin);
+
+    /// MSP init restores the alternate function of the pins
+    hal_ret = HAL_I2C_Init(pt_i2c_handle);
+
+    if (sda_state != GPIO_PIN_SET)
+    {
+        return RET_ERROR;
+    }
+
+    return translate_hal_status(hal_ret);
+}
+
+static response_status_t probe_dev(uint8_t p_ifc_index, uint8_t p_dev_addr, timeout_t p_timeout_ms)
+{
+    ASSERT_AND_RETURN(g_iic_drv.hw_insts == NULL, RET_NOT_INITIALIZED);
+    ASSERT_AND_RETURN(p_ifc_index >= g_iic_drv.base.hw_inst_cnt, RET_NOT_SUPPORTED);
+
+    HAL_StatusTypeDef  hal_ret       = HAL_OK;
+    I2C_HandleTypeDef* pt_i2c_handle = g_iic_drv.hw_insts[p_ifc_index];
+
+    hal_ret =
+      HAL_I2C_IsDeviceReady(pt_i2c_handle, p_dev_addr << 1, IIC_DEVICE_PROBE_TRIES, p_timeout_ms);
+
+    return translate_hal_status(hal_ret);
+}
+
 static struct st_iic_driver_ifc g_interface = {
     .init        = init,
     .write       = master_write,
     .read        = master_read,
     .mem_write   = mem_write,
     .mem_read    = mem_read,
-    .bus_recover = NULL,
+    .bus_recover = bus_recover,
     .dev_check   = is_dev_ready,
+    .dev_probe   = probe_dev,
 };
 
 iic_driver_t* iic_driver_register(void)
@@ -2,6 +2,7 @@
 
 #include "main.h"
 #include "mp_common.h"
+#include "mp_timer_pulse.h"
 #include "string.h"
 #include "su_common.h"
 
@@ -110,6 +111,23 @@ static inline int32_t unhash_hal_slot(TIM_HandleTypeDef* ppt_htim)
     return (int32_t)(base_idx + (pos_plus1 - 1U));
 }
 
+// Lets the interrupts of a second channel of the timer reach the slot of a hashed channel,
+// e.g. the paired channel of the PWM input mode
+static inline void alias_hal_channel(TIM_HandleTypeDef* ppt_hal_tim,
+                                     uint32_t           p_hal_chnl_shift,
+                                     uint32_t           p_alias_shift)
+{
+    uint32_t addr   = (uint32_t)ppt_hal_tim->Instance;
+    uint32_t block  = (((addr >> 16) & 0xF) == 1U);
+    uint32_t offset = (addr & 0xFFFFU) >> 10;
+    uint32_t index  = ((block << 2) + offset);
+
+    uint32_t packed    = g_hal_timers_slot[index];
+    uint32_t pos_plus1 = (packed >> p_hal_chnl_shift) & 0xFU;
+
+    g_hal_timers_slot[index] = (packed & ~(0xFU << p_alias_shift)) | (pos_plus1 << p_alias_shift);
+}
+
 static void cap_cb(TIM_HandleTypeDef* ppt_htim)
 {
     volatile uint32_t drv_tim_idx = unhash_hal_slot(ppt_htim);
@@ -164,19 +182,10 @@ static void cap_cb(TIM_HandleTypeDef* ppt_htim)
                 pt_cap_data->pulse_width_data.falling_edge = HAL_TIM_ReadCapturedValue(ppt_htim, channel);
 
                 // Calculate pulse width (in µs)
-                if (pt_cap_data->pulse_width_data.falling_edge
-                    >= pt_cap_data->pulse_width_data.rising_edge)
-                {
-                    pt_cap_data->pulse_width_data.pulse_width =
-                      pt_cap_data->pulse_width_data.falling_edge
-                      - pt_cap_data->pulse_width_data.rising_edge;
-                }
-                else
-                {
-                    pt_cap_data->pulse_width_data.pulse_width =
-                      (ppt_htim->Instance->ARR - pt_cap_data->pulse_width_data.rising_edge + 1)
-                      + pt_cap_data->pulse_width_data.falling_edge;
-                }
+                pt_cap_data->pulse_width_data.pulse_width =
+                  mp_timer_pulse_width(pt_cap_data->pulse_width_data.rising_edge,
+                                       pt_cap_data->pulse_width_data.falling_edge,
+                                       ppt_htim->Instance->ARR);
 
                 // Switch back to rising edge
                 __HAL_TIM_SET_CAPTUREPOLARITY(ppt_htim, channel, TIM_INPUTCHANNELPOLARITY_RISING);
@@ -194,6 +203,33 @@ static void cap_cb(TIM_HandleTypeDef* ppt_htim)
                 }
             }
             break;
+
+        case IC_MEASURE_PWM:
+        {
+            // Falling edge on the paired channel, the rising edge reset the counter
+            uint32_t direct_chnl = g_ic_drv.hal_drv[drv_tim_idx].engaged_channels;
+            uint32_t cc_flag     = (direct_chnl == TIM_CHANNEL_1) ? TIM_FLAG_CC1 : TIM_FLAG_CC2;
+            bool_t   rising_seen = (__HAL_TIM_GET_FLAG(ppt_htim, cc_flag) != RESET) ? TRUE : FALSE;
+            // Reading the period clears its flag for the next period
+            uint32_t period      = HAL_TIM_ReadCapturedValue(ppt_htim, direct_chnl);
+            uint32_t width       = HAL_TIM_ReadCapturedValue(ppt_htim, channel);
+            uint32_t pulse_width = 0U;
+
+            if (mp_timer_pwm_width(rising_seen, period, width, &pulse_width) == TRUE)
+            {
+                pt_cap_data->pulse_width_data.pulse_width = pulse_width;
+                if (g_ic_drv.capture_cb[drv_tim_idx] != NULL)
+                {
+                    g_ic_drv.capture_cb[drv_tim_idx](drv_tim_idx, pulse_width);
+                }
+                if (g_ic_drv.one_shot[drv_tim_idx])
+                {
+                    HAL_TIM_IC_Stop_IT(ppt_htim, channel);
+                    HAL_TIM_IC_Stop(ppt_htim, direct_chnl);
+                }
+            }
+            break;
+        }
         default:
             return;
     }
@@ -201,6 +237,52 @@ static void cap_cb(TIM_HandleTypeDef* ppt_htim)
     g_ic_drv.on_going[drv_tim_idx] = FALSE;
 }
 
+// Only TI1 and TI2 can reset the counter, and the reset shall not disturb another channel
+static bool_t pwm_input_supported(mp_timer_capture_channels_t p_channel)
+{
+    uint32_t direct_chnl = g_ic_drv.hal_drv[p_channel].engaged_channels;
+
+    if ((direct_chnl != TIM_CHANNEL_1) && (direct_chnl != TIM_CHANNEL_2))
+    {
+        return FALSE;
+    }
+    for (uint8_t i = 0; i < g_ic_drv.base.hw_inst_cnt; i++)
+    {
+        if ((i != p_channel)
+            && (g_ic_drv.hal_drv[i].base_timer == g_ic_drv.hal_drv[p_channel].base_timer))
+        {
+            return FALSE;
+        }
+    }
+
+    return TRUE;
+}
+
+// Restores the plain input capture of a channel that ran in the PWM input mode
+static HAL_StatusTypeDef leave_pwm_input(mp_timer_capture_channels_t p_channel)
+{
+    TIM_HandleTypeDef*     pt_tim      = g_ic_drv.hal_drv[p_channel].base_timer;
+    uint32_t               direct_chnl = g_ic_drv.hal_drv[p_channel].engaged_channels;
+    uint32_t               paired_chnl = (direct_chnl == TIM_CHANNEL_1) ? TIM_CHANNEL_2
+                                                                        : TIM_CHANNEL_1;
+    TIM_SlaveConfigTypeDef slave_cfg   = { .SlaveMode = TIM_SLAVEMODE_DISABLE };
+    TIM_IC_InitTypeDef     ic_cfg      = { .ICPolarity  = TIM_INPUTCHANNELPOLARITY_RISING,
+                                           .ICSelection = TIM_ICSELECTION_DIRECTTI,
+                                           .ICPrescaler = TIM_ICPSC_DIV1,
+                                           .ICFilter    = 0U };
+    HAL_StatusTypeDef      hal_ret     = HAL_OK;
+
+    (void)HAL_TIM_IC_Stop_IT(pt_tim, paired_chnl);
+    (void)HAL_TIM_IC_Stop(pt_tim, direct_chnl);
+    hal_ret = HAL_TIM_SlaveConfigSynchro(pt_tim, &slave_cfg);
+    if (hal_ret == HAL_OK)
+    {
+        hal_ret = HAL_TIM_IC_ConfigChannel(pt_tim, &ic_cfg, direct_chnl);
+    }
+
+    return hal_ret;
+}
+
 static response_status_t init(void)
 {
     response_status_t ret_val = RET_OK;
@@ -272,6 +354,11 @@ static response_status_t req_edge_capture(mp_timer_capture_channels_t p_channel,
     TIM_HandleTypeDef* pt_base_timer = NULL;
     uint32_t           hal_chnl   = 0;
 
+    if ((g_ic_drv.req_cap_type[p_channel] == IC_MEASURE_PWM)
+        && (leave_pwm_input(p_channel) != HAL_OK))
+    {
+        return RET_ERROR;
+    }
     g_ic_drv.req_cap_type[p_channel] = p_rising_falling_edge;
     memset((void*)&g_ic_drv.cap_data[p_channel], 0, sizeof(union un_capture_data));
     g_ic_drv.one_shot[p_channel] = p_one_shot;
@@ -297,6 +384,11 @@ static response_status_t req_pulse_capture(mp_timer_capture_channels_t p_channel
     TIM_HandleTypeDef* pt_base_timer = NULL;
     uint32_t           hal_chnl   = 0;
 
+    if ((g_ic_drv.req_cap_type[p_channel] == IC_MEASURE_PWM)
+        && (leave_pwm_input(p_channel) != HAL_OK))
+    {
+        return RET_ERROR;
+    }
     g_ic_drv.req_cap_type[p_channel] = IC_MEASURE_PULSE_WIDTH;
     memset((void*)&g_ic_drv.cap_data[p_channel], 0, sizeof(union un_capture_data));
     g_ic_drv.one_shot[p_channel] = p_one_shot;
@@ -314,6 +406,70 @@ static response_status_t req_pulse_capture(mp_timer_capture_channels_t p_channel
     return translate_hal_status(hal_ret);
 }
 
+/**
+ * @brief This function measures the pulse width in the PWM input mode. The
+ * input drives two capture channels: the direct one latches the period on the
+ * rising edge, which also resets the counter, the paired one latches the width
+ * on the falling edge. No polarity is switched in the interrupt and only the
+ * falling edge raises one, so a period costs one interrupt instead of two.
+ */
+static response_status_t req_pwm_capture(mp_timer_capture_channels_t p_channel,
+                                         mp_timer_capture_mode_t     p_one_shot)
+{
+    ASSERT_AND_RETURN(g_ic_drv.hal_drv == NULL, RET_NOT_INITIALIZED);
+    ASSERT_AND_RETURN(p_channel >= INPUT_CAPTURE_CHANNEL_CNT, RET_NOT_SUPPORTED);
+    ASSERT_AND_RETURN(g_ic_drv.on_going[p_channel], RET_BUSY);
+
+    if (pwm_input_supported(p_channel) == FALSE)
+    {
+        return RET_NOT_SUPPORTED;
+    }
+
+    TIM_HandleTypeDef*     pt_tim      = g_ic_drv.hal_drv[p_channel].base_timer;
+    uint32_t               direct_chnl = g_ic_drv.hal_drv[p_channel].engaged_channels;
+    uint32_t               paired_chnl = (direct_chnl == TIM_CHANNEL_1) ? TIM_CHANNEL_2
+                                                                        : TIM_CHANNEL_1;
+    HAL_StatusTypeDef      hal_ret     = HAL_OK;
+    TIM_IC_InitTypeDef     ic_cfg      = { .ICPolarity  = TIM_INPUTCHANNELPOLARITY_RISING,
+                                           .ICSelection = TIM_ICSELECTION_DIRECTTI,
+                                           .ICPrescaler = TIM_ICPSC_DIV1,
+                                           .ICFilter    = 0U };
+    TIM_SlaveConfigTypeDef slave_cfg = {
+        .SlaveMode        = TIM_SLAVEMODE_RESET,
+        .InputTrigger     = (direct_chnl == TIM_CHANNEL_1) ? TIM_TS_TI1FP1 : TIM_TS_TI2FP2,
+        .TriggerPolarity  = TIM_INPUTCHANNELPOLARITY_RISING,
+        .TriggerPrescaler = TIM_ICPSC_DIV1,
+        .TriggerFilter    = 0U,
+    };
+
+    g_ic_drv.req_cap_type[p_channel] = IC_MEASURE_PWM;
+    memset((void*)&g_ic_drv.cap_data[p_channel], 0, sizeof(union un_capture_data));
+    g_ic_drv.one_shot[p_channel] = p_one_shot;
+    alias_hal_channel(pt_tim, direct_chnl, paired_chnl);
+
+    hal_ret = HAL_TIM_IC_ConfigChannel(pt_tim, &ic_cfg, direct_chnl);
+    if (hal_ret == HAL_OK)
+    {
+        ic_cfg.ICPolarity  = TIM_INPUTCHANNELPOLARITY_FALLING;
+        ic_cfg.ICSelection = TIM_ICSELECTION_INDIRECTTI;
+        hal_ret            = HAL_TIM_IC_ConfigChannel(pt_tim, &ic_cfg, paired_chnl);
+    }
+    if (hal_ret == HAL_OK)
+    {
+        hal_ret = HAL_TIM_SlaveConfigSynchro(pt_tim, &slave_cfg);
+    }
+    if (hal_ret == HAL_OK)
+    {
+        hal_ret = HAL_TIM_IC_Start(pt_tim, direct_chnl); // Latches the period, no interrupt
+    }
+    if (hal_ret == HAL_OK)
+    {
+        hal_ret = HAL_TIM_IC_Start_IT(pt_tim, paired_chnl);
+    }
+
+    return translate_hal_status(hal_ret);
+}
+
 static response_status_t register_callback(mp_timer_capture_channels_t p_channel,
                                            timer_capture_callback_t    ppt_callback)
 {
@@ -347,6 +503,7 @@ static response_status_t get_data(mp_timer_capture_channels_t p_channel, uint32_
             break;
 
         case IC_MEASURE_PULSE_WIDTH:
+        case IC_MEASURE_PWM:
             *ppt_data = g_ic_drv.cap_data[p_channel].pulse_width_data.pulse_width;
             ret_val = RET_OK;
             break;
@@ -374,6 +531,14 @@ static response_status_t stop_capture(mp_timer_capture_channels_t p_channel)
     TIM_HandleTypeDef* pt_base_timer = NULL;
     uint32_t           hal_chnl   = 0;
 
+    if (g_ic_drv.req_cap_type[p_channel] == IC_MEASURE_PWM)
+    {
+        hal_ret                          = leave_pwm_input(p_channel);
+        g_ic_drv.req_cap_type[p_channel] = IC_MEASURE_PULSE_WIDTH;
+        g_ic_drv.on_going[p_channel]     = FALSE;
+        return translate_hal_status(hal_ret);
+    }
+
     obtain_timer_from_channel(p_channel, &pt_base_timer, &hal_chnl);
 
     memset((void*)&g_ic_drv.cap_data[p_channel], 0, sizeof(union un_capture_data));
@@ -393,6 +558,7 @@ static struct st_ic_driver_ifc g_interface = {
     .capture_edge      = req_edge_capture,
     .capture_pulse     = req_pulse_capture,
     .capture_frequency = NULL,
+    .capture_pwm       = req_pwm_capture,
     .register_callback = register_callback,
     .get_data          = get_data,
     .stop_capture      = stop_capture,
@@ -2,7 +2,10 @@
 
 #include "main.h"
 #include "mp_common.h"
+#include "mp_timer_stats.h"
+#include "string.h"
 #include "su_common.h"
+#include "su_profiler/su_profiler.h"
 
 typedef struct st_stm32_timer_driver
 {
@@ -10,13 +13,19 @@ typedef struct st_stm32_timer_driver
     TIM_HandleTypeDef* hw_inst;
     uint32_t           sub_timers_periods[TIMER_CNT];
     void (*timers_user_cb[TIMER_CNT])(void);
+    void (*alarm_cb)(void); // one-shot compare on the channel of TIMER_10US
+    bool_t           is_alarm_ch_started;
+    mp_timer_stats_t ch_stats[TIMER_CNT];
 } stm32_timer_driver_t;
 
 static stm32_timer_driver_t g_timer_drv = {
-    .base               = { 0U },
-    .hw_inst            = NULL,
-    .sub_timers_periods = { 0 },
-    .timers_user_cb     = { NULL, NULL, NULL, NULL }
+    .base                = { 0U },
+    .hw_inst             = NULL,
+    .sub_timers_periods  = { 0 },
+    .timers_user_cb      = { NULL, NULL, NULL, NULL },
+    .alarm_cb            = NULL,
+    .is_alarm_ch_started = FALSE,
+    .ch_stats            = { { { 0U } } }
 };
 
 void hal_channel_tim_cb(TIM_HandleTypeDef* ppt_htim)
@@ -25,17 +34,25 @@ void hal_channel_tim_cb(TIM_HandleTypeDef* ppt_htim)
                                 &ppt_htim->Instance->CCR2,
                                 &ppt_htim->Instance->CCR3,
                                 &ppt_htim->Instance->CCR4 };
-    uint8_t idx = __builtin_ctz(ppt_htim->Channel);
-    
-    // Update CCRx first for the next interrupt
-    *(ccrs[idx]) += g_timer_drv.sub_timers_periods[idx];
-    
-    // Check for overrun - if counter already passed the new compare value
-    if ((int32_t)(*(ccrs[idx]) - ppt_htim->Instance->CNT) < 0) {
-        // Already missed next interrupt time - adjust CCR
-        *(ccrs[idx]) = ppt_htim->Instance->CNT + g_timer_drv.sub_timers_periods[idx];
+    uint8_t  idx     = __builtin_ctz(ppt_htim->Channel);
+    uint32_t counter = ppt_htim->Instance->CNT;
+
+    // The alarm is one-shot, the user reprograms it from the callback
+    if ((idx == TIMER_10US) && (g_timer_drv.alarm_cb != NULL))
+    {
+        __HAL_TIM_DISABLE_IT(ppt_htim, TIM_IT_CC1);
+        (void)mp_timer_stats_on_fire(&g_timer_drv.ch_stats[idx], *(ccrs[idx]), counter, 0U);
+        g_timer_drv.alarm_cb();
+        return;
     }
-    
+
+    // Update CCRx first for the next interrupt, periods that already passed
+    // are skipped on the grid and counted as overruns
+    *(ccrs[idx]) = mp_timer_stats_on_fire(&g_timer_drv.ch_stats[idx],
+                                          *(ccrs[idx]),
+                                          counter,
+                                          g_timer_drv.sub_timers_periods[idx]);
+
     // Then call user callback
     if (g_timer_drv.timers_user_cb[idx] != NULL)
     {
@@ -59,6 +76,12 @@ static response_status_t init(void)
         CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
         DWT->CYCCNT       = 0;
         DWT->CTRL        |= DWT_CTRL_CYCCNTENA_Msk;
+        SCB->SCR         |= SCB_SCR_SEVONPEND_Msk; // masked interrupts end the idle sleep
+        // Keep the counter running even if no channel is started
+        if (HAL_TIM_Base_Start(g_timer_drv.hw_inst) != HAL_OK)
+        {
+            ret_val = RET_ERROR;
+        }
     }
     else
     {
@@ -80,6 +103,7 @@ static inline HAL_StatusTypeDef oc_start_periodic(mp_timer_id_t p_timer_id, uint
 
     __HAL_TIM_DISABLE_IT(pt_htim, it_bit);
     __HAL_TIM_CLEAR_IT(pt_htim, it_bit);
+    mp_timer_stats_restart(&g_timer_drv.ch_stats[p_timer_id]);
 
     // Optional but nice: clear any pending NVIC for this timer
     // NVIC_ClearPendingIRQ(TIM2_IRQn); // use correct IRQn for your timer
@@ -113,6 +137,10 @@ static response_status_t start(mp_timer_id_t p_timer_id)
     switch (p_timer_id)
     {
         case TIMER_10US:
+            if (g_timer_drv.alarm_cb != NULL)
+            {
+                return RET_BUSY; // channel is used by the alarm
+            }
             hal_ret = oc_start_periodic(p_timer_id, TIM_CHANNEL_1);
             break;
         case TIMER_1MS:
@@ -166,6 +194,11 @@ static response_status_t register_callback(mp_timer_id_t p_timer_id, void (*ppt_
     ASSERT_AND_RETURN(ppt_callback == NULL, RET_PARAM_ERROR);
     ASSERT_AND_RETURN(p_timer_id >= TIMER_CNT, RET_NOT_SUPPORTED);
 
+    if ((p_timer_id == TIMER_10US) && (g_timer_drv.alarm_cb != NULL))
+    {
+        return RET_BUSY; // channel is used by the alarm
+    }
+
     CRITICAL_ENTER();
     // If it's the first time we register a callback for this timer, we need to register the HAL
     // callback
@@ -245,14 +278,136 @@ static void hard_delay(uint32_t p_delay, mp_timer_unit_t p_delay_unit)
     }
 }
 
-static struct st_timer_driver_ifc g_interface = { .init              = init,
-                                                  .start             = start,
-                                                  .stop              = stop,
-                                                  .register_callback = register_callback,
-                                                  .get_state         = get_state,
-                                                  .get_frequency     = NULL,
-                                                  .hard_delay        = hard_delay,
-                                                  .get_cpu_time      = get_cpu_time };
+static uint32_t get_counter(void)
+{
+    ASSERT_AND_RETURN(g_timer_drv.hw_inst == NULL, 0U);
+
+    return __HAL_TIM_GET_COUNTER(g_timer_drv.hw_inst);
+}
+
+static response_status_t set_alarm(uint32_t p_deadline)
+{
+    ASSERT_AND_RETURN(g_timer_drv.hw_inst == NULL, RET_NOT_INITIALIZED);
+    ASSERT_AND_RETURN(g_timer_drv.alarm_cb == NULL, RET_NOT_INITIALIZED);
+
+    HAL_StatusTypeDef  hal_ret = HAL_OK;
+    TIM_HandleTypeDef* pt_htim = g_timer_drv.hw_inst;
+
+    __HAL_TIM_DISABLE_IT(pt_htim, TIM_IT_CC1);
+    __HAL_TIM_SET_COMPARE(pt_htim, TIM_CHANNEL_1, p_deadline);
+    __HAL_TIM_CLEAR_IT(pt_htim, TIM_IT_CC1);
+
+    // A passed or too close deadline would only match after a wrap around
+    if ((int32_t)(p_deadline - __HAL_TIM_GET_COUNTER(pt_htim)) < (int32_t)MP_TIMER_MIN_LEAD)
+    {
+        __HAL_TIM_SET_COMPARE(pt_htim,
+                              TIM_CHANNEL_1,
+                              __HAL_TIM_GET_COUNTER(pt_htim) + MP_TIMER_MIN_LEAD);
+    }
+
+    if (g_timer_drv.is_alarm_ch_started == FALSE)
+    {
+        hal_ret = HAL_TIM_OC_Start(pt_htim, TIM_CHANNEL_1);
+        if (hal_ret == HAL_OK)
+        {
+            g_timer_drv.is_alarm_ch_started = TRUE;
+        }
+    }
+
+    __HAL_TIM_ENABLE_IT(pt_htim, TIM_IT_CC1);
+
+    return translate_hal_status(hal_ret);
+}
+
+static void cancel_alarm(void)
+{
+    ASSERT_AND_RETURN(g_timer_drv.hw_inst == NULL, );
+
+    __HAL_TIM_DISABLE_IT(g_timer_drv.hw_inst, TIM_IT_CC1);
+    __HAL_TIM_CLEAR_IT(g_timer_drv.hw_inst, TIM_IT_CC1);
+}
+
+static response_status_t register_alarm_callback(void (*ppt_callback)(void))
+{
+    ASSERT_AND_RETURN(g_timer_drv.hw_inst == NULL, RET_NOT_INITIALIZED);
+    ASSERT_AND_RETURN(ppt_callback == NULL, RET_PARAM_ERROR);
+
+    CRITICAL_ENTER();
+    if (g_timer_drv.timers_user_cb[TIMER_10US] != NULL)
+    {
+        CRITICAL_EXIT();
+        return RET_BUSY; // channel is used by the periodic timer
+    }
+    HAL_TIM_RegisterCallback(g_timer_drv.hw_inst,
+                             HAL_TIM_OC_DELAY_ELAPSED_CB_ID,
+                             hal_channel_tim_cb);
+    g_timer_drv.alarm_cb = ppt_callback;
+    CRITICAL_EXIT();
+
+    return RET_OK;
+}
+
+static response_status_t get_stats(mp_timer_id_t p_timer_id, ha_timer_stats_t* ppt_stats)
+{
+    ASSERT_AND_RETURN(p_timer_id >= TIMER_CNT, RET_PARAM_ERROR);
+    ASSERT_AND_RETURN(ppt_stats == NULL, RET_PARAM_ERROR);
+
+    // Updated by the timer interrupt
+    CRITICAL_ENTER();
+    *ppt_stats = g_timer_drv.ch_stats[p_timer_id].stats;
+    CRITICAL_EXIT();
+
+    return RET_OK;
+}
+
+static void reset_stats(void)
+{
+    CRITICAL_ENTER();
+    for (uint32_t i = 0U; i < TIMER_CNT; i++)
+    {
+        memset(&g_timer_drv.ch_stats[i].stats, 0, sizeof(ha_timer_stats_t));
+    }
+    CRITICAL_EXIT();
+}
+
+static uint32_t get_cycles(void)
+{
+    return DWT->CYCCNT;
+}
+
+/**
+ * @brief Sleeps with the interrupts masked, so the idle probe ends before the
+ * interrupt that woke the core is served. An interrupt taken since the last
+ * sleep has set the event register, and SEVONPEND sets it for an interrupt
+ * that becomes pending while masked, either way WFE returns at once.
+ */
+static void wait_for_interrupt(void)
+{
+    CRITICAL_ENTER();
+    SU_PROF_ENTER(SU_PROF_IDLE);
+    __WFE();
+    SU_PROF_EXIT(SU_PROF_IDLE);
+    CRITICAL_EXIT();
+}
+
+static struct st_timer_driver_ifc g_interface = {
+    .init                    = init,
+    .start                   = start,
+    .stop                    = stop,
+    .register_callback       = register_callback,
+    .get_state               = get_state,
+    .get_frequency           = NULL,
+    .hard_delay              = hard_delay,
+    .get_cpu_time            = get_cpu_time,
+    .get_counter             = get_counter,
+    .get_cycles              = get_cycles,
+    .set_alarm               = set_alarm,
+    .cancel_alarm            = cancel_alarm,
+    .register_alarm_callback = register_alarm_callback,
+    .wait_for_interrupt      = wait_for_interrupt,
+    .get_stats               = get_stats,
+    .reset_stats             = reset_stats,
+};
 
 timer_driver_t* timer_driver_register(void)
 {
@@ -0,0 +1,43 @@
+#include "mp_timer_pulse.h"
+
+/**
+ * @brief This function gets the width of a pulse captured by two edges of a
+ * free running counter, one reload of the counter between them is allowed.
+ * @param[in] p_rising_ccr Capture of the rising edge.
+ * @param[in] p_falling_ccr Capture of the falling edge.
+ * @param[in] p_arr Reload value of the counter.
+ * @return The width in counter ticks.
+ */
+uint32_t mp_timer_pulse_width(uint32_t p_rising_ccr, uint32_t p_falling_ccr, uint32_t p_arr)
+{
+    if (p_falling_ccr >= p_rising_ccr)
+    {
+        return p_falling_ccr - p_rising_ccr;
+    }
+
+    return (p_arr - p_rising_ccr + 1U) + p_falling_ccr;
+}
+
+/**
+ * @brief This function validates the captures of the PWM input mode. The
+ * rising edge resets the counter and latches the period, the falling edge
+ * latches the width. A width without a rising edge since the last read, e.g.
+ * the first falling edge after the start, is dropped.
+ * @param[in] p_rising_seen TRUE if the period capture flag was set.
+ * @param[in] p_period_ccr Capture of the rising edge, the last period.
+ * @param[in] p_width_ccr Capture of the falling edge.
+ * @param[out] ppt_width Width in counter ticks.
+ * @return TRUE if the width is valid.
+ */
+bool_t mp_timer_pwm_width(bool_t p_rising_seen, uint32_t p_period_ccr, uint32_t p_width_ccr,
+                          uint32_t* ppt_width)
+{
+    if ((p_rising_seen == FALSE) || (p_width_ccr >= p_period_ccr))
+    {
+        return FALSE;
+    }
+
+    *ppt_width = p_width_ccr;
+
+    return TRUE;
+}
@@ -0,0 +1,10 @@
+#ifndef MP_TIMER_PULSE_H
+#define MP_TIMER_PULSE_H
+
+#include "su_common.h"
+
+uint32_t mp_timer_pulse_width(uint32_t p_rising_ccr, uint32_t p_falling_ccr, uint32_t p_arr);
+bool_t   mp_timer_pwm_width(bool_t p_rising_seen, uint32_t p_period_ccr, uint32_t p_width_ccr,
+                            uint32_t* ppt_width);
+
+#endif // MP_TIMER_PULSE_H
@@ -0,0 +1,71 @@
+#include "mp_timer_stats.h"
+
+static uint32_t jitter_bin(uint32_t p_delta)
+{
+    uint32_t bin = (p_delta == 0U) ? 0U : (32U - (uint32_t)__builtin_clz(p_delta));
+
+    return (bin < HA_TIMER_JITTER_BINS) ? bin : (HA_TIMER_JITTER_BINS - 1U);
+}
+
+/**
+ * @brief This function accounts the service of a compare interrupt and gets
+ * the next compare value of a periodic channel. The next value stays on the
+ * grid of the first one, periods that already passed are skipped and counted
+ * as overruns instead of shifting the grid.
+ * @param[in,out] ppt_ch Statistics of the channel.
+ * @param[in] p_compare Compare value that matched.
+ * @param[in] p_counter Counter value at the start of the service.
+ * @param[in] p_period Period of the channel in ticks, 0 for the one-shot alarm.
+ * @return The next compare value, `p_compare` for the alarm.
+ */
+uint32_t mp_timer_stats_on_fire(mp_timer_stats_t* ppt_ch, uint32_t p_compare, uint32_t p_counter,
+                                uint32_t p_period)
+{
+    uint32_t late_ticks = p_counter - p_compare;
+
+    if ((int32_t)late_ticks < 0)
+    {
+        late_ticks = 0U; // Served before the match, e.g. a rewritten compare
+    }
+
+    ppt_ch->stats.fire_cnt++;
+    if (late_ticks > ppt_ch->stats.max_late_ticks)
+    {
+        ppt_ch->stats.max_late_ticks = late_ticks;
+    }
+    if (p_period == 0U)
+    {
+        return p_compare;
+    }
+
+    if (ppt_ch->has_fired == TRUE)
+    {
+        uint32_t delta = (late_ticks > ppt_ch->last_late_ticks)
+                           ? (late_ticks - ppt_ch->last_late_ticks)
+                           : (ppt_ch->last_late_ticks - late_ticks);
+
+        ppt_ch->stats.jitter_hist[jitter_bin(delta)]++;
+    }
+    ppt_ch->last_late_ticks = late_ticks;
+    ppt_ch->has_fired       = TRUE;
+
+    // First period far enough after the counter, at least the next one
+    uint32_t periods = (late_ticks + MP_TIMER_MIN_LEAD + p_period - 1U) / p_period;
+
+    if (periods == 0U)
+    {
+        periods = 1U;
+    }
+    ppt_ch->stats.overrun_cnt += periods - 1U;
+
+    return p_compare + (periods * p_period);
+}
+
+/**
+ * @brief This function is called when a channel is (re)started, the gap to
+ * the last fire is no jitter.
+ */
+void mp_timer_stats_restart(mp_timer_stats_t* ppt_ch)
+{
+    ppt_ch->has_fired = FALSE;
+}
@@ -0,0 +1,20 @@
+#ifndef MP_TIMER_STATS_H
+#define MP_TIMER_STATS_H
+
+#include "ha_timer/ha_timer_private.h"
+
+/// Ticks between the counter and a compare value that is still safe to arm
+#define MP_TIMER_MIN_LEAD (2U)
+
+typedef struct
+{
+    ha_timer_stats_t stats;
+    uint32_t         last_late_ticks;
+    bool_t           has_fired; // Jitter is measured from the second fire on
+} mp_timer_stats_t;
+
+uint32_t mp_timer_stats_on_fire(mp_timer_stats_t* ppt_ch, uint32_t p_compare, uint32_t p_counter,
+                                uint32_t p_period);
+void     mp_timer_stats_restart(mp_timer_stats_t* ppt_ch);
+
+#endif // MP_TIMER_STATS_H
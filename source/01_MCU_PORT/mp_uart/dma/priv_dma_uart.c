@@ -9,18 +9,23 @@
 typedef struct st_stm32_uart_dma_driver
 {
     UART_HandleTypeDef* const * hw_insts;
+    uint32_t                    hw_inst_cnt;
     volatile uint32_t           dma_in_progress;
     bool_t                      hw_insts_registered;
     dma_tx_evt_cb               user_cb[UART_PORT_CNT];
+    uint8_t*                    rx_buf[UART_PORT_CNT];
+    uint16_t                    rx_buf_sz[UART_PORT_CNT];
+    dma_rx_evt_cb               rx_cb[UART_PORT_CNT];
 } stm32_uart_dma_driver_t;
 
 static stm32_uart_dma_driver_t g_uart_dma_drv = { .hw_insts            = NULL,
+                                                  .hw_inst_cnt         = 0U,
                                                   .dma_in_progress     = 0x00,
                                                   .hw_insts_registered = FALSE };
 
 static uint32_t get_inst_idx(UART_HandleTypeDef* ppt_huart)
 {
-    for (uint32_t i = 0; i < __builtin_popcount(g_uart_dma_drv.dma_in_progress); i++)
+    for (uint32_t i = 0; i < g_uart_dma_drv.hw_inst_cnt; i++)
     {
         if (ppt_huart == g_uart_dma_drv.hw_insts[i])
         {
@@ -60,7 +65,44 @@ void dma_tx_abort_cb(UART_HandleTypeDef* ppt_huart)
     }
 }
 
-/* Error handler */
+/**
+ * @brief This function (re)starts the circular reception of a port. The
+ * reception is reported on idle line and on the buffer wrap, the half
+ * transfer interrupt is disabled as the idle line covers it.
+ */
+static response_status_t rx_start(mp_uart_ifc_idx_t p_ifc_index)
+{
+    UART_HandleTypeDef* pt_huart = g_uart_dma_drv.hw_insts[p_ifc_index];
+    HAL_StatusTypeDef   ret_hal  = HAL_OK;
+
+    ret_hal = HAL_UARTEx_ReceiveToIdle_DMA(pt_huart,
+                                           g_uart_dma_drv.rx_buf[p_ifc_index],
+                                           g_uart_dma_drv.rx_buf_sz[p_ifc_index]);
+    if (ret_hal == HAL_OK)
+    {
+        __HAL_DMA_DISABLE_IT(pt_huart->hdmarx, DMA_IT_HT);
+    }
+
+    return translate_hal_status(ret_hal);
+}
+
+/* Received data, the position is where the DMA writes next */
+void dma_rx_event_cb(UART_HandleTypeDef* ppt_huart, uint16_t p_pos)
+{
+    uint32_t ifc_index = get_inst_idx(ppt_huart);
+    if (ifc_index >= UART_PORT_CNT)
+    {
+        return;
+    }
+    if (g_uart_dma_drv.rx_cb[ifc_index] != NULL)
+    {
+        g_uart_dma_drv.rx_cb[ifc_index](ifc_index,
+                                        MP_UART_DMA_RX_EVT_DATA,
+                                        p_pos % g_uart_dma_drv.rx_buf_sz[ifc_index]);
+    }
+}
+
+/* Error handler, a reception error stops the DMA, the reception is restarted */
 void dma_tx_error_cb(UART_HandleTypeDef* ppt_huart)
 {
     uint32_t ifc_index = get_inst_idx(ppt_huart);
@@ -73,6 +115,13 @@ void dma_tx_error_cb(UART_HandleTypeDef* ppt_huart)
     {
         g_uart_dma_drv.user_cb[ifc_index](ifc_index, MP_UART_DMA_TX_EVT_ERROR);
     }
+    if ((g_uart_dma_drv.rx_buf[ifc_index] != NULL)
+        && (ppt_huart->RxState == HAL_UART_STATE_READY)
+        && (rx_start(ifc_index) == RET_OK)
+        && (g_uart_dma_drv.rx_cb[ifc_index] != NULL))
+    {
+        g_uart_dma_drv.rx_cb[ifc_index](ifc_index, MP_UART_DMA_RX_EVT_RESTART, 0U);
+    }
 }
 
 bool_t dma_tx_in_progress(mp_uart_ifc_idx_t p_ifc_index)
@@ -121,18 +170,53 @@ response_status_t dma_tx_register_callback(mp_uart_ifc_idx_t p_ifc_index, dma_tx
     return RET_OK;
 }
 
-void dma_hw_insts_register(UART_HandleTypeDef* const * ppt_hw_insts)
+/**
+ * @brief This function starts the continuous reception of a port into a
+ * circular buffer. The DMA keeps writing around the buffer, the callback
+ * gets the write position and the consumer has to keep up with it.
+ */
+response_status_t dma_rx_start(mp_uart_ifc_idx_t p_ifc_index, uint8_t* ppt_buffer,
+                               size_t p_buffer_sz)
+{
+    ASSERT_AND_RETURN(g_uart_dma_drv.hw_insts_registered == FALSE, RET_NOT_INITIALIZED);
+    ASSERT_AND_RETURN(p_ifc_index >= g_uart_dma_drv.hw_inst_cnt, RET_NOT_SUPPORTED);
+    ASSERT_AND_RETURN(p_buffer_sz > UINT16_MAX, RET_PARAM_ERROR);
+
+    if (g_uart_dma_drv.hw_insts[p_ifc_index]->hdmarx == NULL)
+    {
+        return RET_NOT_SUPPORTED; // No DMA stream on the receiver
+    }
+
+    g_uart_dma_drv.rx_buf[p_ifc_index]    = ppt_buffer;
+    g_uart_dma_drv.rx_buf_sz[p_ifc_index] = (uint16_t)p_buffer_sz;
+
+    return rx_start(p_ifc_index);
+}
+
+response_status_t dma_rx_register_callback(mp_uart_ifc_idx_t p_ifc_index, dma_rx_evt_cb ppt_evt_cb)
+{
+    ASSERT_AND_RETURN(g_uart_dma_drv.hw_insts_registered == FALSE, RET_NOT_INITIALIZED);
+    ASSERT_AND_RETURN(p_ifc_index >= g_uart_dma_drv.hw_inst_cnt, RET_NOT_SUPPORTED);
+
+    g_uart_dma_drv.rx_cb[p_ifc_index] = ppt_evt_cb;
+
+    return RET_OK;
+}
+
+void dma_hw_insts_register(UART_HandleTypeDef* const * ppt_hw_insts, uint32_t p_hw_inst_cnt)
 {
-    g_uart_dma_drv.hw_insts = ppt_hw_insts;
+    g_uart_dma_drv.hw_insts    = ppt_hw_insts;
+    g_uart_dma_drv.hw_inst_cnt = (p_hw_inst_cnt < UART_PORT_CNT) ? p_hw_inst_cnt : UART_PORT_CNT;
     if (ppt_hw_insts != NULL)
     {
-        for (uint32_t i = 0; i < UART_PORT_CNT; i++)
+        for (uint32_t i = 0; i < g_uart_dma_drv.hw_inst_cnt; i++)
         {
             HAL_UART_RegisterCallback(ppt_hw_insts[i], HAL_UART_TX_COMPLETE_CB_ID, dma_tx_finished_cb);
             HAL_UART_RegisterCallback(ppt_hw_insts[i],
                                       HAL_UART_ABORT_TRANSMIT_COMPLETE_CB_ID,
                                       dma_tx_abort_cb);
             HAL_UART_RegisterCallback(ppt_hw_insts[i], HAL_UART_ERROR_CB_ID, dma_tx_error_cb);
+            HAL_UART_RegisterRxEventCallback(ppt_hw_insts[i], dma_rx_event_cb);
         }
     }
     g_uart_dma_drv.hw_insts_registered = (ppt_hw_insts != NULL);
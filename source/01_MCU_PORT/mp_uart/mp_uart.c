@@ -38,7 +38,7 @@ static response_status_t init(void)
             }
         }
     }
-    dma_hw_insts_register(g_uart_drv.hw_insts);
+    dma_hw_insts_register(g_uart_drv.hw_insts, g_uart_drv.base.hw_inst_cnt);
     return ret_val;
 }
 
@@ -93,7 +93,9 @@ static struct st_uart_driver_ifc g_interface = { .init                 = init,
                                                  .transmit             = write,
                                                  .dma_register_cb      = dma_tx_register_callback,
                                                  .dma_transmit_abort   = dma_tx_abort,
-                                                 .dma_transmit_request = dma_tx_start };
+                                                 .dma_transmit_request = dma_tx_start,
+                                                 .dma_receive_start    = dma_rx_start,
+                                                 .dma_register_rx_cb   = dma_rx_register_callback };
 
 uart_driver_t* uart_driver_register(void)
 {
@@ -6,8 +6,25 @@
 #include "stdint.h"
 #include "su_common.h"
 
-static gpio_driver g_pt_io_drv    = NULL;
-static bool_t      g_io_drv_ready = FALSE;
+#define GP_IN_PIN_CNT (GP_PIN_CNT - GP_OUT_PIN_CNT)
+
+static gpio_driver         g_pt_io_drv    = NULL;
+static bool_t              g_io_drv_ready = FALSE;
+static gpio_irq_callback_t g_irq_callbacks[GP_IN_PIN_CNT];
+
+/**
+ * @brief This function is called by the hardware driver in the interrupt
+ * context and forwards the event to the user callback of the input pin.
+ * @param[in] p_pin The pin number that triggered the interrupt.
+ */
+static void irq_dispatcher(uint8_t p_pin)
+{
+    if ((p_pin >= GP_OUT_PIN_CNT) && (p_pin < GP_PIN_CNT)
+        && (g_irq_callbacks[p_pin - GP_OUT_PIN_CNT] != NULL))
+    {
+        g_irq_callbacks[p_pin - GP_OUT_PIN_CNT]((gpio_pins_t)p_pin);
+    }
+}
 
 /**
  * @brief This function sets the pin state to logic high or low.
@@ -102,6 +119,28 @@ response_status_t ha_gpio_toggle(gpio_pins_t p_pin)
     return ret_val;
 }
 
+/**
+ * @brief This function registers a callback to be called when an edge is
+ * detected on an input pin. The callback is executed in the interrupt context
+ * so it shall be kept short.
+ *
+ * @param[in] p_pin The input pin to watch.
+ * @param[in] ppt_callback The function to call, NULL to unregister.
+ * @return Result of the operation.
+ */
+response_status_t ha_gpio_register_callback(gpio_pins_t p_pin, gpio_irq_callback_t ppt_callback)
+{
+    ASSERT_AND_RETURN(g_io_drv_ready == FALSE, RET_NOT_INITIALIZED);
+    /// Ensure the pin is an input pin
+    ASSERT_AND_RETURN(p_pin < GP_OUT_PIN_CNT || p_pin >= GP_PIN_CNT, RET_PARAM_ERROR);
+    ASSERT_AND_RETURN(p_pin >= g_pt_io_drv->hw_pin_cnt, RET_NOT_SUPPORTED);
+    ASSERT_AND_RETURN(g_pt_io_drv->api->register_irq_callback == NULL, RET_NOT_SUPPORTED);
+
+    g_irq_callbacks[p_pin - GP_OUT_PIN_CNT] = ppt_callback;
+
+    return RET_OK;
+}
+
 /**
  * @brief This function initializes the GPIO driver once per power cycle. With
  * no consequences multiple calls.
@@ -124,6 +163,11 @@ response_status_t ha_gpio_init(void)
             g_pt_io_drv->hw_pin_cnt = 0;
             ret_val                 = g_pt_io_drv->api->init();
 
+            if ((ret_val == RET_OK) && (g_pt_io_drv->api->register_irq_callback != NULL))
+            {
+                ret_val = g_pt_io_drv->api->register_irq_callback(irq_dispatcher);
+            }
+
             if (ret_val == RET_OK)
             {
                 g_io_drv_ready = TRUE;
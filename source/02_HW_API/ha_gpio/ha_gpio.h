@@ -26,9 +26,17 @@ typedef enum en_gpio_pin_state
     GP_PIN_SET = 1
 } gpio_pin_state_t;
 
+/**
+ * @brief Callback called from the interrupt context when an edge is detected
+ * on an input pin.
+ * @param[in] p_pin The input pin that triggered the interrupt.
+ */
+typedef void (*gpio_irq_callback_t)(gpio_pins_t p_pin);
+
 response_status_t ha_gpio_set(gpio_pins_t p_pin, gpio_pin_state_t p_value);
 response_status_t ha_gpio_get(gpio_pins_t p_pin, gpio_pin_state_t* ppt_value);
 response_status_t ha_gpio_toggle(gpio_pins_t p_pin);
+response_status_t ha_gpio_register_callback(gpio_pins_t p_pin, gpio_irq_callback_t ppt_callback);
 response_status_t ha_gpio_init(void);
 
 #endif // HA_GPIO_H
@@ -54,6 +54,17 @@ struct st_gpio_driver_ifc
      * @retval `RET_NOT_INITIALIZED` if the interface is not initialized.
      */
     response_status_t (*toggle)(uint8_t);
+    /**
+     * @brief This function shall register the function to be called from the
+     * interrupt context when an edge is detected on an interrupt capable pin.
+     * @param[in] void (*)(uint8_t) callback function, it receives the pin
+     * number that triggered the interrupt.
+     * @retval `RET_OK` if the callback is registered successfully.
+     * @retval `RET_PARAM_ERROR` if the callback is NULL.
+     * @retval `RET_NOT_SUPPORTED` if the hardware does not support pin
+     * interrupts.
+     */
+    response_status_t (*register_irq_callback)(void (*)(uint8_t));
 };
 
 #endif /* HA_GPIO_PRIVATE_H */
@@ -1,12 +1,262 @@
 #include "ha_iic.h"
 
 #include "ha_iic_private.h"
+#include "ha_timer/ha_timer.h"
 #include "mp_iic/mp_iic.h"
 #include "stddef.h"
+#include "string.h"
 #include "su_common.h"
+#include "su_profiler/su_profiler.h"
+#include "su_trace/su_trace.h"
 
-static iic_driver g_pt_iic_drv    = NULL;
-static bool_t     g_iic_drv_ready = FALSE;
+/// Attempts after a not acknowledged one, a NACK only costs the address phase
+#define IIC_MAX_RETRIES        (2U)
+#define IIC_MAX_TRACKED_DEVS   (8U)
+/// A device stalling the bus on this many calls in a row is backed off
+#define IIC_BACKOFF_MIN_STALLS (2U)
+/// A stalling device is skipped for 1, 2, 4 ... up to this many transfers
+#define IIC_BACKOFF_MAX_SKIPS  (64U)
+
+typedef enum
+{
+    IIC_XFER_WRITE = 0x00,
+    IIC_XFER_READ,
+    IIC_XFER_MEM_WRITE,
+    IIC_XFER_MEM_READ,
+} iic_xfer_type_t;
+
+typedef struct
+{
+    iic_xfer_type_t type;
+    uint8_t         port;
+    uint8_t         dev_addr;
+    uint16_t        mem_addr;
+    uint8_t         mem_size;
+    const uint8_t*  pt_tx_data;
+    uint8_t*        pt_rx_data;
+    size_t          data_size;
+    timeout_t       timeout_ms;
+} iic_xfer_t;
+
+typedef struct
+{
+    bool_t          is_used;
+    uint8_t         port;
+    uint8_t         dev_addr;
+    uint16_t        backoff;
+    uint16_t        skip_left;
+    uint16_t        stall_streak;
+    iic_dev_stats_t stats;
+} iic_dev_entry_t;
+
+static iic_driver        g_pt_iic_drv     = NULL;
+static bool_t            g_iic_drv_ready  = FALSE;
+static iic_record_hook_t g_pt_record_hook = NULL;
+
+static iic_bus_stats_t g_bus_stats[IIC_PORT_CNT];
+static iic_dev_entry_t g_dev_entries[IIC_MAX_TRACKED_DEVS];
+
+static iic_dev_entry_t* get_dev_entry(uint8_t p_port, uint8_t p_dev_addr, bool_t p_create)
+{
+    iic_dev_entry_t* pt_free = NULL;
+
+    for (uint8_t i = 0U; i < IIC_MAX_TRACKED_DEVS; i++)
+    {
+        if (g_dev_entries[i].is_used == FALSE)
+        {
+            pt_free = (pt_free == NULL) ? &g_dev_entries[i] : pt_free;
+        }
+        else if ((g_dev_entries[i].port == p_port) && (g_dev_entries[i].dev_addr == p_dev_addr))
+        {
+            return &g_dev_entries[i];
+        }
+    }
+
+    if ((p_create == TRUE) && (pt_free != NULL))
+    {
+        memset(pt_free, 0U, sizeof(*pt_free));
+        pt_free->is_used  = TRUE;
+        pt_free->port     = p_port;
+        pt_free->dev_addr = p_dev_addr;
+    }
+    else
+    {
+        pt_free = NULL;
+    }
+
+    return pt_free;
+}
+
+static response_status_t run_xfer(const iic_xfer_t* ppt_xfer)
+{
+    response_status_t ret_val = RET_OK;
+
+    SU_PROF_ENTER(SU_PROF_IIC_XFER);
+    SU_TRACE(SU_TRACE_IIC_START, ppt_xfer->dev_addr);
+    switch (ppt_xfer->type)
+    {
+        case IIC_XFER_WRITE:
+            ret_val = g_pt_iic_drv->api->write(ppt_xfer->port,
+                                               ppt_xfer->dev_addr,
+                                               ppt_xfer->pt_tx_data,
+                                               ppt_xfer->data_size,
+                                               ppt_xfer->timeout_ms);
+            break;
+        case IIC_XFER_READ:
+            ret_val = g_pt_iic_drv->api->read(ppt_xfer->port,
+                                              ppt_xfer->dev_addr,
+                                              ppt_xfer->pt_rx_data,
+                                              ppt_xfer->data_size,
+                                              ppt_xfer->timeout_ms);
+            break;
+        case IIC_XFER_MEM_WRITE:
+            ret_val = g_pt_iic_drv->api->mem_write(ppt_xfer->port,
+                                                   ppt_xfer->dev_addr,
+                                                   ppt_xfer->mem_addr,
+                                                   ppt_xfer->mem_size,
+                                                   ppt_xfer->pt_tx_data,
+                                                   ppt_xfer->data_size,
+                                                   ppt_xfer->timeout_ms);
+            break;
+        case IIC_XFER_MEM_READ:
+            ret_val = g_pt_iic_drv->api->mem_read(ppt_xfer->port,
+                                                  ppt_xfer->dev_addr,
+                                                  ppt_xfer->mem_addr,
+                                                  ppt_xfer->mem_size,
+                                                  ppt_xfer->pt_rx_data,
+                                                  ppt_xfer->data_size,
+                                                  ppt_xfer->timeout_ms);
+            break;
+        default:
+            ret_val = RET_PARAM_ERROR;
+            break;
+    }
+    SU_TRACE(SU_TRACE_IIC_END, ret_val);
+    SU_PROF_EXIT(SU_PROF_IIC_XFER);
+
+    return ret_val;
+}
+
+static void update_dev_entry(iic_dev_entry_t* ppt_entry, response_status_t p_result)
+{
+    if (ppt_entry == NULL)
+    {
+        return;
+    }
+
+    ppt_entry->stats.xfer_cnt++;
+    if (p_result == RET_OK)
+    {
+        ppt_entry->stats.consec_err_cnt = 0U;
+    }
+    else
+    {
+        ppt_entry->stats.err_cnt++;
+        ppt_entry->stats.consec_err_cnt++;
+    }
+
+    /// Only a bus that keeps stalling costs timeouts, a NACK answers fast and is not backed off
+    if ((p_result != RET_BUSY) && (p_result != RET_TIMEOUT))
+    {
+        ppt_entry->stall_streak = 0U;
+        ppt_entry->backoff      = 0U;
+        return;
+    }
+
+    ppt_entry->stall_streak++;
+    if (ppt_entry->stall_streak >= IIC_BACKOFF_MIN_STALLS)
+    {
+        ppt_entry->backoff   = (ppt_entry->backoff == 0U) ? 1U
+                                                         : (uint16_t)(ppt_entry->backoff * 2U);
+        ppt_entry->backoff   = (ppt_entry->backoff > IIC_BACKOFF_MAX_SKIPS) ? IIC_BACKOFF_MAX_SKIPS
+                                                                            : ppt_entry->backoff;
+        ppt_entry->skip_left = ppt_entry->backoff;
+    }
+}
+
+/**
+ * @brief This internal function runs a transfer with the retry policy. A
+ * NACK is retried as is. A transfer that ends with busy or timeout means the
+ * bus is stalled: the bus is recovered and the transfer retried once. A
+ * failed recovery or a second stall ends the call, so a dead bus costs a
+ * single timeout and recovery per call. A device that stalls the bus on
+ * consecutive calls is backed off, its transfers are rejected with
+ * `RET_BUSY` without using the bus.
+ * @param[in] ppt_xfer Transfer to run.
+ * @return Result of the last attempt.
+ */
+static response_status_t xfer_with_retry(const iic_xfer_t* ppt_xfer)
+{
+    response_status_t ret_val   = RET_OK;
+    iic_bus_stats_t*  pt_stats  = &g_bus_stats[ppt_xfer->port];
+    iic_dev_entry_t*  pt_entry  = get_dev_entry(ppt_xfer->port, ppt_xfer->dev_addr, TRUE);
+    uint32_t          start_us  = 0U;
+    uint32_t          xfer_us   = 0U;
+    bool_t            recovered = FALSE;
+
+    if ((pt_entry != NULL) && (pt_entry->skip_left > 0U))
+    {
+        pt_entry->skip_left--;
+        pt_entry->stats.skip_cnt++;
+        return RET_BUSY;
+    }
+
+    start_us = ha_timer_get_cpu_time_us();
+    pt_stats->xfer_cnt++;
+
+    for (uint8_t attempt = 0U; attempt <= IIC_MAX_RETRIES; attempt++)
+    {
+        if (attempt > 0U)
+        {
+            pt_stats->retry_cnt++;
+        }
+
+        ret_val = run_xfer(ppt_xfer);
+        if (ret_val == RET_OK)
+        {
+            break;
+        }
+
+        pt_stats->err_cnt++;
+        if ((ret_val == RET_BUSY) || (ret_val == RET_TIMEOUT))
+        {
+            pt_stats->stall_cnt++;
+            if ((recovered == TRUE)
+                || (ha_iic_bus_recover((iic_comm_port_t)ppt_xfer->port) != RET_OK))
+            {
+                /// Another timeout would not find the bus in a better state
+                break;
+            }
+            recovered = TRUE;
+        }
+        else if (ret_val != RET_ERROR)
+        {
+            /// Parameter or configuration errors do not improve with a retry
+            break;
+        }
+    }
+
+    xfer_us = ha_timer_get_cpu_time_us() - start_us;
+    if (xfer_us > pt_stats->max_xfer_us)
+    {
+        pt_stats->max_xfer_us = xfer_us;
+    }
+
+    update_dev_entry(pt_entry, ret_val);
+
+    if ((ret_val == RET_OK) && (g_pt_record_hook != NULL)
+        && ((ppt_xfer->type == IIC_XFER_READ) || (ppt_xfer->type == IIC_XFER_MEM_READ)))
+    {
+        g_pt_record_hook((iic_comm_port_t)ppt_xfer->port,
+                         ppt_xfer->dev_addr,
+                         ppt_xfer->mem_addr,
+                         (ppt_xfer->type == IIC_XFER_MEM_READ) ? ppt_xfer->mem_size : 0U,
+                         ppt_xfer->pt_rx_data,
+                         ppt_xfer->data_size);
+    }
+
+    return ret_val;
+}
 
 /**
  * @brief This function sends data to an I2C device.
@@ -29,12 +279,14 @@ response_status_t ha_iic_master_write(iic_comm_port_t p_port, uint8_t p_slave_ad
     ASSERT_AND_RETURN(p_data_size == 0, RET_PARAM_ERROR);
     ASSERT_AND_RETURN(p_timeout_ms == 0, RET_PARAM_ERROR);
 
-    response_status_t ret_val = RET_OK;
-
-    ret_val =
-      g_pt_iic_drv->api->write(p_port, p_slave_addr, ppt_data_buffer, p_data_size, p_timeout_ms);
+    iic_xfer_t xfer = { .type       = IIC_XFER_WRITE,
+                        .port       = p_port,
+                        .dev_addr   = p_slave_addr,
+                        .pt_tx_data = ppt_data_buffer,
+                        .data_size  = p_data_size,
+                        .timeout_ms = p_timeout_ms };
 
-    return ret_val;
+    return xfer_with_retry(&xfer);
 }
 
 /**
@@ -59,12 +311,14 @@ response_status_t ha_iic_master_read(iic_comm_port_t p_port, uint8_t p_slave_add
     ASSERT_AND_RETURN(p_data_size == 0, RET_PARAM_ERROR);
     ASSERT_AND_RETURN(p_timeout_ms == 0, RET_PARAM_ERROR);
 
-    response_status_t ret_val = RET_OK;
-
-    ret_val =
-      g_pt_iic_drv->api->read(p_port, p_slave_addr, ppt_data_buffer, p_data_size, p_timeout_ms);
+    iic_xfer_t xfer = { .type       = IIC_XFER_READ,
+                        .port       = p_port,
+                        .dev_addr   = p_slave_addr,
+                        .pt_rx_data = ppt_data_buffer,
+                        .data_size  = p_data_size,
+                        .timeout_ms = p_timeout_ms };
 
-    return ret_val;
+    return xfer_with_retry(&xfer);
 }
 
 /**
@@ -92,17 +346,16 @@ response_status_t ha_iic_master_mem_write(iic_comm_port_t p_port, uint8_t p_slav
     ASSERT_AND_RETURN(p_data_size == 0, RET_PARAM_ERROR);
     ASSERT_AND_RETURN(p_timeout_ms == 0, RET_PARAM_ERROR);
 
-    response_status_t ret_val = RET_OK;
-
-    ret_val = g_pt_iic_drv->api->mem_write(p_port,
-                                           p_slave_addr,
-                                           p_mem_addr,
-                                           p_mem_size,
-                                           ppt_data_buffer,
-                                           p_data_size,
-                                           p_timeout_ms);
+    iic_xfer_t xfer = { .type       = IIC_XFER_MEM_WRITE,
+                        .port       = p_port,
+                        .dev_addr   = p_slave_addr,
+                        .mem_addr   = p_mem_addr,
+                        .mem_size   = p_mem_size,
+                        .pt_tx_data = ppt_data_buffer,
+                        .data_size  = p_data_size,
+                        .timeout_ms = p_timeout_ms };
 
-    return ret_val;
+    return xfer_with_retry(&xfer);
 }
 
 /**
@@ -131,27 +384,54 @@ response_status_t ha_iic_master_mem_read(iic_comm_port_t p_port, uint8_t p_slave
     ASSERT_AND_RETURN(p_mem_size == 0, RET_PARAM_ERROR);
     ASSERT_AND_RETURN(p_timeout_ms == 0, RET_PARAM_ERROR);
 
-    response_status_t ret_val = RET_OK;
+    iic_xfer_t xfer = { .type       = IIC_XFER_MEM_READ,
+                        .port       = p_port,
+                        .dev_addr   = p_slave_addr,
+                        .mem_addr   = p_mem_addr,
+                        .mem_size   = p_mem_size,
+                        .pt_rx_data = ppt_data_buffer,
+                        .data_size  = p_data_size,
+                        .timeout_ms = p_timeout_ms };
 
-    ret_val = g_pt_iic_drv->api->mem_read(p_port,
-                                          p_slave_addr,
-                                          p_mem_addr,
-                                          p_mem_size,
-                                          ppt_data_buffer,
-                                          p_data_size,
-                                          p_timeout_ms);
-
-    return ret_val;
+    return xfer_with_retry(&xfer);
 }
 
 /**
- * @todo This function is not implemented yet.
- * @retval RET_NOT_SUPPORTED
+ * @brief This function recovers a bus stalled by a slave holding SDA low and
+ * re-initializes the I2C peripheral.
+ * @param[in] p_port I2C communication port.
+ * @return Result of the execution status.
+ * @retval `RET_NOT_SUPPORTED` if the port layer can not recover the bus.
  */
 response_status_t ha_iic_bus_recover(iic_comm_port_t p_port)
 {
-    (void)p_port; // Suppress unused parameter warning
-    return RET_NOT_SUPPORTED;
+    ASSERT_AND_RETURN(g_iic_drv_ready != TRUE, RET_NOT_INITIALIZED);
+    ASSERT_AND_RETURN(p_port >= g_pt_iic_drv->hw_inst_cnt, RET_NOT_SUPPORTED);
+
+    response_status_t ret_val  = RET_OK;
+    iic_bus_stats_t*  pt_stats = &g_bus_stats[p_port];
+    uint32_t          start_us = 0U;
+
+    if (g_pt_iic_drv->api->bus_recover == NULL)
+    {
+        return RET_NOT_SUPPORTED;
+    }
+
+    start_us = ha_timer_get_cpu_time_us();
+    ret_val  = g_pt_iic_drv->api->bus_recover(p_port);
+
+    pt_stats->recover_cnt++;
+    pt_stats->last_recover_us = ha_timer_get_cpu_time_us() - start_us;
+    if (pt_stats->last_recover_us > pt_stats->max_recover_us)
+    {
+        pt_stats->max_recover_us = pt_stats->last_recover_us;
+    }
+    if (ret_val != RET_OK)
+    {
+        pt_stats->recover_fail_cnt++;
+    }
+
+    return ret_val;
 }
 
 /**
@@ -175,6 +455,71 @@ response_status_t ha_iic_dev_check(iic_comm_port_t p_port, uint8_t p_dev_addr,
     return ret_val;
 }
 
+/**
+ * @brief This function probes an I2C address once. Unlike `ha_iic_dev_check`
+ * it does not retry, so an absent device costs a single address phase.
+ * @param[in] p_port I2C communication port.
+ * @param[in] p_dev_addr The address to probe.
+ * @param[in] p_timeout_ms Timeout for the operation in milliseconds. Should not
+ * be zero.
+ * @return Result of the execution status.
+ */
+response_status_t ha_iic_dev_probe(iic_comm_port_t p_port, uint8_t p_dev_addr,
+                                   timeout_t p_timeout_ms)
+{
+    ASSERT_AND_RETURN(g_iic_drv_ready != TRUE, RET_NOT_INITIALIZED);
+    ASSERT_AND_RETURN(p_port >= g_pt_iic_drv->hw_inst_cnt, RET_NOT_SUPPORTED);
+    ASSERT_AND_RETURN(p_timeout_ms == 0, RET_PARAM_ERROR);
+
+    response_status_t ret_val = RET_OK;
+
+    ret_val = g_pt_iic_drv->api->dev_probe(p_port, p_dev_addr, p_timeout_ms);
+
+    return ret_val;
+}
+
+/**
+ * @brief This function returns the bus statistics of a port.
+ * @param[in] p_port I2C communication port.
+ * @param[out] ppt_stats Pointer to store the statistics. Should not be NULL.
+ * @return Result of the execution status.
+ */
+response_status_t ha_iic_get_bus_stats(iic_comm_port_t p_port, iic_bus_stats_t* ppt_stats)
+{
+    ASSERT_AND_RETURN(p_port >= IIC_PORT_CNT, RET_NOT_SUPPORTED);
+    ASSERT_AND_RETURN(ppt_stats == NULL, RET_PARAM_ERROR);
+
+    *ppt_stats = g_bus_stats[p_port];
+
+    return RET_OK;
+}
+
+/**
+ * @brief This function returns the statistics of a device.
+ * @param[in] p_port I2C communication port.
+ * @param[in] p_dev_addr The address of the I2C device.
+ * @param[out] ppt_stats Pointer to store the statistics. Should not be NULL.
+ * @return Result of the execution status.
+ * @retval `RET_NOT_FOUND` if the device has not been accessed yet.
+ */
+response_status_t ha_iic_get_dev_stats(iic_comm_port_t p_port, uint8_t p_dev_addr,
+                                       iic_dev_stats_t* ppt_stats)
+{
+    ASSERT_AND_RETURN(p_port >= IIC_PORT_CNT, RET_NOT_SUPPORTED);
+    ASSERT_AND_RETURN(ppt_stats == NULL, RET_PARAM_ERROR);
+
+    iic_dev_entry_t* pt_entry = get_dev_entry(p_port, p_dev_addr, FALSE);
+
+    if (pt_entry == NULL)
+    {
+        return RET_NOT_FOUND;
+    }
+
+    *ppt_stats = pt_entry->stats;
+
+    return RET_OK;
+}
+
 /**
  * @brief This function initializes the I2C interface.
  * It shall get all hardware instances information from the MCU SDK.
@@ -186,6 +531,15 @@ response_status_t ha_iic_init(void)
 
     if (g_iic_drv_ready != TRUE)
     {
+        /// Transfer and recovery durations are measured with the CPU time
+        ret_val = ha_timer_init();
+        if (ret_val != RET_OK)
+        {
+            return ret_val;
+        }
+
+        memset(g_bus_stats, 0U, sizeof(g_bus_stats));
+        memset(g_dev_entries, 0U, sizeof(g_dev_entries));
         g_pt_iic_drv = iic_driver_register();
 
         if (g_pt_iic_drv == NULL)
@@ -205,3 +559,12 @@ response_status_t ha_iic_init(void)
 
     return ret_val;
 }
+
+/**
+ * @brief This function sets the observer of all successful reads, only one
+ * is kept. A NULL hook stops the observation.
+ */
+void ha_iic_register_record_hook(iic_record_hook_t ppt_hook)
+{
+    g_pt_record_hook = ppt_hook;
+}
@@ -64,6 +64,39 @@ typedef enum en_iic_mem_size
     HW_IIC_MEM_SZ_16BIT = 0x02,
 } i2c_mem_size_t;
 
+/// Bus level statistics, a stall is a transfer that ended with busy or timeout
+typedef struct
+{
+    uint32_t xfer_cnt;
+    uint32_t err_cnt;
+    uint32_t retry_cnt;
+    uint32_t stall_cnt;
+    uint32_t recover_cnt;
+    uint32_t recover_fail_cnt;
+    uint32_t last_recover_us;
+    uint32_t max_recover_us;
+    /// Longest time spent in a single transfer call, retries and recoveries included
+    uint32_t max_xfer_us;
+} iic_bus_stats_t;
+
+/// Per device statistics, a device is tracked after its first transfer
+typedef struct
+{
+    uint32_t xfer_cnt;
+    uint32_t err_cnt;
+    /// Transfers rejected without using the bus while the device is backed off
+    uint32_t skip_cnt;
+    uint16_t consec_err_cnt;
+} iic_dev_stats_t;
+
+/**
+ * @brief Observer of the bytes of every successful read, used to record the
+ * sensor inputs. It runs in the caller context of the read.
+ * @param p_mem_size Register address size in bytes, 0 for a plain read.
+ */
+typedef void (*iic_record_hook_t)(iic_comm_port_t p_port, uint8_t p_dev_addr, uint16_t p_mem_addr,
+                                  uint8_t p_mem_size, const uint8_t* ppt_data, size_t p_len);
+
 response_status_t ha_iic_init(void);
 response_status_t ha_iic_master_read(iic_comm_port_t p_port, uint8_t p_slave_addr,
                                      uint8_t* ppt_data_buffer, size_t p_data_size,
@@ -82,5 +115,11 @@ response_status_t ha_iic_master_mem_write(iic_comm_port_t p_port, uint8_t p_slav
 response_status_t ha_iic_bus_recover(iic_comm_port_t p_port);
 response_status_t ha_iic_dev_check(iic_comm_port_t p_port, uint8_t p_dev_addr,
                                    timeout_t p_timeout_ms);
+response_status_t ha_iic_dev_probe(iic_comm_port_t p_port, uint8_t p_dev_addr,
+                                   timeout_t p_timeout_ms);
+response_status_t ha_iic_get_bus_stats(iic_comm_port_t p_port, iic_bus_stats_t* ppt_stats);
+response_status_t ha_iic_get_dev_stats(iic_comm_port_t p_port, uint8_t p_dev_addr,
+                                       iic_dev_stats_t* ppt_stats);
+void              ha_iic_register_record_hook(iic_record_hook_t ppt_hook);
 
 #endif /* HA_IIC_H */
@@ -6,6 +6,7 @@
 #include "su_common.h"
 
 #define IIC_DEVICE_CHECK_TRIES 10U
+#define IIC_DEVICE_PROBE_TRIES 1U
 
 typedef struct st_iic_driver_ifc* iic_driver_ifc;
 
@@ -96,6 +97,17 @@ struct st_iic_driver_ifc
      * @return Result of the execution status.
      */
     response_status_t (*dev_check)(uint8_t, uint8_t, timeout_t);
+    /**
+     * @brief This function shall probe an I2C address with a single address
+     * phase `IIC_DEVICE_PROBE_TRIES` times, an absent device is reported as
+     * soon as it does not acknowledge.
+     * @param[in] uint8_t The index of the I2C interface to use.
+     * it's from 0 to `hw_inst_cnt - 1`.
+     * @param[in] uint8_t The address to probe.
+     * @param[in] timeout_t The timeout for the operation in milliseconds.
+     * @return Result of the execution status.
+     */
+    response_status_t (*dev_probe)(uint8_t, uint8_t, timeout_t);
 };
 
 #endif /* HA_IIC_PRIVATE_H */
@@ -3,8 +3,26 @@
 
 #include "mp_timer/mp_timer_capture.h"
 
-static ic_driver g_pt_ic_drv    = NULL;
-static bool_t    g_ic_drv_ready = FALSE;
+static ic_driver                 g_pt_ic_drv      = NULL;
+static bool_t                    g_ic_drv_ready   = FALSE;
+static ic_finished_callback_t    g_callbacks[INPUT_CAPTURE_CHANNEL_CNT];
+static volatile ic_record_hook_t g_pt_record_hook = NULL;
+
+/* The driver reports to this dispatcher, so a recorder sees each value before
+   the user callback of the channel */
+static void capture_dispatch(input_capture_channel_t p_chnl, uint32_t p_value)
+{
+    ic_record_hook_t pt_hook = g_pt_record_hook;
+
+    if (pt_hook != NULL)
+    {
+        pt_hook(p_chnl, p_value);
+    }
+    if ((p_chnl < INPUT_CAPTURE_CHANNEL_CNT) && (g_callbacks[p_chnl] != NULL))
+    {
+        g_callbacks[p_chnl](p_chnl, p_value);
+    }
+}
 
 response_status_t ha_input_capture_init(void)
 {
@@ -50,6 +68,16 @@ response_status_t ha_input_capture_request_capture(input_capture_channel_t p_chn
         case IC_MEASURE_FREQUENCY:
             ret_val = g_pt_ic_drv->api->capture_frequency(p_chnl, p_capture_mode);
             break;
+        case IC_MEASURE_PWM:
+            if (g_pt_ic_drv->api->capture_pwm == NULL)
+            {
+                ret_val = RET_NOT_SUPPORTED;
+            }
+            else
+            {
+                ret_val = g_pt_ic_drv->api->capture_pwm(p_chnl, p_capture_mode);
+            }
+            break;
         default:
             ret_val = RET_PARAM_ERROR;
             break;
@@ -72,11 +100,22 @@ response_status_t ha_input_capture_register_callback(input_capture_channel_t p_c
                                                      ic_finished_callback_t  ppt_callback)
 {
     ASSERT_AND_RETURN(!g_ic_drv_ready, RET_NOT_INITIALIZED);
+    ASSERT_AND_RETURN(p_chnl >= INPUT_CAPTURE_CHANNEL_CNT, RET_PARAM_ERROR);
     ASSERT_AND_RETURN(ppt_callback == NULL, RET_PARAM_ERROR);
 
     response_status_t ret_val = RET_OK;
 
-    ret_val = g_pt_ic_drv->api->register_callback(p_chnl, ppt_callback);
+    g_callbacks[p_chnl] = ppt_callback;
+    ret_val             = g_pt_ic_drv->api->register_callback(p_chnl, capture_dispatch);
 
     return ret_val;
 }
+
+/**
+ * @brief This function sets the observer of all captured values, only one is
+ * kept. A NULL hook stops the observation.
+ */
+void ha_input_capture_register_record_hook(ic_record_hook_t ppt_hook)
+{
+    g_pt_record_hook = ppt_hook;
+}
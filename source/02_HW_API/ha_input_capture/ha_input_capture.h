@@ -19,6 +19,7 @@ typedef enum
     IC_CAPTURE_FALLING_EDGE,
     IC_MEASURE_PULSE_WIDTH,
     IC_MEASURE_FREQUENCY,
+    IC_MEASURE_PWM, // Pulse width measured by the timer, one interrupt per period
     IC_CAPTURE_TYPE_CNT
 } input_capture_type_t;
 
@@ -29,6 +30,8 @@ typedef enum
 } input_capture_mode_t;
 
 typedef void (*ic_finished_callback_t)(input_capture_channel_t p_channel, uint32_t p_value);
+/// Observer of every captured value, used to record the inputs. It runs in the capture interrupt
+typedef void (*ic_record_hook_t)(input_capture_channel_t p_channel, uint32_t p_value);
 
 response_status_t ha_input_capture_init(void);
 response_status_t ha_input_capture_request_capture(input_capture_channel_t p_chnl,
@@ -37,5 +40,6 @@ response_status_t ha_input_capture_request_capture(input_capture_channel_t p_chn
 response_status_t ha_input_capture_register_callback(input_capture_channel_t p_chnl,
                                                      ic_finished_callback_t  ppt_callback);
 response_status_t ha_input_capture_abort(input_capture_channel_t p_chnl);
+void              ha_input_capture_register_record_hook(ic_record_hook_t ppt_hook);
 
 #endif // HA_INPUT_CAPTURE_H
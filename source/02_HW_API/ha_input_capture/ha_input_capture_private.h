@@ -32,6 +32,16 @@ struct st_ic_driver_ifc
 
     response_status_t (*capture_frequency)(mp_timer_capture_channels_t, mp_timer_capture_mode_t);
 
+    /**
+     * @brief This function shall measure the pulse width in the PWM input mode
+     * of the timer: the rising edge resets the counter, the falling edge is
+     * captured on the paired channel and raises the only interrupt of a period.
+     *
+     * @retval `RET_NOT_SUPPORTED` if the channel has no paired channel or its
+     * counter is used by another channel, else as the other capture requests.
+     */
+    response_status_t (*capture_pwm)(mp_timer_capture_channels_t, mp_timer_capture_mode_t);
+
     response_status_t (*capture_edge)(mp_timer_capture_channels_t, mp_timer_capture_type_t, mp_timer_capture_mode_t);
 
     response_status_t (*register_callback)(mp_timer_capture_channels_t, timer_capture_callback_t);
@@ -106,3 +106,83 @@ uint32_t ha_timer_get_cpu_time_us(void)
     ASSERT_AND_RETURN(g_timer_drv_ready != TRUE, 0);
     return g_pt_timer_drv->api->get_cpu_time(MP_TIMER_UNIT_US);
 }
+
+/**
+ * @brief This function returns the free running 1 MHz counter, it wraps
+ * around every ~71.6 minutes.
+ */
+uint32_t ha_timer_get_counter(void)
+{
+    ASSERT_AND_RETURN(g_timer_drv_ready != TRUE, 0);
+    return g_pt_timer_drv->api->get_counter();
+}
+
+/**
+ * @brief This function returns the core cycle counter, it is meant for
+ * profiling and wraps around every ~53 s at 80 MHz.
+ */
+uint32_t ha_timer_get_cycles(void)
+{
+    ASSERT_AND_RETURN(g_timer_drv_ready != TRUE, 0);
+    return g_pt_timer_drv->api->get_cycles();
+}
+
+/**
+ * @brief This function arms a one-shot alarm at an absolute counter value.
+ * Deadlines are compared with wrap-around, they shall be less than 2^31 ticks
+ * ahead of the counter.
+ * @param[in] p_deadline Counter value to fire at.
+ * @return Result of the execution status.
+ */
+response_status_t ha_timer_set_alarm(uint32_t p_deadline)
+{
+    ASSERT_AND_RETURN(g_timer_drv_ready != TRUE, RET_NOT_INITIALIZED);
+    return g_pt_timer_drv->api->set_alarm(p_deadline);
+}
+
+void ha_timer_cancel_alarm(void)
+{
+    ASSERT_AND_RETURN(g_timer_drv_ready != TRUE, );
+    g_pt_timer_drv->api->cancel_alarm();
+}
+
+response_status_t ha_timer_register_alarm_callback(void (*ppt_callback)(void))
+{
+    ASSERT_AND_RETURN(g_timer_drv_ready != TRUE, RET_NOT_INITIALIZED);
+    ASSERT_AND_RETURN(ppt_callback == NULL, RET_PARAM_ERROR);
+
+    return g_pt_timer_drv->api->register_alarm_callback(ppt_callback);
+}
+
+/**
+ * @brief This function sleeps the core until the next interrupt, e.g. the
+ * alarm. An interrupt taken since the previous call returns immediately.
+ */
+void ha_timer_wait_for_interrupt(void)
+{
+    ASSERT_AND_RETURN(g_timer_drv_ready != TRUE, );
+    g_pt_timer_drv->api->wait_for_interrupt();
+}
+
+/**
+ * @brief This function copies the service statistics of a timer channel, e.g.
+ * to check that its interrupt is not blocked for longer than a period.
+ * @param[in] p_timer Timer whose compare channel is reported, `TIMER_10US` is
+ * the channel of the alarm.
+ * @param[out] ppt_stats Destination of the statistics.
+ * @return Result of the execution status.
+ */
+response_status_t ha_timer_get_stats(gp_timers_t p_timer, ha_timer_stats_t* ppt_stats)
+{
+    ASSERT_AND_RETURN(g_timer_drv_ready != TRUE, RET_NOT_INITIALIZED);
+    ASSERT_AND_RETURN(p_timer >= TIMER_CNT, RET_NOT_SUPPORTED);
+    ASSERT_AND_RETURN(ppt_stats == NULL, RET_PARAM_ERROR);
+
+    return g_pt_timer_drv->api->get_stats(p_timer, ppt_stats);
+}
+
+void ha_timer_reset_stats(void)
+{
+    ASSERT_AND_RETURN(g_timer_drv_ready != TRUE, );
+    g_pt_timer_drv->api->reset_stats();
+}
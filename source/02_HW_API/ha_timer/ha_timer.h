@@ -15,6 +15,18 @@ typedef enum en_gp_timers
     TIMER_CNT,
 } gp_timers_t;
 
+/// Jitter bin 0 counts fires as late as the previous one, bin n a change of the
+/// lateness of [2^(n - 1), 2^n) ticks, the last bin also takes larger changes
+#define HA_TIMER_JITTER_BINS (8U)
+
+typedef struct
+{
+    uint32_t fire_cnt;
+    uint32_t overrun_cnt;    // Periods skipped because the interrupt was served too late
+    uint32_t max_late_ticks; // Longest time from the compare match to the service
+    uint32_t jitter_hist[HA_TIMER_JITTER_BINS];
+} ha_timer_stats_t;
+
 response_status_t ha_timer_init(void);
 response_status_t ha_timer_start(gp_timers_t p_timer);
 response_status_t ha_timer_stop(gp_timers_t p_timer);
@@ -25,4 +37,12 @@ void              ha_timer_hard_delay_ms(uint32_t p_delay_ms);
 void              ha_timer_hard_delay_us(uint32_t p_delay_ms);
 uint32_t          ha_timer_get_cpu_time_ms(void);
 uint32_t          ha_timer_get_cpu_time_us(void);
+uint32_t          ha_timer_get_counter(void);
+uint32_t          ha_timer_get_cycles(void);
+response_status_t ha_timer_set_alarm(uint32_t p_deadline);
+void              ha_timer_cancel_alarm(void);
+response_status_t ha_timer_register_alarm_callback(void (*ppt_callback)(void));
+void              ha_timer_wait_for_interrupt(void);
+response_status_t ha_timer_get_stats(gp_timers_t p_timer, ha_timer_stats_t* ppt_stats);
+void              ha_timer_reset_stats(void);
 #endif // HA_TIMER_H
@@ -95,6 +95,73 @@ struct st_timer_driver_ifc
      * @retval The current CPU time in the specified unit.
      */
     uint32_t (*get_cpu_time)(mp_timer_unit_t);
+
+    /**
+     * @brief This function shall get the value of the free running 32Bit timer
+     * counter, it counts at 1 MHz and wraps around.
+     *
+     * @retval The current counter value.
+     */
+    uint32_t (*get_counter)(void);
+
+    /**
+     * @brief This function shall get the free running 32Bit core cycle counter.
+     *
+     * @retval The current cycle count.
+     */
+    uint32_t (*get_cycles)(void);
+
+    /**
+     * @brief This function shall arm a one-shot compare that calls the alarm
+     * callback once when the counter reaches the given value. A value that is
+     * already passed fires as soon as possible.
+     *
+     * @param[in] p_deadline Absolute counter value to fire at.
+     *
+     * @retval `RET_OK` if the alarm is armed successfully, else error code.
+     */
+    response_status_t (*set_alarm)(uint32_t);
+
+    /**
+     * @brief This function shall disarm the one-shot compare.
+     */
+    void (*cancel_alarm)(void);
+
+    /**
+     * @brief This function shall register the alarm callback, it is called
+     * from the interrupt context.
+     * @note The alarm uses the channel of `TIMER_10US`, the periodic timer is
+     * not available anymore once the alarm callback is registered.
+     *
+     * @param[in] callback The callback function to register.
+     *
+     * @retval `RET_OK` if the callback is registered successfully, else error code.
+     */
+    response_status_t (*register_alarm_callback)(void (*ppt_callback)(void));
+
+    /**
+     * @brief This function shall put the core to sleep until the next
+     * interrupt. An interrupt taken since the last call shall end the sleep
+     * immediately, so a caller that checked its work before sleeping does not
+     * miss a wake-up.
+     */
+    void (*wait_for_interrupt)(void);
+
+    /**
+     * @brief This function shall get the service statistics of a compare
+     * channel. The alarm only counts fires and lateness.
+     *
+     * @param[in] p_timer_id The ID of the timer whose channel is reported.
+     * @param[out] ppt_stats Pointer to store the statistics.
+     *
+     * @retval `RET_OK` if the statistics are retrieved successfully, else error code.
+     */
+    response_status_t (*get_stats)(mp_timer_id_t, ha_timer_stats_t*);
+
+    /**
+     * @brief This function shall clear the statistics of all channels.
+     */
+    void (*reset_stats)(void);
 };
 
 #endif /* HA_TIMER_PRIVATE_H */
@@ -99,6 +99,50 @@ response_status_t ha_uart_dma_register_callback(uart_comm_port_t p_port, uart_dm
     return ret_val;
 }
 
+/**
+ * @brief This function starts the continuous DMA reception of a port into a
+ * circular buffer.
+ *
+ * @param[in] p_port UART communication port to use.
+ * @param[out] ppt_data_buffer Circular buffer the DMA writes to, it shall
+ * outlive the reception. Should not be NULL.
+ * @param[in] p_data_size Buffer size in bytes. Should not be zero.
+ * @return Result of the execution status, `RET_NOT_SUPPORTED` if the port has
+ * no receive DMA.
+ */
+response_status_t ha_uart_dma_receive_start(uart_comm_port_t p_port, uint8_t* ppt_data_buffer,
+                                            size_t p_data_size)
+{
+    ASSERT_AND_RETURN(g_uart_drv_ready == FALSE, RET_NOT_INITIALIZED);
+    ASSERT_AND_RETURN(p_port >= g_pt_uart_drv->hw_inst_cnt, RET_NOT_SUPPORTED);
+    ASSERT_AND_RETURN(ppt_data_buffer == NULL, RET_PARAM_ERROR);
+    ASSERT_AND_RETURN(p_data_size == 0, RET_PARAM_ERROR);
+
+    response_status_t ret_val = RET_OK;
+
+    ret_val = g_pt_uart_drv->api->dma_receive_start(p_port, ppt_data_buffer, p_data_size);
+
+    return ret_val;
+}
+
+/**
+ * @brief This function registers the reception callback of a port. It is
+ * called from the UART interrupt with the position the DMA writes next, the
+ * new bytes are the ones from the previous position up to it.
+ */
+response_status_t ha_uart_dma_register_rx_callback(uart_comm_port_t p_port,
+                                                   uart_dma_rx_cb   ppt_rx_cb)
+{
+    ASSERT_AND_RETURN(g_uart_drv_ready == FALSE, RET_NOT_INITIALIZED);
+    ASSERT_AND_RETURN(p_port >= g_pt_uart_drv->hw_inst_cnt, RET_NOT_SUPPORTED);
+
+    response_status_t ret_val = RET_OK;
+
+    ret_val = g_pt_uart_drv->api->dma_register_rx_cb(p_port, (dma_rx_evt_cb)ppt_rx_cb);
+
+    return ret_val;
+}
+
 /**
  * @brief This function initializes the UART driver once per power cycle.
  * It has no consequences for multiple calls.
@@ -11,6 +11,7 @@ typedef enum en_uart_comm_port
 {
     UART_DBG_PORT = 0,
     UART_ESP32_PORT,
+    UART_RC_PORT,
     UART_PORT_CNT,
 } uart_comm_port_t;
 
@@ -23,6 +24,14 @@ typedef enum
 
 typedef void (*uart_dma_evt_cb)(uart_comm_port_t, uart_dma_event_t);
 
+typedef enum
+{
+    UART_DMA_RX_EVT_DATA = 0, // New bytes up to the write position
+    UART_DMA_RX_EVT_RESTART   // Reception restarted after an error, writing from 0 again
+} uart_dma_rx_event_t;
+
+typedef void (*uart_dma_rx_cb)(uart_comm_port_t, uart_dma_rx_event_t, size_t);
+
 response_status_t ha_uart_init(void);
 response_status_t ha_uart_receive(uart_comm_port_t p_port, uint8_t* ppt_data_buffer,
                                   size_t p_data_size, timeout_t p_timeout);
@@ -32,5 +41,9 @@ response_status_t ha_uart_dma_transmit(uart_comm_port_t p_port, uint8_t* ppt_dat
                                        size_t p_data_size);
 response_status_t ha_uart_dma_stop(uart_comm_port_t p_port);
 response_status_t ha_uart_dma_register_callback(uart_comm_port_t p_port, uart_dma_evt_cb ppt_evt_cb);
+response_status_t ha_uart_dma_receive_start(uart_comm_port_t p_port, uint8_t* ppt_data_buffer,
+                                            size_t p_data_size);
+response_status_t ha_uart_dma_register_rx_callback(uart_comm_port_t p_port,
+                                                   uart_dma_rx_cb   ppt_rx_cb);
 
 #endif /* HA_UART_H */
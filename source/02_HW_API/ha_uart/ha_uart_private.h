@@ -24,6 +24,16 @@ typedef enum
 
 typedef void (*dma_tx_evt_cb)(mp_uart_ifc_idx_t p_ifc_index, mp_uart_dma_tx_event_t p_event);
 
+typedef enum
+{
+    MP_UART_DMA_RX_EVT_DATA = 0,
+    MP_UART_DMA_RX_EVT_RESTART
+} mp_uart_dma_rx_event_t;
+
+typedef void (*dma_rx_evt_cb)(mp_uart_ifc_idx_t      p_ifc_index,
+                              mp_uart_dma_rx_event_t p_event,
+                              size_t                 p_write_pos);
+
 struct st_uart_driver_ifc
 {
     response_status_t (*init)(void);
@@ -32,6 +42,8 @@ struct st_uart_driver_ifc
     response_status_t (*dma_transmit_request)(mp_uart_ifc_idx_t, uint8_t*, size_t);
     response_status_t (*dma_transmit_abort)(mp_uart_ifc_idx_t);
     response_status_t (*dma_register_cb)(mp_uart_ifc_idx_t, dma_tx_evt_cb);
+    response_status_t (*dma_receive_start)(mp_uart_ifc_idx_t, uint8_t*, size_t);
+    response_status_t (*dma_register_rx_cb)(mp_uart_ifc_idx_t, dma_rx_evt_cb);
 };
 
 #endif /* HA_UART_PRIVATE_H */
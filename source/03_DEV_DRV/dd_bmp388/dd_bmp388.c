@@ -2,6 +2,7 @@
 #include "dd_bmp388.h"
 
 #include "dd_bmp388_defs.h"
+#include "ha_gpio/ha_gpio.h"
 #include "ha_iic/ha_iic.h"
 #include "ha_timer/ha_timer.h"
 #include "string.h"
@@ -9,6 +10,9 @@
 
 #define DEFAULT_IIC_TIMEOUT (100U) // Default I2C timeout in milliseconds
 #define DEFAULT_IIC_REG_SZ (1U)
+#define BMP388_CMD_TIMEOUT_MS (100U)    // Time allowed for the command decoder to get ready
+#define BMP388_CMD_POLL_PERIOD_MS (10U) // Period of `SENS_STATUS.cmd_rdy` polling
+#define BMP388_RESET_SETTLE_MS (25U)    // Time needed by the sensor to boot after a soft reset
 
 #define BMP3_SET_BITS(bitname, data) ((data) << (bitname##_POS))
 
@@ -17,22 +21,53 @@
 IIC_SETUP_PORT_CONNECTION(BMP388_DEV_CNT,
                           IIC_DEFINE_CONNECTION(IIC_PORT1, BMP388_DEV_1, BMP388_IIC_ADDR_1))
 
+typedef enum
+{
+    BMP388_CMD_EXT_MODE_EN = 0x34,
+    BMP388_CMD_FIFO_FLUSH  = 0xB0,
+    BMP388_CMD_SOFT_RESET  = 0xB6,
+} bmp388_cmds;
+
+typedef enum
+{
+    BMP388_CMD_STATE_IDLE = 0x00,
+    /// Polling `SENS_STATUS.cmd_rdy` before writing the command
+    BMP388_CMD_STATE_WAIT_CMD_RDY,
+    /// Soft reset written, waiting for the sensor to boot again
+    BMP388_CMD_STATE_WAIT_RESET,
+} bmp388_cmd_state_t;
+
+struct st_bmp388_cmd_ctx
+{
+    bmp388_cmd_state_t   state;
+    bmp388_cmds          cmd;
+    bmp388_status_t      status;
+    bmp388_cmd_done_cb_t done_cb;
+    uint32_t             deadline_ms;
+    uint32_t             next_step_ms;
+};
+
+struct st_bmp388_drdy_ctx
+{
+    gpio_pins_t pin;
+    bool_t      is_attached;
+    /// Incremented from the interrupt context on every INT pin edge
+    volatile uint8_t irq_cnt;
+    /// Last `irq_cnt` value consumed by the main context
+    uint8_t handled_cnt;
+};
+
 typedef struct st_driver
 {
     bmp388_dev_t                dev;
     struct st_bmp388_calib_data calib_data;
     struct st_bmp388_raw_data   raw_data;
+    struct st_bmp388_cmd_ctx    cmd_ctx;
+    struct st_bmp388_drdy_ctx   drdy_ctx;
     uint8_t                     dev_id;
     bool_t                      is_initialized;
 } driver_t;
 
-typedef enum
-{
-    BMP388_CMD_EXT_MODE_EN = 0x34,
-    BMP388_CMD_FIFO_FLUSH  = 0xB0,
-    BMP388_CMD_SOFT_RESET  = 0xB6,
-} bmp388_cmds;
-
 static driver_t g_bmp_drv[BMP388_DEV_CNT];
 
 /**
@@ -410,33 +445,209 @@ static bmp388_status_t read_temp(bmp388_dev_t* ppt_dev)
     return ret_val;
 }
 
-static response_status_t send_cmd(bmp388_dev_t* ppt_dev, bmp388_cmds p_cmd, uint32_t p_timeout_ms)
+/**
+ * @brief This internal function reads pressure, temperature and sensor time in
+ * a single bus transaction. It is used when the data ready state is known from
+ * the INT pin, so no status register has to be checked.
+ * @param[in,out] ppt_dev BMP388 device instance.
+ * @param[in] p_data_req The data request flags indicating which data to decode.
+ * @return Result of the execution status.
+ */
+static bmp388_status_t read_data_burst(bmp388_dev_t* ppt_dev, bmp388_data_request_t p_data_req)
 {
-    response_status_t ret_val       = RET_OK;
-    uint8_t           reg_val       = 0U;
-    bool_t            cmd_rdy       = FALSE;
-    uint32_t          max_retry_cnt = p_timeout_ms / 10U; // 10 ms intervals
+    response_status_t api_ret_val                         = RET_OK;
+    driver_t*         pt_curr_driver                      = (driver_t*)ppt_dev;
+    uint8_t           reg_data[BMP388_REG_DATA_BURST_LEN] = { 0U };
+    const uint8_t*    pt_pres = &reg_data[BMP388_REG_DATA_PRES - BMP388_REG_DATA_BURST];
+    const uint8_t*    pt_temp = &reg_data[BMP388_REG_DATA_TEMP - BMP388_REG_DATA_BURST];
+    const uint8_t*    pt_time = &reg_data[BMP388_REG_SENS_TIME - BMP388_REG_DATA_BURST];
+
+    api_ret_val =
+      read_register(ppt_dev, reg_data, BMP388_REG_DATA_BURST_LEN, BMP388_REG_DATA_BURST);
+    if (api_ret_val != RET_OK)
+    {
+        return BMP388_ERROR_API;
+    }
+
+    if (p_data_req & BMP388_READ_TIME)
+    {
+        ppt_dev->data.sensortime =
+          BYTES_TO_DWORD(unsigned, pt_time[0U], pt_time[1U], pt_time[2U], 0U);
+    }
+
+    /// Temperature is needed for the pressure compensation as well
+    if (p_data_req & BMP388_READ_PRESS_TEMP)
+    {
+        pt_curr_driver->raw_data.temperature =
+          BYTES_TO_DWORD(unsigned, pt_temp[0U], pt_temp[1U], pt_temp[2U], 0U);
+        ppt_dev->data.temperature = 0U;
+        compensate_temperature(ppt_dev);
+    }
 
-    while (max_retry_cnt > 0U)
+    if (p_data_req & BMP388_READ_PRESSURE)
+    {
+        pt_curr_driver->raw_data.pressure =
+          BYTES_TO_DWORD(unsigned, pt_pres[0U], pt_pres[1U], pt_pres[2U], 0U);
+        ppt_dev->data.pressure = 0U;
+        compensate_pressure(ppt_dev);
+    }
+
+    return BMP388_NO_ERROR;
+}
+
+/**
+ * @brief This internal function is called from the interrupt context on the
+ * INT pin edge. It only records the event, the bus is accessed later from
+ * `dd_bmp388_get_data`.
+ * @param[in] p_pin Input pin that triggered the interrupt.
+ */
+static void drdy_irq_cb(gpio_pins_t p_pin)
+{
+    for (uint8_t i = 0; i < BMP388_DEV_CNT; i++)
     {
-        ret_val = read_register(ppt_dev, &reg_val, DEFAULT_IIC_REG_SZ, BMP388_REG_SENS_STATUS);
-        if (ret_val == RET_OK)
+        if ((g_bmp_drv[i].drdy_ctx.is_attached == TRUE) && (g_bmp_drv[i].drdy_ctx.pin == p_pin))
         {
-            cmd_rdy = BMP3_GET_BITS(reg_val, BMP388_REG_SENS_STATUS_CMD) == 0x01;
-            if (cmd_rdy == TRUE)
-            {
-                ret_val = write_register(ppt_dev, (uint8_t*)&p_cmd, DEFAULT_IIC_REG_SZ, BMP388_REG_CMD);
-                break;
-            }
-            
-                            ret_val = RET_TIMEOUT;
-           
+            g_bmp_drv[i].drdy_ctx.irq_cnt++;
         }
-        max_retry_cnt--;
-        ha_timer_hard_delay_ms(10U); // Wait for 10 ms before retrying
     }
+}
 
-    return ret_val;
+/**
+ * @brief This internal function checks if the given deadline has been reached.
+ * It is safe against the wrap-around of the millisecond counter.
+ * @param[in] p_now_ms Current CPU time in milliseconds.
+ * @param[in] p_deadline_ms Deadline to compare against.
+ * @return TRUE if the deadline is reached, FALSE otherwise.
+ */
+static inline bool_t is_time_reached(uint32_t p_now_ms, uint32_t p_deadline_ms)
+{
+    return ((int32_t)(p_now_ms - p_deadline_ms) >= 0) ? TRUE : FALSE;
+}
+
+/**
+ * @brief This internal function terminates the running command, moves the
+ * driver back to idle and reports the result to the user.
+ * @param[in,out] ppt_drv BMP388 driver instance.
+ * @param[in] p_status Final status of the command.
+ */
+static void finish_cmd(driver_t* ppt_drv, bmp388_status_t p_status)
+{
+    bmp388_cmd_done_cb_t pt_done_cb = ppt_drv->cmd_ctx.done_cb;
+
+    ppt_drv->cmd_ctx.state   = BMP388_CMD_STATE_IDLE;
+    ppt_drv->cmd_ctx.done_cb = NULL;
+    ppt_drv->cmd_ctx.status  = p_status;
+
+    if (pt_done_cb != NULL)
+    {
+        pt_done_cb(&ppt_drv->dev, p_status);
+    }
+}
+
+/**
+ * @brief This internal function queues a command for the sensor. The command
+ * itself is written by `cmd_step` once the sensor reports it is ready to
+ * accept a new command.
+ * @param[in,out] ppt_dev BMP388 device instance.
+ * @param[in] p_cmd Command to send.
+ * @param[in] p_timeout_ms Maximum time to wait for the sensor command decoder.
+ * @param[in] ppt_done_cb Callback to call once the command is completed. Can
+ * be NULL.
+ * @return Result of the execution status.
+ */
+static response_status_t start_cmd(bmp388_dev_t* ppt_dev, bmp388_cmds p_cmd, uint32_t p_timeout_ms,
+                                   bmp388_cmd_done_cb_t ppt_done_cb)
+{
+    driver_t* pt_curr_driver = (driver_t*)ppt_dev;
+    uint32_t  now_ms         = 0U;
+
+    if (pt_curr_driver->cmd_ctx.state != BMP388_CMD_STATE_IDLE)
+    {
+        return RET_BUSY;
+    }
+
+    now_ms = ha_timer_get_cpu_time_ms();
+
+    pt_curr_driver->cmd_ctx.cmd          = p_cmd;
+    pt_curr_driver->cmd_ctx.done_cb      = ppt_done_cb;
+    pt_curr_driver->cmd_ctx.status       = BMP388_NO_ERROR;
+    pt_curr_driver->cmd_ctx.deadline_ms  = now_ms + p_timeout_ms;
+    pt_curr_driver->cmd_ctx.next_step_ms = now_ms;
+    pt_curr_driver->cmd_ctx.state        = BMP388_CMD_STATE_WAIT_CMD_RDY;
+
+    return RET_OK;
+}
+
+/**
+ * @brief This internal function advances the command state machine of one
+ * device by at most one step. It never waits, if the next step is not due yet
+ * it returns immediately.
+ * @param[in,out] ppt_drv BMP388 driver instance.
+ */
+static void cmd_step(driver_t* ppt_drv)
+{
+    struct st_bmp388_cmd_ctx* pt_ctx   = &ppt_drv->cmd_ctx;
+    response_status_t         api_ret  = RET_OK;
+    uint8_t                   reg_val  = 0U;
+    uint32_t                  now_ms   = ha_timer_get_cpu_time_ms();
+    bmp388_status_t           err_stat = BMP388_NO_ERROR;
+
+    if (is_time_reached(now_ms, pt_ctx->next_step_ms) == FALSE)
+    {
+        return;
+    }
+
+    switch (pt_ctx->state)
+    {
+        case BMP388_CMD_STATE_WAIT_CMD_RDY:
+            api_ret =
+              read_register(&ppt_drv->dev, &reg_val, DEFAULT_IIC_REG_SZ, BMP388_REG_SENS_STATUS);
+            if ((api_ret == RET_OK) && (BMP3_GET_BITS(reg_val, BMP388_REG_SENS_STATUS_CMD) == 0x01))
+            {
+                reg_val = (uint8_t)pt_ctx->cmd;
+                api_ret =
+                  write_register(&ppt_drv->dev, &reg_val, DEFAULT_IIC_REG_SZ, BMP388_REG_CMD);
+                if (api_ret != RET_OK)
+                {
+                    finish_cmd(ppt_drv, BMP388_ERROR_API);
+                }
+                else if (pt_ctx->cmd == BMP388_CMD_SOFT_RESET)
+                {
+                    pt_ctx->next_step_ms = now_ms + BMP388_RESET_SETTLE_MS;
+                    pt_ctx->state        = BMP388_CMD_STATE_WAIT_RESET;
+                }
+                else
+                {
+                    finish_cmd(ppt_drv, BMP388_NO_ERROR);
+                }
+            }
+            else if (is_time_reached(now_ms, pt_ctx->deadline_ms) == TRUE)
+            {
+                finish_cmd(ppt_drv, BMP388_ERROR_API);
+            }
+            else
+            {
+                pt_ctx->next_step_ms = now_ms + BMP388_CMD_POLL_PERIOD_MS;
+            }
+            break;
+
+        case BMP388_CMD_STATE_WAIT_RESET:
+            api_ret = read_register(&ppt_drv->dev, &reg_val, DEFAULT_IIC_REG_SZ, BMP388_REG_EVENT);
+            if (api_ret == RET_OK)
+            {
+                err_stat = dd_bmp388_get_error_state(&ppt_drv->dev);
+            }
+            else
+            {
+                err_stat = BMP388_ERROR_API;
+            }
+            finish_cmd(ppt_drv, err_stat);
+            break;
+
+        case BMP388_CMD_STATE_IDLE:
+        default:
+            break;
+    }
 }
 
 static bool_t is_data_rdy(bmp388_dev_t* ppt_dev)
@@ -675,14 +886,44 @@ response_status_t dd_bmp388_get_interrupt_settings(bmp388_dev_t* ppt_dev)
  * sensor or device not initialized.
  * @retval `BMP388_WAITING_PRESS` if pressure data is not ready.
  * @retval `BMP388_WAITING_TEMP` if temperature data is not ready.
+ * @retval `BMP388_WAITING_DATA` if data is not ready or a command is running.
  */
 bmp388_status_t dd_bmp388_get_data(bmp388_dev_t* ppt_dev, bmp388_data_request_t p_data_req)
 {
     ASSERT_AND_RETURN(ppt_dev == NULL, BMP388_ERROR_API);
     ASSERT_AND_RETURN(((driver_t*)(ppt_dev))->is_initialized == FALSE, BMP388_ERROR_API);
+    // Sensor registers are not valid while a command (e.g. soft reset) is in progress
+    if (((driver_t*)(ppt_dev))->cmd_ctx.state != BMP388_CMD_STATE_IDLE)
+    {
+        return BMP388_WAITING_DATA;
+    }
+
+    bmp388_status_t ret_val        = BMP388_NO_ERROR;
+    bool_t          data_rdy       = FALSE;
+    driver_t*       pt_curr_driver = (driver_t*)ppt_dev;
+    uint8_t         irq_cnt        = 0U;
+
+    if (((ppt_dev->settings.int_settings.int_enable) & (BMP388_INT_ENABLE_DRDY))
+        == (BMP388_INT_ENABLE_DRDY)
+        && (pt_curr_driver->drdy_ctx.is_attached == TRUE))
+    {
+        /// Data ready is known from the INT pin, the bus is only used when
+        /// a new sample exists and then in a single transaction
+        irq_cnt = pt_curr_driver->drdy_ctx.irq_cnt;
+        if (irq_cnt == pt_curr_driver->drdy_ctx.handled_cnt)
+        {
+            return BMP388_WAITING_DATA;
+        }
+        pt_curr_driver->drdy_ctx.handled_cnt = irq_cnt;
+
+        ret_val = read_data_burst(ppt_dev, p_data_req);
+        if (!(p_data_req & BMP388_READ_TEMP))
+        {
+            ppt_dev->data.temperature = 0U;
+        }
 
-    bmp388_status_t ret_val  = BMP388_NO_ERROR;
-    bool_t          data_rdy = FALSE;
+        return ret_val;
+    }
 
     if (((ppt_dev->settings.int_settings.int_enable) & (BMP388_INT_ENABLE_DRDY))
         == (BMP388_INT_ENABLE_DRDY))
@@ -758,39 +999,115 @@ bmp388_status_t dd_bmp388_get_error_state(bmp388_dev_t* ppt_dev)
     return ret_val;
 }
 
-bmp388_status_t dd_bmp388_reset(bmp388_dev_t* ppt_dev)
+/**
+ * @brief This function requests a soft reset of the sensor without blocking.
+ * The reset sequence is advanced by `dd_bmp388_process` and the result is
+ * reported through `ppt_done_cb`.
+ * @param[in,out] ppt_dev BMP388 device instance.
+ * @param[in] ppt_done_cb Callback called once the reset is completed. Can be
+ * NULL if the caller polls `dd_bmp388_is_busy` instead.
+ * @return Result of the execution status.
+ * @retval `RET_BUSY` if another command is still running on this device.
+ */
+response_status_t dd_bmp388_reset_async(bmp388_dev_t* ppt_dev, bmp388_cmd_done_cb_t ppt_done_cb)
 {
-    ASSERT_AND_RETURN(ppt_dev == NULL, BMP388_ERROR_API);
-    response_status_t api_ret_val = RET_OK;
-    bmp388_status_t   ret_val     = BMP388_NO_ERROR;
-    uint8_t           reg_val     = 0x00;
-    api_ret_val                   = send_cmd(ppt_dev, BMP388_CMD_SOFT_RESET, 100U);
-    if (api_ret_val == RET_OK)
-    {
-        ha_timer_hard_delay_ms(25U); // Wait for 25 ms after reset
-        api_ret_val = read_register(ppt_dev, &reg_val, DEFAULT_IIC_REG_SZ, BMP388_REG_EVENT);
-        ret_val     = dd_bmp388_get_error_state(ppt_dev);
-    }
+    ASSERT_AND_RETURN(ppt_dev == NULL, RET_PARAM_ERROR);
+    ASSERT_AND_RETURN(((driver_t*)(ppt_dev))->is_initialized == FALSE, RET_NOT_INITIALIZED);
 
-    if (api_ret_val == RET_OK)
+    return start_cmd(ppt_dev, BMP388_CMD_SOFT_RESET, BMP388_CMD_TIMEOUT_MS, ppt_done_cb);
+}
+
+/**
+ * @brief This function checks if a command is still running on the device.
+ * @param[in] ppt_dev BMP388 device instance.
+ * @return TRUE if a command is running, FALSE otherwise.
+ */
+bool_t dd_bmp388_is_busy(bmp388_dev_t* ppt_dev)
+{
+    ASSERT_AND_RETURN(ppt_dev == NULL, FALSE);
+
+    return (((driver_t*)ppt_dev)->cmd_ctx.state != BMP388_CMD_STATE_IDLE) ? TRUE : FALSE;
+}
+
+/**
+ * @brief This function advances the command state machines of all BMP388
+ * devices. It shall be called periodically from the main context, every call
+ * performs at most one bus transaction sequence per device and never waits.
+ */
+void dd_bmp388_process(void)
+{
+    for (uint8_t i = 0; i < BMP388_DEV_CNT; i++)
     {
-        if (reg_val == 0x01 && ret_val == BMP388_NO_ERROR)
+        if ((g_bmp_drv[i].is_initialized == TRUE)
+            && (g_bmp_drv[i].cmd_ctx.state != BMP388_CMD_STATE_IDLE))
         {
-            ret_val = BMP388_NO_ERROR;
-        }
-        else
-        {
-            // Do Nothing. Return ret_val value
+            cmd_step(&g_bmp_drv[i]);
         }
     }
-    else
+}
+
+/**
+ * @brief This function routes the sensor INT pin to the given input pin. Once
+ * attached and `BMP388_INT_ENABLE_DRDY` is enabled, `dd_bmp388_get_data` does
+ * not poll the interrupt status register anymore, it reads the data only after
+ * an edge on the pin and in a single bus transaction.
+ * @note The INT pin shall be configured as non-latched, otherwise it stays
+ * active until the interrupt status register is read.
+ * @param[in,out] ppt_dev BMP388 device instance.
+ * @param[in] p_pin Input pin connected to the sensor INT pin.
+ * @return Result of the execution status.
+ */
+response_status_t dd_bmp388_attach_drdy_pin(bmp388_dev_t* ppt_dev, gpio_pins_t p_pin)
+{
+    ASSERT_AND_RETURN(ppt_dev == NULL, RET_PARAM_ERROR);
+    ASSERT_AND_RETURN(((driver_t*)(ppt_dev))->is_initialized == FALSE, RET_NOT_INITIALIZED);
+
+    response_status_t ret_val        = RET_OK;
+    driver_t*         pt_curr_driver = (driver_t*)ppt_dev;
+
+    pt_curr_driver->drdy_ctx.is_attached = FALSE;
+    pt_curr_driver->drdy_ctx.pin         = p_pin;
+    pt_curr_driver->drdy_ctx.handled_cnt = pt_curr_driver->drdy_ctx.irq_cnt;
+
+    ret_val = ha_gpio_init();
+    if (ret_val == RET_OK)
     {
-        ret_val = BMP388_ERROR_API;
+        ret_val = ha_gpio_register_callback(p_pin, drdy_irq_cb);
+    }
+    if (ret_val == RET_OK)
+    {
+        pt_curr_driver->drdy_ctx.is_attached = TRUE;
     }
 
     return ret_val;
 }
 
+/**
+ * @brief This function performs a soft reset of the sensor and waits until it
+ * is completed. It is built on top of `dd_bmp388_reset_async` and should only
+ * be used during start-up, runtime recovery shall use the asynchronous API.
+ * @param[in,out] ppt_dev BMP388 device instance.
+ * @return Result of the reset.
+ */
+bmp388_status_t dd_bmp388_reset(bmp388_dev_t* ppt_dev)
+{
+    ASSERT_AND_RETURN(ppt_dev == NULL, BMP388_ERROR_API);
+
+    driver_t* pt_curr_driver = (driver_t*)ppt_dev;
+
+    if (dd_bmp388_reset_async(ppt_dev, NULL) != RET_OK)
+    {
+        return BMP388_ERROR_API;
+    }
+
+    while (pt_curr_driver->cmd_ctx.state != BMP388_CMD_STATE_IDLE)
+    {
+        cmd_step(pt_curr_driver);
+    }
+
+    return pt_curr_driver->cmd_ctx.status;
+}
+
 /**
  * @brief This function retrieves the BMP388 device instance based on the device
  * ID.
@@ -2,6 +2,7 @@
 #ifndef DD_BMP388_H
 #define DD_BMP388_H
 
+#include "ha_gpio/ha_gpio.h"
 #include "su_common.h"
 
 typedef enum en_bmp388_oversampling
@@ -184,6 +185,14 @@ typedef enum en_bmp388_devices
     BMP388_DEV_CNT,
 } bmp388_devices_t;
 
+/**
+ * @brief Callback called from `dd_bmp388_process` when an asynchronous command
+ * is completed.
+ * @param[in] ppt_dev Device on which the command was executed.
+ * @param[in] p_status Final status of the command.
+ */
+typedef void (*bmp388_cmd_done_cb_t)(bmp388_dev_t* ppt_dev, bmp388_status_t p_status);
+
 response_status_t dd_bmp388_set_data_settings(bmp388_dev_t* ppt_dev);
 response_status_t dd_bmp388_set_dev_settings(bmp388_dev_t* ppt_dev);
 response_status_t dd_bmp388_set_ifc_settings(bmp388_dev_t* ppt_dev);
@@ -195,6 +204,10 @@ response_status_t dd_bmp388_get_interrupt_settings(bmp388_dev_t* ppt_dev);
 bmp388_status_t   dd_bmp388_get_data(bmp388_dev_t* ppt_dev, bmp388_data_request_t p_data_req);
 bmp388_status_t   dd_bmp388_get_error_state(bmp388_dev_t* ppt_dev);
 bmp388_status_t   dd_bmp388_reset(bmp388_dev_t* ppt_dev);
+response_status_t dd_bmp388_reset_async(bmp388_dev_t* ppt_dev, bmp388_cmd_done_cb_t ppt_done_cb);
+bool_t            dd_bmp388_is_busy(bmp388_dev_t* ppt_dev);
+void              dd_bmp388_process(void);
+response_status_t dd_bmp388_attach_drdy_pin(bmp388_dev_t* ppt_dev, gpio_pins_t p_pin);
 bmp388_dev_t*     dd_bmp388_get_dev(bmp388_devices_t p_dev_id);
 response_status_t dd_bmp388_init(bmp388_dev_t** ppt_dev, bmp388_devices_t p_dev_id);
 
@@ -39,6 +39,15 @@
  */
 #define BMP388_REG_SENS_TIME      (0x0C)
 #define BMP388_REG_SENS_TIME_LEN  (3U)
+/** @brief The sensor time counts at 25.6 kHz and wraps after 24Bit */
+#define BMP388_SENS_TIME_TICK_US  (39.0625F)
+#define BMP388_SENS_TIME_MSK      (0xFFFFFFU)
+
+/** @brief Pressure, temperature and sensor time read in a single burst
+ * @note Registers 0x0A and 0x0B are reserved and skipped while decoding.
+ */
+#define BMP388_REG_DATA_BURST      (BMP388_REG_DATA_PRES)
+#define BMP388_REG_DATA_BURST_LEN  (BMP388_REG_SENS_TIME + BMP388_REG_SENS_TIME_LEN - BMP388_REG_DATA_PRES)
 
 /** @brief 1Bit sensor POR status */
 #define BMP388_REG_EVENT          (0x10)
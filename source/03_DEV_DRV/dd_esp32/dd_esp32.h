@@ -17,8 +17,8 @@ typedef struct
     union un_float_to_bytes mag[3];
     union un_float_to_bytes quat[4];
     union un_float_to_bytes baro;
-    uint32_t             throttle_stick;
-    uint32_t             steering_stick;
+    int16_t              throttle_stick; // Calibrated stick, -1 to 1 in Q15, 0 if the link is lost
+    int16_t              steering_stick;
 } dd_esp32_data_packet_t;
 
 response_status_t dd_esp32_init(void);
@@ -1,27 +1,81 @@
-
 #include "dd_fsi6.h"
 
 #include "ha_input_capture/ha_input_capture.h"
 #include "ha_timer/ha_timer.h"
+#include "ha_uart/ha_uart.h"
 #include "ps_app_timer/ps_app_timer.h"
 #include "su_common.h"
+#include "su_mailbox/su_mailbox.h"
 
 #include <string.h>
 
+/// Two frames, the idle line event after each frame leaves one frame of margin
+#define FSI6_IBUS_RX_BUF_SZ (2U * FSI6_IBUS_FRAME_LEN)
+#define FSI6_MEDIAN_LEN     (3U)
+
+typedef enum
+{
+    FSI6_BACKEND_CAPTURE,
+    FSI6_BACKEND_IBUS
+} fsi6_backend_t;
+
+typedef struct
+{
+    uint32_t        seen_seq;  // Sequence at the last check
+    uint32_t        silent_ms; // Time the check has not seen a new sequence
+    volatile bool_t is_fresh;
+} fsi6_watch_t; // Owned by the check
+
+typedef struct
+{
+    uint32_t pulse_us;
+    uint32_t timestamp_us;
+} fsi6_pulse_t;
+
+typedef struct
+{
+    uint16_t ch_us[FSI6_IBUS_CH_CNT];
+    uint32_t timestamp_us;
+} fsi6_ibus_frame_t;
+
+typedef struct
+{
+    su_mailbox_t mb;    // Published by the capture ISR
+    fsi6_pulse_t pulse; // Storage of the mailbox
+    fsi6_watch_t watch;
+    uint32_t     hist_us[FSI6_MEDIAN_LEN]; // Last valid pulses, owned by the capture ISR
+    uint32_t     hist_pos;
+    bool_t       is_capturing;
+} fsi6_input_t;
+
 typedef struct
 {
-    uint32_t             value[FSI6_IN_CNT];
-    fsi6_inputs_t        channel_to_in[FSI6_IN_CNT];
+    su_mailbox_t       mb;    // Published by the receive ISR
+    fsi6_ibus_frame_t  frame; // Storage of the mailbox
+    fsi6_watch_t       watch;
+    fsi6_ibus_parser_t parser;
+    uint8_t            rx_buf[FSI6_IBUS_RX_BUF_SZ];
+    uint32_t           rx_pos;       // Next byte to parse in rx_buf
+} fsi6_ibus_t;
+
+typedef struct
+{
+    fsi6_backend_t       backend;
+    fsi6_input_t         in[FSI6_IN_CNT];
+    fsi6_ibus_t          ibus;
+    fsi6_inputs_t        channel_to_in[INPUT_CAPTURE_CHANNEL_CNT];
+    uint8_t              in_to_ibus_ch[FSI6_IN_CNT];
     bool_t               initialized;
-    volatile bool_t      waiting_for_data;
-    app_timer_handler_t* timeout_handler;
-    volatile bool_t      timeout_occurred;
+    app_timer_handler_t* check_handler;
 } fsi6_device_t;
 
-fsi6_device_t g_fsi6_dev = { .initialized = FALSE, .waiting_for_data = FALSE, .channel_to_in = {
+fsi6_device_t g_fsi6_dev = { .initialized = FALSE, .channel_to_in = {
     [INPUT_CAPTURE_CHANNEL_1] = FSI6_IN_L_S_UD,
     [INPUT_CAPTURE_CHANNEL_2] = FSI6_IN_R_S_LR,
-} , .timeout_handler = NULL, .timeout_occurred = FALSE };
+} , .in_to_ibus_ch = {
+    [FSI6_IN_L_S_UD] = 2U, // Throttle
+    [FSI6_IN_R_S_LR] = 0U, // Aileron
+} , .check_handler = NULL };
 
 static input_capture_channel_t in2ch(fsi6_inputs_t p_input)
 {
@@ -36,29 +90,253 @@ static input_capture_channel_t in2ch(fsi6_inputs_t p_input)
     }
 }
 
-void timeout_cb(void)
+/**
+ * @brief This function starts the continuous capture of an input. The PWM
+ * input mode of the timer takes one interrupt per frame, inputs whose timer
+ * can not run it fall back to the edge capture with two interrupts.
+ */
+static response_status_t start_capture(fsi6_inputs_t p_input)
 {
-    g_fsi6_dev.timeout_occurred = TRUE;
+    response_status_t ret_val = ha_input_capture_request_capture(in2ch(p_input),
+                                                                 IC_MEASURE_PWM,
+                                                                 IC_CONTINUOUS_CAPTURE);
+
+    if (ret_val == RET_NOT_SUPPORTED)
+    {
+        ret_val = ha_input_capture_request_capture(in2ch(p_input),
+                                                   IC_MEASURE_PULSE_WIDTH,
+                                                   IC_CONTINUOUS_CAPTURE);
+    }
+    if (ret_val == RET_OK)
+    {
+        g_fsi6_dev.in[p_input].is_capturing = TRUE;
+    }
+
+    return ret_val;
 }
 
-void ic_api_cb(input_capture_channel_t p_channel, uint32_t p_value)
+/**
+ * @brief This function copies the latest sample of an input. A capture that
+ * interrupts the copy is detected by the mailbox and the copy is repeated,
+ * so the caller never waits for a pulse. It shall not be called from an
+ * interrupt preempting the capture ISR.
+ */
+static void read_sample(const fsi6_input_t* ppt_in, fsi6_sample_t* ppt_sample)
 {
-    if (g_fsi6_dev.initialized)
+    fsi6_pulse_t pulse;
+
+    (void)su_mailbox_read(&ppt_in->mb, &pulse);
+    ppt_sample->pulse_us     = pulse.pulse_us;
+    ppt_sample->timestamp_us = pulse.timestamp_us;
+    ppt_sample->is_fresh     = ppt_in->watch.is_fresh;
+}
+
+/**
+ * @brief This function copies the latest iBUS frame, all channels come from
+ * the same frame. Same rules as read_sample() towards the receive ISR.
+ */
+static void read_frame(const fsi6_ibus_t* ppt_ibus, fsi6_frame_t* ppt_frame)
+{
+    fsi6_ibus_frame_t frame;
+
+    (void)su_mailbox_read(&ppt_ibus->mb, &frame);
+    memcpy(ppt_frame->ch_us, frame.ch_us, sizeof(ppt_frame->ch_us));
+    ppt_frame->timestamp_us = frame.timestamp_us;
+    ppt_frame->is_fresh     = ppt_ibus->watch.is_fresh;
+}
+
+static void read_input_sample(fsi6_inputs_t p_input, fsi6_sample_t* ppt_sample)
+{
+    if (g_fsi6_dev.backend == FSI6_BACKEND_IBUS)
     {
-        g_fsi6_dev.value[g_fsi6_dev.channel_to_in[p_channel]] = p_value;
-        g_fsi6_dev.waiting_for_data                         = FALSE;
+        fsi6_frame_t frame = { 0U };
+
+        read_frame(&g_fsi6_dev.ibus, &frame);
+        ppt_sample->pulse_us     = frame.ch_us[g_fsi6_dev.in_to_ibus_ch[p_input]];
+        ppt_sample->timestamp_us = frame.timestamp_us;
+        ppt_sample->is_fresh     = frame.is_fresh;
     }
     else
     {
-        // Handle error or unexpected callback
+        read_sample(&g_fsi6_dev.in[p_input], ppt_sample);
     }
 }
 
+/**
+ * @brief This function tracks the freshness of one sequence. A sequence that
+ * did not move for FSI6_TIMEOUT_MS loses its freshness.
+ */
+static void watch_seq(fsi6_watch_t* ppt_watch, const su_mailbox_t* ppt_mb)
+{
+    uint32_t seq = su_mailbox_get_seq(ppt_mb);
+
+    if (seq != ppt_watch->seen_seq)
+    {
+        ppt_watch->seen_seq  = seq;
+        ppt_watch->silent_ms = 0U;
+        ppt_watch->is_fresh  = TRUE;
+    }
+    else if (ppt_watch->silent_ms < FSI6_TIMEOUT_MS)
+    {
+        ppt_watch->silent_ms += FSI6_CHECK_PERIOD_MS;
+        if (ppt_watch->silent_ms >= FSI6_TIMEOUT_MS)
+        {
+            ppt_watch->is_fresh = FALSE;
+        }
+    }
+}
+
+/**
+ * @brief This function is the periodic staleness check of the inputs or of
+ * the iBUS frames. The ISRs only publish samples, so the freshness has a
+ * single writer.
+ */
+static void check_cb(void)
+{
+    if (g_fsi6_dev.backend == FSI6_BACKEND_IBUS)
+    {
+        watch_seq(&g_fsi6_dev.ibus.watch, &g_fsi6_dev.ibus.mb);
+    }
+    else
+    {
+        for (uint32_t i = 0U; i < FSI6_IN_CNT; i++)
+        {
+            watch_seq(&g_fsi6_dev.in[i].watch, &g_fsi6_dev.in[i].mb);
+        }
+    }
+}
+
+static uint32_t median3(const uint32_t* ppt_v)
+{
+    const uint32_t lo = (ppt_v[0] < ppt_v[1]) ? ppt_v[0] : ppt_v[1];
+    const uint32_t hi = (ppt_v[0] < ppt_v[1]) ? ppt_v[1] : ppt_v[0];
+
+    return (ppt_v[2] < lo) ? lo : ((ppt_v[2] > hi) ? hi : ppt_v[2]);
+}
+
+/**
+ * @brief This function filters and publishes a captured pulse. Pulses out of
+ * the servo range are dropped, the others go through a median of 3 so a
+ * single spike never reaches the sample, at the cost of one frame of delay on
+ * a step. The first pulse and the first one after a timeout fill the history.
+ */
+static void ic_api_cb(input_capture_channel_t p_channel, uint32_t p_value)
+{
+    if ((g_fsi6_dev.initialized == FALSE) || (p_channel >= INPUT_CAPTURE_CHANNEL_CNT))
+    {
+        return; // Unexpected callback
+    }
+    if ((p_value < FSI6_PULSE_MIN_US) || (p_value > FSI6_PULSE_MAX_US))
+    {
+        return; // Glitch, the input goes stale if only glitches come
+    }
+
+    fsi6_input_t*  pt_in  = &g_fsi6_dev.in[g_fsi6_dev.channel_to_in[p_channel]];
+    const uint32_t now_us = ha_timer_get_counter();
+
+    // The writer reads its own storage without the mailbox
+    if ((su_mailbox_get_seq(&pt_in->mb) == 0U)
+        || ((now_us - pt_in->pulse.timestamp_us) > (FSI6_TIMEOUT_MS * 1000U)))
+    {
+        for (uint32_t i = 0U; i < FSI6_MEDIAN_LEN; i++)
+        {
+            pt_in->hist_us[i] = p_value;
+        }
+    }
+    pt_in->hist_us[pt_in->hist_pos] = p_value;
+    pt_in->hist_pos                 = (pt_in->hist_pos + 1U) % FSI6_MEDIAN_LEN;
+
+    fsi6_pulse_t* pt_pulse = su_mailbox_write_begin(&pt_in->mb);
+
+    pt_pulse->pulse_us     = median3(pt_in->hist_us);
+    pt_pulse->timestamp_us = now_us;
+    su_mailbox_write_end(&pt_in->mb);
+}
+
+static void publish_frame(const uint16_t* ppt_ch_us)
+{
+    fsi6_ibus_frame_t* pt_frame = su_mailbox_write_begin(&g_fsi6_dev.ibus.mb);
+
+    memcpy(pt_frame->ch_us, ppt_ch_us, sizeof(pt_frame->ch_us));
+    pt_frame->timestamp_us = ha_timer_get_counter();
+    su_mailbox_write_end(&g_fsi6_dev.ibus.mb);
+}
+
+/**
+ * @brief This function parses the bytes the DMA wrote since the last event,
+ * wrapping around the receive ring. Each valid frame is published at once.
+ */
+static void uart_rx_cb(uart_comm_port_t p_port, uart_dma_rx_event_t p_event, size_t p_write_pos)
+{
+    fsi6_ibus_t* pt_ibus = &g_fsi6_dev.ibus;
+    uint16_t     ch_us[FSI6_IBUS_CH_CNT];
+
+    if ((g_fsi6_dev.backend != FSI6_BACKEND_IBUS) || (p_port != UART_RC_PORT)
+        || (p_write_pos >= FSI6_IBUS_RX_BUF_SZ))
+    {
+        return; // Unexpected callback
+    }
+
+    if (p_event == UART_DMA_RX_EVT_RESTART)
+    {
+        pt_ibus->rx_pos     = 0U;
+        pt_ibus->parser.len = 0U; // The partial frame is lost with the error
+        return;
+    }
+
+    while (pt_ibus->rx_pos != p_write_pos)
+    {
+        if (fsi6_ibus_parse(&pt_ibus->parser, pt_ibus->rx_buf[pt_ibus->rx_pos], ch_us) == TRUE)
+        {
+            publish_frame(ch_us);
+        }
+        pt_ibus->rx_pos = (pt_ibus->rx_pos + 1U) % FSI6_IBUS_RX_BUF_SZ;
+    }
+}
+
+/// Starts the periodic staleness check, a check of a former init is replaced
+static response_status_t start_check(void)
+{
+    response_status_t ret_val = ps_app_timer_init();
+
+    if ((ret_val == RET_OK) && (g_fsi6_dev.check_handler != NULL))
+    {
+        (void)ps_app_timer_delete(g_fsi6_dev.check_handler); // Initialized again
+        g_fsi6_dev.check_handler = NULL;
+    }
+    if (ret_val == RET_OK)
+    {
+        // The check only reads the sequences, it runs in the alarm ISR
+        ret_val = ps_app_timer_create(&(g_fsi6_dev.check_handler), FALSE, check_cb, PS_EXEC_ISR);
+    }
+    if (ret_val == RET_OK)
+    {
+        ret_val = ps_app_timer_start(g_fsi6_dev.check_handler,
+                                     FSI6_CHECK_PERIOD_MS,
+                                     APP_TIMER_UNIT_MS);
+    }
+
+    return ret_val;
+}
+
+/**
+ * @brief This function initializes the receiver inputs and starts the
+ * staleness check on the timer service.
+ * @param[in] p_isr TRUE to capture all inputs right away, else an input is
+ * captured from its first dd_fsi6_read_input() call on.
+ */
 response_status_t dd_fsi6_init(bool_t p_isr)
 {
     response_status_t ret_val = RET_OK;
 
-    memset(&(g_fsi6_dev.value), 0, sizeof(g_fsi6_dev.value));
+    g_fsi6_dev.initialized = FALSE;
+    g_fsi6_dev.backend     = FSI6_BACKEND_CAPTURE;
+    memset(&(g_fsi6_dev.in), 0, sizeof(g_fsi6_dev.in));
+    for (int i = 0; i < FSI6_IN_CNT; i++)
+    {
+        (void)su_mailbox_init(&g_fsi6_dev.in[i].mb, &g_fsi6_dev.in[i].pulse,
+                              sizeof(g_fsi6_dev.in[i].pulse));
+    }
 
     ret_val = ha_input_capture_init();
     if (ret_val == RET_OK)
@@ -71,18 +349,14 @@ response_status_t dd_fsi6_init(bool_t p_isr)
 
     if (ret_val == RET_OK)
     {
-        ret_val  = ps_app_timer_init();
-        ret_val |= ps_app_timer_create(&(g_fsi6_dev.timeout_handler), TRUE, timeout_cb);
+        ret_val = start_check();
     }
 
     if (ret_val == RET_OK && p_isr)
     {
         for (int i = 0; i < FSI6_IN_CNT; i++)
         {
-            input_capture_channel_t ch = in2ch(g_fsi6_dev.channel_to_in[i]);
-            ret_val |= ha_input_capture_request_capture(ch,
-                                                       IC_MEASURE_PULSE_WIDTH,
-                                                       IC_CONTINUOUS_CAPTURE);
+            ret_val |= start_capture(i);
         }
     }
 
@@ -94,64 +368,164 @@ response_status_t dd_fsi6_init(bool_t p_isr)
     return ret_val;
 }
 
+/**
+ * @brief This function initializes the receiver on its iBUS serial output
+ * instead of the PWM outputs. The frames are received by DMA on UART_RC_PORT
+ * and parsed in the UART interrupt, one frame carries all channels.
+ */
+response_status_t dd_fsi6_init_ibus(void)
+{
+    response_status_t ret_val = RET_OK;
+
+    g_fsi6_dev.initialized = FALSE;
+    g_fsi6_dev.backend     = FSI6_BACKEND_IBUS;
+    memset(&(g_fsi6_dev.ibus), 0, sizeof(g_fsi6_dev.ibus));
+    (void)su_mailbox_init(&g_fsi6_dev.ibus.mb, &g_fsi6_dev.ibus.frame,
+                          sizeof(g_fsi6_dev.ibus.frame));
+
+    ret_val = ha_uart_init();
+    if (ret_val == RET_OK)
+    {
+        ret_val = ha_uart_dma_register_rx_callback(UART_RC_PORT, uart_rx_cb);
+    }
+    if (ret_val == RET_OK)
+    {
+        ret_val = start_check();
+    }
+    if (ret_val == RET_OK)
+    {
+        ret_val = ha_uart_dma_receive_start(UART_RC_PORT,
+                                            g_fsi6_dev.ibus.rx_buf,
+                                            sizeof(g_fsi6_dev.ibus.rx_buf));
+    }
+
+    if (ret_val == RET_OK)
+    {
+        g_fsi6_dev.initialized = TRUE;
+    }
+
+    return ret_val;
+}
+
 response_status_t dd_fsi6_get_data(fsi6_inputs_t p_input, uint32_t* ppt_value)
 {
     ASSERT_AND_RETURN(ppt_value == NULL, RET_PARAM_ERROR);
     ASSERT_AND_RETURN(g_fsi6_dev.initialized == FALSE, RET_NOT_INITIALIZED);
     ASSERT_AND_RETURN(p_input >= FSI6_IN_CNT, RET_PARAM_ERROR);
 
-    *ppt_value = g_fsi6_dev.value[p_input];
+    fsi6_sample_t sample = { 0U };
+
+    read_input_sample(p_input, &sample);
+    *ppt_value = sample.pulse_us;
 
     return RET_OK;
+}
+
+/**
+ * @brief This function gets the latest pulse of an input with its capture
+ * time and freshness. A new pulse is reported fresh from the next check on,
+ * at most FSI6_CHECK_PERIOD_MS after its capture.
+ */
+response_status_t dd_fsi6_get_sample(fsi6_inputs_t p_input, fsi6_sample_t* ppt_sample)
+{
+    ASSERT_AND_RETURN(ppt_sample == NULL, RET_PARAM_ERROR);
+    ASSERT_AND_RETURN(g_fsi6_dev.initialized == FALSE, RET_NOT_INITIALIZED);
+    ASSERT_AND_RETURN(p_input >= FSI6_IN_CNT, RET_PARAM_ERROR);
+
+    read_input_sample(p_input, ppt_sample);
+
+    return RET_OK;
+}
+
+/**
+ * @brief This function gets the latest iBUS frame with all channels, its
+ * receive time and freshness.
+ * @retval `RET_NOT_SUPPORTED` if the receiver is read by input capture.
+ */
+response_status_t dd_fsi6_get_frame(fsi6_frame_t* ppt_frame)
+{
+    ASSERT_AND_RETURN(ppt_frame == NULL, RET_PARAM_ERROR);
+    ASSERT_AND_RETURN(g_fsi6_dev.initialized == FALSE, RET_NOT_INITIALIZED);
+
+    if (g_fsi6_dev.backend != FSI6_BACKEND_IBUS)
+    {
+        return RET_NOT_SUPPORTED;
+    }
+
+    read_frame(&g_fsi6_dev.ibus, ppt_frame);
 
+    return RET_OK;
 }
 
+/**
+ * @brief This function gets the latest pulse of an input without waiting for
+ * the receiver. The first call on an input that is not captured yet starts
+ * the continuous capture.
+ * @retval `RET_OK` with a fresh value, `RET_BUSY` while the capture starts,
+ * `RET_TIMEOUT` if the input is stale, the value is 0 in both cases.
+ */
 response_status_t dd_fsi6_read_input(fsi6_inputs_t p_input, uint32_t* ppt_value)
 {
     ASSERT_AND_RETURN(ppt_value == NULL, RET_PARAM_ERROR);
     ASSERT_AND_RETURN(g_fsi6_dev.initialized == FALSE, RET_NOT_INITIALIZED);
     ASSERT_AND_RETURN(p_input >= FSI6_IN_CNT, RET_PARAM_ERROR);
 
-    response_status_t ret_val       = RET_OK;
-    g_fsi6_dev.waiting_for_data     = TRUE;
-    g_fsi6_dev.timeout_occurred     = FALSE;
-    input_capture_channel_t channel = in2ch(p_input);
+    response_status_t ret_val = RET_OK;
+    fsi6_input_t*     pt_in   = &g_fsi6_dev.in[p_input];
+    fsi6_sample_t     sample  = { 0U };
 
-    if (ret_val == RET_OK)
+    *ppt_value = 0U;
+
+    if ((g_fsi6_dev.backend == FSI6_BACKEND_CAPTURE) && (pt_in->is_capturing == FALSE))
     {
-        ret_val =
-        ha_input_capture_request_capture(channel, IC_MEASURE_PULSE_WIDTH, IC_ONE_SHOT_CAPTURE);
+        ret_val = start_capture(p_input);
+        if (ret_val == RET_OK)
+        {
+            ret_val = RET_BUSY;
+        }
     }
-    
-    if (ret_val == RET_OK)
+    else
     {
-        ret_val = ps_app_timer_start(g_fsi6_dev.timeout_handler, 40, APP_TIMER_UNIT_MS);
+        read_input_sample(p_input, &sample);
+        if (sample.is_fresh == TRUE)
+        {
+            *ppt_value = sample.pulse_us;
+        }
+        else
+        {
+            ret_val = RET_TIMEOUT;
+        }
     }
 
-    while ((ret_val == RET_OK) && (g_fsi6_dev.waiting_for_data == TRUE) && (g_fsi6_dev.timeout_occurred == FALSE))
-    {
-        ;
-    }
+    return ret_val;
+}
 
-    if (ret_val != RET_OK)
+/**
+ * @brief This function tells if the receiver link is lost, i.e. any input
+ * or the iBUS frame is stale or has not been received yet.
+ */
+bool_t dd_fsi6_is_failsafe(void)
+{
+    bool_t is_failsafe = FALSE;
+
+    if (g_fsi6_dev.initialized == FALSE)
     {
-        // Error occurred
-        g_fsi6_dev.waiting_for_data = FALSE;
-        *ppt_value                      = 0; // Return 0 if error occurred
+        is_failsafe = TRUE;
     }
-    else if (g_fsi6_dev.timeout_occurred == TRUE)
+    else if (g_fsi6_dev.backend == FSI6_BACKEND_IBUS)
     {
-        ret_val = RET_TIMEOUT;
-        // ha_input_capture_abort(channel);
-        *ppt_value                      = 0; // Return 0 if timeout occurred
-        g_fsi6_dev.waiting_for_data = FALSE;
+        is_failsafe = (g_fsi6_dev.ibus.watch.is_fresh == FALSE) ? TRUE : FALSE;
     }
     else
     {
-        *ppt_value                      = g_fsi6_dev.value[g_fsi6_dev.channel_to_in[channel]];
-        g_fsi6_dev.waiting_for_data = FALSE;
-        ret_val                     = RET_OK;
+        for (uint32_t i = 0U; (i < FSI6_IN_CNT) && (is_failsafe == FALSE); i++)
+        {
+            if (g_fsi6_dev.in[i].watch.is_fresh == FALSE)
+            {
+                is_failsafe = TRUE;
+            }
+        }
     }
 
-    return ret_val;
+    return is_failsafe;
 }
@@ -1,9 +1,17 @@
-
 #ifndef DD_FSI6_H
 #define DD_FSI6_H
 
+#include "dd_fsi6_ibus.h"
 #include "su_common.h"
 
+/// A channel without a pulse for this long is stale, two frames of the receiver
+#define FSI6_TIMEOUT_MS      (40U)
+/// Period of the staleness check, the resolution of the timeout
+#define FSI6_CHECK_PERIOD_MS (10U)
+/// Captured pulses out of this range are glitches of the edge capture, never published
+#define FSI6_PULSE_MIN_US    (800U)
+#define FSI6_PULSE_MAX_US    (2200U)
+
 typedef enum
 {
     FSI6_IN_L_S_UD,
@@ -11,8 +19,26 @@ typedef enum
     FSI6_IN_CNT
 } fsi6_inputs_t;
 
+typedef struct
+{
+    uint32_t pulse_us;     // Median of the last 3 pulses, the latest one of iBUS
+    uint32_t timestamp_us; // Capture time on the free running counter, ha_timer_get_counter()
+    bool_t   is_fresh;     // FALSE before the first pulse and after a timeout
+} fsi6_sample_t;
+
+typedef struct
+{
+    uint16_t ch_us[FSI6_IBUS_CH_CNT]; // All channels of one iBUS frame
+    uint32_t timestamp_us;            // Receive time on the free running counter
+    bool_t   is_fresh;                // FALSE before the first frame and after a timeout
+} fsi6_frame_t;
+
 response_status_t dd_fsi6_init(bool_t p_isr);
+response_status_t dd_fsi6_init_ibus(void);
 response_status_t dd_fsi6_get_data(fsi6_inputs_t p_input, uint32_t* ppt_value);
+response_status_t dd_fsi6_get_sample(fsi6_inputs_t p_input, fsi6_sample_t* ppt_sample);
 response_status_t dd_fsi6_read_input(fsi6_inputs_t p_input, uint32_t* ppt_value);
+response_status_t dd_fsi6_get_frame(fsi6_frame_t* ppt_frame);
+bool_t            dd_fsi6_is_failsafe(void);
 
 #endif // DD_FSI6_H
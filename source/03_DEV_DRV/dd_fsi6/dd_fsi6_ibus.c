@@ -0,0 +1,95 @@
+#include "dd_fsi6_ibus.h"
+
+#include <string.h>
+
+#define IBUS_HDR_LEN     (0x20U)
+#define IBUS_HDR_CMD     (0x40U)
+#define IBUS_CRC_POS     (FSI6_IBUS_FRAME_LEN - 2U)
+#define IBUS_CH_POS      (2U)
+#define IBUS_CH_VAL_MASK (0x0FFFU) // The upper nibbles carry the channels past 14
+
+static uint16_t get_le16(const uint8_t* ppt_buf)
+{
+    return (uint16_t)(ppt_buf[0] | ((uint16_t)ppt_buf[1] << 8));
+}
+
+static bool_t is_crc_valid(const uint8_t* ppt_frame)
+{
+    uint16_t crc = 0xFFFFU;
+
+    for (uint32_t i = 0U; i < IBUS_CRC_POS; i++)
+    {
+        crc -= ppt_frame[i];
+    }
+
+    return (crc == get_le16(&ppt_frame[IBUS_CRC_POS])) ? TRUE : FALSE;
+}
+
+/**
+ * @brief This function drops the leading bytes of a rejected frame up to the
+ * next possible header, so a frame starting inside it is not lost.
+ */
+static void resync(fsi6_ibus_parser_t* ppt_parser)
+{
+    uint32_t start = 1U;
+
+    while ((start < ppt_parser->len)
+           && ((ppt_parser->buf[start] != IBUS_HDR_LEN)
+               || (((start + 1U) < ppt_parser->len)
+                   && (ppt_parser->buf[start + 1U] != IBUS_HDR_CMD))))
+    {
+        start++;
+    }
+
+    ppt_parser->len -= start;
+    memmove(ppt_parser->buf, &ppt_parser->buf[start], ppt_parser->len);
+}
+
+void fsi6_ibus_reset(fsi6_ibus_parser_t* ppt_parser)
+{
+    memset(ppt_parser, 0, sizeof(*ppt_parser));
+}
+
+/**
+ * @brief This function feeds one received byte to the parser. Bytes ahead of
+ * a header are dropped, a complete frame is checked against its checksum.
+ * @param[out] ppt_channels FSI6_IBUS_CH_CNT channel values in us, only
+ * written when a frame is complete.
+ * @return TRUE if the byte completed a valid frame.
+ */
+bool_t fsi6_ibus_parse(fsi6_ibus_parser_t* ppt_parser, uint8_t p_byte, uint16_t* ppt_channels)
+{
+    ASSERT_AND_RETURN(ppt_parser == NULL, FALSE);
+    ASSERT_AND_RETURN(ppt_channels == NULL, FALSE);
+
+    bool_t is_frame = FALSE;
+
+    ppt_parser->buf[ppt_parser->len++] = p_byte;
+
+    if (((ppt_parser->len == 1U) && (p_byte != IBUS_HDR_LEN))
+        || ((ppt_parser->len == 2U) && (p_byte != IBUS_HDR_CMD)))
+    {
+        resync(ppt_parser);
+    }
+    else if (ppt_parser->len == FSI6_IBUS_FRAME_LEN)
+    {
+        if (is_crc_valid(ppt_parser->buf) == TRUE)
+        {
+            for (uint32_t i = 0U; i < FSI6_IBUS_CH_CNT; i++)
+            {
+                ppt_channels[i] = get_le16(&ppt_parser->buf[IBUS_CH_POS + (2U * i)])
+                                  & IBUS_CH_VAL_MASK;
+            }
+            ppt_parser->frame_cnt++;
+            ppt_parser->len = 0U;
+            is_frame        = TRUE;
+        }
+        else
+        {
+            ppt_parser->crc_err_cnt++;
+            resync(ppt_parser);
+        }
+    }
+
+    return is_frame;
+}
@@ -0,0 +1,21 @@
+#ifndef DD_FSI6_IBUS_H
+#define DD_FSI6_IBUS_H
+
+#include "su_common.h"
+
+/// iBUS frame: 0x20 0x40 header, 14 channels in little endian, checksum
+#define FSI6_IBUS_FRAME_LEN (32U)
+#define FSI6_IBUS_CH_CNT    (14U)
+
+typedef struct
+{
+    uint8_t  buf[FSI6_IBUS_FRAME_LEN];
+    uint32_t len;          // Bytes of the current frame in buf
+    uint32_t frame_cnt;    // Frames with a valid checksum
+    uint32_t crc_err_cnt;  // Frames dropped on their checksum
+} fsi6_ibus_parser_t;
+
+void   fsi6_ibus_reset(fsi6_ibus_parser_t* ppt_parser);
+bool_t fsi6_ibus_parse(fsi6_ibus_parser_t* ppt_parser, uint8_t p_byte, uint16_t* ppt_channels);
+
+#endif // DD_FSI6_IBUS_H
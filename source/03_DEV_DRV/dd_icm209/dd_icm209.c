@@ -0,0 +1,1128 @@
+#include "dd_icm209.h"
+
+#include "dd_icm209_defs.h"
+#include "ha_iic/ha_iic.h"
+#include "ha_timer/ha_timer.h"
+#include "math.h"
+#include "string.h"
+#include "su_common.h"
+
+#define DEFAULT_IIC_TIMEOUT (100U) // Default I2C timeout in milliseconds
+#define DEFAULT_IIC_REG_SZ (1U)
+
+#define ICM209_RESET_DELAY_MS (10U)  // Time needed by the chip to boot after a reset
+#define ICM209_WAKEUP_DELAY_MS (1U)  // Time needed by the chip to leave the sleep mode
+#define ICM209_SLV4_TIMEOUT_MS (10U) // Maximum duration of a single AK09916 access
+#define ICM209_SENS_BASE_RATE_HZ (1125U)
+
+/// Raw FIFO frame: accel (6) + gyro (6) + AK09916 HXL..ST2 (8)
+#define ICM209_RAW_FRAME_MAX_LEN (6U + 6U + AK09916_REG_DATA_LEN)
+/// Largest DMP packet: header + accel + gyro + compass + quat9 + footer
+#define ICM209_DMP_PACKET_MAX_LEN                                                                \
+    (ICM209_DMP_HDR_LEN + ICM209_DMP_ACCEL_LEN + ICM209_DMP_GYRO_LEN + ICM209_DMP_CPASS_LEN      \
+     + ICM209_DMP_QUAT9_LEN + ICM209_DMP_FOOTER_LEN)
+/// Number of bytes drained from the FIFO in a single bus transaction
+#define ICM209_FIFO_BATCH_SZ (16U * ICM209_RAW_FRAME_MAX_LEN)
+#define ICM209_FIFO_COUNT_MSK (0x1FFFU)
+
+#define ICM209_MIN(a, b) (((a) < (b)) ? (a) : (b))
+#define ICM209_BANK_UNKNOWN (0xFFU)
+#define ICM209_Q30_SCALE (1073741824.F)
+
+#define ICM209_GET_I16(buf, idx) ((int16_t)BYTES_TO_WORD(unsigned, (buf)[(idx) + 1U], (buf)[idx]))
+#define ICM209_GET_I32(buf, idx)                                                 \
+    ((int32_t)BYTES_TO_DWORD(unsigned, (buf)[(idx) + 3U], (buf)[(idx) + 2U], \
+                             (buf)[(idx) + 1U], (buf)[idx]))
+
+typedef enum
+{
+    ICM209_DEV_1 = 0x00,
+    ICM209_DEV_CNT,
+} icm209_devices_t;
+
+IIC_SETUP_PORT_CONNECTION(ICM209_DEV_CNT,
+                          IIC_DEFINE_CONNECTION(IIC_PORT1, ICM209_DEV_1, ICM209_IIC_ADDR_1))
+
+typedef enum
+{
+    ICM209_SENS_GYRO = 0x00,
+    ICM209_SENS_ACCEL,
+    ICM209_SENS_MAG,
+    ICM209_SENS_QUAT,
+    ICM209_SENS_CNT,
+} icm209_sensors_t;
+
+struct st_icm209_sample
+{
+    float  value[4];
+    bool_t is_ready;
+};
+
+typedef struct st_driver
+{
+    TeensyICM20948Settings  settings;
+    struct st_icm209_sample sample[ICM209_SENS_CNT];
+    /// Gyroscope samples since the last read, summed so the integration sees all of them
+    float                   gyro_sum[3];
+    uint16_t                gyro_cnt;
+    const uint8_t*          dmp_image;
+    uint16_t                dmp_image_sz;
+    /// Register bank currently selected in the chip, saves a bus transaction
+    /// per access when consecutive accesses target the same bank
+    uint8_t                 curr_bank;
+    /// Size of a raw FIFO frame, 0 when the DMP owns the FIFO
+    uint8_t                 frame_sz;
+    bool_t                  is_dmp_running;
+    bool_t                  is_initialized;
+    /// Bytes drained from the FIFO that do not form a complete DMP packet yet
+    uint16_t                fifo_len;
+    uint8_t                 fifo_buf[ICM209_FIFO_BATCH_SZ + ICM209_DMP_PACKET_MAX_LEN];
+} driver_t;
+
+static driver_t g_icm_drv;
+
+/**
+ * @brief This internal function selects the register bank of the given
+ * register if it is not already selected.
+ * @param[in] p_reg Bank encoded register address.
+ * @return Result of the execution status.
+ */
+static response_status_t select_bank(uint16_t p_reg)
+{
+    response_status_t ret_val = RET_OK;
+    uint8_t           bank    = ICM209_REG_BANK(p_reg);
+    uint8_t           reg_val = (uint8_t)(bank << ICM209_REG_BANK_SEL_POS);
+
+    if (bank != g_icm_drv.curr_bank)
+    {
+        ret_val = ha_iic_master_mem_write(IIC_GET_DEV_PORT(ICM209_DEV_1),
+                                          IIC_GET_DEV_ADDRESS(ICM209_DEV_1),
+                                          (const uint8_t*)&reg_val,
+                                          DEFAULT_IIC_REG_SZ,
+                                          ICM209_REG_BANK_SEL,
+                                          HW_IIC_MEM_SZ_8BIT,
+                                          DEFAULT_IIC_TIMEOUT);
+
+        g_icm_drv.curr_bank = (ret_val == RET_OK) ? bank : ICM209_BANK_UNKNOWN;
+    }
+
+    return ret_val;
+}
+
+/**
+ * @brief This internal function writes data to consecutive registers of the
+ * sensor.
+ * @param[in] ppt_data Pointer to the data to write.
+ * @param[in] p_data_sz Size of the data to write.
+ * @param[in] p_reg Bank encoded address of the first register.
+ * @return Result of the execution status.
+ */
+static response_status_t write_register(const uint8_t* ppt_data, size_t p_data_sz, uint16_t p_reg)
+{
+    response_status_t ret_val = select_bank(p_reg);
+
+    if (ret_val == RET_OK)
+    {
+        ret_val = ha_iic_master_mem_write(IIC_GET_DEV_PORT(ICM209_DEV_1),
+                                          IIC_GET_DEV_ADDRESS(ICM209_DEV_1),
+                                          ppt_data,
+                                          p_data_sz,
+                                          ICM209_REG_ADDR(p_reg),
+                                          HW_IIC_MEM_SZ_8BIT,
+                                          DEFAULT_IIC_TIMEOUT);
+    }
+
+    return ret_val;
+}
+
+/**
+ * @brief This internal function reads data from consecutive registers of the
+ * sensor.
+ * @param[out] ppt_data Pointer to the buffer to store the read data.
+ * @param[in] p_data_sz Size of the data to read.
+ * @param[in] p_reg Bank encoded address of the first register.
+ * @return Result of the execution status.
+ */
+static response_status_t read_register(uint8_t* ppt_data, size_t p_data_sz, uint16_t p_reg)
+{
+    response_status_t ret_val = select_bank(p_reg);
+
+    if (ret_val == RET_OK)
+    {
+        ret_val = ha_iic_master_mem_read(IIC_GET_DEV_PORT(ICM209_DEV_1),
+                                         IIC_GET_DEV_ADDRESS(ICM209_DEV_1),
+                                         ppt_data,
+                                         p_data_sz,
+                                         ICM209_REG_ADDR(p_reg),
+                                         HW_IIC_MEM_SZ_8BIT,
+                                         DEFAULT_IIC_TIMEOUT);
+    }
+
+    return ret_val;
+}
+
+static inline response_status_t write_reg_byte(uint8_t p_value, uint16_t p_reg)
+{
+    return write_register(&p_value, DEFAULT_IIC_REG_SZ, p_reg);
+}
+
+/**
+ * @brief This internal function accesses a single AK09916 register through
+ * the I2C master slave 4 channel and waits for the transfer to complete.
+ * @param[in] p_is_read TRUE to read the register, FALSE to write it.
+ * @param[in] p_ak_reg AK09916 register address.
+ * @param[in,out] ppt_value Value to write or buffer to store the read value.
+ * @return Result of the execution status.
+ */
+static response_status_t mag_access(bool_t p_is_read, uint8_t p_ak_reg, uint8_t* ppt_value)
+{
+    response_status_t ret_val  = RET_OK;
+    uint8_t           status   = 0U;
+    uint32_t          start_ms = 0U;
+    uint8_t           slv_addr = AK09916_IIC_ADDR;
+
+    if (p_is_read == TRUE)
+    {
+        slv_addr |= ICM209_I2C_SLV_ADDR_READ;
+    }
+
+    ret_val  = write_reg_byte(slv_addr, ICM209_REG_I2C_SLV4_ADDR);
+    ret_val |= write_reg_byte(p_ak_reg, ICM209_REG_I2C_SLV4_REG);
+    if (p_is_read == FALSE)
+    {
+        ret_val |= write_reg_byte(*ppt_value, ICM209_REG_I2C_SLV4_DO);
+    }
+    ret_val |= write_reg_byte(ICM209_I2C_SLV_CTRL_EN, ICM209_REG_I2C_SLV4_CTRL);
+    if (ret_val != RET_OK)
+    {
+        return RET_ERROR;
+    }
+
+    start_ms = ha_timer_get_cpu_time_ms();
+    do
+    {
+        ret_val = read_register(&status, DEFAULT_IIC_REG_SZ, ICM209_REG_I2C_MST_STATUS);
+        if ((ret_val == RET_OK) && ((status & ICM209_I2C_MST_STATUS_SLV4_DONE) != 0U))
+        {
+            break;
+        }
+        ret_val = RET_TIMEOUT;
+    } while ((ha_timer_get_cpu_time_ms() - start_ms) < ICM209_SLV4_TIMEOUT_MS);
+
+    if ((ret_val == RET_OK) && ((status & ICM209_I2C_MST_STATUS_SLV4_NACK) != 0U))
+    {
+        ret_val = RET_ERROR;
+    }
+
+    if ((ret_val == RET_OK) && (p_is_read == TRUE))
+    {
+        ret_val = read_register(ppt_value, DEFAULT_IIC_REG_SZ, ICM209_REG_I2C_SLV4_DI);
+    }
+
+    return ret_val;
+}
+
+/**
+ * @brief This internal function computes a sample rate divider.
+ * @param[in] p_base_rate_hz Base sample rate of the sensor.
+ * @param[in] p_rate_hz Requested sample rate.
+ * @return The divider value to program.
+ */
+static uint16_t get_rate_divider(uint16_t p_base_rate_hz, uint16_t p_rate_hz)
+{
+    if ((p_rate_hz == 0U) || (p_rate_hz >= p_base_rate_hz))
+    {
+        return 0U;
+    }
+
+    return (uint16_t)((p_base_rate_hz / p_rate_hz) - 1U);
+}
+
+/**
+ * @brief This internal function configures the gyroscope and accelerometer
+ * full scale, low pass filter and sample rate.
+ * @return Result of the execution status.
+ */
+static response_status_t config_motion_sensors(void)
+{
+    response_status_t ret_val    = RET_OK;
+    uint8_t           pwr_mgmt_2 = 0U;
+    uint16_t          accel_div  = 0U;
+    uint8_t           div_buf[ICM209_REG_ACCEL_SMPLRT_DIV_LEN] = { 0U };
+
+    if (g_icm_drv.settings.enable_accelerometer == FALSE)
+    {
+        pwr_mgmt_2 |= ICM209_PWR_MGMT_2_ACCEL_OFF;
+    }
+    if (g_icm_drv.settings.enable_gyroscope == FALSE)
+    {
+        pwr_mgmt_2 |= ICM209_PWR_MGMT_2_GYRO_OFF;
+    }
+
+    accel_div  = get_rate_divider(ICM209_SENS_BASE_RATE_HZ,
+                                  g_icm_drv.settings.accelerometer_frequency);
+    div_buf[0] = BYTE_HIGH(accel_div);
+    div_buf[1] = BYTE_LOW(accel_div);
+
+    ret_val  = write_reg_byte(pwr_mgmt_2, ICM209_REG_PWR_MGMT_2);
+    ret_val |= write_reg_byte((g_icm_drv.settings.mode == 0U) ? ICM209_LP_CONFIG_ALL_CYCLE : 0U,
+                              ICM209_REG_LP_CONFIG);
+    ret_val |= write_reg_byte(ICM209_GYRO_CONFIG_1_FS_2000DPS | ICM209_GYRO_CONFIG_1_DLPF_EN,
+                              ICM209_REG_GYRO_CONFIG_1);
+    ret_val |= write_reg_byte((uint8_t)get_rate_divider(ICM209_SENS_BASE_RATE_HZ,
+                                                        g_icm_drv.settings.gyroscope_frequency),
+                              ICM209_REG_GYRO_SMPLRT_DIV);
+    ret_val |= write_reg_byte(ICM209_ACCEL_CONFIG_FS_4G | ICM209_ACCEL_CONFIG_DLPF_EN,
+                              ICM209_REG_ACCEL_CONFIG);
+    ret_val |= write_register(div_buf, sizeof(div_buf), ICM209_REG_ACCEL_SMPLRT_DIV);
+
+    return ret_val;
+}
+
+/**
+ * @brief This internal function enables the I2C master, checks and starts the
+ * AK09916 magnetometer and maps its measurement registers to the external
+ * sensor data registers through slave 0.
+ * @return Result of the execution status.
+ */
+static response_status_t config_magnetometer(void)
+{
+    response_status_t ret_val = RET_OK;
+    uint8_t           reg_val = 0U;
+    uint16_t          freq    = g_icm_drv.settings.magnetometer_frequency;
+
+    ret_val  = write_reg_byte(ICM209_USER_CTRL_I2C_MST_EN, ICM209_REG_USER_CTRL);
+    ret_val |= write_reg_byte(ICM209_I2C_MST_CTRL_P_NSR | ICM209_I2C_MST_CTRL_CLK_400KHZ,
+                              ICM209_REG_I2C_MST_CTRL);
+    ret_val |= write_reg_byte(ICM209_I2C_MST_ODR_68_75_HZ, ICM209_REG_I2C_MST_ODR_CONFIG);
+    if (ret_val == RET_OK)
+    {
+        ret_val = mag_access(TRUE, AK09916_REG_WIA2, &reg_val);
+    }
+    if (ret_val != RET_OK)
+    {
+        return ret_val;
+    }
+    if (reg_val != AK09916_DEVICE_ID)
+    {
+        return RET_NOT_FOUND;
+    }
+
+    reg_val = AK09916_CNTL3_SRST;
+    ret_val = mag_access(FALSE, AK09916_REG_CNTL3, &reg_val);
+
+    if (freq <= 10U)
+    {
+        reg_val = AK09916_MODE_CONT_10HZ;
+    }
+    else if (freq <= 20U)
+    {
+        reg_val = AK09916_MODE_CONT_20HZ;
+    }
+    else if (freq <= 50U)
+    {
+        reg_val = AK09916_MODE_CONT_50HZ;
+    }
+    else
+    {
+        reg_val = AK09916_MODE_CONT_100HZ;
+    }
+    ret_val |= mag_access(FALSE, AK09916_REG_CNTL2, &reg_val);
+
+    ret_val |= write_reg_byte(AK09916_IIC_ADDR | ICM209_I2C_SLV_ADDR_READ,
+                              ICM209_REG_I2C_SLV0_ADDR);
+    ret_val |= write_reg_byte(AK09916_REG_HXL, ICM209_REG_I2C_SLV0_REG);
+    ret_val |= write_reg_byte(ICM209_I2C_SLV_CTRL_EN | AK09916_REG_DATA_LEN,
+                              ICM209_REG_I2C_SLV0_CTRL);
+
+    return ret_val;
+}
+
+/**
+ * @brief This internal function writes data to the DMP memory. The data shall
+ * not cross a DMP memory bank boundary.
+ * @param[in] p_addr DMP memory address.
+ * @param[in] ppt_data Data to write.
+ * @param[in] p_data_sz Size of the data.
+ * @return Result of the execution status.
+ */
+static response_status_t dmp_write_mem(uint16_t p_addr, const uint8_t* ppt_data, size_t p_data_sz)
+{
+    response_status_t ret_val = RET_OK;
+
+    ret_val  = write_reg_byte(BYTE_HIGH(p_addr), ICM209_REG_MEM_BANK_SEL);
+    ret_val |= write_reg_byte(BYTE_LOW(p_addr), ICM209_REG_MEM_START_ADDR);
+    ret_val |= write_register(ppt_data, p_data_sz, ICM209_REG_MEM_R_W);
+
+    return ret_val;
+}
+
+/**
+ * @brief This internal function reads data from the DMP memory. The data shall
+ * not cross a DMP memory bank boundary.
+ * @param[in] p_addr DMP memory address.
+ * @param[out] ppt_data Buffer to store the read data.
+ * @param[in] p_data_sz Size of the data.
+ * @return Result of the execution status.
+ */
+static response_status_t dmp_read_mem(uint16_t p_addr, uint8_t* ppt_data, size_t p_data_sz)
+{
+    response_status_t ret_val = RET_OK;
+
+    ret_val  = write_reg_byte(BYTE_HIGH(p_addr), ICM209_REG_MEM_BANK_SEL);
+    ret_val |= write_reg_byte(BYTE_LOW(p_addr), ICM209_REG_MEM_START_ADDR);
+    ret_val |= read_register(ppt_data, p_data_sz, ICM209_REG_MEM_R_W);
+
+    return ret_val;
+}
+
+static inline response_status_t dmp_write_key16(uint16_t p_addr, uint16_t p_value)
+{
+    uint8_t buf[2] = { BYTE_HIGH(p_value), BYTE_LOW(p_value) };
+
+    return dmp_write_mem(p_addr, buf, sizeof(buf));
+}
+
+static inline response_status_t dmp_write_key32(uint16_t p_addr, uint32_t p_value)
+{
+    uint8_t buf[4] = { BYTE_HIGH(p_value >> 16U), BYTE_LOW(p_value >> 16U), BYTE_HIGH(p_value),
+                       BYTE_LOW(p_value) };
+
+    return dmp_write_mem(p_addr, buf, sizeof(buf));
+}
+
+/**
+ * @brief This internal function writes a 3x3 DMP matrix in a single
+ * transaction, the matrix keys are consecutive in the same memory bank.
+ * @param[in] p_addr DMP memory address of the first coefficient.
+ * @param[in] ppt_mtx Row major Q30 coefficients.
+ * @return Result of the execution status.
+ */
+static response_status_t dmp_write_matrix(uint16_t p_addr, const int32_t ppt_mtx[9])
+{
+    uint8_t buf[ICM209_DMP_MTX_LEN];
+
+    for (uint8_t i = 0U; i < 9U; i++)
+    {
+        const uint32_t value = (uint32_t)ppt_mtx[i];
+
+        buf[(4U * i)]      = BYTE_HIGH(value >> 16U);
+        buf[(4U * i) + 1U] = BYTE_LOW(value >> 16U);
+        buf[(4U * i) + 2U] = BYTE_HIGH(value);
+        buf[(4U * i) + 3U] = BYTE_LOW(value);
+    }
+
+    return dmp_write_mem(p_addr, buf, sizeof(buf));
+}
+
+/**
+ * @brief This internal function computes the DMP gyroscope scale factor, it
+ * converts the gyroscope samples to the angle per DMP step from the sample
+ * rate divider and the trimmed clock, as the InvenSense reference does.
+ * @param[in] p_gyro_div Value of the gyroscope sample rate divider.
+ * @param[in] p_pll Value of the TIMEBASE_CORRECTION_PLL register.
+ * @return The GYRO_SF key value.
+ */
+static uint32_t get_dmp_gyro_sf(uint8_t p_gyro_div, uint8_t p_pll)
+{
+    const uint64_t trim    = (uint64_t)ICM209_DMP_GYRO_SF_PLL_STEP * (p_pll & ICM209_PLL_MSK);
+    const uint64_t base    = ((p_pll & ICM209_PLL_SIGN) != 0U) ? (ICM209_DMP_GYRO_SF_BASE - trim)
+                                                               : (ICM209_DMP_GYRO_SF_BASE + trim);
+    const uint64_t gyro_sf = (ICM209_DMP_GYRO_SF_MAGIC * (1ULL << ICM209_DMP_GYRO_SF_LEVEL)
+                              * ((uint64_t)p_gyro_div + 1U))
+                             / base / ICM209_DMP_GYRO_SF_SCALE;
+
+    return (gyro_sf > ICM209_DMP_GYRO_SF_MAX) ? ICM209_DMP_GYRO_SF_MAX : (uint32_t)gyro_sf;
+}
+
+/**
+ * @brief This internal function loads the DMP image into the DMP memory,
+ * verifies every chunk and sets the program start address.
+ * @return Result of the execution status.
+ */
+static response_status_t dmp_load_image(void)
+{
+    response_status_t ret_val  = RET_OK;
+    uint16_t          offset   = 0U;
+    uint16_t          addr     = ICM209_DMP_LOAD_START;
+    size_t            chunk_sz = 0U;
+    uint8_t           verify_buf[ICM209_DMP_MEM_CHUNK_SZ];
+    uint8_t           start_addr[2] = { BYTE_HIGH(ICM209_DMP_START), BYTE_LOW(ICM209_DMP_START) };
+
+    while ((offset < g_icm_drv.dmp_image_sz) && (ret_val == RET_OK))
+    {
+        /// Chunks never cross a memory bank boundary
+        chunk_sz = ICM209_MIN(ICM209_DMP_MEM_CHUNK_SZ, (size_t)g_icm_drv.dmp_image_sz - offset);
+        chunk_sz = ICM209_MIN(chunk_sz, ICM209_DMP_MEM_BANK_SZ - (size_t)BYTE_LOW(addr));
+
+        ret_val = dmp_write_mem(addr, &g_icm_drv.dmp_image[offset], chunk_sz);
+        if (ret_val == RET_OK)
+        {
+            ret_val = dmp_read_mem(addr, verify_buf, chunk_sz);
+        }
+        if ((ret_val == RET_OK)
+            && (memcmp(verify_buf, &g_icm_drv.dmp_image[offset], chunk_sz) != 0))
+        {
+            ret_val = RET_ERROR;
+        }
+
+        offset += (uint16_t)chunk_sz;
+        addr   += (uint16_t)chunk_sz;
+    }
+
+    if (ret_val == RET_OK)
+    {
+        ret_val = write_register(start_addr, sizeof(start_addr), ICM209_REG_PRGM_START_ADDR);
+    }
+
+    return ret_val;
+}
+
+/**
+ * @brief This internal function writes the scale and mounting keys of the
+ * DMP for the full scales set by `config_motion_sensors`. Without them the
+ * DMP integrates the gyroscope with a wrong scale and its quaternion is
+ * meaningless. The outputs keep the units of the raw FIFO path and the
+ * compass is turned to the accelerometer axes.
+ * @return Result of the execution status.
+ */
+static response_status_t dmp_config_scale(void)
+{
+    /// Y and Z of the AK09916 are inverted compared to the motion sensors
+    static const int32_t cpass_mtx[9] = {
+        ICM209_DMP_CPASS_ONE, 0, 0, 0, -ICM209_DMP_CPASS_ONE, 0, 0, 0, -ICM209_DMP_CPASS_ONE,
+    };
+    static const int32_t b2s_mtx[9] = {
+        ICM209_DMP_MTX_ONE, 0, 0, 0, ICM209_DMP_MTX_ONE, 0, 0, 0, ICM209_DMP_MTX_ONE,
+    };
+    response_status_t ret_val  = RET_OK;
+    uint8_t           pll      = 0U;
+    uint8_t           gyro_div = (uint8_t)get_rate_divider(ICM209_SENS_BASE_RATE_HZ,
+                                                           g_icm_drv.settings.gyroscope_frequency);
+
+    ret_val = read_register(&pll, DEFAULT_IIC_REG_SZ, ICM209_REG_TIMEBASE_CORRECTION_PLL);
+    if (ret_val != RET_OK)
+    {
+        return ret_val;
+    }
+
+    ret_val  = dmp_write_key32(ICM209_DMP_ACC_SCALE, ICM209_DMP_ACC_SCALE_4G);
+    ret_val |= dmp_write_key32(ICM209_DMP_ACC_SCALE2, ICM209_DMP_ACC_SCALE2_4G);
+    ret_val |= dmp_write_key32(ICM209_DMP_GYRO_FULLSCALE, ICM209_DMP_GYRO_FS_2000DPS);
+    ret_val |= dmp_write_key32(ICM209_DMP_GYRO_SF, get_dmp_gyro_sf(gyro_div, pll));
+    ret_val |= dmp_write_matrix(ICM209_DMP_CPASS_MTX, cpass_mtx);
+    ret_val |= dmp_write_matrix(ICM209_DMP_B2S_MTX, b2s_mtx);
+
+    return ret_val;
+}
+
+/**
+ * @brief This internal function selects the DMP outputs and their rates. The
+ * DMP reads the magnetometer through the already configured slave 0.
+ * @return Result of the execution status.
+ */
+static response_status_t dmp_config_outputs(void)
+{
+    response_status_t ret_val  = RET_OK;
+    uint16_t          out_ctl  = ICM209_DMP_HDR_QUAT9;
+    uint16_t          rdy_stat = ICM209_DMP_RDY_GYRO | ICM209_DMP_RDY_ACCEL;
+
+    if (g_icm_drv.settings.enable_accelerometer == TRUE)
+    {
+        out_ctl |= ICM209_DMP_HDR_ACCEL;
+    }
+    if (g_icm_drv.settings.enable_gyroscope == TRUE)
+    {
+        out_ctl |= ICM209_DMP_HDR_GYRO;
+    }
+    if (g_icm_drv.settings.enable_magnetometer == TRUE)
+    {
+        out_ctl  |= ICM209_DMP_HDR_CPASS;
+        rdy_stat |= ICM209_DMP_RDY_CPASS;
+    }
+
+    ret_val  = dmp_write_key16(ICM209_DMP_DATA_OUT_CTL1, out_ctl);
+    ret_val |= dmp_write_key16(ICM209_DMP_DATA_OUT_CTL2, 0U);
+    ret_val |= dmp_write_key16(ICM209_DMP_DATA_INTR_CTL, out_ctl);
+    ret_val |= dmp_write_key16(ICM209_DMP_MOTION_EVENT_CTL, 0U);
+    ret_val |= dmp_write_key16(ICM209_DMP_DATA_RDY_STATUS, rdy_stat);
+    ret_val |= dmp_write_key16(ICM209_DMP_ODR_QUAT9,
+                               get_rate_divider(ICM209_DMP_BASE_RATE_HZ,
+                                                g_icm_drv.settings.quaternion_frequency));
+    ret_val |= dmp_write_key16(ICM209_DMP_ODR_ACCEL,
+                               get_rate_divider(ICM209_DMP_BASE_RATE_HZ,
+                                                g_icm_drv.settings.accelerometer_frequency));
+    ret_val |= dmp_write_key16(ICM209_DMP_ODR_GYRO,
+                               get_rate_divider(ICM209_DMP_BASE_RATE_HZ,
+                                                g_icm_drv.settings.gyroscope_frequency));
+    ret_val |= dmp_write_key16(ICM209_DMP_ODR_CPASS,
+                               get_rate_divider(ICM209_DMP_BASE_RATE_HZ,
+                                                g_icm_drv.settings.magnetometer_frequency));
+
+    return ret_val;
+}
+
+/**
+ * @brief This internal function selects what is pushed to the FIFO, resets it
+ * and enables it, together with the DMP if it is used.
+ * @return Result of the execution status.
+ */
+static response_status_t config_fifo(void)
+{
+    response_status_t ret_val   = RET_OK;
+    uint8_t           fifo_en_1 = 0U;
+    uint8_t           fifo_en_2 = 0U;
+    uint8_t           user_ctrl = ICM209_USER_CTRL_FIFO_EN;
+
+    g_icm_drv.frame_sz = 0U;
+    g_icm_drv.fifo_len = 0U;
+
+    if (g_icm_drv.settings.enable_magnetometer == TRUE)
+    {
+        user_ctrl |= ICM209_USER_CTRL_I2C_MST_EN;
+    }
+
+    if (g_icm_drv.is_dmp_running == TRUE)
+    {
+        /// The DMP writes its packets to the FIFO by itself
+        user_ctrl |= ICM209_USER_CTRL_DMP_EN;
+    }
+    else
+    {
+        /// Frame layout follows the FIFO order: accel, gyro, external sensor
+        if (g_icm_drv.settings.enable_accelerometer == TRUE)
+        {
+            fifo_en_2          |= ICM209_FIFO_EN_2_ACCEL;
+            g_icm_drv.frame_sz += 6U;
+        }
+        if (g_icm_drv.settings.enable_gyroscope == TRUE)
+        {
+            fifo_en_2          |= ICM209_FIFO_EN_2_GYRO_XYZ;
+            g_icm_drv.frame_sz += 6U;
+        }
+        if (g_icm_drv.settings.enable_magnetometer == TRUE)
+        {
+            fifo_en_1          |= ICM209_FIFO_EN_1_SLV_0;
+            g_icm_drv.frame_sz += AK09916_REG_DATA_LEN;
+        }
+    }
+
+    ret_val  = write_reg_byte(fifo_en_1, ICM209_REG_FIFO_EN_1);
+    ret_val |= write_reg_byte(fifo_en_2, ICM209_REG_FIFO_EN_2);
+    ret_val |= write_reg_byte(ICM209_FIFO_MODE_SNAPSHOT, ICM209_REG_FIFO_MODE);
+    ret_val |= write_reg_byte(ICM209_FIFO_RST_ALL, ICM209_REG_FIFO_RST);
+    ret_val |= write_reg_byte(0U, ICM209_REG_FIFO_RST);
+    ret_val |= write_reg_byte(user_ctrl, ICM209_REG_USER_CTRL);
+
+    return ret_val;
+}
+
+/**
+ * @brief This internal function empties the FIFO and the bytes kept from it,
+ * the frames and packets start again on the first byte.
+ */
+static void reset_fifo(void)
+{
+    g_icm_drv.fifo_len = 0U;
+    (void)write_reg_byte(ICM209_FIFO_RST_ALL, ICM209_REG_FIFO_RST);
+    (void)write_reg_byte(0U, ICM209_REG_FIFO_RST);
+}
+
+static void publish_sample(icm209_sensors_t p_sens, float p_v0, float p_v1, float p_v2, float p_v3)
+{
+    g_icm_drv.sample[p_sens].value[0] = p_v0;
+    g_icm_drv.sample[p_sens].value[1] = p_v1;
+    g_icm_drv.sample[p_sens].value[2] = p_v2;
+    g_icm_drv.sample[p_sens].value[3] = p_v3;
+    g_icm_drv.sample[p_sens].is_ready = TRUE;
+}
+
+static void publish_accel(const uint8_t* ppt_buf)
+{
+    publish_sample(ICM209_SENS_ACCEL,
+                   (float)ICM209_GET_I16(ppt_buf, 0U) / ICM209_ACCEL_SENSITIVITY,
+                   (float)ICM209_GET_I16(ppt_buf, 2U) / ICM209_ACCEL_SENSITIVITY,
+                   (float)ICM209_GET_I16(ppt_buf, 4U) / ICM209_ACCEL_SENSITIVITY,
+                   0.F);
+}
+
+static void publish_gyro(const uint8_t* ppt_buf)
+{
+    if (g_icm_drv.sample[ICM209_SENS_GYRO].is_ready == FALSE)
+    {
+        memset(g_icm_drv.gyro_sum, 0U, sizeof(g_icm_drv.gyro_sum));
+        g_icm_drv.gyro_cnt = 0U;
+    }
+
+    publish_sample(ICM209_SENS_GYRO,
+                   (float)ICM209_GET_I16(ppt_buf, 0U) / ICM209_GYRO_SENSITIVITY,
+                   (float)ICM209_GET_I16(ppt_buf, 2U) / ICM209_GYRO_SENSITIVITY,
+                   (float)ICM209_GET_I16(ppt_buf, 4U) / ICM209_GYRO_SENSITIVITY,
+                   0.F);
+
+    for (uint8_t i = 0U; i < 3U; i++)
+    {
+        g_icm_drv.gyro_sum[i] += g_icm_drv.sample[ICM209_SENS_GYRO].value[i];
+    }
+    g_icm_drv.gyro_cnt++;
+}
+
+/**
+ * @brief This internal function converts AK09916 measurement data to the
+ * accelerometer axes. The magnetometer Y and Z axes are inverted compared to
+ * the motion sensors.
+ * @param[in] p_x Raw X axis value.
+ * @param[in] p_y Raw Y axis value.
+ * @param[in] p_z Raw Z axis value.
+ */
+static void publish_mag(int16_t p_x, int16_t p_y, int16_t p_z)
+{
+    publish_sample(ICM209_SENS_MAG,
+                   (float)p_x * ICM209_MAG_RESOLUTION,
+                   -(float)p_y * ICM209_MAG_RESOLUTION,
+                   -(float)p_z * ICM209_MAG_RESOLUTION,
+                   0.F);
+}
+
+/**
+ * @brief This internal function decodes the raw FIFO frames. The gyroscope of
+ * every frame is summed for the integration, the accelerometer and the
+ * magnetometer are only published from the newest frame, older ones are
+ * already outdated.
+ * @param[in] p_frame_cnt Number of complete frames in the FIFO buffer.
+ */
+static void parse_raw_frames(uint16_t p_frame_cnt)
+{
+    const uint8_t* pt_frame = &g_icm_drv.fifo_buf[(p_frame_cnt - 1U) * g_icm_drv.frame_sz];
+
+    if (g_icm_drv.settings.enable_accelerometer == TRUE)
+    {
+        publish_accel(pt_frame);
+        pt_frame += 6U;
+    }
+    if (g_icm_drv.settings.enable_gyroscope == TRUE)
+    {
+        const uint16_t gyro_pos = (g_icm_drv.settings.enable_accelerometer == TRUE) ? 6U : 0U;
+
+        for (uint16_t i = 0U; i < p_frame_cnt; i++)
+        {
+            publish_gyro(&g_icm_drv.fifo_buf[(i * g_icm_drv.frame_sz) + gyro_pos]);
+        }
+        pt_frame += 6U;
+    }
+    if (g_icm_drv.settings.enable_magnetometer == TRUE)
+    {
+        /// AK09916 data is little endian, ST2 is the last byte of the block
+        if ((pt_frame[AK09916_REG_DATA_LEN - 1U] & AK09916_ST2_HOFL) == 0U)
+        {
+            publish_mag((int16_t)BYTES_TO_WORD(unsigned, pt_frame[0U], pt_frame[1U]),
+                        (int16_t)BYTES_TO_WORD(unsigned, pt_frame[2U], pt_frame[3U]),
+                        (int16_t)BYTES_TO_WORD(unsigned, pt_frame[4U], pt_frame[5U]));
+        }
+    }
+}
+
+/**
+ * @brief This internal function computes the length of a DMP packet from its
+ * header.
+ * @param[in] p_header Packet header.
+ * @return Packet length in bytes, 0 if the header is not supported.
+ */
+static uint16_t get_dmp_packet_len(uint16_t p_header)
+{
+    const uint16_t supported = ICM209_DMP_HDR_ACCEL | ICM209_DMP_HDR_GYRO | ICM209_DMP_HDR_CPASS
+                               | ICM209_DMP_HDR_QUAT9;
+    uint16_t       len       = ICM209_DMP_HDR_LEN + ICM209_DMP_FOOTER_LEN;
+
+    if ((p_header & (uint16_t)~supported) != 0U)
+    {
+        return 0U;
+    }
+
+    len += ((p_header & ICM209_DMP_HDR_ACCEL) != 0U) ? ICM209_DMP_ACCEL_LEN : 0U;
+    len += ((p_header & ICM209_DMP_HDR_GYRO) != 0U) ? ICM209_DMP_GYRO_LEN : 0U;
+    len += ((p_header & ICM209_DMP_HDR_CPASS) != 0U) ? ICM209_DMP_CPASS_LEN : 0U;
+    len += ((p_header & ICM209_DMP_HDR_QUAT9) != 0U) ? ICM209_DMP_QUAT9_LEN : 0U;
+
+    return len;
+}
+
+/**
+ * @brief This internal function decodes one DMP packet.
+ * @param[in] ppt_packet Packet, starting with its header.
+ * @param[in] p_header Packet header.
+ */
+static void parse_dmp_packet(const uint8_t* ppt_packet, uint16_t p_header)
+{
+    const uint8_t* pt_data = ppt_packet + ICM209_DMP_HDR_LEN;
+    float          q_x     = 0.F;
+    float          q_y     = 0.F;
+    float          q_z     = 0.F;
+    float          q_w_sq  = 0.F;
+
+    if ((p_header & ICM209_DMP_HDR_ACCEL) != 0U)
+    {
+        publish_accel(pt_data);
+        pt_data += ICM209_DMP_ACCEL_LEN;
+    }
+    if ((p_header & ICM209_DMP_HDR_GYRO) != 0U)
+    {
+        publish_gyro(pt_data);
+        pt_data += ICM209_DMP_GYRO_LEN;
+    }
+    if ((p_header & ICM209_DMP_HDR_CPASS) != 0U)
+    {
+        /// The DMP already reports the compass in the motion sensors frame
+        publish_sample(ICM209_SENS_MAG,
+                       (float)ICM209_GET_I16(pt_data, 0U) * ICM209_MAG_RESOLUTION,
+                       (float)ICM209_GET_I16(pt_data, 2U) * ICM209_MAG_RESOLUTION,
+                       (float)ICM209_GET_I16(pt_data, 4U) * ICM209_MAG_RESOLUTION,
+                       0.F);
+        pt_data += ICM209_DMP_CPASS_LEN;
+    }
+    if ((p_header & ICM209_DMP_HDR_QUAT9) != 0U)
+    {
+        q_x    = (float)ICM209_GET_I32(pt_data, 0U) / ICM209_Q30_SCALE;
+        q_y    = (float)ICM209_GET_I32(pt_data, 4U) / ICM209_Q30_SCALE;
+        q_z    = (float)ICM209_GET_I32(pt_data, 8U) / ICM209_Q30_SCALE;
+        q_w_sq = 1.F - ((q_x * q_x) + (q_y * q_y) + (q_z * q_z));
+        /// w is not transmitted, the quaternion is unit length
+        publish_sample(ICM209_SENS_QUAT, (q_w_sq > 0.F) ? sqrtf(q_w_sq) : 0.F, q_x, q_y, q_z);
+    }
+}
+
+/**
+ * @brief This internal function decodes all complete DMP packets of the FIFO
+ * buffer and keeps the incomplete tail for the next batch.
+ * @return Result of the execution status.
+ * @retval `RET_ERROR` if the stream is out of sync and the FIFO shall be reset.
+ */
+static response_status_t parse_dmp_packets(void)
+{
+    uint16_t offset = 0U;
+    uint16_t header = 0U;
+    uint16_t len    = 0U;
+
+    while ((uint16_t)(g_icm_drv.fifo_len - offset) >= ICM209_DMP_HDR_LEN)
+    {
+        header = BYTES_TO_WORD(unsigned, g_icm_drv.fifo_buf[offset + 1U],
+                               g_icm_drv.fifo_buf[offset]);
+        len    = get_dmp_packet_len(header);
+        if (len == 0U)
+        {
+            return RET_ERROR;
+        }
+        if ((uint16_t)(g_icm_drv.fifo_len - offset) < len)
+        {
+            break;
+        }
+
+        parse_dmp_packet(&g_icm_drv.fifo_buf[offset], header);
+        offset += len;
+    }
+
+    g_icm_drv.fifo_len -= offset;
+    memmove(g_icm_drv.fifo_buf, &g_icm_drv.fifo_buf[offset], g_icm_drv.fifo_len);
+
+    return RET_OK;
+}
+
+/**
+ * @brief This function registers the DMP firmware image. It shall be called
+ * before `dd_icm209_init`. The image is the InvenSense DMP3 firmware
+ * (icm20948_img.dmp3a), it is not part of this driver.
+ * @param[in] ppt_image Pointer to the image, it shall stay valid. NULL with a
+ * size of 0 unregisters the image, the next init uses the raw FIFO.
+ * @param[in] p_size Size of the image.
+ * @return Result of the execution status.
+ */
+response_status_t dd_icm209_set_dmp_image(const uint8_t* ppt_image, uint16_t p_size)
+{
+    ASSERT_AND_RETURN((ppt_image == NULL) != (p_size == 0U), RET_PARAM_ERROR);
+
+    g_icm_drv.dmp_image    = ppt_image;
+    g_icm_drv.dmp_image_sz = p_size;
+
+    return RET_OK;
+}
+
+/**
+ * @brief This function initializes the ICM-20948 and the AK09916
+ * magnetometer and starts the FIFO. When the quaternion output is requested
+ * and a DMP image is registered, the DMP is loaded and owns the FIFO,
+ * otherwise the raw sensor data is pushed to the FIFO.
+ * @param[in] p_settings Sensor configuration.
+ * @return Result of the execution status.
+ * @retval `RET_NOT_FOUND` if the ICM-20948 or the AK09916 does not respond
+ * with the expected identification code.
+ * @retval `RET_PARAM_ERROR` if no sensor is enabled, or only the quaternion
+ * without a DMP image.
+ */
+response_status_t dd_icm209_init(TeensyICM20948Settings p_settings)
+{
+    response_status_t ret_val = RET_OK;
+    uint8_t           reg_val = 0U;
+
+    g_icm_drv.is_initialized = FALSE;
+    /// Without the DMP nor a raw sensor nothing reaches the FIFO, a raw frame would be empty
+    ASSERT_AND_RETURN((p_settings.enable_accelerometer == FALSE)
+                          && (p_settings.enable_gyroscope == FALSE)
+                          && (p_settings.enable_magnetometer == FALSE)
+                          && ((p_settings.enable_quaternion == FALSE)
+                              || (g_icm_drv.dmp_image == NULL)),
+                      RET_PARAM_ERROR);
+
+    ret_val = ha_iic_init();
+    if (ret_val != RET_OK)
+    {
+        return ret_val;
+    }
+
+    memset(g_icm_drv.sample, 0U, sizeof(g_icm_drv.sample));
+    memset(g_icm_drv.gyro_sum, 0U, sizeof(g_icm_drv.gyro_sum));
+    g_icm_drv.gyro_cnt       = 0U;
+    g_icm_drv.settings       = p_settings;
+    g_icm_drv.curr_bank      = ICM209_BANK_UNKNOWN;
+    g_icm_drv.is_dmp_running = FALSE;
+    g_icm_drv.is_initialized = FALSE;
+
+    ret_val = read_register(&reg_val, DEFAULT_IIC_REG_SZ, ICM209_REG_WHO_AM_I);
+    if (ret_val != RET_OK)
+    {
+        return ret_val;
+    }
+    if (reg_val != ICM209_CHIP_ID)
+    {
+        return RET_NOT_FOUND;
+    }
+
+    ret_val = write_reg_byte(ICM209_PWR_MGMT_1_RESET, ICM209_REG_PWR_MGMT_1);
+    ha_timer_hard_delay_ms(ICM209_RESET_DELAY_MS);
+    /// The reset brings the bank selection back to bank 0
+    g_icm_drv.curr_bank = 0U;
+
+    ret_val |= write_reg_byte(ICM209_PWR_MGMT_1_CLKSEL_AUTO, ICM209_REG_PWR_MGMT_1);
+    ha_timer_hard_delay_ms(ICM209_WAKEUP_DELAY_MS);
+    ret_val |= config_motion_sensors();
+
+    if ((ret_val == RET_OK) && (p_settings.enable_magnetometer == TRUE))
+    {
+        ret_val = config_magnetometer();
+    }
+
+    if ((ret_val == RET_OK) && (p_settings.enable_quaternion == TRUE)
+        && (g_icm_drv.dmp_image != NULL))
+    {
+        ret_val = dmp_load_image();
+        if (ret_val == RET_OK)
+        {
+            ret_val                  = dmp_config_scale();
+            ret_val                 |= dmp_config_outputs();
+            g_icm_drv.is_dmp_running = (ret_val == RET_OK) ? TRUE : FALSE;
+        }
+    }
+
+    if (ret_val == RET_OK)
+    {
+        ret_val = config_fifo();
+    }
+
+    g_icm_drv.is_initialized = (ret_val == RET_OK) ? TRUE : FALSE;
+
+    return ret_val;
+}
+
+/**
+ * @brief This function drains the FIFO and publishes the newest samples. The
+ * whole batch is read in a single bus transaction so the cost of a call does
+ * not depend on the number of samples accumulated since the previous call.
+ * A FIFO that overflowed, holds a partial raw frame or was read short has lost
+ * its frame boundaries: it is reset and its content dropped, instead of every
+ * later frame being decoded shifted.
+ * It shall be called periodically from the main context.
+ */
+void dd_icm209_task(void)
+{
+    response_status_t ret_val    = RET_OK;
+    uint8_t           cnt_buf[ICM209_REG_FIFO_COUNT_LEN] = { 0U };
+    uint8_t           int_status = 0U;
+    uint16_t          fifo_cnt   = 0U;
+    uint16_t          read_sz    = 0U;
+    uint16_t          frame_cnt  = 0U;
+
+    if (g_icm_drv.is_initialized == FALSE)
+    {
+        return;
+    }
+
+    ret_val = read_register(cnt_buf, sizeof(cnt_buf), ICM209_REG_FIFO_COUNT);
+    if (ret_val != RET_OK)
+    {
+        return;
+    }
+
+    fifo_cnt = BYTES_TO_WORD(unsigned, cnt_buf[1], cnt_buf[0]) & ICM209_FIFO_COUNT_MSK;
+    if (fifo_cnt == 0U)
+    {
+        return;
+    }
+
+    ret_val = read_register(&int_status, DEFAULT_IIC_REG_SZ, ICM209_REG_INT_STATUS_2);
+    if (ret_val != RET_OK)
+    {
+        return;
+    }
+    if (((int_status & ICM209_INT_STATUS_2_FIFO_OVF) != 0U)
+        || ((g_icm_drv.is_dmp_running == FALSE) && ((fifo_cnt % g_icm_drv.frame_sz) != 0U)))
+    {
+        reset_fifo();
+        return;
+    }
+
+    if (g_icm_drv.is_dmp_running == TRUE)
+    {
+        read_sz = ICM209_MIN(fifo_cnt, ICM209_FIFO_BATCH_SZ);
+    }
+    else
+    {
+        frame_cnt = ICM209_MIN(fifo_cnt, ICM209_FIFO_BATCH_SZ) / g_icm_drv.frame_sz;
+        read_sz   = frame_cnt * g_icm_drv.frame_sz;
+    }
+
+    if (read_sz == 0U)
+    {
+        return;
+    }
+
+    ret_val = read_register(&g_icm_drv.fifo_buf[g_icm_drv.fifo_len], read_sz, ICM209_REG_FIFO_R_W);
+    if (ret_val != RET_OK)
+    {
+        /// The failed read may have consumed part of the data
+        reset_fifo();
+        return;
+    }
+
+    if (g_icm_drv.is_dmp_running == TRUE)
+    {
+        g_icm_drv.fifo_len += read_sz;
+        ret_val             = parse_dmp_packets();
+    }
+    else
+    {
+        parse_raw_frames(frame_cnt);
+    }
+
+    if (ret_val != RET_OK)
+    {
+        /// Packet boundaries are lost, restart from an empty FIFO
+        reset_fifo();
+    }
+}
+
+bool_t dd_icm209_gyro_data_is_ready(void)
+{
+    return g_icm_drv.sample[ICM209_SENS_GYRO].is_ready;
+}
+
+bool_t dd_icm209_accel_data_is_ready(void)
+{
+    return g_icm_drv.sample[ICM209_SENS_ACCEL].is_ready;
+}
+
+bool_t dd_icm209_mag_data_is_ready(void)
+{
+    return g_icm_drv.sample[ICM209_SENS_MAG].is_ready;
+}
+
+bool_t dd_icm209_quat_data_is_ready(void)
+{
+    return g_icm_drv.sample[ICM209_SENS_QUAT].is_ready;
+}
+
+/**
+ * @brief This function returns the newest gyroscope sample in dps and clears
+ * the ready flag.
+ */
+void dd_icm209_read_gyro_data(float* ppt_x, float* ppt_y, float* ppt_z)
+{
+    ASSERT_AND_RETURN(ppt_x == NULL || ppt_y == NULL || ppt_z == NULL, );
+
+    *ppt_x = g_icm_drv.sample[ICM209_SENS_GYRO].value[0];
+    *ppt_y = g_icm_drv.sample[ICM209_SENS_GYRO].value[1];
+    *ppt_z = g_icm_drv.sample[ICM209_SENS_GYRO].value[2];
+
+    g_icm_drv.sample[ICM209_SENS_GYRO].is_ready = FALSE;
+}
+
+/**
+ * @brief This function returns the mean rate in dps of the gyroscope samples
+ * since the previous read and clears the ready flag. The mean over the count
+ * sample periods integrates to the same angle as every sample on its own.
+ * @return Number of samples in the mean, 0 if none came.
+ */
+uint16_t dd_icm209_read_gyro_mean(float* ppt_x, float* ppt_y, float* ppt_z)
+{
+    ASSERT_AND_RETURN(ppt_x == NULL || ppt_y == NULL || ppt_z == NULL, 0U);
+
+    const uint16_t cnt = (g_icm_drv.sample[ICM209_SENS_GYRO].is_ready == TRUE) ? g_icm_drv.gyro_cnt
+                                                                                : 0U;
+
+    if (cnt == 0U)
+    {
+        return 0U;
+    }
+
+    *ppt_x = g_icm_drv.gyro_sum[0] / (float)cnt;
+    *ppt_y = g_icm_drv.gyro_sum[1] / (float)cnt;
+    *ppt_z = g_icm_drv.gyro_sum[2] / (float)cnt;
+
+    g_icm_drv.sample[ICM209_SENS_GYRO].is_ready = FALSE;
+
+    return cnt;
+}
+
+/**
+ * @brief This function returns the newest accelerometer sample in g and clears
+ * the ready flag.
+ */
+void dd_icm209_read_accel_data(float* ppt_x, float* ppt_y, float* ppt_z)
+{
+    ASSERT_AND_RETURN(ppt_x == NULL || ppt_y == NULL || ppt_z == NULL, );
+
+    *ppt_x = g_icm_drv.sample[ICM209_SENS_ACCEL].value[0];
+    *ppt_y = g_icm_drv.sample[ICM209_SENS_ACCEL].value[1];
+    *ppt_z = g_icm_drv.sample[ICM209_SENS_ACCEL].value[2];
+
+    g_icm_drv.sample[ICM209_SENS_ACCEL].is_ready = FALSE;
+}
+
+/**
+ * @brief This function returns the newest magnetometer sample in uT and clears
+ * the ready flag.
+ */
+void dd_icm209_read_mag_data(float* ppt_x, float* ppt_y, float* ppt_z)
+{
+    ASSERT_AND_RETURN(ppt_x == NULL || ppt_y == NULL || ppt_z == NULL, );
+
+    *ppt_x = g_icm_drv.sample[ICM209_SENS_MAG].value[0];
+    *ppt_y = g_icm_drv.sample[ICM209_SENS_MAG].value[1];
+    *ppt_z = g_icm_drv.sample[ICM209_SENS_MAG].value[2];
+
+    g_icm_drv.sample[ICM209_SENS_MAG].is_ready = FALSE;
+}
+
+/**
+ * @brief This function returns the newest DMP orientation quaternion and
+ * clears the ready flag.
+ */
+void dd_icm209_read_quat_data(float* ppt_w, float* ppt_x, float* ppt_y, float* ppt_z)
+{
+    ASSERT_AND_RETURN(ppt_w == NULL || ppt_x == NULL || ppt_y == NULL || ppt_z == NULL, );
+
+    *ppt_w = g_icm_drv.sample[ICM209_SENS_QUAT].value[0];
+    *ppt_x = g_icm_drv.sample[ICM209_SENS_QUAT].value[1];
+    *ppt_y = g_icm_drv.sample[ICM209_SENS_QUAT].value[2];
+    *ppt_z = g_icm_drv.sample[ICM209_SENS_QUAT].value[3];
+
+    g_icm_drv.sample[ICM209_SENS_QUAT].is_ready = FALSE;
+}
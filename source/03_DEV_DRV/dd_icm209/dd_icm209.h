@@ -0,0 +1,44 @@
+#ifndef DD_ICM209_H
+#define DD_ICM209_H
+
+#include "su_common.h"
+
+#define ICM209_IIC_ADDR_1 (0x68)
+#define ICM209_CHIP_ID    (0xEA)
+
+/// Gyroscope full scale is fixed to +-2000 dps
+#define ICM209_GYRO_SENSITIVITY (16.4F)
+/// Accelerometer full scale is fixed to +-4 g
+#define ICM209_ACCEL_SENSITIVITY (8192.F)
+/// AK09916 resolution in uT/LSB
+#define ICM209_MAG_RESOLUTION (0.15F)
+
+typedef struct
+{
+    /// 0 = low power mode, 1 = high performance mode
+    uint8_t  mode;
+    bool_t   enable_gyroscope;
+    bool_t   enable_accelerometer;
+    bool_t   enable_magnetometer;
+    /// Quaternion output needs the DMP image, see `dd_icm209_set_dmp_image`
+    bool_t   enable_quaternion;
+    uint16_t gyroscope_frequency;
+    uint16_t accelerometer_frequency;
+    uint16_t magnetometer_frequency;
+    uint16_t quaternion_frequency;
+} TeensyICM20948Settings;
+
+response_status_t dd_icm209_set_dmp_image(const uint8_t* ppt_image, uint16_t p_size);
+response_status_t dd_icm209_init(TeensyICM20948Settings p_settings);
+void              dd_icm209_task(void);
+bool_t            dd_icm209_gyro_data_is_ready(void);
+bool_t            dd_icm209_accel_data_is_ready(void);
+bool_t            dd_icm209_mag_data_is_ready(void);
+bool_t            dd_icm209_quat_data_is_ready(void);
+void              dd_icm209_read_gyro_data(float* ppt_x, float* ppt_y, float* ppt_z);
+uint16_t          dd_icm209_read_gyro_mean(float* ppt_x, float* ppt_y, float* ppt_z);
+void              dd_icm209_read_accel_data(float* ppt_x, float* ppt_y, float* ppt_z);
+void              dd_icm209_read_mag_data(float* ppt_x, float* ppt_y, float* ppt_z);
+void dd_icm209_read_quat_data(float* ppt_w, float* ppt_x, float* ppt_y, float* ppt_z);
+
+#endif // DD_ICM209_H
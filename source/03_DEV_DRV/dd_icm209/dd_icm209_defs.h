@@ -0,0 +1,228 @@
+#ifndef DD_ICM209_DEFS_H
+#define DD_ICM209_DEFS_H
+
+#include "su_common.h"
+
+/** @brief ICM-20948 registers are split into 4 user banks, the bank is encoded
+ * in the high byte of the register definitions below.
+ */
+#define ICM209_REG(bank, addr)     ((uint16_t)(((uint16_t)(bank) << 8U) | (addr)))
+#define ICM209_REG_BANK(reg)       ((uint8_t)((reg) >> 8U))
+#define ICM209_REG_ADDR(reg)       ((uint8_t)((reg) & 0xFFU))
+
+/** @name ICM-20948 user bank 0 registers */
+
+/** @brief chip identification code */
+#define ICM209_REG_WHO_AM_I        ICM209_REG(0U, 0x00)
+
+#define ICM209_REG_USER_CTRL       ICM209_REG(0U, 0x03)
+#define ICM209_USER_CTRL_DMP_EN        (0x80)
+#define ICM209_USER_CTRL_FIFO_EN       (0x40)
+#define ICM209_USER_CTRL_I2C_MST_EN    (0x20)
+#define ICM209_USER_CTRL_DMP_RST       (0x08)
+#define ICM209_USER_CTRL_SRAM_RST      (0x04)
+#define ICM209_USER_CTRL_I2C_MST_RST   (0x02)
+
+#define ICM209_REG_LP_CONFIG       ICM209_REG(0U, 0x05)
+#define ICM209_LP_CONFIG_ALL_CYCLE     (0x70)
+
+#define ICM209_REG_PWR_MGMT_1      ICM209_REG(0U, 0x06)
+#define ICM209_PWR_MGMT_1_RESET        (0x80)
+#define ICM209_PWR_MGMT_1_CLKSEL_AUTO  (0x01)
+
+/** @brief Sensor disable bits, cleared bit means enabled */
+#define ICM209_REG_PWR_MGMT_2      ICM209_REG(0U, 0x07)
+#define ICM209_PWR_MGMT_2_ACCEL_OFF    (0x38)
+#define ICM209_PWR_MGMT_2_GYRO_OFF     (0x07)
+
+#define ICM209_REG_I2C_MST_STATUS  ICM209_REG(0U, 0x17)
+#define ICM209_I2C_MST_STATUS_SLV4_DONE (0x40)
+#define ICM209_I2C_MST_STATUS_SLV4_NACK (0x10)
+
+/** @brief One FIFO overflow bit per FIFO, cleared on read */
+#define ICM209_REG_INT_STATUS_2    ICM209_REG(0U, 0x1A)
+#define ICM209_INT_STATUS_2_FIFO_OVF   (0x1F)
+
+/** @brief External sensor data read by the I2C master slave 0 */
+#define ICM209_REG_EXT_SLV_SENS_DATA_00 ICM209_REG(0U, 0x3B)
+
+#define ICM209_REG_FIFO_EN_1       ICM209_REG(0U, 0x66)
+#define ICM209_FIFO_EN_1_SLV_0         (0x01)
+
+#define ICM209_REG_FIFO_EN_2       ICM209_REG(0U, 0x67)
+#define ICM209_FIFO_EN_2_ACCEL         (0x10)
+#define ICM209_FIFO_EN_2_GYRO_XYZ      (0x0E)
+
+#define ICM209_REG_FIFO_RST        ICM209_REG(0U, 0x68)
+#define ICM209_FIFO_RST_ALL            (0x1F)
+
+/** @brief 0 stream mode (oldest data is overwritten), 1 snapshot mode (new
+ * data is dropped when full, keeps the frame boundaries aligned)
+ */
+#define ICM209_REG_FIFO_MODE       ICM209_REG(0U, 0x69)
+#define ICM209_FIFO_MODE_SNAPSHOT      (0x1F)
+
+/** @brief 13Bit FIFO byte count, big endian
+ * @note data is split into 2 registers.
+ */
+#define ICM209_REG_FIFO_COUNT      ICM209_REG(0U, 0x70)
+#define ICM209_REG_FIFO_COUNT_LEN      (2U)
+
+/** @brief FIFO data port, burst reads do not increment the address */
+#define ICM209_REG_FIFO_R_W        ICM209_REG(0U, 0x72)
+
+/** @brief DMP memory access */
+#define ICM209_REG_MEM_START_ADDR  ICM209_REG(0U, 0x7C)
+#define ICM209_REG_MEM_R_W         ICM209_REG(0U, 0x7D)
+#define ICM209_REG_MEM_BANK_SEL    ICM209_REG(0U, 0x7E)
+
+/** @brief Bank selection register, mapped at the same address in all banks */
+#define ICM209_REG_BANK_SEL        (0x7F)
+#define ICM209_REG_BANK_SEL_POS        (0x04)
+
+/** @name ICM-20948 user bank 1 registers */
+
+/** @brief Factory trim of the internal clock, the DMP gyroscope scale depends on it */
+#define ICM209_REG_TIMEBASE_CORRECTION_PLL ICM209_REG(1U, 0x28)
+#define ICM209_PLL_SIGN                (0x80)
+#define ICM209_PLL_MSK                 (0x7F)
+
+/** @name ICM-20948 user bank 2 registers */
+
+#define ICM209_REG_GYRO_SMPLRT_DIV ICM209_REG(2U, 0x00)
+
+#define ICM209_REG_GYRO_CONFIG_1   ICM209_REG(2U, 0x01)
+#define ICM209_GYRO_CONFIG_1_FS_2000DPS (0x06)
+#define ICM209_GYRO_CONFIG_1_DLPF_EN    (0x01)
+
+/** @brief 12Bit accelerometer sample rate divider, big endian
+ * @note data is split into 2 registers.
+ */
+#define ICM209_REG_ACCEL_SMPLRT_DIV ICM209_REG(2U, 0x10)
+#define ICM209_REG_ACCEL_SMPLRT_DIV_LEN (2U)
+
+#define ICM209_REG_ACCEL_CONFIG    ICM209_REG(2U, 0x14)
+#define ICM209_ACCEL_CONFIG_FS_4G       (0x02)
+#define ICM209_ACCEL_CONFIG_DLPF_EN     (0x01)
+
+/** @brief 16Bit DMP program start address, big endian */
+#define ICM209_REG_PRGM_START_ADDR ICM209_REG(2U, 0x50)
+
+/** @name ICM-20948 user bank 3 registers */
+
+/** @brief I2C master duty cycled ODR = 1.1 kHz / 2^x */
+#define ICM209_REG_I2C_MST_ODR_CONFIG ICM209_REG(3U, 0x00)
+#define ICM209_I2C_MST_ODR_68_75_HZ    (0x04)
+
+#define ICM209_REG_I2C_MST_CTRL    ICM209_REG(3U, 0x01)
+#define ICM209_I2C_MST_CTRL_P_NSR      (0x10)
+#define ICM209_I2C_MST_CTRL_CLK_400KHZ (0x07)
+
+#define ICM209_REG_I2C_SLV0_ADDR   ICM209_REG(3U, 0x03)
+#define ICM209_REG_I2C_SLV0_REG    ICM209_REG(3U, 0x04)
+#define ICM209_REG_I2C_SLV0_CTRL   ICM209_REG(3U, 0x05)
+
+#define ICM209_REG_I2C_SLV4_ADDR   ICM209_REG(3U, 0x13)
+#define ICM209_REG_I2C_SLV4_REG    ICM209_REG(3U, 0x14)
+#define ICM209_REG_I2C_SLV4_CTRL   ICM209_REG(3U, 0x15)
+#define ICM209_REG_I2C_SLV4_DO     ICM209_REG(3U, 0x16)
+#define ICM209_REG_I2C_SLV4_DI     ICM209_REG(3U, 0x17)
+
+#define ICM209_I2C_SLV_ADDR_READ       (0x80)
+#define ICM209_I2C_SLV_CTRL_EN         (0x80)
+#define ICM209_I2C_SLV_CTRL_LEN_MSK    (0x0F)
+
+/** @name AK09916 magnetometer registers, accessed through the I2C master */
+
+#define AK09916_IIC_ADDR           (0x0C)
+
+/** @brief device identification code */
+#define AK09916_REG_WIA2           (0x01)
+#define AK09916_DEVICE_ID          (0x09)
+
+/** @brief Measurement data, HXL to ST2. ST2 shall be read to release the
+ * data registers.
+ */
+#define AK09916_REG_HXL            (0x11)
+#define AK09916_REG_DATA_LEN           (8U)
+#define AK09916_ST2_HOFL               (0x08)
+
+#define AK09916_REG_CNTL2          (0x31)
+#define AK09916_MODE_CONT_10HZ         (0x02)
+#define AK09916_MODE_CONT_20HZ         (0x04)
+#define AK09916_MODE_CONT_50HZ         (0x06)
+#define AK09916_MODE_CONT_100HZ        (0x08)
+
+#define AK09916_REG_CNTL3          (0x32)
+#define AK09916_CNTL3_SRST             (0x01)
+
+/** @name DMP memory map (InvenSense DMP3 image) */
+
+/** @brief DMP image is loaded at this address and started from ICM209_DMP_START */
+#define ICM209_DMP_LOAD_START      (0x0090U)
+#define ICM209_DMP_START           (0x1000U)
+#define ICM209_DMP_MEM_BANK_SZ     (256U)
+#define ICM209_DMP_MEM_CHUNK_SZ    (16U)
+
+#define ICM209_DMP_DATA_OUT_CTL1   (4U * 16U)
+#define ICM209_DMP_DATA_OUT_CTL2   (4U * 16U + 2U)
+#define ICM209_DMP_DATA_INTR_CTL   (4U * 16U + 12U)
+#define ICM209_DMP_MOTION_EVENT_CTL (4U * 16U + 14U)
+#define ICM209_DMP_DATA_RDY_STATUS (8U * 16U + 10U)
+#define ICM209_DMP_ODR_QUAT9       (10U * 16U + 8U)
+#define ICM209_DMP_ODR_CPASS       (11U * 16U + 6U)
+#define ICM209_DMP_ODR_GYRO        (11U * 16U + 10U)
+#define ICM209_DMP_ODR_ACCEL       (11U * 16U + 14U)
+
+
+/** @brief Scale and mounting keys, 32Bit big endian. The matrices are 3x3 row
+ * major in Q30, the compass one maps the AK09916 to the accelerometer axes.
+ */
+#define ICM209_DMP_GYRO_SF         (19U * 16U)
+#define ICM209_DMP_CPASS_MTX       (23U * 16U)
+#define ICM209_DMP_ACC_SCALE       (30U * 16U)
+#define ICM209_DMP_GYRO_FULLSCALE  (72U * 16U + 12U)
+#define ICM209_DMP_ACC_SCALE2      (79U * 16U + 4U)
+#define ICM209_DMP_B2S_MTX         (208U * 16U)
+#define ICM209_DMP_MTX_LEN         (9U * 4U)
+
+/** @brief Key values for the +-4 g and +-2000 dps full scales */
+#define ICM209_DMP_ACC_SCALE_4G    (0x04000000UL) // 1 g is 2^25 inside the DMP
+#define ICM209_DMP_ACC_SCALE2_4G   (0x00040000UL) // Output in the hardware unit, 8192 LSB/g
+#define ICM209_DMP_GYRO_FS_2000DPS (0x10000000UL) // 2^28
+#define ICM209_DMP_MTX_ONE         (0x40000000L)
+/// AK09916 unit in Q30 as in the InvenSense reference, the DMP output stays 0.15 uT/LSB
+#define ICM209_DMP_CPASS_ONE       (0x09999999L)
+
+/** @brief GYRO_SF = magic * 2^level * (div + 1) / (1270 +- 15 * pll) / scale */
+#define ICM209_DMP_GYRO_SF_MAGIC   (264446880937391ULL)
+#define ICM209_DMP_GYRO_SF_SCALE   (100000ULL)
+#define ICM209_DMP_GYRO_SF_LEVEL   (4U)
+#define ICM209_DMP_GYRO_SF_BASE    (1270U)
+#define ICM209_DMP_GYRO_SF_PLL_STEP (15U)
+#define ICM209_DMP_GYRO_SF_MAX     (0x7FFFFFFFUL)
+
+/** @brief DMP base output rate, the ODR keys hold (base / rate - 1) */
+#define ICM209_DMP_BASE_RATE_HZ    (225U)
+
+/** @brief DATA_RDY_STATUS sensor bits */
+#define ICM209_DMP_RDY_GYRO        (0x0001U)
+#define ICM209_DMP_RDY_ACCEL       (0x0002U)
+#define ICM209_DMP_RDY_CPASS       (0x0008U)
+
+/** @brief DMP FIFO packet header bits, also used in DATA_OUT_CTL1 */
+#define ICM209_DMP_HDR_ACCEL       (0x8000U)
+#define ICM209_DMP_HDR_GYRO        (0x4000U)
+#define ICM209_DMP_HDR_CPASS       (0x2000U)
+#define ICM209_DMP_HDR_QUAT9       (0x0400U)
+#define ICM209_DMP_HDR_HEADER2     (0x0008U)
+
+/** @brief DMP FIFO packet field sizes */
+#define ICM209_DMP_HDR_LEN         (2U)
+#define ICM209_DMP_ACCEL_LEN       (6U)
+#define ICM209_DMP_GYRO_LEN        (12U) // raw data followed by the bias
+#define ICM209_DMP_CPASS_LEN       (6U)
+#define ICM209_DMP_QUAT9_LEN       (14U) // Q30 x, y, z followed by the accuracy
+#define ICM209_DMP_FOOTER_LEN      (2U)
+
+#endif // DD_ICM209_DEFS_H
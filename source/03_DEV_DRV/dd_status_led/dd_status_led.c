@@ -31,7 +31,7 @@ response_status_t dd_status_led_init(void)
 
     if (ret_val == RET_OK)
     {
-        ret_val  = ps_app_timer_create(&g_pt_g_led_timer, FALSE, led_cb);
+        ret_val  = ps_app_timer_create(&g_pt_g_led_timer, FALSE, led_cb, PS_EXEC_DEFERRED);
         ret_val |= ps_app_timer_start(g_pt_g_led_timer, 2000, APP_TIMER_UNIT_MS);
     }
 
@@ -1,155 +1,461 @@
 #include "ps_app_timer.h"
 
-#include "ha_input_capture/ha_input_capture.h"
 #include "ha_timer/ha_timer.h"
 #include "string.h"
+#include "su_trace/su_trace.h"
 
-#define SET_ACTIVE_TIMER_MASK(timer_type, timer_id) \
-    (g_active_timers_msk[timer_type] |= (1U << (timer_id)))
-#define CLEAR_ACTIVE_TIMER_MASK(timer_type, timer_id) \
-    (g_active_timers_msk[timer_type] &= ~(1U << (timer_id)))
+/// The free running counter of the timer driver counts at 1 MHz
+#define TICKS_PER_US (1ULL)
+#define TICKS_PER_MS (1000ULL * TICKS_PER_US)
+#define TICKS_PER_S  (1000ULL * TICKS_PER_MS)
 
-typedef struct
+/// The alarm compares with wrap-around, longer deadlines are reached in steps
+#define ALARM_MAX_DISTANCE (0x7FFFFFFFULL)
+
+/// Level n of the wheel has 64 slots of 64^n ticks, the wheel spans 2^30 ticks
+/// (~17.9 minutes), later deadlines are parked in the top level until in range
+#define WHEEL_LEVELS          (5U)
+#define WHEEL_SLOT_BITS       (6U)
+#define WHEEL_SLOTS           (1U << WHEEL_SLOT_BITS)
+#define WHEEL_SLOT_MASK       (WHEEL_SLOTS - 1U)
+#define WHEEL_LEVEL_SHIFT(lv) ((lv) * WHEEL_SLOT_BITS)
+#define WHEEL_RANGE           (1ULL << WHEEL_LEVEL_SHIFT(WHEEL_LEVELS))
+#define WHEEL_NO_DEADLINE     (UINT64_MAX)
+
+#define FREE_MSK_WORDS ((MAX_USER_TIMER + 31U) / 32U)
+
+/// A deferred callback carries the pool id and the generation of the timer it expired
+#define DEFERRED_ARG_GEN_SHIFT (16U)
+#define DEFERRED_ARG_ID_MSK    (0xFFFFU)
+
+_Static_assert(MAX_USER_TIMER <= (32U * 32U), "Timer pool exceeds the free slot bitmap");
+
+typedef struct st_app_timer
 {
     app_timer_handler_t  user_timer_handler;
-    uint32_t             period; // Timer period in ticks
-    volatile uint32_t    counter;
+    uint64_t             period;   // Timer period in ticks
+    uint64_t             deadline; // Absolute expiry time in ticks
     app_timer_callback_t callback; // User callback function
-    gp_timers_t          type;
+    struct st_app_timer* pt_next;  // Next timer in the same wheel slot
+    struct st_app_timer* pt_prev;  // Previous timer in the same wheel slot
     volatile bool_t      one_shot; // Timer type (oneshot or periodic)
-    int8_t               id; // Unique timer ID
+    bool_t               catch_up; // Fire missed periods instead of skipping them
+    ps_exec_ctx_t        exec_ctx; // Context the callback runs in
+    uint8_t              level;    // Wheel level of a running timer
+    uint8_t              slot;     // Wheel slot of a running timer
+    int16_t              id;       // Unique timer ID
+    uint16_t             gen;      // Bumped on delete, tells a reused pool entry apart
 } app_timer_t;
 
-static app_timer_t       g_app_timer[MAX_USER_TIMER]    = { 0 };
-static volatile uint32_t g_active_timers_msk[TIMER_CNT] = { 0 };
-bool_t g_is_initialized = FALSE;
-
-static response_status_t determine_timer_type_and_period(uint32_t         p_timer_period,
-                                                         app_timer_unit_t p_time_unit,
-                                                         uint32_t*        ppt_timer_counter,
-                                                         gp_timers_t*     ppt_determined_type)
+typedef struct
+{
+    app_timer_t* slots[WHEEL_SLOTS];
+    /// Earliest deadline per slot, it may be too early after a stop which only
+    /// costs one spurious alarm
+    uint64_t slot_min[WHEEL_SLOTS];
+    uint64_t occupied_msk; // Bit per non-empty slot
+} wheel_level_t;
+
+static app_timer_t   g_app_timer[MAX_USER_TIMER] = { 0 };
+static wheel_level_t g_wheel[WHEEL_LEVELS]       = { 0 };
+/// Time of the wheel, all slot visits up to this time are processed
+static uint64_t g_wheel_ticks = 0U;
+/// Free timers, one bit per pool entry and one bit per word with a free entry
+static uint32_t g_free_msk[FREE_MSK_WORDS] = { 0U };
+static uint32_t g_free_words_msk           = 0U;
+/// The 32Bit counter extended to 64Bit, updated on every read
+static uint64_t g_now_ticks      = 0U;
+bool_t          g_is_initialized = FALSE;
+
+static response_status_t determine_period(uint32_t         p_timer_period,
+                                          app_timer_unit_t p_time_unit,
+                                          uint64_t*        ppt_period_ticks)
 {
     response_status_t ret_val = RET_OK;
 
+    if ((p_timer_period == 0U) || (p_timer_period > MAX_TIMER_PERIOD))
+    {
+        return RET_PARAM_ERROR;
+    }
+
     switch (p_time_unit)
     {
         case APP_TIMER_UNIT_US:
-            if (p_timer_period % 10 == 0 && p_timer_period <= MAX_TIMER_PERIOD)
-            {
-                *ppt_determined_type = TIMER_10US;
-                *ppt_timer_counter   = p_timer_period / 10;
-            }
-            else
-            {
-                ret_val = RET_PARAM_ERROR; // Invalid period for microseconds
-            }
+            *ppt_period_ticks = p_timer_period * TICKS_PER_US;
             break;
         case APP_TIMER_UNIT_MS:
-            if (p_timer_period % 100 == 0 && p_timer_period <= MAX_TIMER_PERIOD)
-            {
-                *ppt_determined_type = TIMER_100MS;
-                *ppt_timer_counter   = p_timer_period / 100;
-            }
-            else if (p_timer_period % 10 == 0 && p_timer_period <= MAX_TIMER_PERIOD)
-            {
-                *ppt_determined_type = TIMER_10MS;
-                *ppt_timer_counter   = p_timer_period / 10;
-            }
-            else if (p_timer_period <= MAX_TIMER_PERIOD)
-            {
-                *ppt_determined_type = TIMER_1MS;
-                *ppt_timer_counter   = p_timer_period;
-            }
-            else
-            {
-                ret_val = RET_PARAM_ERROR;
-            }
+            *ppt_period_ticks = p_timer_period * TICKS_PER_MS;
             break;
         case APP_TIMER_UNIT_S:
-            if ((p_timer_period * 10) <= MAX_TIMER_PERIOD)
-            {
-                *ppt_determined_type = TIMER_100MS;
-                *ppt_timer_counter   = p_timer_period * 10;
-            }
-            else
-            {
-                ret_val = RET_PARAM_ERROR;
-            }
+            *ppt_period_ticks = p_timer_period * TICKS_PER_S;
             break;
         case APP_TIMER_UNIT_MIN:
-            if ((p_timer_period * (10 * 60)) <= MAX_TIMER_PERIOD)
-            {
-                *ppt_determined_type = TIMER_100MS;
-                *ppt_timer_counter   = p_timer_period * (10 * 60);
-            }
-            else
-            {
-                ret_val = RET_PARAM_ERROR;
-            }
+            *ppt_period_ticks = p_timer_period * (60U * TICKS_PER_S);
+            break;
+        default:
+            ret_val = RET_PARAM_ERROR;
             break;
     }
+
     return ret_val;
 }
-static int8_t find_free_timer(void)
+
+static int16_t alloc_timer(void)
 {
-    for (int8_t i = 0; i < MAX_USER_TIMER; i++)
+    if (g_free_words_msk == 0U)
+    {
+        return -1; // No free timer found
+    }
+
+    uint8_t word = (uint8_t)__builtin_ctz(g_free_words_msk);
+    uint8_t bit  = (uint8_t)__builtin_ctz(g_free_msk[word]);
+
+    g_free_msk[word] &= ~(1UL << bit);
+    if (g_free_msk[word] == 0U)
     {
-        if (g_app_timer[i].id == -1)
+        g_free_words_msk &= ~(1UL << word);
+    }
+
+    return (int16_t)((word * 32U) + bit);
+}
+
+static void release_timer(int16_t p_id)
+{
+    uint8_t word = (uint8_t)(p_id / 32);
+
+    g_free_msk[word] |= (1UL << (p_id % 32));
+    g_free_words_msk |= (1UL << word);
+}
+
+/**
+ * @brief This internal function extends the hardware counter to 64Bit. The
+ * armed alarm is never further than `ALARM_MAX_DISTANCE` away, so the counter
+ * is read at least twice per wrap around while a timer is running.
+ */
+static uint64_t get_now_ticks(void)
+{
+    uint32_t counter = ha_timer_get_counter();
+
+    g_now_ticks += (uint32_t)(counter - (uint32_t)g_now_ticks);
+
+    return g_now_ticks;
+}
+
+static bool_t wheel_is_empty(void)
+{
+    for (uint8_t level = 0U; level < WHEEL_LEVELS; level++)
+    {
+        if (g_wheel[level].occupied_msk != 0U)
         {
-            return i;
+            return FALSE;
         }
     }
-    return -1; // No free timer found
+
+    return TRUE;
 }
 
-static void dispatch_user_timer(gp_timers_t p_timer_type)
+/**
+ * @brief This internal function links a timer into the wheel. The level is the
+ * one whose slot size matches the distance to the deadline, so the slot is
+ * visited in the slot size before the deadline at the earliest.
+ */
+static void wheel_insert(app_timer_t* ppt_timer)
 {
-    uint32_t active_mask = g_active_timers_msk[p_timer_type];
+    uint64_t       expiry   = ppt_timer->deadline;
+    uint64_t       distance = 0U;
+    uint8_t        level    = 0U;
+    wheel_level_t* pt_level = NULL;
 
-    while (active_mask != 0)
+    if (expiry > g_wheel_ticks)
     {
-        uint8_t      timer_id = __builtin_ctz(active_mask);
-        app_timer_t* pt_timer    = &g_app_timer[timer_id];
+        distance = expiry - g_wheel_ticks;
+    }
+    else
+    {
+        expiry = g_wheel_ticks; // A passed deadline goes into the slot being visited
+    }
+    if (distance >= WHEEL_RANGE)
+    {
+        distance = WHEEL_RANGE - 1U;
+        expiry   = g_wheel_ticks + distance;
+    }
+    if (distance != 0U)
+    {
+        level = (uint8_t)((63U - (uint8_t)__builtin_clzll(distance)) / WHEEL_SLOT_BITS);
+    }
 
-        pt_timer->counter++;
+    pt_level         = &g_wheel[level];
+    ppt_timer->level = level;
+    ppt_timer->slot  = (uint8_t)((expiry >> WHEEL_LEVEL_SHIFT(level)) & WHEEL_SLOT_MASK);
 
-        if (pt_timer->counter >= pt_timer->period)
+    ppt_timer->pt_prev = NULL;
+    ppt_timer->pt_next = pt_level->slots[ppt_timer->slot];
+    if (ppt_timer->pt_next != NULL)
+    {
+        ppt_timer->pt_next->pt_prev = ppt_timer;
+    }
+    pt_level->slots[ppt_timer->slot] = ppt_timer;
+
+    if ((pt_level->occupied_msk & (1ULL << ppt_timer->slot)) == 0U)
+    {
+        pt_level->occupied_msk             |= (1ULL << ppt_timer->slot);
+        pt_level->slot_min[ppt_timer->slot] = ppt_timer->deadline;
+    }
+    else if (ppt_timer->deadline < pt_level->slot_min[ppt_timer->slot])
+    {
+        pt_level->slot_min[ppt_timer->slot] = ppt_timer->deadline;
+    }
+}
+
+static void wheel_remove(app_timer_t* ppt_timer)
+{
+    wheel_level_t* pt_level = &g_wheel[ppt_timer->level];
+
+    if (ppt_timer->pt_prev != NULL)
+    {
+        ppt_timer->pt_prev->pt_next = ppt_timer->pt_next;
+    }
+    else
+    {
+        pt_level->slots[ppt_timer->slot] = ppt_timer->pt_next;
+    }
+    if (ppt_timer->pt_next != NULL)
+    {
+        ppt_timer->pt_next->pt_prev = ppt_timer->pt_prev;
+    }
+
+    if (pt_level->slots[ppt_timer->slot] == NULL)
+    {
+        pt_level->occupied_msk &= ~(1ULL << ppt_timer->slot);
+    }
+    ppt_timer->pt_next = NULL;
+    ppt_timer->pt_prev = NULL;
+}
+
+/**
+ * @brief This internal function finds the next non-empty slot of a level after
+ * the wheel time.
+ * @param[out] ppt_visit Time at which the slot is visited.
+ * @return The slot index, or `WHEEL_SLOTS` if the level is empty.
+ */
+static uint8_t wheel_next_slot(uint8_t p_level, uint64_t* ppt_visit)
+{
+    uint64_t occupied = g_wheel[p_level].occupied_msk;
+
+    if (occupied == 0U)
+    {
+        return WHEEL_SLOTS;
+    }
+
+    uint64_t granule = (g_wheel_ticks >> WHEEL_LEVEL_SHIFT(p_level)) + 1U;
+    uint8_t  first   = (uint8_t)(granule & WHEEL_SLOT_MASK);
+
+    // Rotate so that bit 0 is the slot of the next granule
+    if (first != 0U)
+    {
+        occupied = (occupied >> first) | (occupied << (WHEEL_SLOTS - first));
+    }
+    granule += (uint8_t)__builtin_ctzll(occupied);
+    *ppt_visit = granule << WHEEL_LEVEL_SHIFT(p_level);
+
+    return (uint8_t)(granule & WHEEL_SLOT_MASK);
+}
+
+static uint64_t wheel_next_visit(void)
+{
+    uint64_t next_visit = WHEEL_NO_DEADLINE;
+    uint64_t visit      = 0U;
+
+    for (uint8_t level = 0U; level < WHEEL_LEVELS; level++)
+    {
+        if ((wheel_next_slot(level, &visit) != WHEEL_SLOTS) && (visit < next_visit))
         {
-            
-            if (pt_timer->one_shot == TRUE)
-            {
-                ps_app_timer_stop(&pt_timer->user_timer_handler); // Stop the timer if it's one-shot
-            }
-            else
-            {
-                pt_timer->counter = 0; // Reset counter for periodic timers
-            }
-            
-            pt_timer->user_timer_handler.is_fired = TRUE;
-            
-            if (pt_timer->callback != NULL)
-            {
-                pt_timer->callback();
-            }
+            next_visit = visit;
         }
-        active_mask &= ~(1U << timer_id); // Clear the bit for this timer
     }
+
+    return next_visit;
 }
-static void timer_10us_cb(void)
+
+/**
+ * @brief This internal function gets the earliest deadline of the wheel. Only
+ * the next slot of each level is checked, later slots of a level cover later
+ * time ranges.
+ */
+static uint64_t wheel_next_deadline(void)
 {
-    dispatch_user_timer(TIMER_10US);
+    uint64_t next_deadline = WHEEL_NO_DEADLINE;
+    uint64_t visit         = 0U;
+
+    for (uint8_t level = 0U; level < WHEEL_LEVELS; level++)
+    {
+        uint8_t slot = wheel_next_slot(level, &visit);
+
+        if ((slot != WHEEL_SLOTS) && (g_wheel[level].slot_min[slot] < next_deadline))
+        {
+            next_deadline = g_wheel[level].slot_min[slot];
+        }
+    }
+
+    return next_deadline;
 }
-static void timer_1ms_cb(void)
+
+/**
+ * @brief This internal function runs the callback of an expired timer in the
+ * main context. A timer deleted in the meantime is skipped, also when its pool
+ * entry was taken again by a new timer.
+ * @param[in] p_arg Pool id and generation of the expired timer.
+ */
+static void run_deferred_callback(uint32_t p_arg)
 {
-    dispatch_user_timer(TIMER_1MS);
+    uint32_t     id       = p_arg & DEFERRED_ARG_ID_MSK;
+    uint16_t     gen      = (uint16_t)(p_arg >> DEFERRED_ARG_GEN_SHIFT);
+    app_timer_t* pt_timer = &g_app_timer[id];
+
+    if ((pt_timer->id == (int16_t)id) && (pt_timer->gen == gen) && (pt_timer->callback != NULL))
+    {
+        pt_timer->callback();
+    }
 }
-static void timer_10ms_cb(void)
+
+static void expire_timer(app_timer_t* ppt_timer, uint64_t p_now)
+{
+    if (ppt_timer->one_shot == TRUE)
+    {
+        ppt_timer->user_timer_handler.is_running = FALSE;
+    }
+    else
+    {
+        // Missed periods are skipped and counted, a catch-up timer fires the
+        // latest ones back to back so the callback runs once per period
+        uint64_t missed  = (p_now - ppt_timer->deadline) / ppt_timer->period;
+        uint64_t skipped = missed;
+
+        if (ppt_timer->catch_up == TRUE)
+        {
+            skipped = (missed > APP_TIMER_MAX_CATCH_UP) ? (missed - APP_TIMER_MAX_CATCH_UP) : 0U;
+        }
+        ppt_timer->user_timer_handler.missed_cnt += (uint32_t)skipped;
+        ppt_timer->deadline                      += ppt_timer->period * (skipped + 1U);
+        wheel_insert(ppt_timer);
+    }
+
+    ppt_timer->user_timer_handler.is_fired = TRUE;
+    SU_TRACE(SU_TRACE_TIMER_FIRE, ppt_timer->id);
+
+    if (ppt_timer->callback == NULL)
+    {
+        return;
+    }
+    if (ppt_timer->exec_ctx == PS_EXEC_DEFERRED)
+    {
+        // A full queue drops the call, it is counted in the deferred work stats
+        (void)ps_deferred_work_post(run_deferred_callback,
+                                    ((uint32_t)ppt_timer->gen << DEFERRED_ARG_GEN_SHIFT)
+                                      | (uint32_t)ppt_timer->id);
+    }
+    else
+    {
+        ppt_timer->callback();
+    }
+}
+
+/**
+ * @brief This internal function advances the wheel to a slot visit. The higher
+ * level slots due at this time are moved down, then the timers of the level 0
+ * slot expire.
+ */
+static void wheel_process_visit(uint64_t p_visit, uint64_t p_now)
+{
+    g_wheel_ticks = p_visit;
+
+    for (uint8_t level = WHEEL_LEVELS - 1U; level > 0U; level--)
+    {
+        uint8_t slot = (uint8_t)((p_visit >> WHEEL_LEVEL_SHIFT(level)) & WHEEL_SLOT_MASK);
+
+        if ((p_visit & ((1ULL << WHEEL_LEVEL_SHIFT(level)) - 1U)) != 0U)
+        {
+            continue; // not at a slot boundary of this level
+        }
+        while (g_wheel[level].slots[slot] != NULL)
+        {
+            app_timer_t* pt_timer = g_wheel[level].slots[slot];
+
+            wheel_remove(pt_timer);
+            wheel_insert(pt_timer);
+        }
+    }
+
+    // Pop one by one, the callbacks may stop other timers of the same slot
+    while (g_wheel[0].slots[p_visit & WHEEL_SLOT_MASK] != NULL)
+    {
+        app_timer_t* pt_timer = g_wheel[0].slots[p_visit & WHEEL_SLOT_MASK];
+
+        wheel_remove(pt_timer);
+        expire_timer(pt_timer, p_now);
+    }
+}
+
+/**
+ * @brief This internal function programs the alarm for the nearest deadline.
+ * The alarm interrupt shall be disabled by the caller, it stays disabled when
+ * no timer is running.
+ */
+static void arm_next_deadline(void)
+{
+    uint64_t next_deadline = wheel_next_deadline();
+
+    if (next_deadline != WHEEL_NO_DEADLINE)
+    {
+        uint64_t now      = get_now_ticks();
+        uint64_t distance = 0U;
+
+        if (next_deadline > now)
+        {
+            distance = next_deadline - now;
+        }
+        if (distance > ALARM_MAX_DISTANCE)
+        {
+            distance = ALARM_MAX_DISTANCE;
+        }
+
+        ha_timer_set_alarm((uint32_t)(now + distance));
+    }
+}
+
+/**
+ * @brief This internal function is the alarm callback. The wheel catches up
+ * with all slot visits up to now, moving timers down the levels is deferred
+ * to the alarm of the earliest deadline.
+ */
+static void process_expired(void)
 {
-    dispatch_user_timer(TIMER_10MS);
+    uint64_t now        = get_now_ticks();
+    uint64_t next_visit = wheel_next_visit();
+
+    while (next_visit <= now)
+    {
+        wheel_process_visit(next_visit, now);
+        now        = get_now_ticks();
+        next_visit = wheel_next_visit();
+    }
+    // No slot is visited in between, the wheel can move on to now
+    g_wheel_ticks = now;
+
+    arm_next_deadline();
 }
-static void timer_100ms_cb(void)
+
+static void wheel_start_timer(app_timer_t* ppt_timer, uint64_t p_period)
 {
-    dispatch_user_timer(TIMER_100MS);
+    uint64_t now = get_now_ticks();
+
+    if (wheel_is_empty() == TRUE)
+    {
+        g_wheel_ticks = now;
+    }
+
+    ppt_timer->deadline = now + p_period;
+    wheel_insert(ppt_timer);
 }
 
 response_status_t ps_app_timer_init(void)
@@ -160,6 +466,10 @@ response_status_t ps_app_timer_init(void)
         return RET_OK; // Already initialized
     }
     memset(g_app_timer, 0, sizeof(g_app_timer));
+    memset(g_wheel, 0, sizeof(g_wheel));
+    ps_deferred_work_init();
+    memset(g_free_msk, 0, sizeof(g_free_msk));
+    g_free_words_msk = 0U;
 
     // Initialize the timer driver
     ret_val = ha_timer_init();
@@ -169,14 +479,12 @@ response_status_t ps_app_timer_init(void)
         {
             g_app_timer[i].user_timer_handler.is_running = FALSE;
             g_app_timer[i].user_timer_handler.is_fired   = FALSE;
-            g_app_timer[i].id                      = -1; // Mark as unused
-            g_app_timer[i].period                  = 0;
-            g_app_timer[i].counter                 = 0;
+            g_app_timer[i].id                            = -1; // Mark as unused
+            release_timer((int16_t)i);
         }
-        ret_val  = ha_timer_register_callback(TIMER_10US, timer_10us_cb);
-        ret_val |= ha_timer_register_callback(TIMER_1MS, timer_1ms_cb);
-        ret_val |= ha_timer_register_callback(TIMER_10MS, timer_10ms_cb);
-        ret_val |= ha_timer_register_callback(TIMER_100MS, timer_100ms_cb);
+        g_now_ticks   = ha_timer_get_counter();
+        g_wheel_ticks = g_now_ticks;
+        ret_val       = ha_timer_register_alarm_callback(process_expired);
         if (ret_val == RET_OK)
         {
             g_is_initialized = TRUE; // Mark as initialized
@@ -186,26 +494,36 @@ response_status_t ps_app_timer_init(void)
     return ret_val;
 }
 
+/**
+ * @brief This function takes a timer from the pool.
+ * @param[in] p_exec_ctx `PS_EXEC_ISR` runs the callback in the timer interrupt,
+ * `PS_EXEC_DEFERRED` posts it to the main context.
+ */
 response_status_t ps_app_timer_create(app_timer_handler_t** ppt_timer_handler, bool_t p_oneshot_timer,
-                                      app_timer_callback_t ppt_callback)
+                                      app_timer_callback_t ppt_callback, ps_exec_ctx_t p_exec_ctx)
 {
     ASSERT_AND_RETURN(ppt_timer_handler == NULL, RET_PARAM_ERROR);
 
     response_status_t ret_val   = RET_OK;
-    app_timer_t*      pt_timer     = NULL;
-    int8_t            timer_idx = find_free_timer();
+    app_timer_t*      pt_timer  = NULL;
+    int16_t           timer_idx = alloc_timer();
     if (timer_idx != -1)
     {
         pt_timer                                = &g_app_timer[timer_idx];
         pt_timer->one_shot                      = p_oneshot_timer;
+        pt_timer->catch_up                      = FALSE;
         pt_timer->callback                      = ppt_callback;
-        pt_timer->id                      = timer_idx;
-        pt_timer->counter                 = 0;
-        pt_timer->period                  = 0;
+        pt_timer->exec_ctx                      = p_exec_ctx;
+        pt_timer->id                            = timer_idx;
+        pt_timer->period                        = 0;
+        pt_timer->deadline                      = 0;
+        pt_timer->pt_next                       = NULL;
+        pt_timer->pt_prev                       = NULL;
         pt_timer->user_timer_handler.is_running = FALSE;
         pt_timer->user_timer_handler.is_fired   = FALSE;
-        *ppt_timer_handler                     = &pt_timer->user_timer_handler;
-        ret_val                              = RET_OK;
+        pt_timer->user_timer_handler.missed_cnt = 0U;
+        *ppt_timer_handler                      = &pt_timer->user_timer_handler;
+        ret_val                                 = RET_OK;
     }
     else
     {
@@ -218,20 +536,29 @@ response_status_t ps_app_timer_create(app_timer_handler_t** ppt_timer_handler, b
 response_status_t ps_app_timer_delete(app_timer_handler_t* ppt_timer_handler)
 {
     ASSERT_AND_RETURN(ppt_timer_handler == NULL, RET_PARAM_ERROR);
-    response_status_t ret_val = RET_OK;
-    app_timer_t*      pt_timer   = (app_timer_t*)ppt_timer_handler;
+    response_status_t ret_val  = RET_OK;
+    app_timer_t*      pt_timer = (app_timer_t*)ppt_timer_handler;
 
     ret_val = ps_app_timer_stop(ppt_timer_handler);
 
     if (ret_val == RET_OK)
     {
+        uint16_t gen = pt_timer->gen;
+
+        release_timer(pt_timer->id);
         memset(pt_timer, 0, sizeof(app_timer_t)); // Reset the timer structure
-        pt_timer->id = -1;                  // Mark as unused
+        pt_timer->id  = -1;                       // Mark as unused
+        pt_timer->gen = gen + 1U;                 // Expiries still queued are stale
     }
 
     return ret_val;
 }
 
+/**
+ * @brief This function (re)starts a timer, it expires one period after now.
+ * @note The wheel is protected by masking the alarm, the function shall
+ * be called from the thread context or from a timer callback.
+ */
 response_status_t ps_app_timer_start(app_timer_handler_t* ppt_timer_handler, uint32_t p_timer_period,
                                      app_timer_unit_t p_time_unit)
 {
@@ -239,41 +566,28 @@ response_status_t ps_app_timer_start(app_timer_handler_t* ppt_timer_handler, uin
     ASSERT_AND_RETURN(p_timer_period > MAX_TIMER_PERIOD, RET_PARAM_ERROR);
     ASSERT_AND_RETURN(((app_timer_t*)ppt_timer_handler)->id == -1, RET_NOT_INITIALIZED);
 
-    response_status_t ret_val = RET_OK;
-    app_timer_t*      pt_timer   = (app_timer_t*)ppt_timer_handler;
-
-    // Find the timer type based on the time unit and period
-    gp_timers_t timer_type_to_use = TIMER_CNT;
-    uint32_t    period_to_use = 0;
+    app_timer_t* pt_timer      = (app_timer_t*)ppt_timer_handler;
+    uint64_t     period_to_use = 0;
 
-    if (determine_timer_type_and_period(p_timer_period,
-                                        p_time_unit,
-                                        &period_to_use,
-                                        &timer_type_to_use)
-        != RET_OK)
+    if (determine_period(p_timer_period, p_time_unit, &period_to_use) != RET_OK)
     {
-        ret_val = RET_PARAM_ERROR; // Invalid timer type
-    }
-    else
-    {
-        // If no active timer using this type, start the hardware timer
-        if (g_active_timers_msk[timer_type_to_use] == 0)
-        {
-            ret_val = ha_timer_start(timer_type_to_use);
-        }
+        return RET_PARAM_ERROR; // Invalid timer period
     }
 
-    if (ret_val == RET_OK)
+    ha_timer_cancel_alarm();
+
+    if (pt_timer->user_timer_handler.is_running == TRUE)
     {
-        pt_timer->type                    = timer_type_to_use;
-        pt_timer->period                  = period_to_use;
-        pt_timer->user_timer_handler.is_fired   = FALSE;
-        pt_timer->counter                 = 0;
-        SET_ACTIVE_TIMER_MASK(pt_timer->type, pt_timer->id);
-        pt_timer->user_timer_handler.is_running = TRUE;
+        wheel_remove(pt_timer);
     }
+    pt_timer->period                        = period_to_use;
+    pt_timer->user_timer_handler.is_fired   = FALSE;
+    pt_timer->user_timer_handler.is_running = TRUE;
+    wheel_start_timer(pt_timer, period_to_use);
 
-    return ret_val;
+    arm_next_deadline();
+
+    return RET_OK;
 }
 
 response_status_t ps_app_timer_stop(app_timer_handler_t* ppt_timer_handler)
@@ -281,49 +595,67 @@ response_status_t ps_app_timer_stop(app_timer_handler_t* ppt_timer_handler)
     ASSERT_AND_RETURN(ppt_timer_handler == NULL, RET_PARAM_ERROR);
     ASSERT_AND_RETURN(((app_timer_t*)ppt_timer_handler)->id == -1, RET_NOT_INITIALIZED);
 
-    response_status_t ret_val = RET_OK;
-    app_timer_t*      pt_timer   = (app_timer_t*)ppt_timer_handler;
-    
-    ppt_timer_handler->is_running = FALSE;
+    app_timer_t* pt_timer = (app_timer_t*)ppt_timer_handler;
 
-    CLEAR_ACTIVE_TIMER_MASK(pt_timer->type, pt_timer->id);
+    ha_timer_cancel_alarm();
 
-    // If no active timer using this type, stop the hardware timer
-    if (g_active_timers_msk[pt_timer->type] == 0)
+    if (ppt_timer_handler->is_running == TRUE)
     {
-        ret_val = ha_timer_stop(pt_timer->type);
+        wheel_remove(pt_timer);
     }
+    ppt_timer_handler->is_running = FALSE;
 
-    return ret_val;
+    arm_next_deadline();
+
+    return RET_OK;
 }
 
-response_status_t ps_app_timer_update_period(app_timer_handler_t* ppt_timer_handler, uint32_t p_new_period,
-                                                  app_timer_unit_t p_time_unit)
+/**
+ * @brief This function selects what a late periodic timer does with the
+ * periods it missed, e.g. when interrupts were masked for longer than a
+ * period. By default they are skipped and only counted in `missed_cnt`. With
+ * catch-up the callback runs once per missed period, up to
+ * `APP_TIMER_MAX_CATCH_UP` of them back to back, so a timer that counts ticks
+ * does not drift.
+ */
+response_status_t ps_app_timer_set_catch_up(app_timer_handler_t* ppt_timer_handler, bool_t p_catch_up)
 {
     ASSERT_AND_RETURN(ppt_timer_handler == NULL, RET_PARAM_ERROR);
     ASSERT_AND_RETURN(((app_timer_t*)ppt_timer_handler)->id == -1, RET_NOT_INITIALIZED);
 
-    response_status_t ret_val = RET_OK;
-    app_timer_t*      pt_timer   = (app_timer_t*)ppt_timer_handler;
+    ((app_timer_t*)ppt_timer_handler)->catch_up = p_catch_up;
 
-    // Find the timer type based on the time unit and period
-    gp_timers_t timer_type_to_use = TIMER_CNT;
-    uint32_t    period_to_use = 0;
+    return RET_OK;
+}
 
-    if (determine_timer_type_and_period(p_new_period,
-                                        p_time_unit,
-                                        &period_to_use,
-                                        &timer_type_to_use)
-        != RET_OK)
+/**
+ * @brief This function changes the period of a timer, a running timer expires
+ * one new period after now.
+ */
+response_status_t ps_app_timer_update_period(app_timer_handler_t* ppt_timer_handler, uint32_t p_new_period,
+                                             app_timer_unit_t p_time_unit)
+{
+    ASSERT_AND_RETURN(ppt_timer_handler == NULL, RET_PARAM_ERROR);
+    ASSERT_AND_RETURN(((app_timer_t*)ppt_timer_handler)->id == -1, RET_NOT_INITIALIZED);
+
+    app_timer_t* pt_timer      = (app_timer_t*)ppt_timer_handler;
+    uint64_t     period_to_use = 0;
+
+    if (determine_period(p_new_period, p_time_unit, &period_to_use) != RET_OK)
     {
-        ret_val = RET_PARAM_ERROR; // Invalid timer type
+        return RET_PARAM_ERROR; // Invalid timer period
     }
-    else
+
+    ha_timer_cancel_alarm();
+
+    pt_timer->period = period_to_use;
+    if (pt_timer->user_timer_handler.is_running == TRUE)
     {
-        pt_timer->type   = timer_type_to_use;
-        pt_timer->period = period_to_use;
-        pt_timer->counter = 0; // Reset counter on period update
+        wheel_remove(pt_timer);
+        wheel_start_timer(pt_timer, period_to_use);
     }
 
-    return ret_val;
-}
\ No newline at end of file
+    arm_next_deadline();
+
+    return RET_OK;
+}
@@ -1,10 +1,16 @@
 #ifndef PS_APP_TIMER_H
 #define PS_APP_TIMER_H
 
+#include "ps_deferred_work/ps_deferred_work.h"
 #include "su_common.h"
 
 #define MAX_TIMER_PERIOD (60000000U)
-#define MAX_USER_TIMER (10U)
+/// Size of the static timer pool, can be set by the build (up to 1024 timers)
+#ifndef MAX_USER_TIMER
+#define MAX_USER_TIMER (32U)
+#endif
+/// Periods a catch-up timer fires back to back at most, older ones are skipped
+#define APP_TIMER_MAX_CATCH_UP (8U)
 typedef void (*app_timer_callback_t)(void);
 
 typedef enum
@@ -19,15 +25,17 @@ typedef struct
 {
     bool_t          is_running; // Timer running state
     volatile bool_t is_fired;   // Timer fired state
+    uint32_t        missed_cnt; // Periods skipped because the timer was served late
 } app_timer_handler_t;
 
 response_status_t ps_app_timer_init(void);
 response_status_t ps_app_timer_create(app_timer_handler_t** ppt_timer_handler, bool_t p_oneshot_timer,
-                                      app_timer_callback_t ppt_callback);
+                                      app_timer_callback_t ppt_callback, ps_exec_ctx_t p_exec_ctx);
 response_status_t ps_app_timer_delete(app_timer_handler_t* ppt_timer_handler);
 response_status_t ps_app_timer_start(app_timer_handler_t* ppt_timer_handler, uint32_t p_timer_period,
                                      app_timer_unit_t p_time_unit);
 response_status_t ps_app_timer_stop(app_timer_handler_t* ppt_timer_handler);
+response_status_t ps_app_timer_set_catch_up(app_timer_handler_t* ppt_timer_handler, bool_t p_catch_up);
 response_status_t ps_app_timer_update_period(app_timer_handler_t* ppt_timer_handler,
                                              uint32_t p_new_period, app_timer_unit_t p_time_unit);
 #endif // PS_APP_TIMER_H
@@ -0,0 +1,155 @@
+#include "ps_deferred_work.h"
+
+#include "string.h"
+
+#define QUEUE_MASK (PS_DEFERRED_WORK_QUEUE_SZ - 1U)
+
+_Static_assert((PS_DEFERRED_WORK_QUEUE_SZ & QUEUE_MASK) == 0U,
+               "Deferred work queue size shall be a power of two");
+
+/**
+ * A cell is free for the producer that claimed position `pos` when its
+ * sequence equals `pos`, and holds a published item when its sequence equals
+ * `pos + 1`.
+ */
+typedef struct
+{
+    volatile uint32_t seq;
+    ps_work_fn_t      fn;
+    uint32_t          arg;
+} work_cell_t;
+
+/// Many producers (interrupts of any priority), one consumer (main context)
+static work_cell_t              g_queue[PS_DEFERRED_WORK_QUEUE_SZ];
+static volatile uint32_t        g_tail           = 0U; // next position to claim
+static uint32_t                 g_head           = 0U; // next position to run
+static ps_deferred_work_stats_t g_stats          = { 0U };
+static bool_t                   g_is_initialized = FALSE;
+
+void ps_deferred_work_init(void)
+{
+    if (g_is_initialized == TRUE)
+    {
+        return; // Already initialized
+    }
+
+    for (uint32_t i = 0U; i < PS_DEFERRED_WORK_QUEUE_SZ; i++)
+    {
+        g_queue[i].seq = i;
+        g_queue[i].fn  = NULL;
+        g_queue[i].arg = 0U;
+    }
+    g_tail = 0U;
+    g_head = 0U;
+    memset(&g_stats, 0U, sizeof(g_stats));
+
+    g_is_initialized = TRUE;
+}
+
+/**
+ * @brief This function queues a work item for the main context, it may be
+ * called from any interrupt. A position is claimed with a compare and swap, so
+ * an interrupt preempting another producer never waits for it.
+ * @param[in] ppt_fn Function to run in the main context.
+ * @param[in] p_arg Argument passed to the function.
+ * @return Result of the execution status.
+ * @retval `RET_NO_MEMORY` if the queue is full, the item is dropped.
+ */
+response_status_t ps_deferred_work_post(ps_work_fn_t ppt_fn, uint32_t p_arg)
+{
+    ASSERT_AND_RETURN(ppt_fn == NULL, RET_PARAM_ERROR);
+
+    uint32_t     pos     = __atomic_load_n(&g_tail, __ATOMIC_RELAXED);
+    work_cell_t* pt_cell = NULL;
+
+    for (;;)
+    {
+        pt_cell      = &g_queue[pos & QUEUE_MASK];
+        int32_t diff = (int32_t)(__atomic_load_n(&pt_cell->seq, __ATOMIC_ACQUIRE) - pos);
+
+        if (diff == 0)
+        {
+            if (__atomic_compare_exchange_n(&g_tail,
+                                            &pos,
+                                            pos + 1U,
+                                            FALSE,
+                                            __ATOMIC_RELAXED,
+                                            __ATOMIC_RELAXED))
+            {
+                break; // position claimed
+            }
+            // pos is reloaded by the failed exchange
+        }
+        else if (diff < 0)
+        {
+            __atomic_fetch_add(&g_stats.dropped_cnt, 1U, __ATOMIC_RELAXED);
+            return RET_NO_MEMORY;
+        }
+        else
+        {
+            pos = __atomic_load_n(&g_tail, __ATOMIC_RELAXED);
+        }
+    }
+
+    pt_cell->fn  = ppt_fn;
+    pt_cell->arg = p_arg;
+    __atomic_store_n(&pt_cell->seq, pos + 1U, __ATOMIC_RELEASE);
+    __atomic_fetch_add(&g_stats.posted_cnt, 1U, __ATOMIC_RELAXED);
+
+    return RET_OK;
+}
+
+/**
+ * @brief This function runs the work items pending at the call in the order
+ * they were posted, it shall be called from the main context only. Items
+ * posted meanwhile are left for the next call, so an item that posts itself
+ * again cannot starve the caller.
+ * @return Number of items run.
+ */
+uint32_t ps_deferred_work_process(void)
+{
+    uint32_t run_cnt = 0U;
+    uint32_t pending = __atomic_load_n(&g_tail, __ATOMIC_RELAXED) - g_head;
+
+    if (pending > g_stats.max_pending)
+    {
+        g_stats.max_pending = pending;
+    }
+
+    while (run_cnt < pending)
+    {
+        work_cell_t* pt_cell = &g_queue[g_head & QUEUE_MASK];
+
+        // A claimed but not yet published item stops the run, it is taken next time
+        if (__atomic_load_n(&pt_cell->seq, __ATOMIC_ACQUIRE) != (g_head + 1U))
+        {
+            break;
+        }
+
+        ps_work_fn_t fn  = pt_cell->fn;
+        uint32_t     arg = pt_cell->arg;
+
+        // Release the cell before running, the item may post again
+        __atomic_store_n(&pt_cell->seq, g_head + PS_DEFERRED_WORK_QUEUE_SZ, __ATOMIC_RELEASE);
+        g_head++;
+
+        fn(arg);
+        run_cnt++;
+    }
+
+    g_stats.run_cnt += run_cnt;
+
+    return run_cnt;
+}
+
+bool_t ps_deferred_work_is_pending(void)
+{
+    return (__atomic_load_n(&g_tail, __ATOMIC_RELAXED) != g_head) ? TRUE : FALSE;
+}
+
+void ps_deferred_work_get_stats(ps_deferred_work_stats_t* ppt_stats)
+{
+    ASSERT_AND_RETURN(ppt_stats == NULL, );
+
+    *ppt_stats = g_stats;
+}
@@ -0,0 +1,34 @@
+#ifndef PS_DEFERRED_WORK_H
+#define PS_DEFERRED_WORK_H
+
+#include "su_common.h"
+
+/// Number of work items that can be pending, shall be a power of two
+#ifndef PS_DEFERRED_WORK_QUEUE_SZ
+#define PS_DEFERRED_WORK_QUEUE_SZ (32U)
+#endif
+
+/// Context a registered callback is executed in
+typedef enum
+{
+    PS_EXEC_ISR = 0,  // directly in the interrupt that raised the event
+    PS_EXEC_DEFERRED, // in the main context by `ps_deferred_work_process`
+} ps_exec_ctx_t;
+
+typedef void (*ps_work_fn_t)(uint32_t p_arg);
+
+typedef struct
+{
+    uint32_t posted_cnt;
+    uint32_t run_cnt;
+    uint32_t dropped_cnt; // items posted while the queue was full
+    uint32_t max_pending; // highest queue depth seen by the dispatcher
+} ps_deferred_work_stats_t;
+
+void              ps_deferred_work_init(void);
+response_status_t ps_deferred_work_post(ps_work_fn_t ppt_fn, uint32_t p_arg);
+uint32_t          ps_deferred_work_process(void);
+bool_t            ps_deferred_work_is_pending(void);
+void              ps_deferred_work_get_stats(ps_deferred_work_stats_t* ppt_stats);
+
+#endif // PS_DEFERRED_WORK_H
@@ -1,34 +1,195 @@
 #include "ps_iic_bus_scanner.h"
 
 #include "ha_iic/ha_iic.h"
+#include "ha_timer/ha_timer.h"
 #include "ps_logger/ps_logger.h"
 #include "stdio.h"
 #include "string.h"
 
-#define IIC_TIMEOUT_MS (100U)
+/// A present device acknowledges within one address phase (~100 us at 100 kHz)
+#define IIC_PROBE_TIMEOUT_MS (1U)
 
-void ps_bus_scanner_init(void)
+#define IIC_ADDR_FIRST (0x08U) // 0x00 - 0x07 are reserved
+#define IIC_ADDR_LAST  (0x77U) // 0x78 - 0x7F are reserved
+#define IIC_MAP_SZ     (128U / 8U)
+#define IIC_MAP_MAGIC  (0x50414D49UL)
+
+#if !defined(TEST)
+/// Not cleared by the startup code, so the map survives a warm reset
+#define IIC_MAP_NOINIT __attribute__((section(".noinit")))
+#else
+#define IIC_MAP_NOINIT
+#endif
+
+typedef struct
 {
-    ha_iic_init();
+    uint32_t magic;
+    uint8_t  dev_map[IIC_MAP_SZ];
+    uint32_t checksum;
+} iic_map_cache_t;
+
+static iic_map_cache_t IIC_MAP_NOINIT g_map_cache;
+
+static uint8_t            g_dev_map[IIC_MAP_SZ] = { 0U };
+static ps_iic_scan_info_t g_scan_info           = { 0U };
+
+static inline bool_t map_get(const uint8_t* ppt_map, uint8_t p_addr)
+{
+    return ((ppt_map[p_addr >> 3U] & (1U << (p_addr & 0x07U))) != 0U) ? TRUE : FALSE;
+}
+
+static inline void map_set(uint8_t* ppt_map, uint8_t p_addr)
+{
+    ppt_map[p_addr >> 3U] |= (uint8_t)(1U << (p_addr & 0x07U));
+}
+
+static uint32_t calc_checksum(const iic_map_cache_t* ppt_cache)
+{
+    uint32_t checksum = ppt_cache->magic;
+
+    for (uint8_t i = 0U; i < IIC_MAP_SZ; i++)
+    {
+        checksum = (checksum << 5U) + checksum + ppt_cache->dev_map[i];
+    }
+
+    return checksum;
 }
 
-void ps_scan_iic_bus(void)
+static bool_t is_cache_valid(void)
 {
-    uint8_t dev_addr = 0x00;
-    LOG_INFO("Scanning I2C bus...\n");
+    return ((g_map_cache.magic == IIC_MAP_MAGIC)
+            && (g_map_cache.checksum == calc_checksum(&g_map_cache)))
+             ? TRUE
+             : FALSE;
+}
+
+static bool_t probe(uint8_t p_dev_addr)
+{
+    g_scan_info.probe_cnt++;
+    return (ha_iic_dev_probe(IIC_PORT1, p_dev_addr, IIC_PROBE_TIMEOUT_MS) == RET_OK) ? TRUE
+                                                                                      : FALSE;
+}
+
+/**
+ * @brief This internal function probes only the expected devices and checks
+ * them against the cached map.
+ * @return TRUE if all expected devices answered and the cached map is still
+ * valid, FALSE if a full scan is needed.
+ */
+static bool_t verify_cached_map(const ps_iic_expected_dev_t* ppt_devs, uint8_t p_dev_cnt)
+{
+    if (is_cache_valid() == FALSE)
+    {
+        return FALSE;
+    }
 
-    // NOLINTBEGIN
-    for (dev_addr = 0x00; dev_addr < 0x7F; dev_addr++)
+    for (uint8_t i = 0U; i < p_dev_cnt; i++)
     {
-        if ((dev_addr & 0x78) == 0 || (dev_addr & 0x78) == 0x78)
+        if ((map_get(g_map_cache.dev_map, ppt_devs[i].addr) == FALSE)
+            || (probe(ppt_devs[i].addr) == FALSE))
         {
-            continue; // Skip reserved addresses
+            return FALSE;
         }
-        // NOLINTEND
+    }
+
+    memcpy(g_dev_map, g_map_cache.dev_map, sizeof(g_dev_map));
+
+    return TRUE;
+}
 
-        if (ha_iic_dev_check(IIC_PORT1, dev_addr, IIC_TIMEOUT_MS) == RET_OK)
+static void full_scan(void)
+{
+    memset(g_dev_map, 0U, sizeof(g_dev_map));
+
+    for (uint8_t dev_addr = IIC_ADDR_FIRST; dev_addr <= IIC_ADDR_LAST; dev_addr++)
+    {
+        if (probe(dev_addr) == TRUE)
         {
+            map_set(g_dev_map, dev_addr);
             LOG_INFO_P1("I2C device found at address: 0x%x\n", dev_addr);
         }
     }
+
+    g_map_cache.magic = IIC_MAP_MAGIC;
+    memcpy(g_map_cache.dev_map, g_dev_map, sizeof(g_dev_map));
+    g_map_cache.checksum = calc_checksum(&g_map_cache);
+}
+
+void ps_bus_scanner_init(void)
+{
+    ha_iic_init();
+    ha_timer_init();
+}
+
+/**
+ * @brief This function builds the map of the devices on the I2C bus and
+ * checks it against the expected device table. A map cached by a previous
+ * boot is verified by probing only the expected addresses, the whole address
+ * range is scanned only when the cache is missing or outdated.
+ * @param[in] ppt_devs Expected devices, built by the application from the
+ * driver addresses.
+ * @param[in] p_dev_cnt Number of expected devices.
+ * @return Result of the execution status.
+ * @retval `RET_NOT_FOUND` if an expected device is missing.
+ */
+response_status_t ps_scan_iic_bus(const ps_iic_expected_dev_t* ppt_devs, uint8_t p_dev_cnt)
+{
+    ASSERT_AND_RETURN((ppt_devs == NULL) && (p_dev_cnt != 0U), RET_PARAM_ERROR);
+
+    response_status_t ret_val  = RET_OK;
+    uint32_t          start_us = ha_timer_get_cpu_time_us();
+
+    memset(&g_scan_info, 0U, sizeof(g_scan_info));
+
+    if (verify_cached_map(ppt_devs, p_dev_cnt) == FALSE)
+    {
+        LOG_INFO("Scanning I2C bus...\n");
+        g_scan_info.is_full_scan = TRUE;
+        full_scan();
+    }
+
+    for (uint8_t addr = IIC_ADDR_FIRST; addr <= IIC_ADDR_LAST; addr++)
+    {
+        g_scan_info.dev_cnt += (uint8_t)map_get(g_dev_map, addr);
+    }
+
+    for (uint8_t i = 0U; i < p_dev_cnt; i++)
+    {
+        if (map_get(g_dev_map, ppt_devs[i].addr) == FALSE)
+        {
+            LOG_ERR_P1("I2C device missing at address: 0x%x\n", ppt_devs[i].addr);
+            g_scan_info.missing_cnt++;
+            ret_val = RET_NOT_FOUND;
+        }
+    }
+
+    g_scan_info.duration_us = ha_timer_get_cpu_time_us() - start_us;
+    LOG_INFO_P2("I2C scan done, %d probes in %d us\n",
+                g_scan_info.probe_cnt,
+                g_scan_info.duration_us);
+
+    return ret_val;
+}
+
+bool_t ps_iic_bus_dev_is_present(uint8_t p_dev_addr)
+{
+    ASSERT_AND_RETURN(p_dev_addr > IIC_ADDR_LAST, FALSE);
+
+    return map_get(g_dev_map, p_dev_addr);
+}
+
+void ps_iic_bus_get_scan_info(ps_iic_scan_info_t* ppt_info)
+{
+    ASSERT_AND_RETURN(ppt_info == NULL, );
+
+    *ppt_info = g_scan_info;
+}
+
+/**
+ * @brief This function drops the cached map, the next scan probes the whole
+ * address range.
+ */
+void ps_iic_bus_invalidate_map(void)
+{
+    g_map_cache.magic = 0U;
 }
@@ -1,3 +1,29 @@
+#ifndef PS_IIC_BUS_SCANNER_H
+#define PS_IIC_BUS_SCANNER_H
 
-void ps_bus_scanner_init(void);
-void ps_scan_iic_bus(void);
+#include "su_common.h"
+
+/// A device the application cannot run without, at the address its driver uses
+typedef struct
+{
+    uint8_t     addr;
+    const char* name;
+} ps_iic_expected_dev_t;
+
+typedef struct
+{
+    /// TRUE if the whole address range was probed, FALSE if the cached map was verified
+    bool_t   is_full_scan;
+    uint8_t  probe_cnt;
+    uint8_t  dev_cnt;
+    uint8_t  missing_cnt;
+    uint32_t duration_us;
+} ps_iic_scan_info_t;
+
+void              ps_bus_scanner_init(void);
+response_status_t ps_scan_iic_bus(const ps_iic_expected_dev_t* ppt_devs, uint8_t p_dev_cnt);
+bool_t            ps_iic_bus_dev_is_present(uint8_t p_dev_addr);
+void              ps_iic_bus_get_scan_info(ps_iic_scan_info_t* ppt_info);
+void              ps_iic_bus_invalidate_map(void);
+
+#endif // PS_IIC_BUS_SCANNER_H
@@ -193,10 +193,12 @@ static void add_log_prefix(uint8_t p_lvl, const char* ppt_func_name, uint16_t* p
         "", DBG_LOG_COLOR_E, DBG_LOG_COLOR_W, DBG_LOG_COLOR_I, DBG_LOG_COLOR_P, DBG_LOG_COLOR_D
     };
 
-    /// Copy the log level prefix to the debug message
-    strlcpy(&g_debug_msg[*ppt_bytes_written], log_strings[p_lvl], LOGGER_MSG_MAX_LENGTH);
+    /// Copy the log level prefix to the debug message, strlcpy is missing on older host libcs
+    size_t prefix_len = strlen(log_strings[p_lvl]);
 
-    *ppt_bytes_written = strlen(log_strings[p_lvl]);
+    memcpy(&g_debug_msg[*ppt_bytes_written], log_strings[p_lvl], prefix_len + 1U);
+
+    *ppt_bytes_written = prefix_len;
 
     if (ppt_func_name != NULL)
     {
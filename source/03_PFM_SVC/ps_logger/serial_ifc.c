@@ -1,8 +1,16 @@
 #include "serial_ifc.h"
 
 #include "ha_uart/ha_uart.h"
+#include "ps_deferred_work/ps_deferred_work.h"
 #include "ps_logger.h"
 #include "su_ring_buffer/su_ring_buffer.h"
+#include "su_trace/su_trace.h"
+
+/// Context the next DMA transfer is started in after a TX event, the buffer
+/// bookkeeping is always done in the DMA interrupt
+#ifndef SERIAL_IFC_DMA_EXEC_CTX
+#define SERIAL_IFC_DMA_EXEC_CTX (PS_EXEC_DEFERRED)
+#endif
 
 static uint8_t g_log_buffer_data[LOGGER_MSG_MAX_LENGTH]; // Buffer for log data
 
@@ -29,20 +37,38 @@ static void dma_buffer_process(void)
     // uart_dma_tx_start_tick = HAL_GetTick();
 
     uint8_t* pt_ptr = (uint8_t*)su_rb_get_linear_block_read_address(&g_log_buffer);
+    SU_TRACE(SU_TRACE_DMA_START, g_uart_tx_dma_len);
     if (ha_uart_dma_transmit(UART_DBG_PORT, pt_ptr, g_uart_tx_dma_len) != RET_OK)
     {
         g_uart_tx_dma_busy = 0; // Failed to start DMA
     }
 }
 
+static void dma_restart_work(uint32_t p_arg)
+{
+    UNUSED(p_arg);
+    dma_buffer_process();
+}
+
+/* Start next DMA transfer in the context chosen by SERIAL_IFC_DMA_EXEC_CTX */
+static void dma_restart(void)
+{
+    if ((SERIAL_IFC_DMA_EXEC_CTX == PS_EXEC_ISR)
+        || (ps_deferred_work_post(dma_restart_work, 0U) != RET_OK))
+    {
+        dma_buffer_process();
+    }
+}
+
 static void dma_cb(uart_comm_port_t p_ifc_idx, uart_dma_event_t p_event)
 {
     switch (p_event)
     {
         case UART_DMA_EVT_TX_COMPLETE:
+            SU_TRACE(SU_TRACE_DMA_DONE, g_uart_tx_dma_len);
             su_rb_skip(&g_log_buffer, g_uart_tx_dma_len); // Mark sent data as read
             g_uart_tx_dma_busy = 0;
-            dma_buffer_process();
+            dma_restart();
             break;
         case UART_DMA_EVT_ABORT:
             // Handle TX abort event
@@ -52,7 +78,7 @@ static void dma_cb(uart_comm_port_t p_ifc_idx, uart_dma_event_t p_event)
         case UART_DMA_EVT_ERROR:
             // Handle TX error event
             g_uart_tx_dma_busy = 0;
-            dma_buffer_process();
+            dma_restart();
             break;
         default:
             break;
@@ -74,11 +100,18 @@ void serial_ifc_send(const uint8_t* ppt_data, size_t p_len)
     }
 }
 
+/* Free space in the buffer, a send of up to this many bytes is not dropped */
+size_t serial_ifc_get_free(void)
+{
+    return su_rb_get_free(&g_log_buffer);
+}
+
 response_status_t serial_ifc_init(void)
 {
 
     response_status_t ret = RET_OK;
 
+    ps_deferred_work_init();
     ret = ha_uart_init(); // Initialize UART for DMA
     if (ret == RET_OK)
     {
@@ -5,6 +5,7 @@
 #include "su_common.h"
 
 void              serial_ifc_send(const uint8_t* ppt_data, size_t p_len);
+size_t            serial_ifc_get_free(void);
 response_status_t serial_ifc_init(void);
 
 #endif // PS_LOGGER_SERIAL_IFC_H
@@ -0,0 +1,102 @@
+#include "ps_profiler.h"
+
+#include "ha_timer/ha_timer.h"
+#include "ps_logger/ps_logger.h"
+
+#if defined(PS_PROFILER_HOST_CLOCK)
+#include <time.h>
+
+/// Host builds count nanoseconds scaled to target cycles, the probes stay the same
+static uint32_t host_clock(void)
+{
+    struct timespec now;
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+
+    uint64_t ns = ((uint64_t)now.tv_sec * 1000000000ULL) + (uint64_t)now.tv_nsec;
+
+    return (uint32_t)((ns * PS_PROFILER_CYCLES_PER_US) / 1000U);
+}
+#define PROFILER_CLOCK host_clock
+#else
+#define PROFILER_CLOCK ha_timer_get_cycles
+#endif
+
+/// Start of the measurement window, the 32Bit cycle counter limits it to ~53 s
+static uint32_t g_window_start = 0U;
+
+/**
+ * @brief This function starts the probes on the core cycle counter.
+ */
+response_status_t ps_profiler_init(void)
+{
+    response_status_t ret_val = RET_OK;
+
+#if !defined(PS_PROFILER_HOST_CLOCK)
+    ret_val = ha_timer_init(); // Enables the cycle counter
+#endif
+    if (ret_val == RET_OK)
+    {
+        su_prof_init(PROFILER_CLOCK);
+        g_window_start = su_prof_now();
+    }
+
+    return ret_val;
+}
+
+/**
+ * @brief This function returns the CPU load of the current window, it is the
+ * share of the time the core was not sleeping in the idle probe.
+ */
+uint32_t ps_profiler_get_load_permille(void)
+{
+    su_prof_stats_t idle    = { 0U };
+    uint32_t        elapsed = su_prof_now() - g_window_start;
+
+    (void)su_prof_get_stats(SU_PROF_IDLE, &idle);
+    if ((elapsed == 0U) || (idle.total_cycles >= elapsed))
+    {
+        return 0U;
+    }
+
+    return 1000U - (uint32_t)((idle.total_cycles * 1000U) / elapsed);
+}
+
+/**
+ * @brief This function logs the CPU load and the statistics of every probe
+ * that was hit, then starts a new window.
+ */
+void ps_profiler_dump(void)
+{
+    uint32_t elapsed_us = (su_prof_now() - g_window_start) / PS_PROFILER_CYCLES_PER_US;
+
+    LOG_INFO_P2("Profile of %d ms, CPU load %d permille\n",
+                elapsed_us / 1000U,
+                ps_profiler_get_load_permille());
+
+    for (uint32_t i = 0U; i < SU_PROF_PROBE_CNT; i++)
+    {
+        su_prof_stats_t stats = { 0U };
+
+        (void)su_prof_get_stats((su_prof_probe_t)i, &stats);
+        if (stats.cnt == 0U)
+        {
+            continue;
+        }
+        ps_logger_send(DBG_LVL_INFO,
+                       su_prof_get_name((su_prof_probe_t)i),
+                       "%d runs, avg %d, max %d cycles\n",
+                       stats.cnt,
+                       (uint32_t)(stats.total_cycles / stats.cnt),
+                       stats.max_cycles);
+        ps_logger_send(DBG_LVL_INFO,
+                       su_prof_get_name((su_prof_probe_t)i),
+                       "min %d, p50 < %d, p99 < %d cycles\n",
+                       stats.min_cycles,
+                       su_prof_percentile(&stats, 50U),
+                       su_prof_percentile(&stats, 99U));
+    }
+
+    su_prof_reset();
+    g_window_start = su_prof_now();
+}
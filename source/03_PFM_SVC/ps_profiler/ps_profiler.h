@@ -0,0 +1,16 @@
+#ifndef PS_PROFILER_H
+#define PS_PROFILER_H
+
+#include "su_common.h"
+#include "su_profiler/su_profiler.h"
+
+/// Core clock the cycle counts are converted with
+#ifndef PS_PROFILER_CYCLES_PER_US
+#define PS_PROFILER_CYCLES_PER_US (80U)
+#endif
+
+response_status_t ps_profiler_init(void);
+uint32_t          ps_profiler_get_load_permille(void);
+void              ps_profiler_dump(void);
+
+#endif // PS_PROFILER_H
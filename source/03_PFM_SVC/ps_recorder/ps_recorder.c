@@ -0,0 +1,243 @@
+#include "ps_recorder.h"
+
+#include "ha_iic/ha_iic.h"
+#include "ha_input_capture/ha_input_capture.h"
+#include "ha_timer/ha_timer.h"
+#include "ps_logger/serial_ifc.h"
+#include "string.h"
+#include "su_ring_buffer/su_ring_buffer.h"
+
+/// "#R " + hex digits + '\n'
+#define RECORDER_LINE_MAX_LEN (3U + (PS_RECORDER_LINE_BYTES * 2U) + 1U)
+
+typedef enum
+{
+    RECORDER_IDLE = 0,
+    RECORDER_RUNNING,
+    RECORDER_STOPPING, // Unhooked, the rest of the stream is still sent
+} recorder_state_t;
+
+typedef struct
+{
+    uint32_t t_us;
+    uint32_t value;
+    uint8_t  channel;
+} recorder_capture_t;
+
+static recorder_state_t    g_state = RECORDER_IDLE;
+static bool_t              g_is_dumping;
+static su_rb_t             g_stream;
+static uint8_t             g_stream_data[PS_RECORDER_BUF_SZ];
+static uint32_t            g_last_us;
+static ps_recorder_stats_t g_stats;
+
+/// Single producer queue of the capture interrupt, the main context consumes it
+static recorder_capture_t g_captures[PS_RECORDER_CAPTURE_QUEUE_SZ];
+static volatile uint32_t  g_capture_head;
+static volatile uint32_t  g_capture_tail;
+static volatile uint32_t  g_capture_drop_cnt;
+
+/* Put a whole record in the stream or nothing, a partial record would break
+   every record after it */
+static void put_event(const su_rec_event_t* ppt_event)
+{
+    uint8_t rec[SU_REC_MAX_RECORD_LEN];
+    size_t  len = su_rec_encode(ppt_event, g_last_us, rec, sizeof(rec));
+
+    if ((len == 0U) || (su_rb_get_free(&g_stream) < len))
+    {
+        g_stats.drop_cnt++;
+        return;
+    }
+    (void)su_rb_write(&g_stream, rec, (su_rb_sz_t)len);
+    g_last_us = ppt_event->t_us;
+    g_stats.rec_cnt++;
+    g_stats.byte_cnt += (uint32_t)len;
+}
+
+/* Captures are older than anything the main context records now, moving them
+   first keeps the time steps of the stream positive */
+static void flush_captures(void)
+{
+    su_rec_event_t event = { .type = SU_REC_CAPTURE };
+
+    while (g_capture_tail != g_capture_head)
+    {
+        const recorder_capture_t* pt_cap =
+          &g_captures[g_capture_tail & (PS_RECORDER_CAPTURE_QUEUE_SZ - 1U)];
+
+        event.t_us            = pt_cap->t_us;
+        event.capture.channel = pt_cap->channel;
+        event.capture.value   = pt_cap->value;
+        put_event(&event);
+        g_capture_tail++;
+    }
+    if (g_capture_drop_cnt > 0U)
+    {
+        g_stats.drop_cnt += __atomic_exchange_n(&g_capture_drop_cnt, 0U, __ATOMIC_RELAXED);
+    }
+}
+
+static void record_iic(iic_comm_port_t p_port, uint8_t p_dev_addr, uint16_t p_mem_addr,
+                       uint8_t p_mem_size, const uint8_t* ppt_data, size_t p_len)
+{
+    su_rec_event_t event = { .type = SU_REC_IIC_READ, .t_us = ha_timer_get_counter() };
+
+    flush_captures();
+    if (p_len > SU_REC_MAX_DATA_LEN)
+    {
+        g_stats.drop_cnt++;
+        return;
+    }
+    event.iic.port     = (uint8_t)p_port;
+    event.iic.dev_addr = p_dev_addr;
+    event.iic.mem_size = p_mem_size;
+    event.iic.mem_addr = p_mem_addr;
+    event.iic.len      = (uint16_t)p_len;
+    event.iic.pt_data  = ppt_data;
+    put_event(&event);
+}
+
+static void record_capture(input_capture_channel_t p_channel, uint32_t p_value)
+{
+    uint32_t head = g_capture_head;
+
+    if ((head - g_capture_tail) >= PS_RECORDER_CAPTURE_QUEUE_SZ)
+    {
+        g_capture_drop_cnt++;
+        return;
+    }
+
+    recorder_capture_t* pt_cap = &g_captures[head & (PS_RECORDER_CAPTURE_QUEUE_SZ - 1U)];
+
+    pt_cap->t_us    = ha_timer_get_counter();
+    pt_cap->value   = p_value;
+    pt_cap->channel = (uint8_t)p_channel;
+    __atomic_store_n(&g_capture_head, head + 1U, __ATOMIC_RELEASE);
+}
+
+static size_t format_line(char* ppt_line, const uint8_t* ppt_data, size_t p_len)
+{
+    static const char hex[] = "0123456789abcdef";
+    size_t            len   = 0U;
+
+    ppt_line[len++] = '#';
+    ppt_line[len++] = 'R';
+    ppt_line[len++] = ' ';
+    for (size_t i = 0U; i < p_len; i++)
+    {
+        ppt_line[len++] = hex[ppt_data[i] >> 4U];
+        ppt_line[len++] = hex[ppt_data[i] & 0x0FU];
+    }
+    ppt_line[len++] = '\n';
+
+    return len;
+}
+
+/**
+ * @brief This function starts a recording of the raw sensor inputs: the bytes
+ * of every successful I2C read and every input capture value, each with its
+ * time on the free running counter. A running recording is restarted.
+ * @return Result of the execution status.
+ */
+response_status_t ps_recorder_start(void)
+{
+    uint8_t hdr[SU_REC_HDR_LEN];
+
+    ha_iic_register_record_hook(NULL);
+    ha_input_capture_register_record_hook(NULL);
+    if (su_rb_init(&g_stream, g_stream_data, sizeof(g_stream_data)) == 0U)
+    {
+        return RET_ERROR;
+    }
+    memset(&g_stats, 0, sizeof(g_stats));
+    g_capture_head     = 0U;
+    g_capture_tail     = 0U;
+    g_capture_drop_cnt = 0U;
+    g_is_dumping       = FALSE;
+    g_last_us          = ha_timer_get_counter();
+
+    /// The first record is timed from the start of the recording
+    g_stats.byte_cnt = (uint32_t)su_rec_write_header(hdr, sizeof(hdr));
+    (void)su_rb_write(&g_stream, hdr, g_stats.byte_cnt);
+
+    g_state = RECORDER_RUNNING;
+    ha_iic_register_record_hook(record_iic);
+    ha_input_capture_register_record_hook(record_capture);
+
+    return RET_OK;
+}
+
+/**
+ * @brief This function stops recording, the drains send the rest of the
+ * stream and close the dump.
+ */
+void ps_recorder_stop(void)
+{
+    if (g_state != RECORDER_RUNNING)
+    {
+        return;
+    }
+    ha_iic_register_record_hook(NULL);
+    ha_input_capture_register_record_hook(NULL);
+    flush_captures();
+    g_state = RECORDER_STOPPING;
+}
+
+/**
+ * @brief This function sends the recording over the debug UART as far as the
+ * serial buffer has room, it is meant to be called periodically. A dump is
+ * framed by a "#RS" and a "#RE" line, tools/record converts it to a binary
+ * recording for the host replay.
+ * @return Number of recording bytes sent.
+ */
+uint32_t ps_recorder_drain(void)
+{
+    char     line[RECORDER_LINE_MAX_LEN];
+    uint8_t  data[PS_RECORDER_LINE_BYTES];
+    uint32_t sent_cnt = 0U;
+
+    if (g_state == RECORDER_IDLE)
+    {
+        return 0U;
+    }
+    if (g_state == RECORDER_RUNNING)
+    {
+        flush_captures();
+    }
+
+    while (serial_ifc_get_free() >= RECORDER_LINE_MAX_LEN)
+    {
+        if (g_is_dumping == FALSE)
+        {
+            serial_ifc_send((const uint8_t*)"#RS\n", 4U);
+            g_is_dumping = TRUE;
+            continue;
+        }
+
+        su_rb_sz_t len = su_rb_read(&g_stream, data, sizeof(data));
+
+        if (len == 0U)
+        {
+            if (g_state == RECORDER_STOPPING)
+            {
+                serial_ifc_send((const uint8_t*)"#RE\n", 4U);
+                g_is_dumping = FALSE;
+                g_state      = RECORDER_IDLE;
+            }
+            break;
+        }
+        serial_ifc_send((const uint8_t*)line, format_line(line, data, len));
+        sent_cnt += len;
+    }
+
+    return sent_cnt;
+}
+
+void ps_recorder_get_stats(ps_recorder_stats_t* ppt_stats)
+{
+    ASSERT_AND_RETURN(ppt_stats == NULL, );
+
+    *ppt_stats           = g_stats;
+    ppt_stats->drop_cnt += g_capture_drop_cnt;
+}
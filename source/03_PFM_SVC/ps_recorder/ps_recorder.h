@@ -0,0 +1,28 @@
+#ifndef PS_RECORDER_H
+#define PS_RECORDER_H
+
+#include "su_common.h"
+#include "su_rec/su_rec.h"
+
+/// Bytes of the recording waiting for the debug UART
+#ifndef PS_RECORDER_BUF_SZ
+#define PS_RECORDER_BUF_SZ (4096U)
+#endif
+/// Captures waiting for the main context, shall be a power of two
+#define PS_RECORDER_CAPTURE_QUEUE_SZ (16U)
+/// Recording bytes per dump line, a line is "#R " and 2 hex digits per byte
+#define PS_RECORDER_LINE_BYTES       (32U)
+
+typedef struct
+{
+    uint32_t rec_cnt;  // Records put in the stream
+    uint32_t drop_cnt; // Records lost on a full buffer or queue
+    uint32_t byte_cnt; // Bytes of the stream, the header included
+} ps_recorder_stats_t;
+
+response_status_t ps_recorder_start(void);
+void              ps_recorder_stop(void);
+uint32_t          ps_recorder_drain(void);
+void              ps_recorder_get_stats(ps_recorder_stats_t* ppt_stats);
+
+#endif // PS_RECORDER_H
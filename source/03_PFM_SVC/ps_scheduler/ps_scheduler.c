@@ -0,0 +1,281 @@
+#include "ps_scheduler.h"
+
+#include "ha_timer/ha_timer.h"
+#include "ps_app_timer/ps_app_timer.h"
+#include "ps_deferred_work/ps_deferred_work.h"
+#include "string.h"
+#include "su_trace/su_trace.h"
+
+typedef struct
+{
+    ps_sched_task_handler_t user_task_handler;
+    ps_sched_task_fn_t      fn;
+    uint32_t                period_us;  // PS_SCHED_EVENT_TASK for triggered tasks
+    volatile uint32_t       release_us; // Counter value the next run is due at
+    volatile bool_t         is_pending; // Triggered and not yet run
+    uint8_t                 priority;   // 0 is the highest priority
+} sched_task_t;
+
+static sched_task_t         g_tasks[PS_SCHED_MAX_TASKS] = { 0 };
+static uint32_t             g_task_cnt                  = 0U;
+static ps_sched_stats_t     g_stats                     = { 0U };
+static app_timer_handler_t* g_pt_wake_timer             = NULL;
+static uint32_t             g_wake_at_us                = 0U;
+bool_t                      g_sched_is_initialized      = FALSE;
+
+static bool_t task_is_ready(const sched_task_t* ppt_task, uint32_t p_now)
+{
+    if (ppt_task->period_us == PS_SCHED_EVENT_TASK)
+    {
+        return __atomic_load_n(&ppt_task->is_pending, __ATOMIC_ACQUIRE);
+    }
+
+    return ((int32_t)(p_now - ppt_task->release_us) >= 0) ? TRUE : FALSE;
+}
+
+/// Highest priority ready task, tasks of the same priority run in creation order
+static sched_task_t* pick_ready_task(uint32_t p_now)
+{
+    sched_task_t* pt_best = NULL;
+
+    for (uint32_t i = 0U; i < g_task_cnt; i++)
+    {
+        if ((task_is_ready(&g_tasks[i], p_now) == TRUE)
+            && ((pt_best == NULL) || (g_tasks[i].priority < pt_best->priority)))
+        {
+            pt_best = &g_tasks[i];
+        }
+    }
+
+    return pt_best;
+}
+
+static void run_task(sched_task_t* ppt_task, uint32_t p_now)
+{
+    ps_sched_task_handler_t* pt_acc    = &ppt_task->user_task_handler;
+    uint32_t                 jitter_us = p_now - ppt_task->release_us;
+    uint32_t                 exec_us   = 0U;
+
+    if (ppt_task->period_us == PS_SCHED_EVENT_TASK)
+    {
+        // Cleared before the run, a trigger raised meanwhile runs the task again
+        __atomic_store_n(&ppt_task->is_pending, FALSE, __ATOMIC_RELEASE);
+    }
+    else
+    {
+        // Missed periods are skipped instead of running in a burst
+        uint32_t missed = jitter_us / ppt_task->period_us;
+
+        ppt_task->release_us += ppt_task->period_us * (missed + 1U);
+        pt_acc->missed_cnt   += missed;
+    }
+
+    SU_TRACE(SU_TRACE_TASK_START, ppt_task - g_tasks);
+    ppt_task->fn();
+    SU_TRACE(SU_TRACE_TASK_END, ppt_task - g_tasks);
+
+    exec_us                = ha_timer_get_counter() - p_now;
+    pt_acc->run_cnt       += 1U;
+    pt_acc->total_exec_us += exec_us;
+    if (exec_us > pt_acc->max_exec_us)
+    {
+        pt_acc->max_exec_us = exec_us;
+    }
+    if (jitter_us > pt_acc->max_jitter_us)
+    {
+        pt_acc->max_jitter_us = jitter_us;
+    }
+}
+
+/**
+ * @brief This internal function sleeps until the next periodic release or any
+ * other interrupt. The wake-up timer is only rearmed when the release changed.
+ */
+static void sched_idle(uint32_t p_now)
+{
+    bool_t   has_release = FALSE;
+    uint32_t wake_in_us  = UINT32_MAX;
+
+    for (uint32_t i = 0U; i < g_task_cnt; i++)
+    {
+        uint32_t due_in_us = g_tasks[i].release_us - p_now;
+
+        if ((g_tasks[i].period_us != PS_SCHED_EVENT_TASK) && (due_in_us < wake_in_us))
+        {
+            wake_in_us  = due_in_us;
+            has_release = TRUE;
+        }
+    }
+
+    if (has_release == FALSE)
+    {
+        (void)ps_app_timer_stop(g_pt_wake_timer);
+    }
+    else if ((g_pt_wake_timer->is_running == FALSE) || (g_wake_at_us != (p_now + wake_in_us)))
+    {
+        g_wake_at_us = p_now + wake_in_us;
+        (void)ps_app_timer_start(g_pt_wake_timer, wake_in_us, APP_TIMER_UNIT_US);
+    }
+
+    ha_timer_wait_for_interrupt();
+
+    g_stats.idle_us  += ha_timer_get_counter() - p_now;
+    g_stats.idle_cnt += 1U;
+}
+
+response_status_t ps_sched_init(void)
+{
+    response_status_t ret_val = RET_OK;
+
+    if (g_sched_is_initialized == TRUE)
+    {
+        return RET_OK; // Already initialized
+    }
+    memset(g_tasks, 0, sizeof(g_tasks));
+    memset(&g_stats, 0, sizeof(g_stats));
+    g_task_cnt = 0U;
+
+    ret_val = ps_app_timer_init();
+    if (ret_val == RET_OK)
+    {
+        // The timer only wakes the core, the scheduler loop does the rest
+        ret_val = ps_app_timer_create(&g_pt_wake_timer, TRUE, NULL, PS_EXEC_ISR);
+    }
+    if (ret_val == RET_OK)
+    {
+        g_sched_is_initialized = TRUE;
+    }
+
+    return ret_val;
+}
+
+/**
+ * @brief This function adds a task to the scheduler. A periodic task is first
+ * released at once, then every `p_period_us`.
+ * @param[in] ppt_name Name used in the statistics.
+ * @param[in] p_priority Priority of the task, 0 is the highest.
+ * @param[in] p_period_us Period of the task or `PS_SCHED_EVENT_TASK` for a task
+ * that runs on `ps_sched_task_trigger`.
+ * @return Result of the execution status.
+ * @retval `RET_NO_MEMORY` if all tasks are used.
+ */
+response_status_t ps_sched_task_create(ps_sched_task_handler_t** ppt_task, const char* ppt_name,
+                                       ps_sched_task_fn_t ppt_fn, uint8_t p_priority,
+                                       uint32_t p_period_us)
+{
+    ASSERT_AND_RETURN(g_sched_is_initialized != TRUE, RET_NOT_INITIALIZED);
+    ASSERT_AND_RETURN((ppt_task == NULL) || (ppt_fn == NULL), RET_PARAM_ERROR);
+    ASSERT_AND_RETURN(p_period_us > MAX_TIMER_PERIOD, RET_PARAM_ERROR);
+
+    if (g_task_cnt >= PS_SCHED_MAX_TASKS)
+    {
+        return RET_NO_MEMORY;
+    }
+
+    sched_task_t* pt_task = &g_tasks[g_task_cnt];
+
+    memset(pt_task, 0, sizeof(sched_task_t));
+    pt_task->user_task_handler.name = ppt_name;
+    pt_task->fn                     = ppt_fn;
+    pt_task->period_us              = p_period_us;
+    pt_task->release_us             = ha_timer_get_counter();
+    pt_task->is_pending             = FALSE;
+    pt_task->priority               = p_priority;
+    *ppt_task                       = &pt_task->user_task_handler;
+    g_task_cnt++;
+
+    return RET_OK;
+}
+
+/**
+ * @brief This function releases an event task, it may be called from any
+ * interrupt. Triggers raised before the task runs are merged into one run.
+ */
+response_status_t ps_sched_task_trigger(ps_sched_task_handler_t* ppt_task)
+{
+    ASSERT_AND_RETURN(ppt_task == NULL, RET_PARAM_ERROR);
+
+    sched_task_t* pt_task = (sched_task_t*)ppt_task;
+
+    ASSERT_AND_RETURN(pt_task->period_us != PS_SCHED_EVENT_TASK, RET_NOT_SUPPORTED);
+
+    if (__atomic_load_n(&pt_task->is_pending, __ATOMIC_ACQUIRE) == FALSE)
+    {
+        pt_task->release_us = ha_timer_get_counter();
+        __atomic_store_n(&pt_task->is_pending, TRUE, __ATOMIC_RELEASE);
+    }
+
+    return RET_OK;
+}
+
+/**
+ * @brief This function runs the deferred work or the highest priority ready
+ * task to completion, or sleeps when there is nothing to do.
+ * @return `TRUE` if something was run, `FALSE` if the core was sleeping.
+ */
+bool_t ps_sched_run_once(void)
+{
+    ASSERT_AND_RETURN(g_sched_is_initialized != TRUE, FALSE);
+
+    uint32_t      now     = ha_timer_get_counter();
+    sched_task_t* pt_task = NULL;
+
+    if (ps_deferred_work_is_pending() == TRUE)
+    {
+        (void)ps_deferred_work_process();
+        g_stats.busy_us += ha_timer_get_counter() - now;
+        return TRUE;
+    }
+
+    pt_task = pick_ready_task(now);
+    if (pt_task == NULL)
+    {
+        sched_idle(now);
+        return FALSE;
+    }
+
+    run_task(pt_task, now);
+    g_stats.busy_us += ha_timer_get_counter() - now;
+
+    return TRUE;
+}
+
+/**
+ * @brief This function runs the scheduler forever, it replaces the main loop.
+ */
+void ps_sched_run(void)
+{
+    ASSERT_AND_RETURN(g_sched_is_initialized != TRUE, );
+
+    for (;;)
+    {
+        (void)ps_sched_run_once();
+    }
+}
+
+void ps_sched_get_stats(ps_sched_stats_t* ppt_stats)
+{
+    ASSERT_AND_RETURN(ppt_stats == NULL, );
+
+    *ppt_stats = g_stats;
+}
+
+/**
+ * @brief This function restarts the measurement of the scheduler and of all
+ * tasks, e.g. at the start of a measurement window.
+ */
+void ps_sched_reset_stats(void)
+{
+    memset(&g_stats, 0, sizeof(g_stats));
+
+    for (uint32_t i = 0U; i < g_task_cnt; i++)
+    {
+        ps_sched_task_handler_t* pt_acc = &g_tasks[i].user_task_handler;
+
+        pt_acc->run_cnt       = 0U;
+        pt_acc->missed_cnt    = 0U;
+        pt_acc->max_exec_us   = 0U;
+        pt_acc->max_jitter_us = 0U;
+        pt_acc->total_exec_us = 0U;
+    }
+}
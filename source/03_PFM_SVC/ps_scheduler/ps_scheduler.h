@@ -0,0 +1,43 @@
+#ifndef PS_SCHEDULER_H
+#define PS_SCHEDULER_H
+
+#include "su_common.h"
+
+/// Number of tasks that can be created, can be set by the build
+#ifndef PS_SCHED_MAX_TASKS
+#define PS_SCHED_MAX_TASKS (8U)
+#endif
+/// Period of a task that only runs when it is triggered
+#define PS_SCHED_EVENT_TASK (0U)
+
+typedef void (*ps_sched_task_fn_t)(void);
+
+/// Public part of a task, the accounting is updated after every run
+typedef struct
+{
+    const char* name;
+    uint32_t    run_cnt;
+    uint32_t    missed_cnt;    // Periods skipped because the task started too late
+    uint32_t    max_exec_us;   // Longest run
+    uint32_t    max_jitter_us; // Longest delay from the release to the start of a run
+    uint64_t    total_exec_us; // CPU time of all runs
+} ps_sched_task_handler_t;
+
+typedef struct
+{
+    uint64_t busy_us;  // Time spent in tasks and deferred work
+    uint64_t idle_us;  // Time spent sleeping
+    uint32_t idle_cnt; // Number of times the core went to sleep
+} ps_sched_stats_t;
+
+response_status_t ps_sched_init(void);
+response_status_t ps_sched_task_create(ps_sched_task_handler_t** ppt_task, const char* ppt_name,
+                                       ps_sched_task_fn_t ppt_fn, uint8_t p_priority,
+                                       uint32_t p_period_us);
+response_status_t ps_sched_task_trigger(ps_sched_task_handler_t* ppt_task);
+bool_t            ps_sched_run_once(void);
+void              ps_sched_run(void);
+void              ps_sched_get_stats(ps_sched_stats_t* ppt_stats);
+void              ps_sched_reset_stats(void);
+
+#endif // PS_SCHEDULER_H
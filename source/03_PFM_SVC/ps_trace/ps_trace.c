@@ -0,0 +1,111 @@
+#include "ps_trace.h"
+
+#include "ha_timer/ha_timer.h"
+#include "ps_logger/serial_ifc.h"
+#include "ps_profiler/ps_profiler.h"
+#include "stdio.h"
+
+/// "#T " + hex digits + '\n', the header and the end line are shorter
+#define TRACE_LINE_MAX_LEN (3U + (PS_TRACE_LINE_RECS * sizeof(su_trace_rec_t) * 2U) + 1U)
+
+static bool_t g_is_dumping = FALSE;
+
+/* Hex encode the little endian image of the records as one dump line */
+static size_t format_line(char* ppt_line, const su_trace_rec_t* ppt_recs, uint32_t p_cnt)
+{
+    static const char hex[] = "0123456789abcdef";
+    const uint8_t*    pt_b  = (const uint8_t*)ppt_recs;
+    size_t            len   = 0U;
+
+    ppt_line[len++] = '#';
+    ppt_line[len++] = 'T';
+    ppt_line[len++] = ' ';
+    for (size_t i = 0U; i < (p_cnt * sizeof(su_trace_rec_t)); i++)
+    {
+        ppt_line[len++] = hex[pt_b[i] >> 4U];
+        ppt_line[len++] = hex[pt_b[i] & 0x0FU];
+    }
+    ppt_line[len++] = '\n';
+
+    return len;
+}
+
+/**
+ * @brief This function starts the trace recorder on the core cycle counter.
+ * A trace frozen before a warm reset, e.g. by the fault handler, is kept and
+ * sent by the next drains.
+ */
+response_status_t ps_trace_init(void)
+{
+    response_status_t ret_val = ha_timer_init(); // Enables the cycle counter
+
+    if (ret_val == RET_OK)
+    {
+        g_is_dumping = FALSE;
+        su_trace_init(ha_timer_get_cycles);
+    }
+
+    return ret_val;
+}
+
+/**
+ * @brief This function freezes the recorder, so the next drains send the
+ * last SU_TRACE_BUF_SZ events. The recording restarts once all are sent.
+ * @return Result of the execution status.
+ * @retval `RET_BUSY` if the previous snapshot is still being sent.
+ */
+response_status_t ps_trace_snapshot(void)
+{
+    if (su_trace_is_frozen() == TRUE)
+    {
+        return RET_BUSY;
+    }
+    su_trace_freeze();
+
+    return RET_OK;
+}
+
+/**
+ * @brief This function sends a frozen trace over the debug UART as far as the
+ * serial buffer has room, it is meant to be called periodically. A dump is
+ * framed by a "#TS <cycles per us>" and a "#TE" line, tools/trace converts it
+ * to the Chrome trace format.
+ * @return Number of records sent.
+ */
+uint32_t ps_trace_drain(void)
+{
+    char           line[TRACE_LINE_MAX_LEN];
+    su_trace_rec_t recs[PS_TRACE_LINE_RECS];
+    uint32_t       sent_cnt = 0U;
+
+    if (su_trace_is_frozen() == FALSE)
+    {
+        return 0U;
+    }
+
+    while (serial_ifc_get_free() >= TRACE_LINE_MAX_LEN)
+    {
+        if (g_is_dumping == FALSE)
+        {
+            int len = snprintf(line, sizeof(line), "#TS %u\n", (unsigned)PS_PROFILER_CYCLES_PER_US);
+
+            serial_ifc_send((const uint8_t*)line, (size_t)len);
+            g_is_dumping = TRUE;
+            continue;
+        }
+
+        uint32_t cnt = su_trace_read(recs, PS_TRACE_LINE_RECS);
+
+        if (cnt == 0U)
+        {
+            serial_ifc_send((const uint8_t*)"#TE\n", 4U);
+            g_is_dumping = FALSE;
+            su_trace_resume();
+            break;
+        }
+        serial_ifc_send((const uint8_t*)line, format_line(line, recs, cnt));
+        sent_cnt += cnt;
+    }
+
+    return sent_cnt;
+}
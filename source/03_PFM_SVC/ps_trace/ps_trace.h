@@ -0,0 +1,14 @@
+#ifndef PS_TRACE_H
+#define PS_TRACE_H
+
+#include "su_common.h"
+#include "su_trace/su_trace.h"
+
+/// Records per dump line, a line is "#T " and 16 hex digits per record
+#define PS_TRACE_LINE_RECS (4U)
+
+response_status_t ps_trace_init(void);
+response_status_t ps_trace_snapshot(void);
+uint32_t          ps_trace_drain(void);
+
+#endif // PS_TRACE_H
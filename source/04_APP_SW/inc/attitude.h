@@ -0,0 +1,14 @@
+#ifndef ATTITUDE_H
+#define ATTITUDE_H
+
+#include "su_ahrs/su_ahrs.h"
+#include "su_common.h"
+
+response_status_t attitude_init(void);
+response_status_t attitude_update(const float* ppt_acc, const float* ppt_gyro_dps,
+                                  const float* ppt_mag, uint32_t p_sample_cnt);
+response_status_t attitude_get_quat(float* ppt_quat);
+response_status_t attitude_get_euler(su_ahrs_euler_t* ppt_euler);
+response_status_t attitude_get_vertical_acc(const float* ppt_acc, float* ppt_acc_up);
+
+#endif // ATTITUDE_H
@@ -2,9 +2,12 @@
 #define BARO_H
 
 #include "dd_bmp388/dd_bmp388.h"
+#include "su_baro/su_baro.h"
 #include "su_common.h"
 
 response_status_t baro_get_data(float* ppt_pres_hndlr);
 response_status_t baro_init(void);
+response_status_t baro_update_altitude(float p_pres_pa, float p_acc_up);
+response_status_t baro_get_altitude(float* ppt_alt_m, float* ppt_vs_mps);
 
 #endif // BARO_H
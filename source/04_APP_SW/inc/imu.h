@@ -1,5 +1,10 @@
 #include "su_common.h"
 
+/// Output rate of the gyroscope, see imu_get_gyro_sample_cnt() for the samples of a read
+#define IMU_GYRO_RATE_HZ     (50U)
+/// The accelerometer is given in m/s2, 1 g is this
+#define IMU_STANDARD_GRAVITY (9.806F)
+
 typedef enum
 {
     IMU_ACC,
@@ -10,3 +15,5 @@ typedef enum
 
 response_status_t imu_init();
 response_status_t imu_get_data(float* ppt_acc, float* ppt_gyro, float* ppt_mag, float* ppt_quat);
+response_status_t imu_update_calibration(void);
+uint32_t          imu_get_gyro_sample_cnt(void);
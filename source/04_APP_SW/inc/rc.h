@@ -0,0 +1,11 @@
+#ifndef RC_H
+#define RC_H
+
+#include "dd_fsi6/dd_fsi6.h"
+#include "su_common.h"
+#include "su_rc/su_rc.h"
+
+response_status_t rc_init(void);
+response_status_t rc_get_stick(fsi6_inputs_t p_input, su_q15_t* ppt_value);
+
+#endif // RC_H
@@ -1,11 +1,19 @@
+#include "attitude.h"
 #include "baro.h"
+#include "dd_bmp388/dd_bmp388_defs.h"
 #include "dd_esp32/dd_esp32.h"
 #include "dd_fsi6/dd_fsi6.h"
+#include "dd_icm209/dd_icm209.h"
 #include "dd_status_led/dd_status_led.h"
 #include "imu.h"
-#include "ps_app_timer/ps_app_timer.h"
+#include "ps_deferred_work/ps_deferred_work.h"
 #include "ps_iic_bus_scanner/ps_iic_bus_scanner.h"
 #include "ps_logger/ps_logger.h"
+#include "ps_profiler/ps_profiler.h"
+#include "ps_recorder/ps_recorder.h"
+#include "ps_scheduler/ps_scheduler.h"
+#include "ps_trace/ps_trace.h"
+#include "rc.h"
 
 #include <math.h>
 #include <stdio.h>
@@ -21,21 +29,136 @@
         app_err_handler(); \
     }
 
-app_timer_handler_t* g_pt_g_esp32_msg_timer = NULL;
-
-int32_t map(int32_t p_au32_in, int32_t p_au32_i_nmin, int32_t p_au32_i_nmax, int32_t p_au32_ou_tmin,
-            int32_t p_au32_ou_tmax)
-{
-    return ((((p_au32_in - p_au32_i_nmin) * (p_au32_ou_tmax - p_au32_ou_tmin)) / (p_au32_i_nmax - p_au32_i_nmin))
-            + p_au32_ou_tmin);
-}
+#define IMU_TASK_PERIOD_US       (10000U)
+#define AHRS_TASK_PERIOD_US      (IMU_TASK_PERIOD_US)
+#define BARO_TASK_PERIOD_US      (20000U)
+#define TELEMETRY_TASK_PERIOD_US (50000U)
+#define MONITOR_TASK_PERIOD_US   (10000000U)
+#define TRACE_TASK_PERIOD_US     (20000U)
+/// TRUE to read the receiver on its iBUS serial output instead of the PWM outputs
+#define RC_USE_IBUS              (FALSE)
+/// TRUE to send the raw sensor inputs over the debug UART for the host replay
+#define APP_RECORD_SENSORS       (FALSE)
+#define APP_RAD_TO_DEG           (57.29578F)
+
+static dd_esp32_data_packet_t   g_data_msg    = { 0 };
+static float                    g_dmp_quat[4] = { 0.0F };
+static response_status_t        g_imu_status  = RET_BUSY;
+static response_status_t        g_baro_status = RET_BUSY;
+static ps_sched_task_handler_t* g_pt_imu_task;
+static ps_sched_task_handler_t* g_pt_ahrs_task;
+static ps_sched_task_handler_t* g_pt_baro_task;
+static ps_sched_task_handler_t* g_pt_telemetry_task;
+static ps_sched_task_handler_t* g_pt_monitor_task;
+static ps_sched_task_handler_t* g_pt_trace_task;
+
+/// Devices the application cannot run without, at the addresses their drivers use
+static const ps_iic_expected_dev_t g_iic_devs[] = {
+    { BMP388_IIC_ADDR_1, "BMP388" },
+    { ICM209_IIC_ADDR_1, "ICM-20948" },
+};
 
 void app_err_handler(void)
 {
     dd_status_led_error();
+    (void)ps_trace_snapshot(); // Events leading to the error
     while (1) {
-        ;
+        ps_deferred_work_process(); // keeps the deferred LED blinking
+        (void)ps_trace_drain();
+}
+}
+
+static void imu_task(void)
+{
+    g_imu_status = imu_get_data(&g_data_msg.acc[0].f,
+                                &g_data_msg.gyro[0].f,
+                                &g_data_msg.mag[0].f,
+                                g_dmp_quat);
+}
+
+/* Runs right after the IMU task, one filter step covers the gyro samples of
+   the read. The telemetry carries this attitude in the body frame instead of
+   the DMP one */
+static void ahrs_task(void)
+{
+    if (g_imu_status != RET_OK)
+    {
+        return;
+    }
+    (void)attitude_update(&g_data_msg.acc[0].f,
+                          &g_data_msg.gyro[0].f,
+                          &g_data_msg.mag[0].f,
+                          imu_get_gyro_sample_cnt());
+    (void)attitude_get_quat(&g_data_msg.quat[0].f);
+}
+
+/* Runs after the attitude of the same period, so the vertical acceleration of
+   the last IMU sample goes with the new pressure into the altitude filter */
+static void baro_task(void)
+{
+    float acc_up = 0.0F;
+
+    g_baro_status = baro_get_data(&g_data_msg.baro.f);
+    if (g_baro_status != RET_OK)
+    {
+        return;
+    }
+    if (g_imu_status == RET_OK)
+    {
+        (void)attitude_get_vertical_acc(&g_data_msg.acc[0].f, &acc_up);
+    }
+    (void)baro_update_altitude(g_data_msg.baro.f, acc_up);
+}
+
+static void telemetry_task(void)
+{
+    // Never waits for the receiver, a lost link reads neutral on both sticks
+    (void)rc_get_stick(FSI6_IN_L_S_UD, &g_data_msg.throttle_stick);
+    (void)rc_get_stick(FSI6_IN_R_S_LR, &g_data_msg.steering_stick);
+
+    if ((g_imu_status | g_baro_status) == RET_OK)
+    {
+        LOG_INFO("DATA OK\n");
+        if (dd_esp32_send_data_packet(&g_data_msg) != RET_OK)
+        {
+            LOG_ERR("Error sending data packet to ESP32\n");
+        }
+    }
 }
+
+/* Report the CPU load and the probe statistics of the last window, push the
+   IMU calibration refined meanwhile, then send a trace of the last events */
+static void monitor_task(void)
+{
+    ps_sched_stats_t stats  = { 0U };
+    su_ahrs_euler_t  euler  = { 0.0F, 0.0F, 0.0F };
+    float            alt_m  = 0.0F;
+    float            vs_mps = 0.0F;
+
+    ps_profiler_dump();
+    ps_sched_get_stats(&stats);
+    LOG_INFO_P1("Scheduler slept %d times\n", stats.idle_cnt);
+    ps_sched_reset_stats();
+    (void)attitude_get_euler(&euler);
+    LOG_INFO_P3("Attitude roll %d pitch %d yaw %d deg\n",
+                (int32_t)(euler.roll * APP_RAD_TO_DEG),
+                (int32_t)(euler.pitch * APP_RAD_TO_DEG),
+                (int32_t)(euler.yaw * APP_RAD_TO_DEG));
+    (void)baro_get_altitude(&alt_m, &vs_mps);
+    LOG_INFO_P2("Altitude %d cm, climb %d cm/s\n",
+                (int32_t)(alt_m * 100.0F),
+                (int32_t)(vs_mps * 100.0F));
+    if (imu_update_calibration() == RET_OK)
+    {
+        LOG_INFO("IMU calibration updated\n");
+    }
+    (void)ps_trace_snapshot();
+}
+
+static void trace_task(void)
+{
+    (void)ps_trace_drain();
+    (void)ps_recorder_drain();
 }
 
 int app(void)
@@ -45,12 +168,27 @@ int app(void)
     ret_val = ps_logger_init();
     CHECK_APP_ERR(ret_val);
 
+    ret_val = ps_profiler_init();
+    CHECK_APP_ERR_LOG(ret_val, "Error initializing the profiler\n");
+
+    ret_val = ps_trace_init();
+    CHECK_APP_ERR_LOG(ret_val, "Error initializing the trace recorder\n");
+
+    // Before the sensors, the replay needs their identification and calibration reads
+    if (APP_RECORD_SENSORS == TRUE)
+    {
+        ret_val = ps_recorder_start();
+        CHECK_APP_ERR_LOG(ret_val, "Error starting the sensor recording\n");
+    }
+
     ps_bus_scanner_init();
-    ps_scan_iic_bus();
-    ps_app_timer_init();
+    if (ps_scan_iic_bus(g_iic_devs, ARRAY_SIZE(g_iic_devs)) != RET_OK)
+    {
+        LOG_WARN("Expected I2C devices are missing\n");
+    }
 
-    ret_val = ps_app_timer_create(&g_pt_g_esp32_msg_timer, TRUE, NULL);
-    CHECK_APP_ERR_LOG(ret_val, "Error creating ESP32 message timer\n");
+    ret_val = ps_sched_init();
+    CHECK_APP_ERR_LOG(ret_val, "Error initializing the scheduler\n");
 
     ret_val = dd_status_led_init();
     CHECK_APP_ERR_LOG(ret_val, "Error initializing Status LED\n");
@@ -58,45 +196,40 @@ int app(void)
     ret_val = dd_esp32_init();
     CHECK_APP_ERR_LOG(ret_val, "Error initializing ESP32\n");
 
-    ret_val = dd_fsi6_init(TRUE);
+    ret_val = (RC_USE_IBUS == TRUE) ? dd_fsi6_init_ibus() : dd_fsi6_init(TRUE);
     CHECK_APP_ERR_LOG(ret_val, "Error initializing FSI6\n");
 
+    ret_val = rc_init();
+    CHECK_APP_ERR_LOG(ret_val, "Error initializing the RC calibration\n");
+
     ret_val = imu_init();
     CHECK_APP_ERR_LOG(ret_val, "Error initializing IMU\n");
 
+    ret_val = attitude_init();
+    CHECK_APP_ERR_LOG(ret_val, "Error initializing the attitude filter\n");
+
     ret_val = baro_init();
     CHECK_APP_ERR_LOG(ret_val, "Error initializing Baro\n");
 
-    dd_esp32_data_packet_t data_msg = { 0 };
-    bool_t                 send_msg = FALSE;
+    // The sensors run first, the telemetry sends what they produced
+    ret_val  = ps_sched_task_create(&g_pt_imu_task, "imu", imu_task, 0U, IMU_TASK_PERIOD_US);
+    ret_val |= ps_sched_task_create(&g_pt_ahrs_task, "ahrs", ahrs_task, 1U, AHRS_TASK_PERIOD_US);
+    ret_val |= ps_sched_task_create(&g_pt_baro_task, "baro", baro_task, 2U, BARO_TASK_PERIOD_US);
+    ret_val |= ps_sched_task_create(&g_pt_telemetry_task,
+                                    "telemetry",
+                                    telemetry_task,
+                                    3U,
+                                    TELEMETRY_TASK_PERIOD_US);
+    ret_val |= ps_sched_task_create(&g_pt_monitor_task,
+                                    "monitor",
+                                    monitor_task,
+                                    4U,
+                                    MONITOR_TASK_PERIOD_US);
+    ret_val |= ps_sched_task_create(&g_pt_trace_task, "trace", trace_task, 5U, TRACE_TASK_PERIOD_US);
+    CHECK_APP_ERR_LOG(ret_val, "Error creating the application tasks\n");
 
-    ps_app_timer_start(g_pt_g_esp32_msg_timer, 50, APP_TIMER_UNIT_MS);
     dd_status_led_normal();
-    while (1)
-    {
-        ret_val  = imu_get_data(&data_msg.acc[0].f,
-                               &data_msg.gyro[0].f,
-                               &data_msg.mag[0].f,
-                               &data_msg.quat[0].f);
-        ret_val |= baro_get_data(&data_msg.baro.f);
-
-        dd_fsi6_get_data(FSI6_IN_L_S_UD, &data_msg.throttle_stick);
-        dd_fsi6_get_data(FSI6_IN_R_S_LR, &data_msg.steering_stick);
-
-        if (ret_val == RET_OK && g_pt_g_esp32_msg_timer->is_fired == TRUE)
-        {
-            g_pt_g_esp32_msg_timer->is_fired = FALSE;
-            LOG_INFO("DATA OK\n");
-            ret_val = dd_esp32_send_data_packet(&data_msg);
-            if (ret_val != RET_OK)
-            {
-                LOG_ERR("Error sending data packet to ESP32\n");
-            }
-            ps_app_timer_start(g_pt_g_esp32_msg_timer,
-                               50,
-                               APP_TIMER_UNIT_MS); // Restart timer for next message
-        }
-    }
+    ps_sched_run();
 
     return 0;
 }
@@ -0,0 +1,77 @@
+#include "attitude.h"
+
+#include "imu.h"
+
+#include "string.h"
+
+#define ATTITUDE_DEG_TO_RAD (0.017453292F)
+/// Period of one gyro sample, a step covers all samples since the previous one
+#define ATTITUDE_SAMPLE_S   (1.0F / (float)IMU_GYRO_RATE_HZ)
+
+static su_ahrs_t g_ahrs;
+
+response_status_t attitude_init(void)
+{
+    su_ahrs_init(&g_ahrs, NULL);
+
+    return RET_OK;
+}
+
+/**
+ * @brief This function feeds one calibrated body frame sample to the filter.
+ * @param[in] ppt_gyro_dps Angular rate in dps as read from the IMU.
+ * @param[in] ppt_mag Magnetic field, NULL to correct only roll and pitch.
+ * @param[in] p_sample_cnt Gyro samples the rate is the mean of, the step
+ * integrates over their periods.
+ */
+response_status_t attitude_update(const float* ppt_acc, const float* ppt_gyro_dps,
+                                  const float* ppt_mag, uint32_t p_sample_cnt)
+{
+    ASSERT_AND_RETURN((ppt_acc == NULL) || (ppt_gyro_dps == NULL), RET_PARAM_ERROR);
+
+    if (p_sample_cnt == 0U)
+    {
+        return RET_OK; // No time passed on the gyro clock
+    }
+
+    const float gyro[3] = { ppt_gyro_dps[0] * ATTITUDE_DEG_TO_RAD,
+                            ppt_gyro_dps[1] * ATTITUDE_DEG_TO_RAD,
+                            ppt_gyro_dps[2] * ATTITUDE_DEG_TO_RAD };
+
+    su_ahrs_update(&g_ahrs, gyro, ppt_acc, ppt_mag, (float)p_sample_cnt * ATTITUDE_SAMPLE_S);
+
+    return RET_OK;
+}
+
+/// Attitude as w, x, y, z from the body to the earth frame
+response_status_t attitude_get_quat(float* ppt_quat)
+{
+    ASSERT_AND_RETURN(ppt_quat == NULL, RET_PARAM_ERROR);
+
+    memcpy(ppt_quat, g_ahrs.q, sizeof(g_ahrs.q));
+
+    return RET_OK;
+}
+
+/**
+ * @brief This function gives the acceleration along the earth vertical of a
+ * body frame accelerometer sample, without the gravity.
+ * @param[out] ppt_acc_up Acceleration in m/s2, positive up.
+ */
+response_status_t attitude_get_vertical_acc(const float* ppt_acc, float* ppt_acc_up)
+{
+    ASSERT_AND_RETURN((ppt_acc == NULL) || (ppt_acc_up == NULL), RET_PARAM_ERROR);
+
+    *ppt_acc_up = su_ahrs_earth_z(&g_ahrs, ppt_acc) - IMU_STANDARD_GRAVITY;
+
+    return RET_OK;
+}
+
+response_status_t attitude_get_euler(su_ahrs_euler_t* ppt_euler)
+{
+    ASSERT_AND_RETURN(ppt_euler == NULL, RET_PARAM_ERROR);
+
+    su_ahrs_get_euler(&g_ahrs, ppt_euler);
+
+    return RET_OK;
+}
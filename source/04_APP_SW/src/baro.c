@@ -1,13 +1,58 @@
 #include "baro.h"
 
+#include "dd_bmp388/dd_bmp388_defs.h"
+
 #include "string.h"
 
-bmp388_dev_t* g_pt_baro = NULL;
+/// Output data rate of apply_settings(), the step of the first sample of the altitude filter
+#define BARO_RATE_HZ  (50U)
+#define BARO_DT_S     (1.0F / (float)BARO_RATE_HZ)
+/// Longer gaps, e.g. a sensor recovery, are stepped as this so the filter stays stable
+#define BARO_MAX_DT_S (0.25F)
+
+bmp388_dev_t*    g_pt_baro = NULL;
+static su_baro_t g_baro_alt;
+/// Sensor time of the last sample fed to the filter
+static uint32_t  g_last_sens_time;
+static bool_t    g_has_sens_time = FALSE;
+
+static response_status_t apply_settings(void)
+{
+    response_status_t ret_val = RET_OK;
+
+    g_pt_baro->settings.data_settings.iir_filter         = BMP388_IIR_COEFF_15;
+    g_pt_baro->settings.data_settings.output_data_rate   = BMP388_ODR_50_HZ;
+    g_pt_baro->settings.data_settings.press_oversampling = BMP388_OVERSAMPLING_4X;
+    g_pt_baro->settings.data_settings.temp_oversampling  = BMP388_OVERSAMPLING_2X;
+    g_pt_baro->settings.dev_settings.power_mode          = BMP388_POWER_MODE_NORMAL;
+    g_pt_baro->settings.dev_settings.sensor_enable       = BMP388_SENS_ENABLE_ALL;
+    g_pt_baro->settings.int_settings.int_enable          = BMP388_INT_ENABLE_DRDY;
+    g_pt_baro->settings.int_settings.int_type            = BMP388_INT_TYPE_PP_HIGH_NON_LATCHED;
+    ret_val                                             |= dd_bmp388_set_ifc_settings(g_pt_baro);
+    ret_val                                             |= dd_bmp388_set_data_settings(g_pt_baro);
+    ret_val                                             |= dd_bmp388_set_interrupt_settings(g_pt_baro);
+    ret_val                                             |= dd_bmp388_set_dev_settings(g_pt_baro);
+
+    return ret_val;
+}
+
+static void reset_done_cb(bmp388_dev_t* ppt_dev, bmp388_status_t p_status)
+{
+    UNUSED(ppt_dev);
+
+    // The soft reset brings all registers back to their default values
+    if (p_status == BMP388_NO_ERROR)
+    {
+        (void)apply_settings();
+    }
+}
 
 response_status_t baro_get_data(float* ppt_pres_hndlr)
 {
     ASSERT_AND_RETURN(g_pt_baro == NULL, RET_PARAM_ERROR);
 
+    dd_bmp388_process();
+
     bmp388_status_t status = dd_bmp388_get_data(g_pt_baro, BMP388_READ_ALL);
     if (status == BMP388_NO_ERROR)
     {
@@ -21,6 +66,8 @@ response_status_t baro_get_data(float* ppt_pres_hndlr)
     }
     else
     {
+        // Recover the sensor in the background, the loop keeps running meanwhile
+        (void)dd_bmp388_reset_async(g_pt_baro, reset_done_cb);
         return RET_ERROR;
     }
 }
@@ -37,18 +84,8 @@ response_status_t baro_init()
     ret_val |= dd_bmp388_get_ifc_settings(g_pt_baro);
     ret_val |= dd_bmp388_get_interrupt_settings(g_pt_baro);
 
-    g_pt_baro->settings.data_settings.iir_filter         = BMP388_IIR_COEFF_15;
-    g_pt_baro->settings.data_settings.output_data_rate   = BMP388_ODR_50_HZ;
-    g_pt_baro->settings.data_settings.press_oversampling = BMP388_OVERSAMPLING_4X;
-    g_pt_baro->settings.data_settings.temp_oversampling  = BMP388_OVERSAMPLING_2X;
-    g_pt_baro->settings.dev_settings.power_mode          = BMP388_POWER_MODE_NORMAL;
-    g_pt_baro->settings.dev_settings.sensor_enable       = BMP388_SENS_ENABLE_ALL;
-    g_pt_baro->settings.int_settings.int_enable          = BMP388_INT_ENABLE_DRDY;
-    ret_val                                        |= dd_bmp388_set_ifc_settings(g_pt_baro);
-    ret_val                                        |= dd_bmp388_set_data_settings(g_pt_baro);
-    ret_val                                        |= dd_bmp388_set_interrupt_settings(g_pt_baro);
-    ret_val                                        |= dd_bmp388_set_dev_settings(g_pt_baro);
-    bmp388_status_t status                          = dd_bmp388_get_error_state(g_pt_baro);
+    ret_val                |= apply_settings();
+    bmp388_status_t status  = dd_bmp388_get_error_state(g_pt_baro);
 
     if (ret_val != RET_OK || status != BMP388_NO_ERROR)
     {
@@ -66,5 +103,66 @@ response_status_t baro_init()
         return ret_val;
     }
 
+    // Without the INT pin the driver falls back to polling the status register
+    (void)dd_bmp388_attach_drdy_pin(g_pt_baro, GP_PIN_IN_1);
+
+    // The first sample is the ground, 0 m of the altitude
+    su_baro_init(&g_baro_alt, NULL);
+    g_has_sens_time = FALSE;
+
     return ret_val;
 }
+
+/**
+ * @brief This function feeds a new pressure sample, the last one of
+ * baro_get_data(), to the altitude filter. The step is the sensor time since
+ * the previous sample, the task and the output data rate run on different
+ * clocks so a task period may see no sample or follow a skipped one.
+ * @param[in] p_pres_pa Pressure in Pa, within SU_BARO_MIN_PA and SU_BARO_MAX_PA.
+ * @param[in] p_acc_up Vertical acceleration without the gravity in m/s2, 0
+ * without IMU.
+ * @return RET_OK, or RET_ERROR when the driver clamped the pressure to its
+ * range, the sample is then dropped.
+ */
+response_status_t baro_update_altitude(float p_pres_pa, float p_acc_up)
+{
+    ASSERT_AND_RETURN(g_pt_baro == NULL, RET_PARAM_ERROR);
+    ASSERT_AND_RETURN((p_pres_pa < SU_BARO_MIN_PA) || (p_pres_pa > SU_BARO_MAX_PA),
+                      RET_PARAM_ERROR);
+
+    // The driver clamps an out of range compensation to the bounds and flags it
+    if (g_pt_baro->data.pressure_health != BMP388_HEALTH_OK)
+    {
+        return RET_ERROR; // A glitch of the sensor, not worth a step
+    }
+
+    const uint32_t sens_time = g_pt_baro->data.sensortime;
+    float          dt_s      = BARO_DT_S;
+
+    if (g_has_sens_time == TRUE)
+    {
+        dt_s = (float)((sens_time - g_last_sens_time) & BMP388_SENS_TIME_MSK)
+               * (BMP388_SENS_TIME_TICK_US * 1.0e-6F);
+        dt_s = (dt_s > BARO_MAX_DT_S) ? BARO_MAX_DT_S : dt_s;
+    }
+    g_last_sens_time = sens_time;
+    g_has_sens_time  = TRUE;
+
+    if (dt_s > 0.0F)
+    {
+        su_baro_update(&g_baro_alt, p_pres_pa, p_acc_up, dt_s);
+    }
+
+    return RET_OK;
+}
+
+/// Altitude above the first sample and vertical speed, positive up
+response_status_t baro_get_altitude(float* ppt_alt_m, float* ppt_vs_mps)
+{
+    ASSERT_AND_RETURN((ppt_alt_m == NULL) || (ppt_vs_mps == NULL), RET_PARAM_ERROR);
+
+    *ppt_alt_m  = g_baro_alt.alt_m;
+    *ppt_vs_mps = g_baro_alt.vs_mps;
+
+    return RET_OK;
+}
@@ -1,6 +1,29 @@
 #include "imu.h"
 
 #include "dd_icm209/dd_icm209.h"
+#include "su_affine/su_affine.h"
+#include "su_calib/su_calib.h"
+
+#include <string.h>
+
+/// The vector sensors, one transform each
+#define IMU_XF_CNT           (IMU_MAG + 1)
+/// TRUE to refine the accelerometer and magnetometer calibrations while running
+#define IMU_ONLINE_CALIB     (TRUE)
+/// Horizontal part of the earth field, about central Europe, only scales the planar fit
+#define IMU_MAG_HORIZ_UT     (20.0F)
+/// The accelerometer is taken for the gravity alone while it turns slowly and reads about 1 g
+#define IMU_CAL_MAX_RATE_DPS (5.0F)
+#define IMU_CAL_ACC_TOL      (0.05F)
+
+/// Built with IMU_USE_DMP the DMP quaternion runs. It needs the InvenSense DMP3 firmware
+/// (icm20948_img.dmp3a) as the array g_icm209_dmp3_image in icm209_dmp3_image.h, not distributed
+#if defined(IMU_USE_DMP)
+#include "icm209_dmp3_image.h"
+#define IMU_DMP_ENABLE (TRUE)
+#else
+#define IMU_DMP_ENABLE (FALSE)
+#endif
 
 static const float g_acc_a[3][3] = {
     {  1.190553391091500F,  0.017123734237795F,  0.007837760042511F },
@@ -8,6 +31,7 @@ static const float g_acc_a[3][3] = {
     { -0.064525734014990F, -0.017518888406769F,  1.193724153187501F }
 };
 
+/// Accelerometer offset in m/s2, subtracted after the scale from g
 static const float g_acc_b[3] = { 0.063981206956114F, 0.106560263265376F, -0.338901066521774F };
 
 static const float g_mag_a[3][3] = {
@@ -24,99 +48,216 @@ static const int g_mounting_matrix[3][3] = {
     {  0, 0, 1 }  // Z row
 };
 
+/// Unit scale, calibration and mounting of each sensor folded into one transform
+static su_affine3_t g_imu_base_xf[IMU_XF_CNT];
+/// The transforms in use, the base ones followed by the online correction
+static su_affine3_t g_imu_xf[IMU_XF_CNT];
+/// The online fits see the output of the base transforms, so a correction never feeds back
+static su_calib_t   g_acc_cal;
+static su_calib_t   g_mag_cal;
+/// Gyro samples in the mean rate of the last imu_get_data() success
+static uint32_t     g_gyro_cnt;
 
-void imu_apply_mounting_matrix(float* ppt_acc, float* ppt_gyro, float* ppt_mag)
+/**
+ * @brief This function folds the per sample steps into one transform per
+ * sensor: the accelerometer is scaled from g to m/s2 and calibrated, the
+ * magnetometer is calibrated, then all three are rotated to the body frame.
+ * The calibrations are A * (IMU_STANDARD_GRAVITY * raw - b) for the
+ * accelerometer, its b in m/s2, and A * (raw - b) for the magnetometer, all
+ * in the sensor frame.
+ */
+static void imu_build_transforms(void)
 {
-    float acc_temp[3] = { 0 };
-    float gyro_temp[3] = { 0 };
-    float mag_temp[3] = { 0 };
+    float        mount_m[3][3];
+    float        acc_off[3];
+    float        mag_off[3];
+    float        acc_scale[3][3] = { { IMU_STANDARD_GRAVITY, 0.0F, 0.0F },
+                                     { 0.0F, IMU_STANDARD_GRAVITY, 0.0F },
+                                     { 0.0F, 0.0F, IMU_STANDARD_GRAVITY } };
+    su_affine3_t mount;
+    su_affine3_t step;
 
     for (int i = 0; i < 3; i++)
     {
         for (int j = 0; j < 3; j++)
         {
-            acc_temp[i] += (float)(g_mounting_matrix[i][j]) * ppt_acc[j];
-            gyro_temp[i] += (float)(g_mounting_matrix[i][j]) * ppt_gyro[j];
-            mag_temp[i] += (float)(g_mounting_matrix[i][j]) * ppt_mag[j];
+            mount_m[i][j] = (float)g_mounting_matrix[i][j];
         }
+        acc_off[i] = -g_acc_b[i];
+        mag_off[i] = -g_mag_b[i];
     }
+    su_affine3_init(&mount, mount_m, NULL);
 
-    for (int i = 0; i < 3; i++)
+    su_affine3_init(&g_imu_base_xf[IMU_ACC], acc_scale, acc_off);
+    su_affine3_init(&step, g_acc_a, NULL);
+    su_affine3_compose(&g_imu_base_xf[IMU_ACC], &step, &g_imu_base_xf[IMU_ACC]);
+    su_affine3_compose(&g_imu_base_xf[IMU_ACC], &mount, &g_imu_base_xf[IMU_ACC]);
+
+    g_imu_base_xf[IMU_GYRO] = mount;
+
+    su_affine3_init(&g_imu_base_xf[IMU_MAG], NULL, mag_off);
+    su_affine3_init(&step, g_mag_a, NULL);
+    su_affine3_compose(&g_imu_base_xf[IMU_MAG], &step, &g_imu_base_xf[IMU_MAG]);
+    su_affine3_compose(&g_imu_base_xf[IMU_MAG], &mount, &g_imu_base_xf[IMU_MAG]);
+
+    memcpy(g_imu_xf, g_imu_base_xf, sizeof(g_imu_xf));
+}
+
+/**
+ * @brief This function starts the online fits. A car on a road only turns
+ * about the vertical: the magnetometer is fitted on the planar model, the
+ * xy offset and shape, its z kept from the base calibration. The
+ * accelerometer needs the gravity seen from every side, e.g. a tilt on all
+ * sides on a ramp; level driving never makes its fit converge, so it is
+ * never applied.
+ */
+static response_status_t imu_init_calibration(void)
+{
+    su_calib_cfg_t    cfg     = { .radius   = IMU_STANDARD_GRAVITY,
+                                  .forget   = SU_CALIB_DEFAULT_FORGET,
+                                  .p0       = SU_CALIB_DEFAULT_P0,
+                                  .conv_var = SU_CALIB_DEFAULT_CONV_VAR,
+                                  .model    = SU_CALIB_MODEL_ELLIPSOID };
+    response_status_t ret_val = su_calib_init(&g_acc_cal, &cfg);
+
+    cfg.radius  = IMU_MAG_HORIZ_UT;
+    cfg.model   = SU_CALIB_MODEL_PLANAR;
+    ret_val    |= su_calib_init(&g_mag_cal, &cfg);
+
+    return ret_val;
+}
+
+/**
+ * @brief This function adds a sample to the online fits, both in the body
+ * frame after the base calibration. The accelerometer is only added while
+ * it measures the gravity alone.
+ */
+static void imu_feed_calibration(const float* ppt_raw_acc, const float* ppt_raw_mag,
+                                 const float* ppt_gyro_dps)
+{
+    const float max_rate2 = IMU_CAL_MAX_RATE_DPS * IMU_CAL_MAX_RATE_DPS;
+    const float min_g2    = (1.0F - IMU_CAL_ACC_TOL) * (1.0F - IMU_CAL_ACC_TOL)
+                         * IMU_STANDARD_GRAVITY * IMU_STANDARD_GRAVITY;
+    const float max_g2    = (1.0F + IMU_CAL_ACC_TOL) * (1.0F + IMU_CAL_ACC_TOL)
+                         * IMU_STANDARD_GRAVITY * IMU_STANDARD_GRAVITY;
+    float       v[3];
+
+    su_affine3_apply(&g_imu_base_xf[IMU_MAG], ppt_raw_mag, v);
+    su_calib_update(&g_mag_cal, v);
+
+    const float rate2 = (ppt_gyro_dps[0] * ppt_gyro_dps[0]) + (ppt_gyro_dps[1] * ppt_gyro_dps[1])
+                        + (ppt_gyro_dps[2] * ppt_gyro_dps[2]);
+
+    if (rate2 < max_rate2)
     {
-        ppt_acc[i] = acc_temp[i];
-        ppt_gyro[i] = gyro_temp[i];
-        ppt_mag[i] = mag_temp[i];
+        su_affine3_apply(&g_imu_base_xf[IMU_ACC], ppt_raw_acc, v);
+
+        const float g2 = (v[0] * v[0]) + (v[1] * v[1]) + (v[2] * v[2]);
+
+        if ((g2 > min_g2) && (g2 < max_g2))
+        {
+            su_calib_update(&g_acc_cal, v);
+        }
     }
 }
 
 TeensyICM20948Settings g_icm_settings = {
-    .mode                    = 1,    // 0 = low power mode, 1 = high performance mode
-    .enable_gyroscope        = TRUE, // Enables gyroscope output
-    .enable_accelerometer    = TRUE, // Enables accelerometer output
-    .enable_magnetometer     = TRUE, // Enables magnetometer output
-    .enable_quaternion       = TRUE, // Enables quaternion output
-    .gyroscope_frequency     = 50,   // Max frequency = 225, min frequency = 1
-    .accelerometer_frequency = 50,   // Max frequency = 225, min frequency = 1
-    .magnetometer_frequency  = 50,   // Max frequency = 70, min frequency = 1
-    .quaternion_frequency    = 50    // Max frequency = 225, min frequency = 50
+    .mode                    = 1,                // 0 = low power mode, 1 = high performance mode
+    .enable_gyroscope        = TRUE,             // Enables gyroscope output
+    .enable_accelerometer    = TRUE,             // Enables accelerometer output
+    .enable_magnetometer     = TRUE,             // Enables magnetometer output
+    .enable_quaternion       = IMU_DMP_ENABLE,   // Enables quaternion output
+    .gyroscope_frequency     = IMU_GYRO_RATE_HZ, // Max frequency = 225, min frequency = 1
+    .accelerometer_frequency = 50,               // Max frequency = 225, min frequency = 1
+    .magnetometer_frequency  = 50,               // Max frequency = 70, min frequency = 1
+    .quaternion_frequency    = 50                // Max frequency = 225, min frequency = 50
 };
 
 response_status_t imu_init()
 {
-    return dd_icm209_init(g_icm_settings);
-}
-response_status_t imu_get_data(float* ppt_acc, float* ppt_gyro, float* ppt_mag, float* ppt_quat)
-{
-    response_status_t ret_val = RET_ERROR;
-
-    dd_icm209_task();
-    if (dd_icm209_gyro_data_is_ready())
+    imu_build_transforms();
+    if (imu_init_calibration() != RET_OK)
     {
-        dd_icm209_read_gyro_data(&ppt_gyro[0], &ppt_gyro[1], &ppt_gyro[2]);
-        // gyro[0] /= 1000.f;
-        // gyro[1] /= 1000.f;
-        // gyro[2] /= 1000.f;
-        ret_val = RET_OK;
+        return RET_ERROR;
     }
-    else
+#if defined(IMU_USE_DMP)
+    if (dd_icm209_set_dmp_image(g_icm209_dmp3_image, sizeof(g_icm209_dmp3_image)) != RET_OK)
     {
-        ret_val = RET_BUSY;
+        return RET_ERROR;
     }
+#endif
+    return dd_icm209_init(g_icm_settings);
+}
 
-    if (ret_val == RET_OK && dd_icm209_accel_data_is_ready())
+/**
+ * @brief This function pushes the online calibrations that converged into
+ * the transforms in use, the next sample is corrected with them. A fit that
+ * is not plausible keeps the previous transform.
+ * @retval `RET_OK` if a transform was updated, `RET_BUSY` otherwise.
+ */
+response_status_t imu_update_calibration(void)
+{
+    response_status_t ret_val = RET_BUSY;
+    su_affine3_t      corr;
+
+    if (su_calib_solve(&g_acc_cal, &corr) == RET_OK)
     {
-        dd_icm209_read_accel_data(&ppt_acc[0], &ppt_acc[1], &ppt_acc[2]);
-        ppt_acc[0] *= 9.806F;
-        ppt_acc[1] *= 9.806F;
-        ppt_acc[2] *= 9.806F;
+        su_affine3_compose(&g_imu_xf[IMU_ACC], &corr, &g_imu_base_xf[IMU_ACC]);
         ret_val = RET_OK;
     }
-    else
+    if (su_calib_solve(&g_mag_cal, &corr) == RET_OK)
     {
-        ret_val = RET_BUSY;
+        su_affine3_compose(&g_imu_xf[IMU_MAG], &corr, &g_imu_base_xf[IMU_MAG]);
+        ret_val = RET_OK;
     }
 
-    if (ret_val == RET_OK && dd_icm209_mag_data_is_ready())
+    return ret_val;
+}
+
+response_status_t imu_get_data(float* ppt_acc, float* ppt_gyro, float* ppt_mag, float* ppt_quat)
+{
+    response_status_t ret_val = RET_BUSY;
+
+    dd_icm209_task();
+    // Read only once all sensors are ready, so no gyro sample is consumed without being used
+    if (dd_icm209_gyro_data_is_ready() && dd_icm209_accel_data_is_ready()
+        && dd_icm209_mag_data_is_ready())
     {
+        g_gyro_cnt = dd_icm209_read_gyro_mean(&ppt_gyro[0], &ppt_gyro[1], &ppt_gyro[2]);
+        dd_icm209_read_accel_data(&ppt_acc[0], &ppt_acc[1], &ppt_acc[2]);
         dd_icm209_read_mag_data(&ppt_mag[0], &ppt_mag[1], &ppt_mag[2]);
         ret_val = RET_OK;
     }
-    else
-    {
-        ret_val = RET_BUSY;
-    }
     if (ret_val == RET_OK)
     {
-        imu_apply_mounting_matrix(ppt_acc, ppt_gyro, ppt_mag);
+        float* const vecs[IMU_XF_CNT] = { [IMU_ACC] = ppt_acc,
+                                          [IMU_GYRO] = ppt_gyro,
+                                          [IMU_MAG]  = ppt_mag };
+        float        raw_acc[3];
+        float        raw_mag[3];
+
+        memcpy(raw_acc, ppt_acc, sizeof(raw_acc));
+        memcpy(raw_mag, ppt_mag, sizeof(raw_mag));
+        su_affine3_apply_batch(g_imu_xf, vecs, IMU_XF_CNT);
+        if (IMU_ONLINE_CALIB == TRUE)
+        {
+            imu_feed_calibration(raw_acc, raw_mag, ppt_gyro);
+        }
     }
+    // Quaternion is only produced when the DMP image is loaded, keep the last value otherwise
     if (ret_val == RET_OK && dd_icm209_quat_data_is_ready())
     {
         dd_icm209_read_quat_data(&ppt_quat[0], &ppt_quat[1], &ppt_quat[2], &ppt_quat[3]);
-        ret_val = RET_OK;
-    }
-    else
-    {
-        ret_val = RET_BUSY;
     }
     return ret_val;
 }
+
+/**
+ * @brief This function gives the number of gyro samples behind the rate of
+ * the last imu_get_data() success, the rate is their mean. The samples of a
+ * late read are not lost, the rate holds for this many sample periods.
+ */
+uint32_t imu_get_gyro_sample_cnt(void)
+{
+    return g_gyro_cnt;
+}
@@ -0,0 +1,46 @@
+#include "rc.h"
+
+/// Calibration of the sticks as measured on the FS-i6 outputs, compiled by rc_init()
+static const su_rc_cfg_t g_rc_cfg[FSI6_IN_CNT] = {
+    [FSI6_IN_L_S_UD] = { .min_us      = 1000U,
+                         .center_us   = 1500U,
+                         .max_us      = 2000U,
+                         .deadband_us = 10U,
+                         .expo        = 0.0F }, // Throttle, linear
+    [FSI6_IN_R_S_LR] = { .min_us      = 1000U,
+                         .center_us   = 1500U,
+                         .max_us      = 2000U,
+                         .deadband_us = 10U,
+                         .expo        = 0.3F }, // Steering, finer around the neutral
+};
+static su_rc_t g_rc[FSI6_IN_CNT];
+
+response_status_t rc_init(void)
+{
+    response_status_t ret_val = RET_OK;
+
+    for (uint32_t i = 0U; i < FSI6_IN_CNT; i++)
+    {
+        ret_val |= su_rc_init(&g_rc[i], &g_rc_cfg[i]);
+    }
+
+    return ret_val;
+}
+
+/**
+ * @brief This function gets the calibrated position of a stick, -1 to 1 in
+ * Q15. It never waits for the receiver.
+ * @retval The status of dd_fsi6_read_input(), the stick reads neutral unless
+ * it is `RET_OK`.
+ */
+response_status_t rc_get_stick(fsi6_inputs_t p_input, su_q15_t* ppt_value)
+{
+    ASSERT_AND_RETURN((ppt_value == NULL) || (p_input >= FSI6_IN_CNT), RET_PARAM_ERROR);
+
+    uint32_t          pulse_us = 0U;
+    response_status_t ret_val  = dd_fsi6_read_input(p_input, &pulse_us);
+
+    *ppt_value = (ret_val == RET_OK) ? su_rc_normalize(&g_rc[p_input], pulse_us) : 0;
+
+    return ret_val;
+}
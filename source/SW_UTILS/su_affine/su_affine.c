@@ -0,0 +1,120 @@
+/***************************************************************************************************
+ * Header files.
+ ***************************************************************************************************/
+
+#include "su_affine.h"
+
+#include "string.h"
+
+/***************************************************************************************************
+ * Macro definitions.
+ ***************************************************************************************************/
+
+/// One rounding per product on an FPU with fused multiply-accumulate, e.g. VFMA of the Cortex-M4F
+#if defined(__ARM_FEATURE_FMA) || defined(__FP_FAST_FMAF)
+#define MAC(p_acc, p_a, p_b) __builtin_fmaf((p_a), (p_b), (p_acc))
+#else
+#define MAC(p_acc, p_a, p_b) ((p_acc) + ((p_a) * (p_b)))
+#endif
+
+/***************************************************************************************************
+ * Local type definitions.
+ ***************************************************************************************************/
+
+/***************************************************************************************************
+ * Local data definitions.
+ ***************************************************************************************************/
+
+/***************************************************************************************************
+ * Local function definitions.
+ ***************************************************************************************************/
+
+/// The input is read into registers first, so ppt_out may be ppt_in
+static inline void apply(const su_affine3_t* ppt_xf, const float* ppt_in, float* ppt_out)
+{
+    const float x0 = ppt_in[0];
+    const float x1 = ppt_in[1];
+    const float x2 = ppt_in[2];
+
+    for (uint32_t i = 0U; i < 3U; i++)
+    {
+        const float* r = ppt_xf->row[i];
+
+        ppt_out[i] = MAC(MAC(MAC(r[3], r[0], x0), r[1], x1), r[2], x2);
+    }
+}
+
+/***************************************************************************************************
+ * External function definitions.
+ ***************************************************************************************************/
+
+/**
+ * @brief This function sets a transform from its matrix and offset.
+ * @param[in] ppt_m Matrix, NULL for the identity.
+ * @param[in] ppt_b Offset added after the matrix, NULL for none.
+ */
+void su_affine3_init(su_affine3_t* ppt_xf, const float ppt_m[3][3], const float* ppt_b)
+{
+    ASSERT_AND_RETURN(ppt_xf == NULL, );
+
+    for (uint32_t i = 0U; i < 3U; i++)
+    {
+        for (uint32_t j = 0U; j < 3U; j++)
+        {
+            ppt_xf->row[i][j] = (ppt_m != NULL) ? ppt_m[i][j] : ((i == j) ? 1.0F : 0.0F);
+        }
+        ppt_xf->row[i][3] = (ppt_b != NULL) ? ppt_b[i] : 0.0F;
+    }
+}
+
+/**
+ * @brief This function folds two transforms into one, applying the result
+ * equals applying `ppt_inner` and then `ppt_outer`. The output may be one of
+ * the inputs.
+ */
+void su_affine3_compose(su_affine3_t* ppt_out, const su_affine3_t* ppt_outer,
+                        const su_affine3_t* ppt_inner)
+{
+    ASSERT_AND_RETURN((ppt_out == NULL) || (ppt_outer == NULL) || (ppt_inner == NULL), );
+
+    su_affine3_t res;
+
+    for (uint32_t i = 0U; i < 3U; i++)
+    {
+        for (uint32_t j = 0U; j < 4U; j++)
+        {
+            float acc = (j == 3U) ? ppt_outer->row[i][3] : 0.0F;
+
+            for (uint32_t k = 0U; k < 3U; k++)
+            {
+                acc = MAC(acc, ppt_outer->row[i][k], ppt_inner->row[k][j]);
+            }
+            res.row[i][j] = acc;
+        }
+    }
+
+    memcpy(ppt_out, &res, sizeof(res));
+}
+
+void su_affine3_apply(const su_affine3_t* ppt_xf, const float* ppt_in, float* ppt_out)
+{
+    ASSERT_AND_RETURN((ppt_xf == NULL) || (ppt_in == NULL) || (ppt_out == NULL), );
+
+    apply(ppt_xf, ppt_in, ppt_out);
+}
+
+/**
+ * @brief This function transforms a set of vectors in place in one pass, e.g.
+ * the accelerometer, gyroscope and magnetometer sample of one IMU read.
+ * @param[in] ppt_xfs One transform per vector.
+ * @param[in,out] ppt_vecs Vectors of 3 floats.
+ */
+void su_affine3_apply_batch(const su_affine3_t* ppt_xfs, float* const* ppt_vecs, uint32_t p_cnt)
+{
+    ASSERT_AND_RETURN((ppt_xfs == NULL) || (ppt_vecs == NULL), );
+
+    for (uint32_t s = 0U; s < p_cnt; s++)
+    {
+        apply(&ppt_xfs[s], ppt_vecs[s], ppt_vecs[s]);
+    }
+}
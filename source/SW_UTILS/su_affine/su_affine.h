@@ -0,0 +1,37 @@
+#ifndef SU_AFFINE_H
+#define SU_AFFINE_H
+
+/***************************************************************************************************
+ * Header files.
+ ***************************************************************************************************/
+#include "su_common.h"
+/***************************************************************************************************
+ * Macro definitions.
+ ***************************************************************************************************/
+
+/***************************************************************************************************
+ * External type declarations.
+ ***************************************************************************************************/
+
+/// y = M * x + b, each row holds a row of M followed by its offset so a row
+/// is one aligned 16 byte load with the operands in the order they are used
+typedef struct
+{
+    float row[3][4] __attribute__((aligned(16)));
+} su_affine3_t;
+
+/***************************************************************************************************
+ * External data declarations.
+ ***************************************************************************************************/
+
+/***************************************************************************************************
+ * External function declarations.
+ ***************************************************************************************************/
+
+void su_affine3_init(su_affine3_t* ppt_xf, const float ppt_m[3][3], const float* ppt_b);
+void su_affine3_compose(su_affine3_t* ppt_out, const su_affine3_t* ppt_outer,
+                        const su_affine3_t* ppt_inner);
+void su_affine3_apply(const su_affine3_t* ppt_xf, const float* ppt_in, float* ppt_out);
+void su_affine3_apply_batch(const su_affine3_t* ppt_xfs, float* const* ppt_vecs, uint32_t p_cnt);
+
+#endif /* SU_AFFINE_H */
@@ -0,0 +1,226 @@
+/***************************************************************************************************
+ * Header files.
+ ***************************************************************************************************/
+
+#include "su_ahrs.h"
+
+#include "math.h"
+#include "string.h"
+
+/***************************************************************************************************
+ * Macro definitions.
+ ***************************************************************************************************/
+
+/***************************************************************************************************
+ * Local type definitions.
+ ***************************************************************************************************/
+
+/***************************************************************************************************
+ * Local data definitions.
+ ***************************************************************************************************/
+
+/***************************************************************************************************
+ * Local function definitions.
+ ***************************************************************************************************/
+
+/// Scales a 3 vector to unit length, FALSE for a zero vector
+static bool_t normalize3(float* ppt_v)
+{
+    float norm2 = (ppt_v[0] * ppt_v[0]) + (ppt_v[1] * ppt_v[1]) + (ppt_v[2] * ppt_v[2]);
+
+    if (norm2 <= 0.0F)
+    {
+        return FALSE;
+    }
+
+    float inv = su_ahrs_inv_sqrt(norm2);
+
+    ppt_v[0] *= inv;
+    ppt_v[1] *= inv;
+    ppt_v[2] *= inv;
+
+    return TRUE;
+}
+
+/**
+ * @brief This function gives the direction error of the measured gravity and
+ * magnetic field to their directions predicted by the attitude. The field
+ * reference is its measurement turned to earth and its horizontal part put
+ * on x, so the magnetometer only corrects the heading.
+ */
+static void direction_error(const float* ppt_q, const float* ppt_a, const float* ppt_m,
+                            float* ppt_err)
+{
+    const float q0q0 = ppt_q[0] * ppt_q[0];
+    const float q0q1 = ppt_q[0] * ppt_q[1];
+    const float q0q2 = ppt_q[0] * ppt_q[2];
+    const float q0q3 = ppt_q[0] * ppt_q[3];
+    const float q1q1 = ppt_q[1] * ppt_q[1];
+    const float q1q2 = ppt_q[1] * ppt_q[2];
+    const float q1q3 = ppt_q[1] * ppt_q[3];
+    const float q2q2 = ppt_q[2] * ppt_q[2];
+    const float q2q3 = ppt_q[2] * ppt_q[3];
+    const float q3q3 = ppt_q[3] * ppt_q[3];
+
+    // Gravity direction in the body frame, half of it
+    const float vx = q1q3 - q0q2;
+    const float vy = q0q1 + q2q3;
+    const float vz = q0q0 - 0.5F + q3q3;
+
+    ppt_err[0] = (ppt_a[1] * vz) - (ppt_a[2] * vy);
+    ppt_err[1] = (ppt_a[2] * vx) - (ppt_a[0] * vz);
+    ppt_err[2] = (ppt_a[0] * vy) - (ppt_a[1] * vx);
+
+    if (ppt_m != NULL)
+    {
+        const float hx = 2.0F * ((ppt_m[0] * (0.5F - q2q2 - q3q3)) + (ppt_m[1] * (q1q2 - q0q3))
+                                 + (ppt_m[2] * (q1q3 + q0q2)));
+        const float hy = 2.0F * ((ppt_m[0] * (q1q2 + q0q3)) + (ppt_m[1] * (0.5F - q1q1 - q3q3))
+                                 + (ppt_m[2] * (q2q3 - q0q1)));
+        const float h2 = (hx * hx) + (hy * hy);
+        const float bx = h2 * su_ahrs_inv_sqrt(h2); // sqrt without libm
+        const float bz = 2.0F * ((ppt_m[0] * (q1q3 - q0q2)) + (ppt_m[1] * (q2q3 + q0q1))
+                                 + (ppt_m[2] * (0.5F - q1q1 - q2q2)));
+
+        // Field direction in the body frame, half of it
+        const float wx = (bx * (0.5F - q2q2 - q3q3)) + (bz * (q1q3 - q0q2));
+        const float wy = (bx * (q1q2 - q0q3)) + (bz * (q0q1 + q2q3));
+        const float wz = (bx * (q0q2 + q1q3)) + (bz * (0.5F - q1q1 - q2q2));
+
+        ppt_err[0] += (ppt_m[1] * wz) - (ppt_m[2] * wy);
+        ppt_err[1] += (ppt_m[2] * wx) - (ppt_m[0] * wz);
+        ppt_err[2] += (ppt_m[0] * wy) - (ppt_m[1] * wx);
+    }
+}
+
+/***************************************************************************************************
+ * External function definitions.
+ ***************************************************************************************************/
+
+/**
+ * @brief This function returns 1 / sqrt(x) for x > 0 by the bit level first
+ * guess and two Newton steps, the relative error stays below 5e-6.
+ */
+float su_ahrs_inv_sqrt(float p_x)
+{
+    float    y    = 0.0F;
+    uint32_t bits = 0U;
+
+    memcpy(&bits, &p_x, sizeof(bits));
+    bits = 0x5F375A86U - (bits >> 1);
+    memcpy(&y, &bits, sizeof(y));
+
+    y = y * (1.5F - (0.5F * p_x * y * y));
+    y = y * (1.5F - (0.5F * p_x * y * y));
+
+    return y;
+}
+
+/**
+ * @brief This function starts the filter level and heading north.
+ * @param[in] ppt_cfg Gains, NULL for SU_AHRS_DEFAULT_KP and SU_AHRS_DEFAULT_KI.
+ */
+void su_ahrs_init(su_ahrs_t* ppt_ahrs, const su_ahrs_cfg_t* ppt_cfg)
+{
+    ASSERT_AND_RETURN(ppt_ahrs == NULL, );
+
+    memset(ppt_ahrs, 0, sizeof(*ppt_ahrs));
+    ppt_ahrs->q[0]    = 1.0F;
+    ppt_ahrs->cfg.kp  = (ppt_cfg != NULL) ? ppt_cfg->kp : SU_AHRS_DEFAULT_KP;
+    ppt_ahrs->cfg.ki  = (ppt_cfg != NULL) ? ppt_cfg->ki : SU_AHRS_DEFAULT_KI;
+}
+
+/**
+ * @brief This function integrates one gyro sample, corrected towards the
+ * measured gravity and magnetic field. It has no libm call.
+ * @param[in] ppt_gyro Angular rate in rad/s.
+ * @param[in] ppt_acc Specific force in any unit, +z when level. A zero vector,
+ * e.g. in free fall, skips the correction.
+ * @param[in] ppt_mag Magnetic field in any unit, NULL without magnetometer.
+ * @param[in] p_dt_s Time since the previous update.
+ */
+void su_ahrs_update(su_ahrs_t* ppt_ahrs, const float* ppt_gyro, const float* ppt_acc,
+                    const float* ppt_mag, float p_dt_s)
+{
+    ASSERT_AND_RETURN((ppt_ahrs == NULL) || (ppt_gyro == NULL) || (ppt_acc == NULL), );
+
+    float* q     = ppt_ahrs->q;
+    float  g[3]  = { ppt_gyro[0], ppt_gyro[1], ppt_gyro[2] };
+    float  a[3]  = { ppt_acc[0], ppt_acc[1], ppt_acc[2] };
+    float  m[3]  = { 0.0F };
+    float  qa[4] = { 0.0F };
+
+    if (normalize3(a) == TRUE)
+    {
+        float  err[3] = { 0.0F };
+        bool_t has_m  = FALSE;
+
+        if (ppt_mag != NULL)
+        {
+            memcpy(m, ppt_mag, sizeof(m));
+            has_m = normalize3(m);
+        }
+        direction_error(q, a, (has_m == TRUE) ? m : NULL, err);
+
+        for (uint32_t i = 0U; i < 3U; i++)
+        {
+            if (ppt_ahrs->cfg.ki > 0.0F)
+            {
+                ppt_ahrs->bias_fb[i] += 2.0F * ppt_ahrs->cfg.ki * err[i] * p_dt_s;
+            }
+            g[i] += ppt_ahrs->bias_fb[i] + (2.0F * ppt_ahrs->cfg.kp * err[i]);
+        }
+    }
+
+    // q += 0.5 * q x (0, g) * dt
+    for (uint32_t i = 0U; i < 3U; i++)
+    {
+        g[i] *= 0.5F * p_dt_s;
+    }
+    memcpy(qa, q, sizeof(qa));
+    q[0] += (-qa[1] * g[0]) - (qa[2] * g[1]) - (qa[3] * g[2]);
+    q[1] += (qa[0] * g[0]) + (qa[2] * g[2]) - (qa[3] * g[1]);
+    q[2] += (qa[0] * g[1]) - (qa[1] * g[2]) + (qa[3] * g[0]);
+    q[3] += (qa[0] * g[2]) + (qa[1] * g[1]) - (qa[2] * g[0]);
+
+    float inv = su_ahrs_inv_sqrt((q[0] * q[0]) + (q[1] * q[1]) + (q[2] * q[2]) + (q[3] * q[3]));
+
+    for (uint32_t i = 0U; i < 4U; i++)
+    {
+        q[i] *= inv;
+    }
+}
+
+/**
+ * @brief This function gives the earth vertical component of a body frame
+ * vector, e.g. the specific force along the earth z.
+ */
+float su_ahrs_earth_z(const su_ahrs_t* ppt_ahrs, const float* ppt_v)
+{
+    ASSERT_AND_RETURN((ppt_ahrs == NULL) || (ppt_v == NULL), 0.0F);
+
+    const float* q = ppt_ahrs->q;
+
+    return 2.0F * ((ppt_v[0] * ((q[1] * q[3]) - (q[0] * q[2])))
+                   + (ppt_v[1] * ((q[2] * q[3]) + (q[0] * q[1])))
+                   + (ppt_v[2] * (0.5F - (q[1] * q[1]) - (q[2] * q[2]))));
+}
+
+/**
+ * @brief This function converts the attitude to Euler angles. It is meant
+ * for the output rate, not the update rate, and uses libm.
+ */
+void su_ahrs_get_euler(const su_ahrs_t* ppt_ahrs, su_ahrs_euler_t* ppt_euler)
+{
+    ASSERT_AND_RETURN((ppt_ahrs == NULL) || (ppt_euler == NULL), );
+
+    const float* q      = ppt_ahrs->q;
+    float        sin_p  = 2.0F * ((q[0] * q[2]) - (q[3] * q[1]));
+
+    sin_p            = (sin_p > 1.0F) ? 1.0F : ((sin_p < -1.0F) ? -1.0F : sin_p);
+    ppt_euler->roll  = atan2f(2.0F * ((q[0] * q[1]) + (q[2] * q[3])),
+                              1.0F - (2.0F * ((q[1] * q[1]) + (q[2] * q[2]))));
+    ppt_euler->pitch = asinf(sin_p);
+    ppt_euler->yaw   = atan2f(2.0F * ((q[0] * q[3]) + (q[1] * q[2])),
+                              1.0F - (2.0F * ((q[2] * q[2]) + (q[3] * q[3]))));
+}
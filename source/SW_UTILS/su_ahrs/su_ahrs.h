@@ -0,0 +1,57 @@
+#ifndef SU_AHRS_H
+#define SU_AHRS_H
+
+/***************************************************************************************************
+ * Header files.
+ ***************************************************************************************************/
+#include "su_common.h"
+/***************************************************************************************************
+ * Macro definitions.
+ ***************************************************************************************************/
+
+/// Gains of a few degrees per second of correction, the attitude settles in seconds
+#define SU_AHRS_DEFAULT_KP (1.0F)
+#define SU_AHRS_DEFAULT_KI (0.05F)
+
+/***************************************************************************************************
+ * External type declarations.
+ ***************************************************************************************************/
+
+typedef struct
+{
+    float kp; // Proportional gain of the acc/mag correction, 0 integrates the gyro only
+    float ki; // Integral gain, estimates the gyro bias, 0 disables it
+} su_ahrs_cfg_t;
+
+/// Mahony complementary filter, the body frame is x forward, z up
+typedef struct
+{
+    su_ahrs_cfg_t cfg;
+    float         q[4];        // w, x, y, z, body to earth
+    float         bias_fb[3];  // Integral feedback, in rad/s
+} su_ahrs_t;
+
+/// Tait-Bryan angles in rad, yaw about z, then pitch about y, then roll about x
+typedef struct
+{
+    float roll;
+    float pitch;
+    float yaw;
+} su_ahrs_euler_t;
+
+/***************************************************************************************************
+ * External data declarations.
+ ***************************************************************************************************/
+
+/***************************************************************************************************
+ * External function declarations.
+ ***************************************************************************************************/
+
+void  su_ahrs_init(su_ahrs_t* ppt_ahrs, const su_ahrs_cfg_t* ppt_cfg);
+void  su_ahrs_update(su_ahrs_t* ppt_ahrs, const float* ppt_gyro, const float* ppt_acc,
+                     const float* ppt_mag, float p_dt_s);
+void  su_ahrs_get_euler(const su_ahrs_t* ppt_ahrs, su_ahrs_euler_t* ppt_euler);
+float su_ahrs_earth_z(const su_ahrs_t* ppt_ahrs, const float* ppt_v);
+float su_ahrs_inv_sqrt(float p_x);
+
+#endif /* SU_AHRS_H */
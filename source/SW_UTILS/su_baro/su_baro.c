@@ -0,0 +1,151 @@
+/***************************************************************************************************
+ * Header files.
+ ***************************************************************************************************/
+
+#include "su_baro.h"
+
+#include "string.h"
+
+/***************************************************************************************************
+ * Macro definitions.
+ ***************************************************************************************************/
+
+#define ALT_LUT_CNT  (129U)
+#define ALT_LUT_STEP ((SU_BARO_MAX_PA - SU_BARO_MIN_PA) / (float)(ALT_LUT_CNT - 1U))
+
+/***************************************************************************************************
+ * Local type definitions.
+ ***************************************************************************************************/
+
+/***************************************************************************************************
+ * Local data definitions.
+ ***************************************************************************************************/
+
+/// 44330.77 * (1 - (p / 101325)^0.190263) in m, the standard atmosphere, every ALT_LUT_STEP Pa
+static const float g_alt_lut[ALT_LUT_CNT] = {
+    9163.949F, 9000.052F, 8839.327F, 8681.642F, 8526.871F, 8374.896F, 8225.606F, 8078.898F,
+    7934.675F, 7792.843F, 7653.316F, 7516.013F, 7380.855F, 7247.768F, 7116.684F, 6987.536F,
+    6860.262F, 6734.801F, 6611.097F, 6489.096F, 6368.746F, 6249.998F, 6132.806F, 6017.125F,
+    5902.911F, 5790.123F, 5678.723F, 5568.674F, 5459.937F, 5352.481F, 5246.270F, 5141.274F,
+    5037.461F, 4934.803F, 4833.271F, 4732.838F, 4633.477F, 4535.163F, 4437.873F, 4341.581F,
+    4246.267F, 4151.907F, 4058.482F, 3965.969F, 3874.351F, 3783.607F, 3693.719F, 3604.669F,
+    3516.441F, 3429.016F, 3342.380F, 3256.517F, 3171.410F, 3087.046F, 3003.410F, 2920.488F,
+    2838.267F, 2756.733F, 2675.875F, 2595.679F, 2516.133F, 2437.226F, 2358.947F, 2281.284F,
+    2204.227F, 2127.765F, 2051.889F, 1976.587F, 1901.851F, 1827.671F, 1754.038F, 1680.943F,
+    1608.377F, 1536.332F, 1464.799F, 1393.771F, 1323.240F, 1253.197F, 1183.636F, 1114.549F,
+    1045.928F, 977.768F,  910.061F,  842.799F,  775.978F,  709.591F,  643.630F,  578.091F,
+    512.966F,  448.252F,  383.940F,  320.027F,  256.507F,  193.373F,  130.622F,  68.248F,
+    6.245F,    -55.391F,  -116.664F, -177.580F, -238.144F, -298.359F, -358.230F, -417.762F,
+    -476.959F, -535.825F, -594.363F, -652.580F, -710.477F, -768.059F, -825.330F, -882.293F,
+    -938.953F, -995.312F, -1051.375F, -1107.145F, -1162.624F, -1217.818F, -1272.728F, -1327.358F,
+    -1381.711F, -1435.791F, -1489.600F, -1543.142F, -1596.419F, -1649.434F, -1702.190F,
+    -1754.690F, -1806.937F,
+};
+
+/***************************************************************************************************
+ * Local function definitions.
+ ***************************************************************************************************/
+
+/***************************************************************************************************
+ * External function definitions.
+ ***************************************************************************************************/
+
+/**
+ * @brief This function gives the standard atmosphere altitude of a pressure
+ * without powf(): a quadratic through 3 points of a table, within 2 cm from
+ * SU_BARO_MIN_PA to SU_BARO_MAX_PA. Pressures out of the range are clamped.
+ */
+float su_baro_pressure_altitude(float p_pa)
+{
+    float t = (p_pa - SU_BARO_MIN_PA) * (1.0F / ALT_LUT_STEP);
+
+    if (!(t > 0.0F)) // NaN too
+    {
+        t = 0.0F;
+    }
+    else if (t > (float)(ALT_LUT_CNT - 1U))
+    {
+        t = (float)(ALT_LUT_CNT - 1U);
+    }
+
+    uint32_t idx = (uint32_t)t;
+
+    if (idx > (ALT_LUT_CNT - 3U))
+    {
+        idx = ALT_LUT_CNT - 3U; // The last step extends the quadratic before it
+    }
+
+    const float  f  = t - (float)idx;
+    const float* y  = &g_alt_lut[idx];
+    const float  d1 = y[1] - y[0];
+    const float  d2 = (y[2] - (2.0F * y[1])) + y[0];
+
+    return y[0] + (f * (d1 + ((f - 1.0F) * 0.5F * d2)));
+}
+
+/**
+ * @param[in] ppt_cfg Filter configuration, NULL for the default one.
+ */
+void su_baro_init(su_baro_t* ppt_baro, const su_baro_cfg_t* ppt_cfg)
+{
+    ASSERT_AND_RETURN(ppt_baro == NULL, );
+
+    memset(ppt_baro, 0, sizeof(*ppt_baro));
+    ppt_baro->cfg.tau_s = SU_BARO_DEFAULT_TAU_S;
+    if ((ppt_cfg != NULL) && (ppt_cfg->tau_s > 0.0F))
+    {
+        ppt_baro->cfg = *ppt_cfg;
+    }
+
+    /// Three poles at -1/tau, the error dies out without overshoot
+    const float w = 1.0F / ppt_baro->cfg.tau_s;
+
+    ppt_baro->k[0] = 3.0F * w;
+    ppt_baro->k[1] = 3.0F * w * w;
+    ppt_baro->k[2] = w * w * w;
+}
+
+/**
+ * @brief This function takes a pressure as the 0 m of the altitude and
+ * restarts the estimate at rest there.
+ */
+void su_baro_set_ground(su_baro_t* ppt_baro, float p_pa)
+{
+    ASSERT_AND_RETURN(ppt_baro == NULL, );
+
+    ppt_baro->ground_m   = su_baro_pressure_altitude(p_pa);
+    ppt_baro->alt_m      = 0.0F;
+    ppt_baro->vs_mps     = 0.0F;
+    ppt_baro->acc_corr   = 0.0F;
+    ppt_baro->has_ground = TRUE;
+}
+
+/**
+ * @brief This function runs one step of the filter. The accelerometer
+ * integrates the speed and the altitude, the barometer error pulls them back
+ * and learns the accelerometer bias, so the speed follows the accelerometer
+ * quickly without drifting.
+ * @param[in] p_pa Pressure of the step, the first one is the reference if none is set.
+ * @param[in] p_acc_up Acceleration along the earth vertical without the gravity, in m/s2.
+ * @param[in] p_dt_s Time since the previous step.
+ */
+void su_baro_update(su_baro_t* ppt_baro, float p_pa, float p_acc_up, float p_dt_s)
+{
+    ASSERT_AND_RETURN((ppt_baro == NULL) || (p_dt_s <= 0.0F), );
+
+    if (ppt_baro->has_ground == FALSE)
+    {
+        su_baro_set_ground(ppt_baro, p_pa);
+    }
+
+    const float err = (su_baro_pressure_altitude(p_pa) - ppt_baro->ground_m) - ppt_baro->alt_m;
+
+    ppt_baro->acc_corr += ppt_baro->k[2] * err * p_dt_s;
+    ppt_baro->vs_mps   += ppt_baro->k[1] * err * p_dt_s;
+    ppt_baro->alt_m    += ppt_baro->k[0] * err * p_dt_s;
+
+    const float dv = (p_acc_up + ppt_baro->acc_corr) * p_dt_s;
+
+    ppt_baro->alt_m  += (ppt_baro->vs_mps + (0.5F * dv)) * p_dt_s;
+    ppt_baro->vs_mps += dv;
+}
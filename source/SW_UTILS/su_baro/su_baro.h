@@ -0,0 +1,52 @@
+#ifndef SU_BARO_H
+#define SU_BARO_H
+
+/***************************************************************************************************
+ * Header files.
+ ***************************************************************************************************/
+#include "su_common.h"
+/***************************************************************************************************
+ * Macro definitions.
+ ***************************************************************************************************/
+
+/// Pressure range of the altitude table, the one of the BMP388
+#define SU_BARO_MIN_PA        (30000.0F)
+#define SU_BARO_MAX_PA        (125000.0F)
+/// The barometer corrects the accelerometer over a few seconds
+#define SU_BARO_DEFAULT_TAU_S (2.0F)
+
+/***************************************************************************************************
+ * External type declarations.
+ ***************************************************************************************************/
+
+typedef struct
+{
+    float tau_s; // Time constant of the baro correction, larger trusts the accelerometer longer
+} su_baro_cfg_t;
+
+/// Third order complementary filter of the altitude, the vertical speed and the acc bias
+typedef struct
+{
+    su_baro_cfg_t cfg;
+    float         k[3];       // Gains of the altitude error on the altitude, speed and acc bias
+    float         ground_m;   // Pressure altitude of the reference, 0 m of the estimate
+    float         alt_m;      // Altitude above the reference
+    float         vs_mps;     // Vertical speed, positive up
+    float         acc_corr;   // Correction of the acc bias, in m/s2
+    bool_t        has_ground; // FALSE until a reference is set, the next sample is taken for it
+} su_baro_t;
+
+/***************************************************************************************************
+ * External data declarations.
+ ***************************************************************************************************/
+
+/***************************************************************************************************
+ * External function declarations.
+ ***************************************************************************************************/
+
+float su_baro_pressure_altitude(float p_pa);
+void  su_baro_init(su_baro_t* ppt_baro, const su_baro_cfg_t* ppt_cfg);
+void  su_baro_set_ground(su_baro_t* ppt_baro, float p_pa);
+void  su_baro_update(su_baro_t* ppt_baro, float p_pa, float p_acc_up, float p_dt_s);
+
+#endif /* SU_BARO_H */
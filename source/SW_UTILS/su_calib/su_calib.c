@@ -0,0 +1,374 @@
+/***************************************************************************************************
+ * Header files.
+ ***************************************************************************************************/
+
+#include "su_calib.h"
+
+#include "math.h"
+#include "string.h"
+
+/***************************************************************************************************
+ * Macro definitions.
+ ***************************************************************************************************/
+
+#define N                (SU_CALIB_PARAM_CNT)
+/// Iterations of the matrix square root, quadratic convergence from a plausible fit
+#define SQRT_ITER_CNT    (12U)
+/// Plausible fit: the center within one radius and an average gain in [1/2, 2]
+#define MAX_CENTER       (1.0F)
+#define MIN_MEAN_SCALE2  (0.25F)
+#define MAX_MEAN_SCALE2  (4.0F)
+#define MIN_DET          (1.0e-9F)
+/// Plausible planar fit: the two gains within a factor 2 of each other, their product being 1
+#define MAX_PLANAR_TRACE (2.1213F)
+/// Slots of the planar fit, the other ones are held
+#define PL_A             (0U)
+#define PL_D             (1U)
+#define PL_B             (3U)
+#define PL_V0            (6U)
+#define PL_V1            (7U)
+#define IS_PL_PARAM(i)   \
+    (((i) == PL_A) || ((i) == PL_D) || ((i) == PL_B) || ((i) == PL_V0) || ((i) == PL_V1))
+
+/***************************************************************************************************
+ * Local type definitions.
+ ***************************************************************************************************/
+
+/***************************************************************************************************
+ * Local data definitions.
+ ***************************************************************************************************/
+
+/***************************************************************************************************
+ * Local function definitions.
+ ***************************************************************************************************/
+
+static float det3(const float ppt_m[3][3])
+{
+    return (ppt_m[0][0] * ((ppt_m[1][1] * ppt_m[2][2]) - (ppt_m[1][2] * ppt_m[2][1])))
+           + (ppt_m[0][1] * ((ppt_m[1][2] * ppt_m[2][0]) - (ppt_m[1][0] * ppt_m[2][2])))
+           + (ppt_m[0][2] * ((ppt_m[1][0] * ppt_m[2][1]) - (ppt_m[1][1] * ppt_m[2][0])));
+}
+
+/// Inverse of a 3x3 matrix by its cofactors, FALSE if it is singular
+static bool_t inv3(const float ppt_m[3][3], float ppt_inv[3][3])
+{
+    const float c00 = (ppt_m[1][1] * ppt_m[2][2]) - (ppt_m[1][2] * ppt_m[2][1]);
+    const float c01 = (ppt_m[1][2] * ppt_m[2][0]) - (ppt_m[1][0] * ppt_m[2][2]);
+    const float c02 = (ppt_m[1][0] * ppt_m[2][1]) - (ppt_m[1][1] * ppt_m[2][0]);
+    const float det = (ppt_m[0][0] * c00) + (ppt_m[0][1] * c01) + (ppt_m[0][2] * c02);
+
+    if (!(fabsf(det) > MIN_DET))
+    {
+        return FALSE;
+    }
+
+    const float inv_det = 1.0F / det;
+
+    ppt_inv[0][0] = c00 * inv_det;
+    ppt_inv[1][0] = c01 * inv_det;
+    ppt_inv[2][0] = c02 * inv_det;
+    ppt_inv[0][1] = ((ppt_m[0][2] * ppt_m[2][1]) - (ppt_m[0][1] * ppt_m[2][2])) * inv_det;
+    ppt_inv[1][1] = ((ppt_m[0][0] * ppt_m[2][2]) - (ppt_m[0][2] * ppt_m[2][0])) * inv_det;
+    ppt_inv[2][1] = ((ppt_m[0][1] * ppt_m[2][0]) - (ppt_m[0][0] * ppt_m[2][1])) * inv_det;
+    ppt_inv[0][2] = ((ppt_m[0][1] * ppt_m[1][2]) - (ppt_m[0][2] * ppt_m[1][1])) * inv_det;
+    ppt_inv[1][2] = ((ppt_m[0][2] * ppt_m[1][0]) - (ppt_m[0][0] * ppt_m[1][2])) * inv_det;
+    ppt_inv[2][2] = ((ppt_m[0][0] * ppt_m[1][1]) - (ppt_m[0][1] * ppt_m[1][0])) * inv_det;
+
+    return TRUE;
+}
+
+/**
+ * @brief This function gives the symmetric square root of a positive definite
+ * matrix by the Denman-Beavers iteration, FALSE if an iterate is singular.
+ */
+static bool_t sqrt3(const float ppt_s[3][3], float ppt_root[3][3])
+{
+    float y[3][3];
+    float z[3][3] = { { 1.0F, 0.0F, 0.0F }, { 0.0F, 1.0F, 0.0F }, { 0.0F, 0.0F, 1.0F } };
+    float y_inv[3][3];
+    float z_inv[3][3];
+
+    memcpy(y, ppt_s, sizeof(y));
+    for (uint32_t it = 0U; it < SQRT_ITER_CNT; it++)
+    {
+        if ((inv3(y, y_inv) == FALSE) || (inv3(z, z_inv) == FALSE))
+        {
+            return FALSE;
+        }
+        for (uint32_t i = 0U; i < 3U; i++)
+        {
+            for (uint32_t j = 0U; j < 3U; j++)
+            {
+                y[i][j] = 0.5F * (y[i][j] + z_inv[i][j]);
+                z[i][j] = 0.5F * (z[i][j] + y_inv[i][j]);
+            }
+        }
+    }
+    memcpy(ppt_root, y, sizeof(y));
+
+    return TRUE;
+}
+
+/**
+ * @brief This function solves the planar fit: the ellipse
+ * x2 + y2 + a * (x2 - y2) + 2 * b * xy + 2 * v' * u + d = 0 in the xy plane,
+ * i.e. M = [1 + a, b; b, 1 - a]. The constant z and its cross terms fold into
+ * v and d, and the right side 0 holds however large the center is against
+ * the horizontal radius. That radius depends on the field inclination and is
+ * not known, so the shape is taken with a unit determinant: the xy offset and
+ * shape are corrected, the mean gain and the z axis are kept.
+ */
+static response_status_t solve_planar(const su_calib_t* ppt_cal, su_affine3_t* ppt_corr)
+{
+    const float* t   = ppt_cal->theta;
+    const float  m00 = 1.0F + t[PL_A];
+    const float  m11 = 1.0F - t[PL_A];
+    const float  m01 = t[PL_B];
+    const float  det = (m00 * m11) - (m01 * m01);
+
+    if (!(det > MIN_DET))
+    {
+        return RET_ERROR;
+    }
+
+    const float c0 = -((m11 * t[PL_V0]) - (m01 * t[PL_V1])) / det;
+    const float c1 = -((m00 * t[PL_V1]) - (m01 * t[PL_V0])) / det;
+    const float k  = (m00 * c0 * c0) + (2.0F * m01 * c0 * c1) + (m11 * c1 * c1) - t[PL_D];
+
+    if (!(k > 0.0F) || !(((c0 * c0) + (c1 * c1)) < (MAX_CENTER * MAX_CENTER)))
+    {
+        return RET_ERROR;
+    }
+
+    /// Square root of the 2x2 matrix in closed form, then scaled to a unit determinant
+    const float sd    = sqrtf(det);
+    const float scale = 1.0F / (sqrtf(m00 + m11 + (2.0F * sd)) * sqrtf(sd));
+    const float w00   = (m00 + sd) * scale;
+    const float w11   = (m11 + sd) * scale;
+    const float w01   = m01 * scale;
+
+    if (!((w00 + w11) < MAX_PLANAR_TRACE))
+    {
+        return RET_ERROR;
+    }
+
+    const float r       = ppt_cal->cfg.radius;
+    const float w[3][3] = { { w00, w01, 0.0F }, { w01, w11, 0.0F }, { 0.0F, 0.0F, 1.0F } };
+    const float b[3]    = { -r * ((w00 * c0) + (w01 * c1)), -r * ((w01 * c0) + (w11 * c1)), 0.0F };
+
+    su_affine3_init(ppt_corr, w, b);
+
+    return RET_OK;
+}
+
+/***************************************************************************************************
+ * External function definitions.
+ ***************************************************************************************************/
+
+/**
+ * @brief This function starts a fit from the sphere of the configured radius,
+ * i.e. from the current calibration.
+ * @return RET_OK or RET_PARAM_ERROR for a configuration out of range.
+ */
+response_status_t su_calib_init(su_calib_t* ppt_cal, const su_calib_cfg_t* ppt_cfg)
+{
+    ASSERT_AND_RETURN((ppt_cal == NULL) || (ppt_cfg == NULL), RET_PARAM_ERROR);
+    ASSERT_AND_RETURN(!(ppt_cfg->radius > 0.0F) || !(ppt_cfg->forget > 0.0F)
+                          || (ppt_cfg->forget > 1.0F) || !(ppt_cfg->p0 > 0.0F)
+                          || !(ppt_cfg->conv_var > 0.0F)
+                          || (ppt_cfg->model > SU_CALIB_MODEL_PLANAR),
+                      RET_PARAM_ERROR);
+
+    memset(ppt_cal, 0, sizeof(*ppt_cal));
+    ppt_cal->cfg = *ppt_cfg;
+
+    for (uint32_t i = 0U; i < N; i++)
+    {
+        if (ppt_cfg->model == SU_CALIB_MODEL_PLANAR)
+        {
+            /// Prior unit circle, the held slots get no variance so they never move
+            ppt_cal->theta[i] = (i == PL_D) ? -1.0F : 0.0F;
+            ppt_cal->p[i][i]  = IS_PL_PARAM(i) ? ppt_cfg->p0 : 0.0F;
+        }
+        else
+        {
+            ppt_cal->theta[i] = (i < 3U) ? 1.0F : 0.0F;
+            ppt_cal->p[i][i]  = ppt_cfg->p0;
+        }
+    }
+
+    return RET_OK;
+}
+
+/**
+ * @brief This function adds one sample to the fit of
+ * u' * M * u + 2 * v' * u = 1, with u the sample over the radius, or of the
+ * ellipse of solve_planar() for the planar model. The
+ * statistics are the coefficients and their covariance, so the memory and
+ * the time per sample are fixed. The forgetting stops while a coefficient is
+ * not seen, so its variance never grows above the initial one.
+ */
+void su_calib_update(su_calib_t* ppt_cal, const float* ppt_v)
+{
+    ASSERT_AND_RETURN((ppt_cal == NULL) || (ppt_v == NULL), );
+
+    const float inv_r = 1.0F / ppt_cal->cfg.radius;
+    const float u0    = ppt_v[0] * inv_r;
+    const float u1    = ppt_v[1] * inv_r;
+    const float u2    = ppt_v[2] * inv_r;
+    float       phi[N] = {
+        u0 * u0, u1 * u1, u2 * u2, 2.0F * u0 * u1, 2.0F * u0 * u2, 2.0F * u1 * u2,
+        2.0F * u0, 2.0F * u1, 2.0F * u2,
+    };
+    float p_phi[N];
+    float denom = 0.0F;
+    float err   = 1.0F;
+    float max_p = 0.0F;
+
+    if (ppt_cal->cfg.model == SU_CALIB_MODEL_PLANAR)
+    {
+        /// -(x2 + y2) = a * (x2 - y2) + 2 * b * xy + 2 * v' * u + d, z left out
+        err       = -(phi[0] + phi[1]);
+        phi[PL_A] = phi[0] - phi[1];
+        phi[PL_D] = 1.0F;
+        phi[2]    = 0.0F;
+        phi[4]    = 0.0F;
+        phi[5]    = 0.0F;
+        phi[8]    = 0.0F;
+    }
+
+    for (uint32_t i = 0U; i < N; i++)
+    {
+        float acc = 0.0F;
+
+        for (uint32_t j = 0U; j < N; j++)
+        {
+            acc += ppt_cal->p[i][j] * phi[j];
+        }
+        p_phi[i]  = acc;
+        err      -= phi[i] * ppt_cal->theta[i];
+        max_p     = (ppt_cal->p[i][i] > max_p) ? ppt_cal->p[i][i] : max_p;
+    }
+
+    const float forget = (max_p < ppt_cal->cfg.p0) ? ppt_cal->cfg.forget : 1.0F;
+
+    for (uint32_t i = 0U; i < N; i++)
+    {
+        denom += phi[i] * p_phi[i];
+    }
+    denom += forget;
+    if (!(denom > 0.0F))
+    {
+        return; // Rounding lost the covariance, keep the fit as it is
+    }
+
+    const float inv_denom = 1.0F / denom;
+    const float inv_f     = 1.0F / forget;
+
+    for (uint32_t i = 0U; i < N; i++)
+    {
+        const float k = p_phi[i] * inv_denom;
+
+        ppt_cal->theta[i] += k * err;
+        for (uint32_t j = i; j < N; j++)
+        {
+            ppt_cal->p[i][j] = (ppt_cal->p[i][j] - (k * p_phi[j])) * inv_f;
+            ppt_cal->p[j][i] = ppt_cal->p[i][j];
+        }
+    }
+    ppt_cal->sample_cnt++;
+}
+
+/// Tells if every coefficient is known well enough, i.e. the samples went all around
+bool_t su_calib_is_converged(const su_calib_t* ppt_cal)
+{
+    ASSERT_AND_RETURN(ppt_cal == NULL, FALSE);
+
+    for (uint32_t i = 0U; i < N; i++)
+    {
+        if (!(ppt_cal->p[i][i] <= ppt_cal->cfg.conv_var))
+        {
+            return FALSE;
+        }
+    }
+
+    return TRUE;
+}
+
+/**
+ * @brief This function solves the fit for the transform that maps the
+ * ellipsoid back on the sphere of the radius: the offset removes the center
+ * (hard iron, bias) and the symmetric matrix the shape (soft iron, scale and
+ * cross axis), without a rotation of the frame.
+ * @param[out] ppt_corr Correction to apply after the current calibration.
+ * @return RET_OK, RET_BUSY until the fit converged or RET_ERROR if it is not
+ * a plausible ellipsoid, e.g. a saturated or disturbed sensor.
+ */
+response_status_t su_calib_solve(const su_calib_t* ppt_cal, su_affine3_t* ppt_corr)
+{
+    ASSERT_AND_RETURN((ppt_cal == NULL) || (ppt_corr == NULL), RET_PARAM_ERROR);
+
+    if (su_calib_is_converged(ppt_cal) == FALSE)
+    {
+        return RET_BUSY;
+    }
+    if (ppt_cal->cfg.model == SU_CALIB_MODEL_PLANAR)
+    {
+        return solve_planar(ppt_cal, ppt_corr);
+    }
+
+    const float* t       = ppt_cal->theta;
+    const float  m[3][3] = { { t[0], t[3], t[4] }, { t[3], t[1], t[5] }, { t[4], t[5], t[2] } };
+    float        m_inv[3][3];
+    float        c[3];
+    float        s[3][3];
+    float        w[3][3];
+    float        b[3];
+    float        k = 1.0F;
+
+    if (inv3(m, m_inv) == FALSE)
+    {
+        return RET_ERROR;
+    }
+
+    /// Center c = -M^-1 * v, then (u - c)' * M * (u - c) = 1 + c' * M * c
+    for (uint32_t i = 0U; i < 3U; i++)
+    {
+        c[i] = -((m_inv[i][0] * t[6]) + (m_inv[i][1] * t[7]) + (m_inv[i][2] * t[8]));
+    }
+    for (uint32_t i = 0U; i < 3U; i++)
+    {
+        k += c[i] * ((m[i][0] * c[0]) + (m[i][1] * c[1]) + (m[i][2] * c[2]));
+    }
+    if (!(k > 0.0F) || !(((c[0] * c[0]) + (c[1] * c[1]) + (c[2] * c[2])) < (MAX_CENTER * MAX_CENTER)))
+    {
+        return RET_ERROR;
+    }
+
+    for (uint32_t i = 0U; i < 3U; i++)
+    {
+        for (uint32_t j = 0U; j < 3U; j++)
+        {
+            s[i][j] = m[i][j] / k;
+        }
+    }
+
+    /// Positive definite by the leading minors, then the mean of the squared gains
+    const float minor2 = (s[0][0] * s[1][1]) - (s[0][1] * s[1][0]);
+    const float mean2  = (s[0][0] + s[1][1] + s[2][2]) * (1.0F / 3.0F);
+
+    if (!(s[0][0] > 0.0F) || !(minor2 > 0.0F) || !(det3(s) > 0.0F) || !(mean2 > MIN_MEAN_SCALE2)
+        || !(mean2 < MAX_MEAN_SCALE2) || (sqrt3(s, w) == FALSE))
+    {
+        return RET_ERROR;
+    }
+
+    /// y = r * W * (x / r - c) = W * x - r * W * c
+    for (uint32_t i = 0U; i < 3U; i++)
+    {
+        b[i] = -ppt_cal->cfg.radius * ((w[i][0] * c[0]) + (w[i][1] * c[1]) + (w[i][2] * c[2]));
+    }
+    su_affine3_init(ppt_corr, (const float(*)[3])w, b);
+
+    return RET_OK;
+}
@@ -0,0 +1,65 @@
+#ifndef SU_CALIB_H
+#define SU_CALIB_H
+
+/***************************************************************************************************
+ * Header files.
+ ***************************************************************************************************/
+#include "su_affine/su_affine.h"
+#include "su_common.h"
+/***************************************************************************************************
+ * Macro definitions.
+ ***************************************************************************************************/
+
+/// Coefficients of the ellipsoid: x2, y2, z2, 2xy, 2xz, 2yz, 2x, 2y, 2z, the planar model uses 5
+#define SU_CALIB_PARAM_CNT        (9U)
+/// The statistics fade over about 2000 samples, 40 s at 50 Hz
+#define SU_CALIB_DEFAULT_FORGET   (0.9995F)
+/// Weight of the prior sphere, about one sample
+#define SU_CALIB_DEFAULT_P0       (1.0F)
+/// Every coefficient known to this variance, i.e. all directions were seen
+#define SU_CALIB_DEFAULT_CONV_VAR (0.02F)
+
+/***************************************************************************************************
+ * External type declarations.
+ ***************************************************************************************************/
+
+/// What the motion of the sensor lets the fit observe
+typedef enum
+{
+    SU_CALIB_MODEL_ELLIPSOID, // The vector turns in all directions, e.g. a tumbled sensor
+    SU_CALIB_MODEL_PLANAR     // The vector turns about z only, e.g. the field in a car on a road
+} su_calib_model_t;
+
+typedef struct
+{
+    float            radius;   // Norm of the calibrated vector, e.g. 1 g, scales the statistics
+                               // The planar model takes the norm of its xy part
+    float            forget;   // Forgetting factor per sample, 1 keeps all samples
+    float            p0;       // Initial variance of the coefficients, larger trusts data sooner
+    float            conv_var; // Variance of every coefficient below which the fit is solved
+    su_calib_model_t model;
+} su_calib_cfg_t;
+
+/// Recursive least squares fit of an ellipsoid to the samples of a vector sensor
+typedef struct
+{
+    su_calib_cfg_t cfg;
+    float          theta[SU_CALIB_PARAM_CNT];
+    float          p[SU_CALIB_PARAM_CNT][SU_CALIB_PARAM_CNT]; // Covariance of theta
+    uint32_t       sample_cnt;
+} su_calib_t;
+
+/***************************************************************************************************
+ * External data declarations.
+ ***************************************************************************************************/
+
+/***************************************************************************************************
+ * External function declarations.
+ ***************************************************************************************************/
+
+response_status_t su_calib_init(su_calib_t* ppt_cal, const su_calib_cfg_t* ppt_cfg);
+void              su_calib_update(su_calib_t* ppt_cal, const float* ppt_v);
+bool_t            su_calib_is_converged(const su_calib_t* ppt_cal);
+response_status_t su_calib_solve(const su_calib_t* ppt_cal, su_affine3_t* ppt_corr);
+
+#endif /* SU_CALIB_H */
@@ -7,7 +7,8 @@
 #include "stdint.h"
 #include "su_byte_utils.h"
 
-#if !defined(TEST)
+/// Stops a debugger on the target, the unit tests and the host port go on with the error
+#if !defined(TEST) && defined(__arm__)
 #define SW_BREAK() \
     do { \
         __asm__ __volatile__("bkpt #0\n\t" : : : "memory"); \
@@ -0,0 +1,445 @@
+/***************************************************************************************************
+ * Header files.
+ ***************************************************************************************************/
+
+#include "su_fixed.h"
+
+/// Saturating instructions of the Cortex-M4 DSP extension
+#if defined(__ARM_FEATURE_DSP)
+#include "arm_acle.h"
+#endif
+
+/***************************************************************************************************
+ * Macro definitions.
+ ***************************************************************************************************/
+
+/// Quarter wave of the sine table, 128 steps of pi/256
+#define SIN_LUT_BITS  (7U)
+/// Radians in Q16.16 to a phase of 2^32 per turn, 2^16 / (2 * pi) in Q16.16
+#define RAD_TO_PHASE  (683565276LL)
+/// First guess of 1/d on [0.5, 1), 48/17 - 32/17 * d in Q2.30, then 3 Newton steps
+#define RECIP_SEED_A  (3031741621U)
+#define RECIP_SEED_B  (2021161080U)
+#define RECIP_STEPS   (3U)
+#define MAP_MAX_SHIFT (30U)
+
+/***************************************************************************************************
+ * Local type definitions.
+ ***************************************************************************************************/
+
+/***************************************************************************************************
+ * Local data definitions.
+ ***************************************************************************************************/
+
+/// sin(i * pi / 256) in Q16.16
+static const int32_t g_sin_lut[(1U << SIN_LUT_BITS) + 1U] = {
+    0,     804,   1608,  2412,  3216,  4019,  4821,  5623,  6424,  7224,  8022,  8820,  9616,
+    10411, 11204, 11996, 12785, 13573, 14359, 15143, 15924, 16703, 17479, 18253, 19024, 19792,
+    20557, 21320, 22078, 22834, 23586, 24335, 25080, 25821, 26558, 27291, 28020, 28745, 29466,
+    30182, 30893, 31600, 32303, 33000, 33692, 34380, 35062, 35738, 36410, 37076, 37736, 38391,
+    39040, 39683, 40320, 40951, 41576, 42194, 42806, 43412, 44011, 44604, 45190, 45769, 46341,
+    46906, 47464, 48015, 48559, 49095, 49624, 50146, 50660, 51166, 51665, 52156, 52639, 53114,
+    53581, 54040, 54491, 54934, 55368, 55794, 56212, 56621, 57022, 57414, 57798, 58172, 58538,
+    58896, 59244, 59583, 59914, 60235, 60547, 60851, 61145, 61429, 61705, 61971, 62228, 62476,
+    62714, 62943, 63162, 63372, 63572, 63763, 63944, 64115, 64277, 64429, 64571, 64704, 64827,
+    64940, 65043, 65137, 65220, 65294, 65358, 65413, 65457, 65492, 65516, 65531, 65536,
+};
+
+/// atan(z) = z * (a1 + a3 z^2 + a5 z^4 + a7 z^6 + a9 z^8) on [0, 1] in Q2.30, error below 1e-5
+static const int32_t g_atan_poly[] = { 22371518, -91410863, 193424926, -354656388, 1073597943 };
+
+/***************************************************************************************************
+ * Local function definitions.
+ ***************************************************************************************************/
+
+static inline int32_t sat32(int64_t p_x)
+{
+    if (p_x > INT32_MAX)
+    {
+        return INT32_MAX;
+    }
+    if (p_x < INT32_MIN)
+    {
+        return INT32_MIN;
+    }
+    return (int32_t)p_x;
+}
+
+static inline int16_t sat16(int32_t p_x)
+{
+#if defined(__ARM_FEATURE_DSP)
+    return (int16_t)__ssat(p_x, 16);
+#else
+    if (p_x > INT16_MAX)
+    {
+        return INT16_MAX;
+    }
+    if (p_x < INT16_MIN)
+    {
+        return INT16_MIN;
+    }
+    return (int16_t)p_x;
+#endif
+}
+
+static inline int32_t add_sat32(int32_t p_a, int32_t p_b)
+{
+#if defined(__ARM_FEATURE_DSP)
+    return __qadd(p_a, p_b);
+#else
+    return sat32((int64_t)p_a + p_b);
+#endif
+}
+
+static inline int32_t sub_sat32(int32_t p_a, int32_t p_b)
+{
+#if defined(__ARM_FEATURE_DSP)
+    return __qsub(p_a, p_b);
+#else
+    return sat32((int64_t)p_a - p_b);
+#endif
+}
+
+/// Product of two fixed-point values with p_frac fraction bits, rounded half up
+static inline int64_t mul_round(int32_t p_a, int32_t p_b, uint32_t p_frac)
+{
+    return (((int64_t)p_a * p_b) + (1LL << (p_frac - 1U))) >> p_frac;
+}
+
+/// Float to fixed-point with p_scale steps per unit, rounded and saturated, NaN gives 0
+static int32_t from_float(float p_x, float p_scale, int32_t p_min, int32_t p_max)
+{
+    float x = p_x * p_scale;
+
+    if (x != x)
+    {
+        return 0;
+    }
+    if (x >= (float)p_max)
+    {
+        return p_max;
+    }
+    if (x <= (float)p_min)
+    {
+        return p_min;
+    }
+    return (int32_t)(x + ((x >= 0.0F) ? 0.5F : -0.5F));
+}
+
+/// Sine of a phase of 2^32 per turn, from the quarter wave and a linear interpolation
+static su_q16_t sin_phase(uint32_t p_phase)
+{
+    const uint32_t quarter = 1UL << 30;
+    uint32_t       pos     = p_phase & (quarter - 1U);
+
+    if ((p_phase & quarter) != 0U)
+    {
+        pos = quarter - pos; // Falling quarters mirror the table, pos may reach the top entry
+    }
+
+    const uint32_t idx  = pos >> (30U - SIN_LUT_BITS);
+    const uint32_t frac = (pos >> (14U - SIN_LUT_BITS)) & 0xFFFFU;
+    int32_t        val  = g_sin_lut[idx];
+
+    if (frac != 0U)
+    {
+        val += (int32_t)(mul_round(g_sin_lut[idx + 1U] - val, (int32_t)frac, 16U));
+    }
+
+    return ((p_phase & (2UL * quarter)) != 0U) ? -val : val;
+}
+
+/***************************************************************************************************
+ * External function definitions.
+ ***************************************************************************************************/
+
+su_q15_t su_q15_add_sat(su_q15_t p_a, su_q15_t p_b)
+{
+    return sat16((int32_t)p_a + p_b);
+}
+
+su_q15_t su_q15_sub_sat(su_q15_t p_a, su_q15_t p_b)
+{
+    return sat16((int32_t)p_a - p_b);
+}
+
+/**
+ * @brief This function multiplies two Q1.15 values, rounded half up. -1 * -1
+ * saturates to the largest value.
+ */
+su_q15_t su_q15_mul(su_q15_t p_a, su_q15_t p_b)
+{
+    return sat16((((int32_t)p_a * p_b) + (1L << 14)) >> 15);
+}
+
+su_q15_t su_q15_from_float(float p_x)
+{
+    return (su_q15_t)from_float(p_x, 32768.0F, SU_Q15_MIN, SU_Q15_MAX);
+}
+
+float su_q15_to_float(su_q15_t p_x)
+{
+    return (float)p_x * (1.0F / 32768.0F);
+}
+
+su_q31_t su_q31_add_sat(su_q31_t p_a, su_q31_t p_b)
+{
+    return add_sat32(p_a, p_b);
+}
+
+su_q31_t su_q31_sub_sat(su_q31_t p_a, su_q31_t p_b)
+{
+    return sub_sat32(p_a, p_b);
+}
+
+/**
+ * @brief This function multiplies two Q1.31 values, rounded half up. -1 * -1
+ * saturates to the largest value.
+ */
+su_q31_t su_q31_mul(su_q31_t p_a, su_q31_t p_b)
+{
+    return sat32(mul_round(p_a, p_b, 31U));
+}
+
+su_q31_t su_q31_from_float(float p_x)
+{
+    return from_float(p_x, 2147483648.0F, SU_Q31_MIN, SU_Q31_MAX);
+}
+
+float su_q31_to_float(su_q31_t p_x)
+{
+    return (float)p_x * (1.0F / 2147483648.0F);
+}
+
+su_q16_t su_q16_add_sat(su_q16_t p_a, su_q16_t p_b)
+{
+    return add_sat32(p_a, p_b);
+}
+
+su_q16_t su_q16_sub_sat(su_q16_t p_a, su_q16_t p_b)
+{
+    return sub_sat32(p_a, p_b);
+}
+
+/**
+ * @brief This function multiplies two Q16.16 values, rounded half up and
+ * saturated.
+ */
+su_q16_t su_q16_mul(su_q16_t p_a, su_q16_t p_b)
+{
+    return sat32(mul_round(p_a, p_b, 16U));
+}
+
+/**
+ * @brief This function gives 1 / x without a division, a division is
+ * su_q16_mul(a, su_q16_recip(b)). The input is scaled to [0.5, 1) and its
+ * reciprocal refined by Newton steps from a linear guess. The result is
+ * within one step of the rounded reciprocal, 0 and inputs below 2^-15
+ * saturate.
+ */
+su_q16_t su_q16_recip(su_q16_t p_x)
+{
+    if (p_x == 0)
+    {
+        return SU_Q16_MAX;
+    }
+
+    const uint32_t mag   = (p_x < 0) ? (0U - (uint32_t)p_x) : (uint32_t)p_x;
+    const uint32_t shift = (uint32_t)__builtin_clz(mag);
+    const uint32_t d     = mag << shift; // Q0.32 in [0.5, 1)
+    uint32_t       r     = RECIP_SEED_A - (uint32_t)(((uint64_t)RECIP_SEED_B * d) >> 32);
+
+    for (uint32_t i = 0U; i < RECIP_STEPS; i++)
+    {
+        const uint32_t dr = (uint32_t)(((uint64_t)d * r) >> 32); // About 1 in Q2.30
+
+        r = (uint32_t)(((uint64_t)r * ((1UL << 31) - dr)) >> 30);
+    }
+
+    /// 1/x = 1/d * 2^(shift - 16), the Q16.16 result is r * 2^(shift - 30)
+    const uint64_t res = (((uint64_t)r << shift) + (1ULL << 29)) >> 30;
+
+    if (p_x < 0)
+    {
+        return (res >= (1ULL << 31)) ? SU_Q16_MIN : -(su_q16_t)res;
+    }
+    return (res > (uint64_t)SU_Q16_MAX) ? SU_Q16_MAX : (su_q16_t)res;
+}
+
+/**
+ * @brief This function gives the square root rounded to the nearest step,
+ * digit by digit. It is exact and needs no FPU, but takes about 24 loops.
+ */
+su_q16_t su_q16_sqrt(su_q16_t p_x)
+{
+    ASSERT_AND_RETURN(p_x < 0, 0);
+
+    uint64_t rem  = (uint64_t)p_x << 16;
+    uint64_t root = 0U;
+    uint64_t bit  = 1ULL << 46;
+
+    while (bit > rem)
+    {
+        bit >>= 2;
+    }
+    while (bit != 0U)
+    {
+        if (rem >= (root + bit))
+        {
+            rem  -= root + bit;
+            root  = (root >> 1) + bit;
+        }
+        else
+        {
+            root >>= 1;
+        }
+        bit >>= 2;
+    }
+
+    return (su_q16_t)((rem > root) ? (root + 1U) : root);
+}
+
+/**
+ * @brief This function gives the sine of any angle in radians, within two
+ * steps (3e-5).
+ */
+su_q16_t su_q16_sin(su_q16_t p_rad)
+{
+    return sin_phase((uint32_t)(((int64_t)p_rad * RAD_TO_PHASE) >> 16));
+}
+
+su_q16_t su_q16_cos(su_q16_t p_rad)
+{
+    return sin_phase((uint32_t)(((int64_t)p_rad * RAD_TO_PHASE) >> 16) + (1UL << 30));
+}
+
+/**
+ * @brief This function gives the angle of (x, y) in radians in [-pi, pi],
+ * within 1e-4. The smaller side over the larger one is taken with a 32 bit
+ * division and its arc tangent with a polynomial, then the octant is
+ * restored. Only the ratio of the inputs matters, so they may be in any
+ * common scale.
+ */
+su_q16_t su_q16_atan2(su_q16_t p_y, su_q16_t p_x)
+{
+    uint32_t ax = (p_x < 0) ? (0U - (uint32_t)p_x) : (uint32_t)p_x;
+    uint32_t ay = (p_y < 0) ? (0U - (uint32_t)p_y) : (uint32_t)p_y;
+
+    if ((ax == 0U) && (ay == 0U))
+    {
+        return 0;
+    }
+
+    const bool_t is_steep = (ay > ax) ? TRUE : FALSE;
+    uint32_t     hi       = is_steep ? ay : ax;
+    uint32_t     lo       = is_steep ? ax : ay;
+    const int    bits     = 32 - __builtin_clz(hi);
+
+    if (bits > 16)
+    {
+        hi >>= (uint32_t)(bits - 16); // Keeps lo << 16 in 32 bits
+        lo >>= (uint32_t)(bits - 16);
+    }
+
+    const int32_t z  = (int32_t)(((lo << 16) / hi) << 14); // Q2.30 in [0, 1]
+    const int32_t z2 = (int32_t)mul_round(z, z, 30U);
+    int32_t       p  = g_atan_poly[0];
+
+    for (uint32_t i = 1U; i < ARRAY_SIZE(g_atan_poly); i++)
+    {
+        p = (int32_t)mul_round(p, z2, 30U) + g_atan_poly[i];
+    }
+
+    su_q16_t rad = (su_q16_t)((mul_round(z, p, 30U) + (1L << 13)) >> 14);
+
+    if (is_steep)
+    {
+        rad = SU_Q16_HALF_PI - rad;
+    }
+    if (p_x < 0)
+    {
+        rad = SU_Q16_PI - rad;
+    }
+
+    return (p_y < 0) ? -rad : rad;
+}
+
+su_q16_t su_q16_from_float(float p_x)
+{
+    return from_float(p_x, 65536.0F, SU_Q16_MIN, SU_Q16_MAX);
+}
+
+float su_q16_to_float(su_q16_t p_x)
+{
+    return (float)p_x * (1.0F / 65536.0F);
+}
+
+/**
+ * @brief This function precomputes a linear mapping of [in_min, in_max] to
+ * [out_min, out_max], so each su_fixed_map() is a multiply and a shift
+ * instead of a division. The slope gets the most fraction bits that keep it
+ * in 32 bits, up to 30.
+ * @return RET_OK or RET_PARAM_ERROR for an empty input range.
+ */
+response_status_t su_fixed_map_init(su_fixed_map_t* ppt_map, int32_t p_in_min, int32_t p_in_max,
+                                    int32_t p_out_min, int32_t p_out_max)
+{
+    ASSERT_AND_RETURN((ppt_map == NULL) || (p_in_min == p_in_max), RET_PARAM_ERROR);
+
+    const int64_t in_span  = (int64_t)p_in_max - p_in_min;
+    const int64_t out_span = (int64_t)p_out_max - p_out_min;
+    uint32_t      shift    = MAP_MAX_SHIFT;
+    int64_t       slope    = 0;
+
+    for (;;)
+    {
+        const int64_t num = out_span * (1LL << shift);
+
+        /// Rounded to nearest, the signs of the spans may differ
+        slope = ((num < 0) == (in_span < 0)) ? ((num + (in_span / 2)) / in_span)
+                                             : ((num - (in_span / 2)) / in_span);
+        if (((slope <= INT32_MAX) && (slope >= INT32_MIN)) || (shift == 0U))
+        {
+            break;
+        }
+        shift--;
+    }
+
+    ppt_map->in_min  = p_in_min;
+    ppt_map->out_min = p_out_min;
+    ppt_map->in_lo   = (p_in_min < p_in_max) ? p_in_min : p_in_max;
+    ppt_map->in_hi   = (p_in_min < p_in_max) ? p_in_max : p_in_min;
+    ppt_map->slope   = sat32(slope);
+    ppt_map->shift   = (uint8_t)shift;
+
+    return RET_OK;
+}
+
+/**
+ * @brief This function maps a value with a mapping of su_fixed_map_init(),
+ * rounded to the nearest integer. Inputs out of the range are clamped to it.
+ */
+int32_t su_fixed_map(const su_fixed_map_t* ppt_map, int32_t p_in)
+{
+    ASSERT_AND_RETURN(ppt_map == NULL, 0);
+
+    int32_t in = p_in;
+
+    if (in < ppt_map->in_lo)
+    {
+        in = ppt_map->in_lo;
+    }
+    else if (in > ppt_map->in_hi)
+    {
+        in = ppt_map->in_hi;
+    }
+
+    int64_t out = ((int64_t)in - ppt_map->in_min) * ppt_map->slope;
+
+    if (ppt_map->shift != 0U)
+    {
+        out = (out + (1LL << (ppt_map->shift - 1U))) >> ppt_map->shift;
+    }
+
+    return sat32(out + ppt_map->out_min);
+}
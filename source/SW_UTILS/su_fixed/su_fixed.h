@@ -0,0 +1,82 @@
+#ifndef SU_FIXED_H
+#define SU_FIXED_H
+
+/***************************************************************************************************
+ * Header files.
+ ***************************************************************************************************/
+#include "su_common.h"
+/***************************************************************************************************
+ * Macro definitions.
+ ***************************************************************************************************/
+
+#define SU_Q15_MAX (INT16_MAX) // 1 - 2^-15
+#define SU_Q15_MIN (INT16_MIN) // -1
+#define SU_Q31_MAX (INT32_MAX) // 1 - 2^-31
+#define SU_Q31_MIN (INT32_MIN) // -1
+#define SU_Q16_MAX (INT32_MAX) // 32768 - 2^-16
+#define SU_Q16_MIN (INT32_MIN) // -32768
+#define SU_Q16_ONE (65536)
+
+/// Rounded constants for initializers, the value shall fit the format
+#define SU_Q15_CONST(x) ((su_q15_t)(((x) * 32768.0) + (((x) >= 0.0) ? 0.5 : -0.5)))
+#define SU_Q31_CONST(x) ((su_q31_t)(((x) * 2147483648.0) + (((x) >= 0.0) ? 0.5 : -0.5)))
+#define SU_Q16_CONST(x) ((su_q16_t)(((x) * 65536.0) + (((x) >= 0.0) ? 0.5 : -0.5)))
+
+#define SU_Q16_PI      (205887)
+#define SU_Q16_HALF_PI (102944)
+
+/***************************************************************************************************
+ * External type declarations.
+ ***************************************************************************************************/
+
+typedef int16_t su_q15_t; // Q1.15, [-1, 1)
+typedef int32_t su_q31_t; // Q1.31, [-1, 1)
+typedef int32_t su_q16_t; // Q16.16, [-32768, 32768)
+
+/// y = out_min + (x - in_min) * slope, the slope is kept with as many fraction bits as fit
+typedef struct
+{
+    int32_t in_min;
+    int32_t out_min;
+    int32_t in_lo; // Clamp of the input, the lower of in_min and in_max
+    int32_t in_hi;
+    int32_t slope;
+    uint8_t shift; // Fraction bits of the slope
+} su_fixed_map_t;
+
+/***************************************************************************************************
+ * External data declarations.
+ ***************************************************************************************************/
+
+/***************************************************************************************************
+ * External function declarations.
+ ***************************************************************************************************/
+
+su_q15_t su_q15_add_sat(su_q15_t p_a, su_q15_t p_b);
+su_q15_t su_q15_sub_sat(su_q15_t p_a, su_q15_t p_b);
+su_q15_t su_q15_mul(su_q15_t p_a, su_q15_t p_b);
+su_q15_t su_q15_from_float(float p_x);
+float    su_q15_to_float(su_q15_t p_x);
+
+su_q31_t su_q31_add_sat(su_q31_t p_a, su_q31_t p_b);
+su_q31_t su_q31_sub_sat(su_q31_t p_a, su_q31_t p_b);
+su_q31_t su_q31_mul(su_q31_t p_a, su_q31_t p_b);
+su_q31_t su_q31_from_float(float p_x);
+float    su_q31_to_float(su_q31_t p_x);
+
+su_q16_t su_q16_add_sat(su_q16_t p_a, su_q16_t p_b);
+su_q16_t su_q16_sub_sat(su_q16_t p_a, su_q16_t p_b);
+su_q16_t su_q16_mul(su_q16_t p_a, su_q16_t p_b);
+su_q16_t su_q16_recip(su_q16_t p_x);
+su_q16_t su_q16_sqrt(su_q16_t p_x);
+su_q16_t su_q16_sin(su_q16_t p_rad);
+su_q16_t su_q16_cos(su_q16_t p_rad);
+su_q16_t su_q16_atan2(su_q16_t p_y, su_q16_t p_x);
+su_q16_t su_q16_from_float(float p_x);
+float    su_q16_to_float(su_q16_t p_x);
+
+response_status_t su_fixed_map_init(su_fixed_map_t* ppt_map, int32_t p_in_min, int32_t p_in_max,
+                                    int32_t p_out_min, int32_t p_out_max);
+int32_t           su_fixed_map(const su_fixed_map_t* ppt_map, int32_t p_in);
+
+#endif /* SU_FIXED_H */
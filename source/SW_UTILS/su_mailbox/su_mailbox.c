@@ -0,0 +1,117 @@
+/***************************************************************************************************
+ * Header files.
+ ***************************************************************************************************/
+
+#include "su_mailbox.h"
+
+#include "string.h"
+
+/***************************************************************************************************
+ * Macro definitions.
+ ***************************************************************************************************/
+
+/***************************************************************************************************
+ * Local type definitions.
+ ***************************************************************************************************/
+
+/***************************************************************************************************
+ * Local data definitions.
+ ***************************************************************************************************/
+
+/***************************************************************************************************
+ * Local function definitions.
+ ***************************************************************************************************/
+
+/***************************************************************************************************
+ * External function definitions.
+ ***************************************************************************************************/
+
+/**
+ * @brief This function sets up a mailbox on its storage, the value is
+ * cleared and nothing is published yet.
+ * @param[in] ppt_storage The value, p_size bytes kept for the mailbox only.
+ */
+response_status_t su_mailbox_init(su_mailbox_t* ppt_mb, void* ppt_storage, uint32_t p_size)
+{
+    ASSERT_AND_RETURN((ppt_mb == NULL) || (ppt_storage == NULL) || (p_size == 0U),
+                      RET_PARAM_ERROR);
+
+    memset(ppt_storage, 0, p_size);
+    ppt_mb->data = ppt_storage;
+    ppt_mb->size = p_size;
+    __atomic_store_n(&ppt_mb->seq, 0U, __ATOMIC_RELEASE);
+
+    return RET_OK;
+}
+
+/**
+ * @brief This function publishes a value. The writer never waits, a reader
+ * that overlaps the copy retries. There shall be one writer per mailbox,
+ * e.g. one ISR.
+ */
+void su_mailbox_write(su_mailbox_t* ppt_mb, const void* ppt_value)
+{
+    ASSERT_AND_RETURN((ppt_mb == NULL) || (ppt_value == NULL), );
+
+    void* pt_data = su_mailbox_write_begin(ppt_mb);
+
+    memcpy(pt_data, ppt_value, ppt_mb->size);
+    su_mailbox_write_end(ppt_mb);
+}
+
+/**
+ * @brief This function opens the value for an update in place, the writer
+ * may read and change any part of it until su_mailbox_write_end().
+ * @return The value to update.
+ */
+void* su_mailbox_write_begin(su_mailbox_t* ppt_mb)
+{
+    ASSERT_AND_RETURN(ppt_mb == NULL, NULL);
+
+    const uint32_t seq = ppt_mb->seq; // Only the writer changes it
+
+    __atomic_store_n(&ppt_mb->seq, seq + 1U, __ATOMIC_RELAXED);
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+
+    return ppt_mb->data;
+}
+
+/// Publishes the value updated since su_mailbox_write_begin()
+void su_mailbox_write_end(su_mailbox_t* ppt_mb)
+{
+    ASSERT_AND_RETURN(ppt_mb == NULL, );
+
+    __atomic_store_n(&ppt_mb->seq, ppt_mb->seq + 1U, __ATOMIC_RELEASE);
+}
+
+/**
+ * @brief This function copies the latest value. A write that overlaps the
+ * copy is detected by the sequence and the copy is repeated, so the value is
+ * never torn and the reader never blocks the writer. It shall not be called
+ * from a context preempting the writer, the copy would never end.
+ * @return Sequence of the value, it changes with every write and is 0 before
+ * the first one.
+ */
+uint32_t su_mailbox_read(const su_mailbox_t* ppt_mb, void* ppt_value)
+{
+    ASSERT_AND_RETURN((ppt_mb == NULL) || (ppt_value == NULL), 0U);
+
+    uint32_t seq = 0U;
+
+    do
+    {
+        seq = __atomic_load_n(&ppt_mb->seq, __ATOMIC_ACQUIRE);
+        memcpy(ppt_value, ppt_mb->data, ppt_mb->size);
+        __atomic_thread_fence(__ATOMIC_ACQUIRE);
+    } while (((seq & 1U) != 0U) || (seq != __atomic_load_n(&ppt_mb->seq, __ATOMIC_RELAXED)));
+
+    return seq;
+}
+
+/// Gives the sequence without copying the value, to tell if a new one came, odd during a write
+uint32_t su_mailbox_get_seq(const su_mailbox_t* ppt_mb)
+{
+    ASSERT_AND_RETURN(ppt_mb == NULL, 0U);
+
+    return __atomic_load_n(&ppt_mb->seq, __ATOMIC_ACQUIRE);
+}
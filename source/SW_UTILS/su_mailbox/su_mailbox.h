@@ -0,0 +1,39 @@
+#ifndef SU_MAILBOX_H
+#define SU_MAILBOX_H
+
+/***************************************************************************************************
+ * Header files.
+ ***************************************************************************************************/
+#include "su_common.h"
+/***************************************************************************************************
+ * Macro definitions.
+ ***************************************************************************************************/
+
+/***************************************************************************************************
+ * External type declarations.
+ ***************************************************************************************************/
+
+/// Latest value of a struct shared by one writer with any readers, under a sequence lock
+typedef struct
+{
+    volatile uint32_t seq;  // Odd while the writer copies a value in, 0 before the first one
+    void*             data; // The value, changed by the writer only
+    uint32_t          size;
+} su_mailbox_t;
+
+/***************************************************************************************************
+ * External data declarations.
+ ***************************************************************************************************/
+
+/***************************************************************************************************
+ * External function declarations.
+ ***************************************************************************************************/
+
+response_status_t su_mailbox_init(su_mailbox_t* ppt_mb, void* ppt_storage, uint32_t p_size);
+void              su_mailbox_write(su_mailbox_t* ppt_mb, const void* ppt_value);
+void*             su_mailbox_write_begin(su_mailbox_t* ppt_mb);
+void              su_mailbox_write_end(su_mailbox_t* ppt_mb);
+uint32_t          su_mailbox_read(const su_mailbox_t* ppt_mb, void* ppt_value);
+uint32_t          su_mailbox_get_seq(const su_mailbox_t* ppt_mb);
+
+#endif /* SU_MAILBOX_H */
@@ -0,0 +1,179 @@
+/***************************************************************************************************
+ * Header files.
+ ***************************************************************************************************/
+
+#include "su_profiler.h"
+
+#include "string.h"
+
+/***************************************************************************************************
+ * Macro definitions.
+ ***************************************************************************************************/
+
+/***************************************************************************************************
+ * Local type definitions.
+ ***************************************************************************************************/
+
+/***************************************************************************************************
+ * Local data definitions.
+ ***************************************************************************************************/
+
+static const char* const g_probe_names[SU_PROF_PROBE_CNT] = {
+    [SU_PROF_IDLE]        = "idle",
+    [SU_PROF_ISR_TIM2]    = "TIM2_IRQ",
+    [SU_PROF_ISR_DMA2_S7] = "DMA2_S7_IRQ",
+    [SU_PROF_ISR_EXTI0]   = "EXTI0_IRQ",
+    [SU_PROF_IIC_XFER]    = "iic_xfer",
+};
+
+static su_prof_clock_t g_pt_clock = NULL;
+static uint32_t        g_enter_cycles[SU_PROF_PROBE_CNT];
+static su_prof_stats_t g_stats[SU_PROF_PROBE_CNT];
+
+/***************************************************************************************************
+ * Local function definitions.
+ ***************************************************************************************************/
+
+static uint32_t hist_bin(uint32_t p_cycles)
+{
+    uint32_t msb = (p_cycles == 0U) ? 0U : (31U - (uint32_t)__builtin_clz(p_cycles));
+
+    if (msb < SU_PROF_HIST_FIRST_BIT)
+    {
+        return 0U;
+    }
+    msb -= SU_PROF_HIST_FIRST_BIT;
+
+    return (msb < SU_PROF_HIST_BINS) ? msb : (SU_PROF_HIST_BINS - 1U);
+}
+
+/***************************************************************************************************
+ * External data definitions.
+ ***************************************************************************************************/
+
+/***************************************************************************************************
+ * External function definitions.
+ ***************************************************************************************************/
+
+/**
+ * @brief This function sets the clock of the probes and clears all tables.
+ * Probes hit before the clock is set are ignored.
+ * @param[in] ppt_clock Free running 32Bit cycle counter, e.g. the DWT.
+ */
+void su_prof_init(su_prof_clock_t ppt_clock)
+{
+    g_pt_clock = NULL;
+    memset(g_enter_cycles, 0, sizeof(g_enter_cycles));
+    su_prof_reset();
+    g_pt_clock = ppt_clock;
+}
+
+void su_prof_enter(su_prof_probe_t p_probe)
+{
+    if ((g_pt_clock == NULL) || (p_probe >= SU_PROF_PROBE_CNT))
+    {
+        return;
+    }
+
+    g_enter_cycles[p_probe] = g_pt_clock();
+}
+
+/**
+ * @brief This function closes a probe and adds the cycles since its enter to
+ * the statistics. The time of interrupts preempting the section is included.
+ */
+void su_prof_exit(su_prof_probe_t p_probe)
+{
+    if ((g_pt_clock == NULL) || (p_probe >= SU_PROF_PROBE_CNT))
+    {
+        return;
+    }
+
+    uint32_t         cycles   = g_pt_clock() - g_enter_cycles[p_probe];
+    su_prof_stats_t* pt_stats = &g_stats[p_probe];
+
+    pt_stats->cnt++;
+    pt_stats->total_cycles += cycles;
+    pt_stats->hist[hist_bin(cycles)]++;
+    if (cycles < pt_stats->min_cycles)
+    {
+        pt_stats->min_cycles = cycles;
+    }
+    if (cycles > pt_stats->max_cycles)
+    {
+        pt_stats->max_cycles = cycles;
+    }
+}
+
+uint32_t su_prof_now(void)
+{
+    return (g_pt_clock != NULL) ? g_pt_clock() : 0U;
+}
+
+/**
+ * @brief This function copies the statistics of a probe. Probes are updated
+ * from interrupts, a copy taken while one finishes may mix two runs.
+ * @return Result of the execution status.
+ */
+response_status_t su_prof_get_stats(su_prof_probe_t p_probe, su_prof_stats_t* ppt_stats)
+{
+    ASSERT_AND_RETURN(p_probe >= SU_PROF_PROBE_CNT, RET_PARAM_ERROR);
+    ASSERT_AND_RETURN(ppt_stats == NULL, RET_PARAM_ERROR);
+
+    *ppt_stats = g_stats[p_probe];
+    if (ppt_stats->cnt == 0U)
+    {
+        ppt_stats->min_cycles = 0U;
+    }
+
+    return RET_OK;
+}
+
+/**
+ * @brief This function estimates a percentile from the histogram.
+ * @param[in] ppt_stats Statistics of a probe.
+ * @param[in] p_percent Share of the runs, 1 to 100.
+ * @return Upper bound in cycles of the bin holding the percentile, at most the
+ * longest run.
+ */
+uint32_t su_prof_percentile(const su_prof_stats_t* ppt_stats, uint32_t p_percent)
+{
+    ASSERT_AND_RETURN(ppt_stats == NULL, 0U);
+    ASSERT_AND_RETURN((p_percent == 0U) || (p_percent > 100U), 0U);
+
+    uint64_t rank  = (((uint64_t)ppt_stats->cnt * p_percent) + 99U) / 100U;
+    uint64_t seen  = 0U;
+    uint32_t bound = ppt_stats->max_cycles;
+
+    for (uint32_t i = 0U; i < (SU_PROF_HIST_BINS - 1U); i++)
+    {
+        seen += ppt_stats->hist[i];
+        if (seen >= rank)
+        {
+            bound = 1UL << (SU_PROF_HIST_FIRST_BIT + i + 1U);
+            break;
+        }
+    }
+
+    return (bound < ppt_stats->max_cycles) ? bound : ppt_stats->max_cycles;
+}
+
+const char* su_prof_get_name(su_prof_probe_t p_probe)
+{
+    ASSERT_AND_RETURN(p_probe >= SU_PROF_PROBE_CNT, "");
+
+    return g_probe_names[p_probe];
+}
+
+/**
+ * @brief This function clears the statistics of all probes, e.g. at the start
+ * of a measurement window. Probes that are open keep running.
+ */
+void su_prof_reset(void)
+{
+    memset(g_stats, 0, sizeof(g_stats));
+    for (uint32_t i = 0U; i < SU_PROF_PROBE_CNT; i++)
+    {
+        g_stats[i].min_cycles = UINT32_MAX;
+    }
+}
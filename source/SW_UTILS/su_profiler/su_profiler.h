@@ -0,0 +1,70 @@
+#ifndef SU_PROFILER_H
+#define SU_PROFILER_H
+
+/***************************************************************************************************
+ * Header files.
+ ***************************************************************************************************/
+#include "su_common.h"
+/***************************************************************************************************
+ * Macro definitions.
+ ***************************************************************************************************/
+
+/// Histogram bin n counts runs of [2^(n + 6), 2^(n + 7)) cycles, the first and
+/// the last bin also take the shorter and the longer runs
+#define SU_PROF_HIST_BINS      (12U)
+#define SU_PROF_HIST_FIRST_BIT (6U)
+
+/// Probe points, they cost two clock reads and are compiled out with SU_PROFILER_DISABLE
+#if !defined(SU_PROFILER_DISABLE)
+#define SU_PROF_ENTER(p_probe) su_prof_enter(p_probe)
+#define SU_PROF_EXIT(p_probe)  su_prof_exit(p_probe)
+#else
+#define SU_PROF_ENTER(p_probe) ((void)0)
+#define SU_PROF_EXIT(p_probe)  ((void)0)
+#endif
+
+/***************************************************************************************************
+ * External type declarations.
+ ***************************************************************************************************/
+
+/// Each probe measures one code section that cannot preempt itself
+typedef enum
+{
+    SU_PROF_IDLE = 0,    // core sleeping, gives the CPU load
+    SU_PROF_ISR_TIM2,    // free running timer, app timer alarm
+    SU_PROF_ISR_DMA2_S7, // USART1 TX DMA of the logger
+    SU_PROF_ISR_EXTI0,   // BMP388 data ready
+    SU_PROF_IIC_XFER,    // blocking I2C transfer
+    SU_PROF_PROBE_CNT,
+} su_prof_probe_t;
+
+/// Returns a free running 32Bit cycle counter
+typedef uint32_t (*su_prof_clock_t)(void);
+
+typedef struct
+{
+    uint32_t cnt;
+    uint32_t min_cycles;
+    uint32_t max_cycles;
+    uint64_t total_cycles;
+    uint32_t hist[SU_PROF_HIST_BINS];
+} su_prof_stats_t;
+
+/***************************************************************************************************
+ * External data declarations.
+ ***************************************************************************************************/
+
+/***************************************************************************************************
+ * External function declarations.
+ ***************************************************************************************************/
+
+void              su_prof_init(su_prof_clock_t ppt_clock);
+void              su_prof_enter(su_prof_probe_t p_probe);
+void              su_prof_exit(su_prof_probe_t p_probe);
+uint32_t          su_prof_now(void);
+response_status_t su_prof_get_stats(su_prof_probe_t p_probe, su_prof_stats_t* ppt_stats);
+uint32_t          su_prof_percentile(const su_prof_stats_t* ppt_stats, uint32_t p_percent);
+const char*       su_prof_get_name(su_prof_probe_t p_probe);
+void              su_prof_reset(void);
+
+#endif /* SU_PROFILER_H */
@@ -0,0 +1,113 @@
+/***************************************************************************************************
+ * Header files.
+ ***************************************************************************************************/
+
+#include "su_rc.h"
+
+/***************************************************************************************************
+ * Macro definitions.
+ ***************************************************************************************************/
+
+/// Full deflection of a stick before the expo curve, a power of 2 for the table steps
+#define DEFL_FULL      (1 << 15)
+/// Bits of the deflection below one step of the expo table
+#define EXPO_FRAC_BITS (10U)
+
+/***************************************************************************************************
+ * Local type definitions.
+ ***************************************************************************************************/
+
+/***************************************************************************************************
+ * Local data definitions.
+ ***************************************************************************************************/
+
+/***************************************************************************************************
+ * Local function definitions.
+ ***************************************************************************************************/
+
+/***************************************************************************************************
+ * External function definitions.
+ ***************************************************************************************************/
+
+/**
+ * @brief This function compiles the calibration of a channel: one precomputed
+ * slope on each side of the neutral zone and the table of the expo curve
+ * y = (1 - expo) * x + expo * x^3.
+ * @return RET_OK or RET_PARAM_ERROR if the neutral zone does not leave a
+ * travel on both sides or the expo is out of [0, 1].
+ */
+response_status_t su_rc_init(su_rc_t* ppt_rc, const su_rc_cfg_t* ppt_cfg)
+{
+    ASSERT_AND_RETURN((ppt_rc == NULL) || (ppt_cfg == NULL), RET_PARAM_ERROR);
+
+    const int32_t db_lo_us = (int32_t)ppt_cfg->center_us - ppt_cfg->deadband_us;
+    const int32_t db_hi_us = (int32_t)ppt_cfg->center_us + ppt_cfg->deadband_us;
+
+    ASSERT_AND_RETURN((ppt_cfg->min_us >= db_lo_us) || (ppt_cfg->max_us <= db_hi_us),
+                      RET_PARAM_ERROR);
+    ASSERT_AND_RETURN(!((ppt_cfg->expo >= 0.0F) && (ppt_cfg->expo <= 1.0F)), RET_PARAM_ERROR);
+
+    response_status_t ret_val = su_fixed_map_init(&ppt_rc->lo,
+                                                  db_lo_us,
+                                                  ppt_cfg->min_us,
+                                                  0,
+                                                  DEFL_FULL);
+
+    ret_val |= su_fixed_map_init(&ppt_rc->hi, db_hi_us, ppt_cfg->max_us, 0, DEFL_FULL);
+
+    ppt_rc->db_lo_us = db_lo_us;
+    ppt_rc->db_hi_us = db_hi_us;
+
+    for (uint32_t i = 0U; i < SU_RC_EXPO_LUT_CNT; i++)
+    {
+        const float x = (float)i / (float)(SU_RC_EXPO_LUT_CNT - 1U);
+        const float y = ((1.0F - ppt_cfg->expo) * x) + (ppt_cfg->expo * x * x * x);
+
+        ppt_rc->expo_lut[i] = (su_q15_t)((y * (float)SU_Q15_MAX) + 0.5F);
+    }
+
+    return ret_val;
+}
+
+/**
+ * @brief This function gives the normalized position of a stick from its
+ * pulse, -1 to 1 in Q15 with 0 over the whole neutral zone. Pulses beyond
+ * the calibration are clamped, a lost link (0 us) reads as the low end so
+ * the caller shall check the freshness of the pulse first.
+ */
+su_q15_t su_rc_normalize(const su_rc_t* ppt_rc, uint32_t p_pulse_us)
+{
+    ASSERT_AND_RETURN(ppt_rc == NULL, 0);
+
+    const int32_t pulse_us = (p_pulse_us > UINT16_MAX) ? (int32_t)UINT16_MAX : (int32_t)p_pulse_us;
+    int32_t       defl     = 0;
+
+    if (pulse_us < ppt_rc->db_lo_us)
+    {
+        defl = su_fixed_map(&ppt_rc->lo, pulse_us);
+    }
+    else if (pulse_us > ppt_rc->db_hi_us)
+    {
+        defl = su_fixed_map(&ppt_rc->hi, pulse_us);
+    }
+    else
+    {
+        return 0;
+    }
+
+    /// The full deflection is the end of the last step. The curve is monotonic,
+    /// the interpolation stays between the two points
+    uint32_t idx = (uint32_t)defl >> EXPO_FRAC_BITS;
+
+    if (idx > (SU_RC_EXPO_LUT_CNT - 2U))
+    {
+        idx = SU_RC_EXPO_LUT_CNT - 2U;
+    }
+
+    const int32_t frac = defl - (int32_t)(idx << EXPO_FRAC_BITS);
+    const int32_t y0   = ppt_rc->expo_lut[idx];
+    const int32_t step = ppt_rc->expo_lut[idx + 1U] - y0;
+    const int32_t y    = y0 + (((step * frac) + (1 << (EXPO_FRAC_BITS - 1U))) >> EXPO_FRAC_BITS);
+
+    return (su_q15_t)((pulse_us < ppt_rc->db_lo_us) ? -y : y);
+}
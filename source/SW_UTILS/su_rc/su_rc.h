@@ -0,0 +1,51 @@
+#ifndef SU_RC_H
+#define SU_RC_H
+
+/***************************************************************************************************
+ * Header files.
+ ***************************************************************************************************/
+#include "su_common.h"
+#include "su_fixed/su_fixed.h"
+/***************************************************************************************************
+ * Macro definitions.
+ ***************************************************************************************************/
+
+/// Points of the expo curve from the neutral to the end of the stick
+#define SU_RC_EXPO_LUT_CNT (33U)
+
+/***************************************************************************************************
+ * External type declarations.
+ ***************************************************************************************************/
+
+/// Calibration of one channel, as measured on the receiver
+typedef struct
+{
+    uint16_t min_us;      // Pulse at the low end of the stick
+    uint16_t center_us;   // Pulse at the neutral
+    uint16_t max_us;      // Pulse at the high end of the stick
+    uint16_t deadband_us; // Half width of the neutral zone around center_us
+    float    expo;        // 0 linear to 1 cubic, softer around the neutral
+} su_rc_cfg_t;
+
+/// Calibration compiled for su_rc_normalize(), no division nor float at run time
+typedef struct
+{
+    su_fixed_map_t lo;       // center_us - deadband_us down to min_us, to 0 .. 2^15
+    su_fixed_map_t hi;       // center_us + deadband_us up to max_us, to 0 .. 2^15
+    int32_t        db_lo_us; // Neutral zone
+    int32_t        db_hi_us;
+    su_q15_t       expo_lut[SU_RC_EXPO_LUT_CNT]; // Curve of the stick deflection, every 1/32
+} su_rc_t;
+
+/***************************************************************************************************
+ * External data declarations.
+ ***************************************************************************************************/
+
+/***************************************************************************************************
+ * External function declarations.
+ ***************************************************************************************************/
+
+response_status_t su_rc_init(su_rc_t* ppt_rc, const su_rc_cfg_t* ppt_cfg);
+su_q15_t          su_rc_normalize(const su_rc_t* ppt_rc, uint32_t p_pulse_us);
+
+#endif /* SU_RC_H */
@@ -0,0 +1,259 @@
+/***************************************************************************************************
+ * Header files.
+ ***************************************************************************************************/
+
+#include "su_rec.h"
+
+#include "string.h"
+
+/***************************************************************************************************
+ * Macro definitions.
+ ***************************************************************************************************/
+
+/// Port and memory size share a byte, the size is 0, 1 or 2 bytes
+#define REC_MEM_SIZE_MSK   (0x03U)
+#define REC_PORT_SHIFT     (2U)
+#define REC_VARINT_MAX_LEN (5U)
+
+/***************************************************************************************************
+ * Local type definitions.
+ ***************************************************************************************************/
+
+/***************************************************************************************************
+ * Local data definitions.
+ ***************************************************************************************************/
+
+/***************************************************************************************************
+ * Local function definitions.
+ ***************************************************************************************************/
+
+/// Writes 7 bits per byte, low bits first, the top bit tells another byte follows
+static size_t put_varint(uint8_t* ppt_out, uint32_t p_value)
+{
+    size_t len = 0U;
+
+    while (p_value >= 0x80U)
+    {
+        ppt_out[len++]   = (uint8_t)(p_value | 0x80U);
+        p_value        >>= 7U;
+    }
+    ppt_out[len++] = (uint8_t)p_value;
+
+    return len;
+}
+
+static bool_t get_varint(su_rec_reader_t* ppt_reader, uint32_t* ppt_value)
+{
+    uint32_t value = 0U;
+
+    for (uint32_t i = 0U; i < REC_VARINT_MAX_LEN; i++)
+    {
+        if (ppt_reader->pos >= ppt_reader->len)
+        {
+            return FALSE;
+        }
+
+        uint8_t byte = ppt_reader->pt_buf[ppt_reader->pos++];
+
+        value |= (uint32_t)(byte & 0x7FU) << (7U * i);
+        if ((byte & 0x80U) == 0U)
+        {
+            *ppt_value = value;
+            return TRUE;
+        }
+    }
+
+    return FALSE;
+}
+
+static bool_t get_byte(su_rec_reader_t* ppt_reader, uint8_t* ppt_value)
+{
+    if (ppt_reader->pos >= ppt_reader->len)
+    {
+        return FALSE;
+    }
+    *ppt_value = ppt_reader->pt_buf[ppt_reader->pos++];
+
+    return TRUE;
+}
+
+static bool_t read_iic(su_rec_reader_t* ppt_reader, su_rec_event_t* ppt_event)
+{
+    uint8_t  port_size = 0U;
+    uint32_t mem_addr  = 0U;
+    uint32_t len       = 0U;
+
+    if ((get_byte(ppt_reader, &port_size) == FALSE)
+        || (get_byte(ppt_reader, &ppt_event->iic.dev_addr) == FALSE))
+    {
+        return FALSE;
+    }
+    ppt_event->iic.port     = port_size >> REC_PORT_SHIFT;
+    ppt_event->iic.mem_size = port_size & REC_MEM_SIZE_MSK;
+    if ((ppt_event->iic.mem_size != 0U) && (get_varint(ppt_reader, &mem_addr) == FALSE))
+    {
+        return FALSE;
+    }
+    if ((get_varint(ppt_reader, &len) == FALSE) || (len > SU_REC_MAX_DATA_LEN)
+        || (len > (ppt_reader->len - ppt_reader->pos)))
+    {
+        return FALSE;
+    }
+    ppt_event->iic.mem_addr  = (uint16_t)mem_addr;
+    ppt_event->iic.len       = (uint16_t)len;
+    ppt_event->iic.pt_data   = &ppt_reader->pt_buf[ppt_reader->pos];
+    ppt_reader->pos         += len;
+
+    return TRUE;
+}
+
+/***************************************************************************************************
+ * External function definitions.
+ ***************************************************************************************************/
+
+/**
+ * @brief This function writes the file header that starts every recording.
+ * @return Bytes written, 0 if `p_size` is too small.
+ */
+size_t su_rec_write_header(uint8_t* ppt_out, size_t p_size)
+{
+    ASSERT_AND_RETURN(ppt_out == NULL, 0U);
+
+    if (p_size < SU_REC_HDR_LEN)
+    {
+        return 0U;
+    }
+    memcpy(ppt_out, SU_REC_MAGIC, SU_REC_HDR_LEN - 1U);
+    ppt_out[SU_REC_HDR_LEN - 1U] = SU_REC_VERSION;
+
+    return SU_REC_HDR_LEN;
+}
+
+/**
+ * @brief This function encodes one event. The time is stored as the step from
+ * the previous record, so a capture every 20 ms costs 3 bytes of time.
+ * @param[in] p_prev_us Time of the previous record, the header time is 0.
+ * @return Bytes written, 0 if the record does not fit in `p_size` or the
+ * event is invalid.
+ */
+size_t su_rec_encode(const su_rec_event_t* ppt_event, uint32_t p_prev_us, uint8_t* ppt_out,
+                     size_t p_size)
+{
+    ASSERT_AND_RETURN((ppt_event == NULL) || (ppt_out == NULL), 0U);
+
+    uint8_t meta[SU_REC_MAX_META_LEN];
+    size_t  len = 0U;
+
+    meta[len++]  = (uint8_t)ppt_event->type;
+    len         += put_varint(&meta[len], ppt_event->t_us - p_prev_us);
+
+    switch (ppt_event->type)
+    {
+        case SU_REC_IIC_READ:
+            if ((ppt_event->iic.len > SU_REC_MAX_DATA_LEN)
+                || (ppt_event->iic.mem_size > REC_MEM_SIZE_MSK)
+                || ((ppt_event->iic.len > 0U) && (ppt_event->iic.pt_data == NULL)))
+            {
+                return 0U;
+            }
+            meta[len++] = (uint8_t)((ppt_event->iic.port << REC_PORT_SHIFT)
+                                    | ppt_event->iic.mem_size);
+            meta[len++] = ppt_event->iic.dev_addr;
+            if (ppt_event->iic.mem_size != 0U)
+            {
+                len += put_varint(&meta[len], ppt_event->iic.mem_addr);
+            }
+            len += put_varint(&meta[len], ppt_event->iic.len);
+            if ((len + ppt_event->iic.len) > p_size)
+            {
+                return 0U;
+            }
+            memcpy(&ppt_out[len], ppt_event->iic.pt_data, ppt_event->iic.len);
+            memcpy(ppt_out, meta, len);
+            return len + ppt_event->iic.len;
+        case SU_REC_CAPTURE:
+            meta[len++]  = ppt_event->capture.channel;
+            len         += put_varint(&meta[len], ppt_event->capture.value);
+            if (len > p_size)
+            {
+                return 0U;
+            }
+            memcpy(ppt_out, meta, len);
+            return len;
+        default:
+            return 0U;
+    }
+}
+
+/**
+ * @brief This function starts reading a recording held in memory.
+ * @retval `RET_NOT_SUPPORTED` if the header or its version is unknown.
+ */
+response_status_t su_rec_reader_init(su_rec_reader_t* ppt_reader, const uint8_t* ppt_buf,
+                                     size_t p_len)
+{
+    ASSERT_AND_RETURN((ppt_reader == NULL) || (ppt_buf == NULL), RET_PARAM_ERROR);
+
+    if ((p_len < SU_REC_HDR_LEN) || (memcmp(ppt_buf, SU_REC_MAGIC, SU_REC_HDR_LEN - 1U) != 0)
+        || (ppt_buf[SU_REC_HDR_LEN - 1U] != SU_REC_VERSION))
+    {
+        return RET_NOT_SUPPORTED;
+    }
+    ppt_reader->pt_buf = ppt_buf;
+    ppt_reader->len    = p_len;
+    ppt_reader->pos    = SU_REC_HDR_LEN;
+    ppt_reader->t_us   = 0U;
+
+    return RET_OK;
+}
+
+/**
+ * @brief This function decodes the next event. The data of an I2C read points
+ * into the recording, it stays valid as long as the recording.
+ * @retval `RET_NOT_FOUND` at the end of the recording.
+ * @retval `RET_ERROR` if the record is cut off or of an unknown type, the
+ * reader stays at that record.
+ */
+response_status_t su_rec_read(su_rec_reader_t* ppt_reader, su_rec_event_t* ppt_event)
+{
+    ASSERT_AND_RETURN((ppt_reader == NULL) || (ppt_event == NULL), RET_PARAM_ERROR);
+
+    size_t   start = ppt_reader->pos;
+    uint8_t  type  = 0U;
+    uint32_t dt_us = 0U;
+    bool_t   is_ok = FALSE;
+
+    if (ppt_reader->pos >= ppt_reader->len)
+    {
+        return RET_NOT_FOUND;
+    }
+
+    memset(ppt_event, 0, sizeof(*ppt_event));
+    if ((get_byte(ppt_reader, &type) == TRUE) && (get_varint(ppt_reader, &dt_us) == TRUE))
+    {
+        ppt_event->type = (su_rec_type_t)type;
+        switch (type)
+        {
+            case SU_REC_IIC_READ:
+                is_ok = read_iic(ppt_reader, ppt_event);
+                break;
+            case SU_REC_CAPTURE:
+                is_ok = get_byte(ppt_reader, &ppt_event->capture.channel);
+                is_ok = (is_ok == TRUE) ? get_varint(ppt_reader, &ppt_event->capture.value)
+                                        : FALSE;
+                break;
+            default:
+                break;
+        }
+    }
+
+    if (is_ok == FALSE)
+    {
+        ppt_reader->pos = start;
+        return RET_ERROR;
+    }
+    ppt_reader->t_us += dt_us;
+    ppt_event->t_us   = ppt_reader->t_us;
+
+    return RET_OK;
+}
@@ -0,0 +1,80 @@
+#ifndef SU_REC_H
+#define SU_REC_H
+
+/***************************************************************************************************
+ * Header files.
+ ***************************************************************************************************/
+#include "su_common.h"
+/***************************************************************************************************
+ * Macro definitions.
+ ***************************************************************************************************/
+
+/// A recording starts with "SREC" and the format version
+#define SU_REC_MAGIC          "SREC"
+#define SU_REC_VERSION        (1U)
+#define SU_REC_HDR_LEN        (5U)
+/// Longest register read kept in one record, an ICM FIFO batch fits
+#define SU_REC_MAX_DATA_LEN   (512U)
+/// Type, time step, port and memory size, address, memory address and length
+#define SU_REC_MAX_META_LEN   (1U + 5U + 1U + 1U + 3U + 2U)
+#define SU_REC_MAX_RECORD_LEN (SU_REC_MAX_META_LEN + SU_REC_MAX_DATA_LEN)
+
+/***************************************************************************************************
+ * External type declarations.
+ ***************************************************************************************************/
+
+typedef enum
+{
+    SU_REC_IIC_READ = 1, // Bytes returned by a successful I2C read
+    SU_REC_CAPTURE,      // Value reported by an input capture channel
+    SU_REC_TYPE_CNT
+} su_rec_type_t;
+
+/// One recorded input, time is the free running microsecond counter
+typedef struct
+{
+    su_rec_type_t type;
+    uint32_t      t_us;
+    union
+    {
+        struct
+        {
+            uint8_t        port;
+            uint8_t        dev_addr;
+            uint8_t        mem_size; // 0 for a plain read without register address
+            uint16_t       mem_addr;
+            uint16_t       len;
+            const uint8_t* pt_data;
+        } iic;
+        struct
+        {
+            uint8_t  channel;
+            uint32_t value;
+        } capture;
+    };
+} su_rec_event_t;
+
+typedef struct
+{
+    const uint8_t* pt_buf;
+    size_t         len;
+    size_t         pos;
+    uint32_t       t_us;
+} su_rec_reader_t;
+
+/***************************************************************************************************
+ * External data declarations.
+ ***************************************************************************************************/
+
+/***************************************************************************************************
+ * External function declarations.
+ ***************************************************************************************************/
+
+size_t            su_rec_write_header(uint8_t* ppt_out, size_t p_size);
+size_t            su_rec_encode(const su_rec_event_t* ppt_event, uint32_t p_prev_us,
+                                uint8_t* ppt_out, size_t p_size);
+response_status_t su_rec_reader_init(su_rec_reader_t* ppt_reader, const uint8_t* ppt_buf,
+                                     size_t p_len);
+response_status_t su_rec_read(su_rec_reader_t* ppt_reader, su_rec_event_t* ppt_event);
+
+#endif /* SU_REC_H */
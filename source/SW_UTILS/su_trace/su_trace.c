@@ -0,0 +1,189 @@
+/***************************************************************************************************
+ * Header files.
+ ***************************************************************************************************/
+
+#include "su_trace.h"
+
+#include "string.h"
+
+/***************************************************************************************************
+ * Macro definitions.
+ ***************************************************************************************************/
+
+#define TRACE_BUF_MASK  (SU_TRACE_BUF_SZ - 1U)
+#define TRACE_LAP_SHIFT ((uint32_t)__builtin_ctz(SU_TRACE_BUF_SZ))
+#define TRACE_MAGIC     (0x45434154UL)
+
+/// Lap a position is written in, zeroed records never match the first lap
+#define TRACE_LAP(p_pos) ((uint8_t)(((p_pos) >> TRACE_LAP_SHIFT) + 1U))
+
+#if !defined(TEST)
+/// Not cleared by the startup code, so a frozen trace survives a warm reset
+#define TRACE_NOINIT __attribute__((section(".noinit")))
+#else
+#define TRACE_NOINIT
+#endif
+
+_Static_assert((SU_TRACE_BUF_SZ & TRACE_BUF_MASK) == 0U,
+               "Trace buffer size shall be a power of two");
+_Static_assert(sizeof(su_trace_rec_t) == 8U, "Trace records shall be packed into 8 bytes");
+
+/***************************************************************************************************
+ * Local type definitions.
+ ***************************************************************************************************/
+
+typedef struct
+{
+    uint32_t          magic;
+    volatile uint32_t head; // next position to write, claimed by the writers
+    uint32_t          tail; // next position to read
+    uint32_t          lost; // dropped records not yet reported to the reader
+    volatile bool_t   is_frozen;
+    su_trace_rec_t    recs[SU_TRACE_BUF_SZ];
+} trace_buf_t;
+
+/***************************************************************************************************
+ * Local data definitions.
+ ***************************************************************************************************/
+
+static trace_buf_t TRACE_NOINIT g_trace;
+static su_trace_clock_t         g_pt_clock = NULL;
+
+/***************************************************************************************************
+ * Local function definitions.
+ ***************************************************************************************************/
+
+/***************************************************************************************************
+ * External data definitions.
+ ***************************************************************************************************/
+
+/***************************************************************************************************
+ * External function definitions.
+ ***************************************************************************************************/
+
+/**
+ * @brief This function sets the clock of the trace points. A trace frozen
+ * before a warm reset is kept for the reader, otherwise the buffer is cleared.
+ * Trace points hit before the clock is set are ignored.
+ * @param[in] ppt_clock Free running 32Bit cycle counter, e.g. the DWT.
+ */
+void su_trace_init(su_trace_clock_t ppt_clock)
+{
+    g_pt_clock = NULL;
+    if ((g_trace.magic != TRACE_MAGIC) || (g_trace.is_frozen != TRUE))
+    {
+        memset(&g_trace, 0, sizeof(g_trace));
+        g_trace.magic = TRACE_MAGIC;
+    }
+    g_pt_clock = ppt_clock;
+}
+
+/**
+ * @brief This function appends a record, it may be called from any context.
+ * A position is claimed with an atomic add, so a writer never waits for
+ * another one. The oldest records are overwritten when the reader lags behind.
+ * @param[in] p_type Event type.
+ * @param[in] p_arg Payload of the event.
+ */
+void su_trace_record(su_trace_evt_t p_type, uint16_t p_arg)
+{
+    if ((g_pt_clock == NULL) || (g_trace.is_frozen == TRUE))
+    {
+        return;
+    }
+
+    uint32_t        pos    = __atomic_fetch_add(&g_trace.head, 1U, __ATOMIC_RELAXED);
+    su_trace_rec_t* pt_rec = &g_trace.recs[pos & TRACE_BUF_MASK];
+
+    pt_rec->cycles = g_pt_clock();
+    pt_rec->arg    = p_arg;
+    pt_rec->type   = (uint8_t)p_type;
+    __atomic_store_n(&pt_rec->lap, TRACE_LAP(pos), __ATOMIC_RELEASE);
+}
+
+/**
+ * @brief This function stops the recording, e.g. in a fault handler. The
+ * records stay in the buffer until they are read and the trace is resumed.
+ */
+void su_trace_freeze(void)
+{
+    g_trace.is_frozen = TRUE;
+}
+
+/**
+ * @brief This function drops the unread records and restarts the recording.
+ */
+void su_trace_resume(void)
+{
+    g_trace.tail      = __atomic_load_n(&g_trace.head, __ATOMIC_ACQUIRE);
+    g_trace.lost      = 0U;
+    g_trace.is_frozen = FALSE;
+}
+
+bool_t su_trace_is_frozen(void)
+{
+    return g_trace.is_frozen;
+}
+
+/**
+ * @brief This function copies the oldest unread records. Records that were
+ * overwritten or left incomplete are reported by a SU_TRACE_LOST record in
+ * front of the next valid one. It shall only be called from the thread
+ * context, so it never preempts a writer.
+ * @param[out] ppt_recs Destination of the records.
+ * @param[in] p_max_cnt Capacity of the destination in records.
+ * @return Number of records copied.
+ */
+uint32_t su_trace_read(su_trace_rec_t* ppt_recs, uint32_t p_max_cnt)
+{
+    ASSERT_AND_RETURN(ppt_recs == NULL, 0U);
+
+    uint32_t cnt = 0U;
+
+    for (;;)
+    {
+        uint32_t head = __atomic_load_n(&g_trace.head, __ATOMIC_ACQUIRE);
+
+        if ((head - g_trace.tail) > SU_TRACE_BUF_SZ)
+        {
+            // The writers lapped the reader
+            g_trace.lost += (head - g_trace.tail) - SU_TRACE_BUF_SZ;
+            g_trace.tail  = head - SU_TRACE_BUF_SZ;
+        }
+        if ((g_trace.tail == head) || (cnt >= p_max_cnt))
+        {
+            break;
+        }
+
+        const su_trace_rec_t* pt_slot = &g_trace.recs[g_trace.tail & TRACE_BUF_MASK];
+        uint8_t               lap     = __atomic_load_n(&pt_slot->lap, __ATOMIC_ACQUIRE);
+        su_trace_rec_t        rec     = { pt_slot->cycles, pt_slot->arg, pt_slot->type, lap };
+
+        // A writer that claimed the slot meanwhile may have changed the copy
+        head = __atomic_load_n(&g_trace.head, __ATOMIC_ACQUIRE);
+        if ((lap != TRACE_LAP(g_trace.tail)) || ((head - g_trace.tail) > SU_TRACE_BUF_SZ))
+        {
+            g_trace.lost++;
+            g_trace.tail++;
+            continue;
+        }
+        if (g_trace.lost != 0U)
+        {
+            if ((cnt + 2U) > p_max_cnt)
+            {
+                break; // no room for the record behind the lost report
+            }
+            ppt_recs[cnt].cycles = rec.cycles;
+            ppt_recs[cnt].arg    = (g_trace.lost < UINT16_MAX) ? (uint16_t)g_trace.lost : UINT16_MAX;
+            ppt_recs[cnt].type   = (uint8_t)SU_TRACE_LOST;
+            ppt_recs[cnt].lap    = 0U;
+            cnt++;
+            g_trace.lost = 0U;
+        }
+        ppt_recs[cnt] = rec;
+        cnt++;
+        g_trace.tail++;
+    }
+
+    return cnt;
+}
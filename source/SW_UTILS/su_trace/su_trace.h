@@ -0,0 +1,73 @@
+#ifndef SU_TRACE_H
+#define SU_TRACE_H
+
+/***************************************************************************************************
+ * Header files.
+ ***************************************************************************************************/
+#include "su_common.h"
+/***************************************************************************************************
+ * Macro definitions.
+ ***************************************************************************************************/
+
+/// Records held in RAM, a power of two, 8 bytes each
+#ifndef SU_TRACE_BUF_SZ
+#define SU_TRACE_BUF_SZ (512U)
+#endif
+
+/// Trace points, they cost a clock read and an atomic add and are compiled out
+/// with SU_TRACE_DISABLE
+#if !defined(SU_TRACE_DISABLE)
+#define SU_TRACE(p_type, p_arg) su_trace_record((p_type), (uint16_t)(p_arg))
+#else
+#define SU_TRACE(p_type, p_arg) ((void)0)
+#endif
+
+/***************************************************************************************************
+ * External type declarations.
+ ***************************************************************************************************/
+
+/// Event types, the payload of each is given in the comment
+typedef enum
+{
+    SU_TRACE_LOST = 0,   // number of records dropped before this one
+    SU_TRACE_FAULT,      // fault handler entered
+    SU_TRACE_ISR_ENTER,  // IRQ number
+    SU_TRACE_ISR_EXIT,   // IRQ number
+    SU_TRACE_TIMER_FIRE, // app timer id
+    SU_TRACE_DMA_START,  // bytes
+    SU_TRACE_DMA_DONE,   // bytes
+    SU_TRACE_IIC_START,  // device address
+    SU_TRACE_IIC_END,    // response status
+    SU_TRACE_TASK_START, // scheduler task index
+    SU_TRACE_TASK_END,   // scheduler task index
+    SU_TRACE_EVT_CNT,
+} su_trace_evt_t;
+
+/// Binary record, the dump format is its little endian memory image
+typedef struct
+{
+    uint32_t         cycles; // free running cycle counter
+    uint16_t         arg;
+    uint8_t          type;
+    volatile uint8_t lap; // written last, tells a complete record of this lap
+} su_trace_rec_t;
+
+/// Returns a free running 32Bit cycle counter
+typedef uint32_t (*su_trace_clock_t)(void);
+
+/***************************************************************************************************
+ * External data declarations.
+ ***************************************************************************************************/
+
+/***************************************************************************************************
+ * External function declarations.
+ ***************************************************************************************************/
+
+void     su_trace_init(su_trace_clock_t ppt_clock);
+void     su_trace_record(su_trace_evt_t p_type, uint16_t p_arg);
+void     su_trace_freeze(void);
+void     su_trace_resume(void);
+bool_t   su_trace_is_frozen(void);
+uint32_t su_trace_read(su_trace_rec_t* ppt_recs, uint32_t p_max_cnt);
+
+#endif /* SU_TRACE_H */
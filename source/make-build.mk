@@ -1,4 +1,4 @@
-.PHONY: build clean-build
+.PHONY: build build-host clean-build
 
 ############################### Native Makefile ###############################
 
@@ -7,6 +7,8 @@ ASM_OUT ?= OFF
 
 PLATFORM = $(if $(OS),$(OS),$(shell uname -s))
 FIRMWARE = $(BUILD_DIR)/$(PROJECT_NAME).bin
+# Native build of the application on the simulated port, see 01_MCU_PORT/host
+HOST_BUILD_DIR ?= $(BUILD_DIR)/../host/$(BUILD_TYPE)
 
 BUILD_LOG := $(LOGS_DIR)/build_$(BUILD_TYPE).log
 
@@ -36,5 +38,15 @@ $(BUILD_DIR)/Makefile: $(SRC_DIR)/CMakeLists.txt
 build: .cmake .make-prechecks
 	$(MAKE) -C $(BUILD_DIR) -j$(shell nproc) --no-print-directory 2>&1 | tee $(BUILD_LOG)
 
+build-host:
+	cmake \
+		-S $(SRC_DIR) \
+		-G "$(BUILD_SYSTEM)" \
+		-B$(HOST_BUILD_DIR) \
+		-DPROJECT_NAME=$(PROJECT_NAME) \
+		-DCMAKE_BUILD_TYPE=$(BUILD_TYPE) \
+		-DMCU_TARGET=host
+	$(MAKE) -C $(HOST_BUILD_DIR) -j$(shell nproc) --no-print-directory
+
 clean-build:
 	rm -rf $(BUILD_DIR)
\ No newline at end of file
@@ -162,4 +162,30 @@ void test_gpio_toggle_with_valid_pin_index_should_return_ok(void)
     }
 }
 
+/********* Tests for GPIO interrupts *********/
+
+static uint8_t irq_pin_idx = 0xFF;
+
+static void irq_callback(uint8_t pin)
+{
+    irq_pin_idx = pin;
+}
+
+void test_gpio_register_irq_callback_with_null_should_return_param_error(void)
+{
+    TEST_ASSERT_EQUAL(RET_PARAM_ERROR, g_gpio_driver->api->register_irq_callback(NULL));
+}
+
+void test_gpio_exti_callback_should_report_pin_index(void)
+{
+    TEST_ASSERT_EQUAL(RET_OK, g_gpio_driver->api->register_irq_callback(irq_callback));
+
+    HAL_GPIO_EXTI_Callback(PIN2);
+    TEST_ASSERT_EQUAL(1U, irq_pin_idx);
+
+    irq_pin_idx = 0xFF;
+    HAL_GPIO_EXTI_Callback(GPIO_PIN_15);
+    TEST_ASSERT_EQUAL(0xFF, irq_pin_idx);
+}
+
 #endif // TEST
\ No newline at end of file
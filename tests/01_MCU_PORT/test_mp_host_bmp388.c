@@ -0,0 +1,292 @@
+#ifdef TEST
+
+#include "dd_bmp388.h"
+#include "dd_bmp388_defs.h"
+#include "ha_gpio.h"
+#include "ha_iic.h"
+#include "ha_timer.h"
+#include "mp_host_bmp388.h"
+#include "mp_host_clock.h"
+#include "mp_host_gpio.h"
+#include "mp_host_iic.h"
+#include "mp_host_timer.h"
+#include "mp_timer_stats.h"
+#include "su_profiler.h"
+#include "su_trace.h"
+#include "unity.h"
+
+/// Start-up time of the sensor after the power on
+#define BOOT_NS          (2000000U)
+#define WAIT_MAX         (1000U)
+/// Conversion time terms of the datasheet
+#define CONV_US(osr_p, osr_t) \
+    (234U + 392U + (2020U << (osr_p)) + 163U + (2020U << (osr_t)))
+/// Address, register, address again and the data at 9 clocks each, 3 start or stop conditions
+#define READ_BUS_NS(len) ((((3U + (len)) * 9U) + 3U) * 10000U)
+
+static bmp388_dev_t* g_pt_dev;
+
+static void apply(bmp388_oversampling_t p_osr_p, bmp388_oversampling_t p_osr_t, bmp388_odr_t p_odr,
+                  bmp388_power_mode_t p_mode)
+{
+    g_pt_dev->settings.data_settings.press_oversampling = p_osr_p;
+    g_pt_dev->settings.data_settings.temp_oversampling  = p_osr_t;
+    g_pt_dev->settings.data_settings.output_data_rate   = p_odr;
+    g_pt_dev->settings.data_settings.iir_filter         = BMP388_IIR_DISABLE;
+    g_pt_dev->settings.dev_settings.sensor_enable       = BMP388_SENS_ENABLE_ALL;
+    g_pt_dev->settings.dev_settings.power_mode          = p_mode;
+    TEST_ASSERT_EQUAL(RET_OK, dd_bmp388_set_data_settings(g_pt_dev));
+    TEST_ASSERT_EQUAL(RET_OK, dd_bmp388_set_dev_settings(g_pt_dev));
+}
+
+/// Polls the driver, the core sleeps until the next conversion in between
+static bmp388_status_t wait_data(void)
+{
+    bmp388_status_t status = BMP388_WAITING_DATA;
+
+    for (uint32_t i = 0U; i < WAIT_MAX; i++)
+    {
+        status = dd_bmp388_get_data(g_pt_dev, BMP388_READ_ALL);
+        if ((status != BMP388_WAITING_DATA) && (status != BMP388_WAITING_PRESS)
+            && (status != BMP388_WAITING_TEMP))
+        {
+            break;
+        }
+        mp_host_clock_sleep();
+    }
+
+    return status;
+}
+
+static void set_air(float p_altitude_m, float p_temperature_c)
+{
+    static mp_host_bmp388_point_t point;
+
+    point.t_ms          = 0U;
+    point.altitude_m    = p_altitude_m;
+    point.temperature_c = p_temperature_c;
+    TEST_ASSERT_EQUAL(RET_OK, mp_host_bmp388_set_profile(&point, 1U));
+}
+
+void setUp(void)
+{
+    mp_host_clock_reset();
+    mp_host_iic_reset_stats();
+    TEST_ASSERT_EQUAL(RET_OK, ha_timer_init());
+    TEST_ASSERT_EQUAL(RET_OK, mp_host_bmp388_attach(IIC_PORT1, BMP388_IIC_ADDR_1, GP_PIN_IN_1));
+    TEST_ASSERT_EQUAL(RET_OK, mp_host_bmp388_set_profile(NULL, 0U));
+
+    mp_host_clock_spend_ns(BOOT_NS);
+    TEST_ASSERT_EQUAL(RET_OK, dd_bmp388_init(&g_pt_dev, BMP388_DEV_1));
+}
+
+void tearDown(void)
+{
+    mp_host_clock_reset();
+}
+
+void test_mp_host_bmp388_driver_should_read_the_air_of_the_profile(void)
+{
+    TEST_ASSERT_EQUAL(BMP388_CHIP_ID, g_pt_dev->chip_id);
+
+    apply(BMP388_OVERSAMPLING_NONE, BMP388_OVERSAMPLING_NONE, BMP388_ODR_50_HZ,
+          BMP388_POWER_MODE_NORMAL);
+    TEST_ASSERT_EQUAL(BMP388_NO_ERROR, wait_data());
+
+    TEST_ASSERT_FLOAT_WITHIN(0.01F, MP_HOST_BMP388_DEFAULT_TEMP_C, g_pt_dev->data.temperature);
+    TEST_ASSERT_FLOAT_WITHIN(1.0F,
+                             mp_host_bmp388_altitude_to_pa(MP_HOST_BMP388_DEFAULT_ALT_M),
+                             g_pt_dev->data.pressure);
+    TEST_ASSERT_EQUAL(BMP388_HEALTH_OK, g_pt_dev->data.pressure_health);
+}
+
+void test_mp_host_bmp388_pressure_should_be_measured_over_the_whole_range(void)
+{
+    /// From above BMP388_MAX_PRES down to BMP388_MIN_PRES
+    const float alts[]  = { -1700.0F, 0.0F, 1500.0F, 4000.0F, 9000.0F };
+    const float temps[] = { -20.0F, 25.0F, 60.0F };
+
+    TEST_ASSERT_TRUE(mp_host_bmp388_altitude_to_pa(alts[0]) < BMP388_MAX_PRES);
+    TEST_ASSERT_TRUE(mp_host_bmp388_altitude_to_pa(alts[4]) > BMP388_MIN_PRES);
+
+    for (uint32_t t = 0U; t < ARRAY_SIZE(temps); t++)
+    {
+        for (uint32_t a = 0U; a < ARRAY_SIZE(alts); a++)
+        {
+            set_air(alts[a], temps[t]);
+            /// The forced mode converts once with the air of now
+            apply(BMP388_OVERSAMPLING_2X, BMP388_OVERSAMPLING_NONE, BMP388_ODR_50_HZ,
+                  BMP388_POWER_MODE_FORCED);
+            TEST_ASSERT_EQUAL(BMP388_NO_ERROR, wait_data());
+
+            TEST_ASSERT_FLOAT_WITHIN(0.01F, temps[t], g_pt_dev->data.temperature);
+            TEST_ASSERT_FLOAT_WITHIN(1.0F, mp_host_bmp388_altitude_to_pa(alts[a]),
+                                     g_pt_dev->data.pressure);
+        }
+    }
+}
+
+void test_mp_host_bmp388_profile_should_be_interpolated(void)
+{
+    static const mp_host_bmp388_point_t climb[] = {
+        { .t_ms = 0U, .altitude_m = 0.0F, .temperature_c = 20.0F },
+        { .t_ms = 1000U, .altitude_m = 100.0F, .temperature_c = 20.0F },
+    };
+
+    TEST_ASSERT_EQUAL(RET_OK, mp_host_bmp388_set_profile(climb, ARRAY_SIZE(climb)));
+    apply(BMP388_OVERSAMPLING_NONE, BMP388_OVERSAMPLING_NONE, BMP388_ODR_50_HZ,
+          BMP388_POWER_MODE_NORMAL);
+
+    while (mp_host_clock_now_ns() < 500000000U)
+    {
+        mp_host_clock_sleep();
+    }
+    TEST_ASSERT_EQUAL(BMP388_NO_ERROR, wait_data());
+
+    /// The sleep ended on the first conversion from 500 ms on, within one period of 20 ms
+    TEST_ASSERT_TRUE(g_pt_dev->data.pressure < mp_host_bmp388_altitude_to_pa(49.9F));
+    TEST_ASSERT_TRUE(g_pt_dev->data.pressure > mp_host_bmp388_altitude_to_pa(52.1F));
+}
+
+void test_mp_host_bmp388_forced_conversion_should_take_the_oversampling_time(void)
+{
+    uint64_t start_ns = 0U;
+    uint64_t done_ns  = 0U;
+
+    apply(BMP388_OVERSAMPLING_8X, BMP388_OVERSAMPLING_NONE, BMP388_ODR_50_HZ,
+          BMP388_POWER_MODE_FORCED);
+    start_ns = mp_host_clock_now_ns();
+
+    /// Polls the status every 100 us
+    while (dd_bmp388_get_data(g_pt_dev, BMP388_READ_ALL) != BMP388_NO_ERROR)
+    {
+        TEST_ASSERT_TRUE(mp_host_clock_now_ns() < (start_ns + 100000000U));
+        mp_host_clock_spend_ns(100000U);
+    }
+    done_ns = mp_host_clock_now_ns();
+
+    TEST_ASSERT_TRUE(done_ns >= (start_ns + (CONV_US(3U, 0U) * 1000U)));
+    TEST_ASSERT_TRUE(done_ns < (start_ns + (CONV_US(3U, 0U) * 1000U) + 2000000U));
+    /// Back to sleep after the conversion
+    TEST_ASSERT_EQUAL(RET_OK, dd_bmp388_get_dev_settings(g_pt_dev));
+    TEST_ASSERT_EQUAL(BMP388_POWER_MODE_SLEEP, g_pt_dev->settings.dev_settings.power_mode);
+}
+
+void test_mp_host_bmp388_rate_too_fast_for_the_oversampling_should_be_refused(void)
+{
+    mp_host_bmp388_stats_t stats;
+
+    /// 130 ms of conversion do not fit in 5 ms
+    TEST_ASSERT_TRUE((CONV_US(5U, 5U) * 1000U) > 5000000U);
+    apply(BMP388_OVERSAMPLING_32X, BMP388_OVERSAMPLING_32X, BMP388_ODR_200_HZ,
+          BMP388_POWER_MODE_NORMAL);
+
+    TEST_ASSERT_EQUAL(BMP388_ERROR_CONFIG, dd_bmp388_get_error_state(g_pt_dev));
+    /// Cleared on read
+    TEST_ASSERT_EQUAL(BMP388_NO_ERROR, dd_bmp388_get_error_state(g_pt_dev));
+    TEST_ASSERT_EQUAL(RET_OK, dd_bmp388_get_dev_settings(g_pt_dev));
+    TEST_ASSERT_EQUAL(BMP388_POWER_MODE_SLEEP, g_pt_dev->settings.dev_settings.power_mode);
+
+    mp_host_clock_spend_ns(200000000U);
+    mp_host_bmp388_get_stats(&stats);
+    TEST_ASSERT_EQUAL(0U, stats.conv_cnt);
+}
+
+void test_mp_host_bmp388_drdy_pin_should_cost_one_burst_per_sample(void)
+{
+    mp_host_bmp388_stats_t stats;
+    uint32_t               read_cnt = 0U;
+    uint64_t               end_ns   = 0U;
+
+    g_pt_dev->settings.int_settings.int_enable = BMP388_INT_ENABLE_DRDY;
+    g_pt_dev->settings.int_settings.int_type   = BMP388_INT_TYPE_PP_HIGH_NON_LATCHED;
+    TEST_ASSERT_EQUAL(RET_OK, dd_bmp388_set_interrupt_settings(g_pt_dev));
+    TEST_ASSERT_EQUAL(RET_OK, dd_bmp388_attach_drdy_pin(g_pt_dev, GP_PIN_IN_1));
+    apply(BMP388_OVERSAMPLING_NONE, BMP388_OVERSAMPLING_NONE, BMP388_ODR_50_HZ,
+          BMP388_POWER_MODE_NORMAL);
+
+    mp_host_iic_reset_stats();
+    end_ns = mp_host_clock_now_ns() + 1000000000U;
+    while (mp_host_clock_now_ns() < end_ns)
+    {
+        mp_host_clock_sleep();
+        if (dd_bmp388_get_data(g_pt_dev, BMP388_READ_ALL) == BMP388_NO_ERROR)
+        {
+            read_cnt++;
+        }
+    }
+
+    mp_host_bmp388_get_stats(&stats);
+    /// 50 Hz, every conversion read once
+    TEST_ASSERT_TRUE(read_cnt >= 50U);
+    TEST_ASSERT_EQUAL(stats.conv_cnt, read_cnt);
+    TEST_ASSERT_EQUAL(read_cnt, stats.sample_cnt);
+    TEST_ASSERT_EQUAL(0U, stats.stale_cnt);
+    TEST_ASSERT_EQUAL(0U, stats.lost_cnt);
+    /// Pressure, temperature and sensor time in one transfer, no status read
+    TEST_ASSERT_EQUAL(read_cnt, stats.bus.xfer_cnt);
+    TEST_ASSERT_EQUAL(read_cnt * (3U + BMP388_REG_DATA_BURST_LEN), stats.bus.byte_cnt);
+    TEST_ASSERT_EQUAL(read_cnt * READ_BUS_NS(BMP388_REG_DATA_BURST_LEN), stats.bus.bus_ns);
+}
+
+void test_mp_host_bmp388_fifo_should_queue_the_frames(void)
+{
+    /// FIFO on with pressure and temperature, then the register and value pair of no subsampling
+    uint8_t                cfg[3]   = { 0x19U, BMP388_REG_FIFO_CONFIG_2, 0x00U };
+    uint8_t                len[2]   = { 0U };
+    uint8_t                data[70] = { 0U };
+    mp_host_bmp388_stats_t stats;
+
+    TEST_ASSERT_EQUAL(RET_OK,
+                      ha_iic_master_mem_write(IIC_PORT1, BMP388_IIC_ADDR_1, cfg, sizeof(cfg),
+                                              BMP388_REG_FIFO_CONFIG_1, HW_IIC_MEM_SZ_8BIT, 10U));
+    apply(BMP388_OVERSAMPLING_NONE, BMP388_OVERSAMPLING_NONE, BMP388_ODR_50_HZ,
+          BMP388_POWER_MODE_NORMAL);
+
+    /// Ten conversions, the core sleeps meanwhile
+    do
+    {
+        mp_host_clock_sleep();
+        mp_host_bmp388_get_stats(&stats);
+    } while (stats.conv_cnt < 10U);
+
+    TEST_ASSERT_EQUAL(RET_OK,
+                      ha_iic_master_mem_read(IIC_PORT1, BMP388_IIC_ADDR_1, len, sizeof(len),
+                                             BMP388_REG_FIFO_LENGTH, HW_IIC_MEM_SZ_8BIT, 10U));
+    TEST_ASSERT_EQUAL(sizeof(data), BYTES_TO_WORD(unsigned, len[0], len[1]));
+
+    /// One burst drains it, the address stays on the FIFO data
+    TEST_ASSERT_EQUAL(RET_OK,
+                      ha_iic_master_mem_read(IIC_PORT1, BMP388_IIC_ADDR_1, data, sizeof(data),
+                                             BMP388_REG_FIFO_DATA, HW_IIC_MEM_SZ_8BIT, 10U));
+    for (uint32_t i = 0U; i < sizeof(data); i += 7U)
+    {
+        TEST_ASSERT_EQUAL_HEX8(0x94U, data[i]);
+        TEST_ASSERT_NOT_EQUAL(0U, BYTES_TO_DWORD(unsigned, data[i + 4U], data[i + 5U],
+                                                 data[i + 6U], 0U));
+    }
+    mp_host_bmp388_get_stats(&stats);
+    TEST_ASSERT_EQUAL(10U, stats.sample_cnt);
+
+    TEST_ASSERT_EQUAL(RET_OK,
+                      ha_iic_master_mem_read(IIC_PORT1, BMP388_IIC_ADDR_1, len, sizeof(len),
+                                             BMP388_REG_FIFO_LENGTH, HW_IIC_MEM_SZ_8BIT, 10U));
+    TEST_ASSERT_EQUAL(0U, BYTES_TO_WORD(unsigned, len[0], len[1]));
+}
+
+void test_mp_host_bmp388_soft_reset_should_restore_the_defaults(void)
+{
+    apply(BMP388_OVERSAMPLING_16X, BMP388_OVERSAMPLING_8X, BMP388_ODR_1P5_HZ,
+          BMP388_POWER_MODE_NORMAL);
+
+    TEST_ASSERT_EQUAL(BMP388_NO_ERROR, dd_bmp388_reset(g_pt_dev));
+
+    TEST_ASSERT_EQUAL(RET_OK, dd_bmp388_get_data_settings(g_pt_dev));
+    TEST_ASSERT_EQUAL(RET_OK, dd_bmp388_get_dev_settings(g_pt_dev));
+    TEST_ASSERT_EQUAL(BMP388_OVERSAMPLING_4X, g_pt_dev->settings.data_settings.press_oversampling);
+    TEST_ASSERT_EQUAL(BMP388_OVERSAMPLING_NONE, g_pt_dev->settings.data_settings.temp_oversampling);
+    TEST_ASSERT_EQUAL(BMP388_ODR_200_HZ, g_pt_dev->settings.data_settings.output_data_rate);
+    TEST_ASSERT_EQUAL(BMP388_POWER_MODE_SLEEP, g_pt_dev->settings.dev_settings.power_mode);
+}
+
+#endif // TEST
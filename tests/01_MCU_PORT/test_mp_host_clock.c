@@ -0,0 +1,194 @@
+#ifdef TEST
+
+#include "mp_host_clock.h"
+#include "unity.h"
+
+#include <string.h>
+
+#define LOG_LEN (8U)
+
+typedef struct
+{
+    mp_host_event_t event;
+    uint32_t        id;
+} test_irq_t;
+
+static test_irq_t g_irqs[3];
+static uint32_t   g_log[LOG_LEN];
+static uint64_t   g_log_ns[LOG_LEN];
+static uint32_t   g_log_cnt;
+static bool_t     g_is_ended;
+
+static void irq_handler(void* ppt_ctx)
+{
+    test_irq_t* pt_irq = (test_irq_t*)ppt_ctx;
+
+    if (g_log_cnt < LOG_LEN)
+    {
+        g_log[g_log_cnt]    = pt_irq->id;
+        g_log_ns[g_log_cnt] = mp_host_clock_now_ns();
+        g_log_cnt++;
+    }
+}
+
+/// Works for a while inside the interrupt, the next one shall wait for it
+static void long_irq_handler(void* ppt_ctx)
+{
+    irq_handler(ppt_ctx);
+    mp_host_clock_spend_ns(5000U);
+}
+
+static void on_end(void)
+{
+    g_is_ended = TRUE;
+}
+
+void setUp(void)
+{
+    mp_host_clock_reset();
+    mp_host_clock_set_end(UINT64_MAX, NULL);
+    memset(g_log, 0, sizeof(g_log));
+    g_log_cnt  = 0U;
+    g_is_ended = FALSE;
+    for (uint32_t i = 0U; i < 3U; i++)
+    {
+        g_irqs[i].id = i;
+        mp_host_event_init(&g_irqs[i].event, irq_handler, &g_irqs[i]);
+    }
+}
+
+void tearDown(void)
+{
+    mp_host_clock_reset();
+}
+
+void test_mp_host_clock_work_should_serve_the_interrupts_in_time_order(void)
+{
+    mp_host_event_schedule(&g_irqs[0].event, 3000U);
+    mp_host_event_schedule(&g_irqs[1].event, 1000U);
+    mp_host_event_schedule(&g_irqs[2].event, 2000U);
+
+    mp_host_clock_spend_ns(2500U);
+
+    TEST_ASSERT_EQUAL(2U, g_log_cnt);
+    TEST_ASSERT_EQUAL(1U, g_log[0]);
+    TEST_ASSERT_EQUAL(2U, g_log[1]);
+    /// Each one at its own time, not at the end of the work
+    TEST_ASSERT_EQUAL(1000U, g_log_ns[0]);
+    TEST_ASSERT_EQUAL(2000U, g_log_ns[1]);
+    TEST_ASSERT_EQUAL(2500U, mp_host_clock_now_ns());
+}
+
+void test_mp_host_clock_same_time_should_keep_the_schedule_order(void)
+{
+    mp_host_event_schedule(&g_irqs[2].event, 1000U);
+    mp_host_event_schedule(&g_irqs[0].event, 1000U);
+    mp_host_event_schedule(&g_irqs[1].event, 1000U);
+
+    mp_host_clock_spend_ns(1000U);
+
+    TEST_ASSERT_EQUAL(3U, g_log_cnt);
+    TEST_ASSERT_EQUAL(2U, g_log[0]);
+    TEST_ASSERT_EQUAL(0U, g_log[1]);
+    TEST_ASSERT_EQUAL(1U, g_log[2]);
+}
+
+void test_mp_host_clock_masked_interrupts_should_stay_pending(void)
+{
+    mp_host_event_schedule(&g_irqs[0].event, 1000U);
+
+    mp_host_clock_irq_mask();
+    mp_host_clock_irq_mask();
+    mp_host_clock_spend_ns(5000U);
+    mp_host_clock_irq_unmask();
+    TEST_ASSERT_EQUAL(0U, g_log_cnt);
+
+    /// The last unmask serves it at once, late
+    mp_host_clock_irq_unmask();
+    TEST_ASSERT_EQUAL(1U, g_log_cnt);
+    TEST_ASSERT_EQUAL(5000U, g_log_ns[0]);
+}
+
+void test_mp_host_clock_interrupts_should_not_nest(void)
+{
+    mp_host_event_init(&g_irqs[0].event, long_irq_handler, &g_irqs[0]);
+    mp_host_event_schedule(&g_irqs[0].event, 1000U);
+    mp_host_event_schedule(&g_irqs[1].event, 2000U);
+
+    mp_host_clock_spend_ns(1000U);
+
+    TEST_ASSERT_EQUAL(2U, g_log_cnt);
+    TEST_ASSERT_EQUAL(0U, g_log[0]);
+    /// Raised during the first handler, served once it returned
+    TEST_ASSERT_EQUAL(1U, g_log[1]);
+    TEST_ASSERT_EQUAL(6000U, g_log_ns[1]);
+}
+
+void test_mp_host_clock_sleep_should_jump_to_the_next_interrupt(void)
+{
+    mp_host_clock_stats_t stats;
+
+    mp_host_event_schedule(&g_irqs[0].event, 1000000U);
+    mp_host_event_schedule(&g_irqs[1].event, 3000000U);
+
+    mp_host_clock_sleep();
+    TEST_ASSERT_EQUAL(1U, g_log_cnt);
+    TEST_ASSERT_EQUAL(1000000U, mp_host_clock_now_ns());
+
+    mp_host_clock_sleep();
+    TEST_ASSERT_EQUAL(2U, g_log_cnt);
+    TEST_ASSERT_EQUAL(3000000U, mp_host_clock_now_ns());
+
+    mp_host_clock_get_stats(&stats);
+    TEST_ASSERT_EQUAL(2U, stats.irq_cnt);
+    TEST_ASSERT_EQUAL(3000000U, stats.sleep_ns);
+}
+
+void test_mp_host_clock_interrupt_before_the_sleep_should_wake_it_at_once(void)
+{
+    mp_host_event_schedule(&g_irqs[0].event, 1000U);
+    mp_host_event_schedule(&g_irqs[1].event, 9000U);
+
+    /// The interrupt came while the core was checking for work, it latched the event of WFE
+    mp_host_clock_spend_ns(2000U);
+    mp_host_clock_sleep();
+    TEST_ASSERT_EQUAL(2000U, mp_host_clock_now_ns());
+
+    mp_host_clock_sleep();
+    TEST_ASSERT_EQUAL(9000U, mp_host_clock_now_ns());
+}
+
+void test_mp_host_clock_cancelled_interrupt_should_not_be_raised(void)
+{
+    mp_host_event_schedule(&g_irqs[0].event, 1000U);
+    mp_host_event_schedule(&g_irqs[1].event, 2000U);
+    mp_host_event_cancel(&g_irqs[0].event);
+    /// Moving a scheduled event keeps one entry of it
+    mp_host_event_schedule(&g_irqs[1].event, 500U);
+
+    mp_host_clock_spend_ns(3000U);
+
+    TEST_ASSERT_EQUAL(1U, g_log_cnt);
+    TEST_ASSERT_EQUAL(1U, g_log[0]);
+    TEST_ASSERT_EQUAL(500U, g_log_ns[0]);
+    TEST_ASSERT_FALSE(g_irqs[1].event.is_scheduled);
+}
+
+void test_mp_host_clock_end_should_be_reported_once(void)
+{
+    mp_host_clock_set_end(10000U, on_end);
+
+    mp_host_clock_spend_ns(9999U);
+    TEST_ASSERT_FALSE(g_is_ended);
+
+    /// Nothing scheduled, a sleep reaches the end
+    mp_host_clock_sleep();
+    TEST_ASSERT_TRUE(g_is_ended);
+    TEST_ASSERT_EQUAL(10000U, mp_host_clock_now_ns());
+
+    g_is_ended = FALSE;
+    mp_host_clock_spend_ns(1000U);
+    TEST_ASSERT_FALSE(g_is_ended);
+}
+
+#endif // TEST
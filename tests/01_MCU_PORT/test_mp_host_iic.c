@@ -0,0 +1,250 @@
+#ifdef TEST
+
+#include "ha_iic.h"
+#include "mock_ha_timer.h"
+#include "mp_host_clock.h"
+#include "mp_host_iic.h"
+#include "su_profiler.h"
+#include "su_trace.h"
+#include "unity.h"
+
+#include <string.h>
+
+#define REG_DEV_ADDR (0x40U)
+#define ABSENT_ADDR  (0x51U)
+#define FAULTY_ADDR  (0x52U)
+#define PROBED_ADDR  (0x53U)
+#define TIMEOUT_MS   (10U)
+/// One SCL period at 100 kHz
+#define BUS_CLOCK_NS (10000U)
+
+/// A device with 256 registers and an auto incremented register pointer
+typedef struct
+{
+    uint8_t regs[256];
+    uint8_t ptr;
+} reg_dev_t;
+
+static reg_dev_t       g_dev;
+static mp_host_event_t g_irq;
+static uint64_t        g_irq_ns;
+
+static response_status_t reg_write(void* ppt_ctx, const uint8_t* ppt_data, size_t p_len)
+{
+    reg_dev_t* pt_dev = (reg_dev_t*)ppt_ctx;
+
+    pt_dev->ptr = ppt_data[0];
+    for (size_t i = 1U; i < p_len; i++)
+    {
+        pt_dev->regs[pt_dev->ptr++] = ppt_data[i];
+    }
+
+    return RET_OK;
+}
+
+static response_status_t reg_read(void* ppt_ctx, uint8_t* ppt_data, size_t p_len)
+{
+    reg_dev_t* pt_dev = (reg_dev_t*)ppt_ctx;
+
+    for (size_t i = 0U; i < p_len; i++)
+    {
+        ppt_data[i] = pt_dev->regs[pt_dev->ptr++];
+    }
+
+    return RET_OK;
+}
+
+static response_status_t reg_mem_write(void* ppt_ctx, uint16_t p_mem_addr, uint8_t p_mem_size,
+                                       const uint8_t* ppt_data, size_t p_len)
+{
+    reg_dev_t* pt_dev = (reg_dev_t*)ppt_ctx;
+
+    TEST_ASSERT_EQUAL(HW_IIC_MEM_SZ_8BIT, p_mem_size);
+    pt_dev->ptr = (uint8_t)p_mem_addr;
+    for (size_t i = 0U; i < p_len; i++)
+    {
+        pt_dev->regs[pt_dev->ptr++] = ppt_data[i];
+    }
+
+    return RET_OK;
+}
+
+static response_status_t reg_mem_read(void* ppt_ctx, uint16_t p_mem_addr, uint8_t p_mem_size,
+                                      uint8_t* ppt_data, size_t p_len)
+{
+    reg_dev_t* pt_dev = (reg_dev_t*)ppt_ctx;
+
+    TEST_ASSERT_EQUAL(HW_IIC_MEM_SZ_8BIT, p_mem_size);
+    pt_dev->ptr = (uint8_t)p_mem_addr;
+
+    return reg_read(ppt_ctx, ppt_data, p_len);
+}
+
+static response_status_t busy_mem_read(void* ppt_ctx, uint16_t p_mem_addr, uint8_t p_mem_size,
+                                       uint8_t* ppt_data, size_t p_len)
+{
+    UNUSED(ppt_ctx);
+    UNUSED(p_mem_addr);
+    UNUSED(p_mem_size);
+    UNUSED(ppt_data);
+    UNUSED(p_len);
+
+    return RET_ERROR;
+}
+
+static const mp_host_iic_model_t g_reg_model = {
+    .write     = reg_write,
+    .read      = reg_read,
+    .mem_write = reg_mem_write,
+    .mem_read  = reg_mem_read,
+};
+
+/// Acknowledges its address but fails the reads, the other transfers are not acknowledged
+static const mp_host_iic_model_t g_faulty_model = { .mem_read = busy_mem_read };
+
+static void irq_handler(void* ppt_ctx)
+{
+    UNUSED(ppt_ctx);
+
+    g_irq_ns = mp_host_clock_now_ns();
+}
+
+void setUp(void)
+{
+    ha_timer_init_IgnoreAndReturn(RET_OK);
+    ha_timer_get_cpu_time_us_IgnoreAndReturn(0U);
+
+    mp_host_clock_reset();
+    mp_host_iic_reset_stats();
+    memset(&g_dev, 0, sizeof(g_dev));
+    g_irq_ns = 0U;
+    mp_host_event_init(&g_irq, irq_handler, NULL);
+    TEST_ASSERT_EQUAL(RET_OK, mp_host_iic_attach(IIC_PORT1, REG_DEV_ADDR, &g_reg_model, &g_dev));
+    TEST_ASSERT_EQUAL(RET_OK, mp_host_iic_attach(IIC_PORT1, FAULTY_ADDR, &g_faulty_model, NULL));
+    TEST_ASSERT_EQUAL(RET_OK, ha_iic_init());
+}
+
+void tearDown(void)
+{
+    mp_host_iic_detach(IIC_PORT1, REG_DEV_ADDR);
+    mp_host_iic_detach(IIC_PORT1, FAULTY_ADDR);
+    mp_host_clock_reset();
+}
+
+void test_mp_host_iic_model_should_serve_the_transfers(void)
+{
+    uint8_t out[4] = { 0x11U, 0x22U, 0x33U, 0x44U };
+    uint8_t in[4]  = { 0U };
+    uint8_t cmd[3] = { 0x80U, 0xA5U, 0x5AU };
+
+    TEST_ASSERT_EQUAL(RET_OK,
+                      ha_iic_master_mem_write(IIC_PORT1,
+                                              REG_DEV_ADDR,
+                                              out,
+                                              sizeof(out),
+                                              0x10U,
+                                              HW_IIC_MEM_SZ_8BIT,
+                                              TIMEOUT_MS));
+    TEST_ASSERT_EQUAL(RET_OK,
+                      ha_iic_master_mem_read(IIC_PORT1,
+                                             REG_DEV_ADDR,
+                                             in,
+                                             sizeof(in),
+                                             0x10U,
+                                             HW_IIC_MEM_SZ_8BIT,
+                                             TIMEOUT_MS));
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(out, in, sizeof(out));
+
+    /// Plain transfers, the first byte written sets the register pointer
+    TEST_ASSERT_EQUAL(RET_OK,
+                      ha_iic_master_write(IIC_PORT1, REG_DEV_ADDR, cmd, sizeof(cmd), TIMEOUT_MS));
+    TEST_ASSERT_EQUAL(RET_OK, ha_iic_master_mem_read(IIC_PORT1,
+                                                     REG_DEV_ADDR,
+                                                     in,
+                                                     2U,
+                                                     0x80U,
+                                                     HW_IIC_MEM_SZ_8BIT,
+                                                     TIMEOUT_MS));
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(&cmd[1], in, 2U);
+}
+
+void test_mp_host_iic_transfer_should_hold_the_bus_for_its_wire_time(void)
+{
+    uint8_t             in[6];
+    mp_host_iic_stats_t stats;
+
+    /// Address, register, address again and 6 bytes at 9 clocks each, 3 start or stop conditions
+    mp_host_event_schedule(&g_irq, 500000U);
+    TEST_ASSERT_EQUAL(RET_OK,
+                      ha_iic_master_mem_read(IIC_PORT1,
+                                             REG_DEV_ADDR,
+                                             in,
+                                             sizeof(in),
+                                             0x00U,
+                                             HW_IIC_MEM_SZ_8BIT,
+                                             TIMEOUT_MS));
+
+    mp_host_iic_get_stats(IIC_PORT1, &stats);
+    TEST_ASSERT_EQUAL(1U, stats.xfer_cnt);
+    TEST_ASSERT_EQUAL(9U, stats.byte_cnt);
+    TEST_ASSERT_EQUAL(((9U * 9U) + 3U) * BUS_CLOCK_NS, stats.bus_ns);
+    TEST_ASSERT_TRUE(mp_host_clock_now_ns() >= stats.bus_ns);
+    /// The core polls the peripheral meanwhile, the interrupt is served on time
+    TEST_ASSERT_EQUAL(500000U, g_irq_ns);
+}
+
+void test_mp_host_iic_absent_device_should_not_acknowledge(void)
+{
+    uint8_t             data = 0U;
+    mp_host_iic_stats_t stats;
+
+    TEST_ASSERT_EQUAL(RET_OK, ha_iic_dev_probe(IIC_PORT1, REG_DEV_ADDR, TIMEOUT_MS));
+    /// A failed device is skipped by ha_iic for a while, the read goes to another one
+    TEST_ASSERT_NOT_EQUAL(RET_OK, ha_iic_dev_probe(IIC_PORT1, PROBED_ADDR, TIMEOUT_MS));
+    mp_host_iic_reset_stats();
+
+    TEST_ASSERT_NOT_EQUAL(RET_OK,
+                          ha_iic_master_mem_read(IIC_PORT1,
+                                                 ABSENT_ADDR,
+                                                 &data,
+                                                 1U,
+                                                 0x00U,
+                                                 HW_IIC_MEM_SZ_8BIT,
+                                                 TIMEOUT_MS));
+
+    /// ha_iic retries it, every attempt stops after the address
+    mp_host_iic_get_stats(IIC_PORT1, &stats);
+    TEST_ASSERT_TRUE(stats.xfer_cnt > 1U);
+    TEST_ASSERT_EQUAL(stats.xfer_cnt, stats.nack_cnt);
+    TEST_ASSERT_EQUAL(stats.xfer_cnt, stats.byte_cnt);
+    TEST_ASSERT_EQUAL(stats.xfer_cnt * 11U * BUS_CLOCK_NS, stats.bus_ns);
+}
+
+void test_mp_host_iic_model_failure_should_fail_the_transfer(void)
+{
+    uint8_t             data[2] = { 0U };
+    mp_host_iic_stats_t stats;
+    mp_host_iic_stats_t stats_after;
+
+    TEST_ASSERT_EQUAL(RET_OK, ha_iic_dev_probe(IIC_PORT1, FAULTY_ADDR, TIMEOUT_MS));
+    TEST_ASSERT_NOT_EQUAL(RET_OK,
+                          ha_iic_master_mem_read(IIC_PORT1,
+                                                 FAULTY_ADDR,
+                                                 data,
+                                                 sizeof(data),
+                                                 0x00U,
+                                                 HW_IIC_MEM_SZ_8BIT,
+                                                 TIMEOUT_MS));
+    mp_host_iic_get_stats(IIC_PORT1, &stats);
+    /// The probe is acknowledged, every attempt of the read fails
+    TEST_ASSERT_TRUE(stats.xfer_cnt > 2U);
+    TEST_ASSERT_EQUAL(stats.xfer_cnt - 1U, stats.nack_cnt);
+
+    /// ha_iic backs the device off, the next transfer does not reach the bus
+    TEST_ASSERT_EQUAL(RET_BUSY,
+                      ha_iic_master_write(IIC_PORT1, FAULTY_ADDR, data, 1U, TIMEOUT_MS));
+    mp_host_iic_get_stats(IIC_PORT1, &stats_after);
+    TEST_ASSERT_EQUAL(stats.xfer_cnt, stats_after.xfer_cnt);
+}
+
+#endif // TEST
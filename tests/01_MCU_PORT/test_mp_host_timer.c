@@ -0,0 +1,138 @@
+#ifdef TEST
+
+#include "ha_timer.h"
+#include "mp_host_clock.h"
+#include "mp_host_timer.h"
+#include "mp_timer_stats.h"
+#include "su_profiler.h"
+#include "unity.h"
+
+static uint32_t g_1ms_cnt;
+static uint32_t g_10ms_cnt;
+static uint32_t g_alarm_cnt;
+static uint32_t g_alarm_counter;
+
+static void on_1ms(void)
+{
+    g_1ms_cnt++;
+}
+
+static void on_10ms(void)
+{
+    g_10ms_cnt++;
+}
+
+static void on_alarm(void)
+{
+    g_alarm_cnt++;
+    g_alarm_counter = ha_timer_get_counter();
+}
+
+void setUp(void)
+{
+    mp_host_clock_reset();
+    g_1ms_cnt   = 0U;
+    g_10ms_cnt  = 0U;
+    g_alarm_cnt = 0U;
+
+    TEST_ASSERT_EQUAL(RET_OK, ha_timer_init());
+    TEST_ASSERT_EQUAL(RET_OK, ha_timer_register_callback(TIMER_1MS, on_1ms));
+    TEST_ASSERT_EQUAL(RET_OK, ha_timer_register_callback(TIMER_10MS, on_10ms));
+    TEST_ASSERT_EQUAL(RET_OK, ha_timer_register_alarm_callback(on_alarm));
+    ha_timer_reset_stats();
+}
+
+void tearDown(void)
+{
+    mp_host_clock_reset();
+}
+
+void test_mp_host_timer_periods_should_follow_the_simulated_time(void)
+{
+    ha_timer_stats_t stats;
+
+    TEST_ASSERT_EQUAL(RET_OK, ha_timer_start(TIMER_1MS));
+    TEST_ASSERT_EQUAL(RET_OK, ha_timer_start(TIMER_10MS));
+
+    /// A second of sleeping, only the timers wake the core
+    while (mp_host_clock_now_ns() < 1000000000U)
+    {
+        ha_timer_wait_for_interrupt();
+    }
+
+    TEST_ASSERT_EQUAL(1000U, g_1ms_cnt);
+    TEST_ASSERT_EQUAL(100U, g_10ms_cnt);
+    TEST_ASSERT_EQUAL(RET_OK, ha_timer_get_stats(TIMER_1MS, &stats));
+    TEST_ASSERT_EQUAL(1000U, stats.fire_cnt);
+    TEST_ASSERT_EQUAL(0U, stats.overrun_cnt);
+    TEST_ASSERT_EQUAL(0U, stats.max_late_ticks);
+}
+
+void test_mp_host_timer_masked_core_should_overrun_the_periods(void)
+{
+    ha_timer_stats_t stats;
+
+    TEST_ASSERT_EQUAL(RET_OK, ha_timer_start(TIMER_1MS));
+
+    /// Interrupts masked for 3.5 periods, the matches meanwhile are lost
+    mp_host_clock_irq_mask();
+    mp_host_clock_spend_ns(4500000U);
+    mp_host_clock_irq_unmask();
+
+    TEST_ASSERT_EQUAL(1U, g_1ms_cnt);
+    TEST_ASSERT_EQUAL(RET_OK, ha_timer_get_stats(TIMER_1MS, &stats));
+    TEST_ASSERT_EQUAL(3U, stats.overrun_cnt);
+    TEST_ASSERT_EQUAL(3500U, stats.max_late_ticks);
+
+    /// Back on the grid of the period
+    mp_host_clock_spend_ns(500000U);
+    TEST_ASSERT_EQUAL(2U, g_1ms_cnt);
+}
+
+void test_mp_host_timer_alarm_should_fire_at_its_deadline(void)
+{
+    uint32_t start = ha_timer_get_counter();
+
+    TEST_ASSERT_EQUAL(RET_OK, ha_timer_set_alarm(start + 750U));
+    ha_timer_wait_for_interrupt();
+
+    TEST_ASSERT_EQUAL(1U, g_alarm_cnt);
+    TEST_ASSERT_EQUAL(start + 750U, g_alarm_counter);
+
+    /// One-shot, nothing else wakes the core before the periodic timer. The first wait ends
+    /// at once on the event the alarm latched, as WFE does
+    TEST_ASSERT_EQUAL(RET_OK, ha_timer_start(TIMER_10MS));
+    while (g_10ms_cnt == 0U)
+    {
+        ha_timer_wait_for_interrupt();
+    }
+    TEST_ASSERT_EQUAL(1U, g_alarm_cnt);
+    TEST_ASSERT_TRUE(mp_host_clock_now_ns() >= 10000000U);
+}
+
+void test_mp_host_timer_passed_deadline_should_fire_after_the_lead(void)
+{
+    uint32_t start = ha_timer_get_counter();
+
+    TEST_ASSERT_EQUAL(RET_OK, ha_timer_set_alarm(start - 100U));
+    ha_timer_wait_for_interrupt();
+
+    TEST_ASSERT_EQUAL(1U, g_alarm_cnt);
+    TEST_ASSERT_EQUAL(start + MP_TIMER_MIN_LEAD, g_alarm_counter);
+}
+
+void test_mp_host_timer_cycles_should_run_at_the_core_clock(void)
+{
+    uint32_t cycles = ha_timer_get_cycles();
+    uint32_t us     = ha_timer_get_cpu_time_us();
+
+    ha_timer_hard_delay_ms(2U);
+
+    /// Each call into the port takes MP_HOST_CALL_NS
+    TEST_ASSERT_EQUAL(2000U, ha_timer_get_cpu_time_us() - us);
+    TEST_ASSERT_EQUAL((2000U * (MP_HOST_CPU_HZ / 1000000U))
+                        + (3U * MP_HOST_CALL_NS * (MP_HOST_CPU_HZ / 1000000U) / 1000U),
+                      ha_timer_get_cycles() - cycles);
+}
+
+#endif // TEST
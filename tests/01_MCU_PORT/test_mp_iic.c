@@ -1,6 +1,7 @@
 #ifdef TEST
 
 #include "mock_main.h"
+#include "mock_stm32f4xx_hal_gpio.h"
 #include "mock_stm32f4xx_hal_i2c.h"
 #include "mp_iic.h"
 #include "unity.h"
@@ -86,6 +87,50 @@ HAL_StatusTypeDef HAL_I2C_Mem_Write_fake(I2C_HandleTypeDef* hi2c, uint16_t DevAd
     return i2c_expect.return_val;
 }
 
+/// Simulated bus for the recovery, the slave releases SDA after `sda_release_clk` SCL pulses
+static const struct hal_iic_bus_pins l_iic_bus_pins[] = { { GPIOB, GPIO_PIN_8, GPIOB, GPIO_PIN_9 } };
+static uint8_t                       sda_release_clk = 0U;
+static uint8_t                       scl_pulse_cnt = 0U;
+static GPIO_PinState                 sda_out = GPIO_PIN_SET;
+
+size_t get_iic_bus_pins_stub(struct hal_iic_bus_pins const ** iic_bus_pins, int cmock_num_calls)
+{
+    *iic_bus_pins = l_iic_bus_pins;
+    return 1U;
+}
+
+void HAL_GPIO_WritePin_fake(GPIO_TypeDef* GPIOx, uint16_t GPIO_Pin, GPIO_PinState PinState, int cmock_num_calls)
+{
+    TEST_ASSERT_EQUAL_PTR(GPIOB, GPIOx);
+    if (GPIO_Pin == GPIO_PIN_8 && PinState == GPIO_PIN_RESET)
+    {
+        scl_pulse_cnt++;
+    }
+    else if (GPIO_Pin == GPIO_PIN_9)
+    {
+        sda_out = PinState;
+    }
+}
+
+GPIO_PinState HAL_GPIO_ReadPin_fake(GPIO_TypeDef* GPIOx, uint16_t GPIO_Pin, int cmock_num_calls)
+{
+    TEST_ASSERT_EQUAL(GPIO_PIN_9, GPIO_Pin);
+    return (scl_pulse_cnt >= sda_release_clk) ? sda_out : GPIO_PIN_RESET;
+}
+
+static void expect_bus_recovery(uint8_t p_release_clk)
+{
+    sda_release_clk = p_release_clk;
+    scl_pulse_cnt = 0U;
+    sda_out = GPIO_PIN_SET;
+    get_iic_bus_pins_StubWithCallback(get_iic_bus_pins_stub);
+    HAL_GPIO_WritePin_StubWithCallback(HAL_GPIO_WritePin_fake);
+    HAL_GPIO_ReadPin_StubWithCallback(HAL_GPIO_ReadPin_fake);
+    HAL_GPIO_Init_Ignore();
+    HAL_I2C_DeInit_ExpectAndReturn(&hi2c1, HAL_OK);
+    HAL_I2C_Init_ExpectAndReturn(&hi2c1, HAL_OK);
+}
+
 void setUp(void)
 {
     g_i2c_driver = iic_driver_register();
@@ -220,4 +265,49 @@ void test_iic_master_read_with_valid_parameters_should_return_ok(void)
     TEST_ASSERT_EQUAL(RET_OK, ret_val);
 }
 
+void test_iic_dev_probe_should_try_address_once(void)
+{
+    HAL_I2C_IsDeviceReady_ExpectAndReturn(&hi2c1, 0x68 << 1, 1U, 2U, HAL_OK);
+
+    response_status_t ret_val = g_i2c_driver->api->dev_probe(0, 0x68, 2U);
+
+    TEST_ASSERT_EQUAL(RET_OK, ret_val);
+}
+
+void test_iic_dev_probe_with_no_device_should_return_error(void)
+{
+    HAL_I2C_IsDeviceReady_ExpectAndReturn(&hi2c1, 0x50 << 1, 1U, 2U, HAL_ERROR);
+
+    response_status_t ret_val = g_i2c_driver->api->dev_probe(0, 0x50, 2U);
+
+    TEST_ASSERT_EQUAL(RET_ERROR, ret_val);
+}
+
+void test_iic_bus_recover_should_clock_scl_until_sda_is_released(void)
+{
+    expect_bus_recovery(3U);
+
+    response_status_t ret_val = g_i2c_driver->api->bus_recover(0);
+
+    TEST_ASSERT_EQUAL(RET_OK, ret_val);
+    TEST_ASSERT_EQUAL(3U, scl_pulse_cnt);
+}
+
+void test_iic_bus_recover_with_sda_held_low_should_return_error(void)
+{
+    expect_bus_recovery(0xFFU);
+
+    response_status_t ret_val = g_i2c_driver->api->bus_recover(0);
+
+    TEST_ASSERT_EQUAL(RET_ERROR, ret_val);
+    TEST_ASSERT_EQUAL(9U, scl_pulse_cnt);
+}
+
+void test_iic_bus_recover_with_invalid_index_should_return_not_supported(void)
+{
+    response_status_t ret_val = g_i2c_driver->api->bus_recover(2);
+
+    TEST_ASSERT_EQUAL(RET_NOT_SUPPORTED, ret_val);
+}
+
 #endif // TEST
\ No newline at end of file
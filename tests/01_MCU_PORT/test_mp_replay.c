@@ -0,0 +1,307 @@
+#ifdef TEST
+
+#include "ha_iic.h"
+#include "ha_input_capture.h"
+#include "mock_ha_timer.h"
+#include "mp_host_capture.h"
+#include "mp_host_clock.h"
+#include "mp_host_iic.h"
+#include "mp_replay.h"
+#include "su_profiler.h"
+#include "su_rec.h"
+#include "su_trace.h"
+#include "unity.h"
+
+#include <string.h>
+
+/// A second of a recorded drive: receiver frames, IMU FIFO and baro reads every 20 ms
+#define FRAME_US       (20000U)
+#define FRAME_CNT      (50U)
+#define IMU_ADDR       (0x68U)
+#define IMU_REG_FIFO   (0x72U)
+#define IMU_FIFO_LEN   (12U)
+#define BARO_ADDR      (0x77U)
+#define BARO_REG_DATA  (0x04U)
+#define BARO_DATA_LEN  (6U)
+#define CAP_OFFSET_US  (100U)
+#define IMU_OFFSET_US  (5000U)
+#define BARO_OFFSET_US (6000U)
+#define TIMEOUT_MS     (10U)
+
+typedef struct
+{
+    uint8_t  buf[8192];
+    size_t   len;
+    uint32_t prev_us;
+} rec_buf_t;
+
+static rec_buf_t g_rec;
+static rec_buf_t g_rerec;
+static uint32_t  g_cb_cnt[INPUT_CAPTURE_CHANNEL_CNT];
+static uint32_t  g_cb_last[INPUT_CAPTURE_CHANNEL_CNT];
+static uint32_t  g_issue_us; // Replay time the application loop issued the current read
+
+static void rec_start(rec_buf_t* ppt_rec)
+{
+    ppt_rec->len     = su_rec_write_header(ppt_rec->buf, sizeof(ppt_rec->buf));
+    ppt_rec->prev_us = 0U;
+}
+
+static void rec_put(rec_buf_t* ppt_rec, const su_rec_event_t* ppt_event)
+{
+    size_t len = su_rec_encode(ppt_event,
+                               ppt_rec->prev_us,
+                               &ppt_rec->buf[ppt_rec->len],
+                               sizeof(ppt_rec->buf) - ppt_rec->len);
+
+    TEST_ASSERT_NOT_EQUAL(0U, len);
+    ppt_rec->len     += len;
+    ppt_rec->prev_us  = ppt_event->t_us;
+}
+
+static void fill(uint8_t* ppt_data, size_t p_len, uint32_t p_seed)
+{
+    for (size_t i = 0U; i < p_len; i++)
+    {
+        ppt_data[i] = (uint8_t)((p_seed * 31U) + i);
+    }
+}
+
+static void record_drive(void)
+{
+    uint8_t imu[IMU_FIFO_LEN];
+    uint8_t baro[BARO_DATA_LEN];
+
+    rec_start(&g_rec);
+    for (uint32_t n = 0U; n < FRAME_CNT; n++)
+    {
+        uint32_t       t_us = n * FRAME_US;
+        su_rec_event_t ev   = { .type = SU_REC_CAPTURE, .t_us = t_us + CAP_OFFSET_US };
+
+        ev.capture.channel = INPUT_CAPTURE_CHANNEL_1;
+        ev.capture.value   = 1000U + (n * 10U);
+        rec_put(&g_rec, &ev);
+        ev.t_us            = t_us + CAP_OFFSET_US + 1U;
+        ev.capture.channel = INPUT_CAPTURE_CHANNEL_2;
+        ev.capture.value   = 2000U - (n * 10U);
+        rec_put(&g_rec, &ev);
+
+        fill(imu, sizeof(imu), n);
+        memset(&ev, 0, sizeof(ev));
+        ev.type         = SU_REC_IIC_READ;
+        ev.t_us         = t_us + IMU_OFFSET_US;
+        ev.iic.dev_addr = IMU_ADDR;
+        ev.iic.mem_size = HW_IIC_MEM_SZ_8BIT;
+        ev.iic.mem_addr = IMU_REG_FIFO;
+        ev.iic.len      = sizeof(imu);
+        ev.iic.pt_data  = imu;
+        rec_put(&g_rec, &ev);
+
+        fill(baro, sizeof(baro), n + 1000U);
+        ev.t_us         = t_us + BARO_OFFSET_US;
+        ev.iic.dev_addr = BARO_ADDR;
+        ev.iic.mem_addr = BARO_REG_DATA;
+        ev.iic.len      = sizeof(baro);
+        ev.iic.pt_data  = baro;
+        rec_put(&g_rec, &ev);
+    }
+}
+
+static response_status_t read_imu(uint8_t* ppt_data)
+{
+    return ha_iic_master_mem_read(IIC_PORT1,
+                                  IMU_ADDR,
+                                  ppt_data,
+                                  IMU_FIFO_LEN,
+                                  IMU_REG_FIFO,
+                                  HW_IIC_MEM_SZ_8BIT,
+                                  TIMEOUT_MS);
+}
+
+static response_status_t read_baro(uint8_t* ppt_data)
+{
+    return ha_iic_master_mem_read(IIC_PORT1,
+                                  BARO_ADDR,
+                                  ppt_data,
+                                  BARO_DATA_LEN,
+                                  BARO_REG_DATA,
+                                  HW_IIC_MEM_SZ_8BIT,
+                                  TIMEOUT_MS);
+}
+
+static void capture_cb(input_capture_channel_t p_channel, uint32_t p_value)
+{
+    g_cb_cnt[p_channel]++;
+    g_cb_last[p_channel] = p_value;
+}
+
+static void rerecord_iic(iic_comm_port_t p_port, uint8_t p_dev_addr, uint16_t p_mem_addr,
+                         uint8_t p_mem_size, const uint8_t* ppt_data, size_t p_len)
+{
+    su_rec_event_t ev = { .type = SU_REC_IIC_READ, .t_us = g_issue_us };
+
+    ev.iic.port     = (uint8_t)p_port;
+    ev.iic.dev_addr = p_dev_addr;
+    ev.iic.mem_size = p_mem_size;
+    ev.iic.mem_addr = p_mem_addr;
+    ev.iic.len      = (uint16_t)p_len;
+    ev.iic.pt_data  = ppt_data;
+    rec_put(&g_rerec, &ev);
+}
+
+static void rerecord_capture(input_capture_channel_t p_channel, uint32_t p_value)
+{
+    su_rec_event_t ev = { .type = SU_REC_CAPTURE, .t_us = mp_replay_now_us() };
+
+    ev.capture.channel = (uint8_t)p_channel;
+    ev.capture.value   = p_value;
+    rec_put(&g_rerec, &ev);
+}
+
+void setUp(void)
+{
+    ha_timer_init_IgnoreAndReturn(RET_OK);
+    ha_timer_get_cpu_time_us_IgnoreAndReturn(0U);
+
+    memset(g_cb_cnt, 0, sizeof(g_cb_cnt));
+    memset(g_cb_last, 0, sizeof(g_cb_last));
+    mp_host_clock_reset();
+    mp_host_iic_reset_stats();
+    record_drive();
+    TEST_ASSERT_EQUAL(RET_OK, mp_replay_load(g_rec.buf, g_rec.len));
+
+    TEST_ASSERT_EQUAL(RET_OK, ha_iic_init());
+    TEST_ASSERT_EQUAL(RET_OK, ha_input_capture_init());
+    TEST_ASSERT_EQUAL(RET_OK,
+                      ha_input_capture_register_callback(INPUT_CAPTURE_CHANNEL_1, capture_cb));
+    TEST_ASSERT_EQUAL(RET_OK,
+                      ha_input_capture_register_callback(INPUT_CAPTURE_CHANNEL_2, capture_cb));
+}
+
+void tearDown(void)
+{
+    ha_iic_register_record_hook(NULL);
+    ha_input_capture_register_record_hook(NULL);
+    (void)ha_input_capture_abort(INPUT_CAPTURE_CHANNEL_1);
+    (void)ha_input_capture_abort(INPUT_CAPTURE_CHANNEL_2);
+}
+
+void test_mp_replay_reads_should_return_the_recorded_bytes_in_order(void)
+{
+    uint8_t             data[IMU_FIFO_LEN];
+    uint8_t             expected[IMU_FIFO_LEN];
+    mp_replay_stats_t   stats;
+    mp_host_iic_stats_t bus;
+
+    for (uint32_t n = 0U; n < FRAME_CNT; n++)
+    {
+        fill(expected, IMU_FIFO_LEN, n);
+        TEST_ASSERT_EQUAL(RET_OK, read_imu(data));
+        TEST_ASSERT_EQUAL_UINT8_ARRAY(expected, data, IMU_FIFO_LEN);
+    }
+
+    mp_replay_get_stats(&stats);
+    TEST_ASSERT_EQUAL(FRAME_CNT, stats.iic_read_cnt);
+    TEST_ASSERT_EQUAL(0U, stats.iic_miss_cnt);
+    /// Device address twice, register and data of each read, at 9 clocks a byte
+    mp_host_iic_get_stats(IIC_PORT1, &bus);
+    TEST_ASSERT_EQUAL(FRAME_CNT * (3U + IMU_FIFO_LEN), bus.byte_cnt);
+    TEST_ASSERT_EQUAL(FRAME_CNT * (((3U + IMU_FIFO_LEN) * 9U) + 3U) * 10000U, bus.bus_ns);
+}
+
+void test_mp_replay_devices_should_keep_their_own_order(void)
+{
+    uint8_t data[IMU_FIFO_LEN];
+    uint8_t expected[IMU_FIFO_LEN];
+
+    /// A driver that polls the baro first still gets the IMU reads from the start
+    for (uint32_t n = 0U; n < 3U; n++)
+    {
+        fill(expected, BARO_DATA_LEN, n + 1000U);
+        TEST_ASSERT_EQUAL(RET_OK, read_baro(data));
+        TEST_ASSERT_EQUAL_UINT8_ARRAY(expected, data, BARO_DATA_LEN);
+    }
+    fill(expected, IMU_FIFO_LEN, 0U);
+    TEST_ASSERT_EQUAL(RET_OK, read_imu(data));
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(expected, data, IMU_FIFO_LEN);
+}
+
+void test_mp_replay_unrecorded_device_should_not_answer(void)
+{
+    uint8_t             data = 0U;
+    mp_replay_stats_t   stats;
+    mp_host_iic_stats_t bus;
+
+    TEST_ASSERT_EQUAL(RET_OK, ha_iic_dev_probe(IIC_PORT1, IMU_ADDR, TIMEOUT_MS));
+    TEST_ASSERT_NOT_EQUAL(RET_OK, ha_iic_dev_probe(IIC_PORT1, 0x50U, TIMEOUT_MS));
+    TEST_ASSERT_NOT_EQUAL(RET_OK,
+                          ha_iic_master_mem_read(IIC_PORT1,
+                                                 0x50U,
+                                                 &data,
+                                                 1U,
+                                                 0x00U,
+                                                 HW_IIC_MEM_SZ_8BIT,
+                                                 TIMEOUT_MS));
+
+    mp_replay_get_stats(&stats);
+    mp_host_iic_get_stats(IIC_PORT1, &bus);
+    TEST_ASSERT_TRUE(bus.nack_cnt > 0U);
+    TEST_ASSERT_EQUAL(0U, stats.iic_read_cnt);
+}
+
+void test_mp_replay_captures_should_follow_the_requests(void)
+{
+    TEST_ASSERT_EQUAL(RET_OK,
+                      ha_input_capture_request_capture(INPUT_CAPTURE_CHANNEL_1,
+                                                       IC_MEASURE_PWM,
+                                                       IC_CONTINUOUS_CAPTURE));
+    TEST_ASSERT_EQUAL(RET_OK,
+                      ha_input_capture_request_capture(INPUT_CAPTURE_CHANNEL_2,
+                                                       IC_MEASURE_PULSE_WIDTH,
+                                                       IC_ONE_SHOT_CAPTURE));
+
+    TEST_ASSERT_EQUAL(2U, mp_replay_run_until(CAP_OFFSET_US + 1U));
+    TEST_ASSERT_FALSE(mp_replay_is_done());
+    TEST_ASSERT_EQUAL(FRAME_CNT - 1U, mp_replay_run_until(FRAME_CNT * FRAME_US));
+    TEST_ASSERT_TRUE(mp_replay_is_done());
+
+    TEST_ASSERT_EQUAL(FRAME_CNT, g_cb_cnt[INPUT_CAPTURE_CHANNEL_1]);
+    TEST_ASSERT_EQUAL(1000U + ((FRAME_CNT - 1U) * 10U), g_cb_last[INPUT_CAPTURE_CHANNEL_1]);
+    TEST_ASSERT_EQUAL(1U, g_cb_cnt[INPUT_CAPTURE_CHANNEL_2]);
+    TEST_ASSERT_EQUAL(2000U, g_cb_last[INPUT_CAPTURE_CHANNEL_2]);
+}
+
+void test_mp_replay_recording_the_replay_should_give_the_same_stream(void)
+{
+    uint8_t data[IMU_FIFO_LEN];
+
+    (void)ha_input_capture_request_capture(INPUT_CAPTURE_CHANNEL_1,
+                                           IC_MEASURE_PWM,
+                                           IC_CONTINUOUS_CAPTURE);
+    (void)ha_input_capture_request_capture(INPUT_CAPTURE_CHANNEL_2,
+                                           IC_MEASURE_PWM,
+                                           IC_CONTINUOUS_CAPTURE);
+    rec_start(&g_rerec);
+    ha_iic_register_record_hook(rerecord_iic);
+    ha_input_capture_register_record_hook(rerecord_capture);
+
+    /// The loop of the application: sensors are read at the recorded times, a read
+    /// holds the bus for over a millisecond and is stamped when it is issued
+    for (uint32_t n = 0U; n < FRAME_CNT; n++)
+    {
+        g_issue_us = (n * FRAME_US) + IMU_OFFSET_US;
+        (void)mp_replay_run_until(g_issue_us);
+        TEST_ASSERT_EQUAL(RET_OK, read_imu(data));
+        g_issue_us = (n * FRAME_US) + BARO_OFFSET_US;
+        (void)mp_replay_run_until(g_issue_us);
+        TEST_ASSERT_EQUAL(RET_OK, read_baro(data));
+    }
+
+    TEST_ASSERT_EQUAL(g_rec.len, g_rerec.len);
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(g_rec.buf, g_rerec.buf, g_rec.len);
+
+    /// The recording is used up, the driver sees a failing device
+    TEST_ASSERT_NOT_EQUAL(RET_OK, read_imu(data));
+}
+
+#endif // TEST
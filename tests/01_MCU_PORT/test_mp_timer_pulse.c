@@ -0,0 +1,197 @@
+#ifdef TEST
+
+#include "mp_timer_pulse.h"
+#include "unity.h"
+
+#include <stdio.h>
+
+/// RC receiver frame, 1 MHz capture counter with a 16Bit reload
+#define FRAME_CNT      (500U)
+#define FRAME_US       (20000U)
+#define COUNTER_ARR    (0xFFFFU)
+#define FIRST_RISE_US  (5000U)
+#define NO_LATE_FRAME  (0xFFFFFFFFU)
+
+typedef struct
+{
+    uint32_t rise_us;
+    uint32_t fall_us;
+} sim_frame_t;
+
+typedef struct
+{
+    uint32_t isr_cnt;
+    uint32_t width_cnt;
+    uint32_t bad_width_cnt;
+} sim_result_t;
+
+static sim_frame_t g_frames[FRAME_CNT];
+
+/// Frames of 1000..2000 us pulses with a few us of frame jitter
+static void sim_make_frames(void)
+{
+    uint32_t seed = 12345U;
+    uint32_t t_us = FIRST_RISE_US;
+
+    for (uint32_t i = 0U; i < FRAME_CNT; i++)
+    {
+        seed                = (seed * 1103515245U) + 12345U;
+        g_frames[i].rise_us = t_us;
+        g_frames[i].fall_us = t_us + 1000U + ((seed >> 8) % 1001U);
+        t_us               += FRAME_US + ((seed >> 20) % 8U);
+    }
+}
+
+static void sim_check_width(sim_result_t* ppt_res, uint32_t p_frame, uint32_t p_width)
+{
+    ppt_res->width_cnt++;
+    if ((p_frame >= FRAME_CNT)
+        || (p_width != (g_frames[p_frame].fall_us - g_frames[p_frame].rise_us)))
+    {
+        ppt_res->bad_width_cnt++;
+    }
+}
+
+/**
+ * @brief Edge capture as in the pulse width mode: each edge of the armed
+ * polarity interrupts, the ISR reads the capture and switches the polarity.
+ * The ISR of the rising edge of `p_late_frame` is served after the falling
+ * edge, so the falling edge passes while the rising polarity is still armed.
+ */
+static sim_result_t sim_edge_capture(uint32_t p_late_frame)
+{
+    sim_result_t res          = { 0U };
+    bool_t       wait_falling = FALSE;
+    uint32_t     rising_ccr   = 0U;
+    uint32_t     rising_frame = 0U;
+
+    for (uint32_t i = 0U; i < FRAME_CNT; i++)
+    {
+        for (uint32_t edge = 0U; edge < 2U; edge++)
+        {
+            bool_t   is_rising = (edge == 0U) ? TRUE : FALSE;
+            uint32_t t_us      = (is_rising == TRUE) ? g_frames[i].rise_us : g_frames[i].fall_us;
+
+            if (is_rising == wait_falling)
+            {
+                continue; // Polarity not armed, the edge is not captured
+            }
+            res.isr_cnt++;
+            if (wait_falling == FALSE)
+            {
+                rising_ccr   = t_us & COUNTER_ARR;
+                rising_frame = i;
+                wait_falling = TRUE;
+                if (i == p_late_frame)
+                {
+                    edge++; // Late service, the falling edge passed before the switch
+                }
+            }
+            else
+            {
+                sim_check_width(&res,
+                                rising_frame,
+                                mp_timer_pulse_width(rising_ccr, t_us & COUNTER_ARR, COUNTER_ARR));
+                wait_falling = FALSE;
+            }
+        }
+    }
+
+    return res;
+}
+
+/**
+ * @brief PWM input mode: the rising edge latches the period and resets the
+ * counter without an interrupt, the falling edge latches the width and
+ * interrupts. A late ISR still finds both captures of its frame.
+ */
+static sim_result_t sim_pwm_input(void)
+{
+    sim_result_t res         = { 0U };
+    uint32_t     reset_us    = 0U;
+    uint32_t     period_ccr  = 0U;
+    bool_t       rising_seen = FALSE;
+
+    for (uint32_t i = 0U; i < FRAME_CNT; i++)
+    {
+        uint32_t width_ccr = 0U;
+        uint32_t width     = 0U;
+
+        period_ccr  = (g_frames[i].rise_us - reset_us) & COUNTER_ARR;
+        reset_us    = g_frames[i].rise_us;
+        rising_seen = TRUE;
+
+        width_ccr = (g_frames[i].fall_us - reset_us) & COUNTER_ARR;
+        res.isr_cnt++;
+        if (mp_timer_pwm_width(rising_seen, period_ccr, width_ccr, &width) == TRUE)
+        {
+            sim_check_width(&res, i, width);
+        }
+        rising_seen = FALSE; // Cleared by reading the period
+    }
+
+    return res;
+}
+
+void setUp(void)
+{
+    sim_make_frames();
+}
+
+void tearDown(void) {}
+
+void test_mp_timer_pulse_width_should_handle_the_counter_reload(void)
+{
+    TEST_ASSERT_EQUAL(1500U, mp_timer_pulse_width(1000U, 2500U, COUNTER_ARR));
+    TEST_ASSERT_EQUAL(1500U, mp_timer_pulse_width(0xFF00U, 1500U - 0x100U, COUNTER_ARR));
+}
+
+void test_mp_timer_pwm_width_without_a_rising_edge_should_be_dropped(void)
+{
+    uint32_t width = 0U;
+
+    TEST_ASSERT_FALSE(mp_timer_pwm_width(FALSE, 20000U, 1500U, &width));
+    TEST_ASSERT_TRUE(mp_timer_pwm_width(TRUE, 20000U, 1500U, &width));
+    TEST_ASSERT_EQUAL(1500U, width);
+}
+
+void test_mp_timer_pwm_width_longer_than_the_period_should_be_dropped(void)
+{
+    uint32_t width = 0U;
+
+    TEST_ASSERT_FALSE(mp_timer_pwm_width(TRUE, 1200U, 1500U, &width));
+}
+
+void test_mp_timer_pwm_input_should_halve_the_interrupts(void)
+{
+    sim_result_t edge = sim_edge_capture(NO_LATE_FRAME);
+    sim_result_t pwm  = sim_pwm_input();
+    char         msg[96];
+
+    TEST_ASSERT_EQUAL(2U * FRAME_CNT, edge.isr_cnt);
+    TEST_ASSERT_EQUAL(FRAME_CNT, edge.width_cnt);
+    TEST_ASSERT_EQUAL(0U, edge.bad_width_cnt);
+
+    TEST_ASSERT_EQUAL(FRAME_CNT, pwm.isr_cnt);
+    TEST_ASSERT_EQUAL(FRAME_CNT, pwm.width_cnt);
+    TEST_ASSERT_EQUAL(0U, pwm.bad_width_cnt);
+
+    snprintf(msg, sizeof(msg), "%u frames: edge capture %u ISRs, PWM input %u ISRs",
+             (unsigned)FRAME_CNT, (unsigned)edge.isr_cnt, (unsigned)pwm.isr_cnt);
+    TEST_MESSAGE(msg);
+}
+
+void test_mp_timer_late_polarity_switch_should_corrupt_only_the_edge_capture(void)
+{
+    sim_result_t edge = sim_edge_capture(100U);
+    sim_result_t pwm  = sim_pwm_input();
+
+    /// The falling edge of the next frame closes the pulse, two frames give one bad width
+    TEST_ASSERT_EQUAL(1U, edge.bad_width_cnt);
+    TEST_ASSERT_EQUAL(FRAME_CNT - 2U, edge.width_cnt - edge.bad_width_cnt);
+
+    TEST_ASSERT_EQUAL(0U, pwm.bad_width_cnt);
+    TEST_ASSERT_EQUAL(FRAME_CNT, pwm.width_cnt);
+}
+
+#endif // TEST
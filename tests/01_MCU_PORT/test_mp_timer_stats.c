@@ -0,0 +1,90 @@
+#ifdef TEST
+
+#include "mp_timer_stats.h"
+#include "unity.h"
+
+#include <string.h>
+
+#define PERIOD (100U)
+
+static mp_timer_stats_t g_ch;
+
+void setUp(void)
+{
+    memset(&g_ch, 0, sizeof(g_ch));
+}
+
+void tearDown(void) {}
+
+void test_mp_timer_stats_on_time_service_should_keep_the_period(void)
+{
+    TEST_ASSERT_EQUAL(1100U, mp_timer_stats_on_fire(&g_ch, 1000U, 1000U, PERIOD));
+    TEST_ASSERT_EQUAL(1200U, mp_timer_stats_on_fire(&g_ch, 1100U, 1103U, PERIOD));
+    TEST_ASSERT_EQUAL(1300U, mp_timer_stats_on_fire(&g_ch, 1200U, 1203U, PERIOD));
+
+    TEST_ASSERT_EQUAL(3U, g_ch.stats.fire_cnt);
+    TEST_ASSERT_EQUAL(0U, g_ch.stats.overrun_cnt);
+    TEST_ASSERT_EQUAL(3U, g_ch.stats.max_late_ticks);
+    /// Lateness changed by 3 ticks once, then stayed the same
+    TEST_ASSERT_EQUAL(1U, g_ch.stats.jitter_hist[0]);
+    TEST_ASSERT_EQUAL(1U, g_ch.stats.jitter_hist[2]);
+}
+
+void test_mp_timer_stats_late_service_should_skip_periods_on_the_grid(void)
+{
+    (void)mp_timer_stats_on_fire(&g_ch, 900U, 900U, PERIOD);
+
+    /// Interrupts masked for 250 ticks, the matches at 1100 and 1200 are lost
+    TEST_ASSERT_EQUAL(1300U, mp_timer_stats_on_fire(&g_ch, 1000U, 1250U, PERIOD));
+
+    TEST_ASSERT_EQUAL(2U, g_ch.stats.overrun_cnt);
+    TEST_ASSERT_EQUAL(250U, g_ch.stats.max_late_ticks);
+    TEST_ASSERT_EQUAL(1U, g_ch.stats.jitter_hist[HA_TIMER_JITTER_BINS - 1U]);
+}
+
+void test_mp_timer_stats_match_closer_than_the_lead_should_be_skipped(void)
+{
+    TEST_ASSERT_EQUAL(1200U, mp_timer_stats_on_fire(&g_ch, 1000U, 1099U, PERIOD));
+    TEST_ASSERT_EQUAL(1U, g_ch.stats.overrun_cnt);
+
+    TEST_ASSERT_EQUAL(1300U, mp_timer_stats_on_fire(&g_ch, 1200U, 1298U, PERIOD));
+    TEST_ASSERT_EQUAL(1U, g_ch.stats.overrun_cnt);
+}
+
+void test_mp_timer_stats_should_handle_the_counter_wrap(void)
+{
+    TEST_ASSERT_EQUAL(0x54U, mp_timer_stats_on_fire(&g_ch, 0xFFFFFFF0U, 0x00000010U, PERIOD));
+    TEST_ASSERT_EQUAL(0x20U, g_ch.stats.max_late_ticks);
+    TEST_ASSERT_EQUAL(0U, g_ch.stats.overrun_cnt);
+}
+
+void test_mp_timer_stats_early_service_should_not_count_as_late(void)
+{
+    TEST_ASSERT_EQUAL(1100U, mp_timer_stats_on_fire(&g_ch, 1000U, 995U, PERIOD));
+    TEST_ASSERT_EQUAL(0U, g_ch.stats.max_late_ticks);
+}
+
+void test_mp_timer_stats_alarm_should_only_count_fires_and_lateness(void)
+{
+    TEST_ASSERT_EQUAL(1000U, mp_timer_stats_on_fire(&g_ch, 1000U, 1007U, 0U));
+    TEST_ASSERT_EQUAL(5000U, mp_timer_stats_on_fire(&g_ch, 5000U, 5001U, 0U));
+
+    TEST_ASSERT_EQUAL(2U, g_ch.stats.fire_cnt);
+    TEST_ASSERT_EQUAL(7U, g_ch.stats.max_late_ticks);
+    TEST_ASSERT_EQUAL(0U, g_ch.stats.overrun_cnt);
+    TEST_ASSERT_EQUAL(0U, g_ch.stats.jitter_hist[0]);
+}
+
+void test_mp_timer_stats_restart_should_not_count_the_gap_as_jitter(void)
+{
+    (void)mp_timer_stats_on_fire(&g_ch, 1000U, 1000U, PERIOD);
+    mp_timer_stats_restart(&g_ch);
+    (void)mp_timer_stats_on_fire(&g_ch, 9000U, 9040U, PERIOD);
+
+    for (uint32_t i = 0U; i < HA_TIMER_JITTER_BINS; i++)
+    {
+        TEST_ASSERT_EQUAL(0U, g_ch.stats.jitter_hist[i]);
+    }
+}
+
+#endif // TEST
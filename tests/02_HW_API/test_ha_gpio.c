@@ -11,12 +11,16 @@ static response_status_t drv_init(void);
 static response_status_t drv_write(uint8_t pin, bool_t value);
 static response_status_t drv_read(uint8_t pin, bool_t* value);
 static response_status_t drv_toggle(uint8_t pin);
+static response_status_t drv_register_irq_callback(void (*callback)(uint8_t));
+
+static void (*hw_irq_callback)(uint8_t) = NULL;
 
 struct st_gpio_driver_ifc fake_driver_ifc = {
     .init = drv_init,
     .write = drv_write,
     .read = drv_read,
     .toggle = drv_toggle,
+    .register_irq_callback = drv_register_irq_callback,
 };
 
 struct st_gpio_driver fake_gpio_driver = {
@@ -69,6 +73,22 @@ static response_status_t drv_toggle(uint8_t pin)
     return RET_OK;
 }
 
+static response_status_t drv_register_irq_callback(void (*callback)(uint8_t))
+{
+    hw_irq_callback = callback;
+
+    return RET_OK;
+}
+
+static gpio_pins_t irq_pin = GP_PIN_CNT;
+static uint8_t     irq_cnt = 0U;
+
+static void user_irq_callback(gpio_pins_t pin)
+{
+    irq_pin = pin;
+    irq_cnt++;
+}
+
 void setUp(void) {}
 
 void tearDown(void) {}
@@ -210,4 +230,31 @@ void test_gpio_get_with_invalid_state(void)
     TEST_ASSERT_EQUAL(RET_ERROR, ha_gpio_get(GP_PIN_LED, &pin_val));
 }
 
+/********* Tests for GPIO interrupts *********/
+
+void test_gpio_register_callback_on_output_pin_should_return_param_error(void)
+{
+    TEST_ASSERT_EQUAL(RET_PARAM_ERROR, ha_gpio_register_callback(GP_PIN_LED, user_irq_callback));
+    TEST_ASSERT_EQUAL(RET_PARAM_ERROR, ha_gpio_register_callback(GP_PIN_CNT, user_irq_callback));
+}
+
+void test_gpio_irq_on_input_pin_should_call_user_callback(void)
+{
+    TEST_ASSERT_NOT_NULL(hw_irq_callback);
+    TEST_ASSERT_EQUAL(RET_OK, ha_gpio_register_callback(GP_PIN_IN_1, user_irq_callback));
+
+    irq_cnt = 0U;
+    hw_irq_callback(GP_PIN_IN_1);
+    TEST_ASSERT_EQUAL(1U, irq_cnt);
+    TEST_ASSERT_EQUAL(GP_PIN_IN_1, irq_pin);
+
+    // Output pins sharing the same interrupt line are ignored
+    hw_irq_callback(GP_PIN_LED);
+    TEST_ASSERT_EQUAL(1U, irq_cnt);
+
+    TEST_ASSERT_EQUAL(RET_OK, ha_gpio_register_callback(GP_PIN_IN_1, NULL));
+    hw_irq_callback(GP_PIN_IN_1);
+    TEST_ASSERT_EQUAL(1U, irq_cnt);
+}
+
 #endif
\ No newline at end of file
@@ -1,16 +1,257 @@
 #ifdef TEST
 
 #include "ha_iic.h"
+#include "ha_iic_private.h"
+#include "mock_ha_timer.h"
 #include "mock_mp_iic.h"
+#include "su_profiler.h"
+#include "su_trace.h"
 #include "unity.h"
 
-void setUp(void) {}
+#define SIM_TIMEOUT_MS     (10U)
+#define SIM_XFER_US        (50U)   // healthy register read
+#define SIM_NACK_US        (20U)   // address phase not acknowledged
+#define SIM_RECOVER_US     (150U)  // 9 SCL pulses, STOP and peripheral init
+/// Dead bus: one timeout and the failed recovery
+#define SIM_XFER_MAX_US    (SIM_TIMEOUT_MS * 1000U + SIM_RECOVER_US)
+/// Bus stuck again right after a successful recovery: the retry times out once more
+#define SIM_RESTALL_MAX_US (2U * SIM_TIMEOUT_MS * 1000U + SIM_RECOVER_US)
+
+typedef enum
+{
+    SIM_BUS_OK = 0x00,
+    SIM_BUS_NACK,
+    SIM_BUS_STUCK_RECOVERABLE,
+    SIM_BUS_STUCK_AGAIN, // recovery succeeds, the slave holds SDA again
+    SIM_BUS_STUCK,
+} sim_bus_state_t;
+
+/// Simulated bus, each operation advances the simulated CPU time
+static sim_bus_state_t g_sim_state;
+static uint32_t        g_sim_time_us;
+static uint32_t        g_sim_xfer_cnt;
+static uint32_t        g_sim_recover_cnt;
+
+static response_status_t fake_init(void)
+{
+    return RET_OK;
+}
+
+static response_status_t fake_mem_read(uint8_t p_ifc_index, uint8_t p_dev_addr, uint16_t p_mem_addr,
+                                       uint8_t p_mem_size, uint8_t* const ppt_data, size_t p_len,
+                                       timeout_t p_timeout_ms)
+{
+    g_sim_xfer_cnt++;
+
+    switch (g_sim_state)
+    {
+        case SIM_BUS_OK:
+            g_sim_time_us += SIM_XFER_US;
+            return RET_OK;
+        case SIM_BUS_NACK:
+            g_sim_time_us += SIM_NACK_US;
+            return RET_ERROR;
+        default:
+            /// SDA held low, the transfer waits for the bus until the timeout
+            g_sim_time_us += p_timeout_ms * 1000U;
+            return RET_BUSY;
+    }
+}
+
+static response_status_t fake_bus_recover(uint8_t p_ifc_index)
+{
+    g_sim_recover_cnt++;
+    g_sim_time_us += SIM_RECOVER_US;
+
+    if (g_sim_state == SIM_BUS_STUCK_RECOVERABLE)
+    {
+        g_sim_state = SIM_BUS_OK;
+    }
+
+    return (g_sim_state == SIM_BUS_STUCK) ? RET_ERROR : RET_OK;
+}
+
+static struct st_iic_driver_ifc g_fake_ifc = {
+    .init        = fake_init,
+    .mem_read    = fake_mem_read,
+    .bus_recover = fake_bus_recover,
+};
+
+static iic_driver_t g_fake_drv = { .api = &g_fake_ifc, .hw_inst_cnt = 1U };
+
+uint32_t ha_timer_get_cpu_time_us_stub(int cmock_num_calls)
+{
+    return g_sim_time_us;
+}
+
+static response_status_t read_reg(uint8_t p_dev_addr)
+{
+    uint8_t data = 0U;
+
+    return ha_iic_master_mem_read(IIC_PORT1,
+                                  p_dev_addr,
+                                  &data,
+                                  sizeof(data),
+                                  0x00,
+                                  HW_IIC_MEM_SZ_8BIT,
+                                  SIM_TIMEOUT_MS);
+}
+
+void setUp(void)
+{
+    g_sim_state       = SIM_BUS_OK;
+    g_sim_time_us     = 0U;
+    g_sim_xfer_cnt    = 0U;
+    g_sim_recover_cnt = 0U;
+
+    ha_timer_init_IgnoreAndReturn(RET_OK);
+    ha_timer_get_cpu_time_us_StubWithCallback(ha_timer_get_cpu_time_us_stub);
+    iic_driver_register_IgnoreAndReturn(&g_fake_drv);
+
+    /// Driver stays initialized over the tests, each test uses its own device
+    TEST_ASSERT_EQUAL(RET_OK, ha_iic_init());
+    g_fake_drv.hw_inst_cnt = 1U;
+}
 
 void tearDown(void) {}
 
-void test_ha_iic_NeedToImplement(void)
+void test_ha_iic_healthy_bus_should_not_retry(void)
+{
+    iic_bus_stats_t bus_before = { 0U };
+    iic_bus_stats_t bus_after  = { 0U };
+    iic_dev_stats_t dev        = { 0U };
+
+    ha_iic_get_bus_stats(IIC_PORT1, &bus_before);
+
+    TEST_ASSERT_EQUAL(RET_OK, read_reg(0x10));
+
+    ha_iic_get_bus_stats(IIC_PORT1, &bus_after);
+    TEST_ASSERT_EQUAL(1U, g_sim_xfer_cnt);
+    TEST_ASSERT_EQUAL(bus_before.retry_cnt, bus_after.retry_cnt);
+    TEST_ASSERT_EQUAL(RET_OK, ha_iic_get_dev_stats(IIC_PORT1, 0x10, &dev));
+    TEST_ASSERT_EQUAL(1U, dev.xfer_cnt);
+    TEST_ASSERT_EQUAL(0U, dev.err_cnt);
+}
+
+void test_ha_iic_stuck_bus_should_be_recovered_and_retried(void)
+{
+    iic_bus_stats_t bus_before = { 0U };
+    iic_bus_stats_t bus_after  = { 0U };
+
+    ha_iic_get_bus_stats(IIC_PORT1, &bus_before);
+    g_sim_state = SIM_BUS_STUCK_RECOVERABLE;
+
+    TEST_ASSERT_EQUAL(RET_OK, read_reg(0x11));
+
+    ha_iic_get_bus_stats(IIC_PORT1, &bus_after);
+    TEST_ASSERT_EQUAL(2U, g_sim_xfer_cnt);
+    TEST_ASSERT_EQUAL(1U, g_sim_recover_cnt);
+    TEST_ASSERT_EQUAL(bus_before.stall_cnt + 1U, bus_after.stall_cnt);
+    TEST_ASSERT_EQUAL(bus_before.recover_cnt + 1U, bus_after.recover_cnt);
+    TEST_ASSERT_EQUAL(bus_before.retry_cnt + 1U, bus_after.retry_cnt);
+    TEST_ASSERT_EQUAL(SIM_RECOVER_US, bus_after.last_recover_us);
+}
+
+void test_ha_iic_nack_should_be_retried_without_recovery(void)
+{
+    g_sim_state = SIM_BUS_NACK;
+
+    TEST_ASSERT_EQUAL(RET_ERROR, read_reg(0x12));
+
+    TEST_ASSERT_EQUAL(3U, g_sim_xfer_cnt);
+    TEST_ASSERT_EQUAL(0U, g_sim_recover_cnt);
+}
+
+void test_ha_iic_stuck_bus_should_bound_call_latency(void)
+{
+    iic_bus_stats_t bus = { 0U };
+
+    g_sim_state = SIM_BUS_STUCK;
+
+    TEST_ASSERT_EQUAL(RET_BUSY, read_reg(0x13));
+
+    /// No retry once the recovery failed
+    ha_iic_get_bus_stats(IIC_PORT1, &bus);
+    TEST_ASSERT_EQUAL(1U, g_sim_xfer_cnt);
+    TEST_ASSERT_EQUAL(1U, g_sim_recover_cnt);
+    TEST_ASSERT_LESS_OR_EQUAL(SIM_XFER_MAX_US, g_sim_time_us);
+    /// No call of the run took longer than a bus stuck again after its recovery
+    TEST_ASSERT_LESS_OR_EQUAL(SIM_RESTALL_MAX_US, bus.max_xfer_us);
+    TEST_ASSERT_TRUE(bus.recover_fail_cnt > 0U);
+}
+
+void test_ha_iic_bus_stuck_again_after_recovery_should_be_retried_once(void)
+{
+    g_sim_state = SIM_BUS_STUCK_AGAIN;
+
+    TEST_ASSERT_EQUAL(RET_BUSY, read_reg(0x16));
+
+    TEST_ASSERT_EQUAL(2U, g_sim_xfer_cnt);
+    TEST_ASSERT_EQUAL(1U, g_sim_recover_cnt);
+    TEST_ASSERT_LESS_OR_EQUAL(SIM_RESTALL_MAX_US, g_sim_time_us);
+}
+
+void test_ha_iic_failing_device_should_be_backed_off(void)
 {
-    TEST_IGNORE_MESSAGE("Need to Implement ha_iic");
+    iic_dev_stats_t dev = { 0U };
+
+    g_sim_state = SIM_BUS_STUCK;
+
+    /// attempts at call 1, 2, 4 and 7, the calls in between are skipped
+    for (uint8_t i = 0U; i < 10U; i++)
+    {
+        TEST_ASSERT_EQUAL(RET_BUSY, read_reg(0x14));
+    }
+
+    TEST_ASSERT_EQUAL(4U, g_sim_xfer_cnt);
+    TEST_ASSERT_LESS_OR_EQUAL(4U * SIM_XFER_MAX_US, g_sim_time_us);
+    TEST_ASSERT_EQUAL(RET_OK, ha_iic_get_dev_stats(IIC_PORT1, 0x14, &dev));
+    TEST_ASSERT_EQUAL(4U, dev.err_cnt);
+    TEST_ASSERT_EQUAL(6U, dev.skip_cnt);
+    TEST_ASSERT_EQUAL(4U, dev.consec_err_cnt);
+}
+
+void test_ha_iic_nack_should_not_back_off_device(void)
+{
+    iic_dev_stats_t dev = { 0U };
+
+    g_sim_state = SIM_BUS_NACK;
+    TEST_ASSERT_EQUAL(RET_ERROR, read_reg(0x17));
+    TEST_ASSERT_EQUAL(RET_ERROR, read_reg(0x17));
+
+    g_sim_state = SIM_BUS_OK;
+    TEST_ASSERT_EQUAL(RET_OK, read_reg(0x17));
+
+    TEST_ASSERT_EQUAL(RET_OK, ha_iic_get_dev_stats(IIC_PORT1, 0x17, &dev));
+    TEST_ASSERT_EQUAL(0U, dev.skip_cnt);
+    TEST_ASSERT_EQUAL(2U, dev.err_cnt);
+}
+
+void test_ha_iic_backed_off_device_should_resume_after_success(void)
+{
+    iic_dev_stats_t dev = { 0U };
+
+    g_sim_state = SIM_BUS_STUCK;
+    TEST_ASSERT_EQUAL(RET_BUSY, read_reg(0x15));
+    TEST_ASSERT_EQUAL(RET_BUSY, read_reg(0x15));
+    g_sim_xfer_cnt = 0U;
+    TEST_ASSERT_EQUAL(RET_BUSY, read_reg(0x15));
+    TEST_ASSERT_EQUAL(0U, g_sim_xfer_cnt);
+
+    g_sim_state = SIM_BUS_OK;
+    TEST_ASSERT_EQUAL(RET_OK, read_reg(0x15));
+    TEST_ASSERT_EQUAL(RET_OK, read_reg(0x15));
+
+    TEST_ASSERT_EQUAL(RET_OK, ha_iic_get_dev_stats(IIC_PORT1, 0x15, &dev));
+    TEST_ASSERT_EQUAL(0U, dev.consec_err_cnt);
+    TEST_ASSERT_EQUAL(1U, dev.skip_cnt);
+}
+
+void test_ha_iic_get_dev_stats_of_unknown_device_should_return_not_found(void)
+{
+    iic_dev_stats_t dev = { 0U };
+
+    TEST_ASSERT_EQUAL(RET_NOT_FOUND, ha_iic_get_dev_stats(IIC_PORT1, 0x7E, &dev));
 }
 
-#endif // TEST
\ No newline at end of file
+#endif // TEST
@@ -2,6 +2,7 @@
 
 #include "dd_bmp388.h"
 #include "dd_bmp388_defs.h"
+#include "mock_ha_gpio.h"
 #include "mock_ha_timer.h"
 #include "mock_ha_iic.h"
 #include "unity.h"
@@ -524,4 +525,177 @@ void test_dd_bmp388_get_error_codes(void)
     }
 }
 
+bmp388_status_t reset_cb_status   = BMP388_ERROR_API;
+uint8_t         reset_cb_call_cnt = 0U;
+
+void reset_done_cb(bmp388_dev_t* ppt_dev, bmp388_status_t p_status)
+{
+    TEST_ASSERT_EQUAL_PTR(baro_sens, ppt_dev);
+    reset_cb_status = p_status;
+    reset_cb_call_cnt++;
+}
+
+void test_dd_bmp388_reset_async_should_not_block(void)
+{
+    uint8_t not_rdy_buf = 0x00;
+    uint8_t cmd_rdy_buf = BIT(4, 1);
+    uint8_t event_buf   = 0x01;
+    uint8_t err_buf     = 0x00;
+
+    reset_cb_call_cnt = 0U;
+
+    // Request only records the deadline, no bus access
+    ha_timer_get_cpu_time_ms_ExpectAndReturn(0U);
+    TEST_ASSERT_EQUAL(RET_OK, dd_bmp388_reset_async(baro_sens, reset_done_cb));
+    TEST_ASSERT_TRUE(dd_bmp388_is_busy(baro_sens));
+    TEST_ASSERT_EQUAL(RET_BUSY, dd_bmp388_reset_async(baro_sens, reset_done_cb));
+    TEST_ASSERT_EQUAL(BMP388_WAITING_DATA, dd_bmp388_get_data(baro_sens, BMP388_READ_ALL));
+
+    // Command decoder is not ready yet, poll again 10 ms later
+    ha_timer_get_cpu_time_ms_ExpectAndReturn(0U);
+    ha_iic_master_mem_read_ExpectAnyArgsAndReturn(RET_OK);
+    ha_iic_master_mem_read_ReturnThruPtr_ppt_data_buffer(&not_rdy_buf);
+    dd_bmp388_process();
+
+    ha_timer_get_cpu_time_ms_ExpectAndReturn(5U);
+    dd_bmp388_process();
+
+    // Command decoder ready, soft reset is written
+    ha_timer_get_cpu_time_ms_ExpectAndReturn(10U);
+    ha_iic_master_mem_read_ExpectAnyArgsAndReturn(RET_OK);
+    ha_iic_master_mem_read_ReturnThruPtr_ppt_data_buffer(&cmd_rdy_buf);
+    ha_iic_master_mem_write_ExpectAnyArgsAndReturn(RET_OK);
+    dd_bmp388_process();
+    TEST_ASSERT_TRUE(dd_bmp388_is_busy(baro_sens));
+
+    // Sensor still booting
+    ha_timer_get_cpu_time_ms_ExpectAndReturn(34U);
+    dd_bmp388_process();
+    TEST_ASSERT_EQUAL(0U, reset_cb_call_cnt);
+
+    // Reset settled, event and error registers are checked
+    ha_timer_get_cpu_time_ms_ExpectAndReturn(35U);
+    ha_iic_master_mem_read_ExpectAnyArgsAndReturn(RET_OK);
+    ha_iic_master_mem_read_ReturnThruPtr_ppt_data_buffer(&event_buf);
+    ha_iic_master_mem_read_ExpectAnyArgsAndReturn(RET_OK);
+    ha_iic_master_mem_read_ReturnThruPtr_ppt_data_buffer(&err_buf);
+    dd_bmp388_process();
+
+    TEST_ASSERT_EQUAL(1U, reset_cb_call_cnt);
+    TEST_ASSERT_EQUAL(BMP388_NO_ERROR, reset_cb_status);
+    TEST_ASSERT_FALSE(dd_bmp388_is_busy(baro_sens));
+}
+
+void test_dd_bmp388_reset_async_cmd_not_ready_should_time_out(void)
+{
+    uint8_t not_rdy_buf = 0x00;
+
+    reset_cb_call_cnt = 0U;
+
+    ha_timer_get_cpu_time_ms_ExpectAndReturn(UINT32_MAX - 50U);
+    TEST_ASSERT_EQUAL(RET_OK, dd_bmp388_reset_async(baro_sens, reset_done_cb));
+
+    // Deadline crosses the counter wrap-around
+    ha_timer_get_cpu_time_ms_ExpectAndReturn(UINT32_MAX - 50U);
+    ha_iic_master_mem_read_ExpectAnyArgsAndReturn(RET_OK);
+    ha_iic_master_mem_read_ReturnThruPtr_ppt_data_buffer(&not_rdy_buf);
+    dd_bmp388_process();
+    TEST_ASSERT_EQUAL(0U, reset_cb_call_cnt);
+
+    ha_timer_get_cpu_time_ms_ExpectAndReturn(49U);
+    ha_iic_master_mem_read_ExpectAnyArgsAndReturn(RET_OK);
+    ha_iic_master_mem_read_ReturnThruPtr_ppt_data_buffer(&not_rdy_buf);
+    dd_bmp388_process();
+
+    TEST_ASSERT_EQUAL(1U, reset_cb_call_cnt);
+    TEST_ASSERT_EQUAL(BMP388_ERROR_API, reset_cb_status);
+    TEST_ASSERT_FALSE(dd_bmp388_is_busy(baro_sens));
+}
+
+gpio_irq_callback_t drdy_irq_callback = NULL;
+gpio_pins_t         drdy_irq_pin      = GP_PIN_CNT;
+uint32_t            iic_read_cnt      = 0U;
+
+response_status_t ha_gpio_register_callback_stub(gpio_pins_t p_pin, gpio_irq_callback_t ppt_callback,
+                                                 int cmock_num_calls)
+{
+    drdy_irq_pin = p_pin;
+    drdy_irq_callback = ppt_callback;
+    return RET_OK;
+}
+
+response_status_t ha_iic_master_mem_read_burst_stub(iic_comm_port_t p_port, uint8_t p_slave_addr,
+                                                    uint8_t* ppt_data_buffer, size_t p_data_size,
+                                                    uint16_t p_mem_addr, i2c_mem_size_t p_mem_size,
+                                                    timeout_t p_timeout_ms, int cmock_num_calls)
+{
+    const uint8_t burst[] = { 0x80, 0x0A, 0x6C, 0x00, 0x62, 0x81, 0x00, 0x00, 0x10, 0x20, 0x30 };
+
+    TEST_ASSERT_EQUAL_HEX8(BMP388_REG_DATA_BURST, p_mem_addr);
+    TEST_ASSERT_EQUAL(sizeof(burst), p_data_size);
+    memcpy(ppt_data_buffer, burst, sizeof(burst));
+    iic_read_cnt++;
+    return RET_OK;
+}
+
+void test_dd_bmp388_attach_drdy_pin_should_register_gpio_callback(void)
+{
+    ha_gpio_init_ExpectAndReturn(RET_OK);
+    ha_gpio_register_callback_StubWithCallback(ha_gpio_register_callback_stub);
+
+    TEST_ASSERT_EQUAL(RET_OK, dd_bmp388_attach_drdy_pin(baro_sens, GP_PIN_IN_1));
+    TEST_ASSERT_EQUAL(GP_PIN_IN_1, drdy_irq_pin);
+    TEST_ASSERT_NOT_NULL(drdy_irq_callback);
+}
+
+void test_dd_bmp388_get_data_without_drdy_irq_should_not_access_bus(void)
+{
+    baro_sens->settings.int_settings.int_enable = BMP388_INT_ENABLE_DRDY;
+
+    // Any bus access would be an unexpected mock call
+    for (uint8_t i = 0; i < 10U; i++)
+    {
+        TEST_ASSERT_EQUAL(BMP388_WAITING_DATA, dd_bmp388_get_data(baro_sens, BMP388_READ_ALL));
+    }
+}
+
+void test_dd_bmp388_get_data_with_drdy_irq_should_read_once_per_sample(void)
+{
+    const uint32_t sample_cnt = 10U;
+    const uint32_t loops_per_sample = 5U;
+    uint32_t       new_data_cnt = 0U;
+
+    baro_sens->settings.int_settings.int_enable = BMP388_INT_ENABLE_DRDY;
+    iic_read_cnt = 0U;
+    ha_iic_master_mem_read_StubWithCallback(ha_iic_master_mem_read_burst_stub);
+
+    for (uint32_t sample = 0; sample < sample_cnt; sample++)
+    {
+        // Simulated EXTI edge on the sensor INT pin
+        drdy_irq_callback(GP_PIN_IN_1);
+
+        for (uint32_t loop = 0; loop < loops_per_sample; loop++)
+        {
+            if (dd_bmp388_get_data(baro_sens, BMP388_READ_ALL) == BMP388_NO_ERROR)
+            {
+                new_data_cnt++;
+            }
+        }
+    }
+
+    TEST_ASSERT_EQUAL(sample_cnt, new_data_cnt);
+    TEST_ASSERT_EQUAL(sample_cnt, iic_read_cnt);
+    TEST_ASSERT_EQUAL(0x302010, baro_sens->data.sensortime);
+    TEST_ASSERT_EQUAL_FLOAT(24.6625, baro_sens->data.temperature);
+    TEST_ASSERT_EQUAL_FLOAT(101269.68, baro_sens->data.pressure);
+}
+
+void test_dd_bmp388_get_data_with_drdy_irq_on_other_pin_should_be_ignored(void)
+{
+    baro_sens->settings.int_settings.int_enable = BMP388_INT_ENABLE_DRDY;
+
+    drdy_irq_callback(GP_PIN_LED);
+    TEST_ASSERT_EQUAL(BMP388_WAITING_DATA, dd_bmp388_get_data(baro_sens, BMP388_READ_ALL));
+}
+
 #endif // TEST
\ No newline at end of file
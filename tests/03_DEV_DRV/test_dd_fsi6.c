@@ -1,24 +1,480 @@
-
 #ifdef TEST
 
 #include "unity.h"
 
 #include "dd_fsi6.h"
+#include "dd_fsi6_ibus.h"
+#include "ibus_frame.h"
 #include "mock_ha_input_capture.h"
 #include "mock_ha_timer.h"
+#include "mock_ha_uart.h"
 #include "mock_ps_app_timer.h"
+#include "su_mailbox.h"
+
+#define PULSE_MID_US (1500U)
+#define PULSE_MAX_US (2000U)
+#define IBUS_THR_CH  (2U)
+#define IBUS_AIL_CH  (0U)
+
+static ic_finished_callback_t g_pt_capture_cb;
+static app_timer_callback_t   g_pt_check_cb;
+static app_timer_handler_t    g_check_timer;
+static uint32_t               g_counter_us;
+static uart_dma_rx_cb         g_pt_rx_cb;
+static uint8_t*               g_pt_rx_buf;
+static size_t                 g_rx_buf_sz;
+static size_t                 g_rx_write_pos;
+
+static response_status_t register_callback_stub(input_capture_channel_t p_chnl,
+                                                ic_finished_callback_t  ppt_callback,
+                                                int                     cmock_num_calls)
+{
+    g_pt_capture_cb = ppt_callback;
+    return RET_OK;
+}
+
+static response_status_t app_timer_create_stub(app_timer_handler_t** ppt_timer_handler,
+                                               bool_t                p_oneshot_timer,
+                                               app_timer_callback_t  ppt_callback,
+                                               ps_exec_ctx_t         p_exec_ctx,
+                                               int                   cmock_num_calls)
+{
+    TEST_ASSERT_FALSE(p_oneshot_timer);
+    TEST_ASSERT_EQUAL(PS_EXEC_ISR, p_exec_ctx);
+    g_pt_check_cb      = ppt_callback;
+    *ppt_timer_handler = &g_check_timer;
+    return RET_OK;
+}
+
+static uint32_t get_counter_stub(int cmock_num_calls)
+{
+    return g_counter_us;
+}
+
+static response_status_t register_rx_callback_stub(uart_comm_port_t p_port,
+                                                   uart_dma_rx_cb   ppt_rx_cb,
+                                                   int              cmock_num_calls)
+{
+    TEST_ASSERT_EQUAL(UART_RC_PORT, p_port);
+    g_pt_rx_cb = ppt_rx_cb;
+    return RET_OK;
+}
+
+static response_status_t receive_start_stub(uart_comm_port_t p_port,
+                                            uint8_t*         ppt_data_buffer,
+                                            size_t           p_data_size,
+                                            int              cmock_num_calls)
+{
+    TEST_ASSERT_EQUAL(UART_RC_PORT, p_port);
+    g_pt_rx_buf    = ppt_data_buffer;
+    g_rx_buf_sz    = p_data_size;
+    g_rx_write_pos = 0U;
+    return RET_OK;
+}
+
+/// Builds an iBUS frame, the channels not given are centered
+static void make_ibus_frame(uint8_t* ppt_frame, uint16_t p_ail_us, uint16_t p_thr_us)
+{
+    uint16_t ch_us[FSI6_IBUS_CH_CNT];
+
+    for (uint32_t i = 0U; i < FSI6_IBUS_CH_CNT; i++)
+    {
+        ch_us[i] = PULSE_MID_US;
+    }
+    ch_us[IBUS_AIL_CH] = p_ail_us;
+    ch_us[IBUS_THR_CH] = p_thr_us;
+    ibus_build_frame(ppt_frame, ch_us);
+}
+
+/// Writes the bytes around the DMA ring and raises the receive event after them
+static void dma_receive(const uint8_t* ppt_data, uint32_t p_len)
+{
+    for (uint32_t i = 0U; i < p_len; i++)
+    {
+        g_pt_rx_buf[g_rx_write_pos] = ppt_data[i];
+        g_rx_write_pos              = (g_rx_write_pos + 1U) % g_rx_buf_sz;
+    }
+    g_pt_rx_cb(UART_RC_PORT, UART_DMA_RX_EVT_DATA, g_rx_write_pos);
+}
+
+static void init_fsi6_ibus(void)
+{
+    ha_uart_init_ExpectAndReturn(RET_OK);
+    ha_uart_dma_register_rx_callback_StubWithCallback(register_rx_callback_stub);
+    ps_app_timer_init_ExpectAndReturn(RET_OK);
+    ps_app_timer_create_StubWithCallback(app_timer_create_stub);
+    ps_app_timer_start_ExpectAndReturn(&g_check_timer,
+                                       FSI6_CHECK_PERIOD_MS,
+                                       APP_TIMER_UNIT_MS,
+                                       RET_OK);
+    ha_uart_dma_receive_start_StubWithCallback(receive_start_stub);
+
+    TEST_ASSERT_EQUAL(RET_OK, dd_fsi6_init_ibus());
+}
+
+static void init_fsi6(bool_t p_isr)
+{
+    ha_input_capture_init_ExpectAndReturn(RET_OK);
+    ha_input_capture_register_callback_StubWithCallback(register_callback_stub);
+    ps_app_timer_init_ExpectAndReturn(RET_OK);
+    ps_app_timer_create_StubWithCallback(app_timer_create_stub);
+    ps_app_timer_start_ExpectAndReturn(&g_check_timer,
+                                       FSI6_CHECK_PERIOD_MS,
+                                       APP_TIMER_UNIT_MS,
+                                       RET_OK);
+
+    TEST_ASSERT_EQUAL(RET_OK, dd_fsi6_init(p_isr));
+}
+
+/// Runs the periodic staleness check for `p_ms`
+static void run_checks(uint32_t p_ms)
+{
+    for (uint32_t i = 0U; i < (p_ms / FSI6_CHECK_PERIOD_MS); i++)
+    {
+        g_counter_us += FSI6_CHECK_PERIOD_MS * 1000U;
+        g_pt_check_cb();
+    }
+}
 
 void setUp(void)
 {
+    g_pt_capture_cb = NULL;
+    g_pt_check_cb   = NULL;
+    g_pt_rx_cb      = NULL;
+    g_pt_rx_buf     = NULL;
+    g_counter_us    = 0xFFFFF000U;
+    ha_timer_get_counter_StubWithCallback(get_counter_stub);
+    ps_app_timer_delete_IgnoreAndReturn(RET_OK);
+}
+
+void tearDown(void) {}
+
+void test_dd_fsi6_init_should_capture_continuously_and_start_the_check(void)
+{
+    ha_input_capture_request_capture_ExpectAndReturn(INPUT_CAPTURE_CHANNEL_1,
+                                                     IC_MEASURE_PWM,
+                                                     IC_CONTINUOUS_CAPTURE,
+                                                     RET_OK);
+    ha_input_capture_request_capture_ExpectAndReturn(INPUT_CAPTURE_CHANNEL_2,
+                                                     IC_MEASURE_PWM,
+                                                     IC_CONTINUOUS_CAPTURE,
+                                                     RET_OK);
+    init_fsi6(TRUE);
+
+    TEST_ASSERT_NOT_NULL(g_pt_capture_cb);
+    TEST_ASSERT_NOT_NULL(g_pt_check_cb);
+    /// Nothing received yet
+    TEST_ASSERT_TRUE(dd_fsi6_is_failsafe());
+}
+
+void test_dd_fsi6_input_without_pwm_mode_should_fall_back_to_edge_capture(void)
+{
+    ha_input_capture_request_capture_ExpectAndReturn(INPUT_CAPTURE_CHANNEL_1,
+                                                     IC_MEASURE_PWM,
+                                                     IC_CONTINUOUS_CAPTURE,
+                                                     RET_NOT_SUPPORTED);
+    ha_input_capture_request_capture_ExpectAndReturn(INPUT_CAPTURE_CHANNEL_1,
+                                                     IC_MEASURE_PULSE_WIDTH,
+                                                     IC_CONTINUOUS_CAPTURE,
+                                                     RET_OK);
+    ha_input_capture_request_capture_ExpectAndReturn(INPUT_CAPTURE_CHANNEL_2,
+                                                     IC_MEASURE_PWM,
+                                                     IC_CONTINUOUS_CAPTURE,
+                                                     RET_OK);
+    init_fsi6(TRUE);
+}
+
+void test_dd_fsi6_capture_should_publish_the_pulse_with_its_timestamp(void)
+{
+    fsi6_sample_t sample = { 0U };
+
+    ha_input_capture_request_capture_IgnoreAndReturn(RET_OK);
+    init_fsi6(TRUE);
+
+    g_counter_us = 12345U;
+    g_pt_capture_cb(INPUT_CAPTURE_CHANNEL_2, PULSE_MAX_US);
+
+    TEST_ASSERT_EQUAL(RET_OK, dd_fsi6_get_sample(FSI6_IN_R_S_LR, &sample));
+    TEST_ASSERT_EQUAL(PULSE_MAX_US, sample.pulse_us);
+    TEST_ASSERT_EQUAL(12345U, sample.timestamp_us);
+    /// Fresh from the next check on
+    TEST_ASSERT_FALSE(sample.is_fresh);
+
+    run_checks(FSI6_CHECK_PERIOD_MS);
+
+    TEST_ASSERT_EQUAL(RET_OK, dd_fsi6_get_sample(FSI6_IN_R_S_LR, &sample));
+    TEST_ASSERT_TRUE(sample.is_fresh);
+    TEST_ASSERT_EQUAL(RET_OK, dd_fsi6_get_sample(FSI6_IN_L_S_UD, &sample));
+    TEST_ASSERT_FALSE(sample.is_fresh);
+}
+
+void test_dd_fsi6_missing_pulses_should_make_the_input_stale(void)
+{
+    fsi6_sample_t sample = { 0U };
+
+    ha_input_capture_request_capture_IgnoreAndReturn(RET_OK);
+    init_fsi6(TRUE);
+
+    g_pt_capture_cb(INPUT_CAPTURE_CHANNEL_1, PULSE_MID_US);
+    g_pt_capture_cb(INPUT_CAPTURE_CHANNEL_2, PULSE_MID_US);
+    run_checks(FSI6_CHECK_PERIOD_MS);
+    TEST_ASSERT_FALSE(dd_fsi6_is_failsafe());
+
+    run_checks(FSI6_TIMEOUT_MS - FSI6_CHECK_PERIOD_MS);
+    TEST_ASSERT_FALSE(dd_fsi6_is_failsafe());
+
+    run_checks(FSI6_CHECK_PERIOD_MS);
+    TEST_ASSERT_TRUE(dd_fsi6_is_failsafe());
+    TEST_ASSERT_EQUAL(RET_OK, dd_fsi6_get_sample(FSI6_IN_L_S_UD, &sample));
+    TEST_ASSERT_FALSE(sample.is_fresh);
+    /// The last pulse is kept for the caller
+    TEST_ASSERT_EQUAL(PULSE_MID_US, sample.pulse_us);
+}
+
+void test_dd_fsi6_one_silent_input_should_trigger_the_failsafe(void)
+{
+    ha_input_capture_request_capture_IgnoreAndReturn(RET_OK);
+    init_fsi6(TRUE);
+
+    for (uint32_t frame = 0U; frame < 5U; frame++)
+    {
+        g_pt_capture_cb(INPUT_CAPTURE_CHANNEL_1, PULSE_MID_US);
+        if (frame == 0U)
+        {
+            g_pt_capture_cb(INPUT_CAPTURE_CHANNEL_2, PULSE_MID_US);
+        }
+        run_checks(20U);
+    }
+
+    TEST_ASSERT_TRUE(dd_fsi6_is_failsafe());
+}
+
+void test_dd_fsi6_pulse_after_a_timeout_should_recover(void)
+{
+    ha_input_capture_request_capture_IgnoreAndReturn(RET_OK);
+    init_fsi6(TRUE);
+
+    run_checks(100U);
+    TEST_ASSERT_TRUE(dd_fsi6_is_failsafe());
+
+    g_pt_capture_cb(INPUT_CAPTURE_CHANNEL_1, PULSE_MID_US);
+    g_pt_capture_cb(INPUT_CAPTURE_CHANNEL_2, PULSE_MID_US);
+    run_checks(FSI6_CHECK_PERIOD_MS);
+
+    TEST_ASSERT_FALSE(dd_fsi6_is_failsafe());
+}
+
+void test_dd_fsi6_read_input_should_never_wait_for_the_receiver(void)
+{
+    uint32_t value = 1U;
+
+    init_fsi6(FALSE);
+
+    ha_input_capture_request_capture_ExpectAndReturn(INPUT_CAPTURE_CHANNEL_1,
+                                                     IC_MEASURE_PWM,
+                                                     IC_CONTINUOUS_CAPTURE,
+                                                     RET_OK);
+    TEST_ASSERT_EQUAL(RET_BUSY, dd_fsi6_read_input(FSI6_IN_L_S_UD, &value));
+    TEST_ASSERT_EQUAL(0U, value);
+
+    /// The capture is started once, no pulse yet
+    TEST_ASSERT_EQUAL(RET_TIMEOUT, dd_fsi6_read_input(FSI6_IN_L_S_UD, &value));
+    TEST_ASSERT_EQUAL(0U, value);
+
+    g_pt_capture_cb(INPUT_CAPTURE_CHANNEL_1, PULSE_MID_US);
+    run_checks(FSI6_CHECK_PERIOD_MS);
+
+    TEST_ASSERT_EQUAL(RET_OK, dd_fsi6_read_input(FSI6_IN_L_S_UD, &value));
+    TEST_ASSERT_EQUAL(PULSE_MID_US, value);
+}
+
+void test_dd_fsi6_single_spike_should_be_filtered_by_the_median(void)
+{
+    fsi6_sample_t sample = { 0U };
+
+    ha_input_capture_request_capture_IgnoreAndReturn(RET_OK);
+    init_fsi6(TRUE);
+
+    g_pt_capture_cb(INPUT_CAPTURE_CHANNEL_1, PULSE_MID_US);
+    g_pt_capture_cb(INPUT_CAPTURE_CHANNEL_1, PULSE_MID_US);
+    g_pt_capture_cb(INPUT_CAPTURE_CHANNEL_1, PULSE_MAX_US);
+    TEST_ASSERT_EQUAL(RET_OK, dd_fsi6_get_sample(FSI6_IN_L_S_UD, &sample));
+    TEST_ASSERT_EQUAL(PULSE_MID_US, sample.pulse_us);
+
+    g_pt_capture_cb(INPUT_CAPTURE_CHANNEL_1, PULSE_MID_US);
+    TEST_ASSERT_EQUAL(RET_OK, dd_fsi6_get_sample(FSI6_IN_L_S_UD, &sample));
+    TEST_ASSERT_EQUAL(PULSE_MID_US, sample.pulse_us);
+
+    /// A step goes through one frame later
+    g_pt_capture_cb(INPUT_CAPTURE_CHANNEL_1, PULSE_MAX_US);
+    g_pt_capture_cb(INPUT_CAPTURE_CHANNEL_1, PULSE_MAX_US);
+    TEST_ASSERT_EQUAL(RET_OK, dd_fsi6_get_sample(FSI6_IN_L_S_UD, &sample));
+    TEST_ASSERT_EQUAL(PULSE_MAX_US, sample.pulse_us);
+}
+
+void test_dd_fsi6_pulse_out_of_range_should_be_dropped(void)
+{
+    fsi6_sample_t sample = { 0U };
+
+    ha_input_capture_request_capture_IgnoreAndReturn(RET_OK);
+    init_fsi6(TRUE);
+
+    g_counter_us = 5000U;
+    g_pt_capture_cb(INPUT_CAPTURE_CHANNEL_2, PULSE_MID_US);
+    run_checks(FSI6_CHECK_PERIOD_MS);
+
+    g_pt_capture_cb(INPUT_CAPTURE_CHANNEL_2, FSI6_PULSE_MIN_US - 1U);
+    g_pt_capture_cb(INPUT_CAPTURE_CHANNEL_2, FSI6_PULSE_MAX_US + 1U);
+    g_pt_capture_cb(INPUT_CAPTURE_CHANNEL_2, 0U);
+    TEST_ASSERT_EQUAL(RET_OK, dd_fsi6_get_sample(FSI6_IN_R_S_LR, &sample));
+    TEST_ASSERT_EQUAL(PULSE_MID_US, sample.pulse_us);
+    TEST_ASSERT_EQUAL(5000U, sample.timestamp_us);
+
+    /// Only glitches, the input goes stale
+    for (uint32_t i = 0U; i < (FSI6_TIMEOUT_MS / FSI6_CHECK_PERIOD_MS); i++)
+    {
+        g_pt_capture_cb(INPUT_CAPTURE_CHANNEL_2, FSI6_PULSE_MAX_US + 100U);
+        run_checks(FSI6_CHECK_PERIOD_MS);
+    }
+    TEST_ASSERT_EQUAL(RET_OK, dd_fsi6_get_sample(FSI6_IN_R_S_LR, &sample));
+    TEST_ASSERT_FALSE(sample.is_fresh);
+}
+
+void test_dd_fsi6_first_pulse_after_a_timeout_should_not_be_held_by_old_ones(void)
+{
+    fsi6_sample_t sample = { 0U };
+
+    ha_input_capture_request_capture_IgnoreAndReturn(RET_OK);
+    init_fsi6(TRUE);
+
+    g_pt_capture_cb(INPUT_CAPTURE_CHANNEL_1, PULSE_MID_US);
+    g_pt_capture_cb(INPUT_CAPTURE_CHANNEL_1, PULSE_MID_US);
+    run_checks(100U);
+
+    g_pt_capture_cb(INPUT_CAPTURE_CHANNEL_1, PULSE_MAX_US);
+    TEST_ASSERT_EQUAL(RET_OK, dd_fsi6_get_sample(FSI6_IN_L_S_UD, &sample));
+    TEST_ASSERT_EQUAL(PULSE_MAX_US, sample.pulse_us);
+}
+
+void test_dd_fsi6_get_sample_with_invalid_params_should_return_param_error(void)
+{
+    fsi6_sample_t sample = { 0U };
+
+    ha_input_capture_request_capture_IgnoreAndReturn(RET_OK);
+    init_fsi6(TRUE);
+
+    TEST_ASSERT_EQUAL(RET_PARAM_ERROR, dd_fsi6_get_sample(FSI6_IN_L_S_UD, NULL));
+    TEST_ASSERT_EQUAL(RET_PARAM_ERROR, dd_fsi6_get_sample(FSI6_IN_CNT, &sample));
 }
 
-void tearDown(void)
+void test_dd_fsi6_get_frame_with_input_capture_should_not_be_supported(void)
 {
+    fsi6_frame_t frame = { 0U };
+
+    ha_input_capture_request_capture_IgnoreAndReturn(RET_OK);
+    init_fsi6(TRUE);
+
+    TEST_ASSERT_EQUAL(RET_NOT_SUPPORTED, dd_fsi6_get_frame(&frame));
 }
 
-void test_dd_fsi6_NeedToImplement(void)
+void test_dd_fsi6_ibus_init_should_receive_on_the_rc_port(void)
 {
-    TEST_IGNORE_MESSAGE("Need to Implement dd_fsi6");
+    init_fsi6_ibus();
+
+    TEST_ASSERT_NOT_NULL(g_pt_rx_cb);
+    TEST_ASSERT_NOT_NULL(g_pt_rx_buf);
+    TEST_ASSERT_TRUE(g_rx_buf_sz >= (2U * FSI6_IBUS_FRAME_LEN));
+    TEST_ASSERT_TRUE(dd_fsi6_is_failsafe());
+}
+
+void test_dd_fsi6_ibus_frame_should_publish_all_channels_at_once(void)
+{
+    uint8_t      buf[FSI6_IBUS_FRAME_LEN];
+    fsi6_frame_t frame = { 0U };
+    uint32_t     value = 0U;
+
+    init_fsi6_ibus();
+    make_ibus_frame(buf, 1100U, 1900U);
+
+    /// A partial frame publishes nothing
+    dma_receive(buf, 20U);
+    TEST_ASSERT_EQUAL(RET_OK, dd_fsi6_get_frame(&frame));
+    TEST_ASSERT_EQUAL(0U, frame.ch_us[IBUS_THR_CH]);
+
+    g_counter_us = 4321U;
+    dma_receive(&buf[20], FSI6_IBUS_FRAME_LEN - 20U);
+    run_checks(FSI6_CHECK_PERIOD_MS);
+
+    TEST_ASSERT_EQUAL(RET_OK, dd_fsi6_get_frame(&frame));
+    TEST_ASSERT_TRUE(frame.is_fresh);
+    TEST_ASSERT_EQUAL(4321U, frame.timestamp_us);
+    TEST_ASSERT_EQUAL(1100U, frame.ch_us[IBUS_AIL_CH]);
+    TEST_ASSERT_EQUAL(1900U, frame.ch_us[IBUS_THR_CH]);
+    TEST_ASSERT_EQUAL(1500U, frame.ch_us[FSI6_IBUS_CH_CNT - 1U]);
+
+    TEST_ASSERT_EQUAL(RET_OK, dd_fsi6_read_input(FSI6_IN_L_S_UD, &value));
+    TEST_ASSERT_EQUAL(1900U, value);
+    TEST_ASSERT_EQUAL(RET_OK, dd_fsi6_read_input(FSI6_IN_R_S_LR, &value));
+    TEST_ASSERT_EQUAL(1100U, value);
+    TEST_ASSERT_FALSE(dd_fsi6_is_failsafe());
+}
+
+void test_dd_fsi6_ibus_frames_across_the_ring_wrap_should_be_parsed(void)
+{
+    uint8_t      buf[FSI6_IBUS_FRAME_LEN];
+    uint8_t      noise[7] = { 0x00U, 0x20U, 0x13U, 0x37U, 0x20U, 0x40U, 0x01U };
+    fsi6_frame_t frame    = { 0U };
+
+    init_fsi6_ibus();
+
+    /// Line noise shifts the frames against the ring, they wrap around its end
+    dma_receive(noise, sizeof(noise));
+    for (uint16_t i = 0U; i < 10U; i++)
+    {
+        make_ibus_frame(buf, 1000U + i, 2000U - i);
+        dma_receive(buf, sizeof(buf));
+
+        TEST_ASSERT_EQUAL(RET_OK, dd_fsi6_get_frame(&frame));
+        TEST_ASSERT_EQUAL(1000U + i, frame.ch_us[IBUS_AIL_CH]);
+        TEST_ASSERT_EQUAL(2000U - i, frame.ch_us[IBUS_THR_CH]);
+    }
+}
+
+void test_dd_fsi6_ibus_lost_link_should_trigger_the_failsafe(void)
+{
+    uint8_t  buf[FSI6_IBUS_FRAME_LEN];
+    uint32_t value = 1U;
+
+    init_fsi6_ibus();
+    make_ibus_frame(buf, 1500U, 1000U);
+    dma_receive(buf, sizeof(buf));
+    run_checks(FSI6_CHECK_PERIOD_MS);
+    TEST_ASSERT_FALSE(dd_fsi6_is_failsafe());
+
+    run_checks(FSI6_TIMEOUT_MS);
+
+    TEST_ASSERT_TRUE(dd_fsi6_is_failsafe());
+    TEST_ASSERT_EQUAL(RET_TIMEOUT, dd_fsi6_read_input(FSI6_IN_L_S_UD, &value));
+    TEST_ASSERT_EQUAL(0U, value);
+}
+
+void test_dd_fsi6_ibus_restart_should_drop_the_partial_frame(void)
+{
+    uint8_t      buf[FSI6_IBUS_FRAME_LEN];
+    fsi6_frame_t frame = { 0U };
+
+    init_fsi6_ibus();
+    make_ibus_frame(buf, 1200U, 1300U);
+    dma_receive(buf, 10U);
+
+    /// A receive error restarted the DMA at the start of the ring
+    g_rx_write_pos = 0U;
+    g_pt_rx_cb(UART_RC_PORT, UART_DMA_RX_EVT_RESTART, 0U);
+    dma_receive(buf, sizeof(buf));
+
+    TEST_ASSERT_EQUAL(RET_OK, dd_fsi6_get_frame(&frame));
+    TEST_ASSERT_EQUAL(1200U, frame.ch_us[IBUS_AIL_CH]);
+    TEST_ASSERT_EQUAL(1300U, frame.ch_us[IBUS_THR_CH]);
 }
 
 #endif // TEST
@@ -0,0 +1,138 @@
+#ifdef TEST
+
+#include "unity.h"
+
+#include "dd_fsi6_ibus.h"
+#include "ibus_frame.h"
+
+#include <string.h>
+
+static fsi6_ibus_parser_t g_parser;
+static uint16_t           g_ch_us[FSI6_IBUS_CH_CNT];
+
+/// Builds a frame with channel i at 1000 + p_base + i us
+static void make_frame(uint8_t* ppt_frame, uint16_t p_base)
+{
+    uint16_t ch_us[FSI6_IBUS_CH_CNT];
+
+    for (uint32_t i = 0U; i < FSI6_IBUS_CH_CNT; i++)
+    {
+        ch_us[i] = (uint16_t)(1000U + p_base + i);
+    }
+    ibus_build_frame(ppt_frame, ch_us);
+}
+
+/// Feeds the bytes, returns the number of completed frames
+static uint32_t feed(const uint8_t* ppt_buf, uint32_t p_len)
+{
+    uint32_t frames = 0U;
+
+    for (uint32_t i = 0U; i < p_len; i++)
+    {
+        if (fsi6_ibus_parse(&g_parser, ppt_buf[i], g_ch_us) == TRUE)
+        {
+            frames++;
+        }
+    }
+
+    return frames;
+}
+
+void setUp(void)
+{
+    fsi6_ibus_reset(&g_parser);
+    memset(g_ch_us, 0, sizeof(g_ch_us));
+}
+
+void tearDown(void) {}
+
+void test_fsi6_ibus_valid_frame_should_give_all_channels(void)
+{
+    uint8_t frame[FSI6_IBUS_FRAME_LEN];
+
+    make_frame(frame, 500U);
+
+    /// Nothing before the last byte
+    TEST_ASSERT_EQUAL(0U, feed(frame, FSI6_IBUS_FRAME_LEN - 1U));
+    TEST_ASSERT_EQUAL(1U, feed(&frame[FSI6_IBUS_FRAME_LEN - 1U], 1U));
+
+    for (uint32_t i = 0U; i < FSI6_IBUS_CH_CNT; i++)
+    {
+        TEST_ASSERT_EQUAL(1500U + i, g_ch_us[i]);
+    }
+    TEST_ASSERT_EQUAL(1U, g_parser.frame_cnt);
+    TEST_ASSERT_EQUAL(0U, g_parser.crc_err_cnt);
+}
+
+void test_fsi6_ibus_bad_checksum_should_drop_the_frame(void)
+{
+    uint8_t frame[FSI6_IBUS_FRAME_LEN];
+
+    make_frame(frame, 500U);
+    frame[5] ^= 0x01U;
+
+    TEST_ASSERT_EQUAL(0U, feed(frame, sizeof(frame)));
+    TEST_ASSERT_EQUAL(0U, g_ch_us[0]);
+    TEST_ASSERT_EQUAL(1U, g_parser.crc_err_cnt);
+
+    make_frame(frame, 200U);
+    TEST_ASSERT_EQUAL(1U, feed(frame, sizeof(frame)));
+    TEST_ASSERT_EQUAL(1200U, g_ch_us[0]);
+}
+
+void test_fsi6_ibus_bytes_before_the_header_should_be_skipped(void)
+{
+    uint8_t stream[5U + FSI6_IBUS_FRAME_LEN] = { 0x00U, 0x20U, 0x20U, 0x41U, 0xFFU };
+
+    make_frame(&stream[5], 0U);
+
+    TEST_ASSERT_EQUAL(1U, feed(stream, sizeof(stream)));
+    TEST_ASSERT_EQUAL(1000U, g_ch_us[0]);
+    TEST_ASSERT_EQUAL(0U, g_parser.crc_err_cnt);
+}
+
+void test_fsi6_ibus_frame_inside_a_truncated_frame_should_be_found(void)
+{
+    uint8_t stream[10U + FSI6_IBUS_FRAME_LEN];
+
+    /// The receiver started in the middle of a frame that looks like a header
+    make_frame(stream, 300U);
+    make_frame(&stream[10], 700U);
+
+    TEST_ASSERT_EQUAL(1U, feed(stream, sizeof(stream)));
+    TEST_ASSERT_EQUAL(1700U, g_ch_us[0]);
+    TEST_ASSERT_EQUAL(1U, g_parser.crc_err_cnt);
+}
+
+void test_fsi6_ibus_noisy_stream_should_lose_only_the_hit_frames(void)
+{
+    uint8_t  frame[FSI6_IBUS_FRAME_LEN];
+    uint32_t seed   = 4242U;
+    uint32_t frames = 0U;
+
+    for (uint16_t n = 0U; n < 200U; n++)
+    {
+        make_frame(frame, n);
+        seed = (seed * 1103515245U) + 12345U;
+        if ((n % 10U) == 0U)
+        {
+            frame[2U + ((seed >> 16) % 28U)] ^= 0x10U; // Bit error
+        }
+        frames += feed(frame, sizeof(frame));
+        if ((n % 7U) == 0U)
+        {
+            uint8_t noise = (uint8_t)(seed >> 24);
+
+            frames += feed(&noise, 1U); // Line glitch between two frames
+        }
+        if (((n % 10U) != 0U) && (frames > 0U))
+        {
+            TEST_ASSERT_EQUAL(1000U + n, g_ch_us[0]);
+        }
+    }
+
+    TEST_ASSERT_EQUAL(180U, frames);
+    TEST_ASSERT_EQUAL(180U, g_parser.frame_cnt);
+}
+
+#endif // TEST
@@ -0,0 +1,541 @@
+#ifdef TEST
+
+#include "dd_icm209.h"
+#include "dd_icm209_defs.h"
+#include "mock_ha_iic.h"
+#include "mock_ha_timer.h"
+#include "unity.h"
+
+#include <string.h>
+
+#define SIM_BANK_CNT    (4U)
+#define SIM_BANK_SZ     (128U)
+#define SIM_FIFO_SZ     (512U)
+#define SIM_FRAME_SZ    (20U)
+#define SIM_DMP_MEM_SZ  (0x1000U)
+#define SIM_IMAGE_SZ    (300U)
+#define SIM_PACKET_SZ   (42U)
+/// 90 deg about z in Q30
+#define SIM_Q30_SIN45   (759250125)
+
+/// Simulated ICM-20948 register file, DMP memory and the AK09916 behind its I2C master
+typedef struct
+{
+    uint8_t  regs[SIM_BANK_CNT][SIM_BANK_SZ];
+    uint8_t  bank;
+    uint8_t  ak_regs[0x40];
+    uint8_t  dmp_mem[SIM_DMP_MEM_SZ];
+    /// DMP memory when the program start is set, before the keys patch the image
+    uint8_t  dmp_loaded[SIM_DMP_MEM_SZ];
+    uint8_t  fifo[SIM_FIFO_SZ];
+    uint16_t fifo_cnt;
+    bool_t   fail_fifo_read;
+    uint32_t fifo_rst_cnt;
+    uint32_t bank_sel_cnt;
+    uint32_t transaction_cnt;
+} sim_icm209_t;
+
+static sim_icm209_t g_sim;
+
+static void sim_set_fifo(const uint8_t* ppt_data, uint16_t p_size)
+{
+    memmove(g_sim.fifo, ppt_data, p_size);
+    g_sim.fifo_cnt = p_size;
+    g_sim.regs[0][ICM209_REG_ADDR(ICM209_REG_FIFO_COUNT)]      = (uint8_t)(p_size >> 8U);
+    g_sim.regs[0][ICM209_REG_ADDR(ICM209_REG_FIFO_COUNT) + 1U] = (uint8_t)(p_size & 0xFFU);
+}
+
+/// DMP memory address selected by the bank and start address registers
+static uint8_t* sim_dmp_mem(size_t p_size)
+{
+    uint16_t addr = (uint16_t)((g_sim.regs[0][ICM209_REG_ADDR(ICM209_REG_MEM_BANK_SEL)] << 8U)
+                               | g_sim.regs[0][ICM209_REG_ADDR(ICM209_REG_MEM_START_ADDR)]);
+
+    /// An access never crosses a DMP memory bank
+    TEST_ASSERT_LESS_OR_EQUAL(ICM209_DMP_MEM_BANK_SZ, (addr & 0xFFU) + p_size);
+    TEST_ASSERT_LESS_OR_EQUAL(SIM_DMP_MEM_SZ, addr + p_size);
+
+    return &g_sim.dmp_mem[addr];
+}
+
+static uint32_t sim_dmp_key32(uint16_t p_addr)
+{
+    const uint8_t* pt_key = &g_sim.dmp_mem[p_addr];
+
+    return ((uint32_t)pt_key[0] << 24U) | ((uint32_t)pt_key[1] << 16U)
+           | ((uint32_t)pt_key[2] << 8U) | pt_key[3];
+}
+
+static void sim_slv4_transfer(void)
+{
+    uint8_t addr = g_sim.regs[3][ICM209_REG_ADDR(ICM209_REG_I2C_SLV4_ADDR)];
+    uint8_t reg  = g_sim.regs[3][ICM209_REG_ADDR(ICM209_REG_I2C_SLV4_REG)];
+
+    if ((addr & ICM209_I2C_SLV_ADDR_READ) != 0U)
+    {
+        g_sim.regs[3][ICM209_REG_ADDR(ICM209_REG_I2C_SLV4_DI)] = g_sim.ak_regs[reg];
+    }
+    else
+    {
+        g_sim.ak_regs[reg] = g_sim.regs[3][ICM209_REG_ADDR(ICM209_REG_I2C_SLV4_DO)];
+    }
+    g_sim.regs[0][ICM209_REG_ADDR(ICM209_REG_I2C_MST_STATUS)] |= ICM209_I2C_MST_STATUS_SLV4_DONE;
+}
+
+response_status_t ha_iic_master_mem_write_stub(iic_comm_port_t p_port, uint8_t p_slave_addr,
+                                               const uint8_t* ppt_data_buffer, size_t p_data_size,
+                                               uint16_t p_mem_addr, i2c_mem_size_t p_mem_size,
+                                               timeout_t p_timeout_ms, int cmock_num_calls)
+{
+    TEST_ASSERT_EQUAL_HEX8(ICM209_IIC_ADDR_1, p_slave_addr);
+    g_sim.transaction_cnt++;
+
+    if (p_mem_addr == ICM209_REG_BANK_SEL)
+    {
+        g_sim.bank = ppt_data_buffer[0] >> ICM209_REG_BANK_SEL_POS;
+        g_sim.bank_sel_cnt++;
+        return RET_OK;
+    }
+
+    if ((g_sim.bank == 0U) && (p_mem_addr == ICM209_REG_ADDR(ICM209_REG_MEM_R_W)))
+    {
+        memcpy(sim_dmp_mem(p_data_size), ppt_data_buffer, p_data_size);
+        return RET_OK;
+    }
+
+    for (size_t i = 0; i < p_data_size; i++)
+    {
+        g_sim.regs[g_sim.bank][p_mem_addr + i] = ppt_data_buffer[i];
+    }
+
+    if ((g_sim.bank == 2U) && (p_mem_addr == ICM209_REG_ADDR(ICM209_REG_PRGM_START_ADDR)))
+    {
+        memcpy(g_sim.dmp_loaded, g_sim.dmp_mem, sizeof(g_sim.dmp_loaded));
+    }
+    if ((g_sim.bank == 0U) && (p_mem_addr == ICM209_REG_ADDR(ICM209_REG_FIFO_RST))
+        && (ppt_data_buffer[0] == ICM209_FIFO_RST_ALL))
+    {
+        sim_set_fifo(g_sim.fifo, 0U);
+        g_sim.fifo_rst_cnt++;
+    }
+
+    if ((g_sim.bank == 3U) && (p_mem_addr == ICM209_REG_ADDR(ICM209_REG_I2C_SLV4_CTRL))
+        && ((ppt_data_buffer[0] & ICM209_I2C_SLV_CTRL_EN) != 0U))
+    {
+        sim_slv4_transfer();
+    }
+
+    return RET_OK;
+}
+
+response_status_t ha_iic_master_mem_read_stub(iic_comm_port_t p_port, uint8_t p_slave_addr,
+                                              uint8_t* ppt_data_buffer, size_t p_data_size,
+                                              uint16_t p_mem_addr, i2c_mem_size_t p_mem_size,
+                                              timeout_t p_timeout_ms, int cmock_num_calls)
+{
+    TEST_ASSERT_EQUAL_HEX8(ICM209_IIC_ADDR_1, p_slave_addr);
+    g_sim.transaction_cnt++;
+
+    if ((g_sim.bank == 0U) && (p_mem_addr == ICM209_REG_ADDR(ICM209_REG_FIFO_R_W)))
+    {
+        TEST_ASSERT_LESS_OR_EQUAL(g_sim.fifo_cnt, p_data_size);
+        if (g_sim.fail_fifo_read == TRUE)
+        {
+            /// Torn read, the FIFO lost a few bytes the driver never got
+            sim_set_fifo(&g_sim.fifo[3U], (uint16_t)(g_sim.fifo_cnt - 3U));
+            return RET_ERROR;
+        }
+        memcpy(ppt_data_buffer, g_sim.fifo, p_data_size);
+        sim_set_fifo(&g_sim.fifo[p_data_size], (uint16_t)(g_sim.fifo_cnt - p_data_size));
+        return RET_OK;
+    }
+    if ((g_sim.bank == 0U) && (p_mem_addr == ICM209_REG_ADDR(ICM209_REG_MEM_R_W)))
+    {
+        memcpy(ppt_data_buffer, sim_dmp_mem(p_data_size), p_data_size);
+        return RET_OK;
+    }
+
+    memcpy(ppt_data_buffer, &g_sim.regs[g_sim.bank][p_mem_addr], p_data_size);
+    if ((g_sim.bank == 0U) && (p_mem_addr == ICM209_REG_ADDR(ICM209_REG_INT_STATUS_2)))
+    {
+        g_sim.regs[0][p_mem_addr] = 0U; // Cleared on read
+    }
+
+    return RET_OK;
+}
+
+static TeensyICM20948Settings get_default_settings(void)
+{
+    TeensyICM20948Settings settings = {
+        .mode                    = 1,
+        .enable_gyroscope        = TRUE,
+        .enable_accelerometer    = TRUE,
+        .enable_magnetometer     = TRUE,
+        .enable_quaternion       = TRUE,
+        .gyroscope_frequency     = 50,
+        .accelerometer_frequency = 50,
+        .magnetometer_frequency  = 50,
+        .quaternion_frequency    = 50,
+    };
+
+    return settings;
+}
+
+static void fill_frame(uint8_t* ppt_frame, int16_t p_acc_x, int16_t p_gyro_x, int16_t p_mag_x)
+{
+    memset(ppt_frame, 0U, SIM_FRAME_SZ);
+    ppt_frame[0]  = (uint8_t)((uint16_t)p_acc_x >> 8U);
+    ppt_frame[1]  = (uint8_t)((uint16_t)p_acc_x & 0xFFU);
+    ppt_frame[6]  = (uint8_t)((uint16_t)p_gyro_x >> 8U);
+    ppt_frame[7]  = (uint8_t)((uint16_t)p_gyro_x & 0xFFU);
+    /// AK09916 data is little endian
+    ppt_frame[12] = (uint8_t)((uint16_t)p_mag_x & 0xFFU);
+    ppt_frame[13] = (uint8_t)((uint16_t)p_mag_x >> 8U);
+}
+
+/// DMP packet with the accelerometer, gyroscope, compass and quaternion, all big endian
+static void fill_dmp_packet(uint8_t* ppt_packet, int16_t p_acc_x, int16_t p_gyro_x,
+                            int16_t p_cpass_x, int32_t p_quat_z)
+{
+    const uint16_t header = ICM209_DMP_HDR_ACCEL | ICM209_DMP_HDR_GYRO | ICM209_DMP_HDR_CPASS
+                            | ICM209_DMP_HDR_QUAT9;
+
+    memset(ppt_packet, 0U, SIM_PACKET_SZ);
+    ppt_packet[0]  = (uint8_t)(header >> 8U);
+    ppt_packet[1]  = (uint8_t)(header & 0xFFU);
+    ppt_packet[2]  = (uint8_t)((uint16_t)p_acc_x >> 8U);
+    ppt_packet[3]  = (uint8_t)((uint16_t)p_acc_x & 0xFFU);
+    ppt_packet[8]  = (uint8_t)((uint16_t)p_gyro_x >> 8U);
+    ppt_packet[9]  = (uint8_t)((uint16_t)p_gyro_x & 0xFFU);
+    ppt_packet[20] = (uint8_t)((uint16_t)p_cpass_x >> 8U);
+    ppt_packet[21] = (uint8_t)((uint16_t)p_cpass_x & 0xFFU);
+    for (uint8_t i = 0U; i < 4U; i++)
+    {
+        ppt_packet[34U + i] = (uint8_t)((uint32_t)p_quat_z >> (24U - (8U * i)));
+    }
+}
+
+static void init_sensor(void)
+{
+    ha_iic_init_ExpectAndReturn(RET_OK);
+    TEST_ASSERT_EQUAL(RET_OK, dd_icm209_init(get_default_settings()));
+}
+
+void setUp(void)
+{
+    memset(&g_sim, 0U, sizeof(g_sim));
+    g_sim.regs[0][ICM209_REG_ADDR(ICM209_REG_WHO_AM_I)] = ICM209_CHIP_ID;
+    g_sim.ak_regs[AK09916_REG_WIA2]                     = AK09916_DEVICE_ID;
+
+    (void)dd_icm209_set_dmp_image(NULL, 0U);
+    ha_iic_master_mem_write_StubWithCallback(ha_iic_master_mem_write_stub);
+    ha_iic_master_mem_read_StubWithCallback(ha_iic_master_mem_read_stub);
+    ha_timer_hard_delay_ms_Ignore();
+    ha_timer_get_cpu_time_ms_IgnoreAndReturn(0U);
+}
+
+void tearDown(void) {}
+
+void test_dd_icm209_init_error_in_iic_init_should_return_error(void)
+{
+    ha_iic_init_ExpectAndReturn(RET_ERROR);
+
+    TEST_ASSERT_EQUAL(RET_ERROR, dd_icm209_init(get_default_settings()));
+}
+
+void test_dd_icm209_init_with_no_dev_should_return_not_found(void)
+{
+    g_sim.regs[0][ICM209_REG_ADDR(ICM209_REG_WHO_AM_I)] = 0x00;
+    ha_iic_init_ExpectAndReturn(RET_OK);
+
+    TEST_ASSERT_EQUAL(RET_NOT_FOUND, dd_icm209_init(get_default_settings()));
+}
+
+void test_dd_icm209_init_with_no_mag_should_return_not_found(void)
+{
+    g_sim.ak_regs[AK09916_REG_WIA2] = 0x00;
+    ha_iic_init_ExpectAndReturn(RET_OK);
+
+    TEST_ASSERT_EQUAL(RET_NOT_FOUND, dd_icm209_init(get_default_settings()));
+}
+
+void test_dd_icm209_init_with_empty_fifo_frame_should_return_param_error(void)
+{
+    TeensyICM20948Settings settings = get_default_settings();
+
+    settings.enable_gyroscope     = FALSE;
+    settings.enable_accelerometer = FALSE;
+    settings.enable_magnetometer  = FALSE;
+    g_sim.transaction_cnt         = 0U;
+
+    /// Quaternion only, without a DMP image
+    TEST_ASSERT_EQUAL(RET_PARAM_ERROR, dd_icm209_init(settings));
+
+    settings.enable_quaternion = FALSE;
+    TEST_ASSERT_EQUAL(RET_PARAM_ERROR, dd_icm209_init(settings));
+
+    dd_icm209_task();
+    TEST_ASSERT_EQUAL(0U, g_sim.transaction_cnt);
+}
+
+void test_dd_icm209_init_without_dmp_image_should_use_raw_fifo(void)
+{
+    init_sensor();
+
+    TEST_ASSERT_EQUAL_HEX8(ICM209_USER_CTRL_FIFO_EN | ICM209_USER_CTRL_I2C_MST_EN,
+                           g_sim.regs[0][ICM209_REG_ADDR(ICM209_REG_USER_CTRL)]);
+    TEST_ASSERT_EQUAL_HEX8(ICM209_FIFO_EN_2_ACCEL | ICM209_FIFO_EN_2_GYRO_XYZ,
+                           g_sim.regs[0][ICM209_REG_ADDR(ICM209_REG_FIFO_EN_2)]);
+    TEST_ASSERT_EQUAL_HEX8(ICM209_FIFO_EN_1_SLV_0,
+                           g_sim.regs[0][ICM209_REG_ADDR(ICM209_REG_FIFO_EN_1)]);
+    TEST_ASSERT_EQUAL_HEX8(AK09916_MODE_CONT_50HZ, g_sim.ak_regs[AK09916_REG_CNTL2]);
+    TEST_ASSERT_EQUAL_HEX8(AK09916_IIC_ADDR | ICM209_I2C_SLV_ADDR_READ,
+                           g_sim.regs[3][ICM209_REG_ADDR(ICM209_REG_I2C_SLV0_ADDR)]);
+    TEST_ASSERT_EQUAL_HEX8(ICM209_I2C_SLV_CTRL_EN | AK09916_REG_DATA_LEN,
+                           g_sim.regs[3][ICM209_REG_ADDR(ICM209_REG_I2C_SLV0_CTRL)]);
+}
+
+void test_dd_icm209_task_should_not_switch_bank_when_already_selected(void)
+{
+    init_sensor();
+    g_sim.bank_sel_cnt = 0U;
+
+    dd_icm209_task();
+    dd_icm209_task();
+
+    TEST_ASSERT_EQUAL(0U, g_sim.bank_sel_cnt);
+}
+
+void test_dd_icm209_task_with_empty_fifo_should_not_publish(void)
+{
+    init_sensor();
+    g_sim.transaction_cnt = 0U;
+
+    dd_icm209_task();
+
+    TEST_ASSERT_EQUAL(1U, g_sim.transaction_cnt);
+    TEST_ASSERT_FALSE(dd_icm209_gyro_data_is_ready());
+    TEST_ASSERT_FALSE(dd_icm209_accel_data_is_ready());
+    TEST_ASSERT_FALSE(dd_icm209_mag_data_is_ready());
+    TEST_ASSERT_FALSE(dd_icm209_quat_data_is_ready());
+}
+
+void test_dd_icm209_task_should_drain_batch_in_one_read(void)
+{
+    uint8_t fifo[SIM_FRAME_SZ * 10U] = { 0U };
+    float   x                        = 0.F;
+    float   y                        = 0.F;
+    float   z                        = 0.F;
+
+    for (uint8_t i = 0U; i < 10U; i++)
+    {
+        fill_frame(&fifo[i * SIM_FRAME_SZ], (int16_t)(i * 100), (int16_t)(i * 10), (int16_t)i);
+    }
+    fill_frame(&fifo[9U * SIM_FRAME_SZ], 8192, 164, 100);
+
+    init_sensor();
+    sim_set_fifo(fifo, sizeof(fifo));
+    g_sim.transaction_cnt = 0U;
+
+    dd_icm209_task();
+
+    /// FIFO count and overflow status followed by a single burst of the whole batch
+    TEST_ASSERT_EQUAL(3U, g_sim.transaction_cnt);
+    TEST_ASSERT_EQUAL(0U, g_sim.fifo_cnt);
+
+    TEST_ASSERT_TRUE(dd_icm209_accel_data_is_ready());
+    dd_icm209_read_accel_data(&x, &y, &z);
+    TEST_ASSERT_FLOAT_WITHIN(0.001F, 1.0F, x);
+    TEST_ASSERT_FALSE(dd_icm209_accel_data_is_ready());
+
+    TEST_ASSERT_TRUE(dd_icm209_gyro_data_is_ready());
+    dd_icm209_read_gyro_data(&x, &y, &z);
+    TEST_ASSERT_FLOAT_WITHIN(0.001F, 10.0F, x);
+
+    TEST_ASSERT_TRUE(dd_icm209_mag_data_is_ready());
+    dd_icm209_read_mag_data(&x, &y, &z);
+    TEST_ASSERT_FLOAT_WITHIN(0.001F, 15.0F, x);
+
+    TEST_ASSERT_FALSE(dd_icm209_quat_data_is_ready());
+}
+
+void test_dd_icm209_gyro_mean_should_cover_every_frame_since_the_last_read(void)
+{
+    uint8_t fifo[SIM_FRAME_SZ * 4U] = { 0U };
+    float   x                       = 0.F;
+    float   y                       = 0.F;
+    float   z                       = 0.F;
+
+    /// 10, 20, 30 and 40 dps in one batch
+    for (uint8_t i = 0U; i < 4U; i++)
+    {
+        fill_frame(&fifo[i * SIM_FRAME_SZ], 8192, (int16_t)(164 * (i + 1)), 100);
+    }
+
+    init_sensor();
+    TEST_ASSERT_EQUAL(0U, dd_icm209_read_gyro_mean(&x, &y, &z));
+
+    sim_set_fifo(fifo, sizeof(fifo));
+    dd_icm209_task();
+    TEST_ASSERT_EQUAL(4U, dd_icm209_read_gyro_mean(&x, &y, &z));
+    TEST_ASSERT_FLOAT_WITHIN(0.001F, 25.0F, x);
+    TEST_ASSERT_FALSE(dd_icm209_gyro_data_is_ready());
+
+    /// Two batches before a read are summed, a read starts a new sum
+    sim_set_fifo(fifo, SIM_FRAME_SZ);
+    dd_icm209_task();
+    sim_set_fifo(&fifo[3U * SIM_FRAME_SZ], SIM_FRAME_SZ);
+    dd_icm209_task();
+    TEST_ASSERT_EQUAL(2U, dd_icm209_read_gyro_mean(&x, &y, &z));
+    TEST_ASSERT_FLOAT_WITHIN(0.001F, 25.0F, x);
+}
+
+void test_dd_icm209_task_with_partial_frame_should_reset_fifo(void)
+{
+    uint8_t fifo[SIM_FRAME_SZ * 2U + 5U] = { 0U };
+
+    fill_frame(&fifo[0], 8192, 164, 100);
+    fill_frame(&fifo[SIM_FRAME_SZ], 8192, 164, 100);
+
+    init_sensor();
+    g_sim.fifo_rst_cnt = 0U;
+    sim_set_fifo(fifo, sizeof(fifo));
+
+    dd_icm209_task();
+
+    /// The boundaries are unknown, no frame is decoded shifted
+    TEST_ASSERT_EQUAL(1U, g_sim.fifo_rst_cnt);
+    TEST_ASSERT_EQUAL(0U, g_sim.fifo_cnt);
+    TEST_ASSERT_FALSE(dd_icm209_gyro_data_is_ready());
+    TEST_ASSERT_FALSE(dd_icm209_accel_data_is_ready());
+
+    /// Whole frames again after the reset
+    sim_set_fifo(fifo, SIM_FRAME_SZ * 2U);
+    dd_icm209_task();
+    TEST_ASSERT_EQUAL(1U, g_sim.fifo_rst_cnt);
+    TEST_ASSERT_TRUE(dd_icm209_gyro_data_is_ready());
+}
+
+void test_dd_icm209_task_with_fifo_overflow_should_reset_fifo(void)
+{
+    uint8_t fifo[SIM_FRAME_SZ * 2U] = { 0U };
+
+    fill_frame(&fifo[0], 8192, 164, 100);
+    fill_frame(&fifo[SIM_FRAME_SZ], 8192, 164, 100);
+
+    init_sensor();
+    g_sim.fifo_rst_cnt = 0U;
+    sim_set_fifo(fifo, sizeof(fifo));
+    g_sim.regs[0][ICM209_REG_ADDR(ICM209_REG_INT_STATUS_2)] = 0x01U;
+
+    dd_icm209_task();
+
+    TEST_ASSERT_EQUAL(1U, g_sim.fifo_rst_cnt);
+    TEST_ASSERT_EQUAL(0U, g_sim.fifo_cnt);
+    TEST_ASSERT_FALSE(dd_icm209_gyro_data_is_ready());
+}
+
+void test_dd_icm209_task_with_torn_fifo_read_should_reset_fifo(void)
+{
+    uint8_t fifo[SIM_FRAME_SZ * 3U] = { 0U };
+
+    init_sensor();
+    g_sim.fifo_rst_cnt   = 0U;
+    sim_set_fifo(fifo, sizeof(fifo));
+    g_sim.fail_fifo_read = TRUE;
+
+    dd_icm209_task();
+
+    TEST_ASSERT_EQUAL(1U, g_sim.fifo_rst_cnt);
+    TEST_ASSERT_EQUAL(0U, g_sim.fifo_cnt);
+    TEST_ASSERT_FALSE(dd_icm209_gyro_data_is_ready());
+}
+
+void test_dd_icm209_init_with_dmp_image_should_load_it_and_write_the_scale_keys(void)
+{
+    static uint8_t image[SIM_IMAGE_SZ];
+
+    for (uint16_t i = 0U; i < SIM_IMAGE_SZ; i++)
+    {
+        image[i] = (uint8_t)((i * 7U) + 3U);
+    }
+    /// Negative clock trim
+    g_sim.regs[1][ICM209_REG_ADDR(ICM209_REG_TIMEBASE_CORRECTION_PLL)] = 0x85U;
+
+    TEST_ASSERT_EQUAL(RET_OK, dd_icm209_set_dmp_image(image, sizeof(image)));
+    init_sensor();
+
+    TEST_ASSERT_EQUAL_MEMORY(image, &g_sim.dmp_loaded[ICM209_DMP_LOAD_START], sizeof(image));
+    TEST_ASSERT_EQUAL_HEX8(BYTE_HIGH(ICM209_DMP_START),
+                           g_sim.regs[2][ICM209_REG_ADDR(ICM209_REG_PRGM_START_ADDR)]);
+    TEST_ASSERT_EQUAL_HEX8(BYTE_LOW(ICM209_DMP_START),
+                           g_sim.regs[2][ICM209_REG_ADDR(ICM209_REG_PRGM_START_ADDR) + 1U]);
+    TEST_ASSERT_BITS_HIGH(ICM209_USER_CTRL_DMP_EN,
+                          g_sim.regs[0][ICM209_REG_ADDR(ICM209_REG_USER_CTRL)]);
+
+    TEST_ASSERT_EQUAL_HEX32(0x04000000U, sim_dmp_key32(ICM209_DMP_ACC_SCALE));
+    TEST_ASSERT_EQUAL_HEX32(0x00040000U, sim_dmp_key32(ICM209_DMP_ACC_SCALE2));
+    TEST_ASSERT_EQUAL_HEX32(0x10000000U, sim_dmp_key32(ICM209_DMP_GYRO_FULLSCALE));
+    /// Divider 21 for 50 Hz, 1270 - 5 * 15 from the trim
+    TEST_ASSERT_EQUAL_HEX32(0x2E6DEED6U, sim_dmp_key32(ICM209_DMP_GYRO_SF));
+    TEST_ASSERT_EQUAL_HEX32(0x09999999U, sim_dmp_key32(ICM209_DMP_CPASS_MTX));
+    TEST_ASSERT_EQUAL_HEX32(0xF6666667U, sim_dmp_key32(ICM209_DMP_CPASS_MTX + 16U));
+    TEST_ASSERT_EQUAL_HEX32(0xF6666667U, sim_dmp_key32(ICM209_DMP_CPASS_MTX + 32U));
+    TEST_ASSERT_EQUAL_HEX32(0U, sim_dmp_key32(ICM209_DMP_CPASS_MTX + 4U));
+    TEST_ASSERT_EQUAL_HEX32(0x40000000U, sim_dmp_key32(ICM209_DMP_B2S_MTX));
+    TEST_ASSERT_EQUAL_HEX32(0x40000000U, sim_dmp_key32(ICM209_DMP_B2S_MTX + 16U));
+    TEST_ASSERT_EQUAL_HEX32(0x40000000U, sim_dmp_key32(ICM209_DMP_B2S_MTX + 32U));
+    TEST_ASSERT_EQUAL_HEX32(0U, sim_dmp_key32(ICM209_DMP_B2S_MTX + 12U));
+}
+
+void test_dd_icm209_task_should_parse_dmp_packets_across_batches(void)
+{
+    static const uint8_t image[16] = { 0U };
+    uint8_t              fifo[SIM_PACKET_SZ * 3U];
+    uint8_t              bad_header[SIM_PACKET_SZ] = { 0x00U, 0x01U };
+    float                w = 0.F;
+    float                x = 0.F;
+    float                y = 0.F;
+    float                z = 0.F;
+
+    fill_dmp_packet(&fifo[0], 4096, 164, 100, 0);
+    fill_dmp_packet(&fifo[SIM_PACKET_SZ], 8192, 328, 100, SIM_Q30_SIN45);
+    fill_dmp_packet(&fifo[SIM_PACKET_SZ * 2U], 8192, 492, 100, SIM_Q30_SIN45);
+
+    TEST_ASSERT_EQUAL(RET_OK, dd_icm209_set_dmp_image(image, sizeof(image)));
+    init_sensor();
+    g_sim.fifo_rst_cnt = 0U;
+
+    /// Two packets and the head of the third
+    sim_set_fifo(fifo, (SIM_PACKET_SZ * 2U) + 10U);
+    dd_icm209_task();
+
+    TEST_ASSERT_EQUAL(0U, g_sim.fifo_rst_cnt);
+    TEST_ASSERT_TRUE(dd_icm209_accel_data_is_ready());
+    dd_icm209_read_accel_data(&x, &y, &z);
+    TEST_ASSERT_FLOAT_WITHIN(0.001F, 1.0F, x);
+    TEST_ASSERT_EQUAL(2U, dd_icm209_read_gyro_mean(&x, &y, &z));
+    TEST_ASSERT_FLOAT_WITHIN(0.001F, 15.0F, x);
+    TEST_ASSERT_TRUE(dd_icm209_mag_data_is_ready());
+    dd_icm209_read_mag_data(&x, &y, &z);
+    TEST_ASSERT_FLOAT_WITHIN(0.001F, 15.0F, x);
+    TEST_ASSERT_TRUE(dd_icm209_quat_data_is_ready());
+    dd_icm209_read_quat_data(&w, &x, &y, &z);
+    TEST_ASSERT_FLOAT_WITHIN(0.0001F, 0.70711F, w);
+    TEST_ASSERT_FLOAT_WITHIN(0.0001F, 0.0F, x);
+    TEST_ASSERT_FLOAT_WITHIN(0.0001F, 0.70711F, z);
+
+    /// The tail completes the kept head
+    sim_set_fifo(&fifo[(SIM_PACKET_SZ * 2U) + 10U], SIM_PACKET_SZ - 10U);
+    dd_icm209_task();
+    TEST_ASSERT_EQUAL(1U, dd_icm209_read_gyro_mean(&x, &y, &z));
+    TEST_ASSERT_FLOAT_WITHIN(0.001F, 30.0F, x);
+
+    /// An unknown header loses the packet boundaries
+    sim_set_fifo(bad_header, sizeof(bad_header));
+    dd_icm209_task();
+    TEST_ASSERT_EQUAL(1U, g_sim.fifo_rst_cnt);
+    TEST_ASSERT_FALSE(dd_icm209_gyro_data_is_ready());
+}
+
+#endif // TEST
@@ -0,0 +1,466 @@
+#ifdef TEST
+
+#include "mock_ha_timer.h"
+#include "ps_app_timer.h"
+#include "ps_deferred_work.h"
+#include "su_trace.h"
+#include "unity.h"
+
+#include <stdio.h>
+
+#define SIM_ALARM_MIN_LEAD (2U)
+#define SIM_ISR_COST_US    (2U)            // alarm ISR with one expiry, ~160 cycles at 80 MHz
+#define SIM_START_US       (0xFFF00000ULL) // the counter wraps around early in each run
+#define SIM_DURATION_US    (10000000ULL)
+
+extern bool_t g_is_initialized;
+
+/// Simulated free running 1 MHz counter with a single one-shot compare
+static uint64_t g_sim_time_us;
+static uint32_t g_sim_compare;
+static bool_t   g_sim_alarm_armed;
+static uint32_t g_sim_isr_cnt;
+static void (*g_sim_alarm_cb)(void);
+
+static app_timer_handler_t* g_pt_led_timer;
+static app_timer_handler_t* g_pt_esp32_timer;
+static app_timer_handler_t* g_pt_fsi6_timer;
+static uint32_t             g_led_cnt;
+static uint32_t             g_esp32_cnt;
+static uint32_t             g_fsi6_timeout_cnt;
+static uint64_t             g_last_fire_us;
+
+/// Pool filled with one-shot timers that check their own expiry time
+static app_timer_handler_t* g_pt_pool[MAX_USER_TIMER];
+static uint64_t             g_pool_deadline_us[MAX_USER_TIMER];
+static uint32_t             g_pool_fire_cnt;
+static uint32_t             g_pool_late_cnt; // fired early or later than the compare allows
+
+uint32_t ha_timer_get_counter_stub(int cmock_num_calls)
+{
+    return (uint32_t)g_sim_time_us;
+}
+
+response_status_t ha_timer_set_alarm_stub(uint32_t p_deadline, int cmock_num_calls)
+{
+    uint32_t counter = (uint32_t)g_sim_time_us;
+
+    g_sim_compare = p_deadline;
+    if ((int32_t)(p_deadline - counter) < (int32_t)SIM_ALARM_MIN_LEAD)
+    {
+        g_sim_compare = counter + SIM_ALARM_MIN_LEAD;
+    }
+    g_sim_alarm_armed = TRUE;
+
+    return RET_OK;
+}
+
+void ha_timer_cancel_alarm_stub(int cmock_num_calls)
+{
+    g_sim_alarm_armed = FALSE;
+}
+
+response_status_t ha_timer_register_alarm_callback_stub(void (*ppt_callback)(void),
+                                                        int cmock_num_calls)
+{
+    g_sim_alarm_cb = ppt_callback;
+    return RET_OK;
+}
+
+static void led_cb(void)
+{
+    g_led_cnt++;
+    g_last_fire_us = g_sim_time_us;
+}
+
+static void esp32_cb(void)
+{
+    g_esp32_cnt++;
+    // The application sends the next message as soon as the previous one is done
+    ps_app_timer_start(g_pt_esp32_timer, 50U, APP_TIMER_UNIT_MS);
+}
+
+static void fsi6_timeout_cb(void)
+{
+    g_fsi6_timeout_cnt++;
+    g_last_fire_us = g_sim_time_us;
+}
+
+static void pool_cb(void)
+{
+    for (uint32_t i = 0U; i < MAX_USER_TIMER; i++)
+    {
+        if ((g_pt_pool[i]->is_fired == TRUE) && (g_pool_deadline_us[i] != 0U))
+        {
+            // The compare cannot be armed closer than the minimum lead
+            g_pool_late_cnt += ((g_sim_time_us < g_pool_deadline_us[i])
+                                || (g_sim_time_us >= (g_pool_deadline_us[i] + SIM_ALARM_MIN_LEAD)))
+                                 ? 1U
+                                 : 0U;
+            g_pool_deadline_us[i] = 0U;
+            g_pool_fire_cnt++;
+        }
+    }
+}
+
+/**
+ * @brief Runs the simulated time until `p_end_us`, the alarm interrupt is
+ * taken when the counter matches the compare value. `p_poll_period_us` models
+ * the main loop restarting the receiver timeout on each received frame.
+ */
+static void sim_run_until(uint64_t p_end_us, uint64_t p_poll_period_us)
+{
+    uint64_t next_poll_us = g_sim_time_us + p_poll_period_us;
+
+    while (g_sim_time_us < p_end_us)
+    {
+        int32_t  alarm_in = (int32_t)(g_sim_compare - (uint32_t)g_sim_time_us);
+        uint64_t next_us  = p_end_us;
+        uint64_t alarm_us = g_sim_time_us + ((alarm_in > 0) ? (uint32_t)alarm_in : 0U);
+
+        if ((g_sim_alarm_armed == TRUE) && (alarm_us < next_us))
+        {
+            next_us = alarm_us;
+        }
+        if ((p_poll_period_us != 0U) && (next_poll_us < next_us))
+        {
+            next_us = next_poll_us;
+        }
+
+        g_sim_time_us = next_us;
+
+        if ((g_sim_alarm_armed == TRUE) && (g_sim_time_us == alarm_us))
+        {
+            g_sim_alarm_armed = FALSE;
+            g_sim_isr_cnt++;
+            g_sim_alarm_cb();
+        }
+        if ((p_poll_period_us != 0U) && (g_sim_time_us == next_poll_us))
+        {
+            ps_app_timer_start(g_pt_fsi6_timer, 40U, APP_TIMER_UNIT_MS);
+            next_poll_us += p_poll_period_us;
+        }
+    }
+}
+
+/**
+ * @brief Advances the simulated time to `p_end_us` with the interrupts masked,
+ * a compare match meanwhile stays pending and is taken late by the next run.
+ */
+static void sim_mask_irq_until(uint64_t p_end_us)
+{
+    g_sim_time_us = p_end_us;
+}
+
+static uint32_t report_load_ppm(const char* ppt_mix, uint32_t p_isr_cnt, uint64_t p_duration_us)
+{
+    char     msg[96];
+    uint32_t load_ppm = (uint32_t)((p_isr_cnt * SIM_ISR_COST_US * 1000000ULL) / p_duration_us);
+
+    snprintf(msg,
+             sizeof(msg),
+             "%s: %u ISRs, CPU load %u ppm",
+             ppt_mix,
+             (unsigned)p_isr_cnt,
+             (unsigned)load_ppm);
+    TEST_MESSAGE(msg);
+
+    return load_ppm;
+}
+
+void setUp(void)
+{
+    g_sim_time_us      = SIM_START_US;
+    g_sim_compare      = 0U;
+    g_sim_alarm_armed  = FALSE;
+    g_sim_isr_cnt      = 0U;
+    g_sim_alarm_cb     = NULL;
+    g_led_cnt          = 0U;
+    g_esp32_cnt        = 0U;
+    g_fsi6_timeout_cnt = 0U;
+    g_last_fire_us     = 0U;
+    g_is_initialized   = FALSE;
+
+    ha_timer_init_IgnoreAndReturn(RET_OK);
+    ha_timer_get_counter_StubWithCallback(ha_timer_get_counter_stub);
+    ha_timer_set_alarm_StubWithCallback(ha_timer_set_alarm_stub);
+    ha_timer_cancel_alarm_StubWithCallback(ha_timer_cancel_alarm_stub);
+    ha_timer_register_alarm_callback_StubWithCallback(ha_timer_register_alarm_callback_stub);
+
+    TEST_ASSERT_EQUAL(RET_OK, ps_app_timer_init());
+    TEST_ASSERT_NOT_NULL(g_sim_alarm_cb);
+}
+
+void tearDown(void) {}
+
+void test_ps_app_timer_no_running_timer_should_not_arm_the_alarm(void)
+{
+    TEST_ASSERT_EQUAL(RET_OK, ps_app_timer_create(&g_pt_led_timer, FALSE, led_cb, PS_EXEC_ISR));
+
+    sim_run_until(SIM_START_US + SIM_DURATION_US, 0U);
+
+    TEST_ASSERT_FALSE(g_sim_alarm_armed);
+    TEST_ASSERT_EQUAL(0U, g_sim_isr_cnt);
+}
+
+void test_ps_app_timer_typical_mix_should_interrupt_only_on_expiry(void)
+{
+    TEST_ASSERT_EQUAL(RET_OK, ps_app_timer_create(&g_pt_led_timer, FALSE, led_cb, PS_EXEC_ISR));
+    TEST_ASSERT_EQUAL(RET_OK, ps_app_timer_create(&g_pt_esp32_timer, TRUE, esp32_cb, PS_EXEC_ISR));
+    TEST_ASSERT_EQUAL(RET_OK,
+                      ps_app_timer_create(&g_pt_fsi6_timer, TRUE, fsi6_timeout_cb, PS_EXEC_ISR));
+    TEST_ASSERT_EQUAL(RET_OK, ps_app_timer_start(g_pt_led_timer, 1000U, APP_TIMER_UNIT_MS));
+    TEST_ASSERT_EQUAL(RET_OK, ps_app_timer_start(g_pt_esp32_timer, 50U, APP_TIMER_UNIT_MS));
+
+    /// Frames every 20 ms keep the 40 ms receiver timeout from expiring
+    sim_run_until(SIM_START_US + SIM_DURATION_US, 20000U);
+
+    TEST_ASSERT_EQUAL(10U, g_led_cnt);
+    TEST_ASSERT_EQUAL(200U, g_esp32_cnt);
+    TEST_ASSERT_EQUAL(0U, g_fsi6_timeout_cnt);
+    /// LED and ESP32 expire together once per second
+    TEST_ASSERT_EQUAL(200U, g_sim_isr_cnt);
+    /// The tick based engine took 1100 ISRs (10 ms and 100 ms channels)
+    TEST_ASSERT_LESS_OR_EQUAL(
+      100U, report_load_ppm("LED 1 s, ESP32 50 ms, FSI6 40 ms", g_sim_isr_cnt, SIM_DURATION_US));
+}
+
+void test_ps_app_timer_us_timer_should_not_need_a_fast_tick(void)
+{
+    TEST_ASSERT_EQUAL(RET_OK, ps_app_timer_create(&g_pt_led_timer, FALSE, led_cb, PS_EXEC_ISR));
+    TEST_ASSERT_EQUAL(RET_OK, ps_app_timer_start(g_pt_led_timer, 500U, APP_TIMER_UNIT_US));
+
+    sim_run_until(SIM_START_US + SIM_DURATION_US, 0U);
+
+    TEST_ASSERT_EQUAL(20000U, g_led_cnt);
+    TEST_ASSERT_EQUAL(20000U, g_sim_isr_cnt);
+    /// The tick based engine took 1000000 ISRs (10 us channel)
+    TEST_ASSERT_LESS_OR_EQUAL(
+      5000U, report_load_ppm("500 us periodic", g_sim_isr_cnt, SIM_DURATION_US));
+}
+
+void test_ps_app_timer_missed_receiver_frames_should_fire_the_timeout(void)
+{
+    TEST_ASSERT_EQUAL(RET_OK,
+                      ps_app_timer_create(&g_pt_fsi6_timer, TRUE, fsi6_timeout_cb, PS_EXEC_ISR));
+    TEST_ASSERT_EQUAL(RET_OK, ps_app_timer_start(g_pt_fsi6_timer, 40U, APP_TIMER_UNIT_MS));
+
+    sim_run_until(SIM_START_US + 100000U, 0U);
+
+    TEST_ASSERT_EQUAL(1U, g_fsi6_timeout_cnt);
+    TEST_ASSERT_EQUAL(1U, g_sim_isr_cnt);
+    TEST_ASSERT_EQUAL(SIM_START_US + 40000U, g_last_fire_us);
+    TEST_ASSERT_TRUE(g_pt_fsi6_timer->is_fired);
+    TEST_ASSERT_FALSE(g_pt_fsi6_timer->is_running);
+}
+
+void test_ps_app_timer_stopped_timer_should_not_fire(void)
+{
+    TEST_ASSERT_EQUAL(RET_OK, ps_app_timer_create(&g_pt_led_timer, FALSE, led_cb, PS_EXEC_ISR));
+    TEST_ASSERT_EQUAL(RET_OK, ps_app_timer_start(g_pt_led_timer, 100U, APP_TIMER_UNIT_MS));
+
+    sim_run_until(SIM_START_US + 250000U, 0U);
+    TEST_ASSERT_EQUAL(RET_OK, ps_app_timer_stop(g_pt_led_timer));
+    sim_run_until(SIM_START_US + SIM_DURATION_US, 0U);
+
+    TEST_ASSERT_EQUAL(2U, g_led_cnt);
+    TEST_ASSERT_EQUAL(2U, g_sim_isr_cnt);
+    TEST_ASSERT_FALSE(g_sim_alarm_armed);
+}
+
+void test_ps_app_timer_update_period_should_rearm_from_now(void)
+{
+    TEST_ASSERT_EQUAL(RET_OK, ps_app_timer_create(&g_pt_led_timer, FALSE, led_cb, PS_EXEC_ISR));
+    TEST_ASSERT_EQUAL(RET_OK, ps_app_timer_start(g_pt_led_timer, 2000U, APP_TIMER_UNIT_MS));
+
+    sim_run_until(SIM_START_US + 300000U, 0U);
+    TEST_ASSERT_EQUAL(RET_OK, ps_app_timer_update_period(g_pt_led_timer, 500U, APP_TIMER_UNIT_MS));
+    sim_run_until(SIM_START_US + 1300000U, 0U);
+
+    TEST_ASSERT_EQUAL(2U, g_led_cnt);
+    TEST_ASSERT_EQUAL(SIM_START_US + 1300000U, g_last_fire_us);
+}
+
+void test_ps_app_timer_long_timer_should_fire_after_counter_wraps(void)
+{
+    TEST_ASSERT_EQUAL(RET_OK,
+                      ps_app_timer_create(&g_pt_fsi6_timer, TRUE, fsi6_timeout_cb, PS_EXEC_ISR));
+    TEST_ASSERT_EQUAL(RET_OK, ps_app_timer_start(g_pt_fsi6_timer, 90U, APP_TIMER_UNIT_MIN));
+
+    sim_run_until(SIM_START_US + (91ULL * 60000000ULL), 0U);
+
+    TEST_ASSERT_EQUAL(1U, g_fsi6_timeout_cnt);
+    TEST_ASSERT_EQUAL(SIM_START_US + (90ULL * 60000000ULL), g_last_fire_us);
+    /// The alarm reaches at most 2^31 us ahead, two steps before the expiry
+    TEST_ASSERT_EQUAL(3U, g_sim_isr_cnt);
+}
+
+void test_ps_app_timer_invalid_period_should_return_param_error(void)
+{
+    TEST_ASSERT_EQUAL(RET_OK, ps_app_timer_create(&g_pt_led_timer, FALSE, led_cb, PS_EXEC_ISR));
+
+    TEST_ASSERT_EQUAL(RET_PARAM_ERROR, ps_app_timer_start(g_pt_led_timer, 0U, APP_TIMER_UNIT_MS));
+    TEST_ASSERT_FALSE(g_pt_led_timer->is_running);
+}
+
+void test_ps_app_timer_late_service_should_skip_the_missed_periods(void)
+{
+    TEST_ASSERT_EQUAL(RET_OK, ps_app_timer_create(&g_pt_led_timer, FALSE, led_cb, PS_EXEC_ISR));
+    TEST_ASSERT_EQUAL(RET_OK, ps_app_timer_start(g_pt_led_timer, 10U, APP_TIMER_UNIT_MS));
+
+    sim_run_until(SIM_START_US + 25000U, 0U);
+    sim_mask_irq_until(SIM_START_US + 57000U);
+    sim_run_until(SIM_START_US + 100000U, 0U);
+
+    /// Fired at 10, 20, late at 57, then back on the grid from 60 on
+    TEST_ASSERT_EQUAL(8U, g_led_cnt);
+    TEST_ASSERT_EQUAL(2U, g_pt_led_timer->missed_cnt);
+    TEST_ASSERT_EQUAL(SIM_START_US + 100000U, g_last_fire_us);
+}
+
+void test_ps_app_timer_catch_up_timer_should_fire_the_missed_periods(void)
+{
+    TEST_ASSERT_EQUAL(RET_OK, ps_app_timer_create(&g_pt_led_timer, FALSE, led_cb, PS_EXEC_ISR));
+    TEST_ASSERT_EQUAL(RET_OK, ps_app_timer_set_catch_up(g_pt_led_timer, TRUE));
+    TEST_ASSERT_EQUAL(RET_OK, ps_app_timer_start(g_pt_led_timer, 10U, APP_TIMER_UNIT_MS));
+
+    sim_run_until(SIM_START_US + 25000U, 0U);
+    sim_mask_irq_until(SIM_START_US + 57000U);
+    sim_run_until(SIM_START_US + 57000U + 1U, 0U);
+
+    /// The periods at 30, 40 and 50 fire back to back in one interrupt
+    TEST_ASSERT_EQUAL(5U, g_led_cnt);
+    TEST_ASSERT_EQUAL(3U, g_sim_isr_cnt);
+
+    sim_run_until(SIM_START_US + 100000U, 0U);
+
+    TEST_ASSERT_EQUAL(10U, g_led_cnt);
+    TEST_ASSERT_EQUAL(0U, g_pt_led_timer->missed_cnt);
+}
+
+void test_ps_app_timer_catch_up_should_be_bounded(void)
+{
+    TEST_ASSERT_EQUAL(RET_OK, ps_app_timer_create(&g_pt_led_timer, FALSE, led_cb, PS_EXEC_ISR));
+    TEST_ASSERT_EQUAL(RET_OK, ps_app_timer_set_catch_up(g_pt_led_timer, TRUE));
+    TEST_ASSERT_EQUAL(RET_OK, ps_app_timer_start(g_pt_led_timer, 10U, APP_TIMER_UNIT_MS));
+
+    sim_run_until(SIM_START_US + 25000U, 0U);
+    sim_mask_irq_until(SIM_START_US + 225000U);
+    sim_run_until(SIM_START_US + 225000U + 1U, 0U);
+
+    /// 20 periods passed, the oldest 11 are skipped
+    TEST_ASSERT_EQUAL(2U + 1U + APP_TIMER_MAX_CATCH_UP, g_led_cnt);
+    TEST_ASSERT_EQUAL(11U, g_pt_led_timer->missed_cnt);
+
+    sim_run_until(SIM_START_US + 300000U, 0U);
+
+    TEST_ASSERT_EQUAL(30U, g_led_cnt + g_pt_led_timer->missed_cnt);
+}
+
+void test_ps_app_timer_set_catch_up_without_timer_should_return_param_error(void)
+{
+    TEST_ASSERT_EQUAL(RET_PARAM_ERROR, ps_app_timer_set_catch_up(NULL, TRUE));
+}
+
+void test_ps_app_timer_pool_should_fire_each_timer_on_its_deadline(void)
+{
+    uint32_t seed = 12345U;
+
+    for (uint32_t i = 0U; i < MAX_USER_TIMER; i++)
+    {
+        TEST_ASSERT_EQUAL(RET_OK, ps_app_timer_create(&g_pt_pool[i], TRUE, pool_cb, PS_EXEC_ISR));
+    }
+    g_pool_fire_cnt = 0U;
+    g_pool_late_cnt = 0U;
+
+    /// Periods from 1 us to ~33 s exercise every level of the wheel
+    for (uint32_t round = 0U; round < 8U; round++)
+    {
+        for (uint32_t i = 0U; i < MAX_USER_TIMER; i++)
+        {
+            uint32_t period_us = 0U;
+
+            seed      = (seed * 1103515245U) + 12345U;
+            period_us = 1U + ((seed >> 4U) % (1U << ((i % 25U) + 1U)));
+
+            TEST_ASSERT_EQUAL(RET_OK,
+                              ps_app_timer_start(g_pt_pool[i], period_us, APP_TIMER_UNIT_US));
+            g_pool_deadline_us[i] = g_sim_time_us + period_us;
+        }
+        sim_run_until(g_sim_time_us + (1ULL << 26U), 0U);
+    }
+
+    TEST_ASSERT_EQUAL(8U * MAX_USER_TIMER, g_pool_fire_cnt);
+    TEST_ASSERT_EQUAL(0U, g_pool_late_cnt);
+}
+
+void test_ps_app_timer_pool_exhausted_should_return_no_memory(void)
+{
+    app_timer_handler_t* pt_extra = NULL;
+
+    for (uint32_t i = 0U; i < MAX_USER_TIMER; i++)
+    {
+        TEST_ASSERT_EQUAL(RET_OK, ps_app_timer_create(&g_pt_pool[i], TRUE, NULL, PS_EXEC_ISR));
+    }
+    TEST_ASSERT_EQUAL(RET_NO_MEMORY, ps_app_timer_create(&pt_extra, TRUE, NULL, PS_EXEC_ISR));
+
+    TEST_ASSERT_EQUAL(RET_OK, ps_app_timer_delete(g_pt_pool[3]));
+    TEST_ASSERT_EQUAL(RET_OK, ps_app_timer_create(&pt_extra, TRUE, NULL, PS_EXEC_ISR));
+    TEST_ASSERT_EQUAL_PTR(g_pt_pool[3], pt_extra);
+}
+
+void test_ps_app_timer_deferred_callback_should_run_in_main_context(void)
+{
+    TEST_ASSERT_EQUAL(RET_OK,
+                      ps_app_timer_create(&g_pt_led_timer, TRUE, led_cb, PS_EXEC_DEFERRED));
+    TEST_ASSERT_EQUAL(RET_OK, ps_app_timer_start(g_pt_led_timer, 10U, APP_TIMER_UNIT_MS));
+
+    sim_run_until(g_sim_time_us + 20000U, 0U);
+
+    /// The interrupt only queues the callback, the main loop runs it
+    TEST_ASSERT_EQUAL(1U, g_sim_isr_cnt);
+    TEST_ASSERT_EQUAL(0U, g_led_cnt);
+    TEST_ASSERT_TRUE(g_pt_led_timer->is_fired);
+    TEST_ASSERT_TRUE(ps_deferred_work_is_pending());
+
+    TEST_ASSERT_EQUAL(1U, ps_deferred_work_process());
+    TEST_ASSERT_EQUAL(1U, g_led_cnt);
+}
+
+void test_ps_app_timer_deferred_callback_of_deleted_timer_should_not_run(void)
+{
+    TEST_ASSERT_EQUAL(RET_OK,
+                      ps_app_timer_create(&g_pt_led_timer, TRUE, led_cb, PS_EXEC_DEFERRED));
+    TEST_ASSERT_EQUAL(RET_OK, ps_app_timer_start(g_pt_led_timer, 10U, APP_TIMER_UNIT_MS));
+
+    sim_run_until(g_sim_time_us + 20000U, 0U);
+    TEST_ASSERT_EQUAL(RET_OK, ps_app_timer_delete(g_pt_led_timer));
+
+    TEST_ASSERT_EQUAL(1U, ps_deferred_work_process());
+    TEST_ASSERT_EQUAL(0U, g_led_cnt);
+}
+
+void test_ps_app_timer_deferred_callback_of_reused_timer_should_not_run(void)
+{
+    app_timer_handler_t* pt_reused = NULL;
+
+    TEST_ASSERT_EQUAL(RET_OK,
+                      ps_app_timer_create(&g_pt_led_timer, TRUE, led_cb, PS_EXEC_DEFERRED));
+    TEST_ASSERT_EQUAL(RET_OK, ps_app_timer_start(g_pt_led_timer, 10U, APP_TIMER_UNIT_MS));
+
+    sim_run_until(g_sim_time_us + 20000U, 0U);
+    TEST_ASSERT_EQUAL(RET_OK, ps_app_timer_delete(g_pt_led_timer));
+
+    /// The new timer takes the same pool entry before the stale expiry runs
+    TEST_ASSERT_EQUAL(RET_OK, ps_app_timer_create(&pt_reused, TRUE, led_cb, PS_EXEC_DEFERRED));
+    TEST_ASSERT_EQUAL_PTR(g_pt_led_timer, pt_reused);
+    TEST_ASSERT_EQUAL(1U, ps_deferred_work_process());
+    TEST_ASSERT_EQUAL(0U, g_led_cnt);
+
+    TEST_ASSERT_EQUAL(RET_OK, ps_app_timer_start(pt_reused, 10U, APP_TIMER_UNIT_MS));
+    sim_run_until(g_sim_time_us + 20000U, 0U);
+    TEST_ASSERT_EQUAL(1U, ps_deferred_work_process());
+    TEST_ASSERT_EQUAL(1U, g_led_cnt);
+}
+
+#endif // TEST
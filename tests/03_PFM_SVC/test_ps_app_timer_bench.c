@@ -0,0 +1,178 @@
+#ifdef TEST
+
+#include "bench_clock.h"
+#include "mock_ha_timer.h"
+#include "ps_app_timer.h"
+#include "ps_deferred_work.h"
+#include "su_trace.h"
+#include "unity.h"
+
+#include <stdio.h>
+
+/// Built with MAX_USER_TIMER=1024, see the defines of this test in project.yml
+#define BENCH_MAX_TIMERS (1000U)
+#define BENCH_RUNS       (5U)
+/// Host timing is noisy, an O(1) operation shall stay within this factor
+#define BENCH_MAX_GROWTH (4U)
+#define BENCH_NOISE_NS   (100U)
+
+extern bool_t g_is_initialized;
+
+typedef struct
+{
+    uint32_t start_ns;
+    uint32_t stop_ns;
+    uint32_t expire_ns;
+} bench_cost_t;
+
+/// Simulated free running 1 MHz counter with a single one-shot compare
+static uint64_t g_sim_time_us;
+static uint32_t g_sim_compare;
+static bool_t   g_sim_alarm_armed;
+static void (*g_sim_alarm_cb)(void);
+
+static app_timer_handler_t* g_pt_timers[BENCH_MAX_TIMERS];
+static uint32_t             g_fire_cnt;
+
+uint32_t ha_timer_get_counter_stub(int cmock_num_calls)
+{
+    return (uint32_t)g_sim_time_us;
+}
+
+response_status_t ha_timer_set_alarm_stub(uint32_t p_deadline, int cmock_num_calls)
+{
+    g_sim_compare     = p_deadline;
+    g_sim_alarm_armed = TRUE;
+    return RET_OK;
+}
+
+void ha_timer_cancel_alarm_stub(int cmock_num_calls)
+{
+    g_sim_alarm_armed = FALSE;
+}
+
+response_status_t ha_timer_register_alarm_callback_stub(void (*ppt_callback)(void),
+                                                        int cmock_num_calls)
+{
+    g_sim_alarm_cb = ppt_callback;
+    return RET_OK;
+}
+
+static void fire_cb(void)
+{
+    g_fire_cnt++;
+}
+
+/// Periods from 1 ms to ~65 s, spread over the levels of the wheel
+static uint32_t bench_period_ms(uint32_t p_idx)
+{
+    return 1U + ((p_idx * 7919U) % 65536U);
+}
+
+static void sim_run_alarms(void)
+{
+    while (g_sim_alarm_armed == TRUE)
+    {
+        g_sim_time_us    += (uint32_t)(g_sim_compare - (uint32_t)g_sim_time_us);
+        g_sim_alarm_armed = FALSE;
+        g_sim_alarm_cb();
+    }
+}
+
+static bench_cost_t bench_run(uint32_t p_timer_cnt)
+{
+    bench_cost_t best = { UINT32_MAX, UINT32_MAX, UINT32_MAX };
+
+    for (uint32_t run = 0U; run < BENCH_RUNS; run++)
+    {
+        uint64_t t0 = 0U;
+        uint32_t ns = 0U;
+
+        t0 = host_now_ns();
+        for (uint32_t i = 0U; i < p_timer_cnt; i++)
+        {
+            ps_app_timer_start(g_pt_timers[i], bench_period_ms(i), APP_TIMER_UNIT_MS);
+        }
+        ns            = (uint32_t)((host_now_ns() - t0) / p_timer_cnt);
+        best.start_ns = (ns < best.start_ns) ? ns : best.start_ns;
+
+        t0 = host_now_ns();
+        for (uint32_t i = 0U; i < p_timer_cnt; i++)
+        {
+            ps_app_timer_stop(g_pt_timers[i]);
+        }
+        ns           = (uint32_t)((host_now_ns() - t0) / p_timer_cnt);
+        best.stop_ns = (ns < best.stop_ns) ? ns : best.stop_ns;
+
+        for (uint32_t i = 0U; i < p_timer_cnt; i++)
+        {
+            ps_app_timer_start(g_pt_timers[i], bench_period_ms(i), APP_TIMER_UNIT_MS);
+        }
+        g_fire_cnt = 0U;
+        t0         = host_now_ns();
+        sim_run_alarms();
+        ns             = (uint32_t)((host_now_ns() - t0) / p_timer_cnt);
+        best.expire_ns = (ns < best.expire_ns) ? ns : best.expire_ns;
+        TEST_ASSERT_EQUAL(p_timer_cnt, g_fire_cnt);
+    }
+
+    return best;
+}
+
+static void report_cost(uint32_t p_timer_cnt, const bench_cost_t* ppt_cost)
+{
+    char msg[96];
+
+    snprintf(msg,
+             sizeof(msg),
+             "%4u timers: start %u ns, stop %u ns, expire %u ns",
+             (unsigned)p_timer_cnt,
+             (unsigned)ppt_cost->start_ns,
+             (unsigned)ppt_cost->stop_ns,
+             (unsigned)ppt_cost->expire_ns);
+    TEST_MESSAGE(msg);
+}
+
+void setUp(void)
+{
+    g_sim_time_us     = 0U;
+    g_sim_compare     = 0U;
+    g_sim_alarm_armed = FALSE;
+    g_sim_alarm_cb    = NULL;
+    g_is_initialized  = FALSE;
+
+    ha_timer_init_IgnoreAndReturn(RET_OK);
+    ha_timer_get_counter_StubWithCallback(ha_timer_get_counter_stub);
+    ha_timer_set_alarm_StubWithCallback(ha_timer_set_alarm_stub);
+    ha_timer_cancel_alarm_StubWithCallback(ha_timer_cancel_alarm_stub);
+    ha_timer_register_alarm_callback_StubWithCallback(ha_timer_register_alarm_callback_stub);
+
+    TEST_ASSERT_EQUAL(RET_OK, ps_app_timer_init());
+
+    for (uint32_t i = 0U; i < BENCH_MAX_TIMERS; i++)
+    {
+        TEST_ASSERT_EQUAL(RET_OK, ps_app_timer_create(&g_pt_timers[i], TRUE, fire_cb, PS_EXEC_ISR));
+    }
+}
+
+void tearDown(void) {}
+
+void test_ps_app_timer_bench_cost_should_not_grow_with_timer_count(void)
+{
+    bench_cost_t cost_10   = bench_run(10U);
+    bench_cost_t cost_100  = bench_run(100U);
+    bench_cost_t cost_1000 = bench_run(1000U);
+
+    report_cost(10U, &cost_10);
+    report_cost(100U, &cost_100);
+    report_cost(1000U, &cost_1000);
+
+    TEST_ASSERT_LESS_OR_EQUAL((cost_10.start_ns * BENCH_MAX_GROWTH) + BENCH_NOISE_NS,
+                              cost_1000.start_ns);
+    TEST_ASSERT_LESS_OR_EQUAL((cost_10.stop_ns * BENCH_MAX_GROWTH) + BENCH_NOISE_NS,
+                              cost_1000.stop_ns);
+    TEST_ASSERT_LESS_OR_EQUAL((cost_10.expire_ns * BENCH_MAX_GROWTH) + BENCH_NOISE_NS,
+                              cost_1000.expire_ns);
+}
+
+#endif // TEST
@@ -0,0 +1,111 @@
+#ifdef TEST
+
+#include "ps_deferred_work.h"
+#include "unity.h"
+
+#define WORK_LOG_SZ (2U * PS_DEFERRED_WORK_QUEUE_SZ)
+
+/// Arguments of the work items in the order they were run
+static uint32_t g_work_log[WORK_LOG_SZ];
+static uint32_t g_work_cnt;
+
+static void log_work(uint32_t p_arg)
+{
+    if (g_work_cnt < WORK_LOG_SZ)
+    {
+        g_work_log[g_work_cnt] = p_arg;
+    }
+    g_work_cnt++;
+}
+
+/// Posts itself again until it has run three times
+static void repost_work(uint32_t p_arg)
+{
+    log_work(p_arg);
+    if (p_arg < 3U)
+    {
+        TEST_ASSERT_EQUAL(RET_OK, ps_deferred_work_post(repost_work, p_arg + 1U));
+    }
+}
+
+void setUp(void)
+{
+    ps_deferred_work_init();
+
+    // The queue keeps its state between the tests, drain what is left over
+    while (ps_deferred_work_is_pending() == TRUE)
+    {
+        (void)ps_deferred_work_process();
+    }
+    g_work_cnt = 0U;
+}
+
+void tearDown(void) {}
+
+void test_ps_deferred_work_should_run_items_in_posted_order(void)
+{
+    for (uint32_t i = 0U; i < 5U; i++)
+    {
+        TEST_ASSERT_EQUAL(RET_OK, ps_deferred_work_post(log_work, 100U + i));
+    }
+    TEST_ASSERT_EQUAL(0U, g_work_cnt);
+    TEST_ASSERT_TRUE(ps_deferred_work_is_pending());
+
+    TEST_ASSERT_EQUAL(5U, ps_deferred_work_process());
+
+    TEST_ASSERT_EQUAL(5U, g_work_cnt);
+    for (uint32_t i = 0U; i < 5U; i++)
+    {
+        TEST_ASSERT_EQUAL(100U + i, g_work_log[i]);
+    }
+    TEST_ASSERT_FALSE(ps_deferred_work_is_pending());
+}
+
+void test_ps_deferred_work_full_queue_should_drop_and_count(void)
+{
+    ps_deferred_work_stats_t before = { 0U };
+    ps_deferred_work_stats_t after  = { 0U };
+
+    ps_deferred_work_get_stats(&before);
+
+    for (uint32_t i = 0U; i < PS_DEFERRED_WORK_QUEUE_SZ; i++)
+    {
+        TEST_ASSERT_EQUAL(RET_OK, ps_deferred_work_post(log_work, i));
+    }
+    TEST_ASSERT_EQUAL(RET_NO_MEMORY, ps_deferred_work_post(log_work, 0xFFU));
+    TEST_ASSERT_EQUAL(RET_NO_MEMORY, ps_deferred_work_post(log_work, 0xFFU));
+
+    TEST_ASSERT_EQUAL(PS_DEFERRED_WORK_QUEUE_SZ, ps_deferred_work_process());
+    TEST_ASSERT_EQUAL(PS_DEFERRED_WORK_QUEUE_SZ - 1U, g_work_log[PS_DEFERRED_WORK_QUEUE_SZ - 1U]);
+
+    ps_deferred_work_get_stats(&after);
+    TEST_ASSERT_EQUAL(2U, after.dropped_cnt - before.dropped_cnt);
+    TEST_ASSERT_EQUAL(PS_DEFERRED_WORK_QUEUE_SZ, after.posted_cnt - before.posted_cnt);
+    TEST_ASSERT_EQUAL(PS_DEFERRED_WORK_QUEUE_SZ, after.run_cnt - before.run_cnt);
+    TEST_ASSERT_EQUAL(PS_DEFERRED_WORK_QUEUE_SZ, after.max_pending);
+
+    // The released cells are usable again
+    TEST_ASSERT_EQUAL(RET_OK, ps_deferred_work_post(log_work, 7U));
+    TEST_ASSERT_EQUAL(1U, ps_deferred_work_process());
+}
+
+void test_ps_deferred_work_item_posted_while_running_should_wait_for_next_call(void)
+{
+    TEST_ASSERT_EQUAL(RET_OK, ps_deferred_work_post(repost_work, 1U));
+
+    TEST_ASSERT_EQUAL(1U, ps_deferred_work_process());
+    TEST_ASSERT_EQUAL(1U, ps_deferred_work_process());
+    TEST_ASSERT_EQUAL(1U, ps_deferred_work_process());
+
+    TEST_ASSERT_EQUAL(3U, g_work_cnt);
+    TEST_ASSERT_EQUAL(3U, g_work_log[2]);
+    TEST_ASSERT_FALSE(ps_deferred_work_is_pending());
+}
+
+void test_ps_deferred_work_null_function_should_return_param_error(void)
+{
+    TEST_ASSERT_EQUAL(RET_PARAM_ERROR, ps_deferred_work_post(NULL, 0U));
+    TEST_ASSERT_FALSE(ps_deferred_work_is_pending());
+}
+
+#endif // TEST
@@ -0,0 +1,145 @@
+#ifdef TEST
+
+#include "mock_ha_iic.h"
+#include "mock_ha_timer.h"
+#include "mock_ps_logger.h"
+#include "ps_iic_bus_scanner.h"
+#include "unity.h"
+
+#include <string.h>
+
+#define SIM_ADDR_PHASE_US  (100U)   // address phase with ACK/NACK at 100 kHz
+#define SIM_STUCK_PROBE_US (1000U)  // probe that runs into its timeout
+#define SIM_DEV_BMP388     (0x76U)
+#define SIM_DEV_ICM20948   (0x68U)
+
+static const ps_iic_expected_dev_t g_expected_devs[] = {
+    { SIM_DEV_BMP388, "BMP388" },
+    { SIM_DEV_ICM20948, "ICM-20948" },
+};
+
+/// Simulated I2C bus, each probe advances the simulated CPU time
+static bool_t   g_sim_present[128];
+static bool_t   g_sim_stuck[128];
+static uint32_t g_sim_time_us;
+
+response_status_t ha_iic_dev_probe_stub(iic_comm_port_t p_port, uint8_t p_dev_addr,
+                                        timeout_t p_timeout_ms, int cmock_num_calls)
+{
+    TEST_ASSERT_EQUAL(IIC_PORT1, p_port);
+    TEST_ASSERT_TRUE(p_dev_addr >= 0x08U && p_dev_addr <= 0x77U);
+
+    if (g_sim_stuck[p_dev_addr] == TRUE)
+    {
+        g_sim_time_us += p_timeout_ms * 1000U;
+        return RET_TIMEOUT;
+    }
+
+    g_sim_time_us += SIM_ADDR_PHASE_US;
+
+    return (g_sim_present[p_dev_addr] == TRUE) ? RET_OK : RET_ERROR;
+}
+
+uint32_t ha_timer_get_cpu_time_us_stub(int cmock_num_calls)
+{
+    return g_sim_time_us;
+}
+
+void setUp(void)
+{
+    memset(g_sim_present, 0U, sizeof(g_sim_present));
+    memset(g_sim_stuck, 0U, sizeof(g_sim_stuck));
+    g_sim_time_us                   = 0U;
+    g_sim_present[SIM_DEV_BMP388]   = TRUE;
+    g_sim_present[SIM_DEV_ICM20948] = TRUE;
+
+    ha_iic_dev_probe_StubWithCallback(ha_iic_dev_probe_stub);
+    ha_timer_get_cpu_time_us_StubWithCallback(ha_timer_get_cpu_time_us_stub);
+    ps_logger_send_Ignore();
+
+    ps_iic_bus_invalidate_map();
+}
+
+void tearDown(void) {}
+
+void test_ps_scan_iic_bus_first_boot_should_probe_all_addresses_once(void)
+{
+    ps_iic_scan_info_t info = { 0U };
+
+    TEST_ASSERT_EQUAL(RET_OK, ps_scan_iic_bus(g_expected_devs, ARRAY_SIZE(g_expected_devs)));
+    ps_iic_bus_get_scan_info(&info);
+
+    TEST_ASSERT_TRUE(info.is_full_scan);
+    TEST_ASSERT_EQUAL(112U, info.probe_cnt);
+    TEST_ASSERT_EQUAL(2U, info.dev_cnt);
+    TEST_ASSERT_EQUAL(0U, info.missing_cnt);
+    TEST_ASSERT_EQUAL(112U * SIM_ADDR_PHASE_US, info.duration_us);
+    TEST_ASSERT_TRUE(ps_iic_bus_dev_is_present(SIM_DEV_BMP388));
+    TEST_ASSERT_TRUE(ps_iic_bus_dev_is_present(SIM_DEV_ICM20948));
+    TEST_ASSERT_FALSE(ps_iic_bus_dev_is_present(0x50U));
+}
+
+void test_ps_scan_iic_bus_next_boot_should_only_verify_expected_devices(void)
+{
+    ps_iic_scan_info_t info = { 0U };
+
+    g_sim_present[0x50U] = TRUE;
+    TEST_ASSERT_EQUAL(RET_OK, ps_scan_iic_bus(g_expected_devs, ARRAY_SIZE(g_expected_devs)));
+
+    g_sim_time_us = 0U;
+    TEST_ASSERT_EQUAL(RET_OK, ps_scan_iic_bus(g_expected_devs, ARRAY_SIZE(g_expected_devs)));
+    ps_iic_bus_get_scan_info(&info);
+
+    TEST_ASSERT_FALSE(info.is_full_scan);
+    TEST_ASSERT_EQUAL(2U, info.probe_cnt);
+    TEST_ASSERT_EQUAL(3U, info.dev_cnt);
+    TEST_ASSERT_EQUAL(2U * SIM_ADDR_PHASE_US, info.duration_us);
+    TEST_ASSERT_TRUE(ps_iic_bus_dev_is_present(0x50U));
+}
+
+void test_ps_scan_iic_bus_with_missing_device_should_rescan_and_return_not_found(void)
+{
+    ps_iic_scan_info_t info = { 0U };
+
+    TEST_ASSERT_EQUAL(RET_OK, ps_scan_iic_bus(g_expected_devs, ARRAY_SIZE(g_expected_devs)));
+
+    g_sim_present[SIM_DEV_BMP388] = FALSE;
+    TEST_ASSERT_EQUAL(RET_NOT_FOUND, ps_scan_iic_bus(g_expected_devs, ARRAY_SIZE(g_expected_devs)));
+    ps_iic_bus_get_scan_info(&info);
+
+    TEST_ASSERT_TRUE(info.is_full_scan);
+    TEST_ASSERT_EQUAL(1U, info.missing_cnt);
+    TEST_ASSERT_FALSE(ps_iic_bus_dev_is_present(SIM_DEV_BMP388));
+}
+
+void test_ps_scan_iic_bus_should_check_the_devices_given_by_the_app(void)
+{
+    const ps_iic_expected_dev_t alt_devs[] = { { SIM_DEV_BMP388 + 1U, "BMP388" } };
+    ps_iic_scan_info_t          info       = { 0U };
+
+    TEST_ASSERT_EQUAL(RET_NOT_FOUND, ps_scan_iic_bus(alt_devs, ARRAY_SIZE(alt_devs)));
+    ps_iic_bus_get_scan_info(&info);
+    TEST_ASSERT_EQUAL(1U, info.missing_cnt);
+
+    g_sim_present[SIM_DEV_BMP388 + 1U] = TRUE;
+    TEST_ASSERT_EQUAL(RET_OK, ps_scan_iic_bus(alt_devs, ARRAY_SIZE(alt_devs)));
+    TEST_ASSERT_EQUAL(RET_PARAM_ERROR, ps_scan_iic_bus(NULL, 1U));
+}
+
+void test_ps_scan_iic_bus_with_stuck_addresses_should_bound_scan_time(void)
+{
+    ps_iic_scan_info_t info = { 0U };
+
+    for (uint8_t addr = 0x08U; addr <= 0x77U; addr++)
+    {
+        g_sim_stuck[addr] = (addr != SIM_DEV_BMP388 && addr != SIM_DEV_ICM20948) ? TRUE : FALSE;
+    }
+
+    TEST_ASSERT_EQUAL(RET_OK, ps_scan_iic_bus(g_expected_devs, ARRAY_SIZE(g_expected_devs)));
+    ps_iic_bus_get_scan_info(&info);
+
+    /// One short timeout per address instead of 10 tries of 100 ms
+    TEST_ASSERT_LESS_OR_EQUAL(112U * SIM_STUCK_PROBE_US, info.duration_us);
+}
+
+#endif // TEST
@@ -0,0 +1,103 @@
+#ifdef TEST
+
+#include "mock_ps_logger.h"
+#include "ps_profiler.h"
+#include "su_profiler.h"
+#include "unity.h"
+
+#include <time.h>
+
+/// Built with PS_PROFILER_HOST_CLOCK, see the defines of this test in project.yml
+#define SLEEP_US (2000U)
+#define BUSY_US  (2000U)
+
+static uint32_t g_dump_line_cnt;
+
+void ps_logger_send_stub(debug_level_t p_lvl, const char* ppt_func_name, const char* ppt_msg,
+                         float p_param_1, float p_param_2, float p_param_3, int cmock_num_calls)
+{
+    g_dump_line_cnt++;
+}
+
+static uint64_t host_now_us(void)
+{
+    struct timespec now;
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return ((uint64_t)now.tv_sec * 1000000U) + ((uint64_t)now.tv_nsec / 1000U);
+}
+
+static void host_sleep_us(uint32_t p_us)
+{
+    struct timespec delay = { 0, (long)p_us * 1000L };
+
+    nanosleep(&delay, NULL);
+}
+
+static void host_busy_us(uint32_t p_us)
+{
+    uint64_t end_us = host_now_us() + p_us;
+
+    while (host_now_us() < end_us)
+    {
+        ;
+    }
+}
+
+void setUp(void)
+{
+    g_dump_line_cnt = 0U;
+    ps_logger_send_StubWithCallback(ps_logger_send_stub);
+
+    TEST_ASSERT_EQUAL(RET_OK, ps_profiler_init());
+}
+
+void tearDown(void) {}
+
+void test_ps_profiler_host_clock_should_measure_in_target_cycles(void)
+{
+    su_prof_stats_t stats = { 0U };
+
+    SU_PROF_ENTER(SU_PROF_IIC_XFER);
+    host_busy_us(BUSY_US);
+    SU_PROF_EXIT(SU_PROF_IIC_XFER);
+
+    TEST_ASSERT_EQUAL(RET_OK, su_prof_get_stats(SU_PROF_IIC_XFER, &stats));
+    TEST_ASSERT_EQUAL(1U, stats.cnt);
+    TEST_ASSERT_TRUE(stats.max_cycles >= ((BUSY_US - 1U) * PS_PROFILER_CYCLES_PER_US));
+    TEST_ASSERT_TRUE(stats.max_cycles < (10U * BUSY_US * PS_PROFILER_CYCLES_PER_US));
+}
+
+void test_ps_profiler_load_should_follow_the_idle_time(void)
+{
+    uint32_t load = 0U;
+
+    for (uint32_t i = 0U; i < 5U; i++)
+    {
+        host_busy_us(BUSY_US);
+        SU_PROF_ENTER(SU_PROF_IDLE);
+        host_sleep_us(SLEEP_US);
+        SU_PROF_EXIT(SU_PROF_IDLE);
+    }
+    load = ps_profiler_get_load_permille();
+
+    /// Half busy, the host scheduler only makes the sleeps longer
+    TEST_ASSERT_TRUE(load > 50U);
+    TEST_ASSERT_TRUE(load < 600U);
+}
+
+void test_ps_profiler_dump_should_log_hit_probes_and_restart_the_window(void)
+{
+    su_prof_stats_t stats = { 0U };
+
+    SU_PROF_ENTER(SU_PROF_ISR_TIM2);
+    SU_PROF_EXIT(SU_PROF_ISR_TIM2);
+    ps_profiler_dump();
+
+    /// Summary line and two lines for the only probe that was hit
+    TEST_ASSERT_EQUAL(3U, g_dump_line_cnt);
+    TEST_ASSERT_EQUAL(RET_OK, su_prof_get_stats(SU_PROF_ISR_TIM2, &stats));
+    TEST_ASSERT_EQUAL(0U, stats.cnt);
+}
+
+#endif // TEST
@@ -0,0 +1,241 @@
+#ifdef TEST
+
+#include "mock_ha_iic.h"
+#include "mock_ha_input_capture.h"
+#include "mock_ha_timer.h"
+#include "mock_serial_ifc.h"
+#include "ps_recorder.h"
+#include "su_rec.h"
+#include "su_ring_buffer.h"
+#include "unity.h"
+
+#include <stdio.h>
+#include <string.h>
+
+static uint32_t          g_counter;
+static size_t            g_serial_free;
+static char              g_serial_out[16384];
+static size_t            g_serial_len;
+static iic_record_hook_t g_pt_iic_hook;
+static ic_record_hook_t  g_pt_capture_hook;
+static uint8_t           g_rec[8192];
+
+uint32_t ha_timer_get_counter_stub(int cmock_num_calls)
+{
+    return g_counter;
+}
+
+size_t serial_ifc_get_free_stub(int cmock_num_calls)
+{
+    return g_serial_free;
+}
+
+void serial_ifc_send_stub(const uint8_t* ppt_data, size_t p_len, int cmock_num_calls)
+{
+    TEST_ASSERT_TRUE(p_len <= g_serial_free);
+    TEST_ASSERT_TRUE((g_serial_len + p_len) < sizeof(g_serial_out));
+    memcpy(&g_serial_out[g_serial_len], ppt_data, p_len);
+    g_serial_len                += p_len;
+    g_serial_out[g_serial_len]   = '\0';
+    g_serial_free               -= p_len;
+}
+
+void ha_iic_register_record_hook_stub(iic_record_hook_t ppt_hook, int cmock_num_calls)
+{
+    g_pt_iic_hook = ppt_hook;
+}
+
+void ha_input_capture_register_record_hook_stub(ic_record_hook_t ppt_hook, int cmock_num_calls)
+{
+    g_pt_capture_hook = ppt_hook;
+}
+
+/// Converts the "#R" lines of the dump back to the recording, as tools/record does
+static size_t parse_dump(void)
+{
+    const char* pt_line = g_serial_out;
+    size_t      len     = 0U;
+
+    TEST_ASSERT_EQUAL(0, strncmp(pt_line, "#RS\n", 4U));
+    while ((pt_line = strstr(pt_line, "#R ")) != NULL)
+    {
+        unsigned int byte = 0U;
+
+        pt_line += 3;
+        while (sscanf(pt_line, "%2x", &byte) == 1)
+        {
+            g_rec[len++]  = (uint8_t)byte;
+            pt_line      += 2;
+        }
+        TEST_ASSERT_EQUAL('\n', *pt_line);
+    }
+
+    return len;
+}
+
+static void capture(uint32_t p_t_us, input_capture_channel_t p_channel, uint32_t p_value)
+{
+    g_counter = p_t_us;
+    TEST_ASSERT_NOT_NULL(g_pt_capture_hook);
+    g_pt_capture_hook(p_channel, p_value);
+}
+
+static void iic_read(uint32_t p_t_us, uint8_t p_dev_addr, const uint8_t* ppt_data, size_t p_len)
+{
+    g_counter = p_t_us;
+    TEST_ASSERT_NOT_NULL(g_pt_iic_hook);
+    g_pt_iic_hook(IIC_PORT1, p_dev_addr, 0x1FU, HW_IIC_MEM_SZ_8BIT, ppt_data, p_len);
+}
+
+static void drain_all(void)
+{
+    g_serial_free = sizeof(g_serial_out);
+    while (ps_recorder_drain() > 0U)
+    {
+    }
+}
+
+void setUp(void)
+{
+    g_counter         = 1000U;
+    g_serial_free     = 512U;
+    g_serial_len      = 0U;
+    g_pt_iic_hook     = NULL;
+    g_pt_capture_hook = NULL;
+    memset(g_serial_out, 0, sizeof(g_serial_out));
+
+    ha_timer_get_counter_StubWithCallback(ha_timer_get_counter_stub);
+    serial_ifc_get_free_StubWithCallback(serial_ifc_get_free_stub);
+    serial_ifc_send_StubWithCallback(serial_ifc_send_stub);
+    ha_iic_register_record_hook_StubWithCallback(ha_iic_register_record_hook_stub);
+    ha_input_capture_register_record_hook_StubWithCallback(
+      ha_input_capture_register_record_hook_stub);
+}
+
+void tearDown(void)
+{
+    ps_recorder_stop();
+    drain_all();
+}
+
+void test_ps_recorder_drain_without_recording_should_send_nothing(void)
+{
+    TEST_ASSERT_EQUAL(0U, ps_recorder_drain());
+    TEST_ASSERT_EQUAL(0U, g_serial_len);
+}
+
+void test_ps_recorder_dump_should_decode_to_the_recorded_inputs(void)
+{
+    const uint8_t       imu[6] = { 0x01U, 0x02U, 0x03U, 0x04U, 0x05U, 0x06U };
+    su_rec_reader_t     reader;
+    su_rec_event_t      ev;
+    ps_recorder_stats_t stats;
+
+    TEST_ASSERT_EQUAL(RET_OK, ps_recorder_start());
+    capture(1500U, INPUT_CAPTURE_CHANNEL_2, 1234U);
+    iic_read(2000U, 0x68U, imu, sizeof(imu));
+    capture(2500U, INPUT_CAPTURE_CHANNEL_1, 1800U);
+    ps_recorder_stop();
+
+    /// Nothing is recorded after the stop
+    TEST_ASSERT_NULL(g_pt_iic_hook);
+    TEST_ASSERT_NULL(g_pt_capture_hook);
+
+    drain_all();
+    TEST_ASSERT_EQUAL_STRING("#RE\n", &g_serial_out[g_serial_len - 4U]);
+    TEST_ASSERT_EQUAL(RET_OK, su_rec_reader_init(&reader, g_rec, parse_dump()));
+
+    TEST_ASSERT_EQUAL(RET_OK, su_rec_read(&reader, &ev));
+    TEST_ASSERT_EQUAL(SU_REC_CAPTURE, ev.type);
+    TEST_ASSERT_EQUAL(500U, ev.t_us);
+    TEST_ASSERT_EQUAL(INPUT_CAPTURE_CHANNEL_2, ev.capture.channel);
+    TEST_ASSERT_EQUAL(1234U, ev.capture.value);
+
+    TEST_ASSERT_EQUAL(RET_OK, su_rec_read(&reader, &ev));
+    TEST_ASSERT_EQUAL(SU_REC_IIC_READ, ev.type);
+    TEST_ASSERT_EQUAL(1000U, ev.t_us);
+    TEST_ASSERT_EQUAL(0x68U, ev.iic.dev_addr);
+    TEST_ASSERT_EQUAL(0x1FU, ev.iic.mem_addr);
+    TEST_ASSERT_EQUAL(HW_IIC_MEM_SZ_8BIT, ev.iic.mem_size);
+    TEST_ASSERT_EQUAL(sizeof(imu), ev.iic.len);
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(imu, ev.iic.pt_data, sizeof(imu));
+
+    TEST_ASSERT_EQUAL(RET_OK, su_rec_read(&reader, &ev));
+    TEST_ASSERT_EQUAL(1500U, ev.t_us);
+    TEST_ASSERT_EQUAL(RET_NOT_FOUND, su_rec_read(&reader, &ev));
+
+    ps_recorder_get_stats(&stats);
+    TEST_ASSERT_EQUAL(3U, stats.rec_cnt);
+    TEST_ASSERT_EQUAL(0U, stats.drop_cnt);
+    TEST_ASSERT_EQUAL(reader.len, stats.byte_cnt);
+}
+
+void test_ps_recorder_captures_beyond_the_queue_should_be_dropped(void)
+{
+    ps_recorder_stats_t stats;
+
+    TEST_ASSERT_EQUAL(RET_OK, ps_recorder_start());
+    for (uint32_t i = 0U; i < (PS_RECORDER_CAPTURE_QUEUE_SZ + 4U); i++)
+    {
+        capture(1000U + i, INPUT_CAPTURE_CHANNEL_1, i);
+    }
+    ps_recorder_get_stats(&stats);
+    TEST_ASSERT_EQUAL(4U, stats.drop_cnt);
+
+    /// The main context empties the queue, the interrupt can record again
+    (void)ps_recorder_drain();
+    capture(2000U, INPUT_CAPTURE_CHANNEL_1, 0U);
+    (void)ps_recorder_drain();
+    ps_recorder_get_stats(&stats);
+    TEST_ASSERT_EQUAL(PS_RECORDER_CAPTURE_QUEUE_SZ + 1U, stats.rec_cnt);
+    TEST_ASSERT_EQUAL(4U, stats.drop_cnt);
+}
+
+void test_ps_recorder_full_stream_should_drop_whole_records(void)
+{
+    uint8_t             data[200];
+    su_rec_reader_t     reader;
+    su_rec_event_t      ev;
+    ps_recorder_stats_t stats;
+    uint32_t            read_cnt = 0U;
+
+    memset(data, 0xA5, sizeof(data));
+    TEST_ASSERT_EQUAL(RET_OK, ps_recorder_start());
+    for (uint32_t i = 0U; i < 40U; i++)
+    {
+        iic_read(1000U + (i * 100U), 0x77U, data, sizeof(data));
+    }
+    ps_recorder_stop();
+    ps_recorder_get_stats(&stats);
+    TEST_ASSERT_TRUE(stats.drop_cnt > 0U);
+    TEST_ASSERT_EQUAL(40U, stats.rec_cnt + stats.drop_cnt);
+    TEST_ASSERT_TRUE(stats.byte_cnt <= PS_RECORDER_BUF_SZ);
+
+    drain_all();
+    TEST_ASSERT_EQUAL(RET_OK, su_rec_reader_init(&reader, g_rec, parse_dump()));
+    while (su_rec_read(&reader, &ev) == RET_OK)
+    {
+        TEST_ASSERT_EQUAL(sizeof(data), ev.iic.len);
+        read_cnt++;
+    }
+    TEST_ASSERT_EQUAL(reader.len, reader.pos);
+    TEST_ASSERT_EQUAL(stats.rec_cnt, read_cnt);
+}
+
+void test_ps_recorder_drain_should_wait_for_room_in_the_serial_buffer(void)
+{
+    const uint8_t data[4] = { 0U };
+
+    TEST_ASSERT_EQUAL(RET_OK, ps_recorder_start());
+    iic_read(1100U, 0x68U, data, sizeof(data));
+
+    g_serial_free = 8U;
+    TEST_ASSERT_EQUAL(0U, ps_recorder_drain());
+    TEST_ASSERT_EQUAL(0U, g_serial_len);
+
+    g_serial_free = 512U;
+    TEST_ASSERT_TRUE(ps_recorder_drain() > 0U);
+    TEST_ASSERT_EQUAL(0, strncmp(g_serial_out, "#RS\n#R 53524543", 15U));
+}
+
+#endif // TEST
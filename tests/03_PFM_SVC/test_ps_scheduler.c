@@ -0,0 +1,338 @@
+#ifdef TEST
+
+#include "mock_ha_timer.h"
+#include "mock_ps_app_timer.h"
+#include "ps_deferred_work.h"
+#include "ps_scheduler.h"
+#include "su_trace.h"
+#include "unity.h"
+
+#include <stdio.h>
+#include <string.h>
+
+#define SIM_START_US    (0xFFFF0000ULL) // the counter wraps around early in each run
+#define SIM_DURATION_US (1000000U)
+#define SIM_IRQ_NONE    (UINT64_MAX)
+
+#define IMU_COST_US       (300U)
+#define BARO_COST_US      (500U)
+#define TELEMETRY_COST_US (1500U)
+
+extern bool_t g_sched_is_initialized;
+
+/// Simulated 1 MHz counter, the tasks consume CPU time by advancing it
+static uint64_t                 g_sim_time_us;
+static uint64_t                 g_sim_wake_at_us;
+static bool_t                   g_sim_wake_armed;
+static uint64_t                 g_sim_irq_at_us; // external interrupt triggering the event task
+static app_timer_handler_t      g_sim_wake_timer;
+static uint32_t                 g_sim_sleep_cnt;
+static ps_sched_task_handler_t* g_pt_imu_task;
+static ps_sched_task_handler_t* g_pt_baro_task;
+static ps_sched_task_handler_t* g_pt_telemetry_task;
+static ps_sched_task_handler_t* g_pt_event_task;
+
+/// Order in which the tasks ran, one letter per run
+static char     g_run_log[16];
+static uint32_t g_run_log_len;
+
+uint32_t ha_timer_get_counter_stub(int cmock_num_calls)
+{
+    return (uint32_t)g_sim_time_us;
+}
+
+static void sim_irq(void);
+
+/// The core sleeps until the wake-up timer or the external interrupt
+void ha_timer_wait_for_interrupt_stub(int cmock_num_calls)
+{
+    uint64_t wake_us = SIM_IRQ_NONE;
+
+    if (g_sim_wake_armed == TRUE)
+    {
+        wake_us = g_sim_wake_at_us;
+    }
+    if (g_sim_irq_at_us < wake_us)
+    {
+        wake_us = g_sim_irq_at_us;
+    }
+    TEST_ASSERT_TRUE(wake_us != SIM_IRQ_NONE); // the core would sleep forever
+
+    g_sim_time_us = (wake_us > g_sim_time_us) ? wake_us : g_sim_time_us;
+    g_sim_sleep_cnt++;
+
+    if ((g_sim_wake_armed == TRUE) && (g_sim_time_us >= g_sim_wake_at_us))
+    {
+        g_sim_wake_armed            = FALSE;
+        g_sim_wake_timer.is_running = FALSE;
+    }
+    if (g_sim_time_us >= g_sim_irq_at_us)
+    {
+        g_sim_irq_at_us = SIM_IRQ_NONE;
+        sim_irq();
+    }
+}
+
+response_status_t ps_app_timer_create_stub(app_timer_handler_t** ppt_timer_handler,
+                                           bool_t                p_oneshot_timer,
+                                           app_timer_callback_t  ppt_callback,
+                                           ps_exec_ctx_t         p_exec_ctx,
+                                           int                   cmock_num_calls)
+{
+    *ppt_timer_handler = &g_sim_wake_timer;
+    return RET_OK;
+}
+
+response_status_t ps_app_timer_start_stub(app_timer_handler_t* ppt_timer_handler,
+                                          uint32_t p_timer_period, app_timer_unit_t p_time_unit,
+                                          int cmock_num_calls)
+{
+    TEST_ASSERT_EQUAL(APP_TIMER_UNIT_US, p_time_unit);
+    TEST_ASSERT_TRUE(p_timer_period > 0U);
+
+    g_sim_wake_at_us            = g_sim_time_us + p_timer_period;
+    g_sim_wake_armed            = TRUE;
+    g_sim_wake_timer.is_running = TRUE;
+
+    return RET_OK;
+}
+
+response_status_t ps_app_timer_stop_stub(app_timer_handler_t* ppt_timer_handler,
+                                         int cmock_num_calls)
+{
+    g_sim_wake_armed            = FALSE;
+    g_sim_wake_timer.is_running = FALSE;
+    return RET_OK;
+}
+
+static void log_run(char p_task)
+{
+    if (g_run_log_len < (sizeof(g_run_log) - 1U))
+    {
+        g_run_log[g_run_log_len++] = p_task;
+    }
+}
+
+static void imu_task(void)
+{
+    log_run('i');
+    g_sim_time_us += IMU_COST_US;
+}
+
+static void baro_task(void)
+{
+    log_run('b');
+    g_sim_time_us += BARO_COST_US;
+}
+
+static void telemetry_task(void)
+{
+    log_run('t');
+    g_sim_time_us += TELEMETRY_COST_US;
+}
+
+static void event_task(void)
+{
+    log_run('e');
+    g_sim_time_us += 100U;
+}
+
+static void deferred_work(uint32_t p_arg)
+{
+    log_run((char)p_arg);
+}
+
+static void sim_irq(void)
+{
+    TEST_ASSERT_EQUAL(RET_OK, ps_sched_task_trigger(g_pt_event_task));
+}
+
+static void sim_run_until(uint64_t p_end_us)
+{
+    while (g_sim_time_us < p_end_us)
+    {
+        (void)ps_sched_run_once();
+    }
+}
+
+static void report_task(const ps_sched_task_handler_t* ppt_task)
+{
+    char msg[96];
+
+    snprintf(msg,
+             sizeof(msg),
+             "%-10s %4u runs, %5u us CPU, max exec %4u us, max jitter %4u us",
+             ppt_task->name,
+             (unsigned)ppt_task->run_cnt,
+             (unsigned)ppt_task->total_exec_us,
+             (unsigned)ppt_task->max_exec_us,
+             (unsigned)ppt_task->max_jitter_us);
+    TEST_MESSAGE(msg);
+}
+
+static void create_app_tasks(void)
+{
+    TEST_ASSERT_EQUAL(RET_OK, ps_sched_task_create(&g_pt_imu_task, "imu", imu_task, 0U, 10000U));
+    TEST_ASSERT_EQUAL(RET_OK,
+                      ps_sched_task_create(&g_pt_baro_task, "baro", baro_task, 1U, 20000U));
+    TEST_ASSERT_EQUAL(RET_OK,
+                      ps_sched_task_create(&g_pt_telemetry_task,
+                                           "telemetry",
+                                           telemetry_task,
+                                           2U,
+                                           50000U));
+}
+
+void setUp(void)
+{
+    g_sim_time_us               = SIM_START_US;
+    g_sim_wake_at_us            = 0U;
+    g_sim_wake_armed            = FALSE;
+    g_sim_irq_at_us             = SIM_IRQ_NONE;
+    g_sim_wake_timer.is_running = FALSE;
+    g_sim_sleep_cnt             = 0U;
+    g_run_log_len               = 0U;
+    g_sched_is_initialized      = FALSE;
+    memset(g_run_log, 0, sizeof(g_run_log));
+
+    ha_timer_get_counter_StubWithCallback(ha_timer_get_counter_stub);
+    ha_timer_wait_for_interrupt_StubWithCallback(ha_timer_wait_for_interrupt_stub);
+    ps_app_timer_init_IgnoreAndReturn(RET_OK);
+    ps_app_timer_create_StubWithCallback(ps_app_timer_create_stub);
+    ps_app_timer_start_StubWithCallback(ps_app_timer_start_stub);
+    ps_app_timer_stop_StubWithCallback(ps_app_timer_stop_stub);
+
+    ps_deferred_work_init();
+    TEST_ASSERT_EQUAL(RET_OK, ps_sched_init());
+}
+
+void tearDown(void) {}
+
+void test_ps_sched_app_tasks_should_sleep_between_releases(void)
+{
+    ps_sched_stats_t stats   = { 0U };
+    char             msg[96] = { 0 };
+
+    create_app_tasks();
+    sim_run_until(SIM_START_US + SIM_DURATION_US);
+    ps_sched_get_stats(&stats);
+
+    report_task(g_pt_imu_task);
+    report_task(g_pt_baro_task);
+    report_task(g_pt_telemetry_task);
+    snprintf(msg,
+             sizeof(msg),
+             "loop: busy %u us, idle %u us, %u sleeps",
+             (unsigned)stats.busy_us,
+             (unsigned)stats.idle_us,
+             (unsigned)stats.idle_cnt);
+    TEST_MESSAGE(msg);
+
+    TEST_ASSERT_EQUAL(100U, g_pt_imu_task->run_cnt);
+    TEST_ASSERT_EQUAL(50U, g_pt_baro_task->run_cnt);
+    TEST_ASSERT_EQUAL(20U, g_pt_telemetry_task->run_cnt);
+    TEST_ASSERT_EQUAL(100U * IMU_COST_US, g_pt_imu_task->total_exec_us);
+    TEST_ASSERT_EQUAL(TELEMETRY_COST_US, g_pt_telemetry_task->max_exec_us);
+
+    /// The CPU only works 8.5% of the time instead of polling at 100%
+    TEST_ASSERT_EQUAL(85000U, stats.busy_us);
+    TEST_ASSERT_EQUAL(SIM_DURATION_US - 85000U, stats.idle_us);
+
+    /// Releases of higher priority tasks at the same time delay the others
+    TEST_ASSERT_EQUAL(0U, g_pt_imu_task->max_jitter_us);
+    TEST_ASSERT_EQUAL(IMU_COST_US, g_pt_baro_task->max_jitter_us);
+    TEST_ASSERT_EQUAL(IMU_COST_US + BARO_COST_US, g_pt_telemetry_task->max_jitter_us);
+    TEST_ASSERT_EQUAL(0U, g_pt_telemetry_task->missed_cnt);
+}
+
+void test_ps_sched_ready_tasks_should_run_in_priority_order(void)
+{
+    ps_sched_task_handler_t* pt_low  = NULL;
+    ps_sched_task_handler_t* pt_high = NULL;
+
+    // Created in reverse order, the priority decides
+    TEST_ASSERT_EQUAL(RET_OK, ps_sched_task_create(&pt_low, "baro", baro_task, 5U, 20000U));
+    TEST_ASSERT_EQUAL(RET_OK, ps_sched_task_create(&pt_high, "imu", imu_task, 1U, 20000U));
+
+    TEST_ASSERT_TRUE(ps_sched_run_once());
+    TEST_ASSERT_TRUE(ps_sched_run_once());
+    TEST_ASSERT_EQUAL_STRING("ib", g_run_log);
+}
+
+void test_ps_sched_overrun_should_skip_missed_periods(void)
+{
+    create_app_tasks();
+
+    TEST_ASSERT_TRUE(ps_sched_run_once());
+    g_sim_time_us += 35000U; // e.g. a blocking bus recovery in the imu task
+    sim_run_until(g_sim_time_us + 2000U);
+
+    /// The late releases run once, the periods in between are dropped
+    TEST_ASSERT_EQUAL(2U, g_pt_imu_task->missed_cnt);
+    TEST_ASSERT_EQUAL(1U, g_pt_baro_task->missed_cnt);
+}
+
+void test_ps_sched_event_task_should_only_run_when_triggered(void)
+{
+    TEST_ASSERT_EQUAL(RET_OK,
+                      ps_sched_task_create(&g_pt_event_task,
+                                           "event",
+                                           event_task,
+                                           0U,
+                                           PS_SCHED_EVENT_TASK));
+
+    /// Without a periodic task the core sleeps without a wake-up timer
+    g_sim_irq_at_us = g_sim_time_us + 7000U;
+    TEST_ASSERT_FALSE(ps_sched_run_once());
+    TEST_ASSERT_FALSE(g_sim_wake_armed);
+    TEST_ASSERT_TRUE(ps_sched_run_once());
+    TEST_ASSERT_EQUAL_STRING("e", g_run_log);
+    TEST_ASSERT_EQUAL(0U, g_pt_event_task->max_jitter_us);
+
+    /// Triggers raised before the task runs are merged
+    TEST_ASSERT_EQUAL(RET_OK, ps_sched_task_trigger(g_pt_event_task));
+    g_sim_time_us += 40U;
+    TEST_ASSERT_EQUAL(RET_OK, ps_sched_task_trigger(g_pt_event_task));
+    TEST_ASSERT_TRUE(ps_sched_run_once());
+    TEST_ASSERT_EQUAL(2U, g_pt_event_task->run_cnt);
+    TEST_ASSERT_EQUAL(40U, g_pt_event_task->max_jitter_us);
+
+    g_sim_irq_at_us = g_sim_time_us + 1000U;
+    TEST_ASSERT_FALSE(ps_sched_run_once());
+    TEST_ASSERT_EQUAL(2U, g_sim_sleep_cnt);
+}
+
+void test_ps_sched_deferred_work_should_run_before_tasks(void)
+{
+    create_app_tasks();
+    TEST_ASSERT_EQUAL(RET_OK, ps_deferred_work_post(deferred_work, 'd'));
+
+    TEST_ASSERT_TRUE(ps_sched_run_once());
+    TEST_ASSERT_TRUE(ps_sched_run_once());
+    TEST_ASSERT_EQUAL_STRING("di", g_run_log);
+}
+
+void test_ps_sched_task_pool_exhausted_should_return_no_memory(void)
+{
+    ps_sched_task_handler_t* pt_task = NULL;
+
+    for (uint32_t i = 0U; i < PS_SCHED_MAX_TASKS; i++)
+    {
+        TEST_ASSERT_EQUAL(RET_OK, ps_sched_task_create(&pt_task, "imu", imu_task, 0U, 1000U));
+    }
+    TEST_ASSERT_EQUAL(RET_NO_MEMORY, ps_sched_task_create(&pt_task, "imu", imu_task, 0U, 1000U));
+}
+
+void test_ps_sched_invalid_parameters_should_return_error(void)
+{
+    ps_sched_task_handler_t* pt_task = NULL;
+
+    TEST_ASSERT_EQUAL(RET_PARAM_ERROR, ps_sched_task_create(&pt_task, "x", NULL, 0U, 1000U));
+    TEST_ASSERT_EQUAL(RET_PARAM_ERROR,
+                      ps_sched_task_create(&pt_task, "x", imu_task, 0U, MAX_TIMER_PERIOD + 1U));
+
+    TEST_ASSERT_EQUAL(RET_OK, ps_sched_task_create(&pt_task, "imu", imu_task, 0U, 1000U));
+    TEST_ASSERT_EQUAL(RET_NOT_SUPPORTED, ps_sched_task_trigger(pt_task));
+}
+
+#endif // TEST
@@ -0,0 +1,103 @@
+#ifdef TEST
+
+#include "mock_ha_timer.h"
+#include "mock_serial_ifc.h"
+#include "ps_trace.h"
+#include "su_trace.h"
+#include "unity.h"
+
+#include <string.h>
+
+static uint32_t g_sim_cycles;
+static size_t   g_serial_free;
+static char     g_serial_out[1024];
+static size_t   g_serial_len;
+
+uint32_t ha_timer_get_cycles_stub(int cmock_num_calls)
+{
+    return g_sim_cycles;
+}
+
+size_t serial_ifc_get_free_stub(int cmock_num_calls)
+{
+    return g_serial_free;
+}
+
+void serial_ifc_send_stub(const uint8_t* ppt_data, size_t p_len, int cmock_num_calls)
+{
+    TEST_ASSERT_TRUE(p_len <= g_serial_free);
+    memcpy(&g_serial_out[g_serial_len], ppt_data, p_len);
+    g_serial_len                += p_len;
+    g_serial_out[g_serial_len]   = '\0';
+    g_serial_free               -= p_len;
+}
+
+void setUp(void)
+{
+    g_sim_cycles  = 0U;
+    g_serial_free = 512U;
+    g_serial_len  = 0U;
+    memset(g_serial_out, 0, sizeof(g_serial_out));
+
+    ha_timer_init_IgnoreAndReturn(RET_OK);
+    ha_timer_get_cycles_StubWithCallback(ha_timer_get_cycles_stub);
+    serial_ifc_get_free_StubWithCallback(serial_ifc_get_free_stub);
+    serial_ifc_send_StubWithCallback(serial_ifc_send_stub);
+
+    su_trace_resume();
+    TEST_ASSERT_EQUAL(RET_OK, ps_trace_init());
+}
+
+void tearDown(void) {}
+
+void test_ps_trace_drain_without_snapshot_should_send_nothing(void)
+{
+    SU_TRACE(SU_TRACE_TASK_START, 1U);
+
+    TEST_ASSERT_EQUAL(0U, ps_trace_drain());
+    TEST_ASSERT_EQUAL(0U, g_serial_len);
+}
+
+void test_ps_trace_drain_should_send_a_framed_hex_dump(void)
+{
+    g_sim_cycles = 0x01020304U;
+    SU_TRACE(SU_TRACE_IIC_START, 0x76U);
+    for (uint32_t i = 0U; i < 4U; i++)
+    {
+        SU_TRACE(SU_TRACE_TASK_START, i);
+    }
+
+    TEST_ASSERT_EQUAL(RET_OK, ps_trace_snapshot());
+    TEST_ASSERT_EQUAL(5U, ps_trace_drain());
+
+    /// cycles, arg, type and lap of each record in little endian
+    TEST_ASSERT_EQUAL_STRING("#TS 80\n"
+                             "#T 0403020176000701"
+                             "0403020100000901"
+                             "0403020101000901"
+                             "0403020102000901\n"
+                             "#T 0403020103000901\n"
+                             "#TE\n",
+                             g_serial_out);
+
+    /// The recording restarted after the end line
+    TEST_ASSERT_FALSE(su_trace_is_frozen());
+}
+
+void test_ps_trace_drain_should_wait_for_room_in_the_serial_buffer(void)
+{
+    SU_TRACE(SU_TRACE_TASK_START, 0U);
+    TEST_ASSERT_EQUAL(RET_OK, ps_trace_snapshot());
+
+    g_serial_free = 40U;
+    TEST_ASSERT_EQUAL(0U, ps_trace_drain());
+    TEST_ASSERT_EQUAL(0U, g_serial_len);
+    TEST_ASSERT_EQUAL(RET_BUSY, ps_trace_snapshot());
+
+    g_serial_free = 512U;
+    TEST_ASSERT_EQUAL(1U, ps_trace_drain());
+    TEST_ASSERT_EQUAL_STRING("#TS 80\n#T 0000000000000901\n#TE\n", g_serial_out);
+    TEST_ASSERT_EQUAL(RET_OK, ps_trace_snapshot());
+}
+
+#endif // TEST
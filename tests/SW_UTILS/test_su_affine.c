@@ -0,0 +1,261 @@
+#ifdef TEST
+
+#include "bench_clock.h"
+#include "su_affine.h"
+#include "unity.h"
+
+#include <math.h>
+#include <stdio.h>
+
+#define BENCH_SAMPLES (20000U)
+#define BENCH_RUNS    (5U)
+#define GRAVITY       (9.806F)
+
+/// The IMU chain: accelerometer calibration and a mounting rotation
+static const float g_acc_a[3][3] = {
+    {  1.190553391091500F,  0.017123734237795F,  0.007837760042511F },
+    {  0.001996992431559F,  1.196668563340221F, -0.000775887418440F },
+    { -0.064525734014990F, -0.017518888406769F,  1.193724153187501F }
+};
+static const float g_acc_b[3]    = { 0.063981206956114F, 0.106560263265376F, -0.338901066521774F };
+static const int   g_mount[3][3] = { { 0, -1, 0 }, { -1, 0, 0 }, { 0, 0, 1 } };
+
+static float g_samples[BENCH_SAMPLES][3][3];
+
+static float rand_unit(uint32_t* ppt_seed)
+{
+    *ppt_seed = (*ppt_seed * 1103515245U) + 12345U;
+    return ((float)((*ppt_seed >> 8) & 0xFFFFU) / 32768.0F) - 1.0F;
+}
+
+/// Per sample steps before the fused transform: scale, calibrate, then mount per element
+static void ref_chain(float* ppt_acc, float* ppt_gyro, float* ppt_mag)
+{
+    float* vecs[3] = { ppt_acc, ppt_gyro, ppt_mag };
+    float  cal[3]  = { 0.0F };
+
+    for (int i = 0; i < 3; i++)
+    {
+        ppt_acc[i] *= GRAVITY;
+    }
+    for (int i = 0; i < 3; i++)
+    {
+        cal[i] = 0.0F;
+        for (int j = 0; j < 3; j++)
+        {
+            cal[i] += g_acc_a[i][j] * (ppt_acc[j] - g_acc_b[j]);
+        }
+    }
+    for (int i = 0; i < 3; i++)
+    {
+        ppt_acc[i] = cal[i];
+    }
+    for (int s = 0; s < 3; s++)
+    {
+        float tmp[3] = { 0.0F };
+
+        for (int i = 0; i < 3; i++)
+        {
+            for (int j = 0; j < 3; j++)
+            {
+                tmp[i] += (float)(g_mount[i][j]) * vecs[s][j];
+            }
+        }
+        for (int i = 0; i < 3; i++)
+        {
+            vecs[s][i] = tmp[i];
+        }
+    }
+}
+
+/// Folds the same chain into one transform per sensor, the mag is only mounted here
+static void build_fused(su_affine3_t* ppt_xfs)
+{
+    float        mount_m[3][3];
+    float        scale_m[3][3] = { { GRAVITY, 0.0F, 0.0F },
+                                   { 0.0F, GRAVITY, 0.0F },
+                                   { 0.0F, 0.0F, GRAVITY } };
+    float        off[3]        = { -g_acc_b[0], -g_acc_b[1], -g_acc_b[2] };
+    su_affine3_t mount;
+    su_affine3_t step;
+
+    for (int i = 0; i < 3; i++)
+    {
+        for (int j = 0; j < 3; j++)
+        {
+            mount_m[i][j] = (float)g_mount[i][j];
+        }
+    }
+    su_affine3_init(&mount, mount_m, NULL);
+
+    su_affine3_init(&ppt_xfs[0], scale_m, off);
+    su_affine3_init(&step, g_acc_a, NULL);
+    su_affine3_compose(&ppt_xfs[0], &step, &ppt_xfs[0]);
+    su_affine3_compose(&ppt_xfs[0], &mount, &ppt_xfs[0]);
+    ppt_xfs[1] = mount;
+    ppt_xfs[2] = mount;
+}
+
+static void fill_samples(void)
+{
+    uint32_t seed = 777U;
+
+    for (uint32_t n = 0U; n < BENCH_SAMPLES; n++)
+    {
+        for (uint32_t s = 0U; s < 3U; s++)
+        {
+            for (uint32_t i = 0U; i < 3U; i++)
+            {
+                g_samples[n][s][i] = rand_unit(&seed) * ((s == 2U) ? 300.0F : 2.0F);
+            }
+        }
+    }
+}
+
+void setUp(void) {}
+
+void tearDown(void) {}
+
+void test_su_affine3_init_without_matrix_should_be_the_identity(void)
+{
+    su_affine3_t xf;
+    float        b[3]   = { 1.0F, -2.0F, 3.0F };
+    float        vec[3] = { 4.0F, 5.0F, 6.0F };
+
+    su_affine3_init(&xf, NULL, b);
+    su_affine3_apply(&xf, vec, vec);
+
+    TEST_ASSERT_EQUAL_FLOAT(5.0F, vec[0]);
+    TEST_ASSERT_EQUAL_FLOAT(3.0F, vec[1]);
+    TEST_ASSERT_EQUAL_FLOAT(9.0F, vec[2]);
+}
+
+void test_su_affine3_compose_should_equal_applying_both_in_order(void)
+{
+    uint32_t     seed = 99U;
+    float        m[2][3][3];
+    float        b[2][3];
+    su_affine3_t inner;
+    su_affine3_t outer;
+    su_affine3_t fused;
+
+    for (int t = 0; t < 2; t++)
+    {
+        for (int i = 0; i < 3; i++)
+        {
+            for (int j = 0; j < 3; j++)
+            {
+                m[t][i][j] = rand_unit(&seed);
+            }
+            b[t][i] = 10.0F * rand_unit(&seed);
+        }
+    }
+    su_affine3_init(&inner, m[0], b[0]);
+    su_affine3_init(&outer, m[1], b[1]);
+    su_affine3_compose(&fused, &outer, &inner);
+
+    for (int n = 0; n < 100; n++)
+    {
+        float x[3] = { rand_unit(&seed), rand_unit(&seed), rand_unit(&seed) };
+        float seq[3];
+        float one[3];
+
+        su_affine3_apply(&inner, x, seq);
+        su_affine3_apply(&outer, seq, seq);
+        su_affine3_apply(&fused, x, one);
+        for (int i = 0; i < 3; i++)
+        {
+            TEST_ASSERT_FLOAT_WITHIN(1e-4F, seq[i], one[i]);
+        }
+    }
+}
+
+void test_su_affine3_fused_imu_chain_should_match_the_step_by_step_chain(void)
+{
+    su_affine3_t xfs[3];
+    float        max_err[3] = { 0.0F };
+
+    fill_samples();
+    build_fused(xfs);
+
+    for (uint32_t n = 0U; n < BENCH_SAMPLES; n++)
+    {
+        float ref[3][3];
+        float out[3][3];
+
+        for (uint32_t s = 0U; s < 3U; s++)
+        {
+            for (uint32_t i = 0U; i < 3U; i++)
+            {
+                ref[s][i] = g_samples[n][s][i];
+                out[s][i] = g_samples[n][s][i];
+            }
+        }
+        ref_chain(ref[0], ref[1], ref[2]);
+        su_affine3_apply_batch(xfs, (float* const[]) { out[0], out[1], out[2] }, 3U);
+
+        for (uint32_t s = 0U; s < 3U; s++)
+        {
+            for (uint32_t i = 0U; i < 3U; i++)
+            {
+                float err = fabsf(out[s][i] - ref[s][i]) / (1.0F + fabsf(ref[s][i]));
+
+                max_err[s] = (err > max_err[s]) ? err : max_err[s];
+            }
+        }
+    }
+
+    /// Float rounding only, the mounting permutes and flips exactly
+    TEST_ASSERT_TRUE(max_err[0] < 1e-5F);
+    TEST_ASSERT_EQUAL_FLOAT(0.0F, max_err[1]);
+    TEST_ASSERT_EQUAL_FLOAT(0.0F, max_err[2]);
+}
+
+void test_su_affine3_bench_host_ns_per_sample(void)
+{
+    su_affine3_t xfs[3];
+    uint64_t     best_ref   = UINT64_MAX;
+    uint64_t     best_fused = UINT64_MAX;
+    volatile float sink     = 0.0F;
+    char         msg[128];
+
+    fill_samples();
+    build_fused(xfs);
+
+    for (uint32_t run = 0U; run < BENCH_RUNS; run++)
+    {
+        uint64_t t0 = host_now_ns();
+
+        for (uint32_t n = 0U; n < BENCH_SAMPLES; n++)
+        {
+            ref_chain(g_samples[n][0], g_samples[n][1], g_samples[n][2]);
+        }
+        t0       = host_now_ns() - t0;
+        best_ref = (t0 < best_ref) ? t0 : best_ref;
+
+        t0 = host_now_ns();
+        for (uint32_t n = 0U; n < BENCH_SAMPLES; n++)
+        {
+            su_affine3_apply_batch(xfs,
+                                   (float* const[]) { g_samples[n][0],
+                                                      g_samples[n][1],
+                                                      g_samples[n][2] },
+                                   3U);
+        }
+        t0         = host_now_ns() - t0;
+        best_fused = (t0 < best_fused) ? t0 : best_fused;
+        sink      += g_samples[run][0][0];
+        fill_samples(); // Keep the values bounded
+    }
+    (void)sink;
+
+    snprintf(msg,
+             sizeof(msg),
+             "3 sensors/sample on the host: step by step %.1f ns, fused %.1f ns",
+             host_ns_per_op(best_ref, BENCH_SAMPLES),
+             host_ns_per_op(best_fused, BENCH_SAMPLES));
+    /// Printed only, host timing is noisy and does not tell the cycles of the M4
+    TEST_MESSAGE(msg);
+}
+
+#endif // TEST
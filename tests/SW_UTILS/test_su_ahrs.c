@@ -0,0 +1,372 @@
+#ifdef TEST
+
+#include "bench_clock.h"
+#include "su_ahrs.h"
+#include "unity.h"
+
+#include <math.h>
+#include <stdio.h>
+
+#define RATE_HZ        (50U)
+#define REC_S          (60U)
+#define REC_CNT        (RATE_HZ * REC_S)
+#define SETTLE_CNT     (RATE_HZ * 20U)
+#define TRUTH_SUBSTEPS (20U)
+#define GRAVITY        (9.806)
+#define DEG            (57.29577951308232)
+#define BENCH_RUNS     (5U)
+
+/// One recorded IMU sample, the truth is kept for the comparison
+typedef struct
+{
+    float  gyro[3]; // rad/s
+    float  acc[3];  // m/s2
+    float  mag[3];  // uT
+    double q[4];    // true attitude
+} rec_sample_t;
+
+/// Double precision reference of the same filter
+typedef struct
+{
+    double q[4];
+    double bias_fb[3];
+    double kp;
+    double ki;
+} ref_ahrs_t;
+
+static rec_sample_t g_rec[REC_CNT];
+static uint32_t     g_seed;
+
+static double noise(double p_sigma)
+{
+    double sum = 0.0;
+
+    // Sum of uniforms, close enough to a normal distribution
+    for (int i = 0; i < 12; i++)
+    {
+        g_seed = (g_seed * 1103515245U) + 12345U;
+        sum   += (double)((g_seed >> 8) & 0xFFFFU) / 65536.0;
+    }
+    return (sum - 6.0) * p_sigma;
+}
+
+static void quat_normalize(double* ppt_q)
+{
+    double n = sqrt((ppt_q[0] * ppt_q[0]) + (ppt_q[1] * ppt_q[1]) + (ppt_q[2] * ppt_q[2])
+                    + (ppt_q[3] * ppt_q[3]));
+
+    for (int i = 0; i < 4; i++)
+    {
+        ppt_q[i] /= n;
+    }
+}
+
+static void quat_integrate(double* ppt_q, const double* ppt_w, double p_dt)
+{
+    double qa[4] = { ppt_q[0], ppt_q[1], ppt_q[2], ppt_q[3] };
+    double g[3]  = { 0.5 * ppt_w[0] * p_dt, 0.5 * ppt_w[1] * p_dt, 0.5 * ppt_w[2] * p_dt };
+
+    ppt_q[0] += (-qa[1] * g[0]) - (qa[2] * g[1]) - (qa[3] * g[2]);
+    ppt_q[1] += (qa[0] * g[0]) + (qa[2] * g[2]) - (qa[3] * g[1]);
+    ppt_q[2] += (qa[0] * g[1]) - (qa[1] * g[2]) + (qa[3] * g[0]);
+    ppt_q[3] += (qa[0] * g[2]) + (qa[1] * g[1]) - (qa[2] * g[0]);
+    quat_normalize(ppt_q);
+}
+
+/// Earth vector seen in the body frame
+static void earth_to_body(const double* ppt_q, const double* ppt_e, double* ppt_b)
+{
+    double w = ppt_q[0];
+    double x = ppt_q[1];
+    double y = ppt_q[2];
+    double z = ppt_q[3];
+
+    ppt_b[0] = ((1.0 - (2.0 * ((y * y) + (z * z)))) * ppt_e[0])
+               + (2.0 * ((x * y) + (w * z)) * ppt_e[1]) + (2.0 * ((x * z) - (w * y)) * ppt_e[2]);
+    ppt_b[1] = (2.0 * ((x * y) - (w * z)) * ppt_e[0])
+               + ((1.0 - (2.0 * ((x * x) + (z * z)))) * ppt_e[1])
+               + (2.0 * ((y * z) + (w * x)) * ppt_e[2]);
+    ppt_b[2] = (2.0 * ((x * z) + (w * y)) * ppt_e[0]) + (2.0 * ((y * z) - (w * x)) * ppt_e[1])
+               + ((1.0 - (2.0 * ((x * x) + (y * y)))) * ppt_e[2]);
+}
+
+/**
+ * @brief Records a minute of a vehicle swaying and turning: gyro with bias
+ * and noise, accelerometer and magnetometer with noise, at the gyro rate.
+ */
+static void record(const double* ppt_q0)
+{
+    const double bias[3]  = { 0.010, -0.008, 0.005 };
+    const double field[3] = { 20.0, 0.0, -45.0 }; // North and down, in uT
+    const double up[3]    = { 0.0, 0.0, GRAVITY };
+    double       q[4]     = { ppt_q0[0], ppt_q0[1], ppt_q0[2], ppt_q0[3] };
+    double       dt       = 1.0 / RATE_HZ;
+
+    g_seed = 2024U;
+    for (uint32_t n = 0U; n < REC_CNT; n++)
+    {
+        double t = n * dt;
+        double w[3];
+        double acc[3];
+        double mag[3];
+
+        w[0] = 0.6 * sin(0.7 * t);
+        w[1] = 0.4 * sin((0.5 * t) + 1.0);
+        w[2] = 0.3 * cos(0.3 * t);
+        for (uint32_t s = 0U; s < TRUTH_SUBSTEPS; s++)
+        {
+            quat_integrate(q, w, dt / TRUTH_SUBSTEPS);
+        }
+        earth_to_body(q, up, acc);
+        earth_to_body(q, field, mag);
+        for (int i = 0; i < 3; i++)
+        {
+            g_rec[n].gyro[i] = (float)(w[i] + bias[i] + noise(0.005));
+            g_rec[n].acc[i]  = (float)(acc[i] + noise(0.05));
+            g_rec[n].mag[i]  = (float)(mag[i] + noise(0.3));
+        }
+        for (int i = 0; i < 4; i++)
+        {
+            g_rec[n].q[i] = q[i];
+        }
+    }
+}
+
+static void ref_update(ref_ahrs_t* ppt_ahrs, const float* ppt_g, const float* ppt_a,
+                       const float* ppt_m, double p_dt)
+{
+    double* q = ppt_ahrs->q;
+    double  g[3];
+    double  a[3];
+    double  m[3];
+    double  na = sqrt((ppt_a[0] * (double)ppt_a[0]) + (ppt_a[1] * (double)ppt_a[1])
+                      + (ppt_a[2] * (double)ppt_a[2]));
+    double  nm = sqrt((ppt_m[0] * (double)ppt_m[0]) + (ppt_m[1] * (double)ppt_m[1])
+                      + (ppt_m[2] * (double)ppt_m[2]));
+
+    for (int i = 0; i < 3; i++)
+    {
+        g[i] = ppt_g[i];
+        a[i] = ppt_a[i] / na;
+        m[i] = ppt_m[i] / nm;
+    }
+
+    double q0q0 = q[0] * q[0], q0q1 = q[0] * q[1], q0q2 = q[0] * q[2], q0q3 = q[0] * q[3];
+    double q1q1 = q[1] * q[1], q1q2 = q[1] * q[2], q1q3 = q[1] * q[3];
+    double q2q2 = q[2] * q[2], q2q3 = q[2] * q[3], q3q3 = q[3] * q[3];
+    double hx   = 2.0 * ((m[0] * (0.5 - q2q2 - q3q3)) + (m[1] * (q1q2 - q0q3))
+                       + (m[2] * (q1q3 + q0q2)));
+    double hy   = 2.0 * ((m[0] * (q1q2 + q0q3)) + (m[1] * (0.5 - q1q1 - q3q3))
+                       + (m[2] * (q2q3 - q0q1)));
+    double bx   = sqrt((hx * hx) + (hy * hy));
+    double bz   = 2.0 * ((m[0] * (q1q3 - q0q2)) + (m[1] * (q2q3 + q0q1))
+                       + (m[2] * (0.5 - q1q1 - q2q2)));
+    double v[3] = { q1q3 - q0q2, q0q1 + q2q3, q0q0 - 0.5 + q3q3 };
+    double w[3] = { (bx * (0.5 - q2q2 - q3q3)) + (bz * (q1q3 - q0q2)),
+                    (bx * (q1q2 - q0q3)) + (bz * (q0q1 + q2q3)),
+                    (bx * (q0q2 + q1q3)) + (bz * (0.5 - q1q1 - q2q2)) };
+    double e[3] = { ((a[1] * v[2]) - (a[2] * v[1])) + ((m[1] * w[2]) - (m[2] * w[1])),
+                    ((a[2] * v[0]) - (a[0] * v[2])) + ((m[2] * w[0]) - (m[0] * w[2])),
+                    ((a[0] * v[1]) - (a[1] * v[0])) + ((m[0] * w[1]) - (m[1] * w[0])) };
+
+    for (int i = 0; i < 3; i++)
+    {
+        ppt_ahrs->bias_fb[i] += 2.0 * ppt_ahrs->ki * e[i] * p_dt;
+        g[i]                 += ppt_ahrs->bias_fb[i] + (2.0 * ppt_ahrs->kp * e[i]);
+    }
+    quat_integrate(q, g, p_dt);
+}
+
+/// Angle between two attitudes in degrees, exact for quaternions slightly off the unit norm
+static double quat_angle_deg(const double* ppt_a, const double* ppt_b)
+{
+    double w = (ppt_a[0] * ppt_b[0]) + (ppt_a[1] * ppt_b[1]) + (ppt_a[2] * ppt_b[2])
+               + (ppt_a[3] * ppt_b[3]);
+    double x = (ppt_a[0] * ppt_b[1]) - (ppt_a[1] * ppt_b[0]) - (ppt_a[2] * ppt_b[3])
+               + (ppt_a[3] * ppt_b[2]);
+    double y = (ppt_a[0] * ppt_b[2]) + (ppt_a[1] * ppt_b[3]) - (ppt_a[2] * ppt_b[0])
+               - (ppt_a[3] * ppt_b[1]);
+    double z = (ppt_a[0] * ppt_b[3]) - (ppt_a[1] * ppt_b[2]) + (ppt_a[2] * ppt_b[1])
+               - (ppt_a[3] * ppt_b[0]);
+
+    return 2.0 * atan2(sqrt((x * x) + (y * y) + (z * z)), fabs(w)) * DEG;
+}
+
+static double quat_angle_deg_f(const float* ppt_a, const double* ppt_b)
+{
+    double a[4] = { ppt_a[0], ppt_a[1], ppt_a[2], ppt_a[3] };
+
+    return quat_angle_deg(a, ppt_b);
+}
+
+void setUp(void)
+{
+    const double level[4] = { 1.0, 0.0, 0.0, 0.0 };
+
+    record(level);
+}
+
+void tearDown(void) {}
+
+void test_su_ahrs_inv_sqrt_should_be_accurate_over_the_range(void)
+{
+    for (float x = 1e-6F; x < 1e6F; x *= 1.37F)
+    {
+        float rel = fabsf((su_ahrs_inv_sqrt(x) * sqrtf(x)) - 1.0F);
+
+        TEST_ASSERT_TRUE(rel < 5e-6F);
+    }
+}
+
+void test_su_ahrs_euler_should_follow_the_yaw_pitch_roll_order(void)
+{
+    su_ahrs_t       ahrs;
+    su_ahrs_euler_t euler;
+    const double    r = 0.3 / 2.0; // Half angles
+    const double    p = -0.2 / 2.0;
+    const double    y = 1.0 / 2.0;
+
+    su_ahrs_init(&ahrs, NULL);
+    ahrs.q[0] = (float)((cos(r) * cos(p) * cos(y)) + (sin(r) * sin(p) * sin(y)));
+    ahrs.q[1] = (float)((sin(r) * cos(p) * cos(y)) - (cos(r) * sin(p) * sin(y)));
+    ahrs.q[2] = (float)((cos(r) * sin(p) * cos(y)) + (sin(r) * cos(p) * sin(y)));
+    ahrs.q[3] = (float)((cos(r) * cos(p) * sin(y)) - (sin(r) * sin(p) * cos(y)));
+    su_ahrs_get_euler(&ahrs, &euler);
+
+    TEST_ASSERT_FLOAT_WITHIN(1e-5F, 0.3F, euler.roll);
+    TEST_ASSERT_FLOAT_WITHIN(1e-5F, -0.2F, euler.pitch);
+    TEST_ASSERT_FLOAT_WITHIN(1e-5F, 1.0F, euler.yaw);
+}
+
+void test_su_ahrs_earth_z_should_undo_the_attitude(void)
+{
+    const double up[3]    = { 0.0, 0.0, GRAVITY };
+    const double north[3] = { 1.0, 0.0, 0.0 };
+    su_ahrs_t    ahrs;
+    double       q[4]     = { 0.8, 0.3, -0.4, 0.2 };
+    double       b_up[3];
+    double       b_north[3];
+
+    su_ahrs_init(&ahrs, NULL);
+    quat_normalize(q);
+    for (int i = 0; i < 4; i++)
+    {
+        ahrs.q[i] = (float)q[i];
+    }
+    earth_to_body(q, up, b_up);
+    earth_to_body(q, north, b_north);
+
+    const float v_up[3]    = { (float)b_up[0], (float)b_up[1], (float)b_up[2] };
+    const float v_north[3] = { (float)b_north[0], (float)b_north[1], (float)b_north[2] };
+
+    TEST_ASSERT_FLOAT_WITHIN(1e-5F, (float)GRAVITY, su_ahrs_earth_z(&ahrs, v_up));
+    TEST_ASSERT_FLOAT_WITHIN(1e-6F, 0.0F, su_ahrs_earth_z(&ahrs, v_north));
+}
+
+void test_su_ahrs_gain_should_pull_a_wrong_start_to_the_measurement(void)
+{
+    const double  tilted[4] = { cos(0.2), sin(0.2), 0.0, 0.0 }; // 23 deg of roll
+    su_ahrs_cfg_t gyro_only = { .kp = 0.0F, .ki = 0.0F };
+    su_ahrs_t     open;
+    su_ahrs_t     closed;
+
+    record(tilted);
+    su_ahrs_init(&open, &gyro_only);
+    su_ahrs_init(&closed, NULL);
+    for (uint32_t n = 0U; n < SETTLE_CNT; n++)
+    {
+        su_ahrs_update(&open, g_rec[n].gyro, g_rec[n].acc, g_rec[n].mag, 1.0F / RATE_HZ);
+        su_ahrs_update(&closed, g_rec[n].gyro, g_rec[n].acc, g_rec[n].mag, 1.0F / RATE_HZ);
+    }
+
+    TEST_ASSERT_TRUE(quat_angle_deg_f(open.q, g_rec[SETTLE_CNT - 1U].q) > 10.0);
+    TEST_ASSERT_TRUE(quat_angle_deg_f(closed.q, g_rec[SETTLE_CNT - 1U].q) < 5.0);
+}
+
+void test_su_ahrs_replay_should_match_the_double_precision_reference(void)
+{
+    su_ahrs_t  ahrs;
+    ref_ahrs_t ref       = { .q = { 1.0, 0.0, 0.0, 0.0 },
+                             .kp = SU_AHRS_DEFAULT_KP,
+                             .ki = SU_AHRS_DEFAULT_KI };
+    double     max_err   = 0.0;
+    double     max_ref   = 0.0;
+    double     max_delta = 0.0;
+    char       msg[128];
+
+    su_ahrs_init(&ahrs, NULL);
+    for (uint32_t n = 0U; n < REC_CNT; n++)
+    {
+        su_ahrs_update(&ahrs, g_rec[n].gyro, g_rec[n].acc, g_rec[n].mag, 1.0F / RATE_HZ);
+        ref_update(&ref, g_rec[n].gyro, g_rec[n].acc, g_rec[n].mag, 1.0 / RATE_HZ);
+
+        if (n >= SETTLE_CNT)
+        {
+            double err   = quat_angle_deg_f(ahrs.q, g_rec[n].q);
+            double err_r = quat_angle_deg(ref.q, g_rec[n].q);
+            double delta = quat_angle_deg_f(ahrs.q, ref.q);
+
+            max_err   = (err > max_err) ? err : max_err;
+            max_ref   = (err_r > max_ref) ? err_r : max_ref;
+            max_delta = (delta > max_delta) ? delta : max_delta;
+        }
+    }
+
+    snprintf(msg,
+             sizeof(msg),
+             "max error to truth: float %.3f deg, double %.3f deg, float to double %.4f deg",
+             max_err,
+             max_ref,
+             max_delta);
+    TEST_MESSAGE(msg);
+
+    TEST_ASSERT_TRUE(max_err < 4.0);
+    TEST_ASSERT_TRUE(max_delta < 0.01);
+    TEST_ASSERT_FLOAT_WITHIN(1e-5F,
+                             1.0F,
+                             (ahrs.q[0] * ahrs.q[0]) + (ahrs.q[1] * ahrs.q[1])
+                               + (ahrs.q[2] * ahrs.q[2]) + (ahrs.q[3] * ahrs.q[3]));
+}
+
+void test_su_ahrs_bench_host_ns_per_update(void)
+{
+    uint64_t best_f = UINT64_MAX;
+    uint64_t best_d = UINT64_MAX;
+    char     msg[128];
+
+    for (uint32_t run = 0U; run < BENCH_RUNS; run++)
+    {
+        su_ahrs_t  ahrs;
+        ref_ahrs_t ref = { .q = { 1.0, 0.0, 0.0, 0.0 },
+                           .kp = SU_AHRS_DEFAULT_KP,
+                           .ki = SU_AHRS_DEFAULT_KI };
+        uint64_t   t0  = 0U;
+
+        su_ahrs_init(&ahrs, NULL);
+        t0 = host_now_ns();
+        for (uint32_t n = 0U; n < REC_CNT; n++)
+        {
+            su_ahrs_update(&ahrs, g_rec[n].gyro, g_rec[n].acc, g_rec[n].mag, 1.0F / RATE_HZ);
+        }
+        t0     = host_now_ns() - t0;
+        best_f = (t0 < best_f) ? t0 : best_f;
+
+        t0 = host_now_ns();
+        for (uint32_t n = 0U; n < REC_CNT; n++)
+        {
+            ref_update(&ref, g_rec[n].gyro, g_rec[n].acc, g_rec[n].mag, 1.0 / RATE_HZ);
+        }
+        t0     = host_now_ns() - t0;
+        best_d = (t0 < best_d) ? t0 : best_d;
+        TEST_ASSERT_TRUE(ref.q[0] == ref.q[0]); // Keeps the reference from being optimized out
+    }
+
+    snprintf(msg,
+             sizeof(msg),
+             "per update on the host: float %.1f ns, double reference %.1f ns",
+             host_ns_per_op(best_f, REC_CNT),
+             host_ns_per_op(best_d, REC_CNT));
+    TEST_MESSAGE(msg);
+}
+
+#endif // TEST
@@ -0,0 +1,198 @@
+#ifdef TEST
+
+#include "bench_clock.h"
+#include "dd_bmp388_defs.h"
+#include "su_baro.h"
+#include "unity.h"
+
+#include <math.h>
+#include <stdio.h>
+
+#define RATE_HZ       (50U)
+#define DT_S          (1.0F / (float)RATE_HZ)
+#define RUN_CNT       (RATE_HZ * 120U)
+#define SETTLE_CNT    (RATE_HZ * 20U)
+#define TWO_PI        (6.283185307179586)
+#define BENCH_SAMPLES (20000U)
+#define BENCH_RUNS    (5U)
+
+static uint32_t g_seed;
+
+/// The standard atmosphere, as the host model of the BMP388
+static double ref_altitude(double p_pa)
+{
+    return 44330.77 * (1.0 - pow(p_pa / 101325.0, 0.190263));
+}
+
+static double ref_pressure(double p_alt_m)
+{
+    return 101325.0 * pow(1.0 - (2.25577e-5 * p_alt_m), 5.25588);
+}
+
+static double rand_gauss(void)
+{
+    double u[2];
+
+    for (int i = 0; i < 2; i++)
+    {
+        g_seed = (g_seed * 1103515245U) + 12345U;
+        u[i]   = ((double)((g_seed >> 8) & 0xFFFFFFU) + 1.0) / 16777217.0;
+    }
+    return sqrt(-2.0 * log(u[0])) * cos(TWO_PI * u[1]);
+}
+
+void setUp(void)
+{
+    g_seed = 1234U;
+}
+
+void tearDown(void) {}
+
+void test_su_baro_pressure_altitude_should_match_the_formula_over_the_sensor_range(void)
+{
+    double max_err = 0.0;
+
+    TEST_ASSERT_EQUAL_FLOAT(BMP388_MIN_PRES, SU_BARO_MIN_PA);
+    TEST_ASSERT_EQUAL_FLOAT(BMP388_MAX_PRES, SU_BARO_MAX_PA);
+
+    for (float pa = BMP388_MIN_PRES; pa <= BMP388_MAX_PRES; pa += 0.25F)
+    {
+        double err = fabs(su_baro_pressure_altitude(pa) - ref_altitude(pa));
+
+        max_err = (err > max_err) ? err : max_err;
+    }
+    TEST_ASSERT_TRUE(max_err < 0.02);
+
+    /// Out of the range, clamped
+    TEST_ASSERT_EQUAL_FLOAT(su_baro_pressure_altitude(BMP388_MIN_PRES),
+                            su_baro_pressure_altitude(1000.0F));
+    TEST_ASSERT_EQUAL_FLOAT(su_baro_pressure_altitude(BMP388_MAX_PRES),
+                            su_baro_pressure_altitude(2.0e5F));
+    TEST_ASSERT_EQUAL_FLOAT(su_baro_pressure_altitude(BMP388_MIN_PRES),
+                            su_baro_pressure_altitude(NAN));
+}
+
+void test_su_baro_altitude_should_be_relative_to_the_ground(void)
+{
+    su_baro_t baro;
+
+    su_baro_init(&baro, NULL);
+    su_baro_set_ground(&baro, (float)ref_pressure(1500.0));
+
+    /// At rest 30 m above the ground, the filter settles on the barometer
+    for (uint32_t n = 0U; n < RUN_CNT; n++)
+    {
+        su_baro_update(&baro, (float)ref_pressure(1530.0), 0.0F, DT_S);
+    }
+    TEST_ASSERT_FLOAT_WITHIN(0.02F, 30.0F, baro.alt_m);
+    TEST_ASSERT_FLOAT_WITHIN(0.01F, 0.0F, baro.vs_mps);
+
+    /// Without a reference the first sample is the ground
+    su_baro_init(&baro, NULL);
+    su_baro_update(&baro, 90000.0F, 0.0F, DT_S);
+    TEST_ASSERT_EQUAL_FLOAT(0.0F, baro.alt_m);
+}
+
+void test_su_baro_vertical_speed_should_follow_a_climb_and_learn_the_acc_bias(void)
+{
+    const double acc_bias = 0.3;
+    su_baro_t    baro;
+    double       sq_vs   = 0.0;
+    double       sq_diff = 0.0;
+    double       sq_alt  = 0.0;
+    float        prev_m  = 0.0F;
+
+    su_baro_init(&baro, NULL);
+    su_baro_set_ground(&baro, (float)ref_pressure(200.0));
+
+    /// Up and down by 10 m every 20 s, the barometer is noisy and the accelerometer biased
+    for (uint32_t n = 0U; n < RUN_CNT; n++)
+    {
+        const double t      = (double)n / RATE_HZ;
+        const double w      = TWO_PI / 20.0;
+        const double alt    = 10.0 * (1.0 - cos(w * t));
+        const double vs     = 10.0 * w * sin(w * t);
+        const double acc    = 10.0 * w * w * cos(w * t);
+        const float  baro_m = (float)(alt + (0.3 * rand_gauss()));
+
+        su_baro_update(&baro,
+                       (float)ref_pressure(200.0 + baro_m),
+                       (float)(acc + acc_bias + (0.1 * rand_gauss())),
+                       DT_S);
+
+        if (n >= SETTLE_CNT)
+        {
+            /// The speed differentiated from the barometer alone, for the comparison
+            const double diff = (baro_m - prev_m) / DT_S;
+
+            sq_vs   += (baro.vs_mps - vs) * (baro.vs_mps - vs);
+            sq_diff += (diff - vs) * (diff - vs);
+            sq_alt  += (baro.alt_m - alt) * (baro.alt_m - alt);
+        }
+        prev_m = baro_m;
+    }
+
+    const double cnt = (double)(RUN_CNT - SETTLE_CNT);
+
+    TEST_ASSERT_TRUE(sqrt(sq_vs / cnt) < 0.2);
+    TEST_ASSERT_TRUE(sqrt(sq_vs / cnt) < (0.1 * sqrt(sq_diff / cnt)));
+    TEST_ASSERT_TRUE(sqrt(sq_alt / cnt) < 0.3);
+    TEST_ASSERT_FLOAT_WITHIN(0.05F, (float)-acc_bias, baro.acc_corr);
+}
+
+void test_su_baro_bench_host_ns_per_sample(void)
+{
+    static float pa[BENCH_SAMPLES];
+    uint64_t     best_pow  = UINT64_MAX;
+    uint64_t     best_lut  = UINT64_MAX;
+    uint64_t     best_step = UINT64_MAX;
+    su_baro_t    baro;
+    float        sum       = 0.0F;
+    char         msg[160];
+
+    for (uint32_t n = 0U; n < BENCH_SAMPLES; n++)
+    {
+        pa[n] = (float)ref_pressure(500.0 + (2.0 * rand_gauss()));
+    }
+    su_baro_init(&baro, NULL);
+
+    for (uint32_t run = 0U; run < BENCH_RUNS; run++)
+    {
+        uint64_t t0 = host_now_ns();
+
+        for (uint32_t n = 0U; n < BENCH_SAMPLES; n++)
+        {
+            sum += 44330.77F * (1.0F - powf(pa[n] * (1.0F / 101325.0F), 0.190263F));
+        }
+        t0       = host_now_ns() - t0;
+        best_pow = (t0 < best_pow) ? t0 : best_pow;
+
+        t0 = host_now_ns();
+        for (uint32_t n = 0U; n < BENCH_SAMPLES; n++)
+        {
+            sum += su_baro_pressure_altitude(pa[n]);
+        }
+        t0       = host_now_ns() - t0;
+        best_lut = (t0 < best_lut) ? t0 : best_lut;
+
+        t0 = host_now_ns();
+        for (uint32_t n = 0U; n < BENCH_SAMPLES; n++)
+        {
+            su_baro_update(&baro, pa[n], 0.0F, DT_S);
+        }
+        t0        = host_now_ns() - t0;
+        best_step = (t0 < best_step) ? t0 : best_step;
+    }
+    TEST_ASSERT_TRUE(sum == sum);
+
+    snprintf(msg,
+             sizeof(msg),
+             "altitude on the host: powf %.1f ns, table %.1f ns, filter step %.1f ns",
+             host_ns_per_op(best_pow, BENCH_SAMPLES),
+             host_ns_per_op(best_lut, BENCH_SAMPLES),
+             host_ns_per_op(best_step, BENCH_SAMPLES));
+    /// Printed only, the host powf() is close to a table lookup unlike the one of the M4
+    TEST_MESSAGE(msg);
+}
+
+#endif // TEST
@@ -0,0 +1,413 @@
+#ifdef TEST
+
+#include "bench_clock.h"
+#include "su_affine.h"
+#include "su_calib.h"
+#include "unity.h"
+
+#include <math.h>
+#include <stdio.h>
+
+#define RATE_HZ       (50U)
+#define RUN_CNT       (RATE_HZ * 120U)
+#define MAG_FIELD_UT  (50.0)
+/// Inclination of the earth field, about the one of central Europe
+#define MAG_INCL      (1.13)
+#define GRAVITY       (9.806)
+#define TWO_PI        (6.283185307179586)
+#define BENCH_SAMPLES (20000U)
+#define BENCH_RUNS    (5U)
+
+/// Soft iron and hard iron left by an outdated calibration
+static const double g_mag_d[3][3] = {
+    { 1.08, 0.04, -0.03 },
+    { 0.04, 0.93, 0.05 },
+    { -0.03, 0.05, 1.03 },
+};
+static const double g_mag_o[3] = { 6.0, -4.0, 9.0 };
+
+/// Scale and bias of the accelerometer axes
+static const double g_acc_d[3][3] = {
+    { 1.02, 0.0, 0.0 },
+    { 0.0, 0.97, 0.0 },
+    { 0.0, 0.0, 1.01 },
+};
+static const double g_acc_o[3] = { 0.2, -0.15, 0.3 };
+
+static uint32_t g_seed;
+
+static double rand_gauss(void)
+{
+    double u[2];
+
+    for (int i = 0; i < 2; i++)
+    {
+        g_seed = (g_seed * 1103515245U) + 12345U;
+        u[i]   = ((double)((g_seed >> 8) & 0xFFFFFFU) + 1.0) / 16777217.0;
+    }
+    return sqrt(-2.0 * log(u[0])) * cos(TWO_PI * u[1]);
+}
+
+/// A smooth path of the field in the sensor frame: one turn every 8 s, tilted up to +-p_tilt
+static void true_dir(uint32_t p_n, double p_tilt, double* ppt_dir)
+{
+    const double t     = (double)p_n / RATE_HZ;
+    const double yaw   = (TWO_PI / 8.0) * t;
+    const double theta = (TWO_PI / 4.0) + (p_tilt * sin((TWO_PI / 20.0) * t));
+
+    ppt_dir[0] = sin(theta) * cos(yaw);
+    ppt_dir[1] = sin(theta) * sin(yaw);
+    ppt_dir[2] = cos(theta);
+}
+
+/**
+ * @brief The field in the sensor frame of a car on a road: turns at a varying
+ * rate and the pitch and roll of the bumps, a few degrees.
+ */
+static void level_field(uint32_t p_n, double* ppt_field)
+{
+    const double t     = (double)p_n / RATE_HZ;
+    const double yaw   = ((TWO_PI / 25.0) * t) + (2.0 * sin((TWO_PI / 40.0) * t));
+    const double pitch = 0.04 * sin((TWO_PI / 3.0) * t);
+    const double roll  = 0.03 * sin((TWO_PI / 2.2) * t);
+    const double h     = MAG_FIELD_UT * cos(MAG_INCL);
+    const double v     = MAG_FIELD_UT * sin(MAG_INCL);
+    /// Earth to body: the yaw, then the pitch about y, then the roll about x
+    const double x0    = (h * cos(yaw));
+    const double y0    = -(h * sin(yaw));
+    const double x1    = (x0 * cos(pitch)) - (v * sin(pitch));
+    const double z1    = (x0 * sin(pitch)) + (v * cos(pitch));
+
+    ppt_field[0] = x1;
+    ppt_field[1] = (y0 * cos(roll)) + (z1 * sin(roll));
+    ppt_field[2] = -(y0 * sin(roll)) + (z1 * cos(roll));
+}
+
+static void distort(const double ppt_d[3][3], const double* ppt_o, const double* ppt_true,
+                    double p_noise, float* ppt_meas)
+{
+    for (uint32_t i = 0U; i < 3U; i++)
+    {
+        ppt_meas[i] = (float)((ppt_d[i][0] * ppt_true[0]) + (ppt_d[i][1] * ppt_true[1])
+                              + (ppt_d[i][2] * ppt_true[2]) + ppt_o[i] + (p_noise * rand_gauss()));
+    }
+}
+
+/// Largest error of the correction against the inverse of the distortion
+static double corr_err(const su_affine3_t* ppt_corr, const double ppt_d[3][3], const double* ppt_o,
+                       double p_radius)
+{
+    double max_err = 0.0;
+
+    /// Back on the sphere whatever the direction
+    for (uint32_t n = 0U; n < 2000U; n++)
+    {
+        double dir[3] = { rand_gauss(), rand_gauss(), rand_gauss() };
+        double norm   = sqrt((dir[0] * dir[0]) + (dir[1] * dir[1]) + (dir[2] * dir[2]));
+        float  meas[3];
+        float  out[3];
+
+        for (uint32_t i = 0U; i < 3U; i++)
+        {
+            dir[i] *= p_radius / norm;
+        }
+        distort(ppt_d, ppt_o, dir, 0.0, meas);
+        su_affine3_apply(ppt_corr, meas, out);
+        for (uint32_t i = 0U; i < 3U; i++)
+        {
+            const double err = fabs(out[i] - dir[i]) / p_radius;
+
+            max_err = (err > max_err) ? err : max_err;
+        }
+    }
+    return max_err;
+}
+
+static su_calib_cfg_t make_cfg(double p_radius)
+{
+    su_calib_cfg_t cfg = {
+        .radius   = (float)p_radius,
+        .forget   = SU_CALIB_DEFAULT_FORGET,
+        .p0       = SU_CALIB_DEFAULT_P0,
+        .conv_var = SU_CALIB_DEFAULT_CONV_VAR,
+        .model    = SU_CALIB_MODEL_ELLIPSOID,
+    };
+
+    return cfg;
+}
+
+void setUp(void)
+{
+    g_seed = 1234U;
+}
+
+void tearDown(void) {}
+
+void test_su_calib_should_converge_on_a_distorted_magnetometer(void)
+{
+    const su_calib_cfg_t cfg      = make_cfg(MAG_FIELD_UT);
+    uint32_t             conv_n   = RUN_CNT;
+    uint32_t             good_n   = RUN_CNT;
+    su_calib_t           cal;
+    su_affine3_t         corr;
+    char                 msg[120];
+
+    TEST_ASSERT_EQUAL(RET_OK, su_calib_init(&cal, &cfg));
+    TEST_ASSERT_EQUAL(RET_BUSY, su_calib_solve(&cal, &corr));
+
+    for (uint32_t n = 0U; n < RUN_CNT; n++)
+    {
+        double dir[3];
+        float  meas[3];
+
+        true_dir(n, 1.2, dir);
+        for (uint32_t i = 0U; i < 3U; i++)
+        {
+            dir[i] *= MAG_FIELD_UT;
+        }
+        distort(g_mag_d, g_mag_o, dir, 0.3, meas);
+        su_calib_update(&cal, meas);
+
+        if ((conv_n == RUN_CNT) && (su_calib_solve(&cal, &corr) == RET_OK))
+        {
+            conv_n = n;
+        }
+        if ((good_n == RUN_CNT) && (conv_n != RUN_CNT) && ((n % RATE_HZ) == 0U))
+        {
+            TEST_ASSERT_EQUAL(RET_OK, su_calib_solve(&cal, &corr));
+            if (corr_err(&corr, g_mag_d, g_mag_o, MAG_FIELD_UT) < 0.01)
+            {
+                good_n = n;
+            }
+        }
+    }
+
+    /// Within 1 % as soon as it is solved, in less than two periods of the tilt
+    TEST_ASSERT_TRUE(conv_n < (RATE_HZ * 40U));
+    TEST_ASSERT_TRUE(good_n <= (conv_n + RATE_HZ));
+    TEST_ASSERT_EQUAL(RET_OK, su_calib_solve(&cal, &corr));
+    TEST_ASSERT_TRUE(corr_err(&corr, g_mag_d, g_mag_o, MAG_FIELD_UT) < 0.005);
+    TEST_ASSERT_EQUAL_UINT32(RUN_CNT, cal.sample_cnt);
+
+    snprintf(msg,
+             sizeof(msg),
+             "magnetometer: solvable after %.1f s, within 1 %% after %.1f s",
+             (double)conv_n / RATE_HZ,
+             (double)good_n / RATE_HZ);
+    TEST_MESSAGE(msg);
+}
+
+void test_su_calib_should_find_the_accelerometer_bias_and_scale(void)
+{
+    const su_calib_cfg_t cfg = make_cfg(GRAVITY);
+    su_calib_t           cal;
+    su_affine3_t         corr;
+
+    TEST_ASSERT_EQUAL(RET_OK, su_calib_init(&cal, &cfg));
+
+    /// The gravity seen from all sides, with the vibrations of the road
+    for (uint32_t n = 0U; n < RUN_CNT; n++)
+    {
+        double dir[3];
+        float  meas[3];
+
+        true_dir(n, 1.5, dir);
+        for (uint32_t i = 0U; i < 3U; i++)
+        {
+            dir[i] *= GRAVITY;
+        }
+        distort(g_acc_d, g_acc_o, dir, 0.05, meas);
+        su_calib_update(&cal, meas);
+    }
+
+    TEST_ASSERT_EQUAL(RET_OK, su_calib_solve(&cal, &corr));
+    TEST_ASSERT_TRUE(corr_err(&corr, g_acc_d, g_acc_o, GRAVITY) < 0.005);
+    TEST_ASSERT_FLOAT_WITHIN(0.02F, -0.2F / 1.02F, corr.row[0][3]);
+    TEST_ASSERT_FLOAT_WITHIN(0.02F, 0.15F / 0.97F, corr.row[1][3]);
+    TEST_ASSERT_FLOAT_WITHIN(0.02F, -0.3F / 1.01F, corr.row[2][3]);
+}
+
+void test_su_calib_without_all_directions_should_not_be_solved(void)
+{
+    const su_calib_cfg_t cfg = make_cfg(GRAVITY);
+    su_calib_t           cal;
+    su_affine3_t         corr;
+
+    /// Driving on a flat road, the gravity stays near the z axis
+    TEST_ASSERT_EQUAL(RET_OK, su_calib_init(&cal, &cfg));
+    for (uint32_t n = 0U; n < RUN_CNT; n++)
+    {
+        const double tilt   = 0.05 * sin((TWO_PI / 8.0) * ((double)n / RATE_HZ));
+        const double dir[3] = { GRAVITY * tilt, 0.0, GRAVITY };
+        float        meas[3];
+
+        distort(g_acc_d, g_acc_o, dir, 0.05, meas);
+        su_calib_update(&cal, meas);
+    }
+    TEST_ASSERT_FALSE(su_calib_is_converged(&cal));
+    TEST_ASSERT_EQUAL(RET_BUSY, su_calib_solve(&cal, &corr));
+    /// The unseen coefficients stay within their prior, no wind up of the forgetting
+    for (uint32_t i = 0U; i < SU_CALIB_PARAM_CNT; i++)
+    {
+        TEST_ASSERT_TRUE(cal.p[i][i] <= (cfg.p0 * 1.001F));
+    }
+
+    /// A sensor far off the expected norm, e.g. a magnetometer near a motor, is not trusted
+    TEST_ASSERT_EQUAL(RET_OK, su_calib_init(&cal, &cfg));
+    for (uint32_t n = 0U; n < RUN_CNT; n++)
+    {
+        double dir[3];
+        float  meas[3];
+
+        true_dir(n, 1.5, dir);
+        for (uint32_t i = 0U; i < 3U; i++)
+        {
+            dir[i] *= 3.0 * GRAVITY;
+        }
+        distort(g_acc_d, g_acc_o, dir, 0.05, meas);
+        su_calib_update(&cal, meas);
+    }
+    TEST_ASSERT_TRUE(su_calib_is_converged(&cal));
+    TEST_ASSERT_EQUAL(RET_ERROR, su_calib_solve(&cal, &corr));
+}
+
+void test_su_calib_planar_model_should_converge_while_driving_level(void)
+{
+    su_calib_cfg_t cfg    = make_cfg(MAG_FIELD_UT);
+    uint32_t       conv_n = RUN_CNT;
+    su_calib_t     cal;
+    su_calib_t     cal_3d;
+    su_affine3_t   corr;
+    double         min_h  = 1.0e9;
+    double         max_h  = 0.0;
+    char           msg[120];
+
+    TEST_ASSERT_EQUAL(RET_OK, su_calib_init(&cal_3d, &cfg));
+    cfg.model  = SU_CALIB_MODEL_PLANAR;
+    cfg.radius = (float)(MAG_FIELD_UT * cos(MAG_INCL));
+    TEST_ASSERT_EQUAL(RET_OK, su_calib_init(&cal, &cfg));
+
+    for (uint32_t n = 0U; n < RUN_CNT; n++)
+    {
+        double field[3];
+        float  meas[3];
+
+        level_field(n, field);
+        distort(g_mag_d, g_mag_o, field, 0.3, meas);
+        su_calib_update(&cal, meas);
+        su_calib_update(&cal_3d, meas);
+        if ((conv_n == RUN_CNT) && (su_calib_solve(&cal, &corr) == RET_OK))
+        {
+            conv_n = n;
+        }
+    }
+
+    /// The vertical is never seen from aside, the ellipsoid cannot be solved
+    TEST_ASSERT_FALSE(su_calib_is_converged(&cal_3d));
+    TEST_ASSERT_TRUE(conv_n < (RATE_HZ * 60U));
+    TEST_ASSERT_EQUAL(RET_OK, su_calib_solve(&cal, &corr));
+
+    /// Level again, the horizontal field is back on a circle around 0, it was off by 25 %
+    for (uint32_t n = 0U; n < 360U; n++)
+    {
+        const double yaw      = (TWO_PI * n) / 360.0;
+        const double field[3] = { MAG_FIELD_UT * cos(MAG_INCL) * cos(yaw),
+                                  -MAG_FIELD_UT * cos(MAG_INCL) * sin(yaw),
+                                  MAG_FIELD_UT * sin(MAG_INCL) };
+        float        meas[3];
+        float        out[3];
+
+        distort(g_mag_d, g_mag_o, field, 0.0, meas);
+        su_affine3_apply(&corr, meas, out);
+
+        const double h = sqrt(((double)out[0] * out[0]) + ((double)out[1] * out[1]));
+
+        min_h = (h < min_h) ? h : min_h;
+        max_h = (h > max_h) ? h : max_h;
+    }
+    TEST_ASSERT_TRUE(((max_h - min_h) / (max_h + min_h)) < 0.01);
+    /// The z axis is left to the base calibration
+    TEST_ASSERT_EQUAL_FLOAT(1.0F, corr.row[2][2]);
+    TEST_ASSERT_EQUAL_FLOAT(0.0F, corr.row[2][3]);
+
+    snprintf(msg,
+             sizeof(msg),
+             "planar: solvable after %.1f s, horizontal field within %.2f %%",
+             (double)conv_n / RATE_HZ,
+             (100.0 * (max_h - min_h)) / (max_h + min_h));
+    TEST_MESSAGE(msg);
+}
+
+void test_su_calib_init_with_invalid_params_should_return_param_error(void)
+{
+    su_calib_cfg_t cfg = make_cfg(GRAVITY);
+    su_calib_t     cal;
+
+    TEST_ASSERT_EQUAL(RET_PARAM_ERROR, su_calib_init(NULL, &cfg));
+    TEST_ASSERT_EQUAL(RET_PARAM_ERROR, su_calib_init(&cal, NULL));
+    cfg.radius = 0.0F;
+    TEST_ASSERT_EQUAL(RET_PARAM_ERROR, su_calib_init(&cal, &cfg));
+    cfg        = make_cfg(GRAVITY);
+    cfg.forget = 1.5F;
+    TEST_ASSERT_EQUAL(RET_PARAM_ERROR, su_calib_init(&cal, &cfg));
+    cfg        = make_cfg(GRAVITY);
+    cfg.p0     = NAN;
+    TEST_ASSERT_EQUAL(RET_PARAM_ERROR, su_calib_init(&cal, &cfg));
+    cfg        = make_cfg(GRAVITY);
+    cfg.model  = (su_calib_model_t)(SU_CALIB_MODEL_PLANAR + 1);
+    TEST_ASSERT_EQUAL(RET_PARAM_ERROR, su_calib_init(&cal, &cfg));
+}
+
+void test_su_calib_bench_host_ns_per_sample(void)
+{
+    static float         samples[BENCH_SAMPLES][3];
+    const su_calib_cfg_t cfg        = make_cfg(MAG_FIELD_UT);
+    uint64_t             best_upd   = UINT64_MAX;
+    uint64_t             best_solve = UINT64_MAX;
+    su_calib_t           cal;
+    su_affine3_t         corr;
+    char                 msg[160];
+
+    for (uint32_t n = 0U; n < BENCH_SAMPLES; n++)
+    {
+        double dir[3];
+
+        true_dir(n, 1.2, dir);
+        for (uint32_t i = 0U; i < 3U; i++)
+        {
+            dir[i] *= MAG_FIELD_UT;
+        }
+        distort(g_mag_d, g_mag_o, dir, 0.3, samples[n]);
+    }
+
+    for (uint32_t run = 0U; run < BENCH_RUNS; run++)
+    {
+        TEST_ASSERT_EQUAL(RET_OK, su_calib_init(&cal, &cfg));
+
+        uint64_t t0 = host_now_ns();
+
+        for (uint32_t n = 0U; n < BENCH_SAMPLES; n++)
+        {
+            su_calib_update(&cal, samples[n]);
+        }
+        t0       = host_now_ns() - t0;
+        best_upd = (t0 < best_upd) ? t0 : best_upd;
+
+        t0 = host_now_ns();
+        for (uint32_t n = 0U; n < 100U; n++)
+        {
+            TEST_ASSERT_EQUAL(RET_OK, su_calib_solve(&cal, &corr));
+        }
+        t0         = host_now_ns() - t0;
+        best_solve = (t0 < best_solve) ? t0 : best_solve;
+    }
+
+    snprintf(msg,
+             sizeof(msg),
+             "calibration on the host: update %.1f ns/sample, solve %.1f ns",
+             host_ns_per_op(best_upd, BENCH_SAMPLES),
+             host_ns_per_op(best_solve, 100U));
+    TEST_MESSAGE(msg);
+}
+
+#endif // TEST
@@ -0,0 +1,385 @@
+#ifdef TEST
+
+#include "bench_clock.h"
+#include "su_fixed.h"
+#include "unity.h"
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define TWO_PI        (6.283185307179586)
+#define Q16           (65536.0)
+#define BENCH_SAMPLES (20000U)
+#define BENCH_RUNS    (5U)
+
+/// Stick pulses of the receiver to a command
+#define STICK_MIN_US  (1000)
+#define STICK_MAX_US  (2000)
+#define CMD_MIN       (-500)
+#define CMD_MAX       (500)
+
+static int32_t g_bench_in[BENCH_SAMPLES];
+
+static uint32_t rand_u32(uint32_t* ppt_seed)
+{
+    uint32_t hi = 0U;
+
+    *ppt_seed = (*ppt_seed * 1103515245U) + 12345U;
+    hi        = *ppt_seed & 0xFFFF0000U;
+    *ppt_seed = (*ppt_seed * 1103515245U) + 12345U;
+    return hi | (*ppt_seed >> 16);
+}
+
+/// Reference of a rounded and saturated fixed-point result
+static int64_t ref_round(long double p_x, int64_t p_min, int64_t p_max)
+{
+    long double r = floorl(p_x + 0.5L);
+
+    if (r > (long double)p_max)
+    {
+        return p_max;
+    }
+    if (r < (long double)p_min)
+    {
+        return p_min;
+    }
+    return (int64_t)r;
+}
+
+/// An integer map with a division on every call
+static int32_t div_map(int32_t p_in)
+{
+    return (((p_in - STICK_MIN_US) * (CMD_MAX - CMD_MIN)) / (STICK_MAX_US - STICK_MIN_US))
+           + CMD_MIN;
+}
+
+static void report(const char* ppt_name, uint64_t p_ref_ns, uint64_t p_fixed_ns)
+{
+    char msg[128];
+
+    snprintf(msg,
+             sizeof(msg),
+             "%s on the host: reference %.1f ns, fixed %.1f ns",
+             ppt_name,
+             host_ns_per_op(p_ref_ns, BENCH_SAMPLES),
+             host_ns_per_op(p_fixed_ns, BENCH_SAMPLES));
+    TEST_MESSAGE(msg);
+}
+
+void setUp(void) {}
+
+void tearDown(void) {}
+
+void test_su_q15_should_round_and_saturate_every_operand(void)
+{
+    /// Every a against a spread of b, both ends included
+    for (int32_t a = INT16_MIN; a <= INT16_MAX; a++)
+    {
+        for (int32_t b = INT16_MIN; b <= INT16_MAX; b += 257)
+        {
+            TEST_ASSERT_EQUAL_INT16(ref_round((long double)a * b / 32768.0L, INT16_MIN, INT16_MAX),
+                                    su_q15_mul((su_q15_t)a, (su_q15_t)b));
+            TEST_ASSERT_EQUAL_INT16(ref_round(a + b, INT16_MIN, INT16_MAX),
+                                    su_q15_add_sat((su_q15_t)a, (su_q15_t)b));
+            TEST_ASSERT_EQUAL_INT16(ref_round(a - b, INT16_MIN, INT16_MAX),
+                                    su_q15_sub_sat((su_q15_t)a, (su_q15_t)b));
+        }
+    }
+    TEST_ASSERT_EQUAL_INT16(SU_Q15_MAX, su_q15_mul(SU_Q15_MIN, SU_Q15_MIN));
+    TEST_ASSERT_EQUAL_INT16(SU_Q15_CONST(0.25), su_q15_mul(SU_Q15_CONST(0.5), SU_Q15_CONST(0.5)));
+}
+
+void test_su_q31_and_q16_should_round_and_saturate(void)
+{
+    uint32_t seed = 31U;
+
+    for (uint32_t n = 0U; n < 2000000U; n++)
+    {
+        /// Small magnitudes too, so the Q16.16 products do not all saturate
+        const int32_t a = (int32_t)rand_u32(&seed) >> (n % 24U);
+        const int32_t b = (int32_t)rand_u32(&seed) >> ((n / 24U) % 24U);
+
+        TEST_ASSERT_EQUAL_INT32(ref_round((long double)a * b / 2147483648.0L, INT32_MIN, INT32_MAX),
+                                su_q31_mul(a, b));
+        TEST_ASSERT_EQUAL_INT32(ref_round((long double)a * b / Q16, INT32_MIN, INT32_MAX),
+                                su_q16_mul(a, b));
+        TEST_ASSERT_EQUAL_INT32(ref_round((long double)a + b, INT32_MIN, INT32_MAX),
+                                su_q31_add_sat(a, b));
+        TEST_ASSERT_EQUAL_INT32(ref_round((long double)a - b, INT32_MIN, INT32_MAX),
+                                su_q16_sub_sat(a, b));
+    }
+    TEST_ASSERT_EQUAL_INT32(SU_Q31_MAX, su_q31_mul(SU_Q31_MIN, SU_Q31_MIN));
+    TEST_ASSERT_EQUAL_INT32(SU_Q16_MAX, su_q16_add_sat(SU_Q16_MAX, 1));
+    TEST_ASSERT_EQUAL_INT32(SU_Q16_MIN, su_q31_sub_sat(SU_Q31_MIN, 1));
+}
+
+void test_su_fixed_float_conversion_should_round_and_saturate(void)
+{
+    TEST_ASSERT_EQUAL_INT16(SU_Q15_MAX, su_q15_from_float(1.0F));
+    TEST_ASSERT_EQUAL_INT16(SU_Q15_MIN, su_q15_from_float(-3.0F));
+    TEST_ASSERT_EQUAL_INT16(-16384, su_q15_from_float(-0.5F));
+    TEST_ASSERT_EQUAL_INT32(SU_Q31_MAX, su_q31_from_float(1.5F));
+    TEST_ASSERT_EQUAL_INT32(1073741824, su_q31_from_float(0.5F));
+    TEST_ASSERT_EQUAL_INT32(SU_Q16_CONST(-2.5), su_q16_from_float(-2.5F));
+    TEST_ASSERT_EQUAL_INT32(SU_Q16_MIN, su_q16_from_float(-40000.0F));
+    TEST_ASSERT_EQUAL_INT32(0, su_q16_from_float(NAN));
+    TEST_ASSERT_EQUAL_FLOAT(-2.5F, su_q16_to_float(SU_Q16_CONST(-2.5)));
+    TEST_ASSERT_EQUAL_FLOAT(0.25F, su_q15_to_float(SU_Q15_CONST(0.25)));
+    TEST_ASSERT_EQUAL_FLOAT(-1.0F, su_q31_to_float(SU_Q31_MIN));
+}
+
+void test_su_q16_recip_should_be_within_one_step(void)
+{
+    uint32_t max_err = 0U;
+
+    /// Every input up to 64, then a spread up to the largest one, both signs
+    for (int64_t x = 1; x <= INT32_MAX; x += ((x < (64 << 16)) ? 1 : 997))
+    {
+        for (int sign = -1; sign <= 1; sign += 2)
+        {
+            const int32_t xi  = (int32_t)(sign * x);
+            const int64_t ref = ref_round(4294967296.0L / xi, INT32_MIN, INT32_MAX);
+            const int64_t err = llabs(ref - su_q16_recip(xi));
+
+            max_err = (err > max_err) ? (uint32_t)err : max_err;
+        }
+    }
+    TEST_ASSERT_TRUE(max_err <= 1U);
+
+    TEST_ASSERT_EQUAL_INT32(SU_Q16_MAX, su_q16_recip(0));
+    TEST_ASSERT_EQUAL_INT32(SU_Q16_MAX, su_q16_recip(1));
+    TEST_ASSERT_EQUAL_INT32(SU_Q16_MIN, su_q16_recip(-2));
+    TEST_ASSERT_EQUAL_INT32(SU_Q16_CONST(0.25), su_q16_recip(SU_Q16_CONST(4.0)));
+    /// A division through the reciprocal, 0.4 is rounded to a step of 2^-16 first
+    TEST_ASSERT_INT32_WITHIN(4,
+                             SU_Q16_CONST(-3.0),
+                             su_q16_mul(SU_Q16_CONST(-7.5), su_q16_recip(SU_Q16_CONST(2.5))));
+}
+
+void test_su_q16_sqrt_should_be_rounded_exactly(void)
+{
+    /// Every input up to 64, then a spread up to the largest one
+    for (int64_t x = 0; x <= INT32_MAX; x += ((x < (64 << 16)) ? 1 : 331))
+    {
+        TEST_ASSERT_EQUAL_INT32(ref_round(sqrtl((long double)x * Q16), 0, INT32_MAX),
+                                su_q16_sqrt((su_q16_t)x));
+    }
+    TEST_ASSERT_EQUAL_INT32(SU_Q16_CONST(1.5), su_q16_sqrt(SU_Q16_CONST(2.25)));
+    TEST_ASSERT_EQUAL_INT32(0, su_q16_sqrt(-SU_Q16_ONE));
+}
+
+void test_su_q16_sin_cos_should_match_every_angle_of_two_turns(void)
+{
+    const int32_t two_turns = (int32_t)(2.0 * TWO_PI * Q16);
+    int64_t       max_err   = 0;
+
+    for (int32_t rad = -two_turns; rad <= two_turns; rad++)
+    {
+        const double  a  = rad / Q16;
+        const int64_t es = llabs(ref_round(sin(a) * Q16, INT32_MIN, INT32_MAX) - su_q16_sin(rad));
+        const int64_t ec = llabs(ref_round(cos(a) * Q16, INT32_MIN, INT32_MAX) - su_q16_cos(rad));
+
+        max_err = (es > max_err) ? es : max_err;
+        max_err = (ec > max_err) ? ec : max_err;
+    }
+    /// 3e-5, the interpolation of the table and the phase rounding
+    TEST_ASSERT_TRUE(max_err <= 2);
+
+    /// Far angles wrap
+    TEST_ASSERT_INT32_WITHIN(2, su_q16_sin(SU_Q16_CONST(1.0)),
+                             su_q16_sin(SU_Q16_CONST(1.0 + (1000.0 * TWO_PI))));
+    TEST_ASSERT_EQUAL_INT32(SU_Q16_ONE, su_q16_cos(0));
+    TEST_ASSERT_EQUAL_INT32(-SU_Q16_ONE, su_q16_sin(-SU_Q16_HALF_PI));
+}
+
+void test_su_q16_atan2_should_match_all_around_the_circle(void)
+{
+    double max_err = 0.0;
+
+    /// Radii from a few steps to near the largest value
+    for (double radius = 3.0; radius < 2.0e9; radius *= 7.3)
+    {
+        for (int32_t i = 0; i < 20000; i++)
+        {
+            const double  a   = -M_PI + ((TWO_PI * i) / 20000.0);
+            const int32_t x   = (int32_t)lround(radius * cos(a));
+            const int32_t y   = (int32_t)lround(radius * sin(a));
+            double        err = 0.0;
+
+            if ((x == 0) && (y == 0))
+            {
+                continue;
+            }
+            err = fabs((su_q16_atan2(y, x) / Q16) - atan2(y, x));
+            err = (err > M_PI) ? (TWO_PI - err) : err;
+            max_err = (err > max_err) ? err : max_err;
+        }
+    }
+    TEST_ASSERT_TRUE(max_err < 1e-4);
+
+    TEST_ASSERT_EQUAL_INT32(0, su_q16_atan2(0, 0));
+    TEST_ASSERT_EQUAL_INT32(0, su_q16_atan2(0, 5));
+    TEST_ASSERT_EQUAL_INT32(SU_Q16_HALF_PI, su_q16_atan2(5, 0));
+    TEST_ASSERT_EQUAL_INT32(SU_Q16_PI, su_q16_atan2(0, -5));
+    TEST_ASSERT_EQUAL_INT32(-SU_Q16_HALF_PI, su_q16_atan2(INT32_MIN, 0));
+}
+
+void test_su_fixed_map_should_round_every_input(void)
+{
+    static const int32_t ranges[][4] = {
+        { STICK_MIN_US, STICK_MAX_US, CMD_MIN, CMD_MAX },
+        { 0, 4095, 1000, -1000 },
+        { 2000, 1000, 0, 100 },
+        { -32768, 32767, 0, 1 },
+        { 0, 100, -2000000000, 2000000000 },
+    };
+    su_fixed_map_t map;
+
+    for (uint32_t r = 0U; r < ARRAY_SIZE(ranges); r++)
+    {
+        const int32_t in_min  = ranges[r][0];
+        const int32_t in_max  = ranges[r][1];
+        const int32_t out_min = ranges[r][2];
+        const int32_t out_max = ranges[r][3];
+        const int32_t lo      = (in_min < in_max) ? in_min : in_max;
+        const int32_t hi      = (in_min < in_max) ? in_max : in_min;
+
+        TEST_ASSERT_EQUAL(RET_OK, su_fixed_map_init(&map, in_min, in_max, out_min, out_max));
+        for (int32_t in = lo; in <= hi; in++)
+        {
+            const long double span  = (long double)out_max - out_min;
+            const long double exact = out_min
+                                      + ((((long double)in - in_min) * span)
+                                         / ((long double)in_max - in_min));
+            /// A half way value may go either way with the rounded slope
+            const int32_t     tol   = ((exact - floorl(exact)) == 0.5L) ? 1 : 0;
+
+            TEST_ASSERT_INT32_WITHIN(tol,
+                                     ref_round(exact, INT32_MIN, INT32_MAX),
+                                     su_fixed_map(&map, in));
+        }
+        /// Clamped out of the range
+        TEST_ASSERT_EQUAL_INT32(su_fixed_map(&map, lo), su_fixed_map(&map, lo - 100));
+        TEST_ASSERT_EQUAL_INT32(su_fixed_map(&map, hi), su_fixed_map(&map, INT32_MAX));
+    }
+
+    TEST_ASSERT_EQUAL(RET_PARAM_ERROR, su_fixed_map_init(&map, 5, 5, 0, 1));
+}
+
+void test_su_fixed_bench_host_ns_per_call(void)
+{
+    uint64_t         best[2][5];
+    uint32_t         seed   = 5U;
+    su_fixed_map_t   map;
+    volatile float   sink_f = 0.0F;
+    volatile int32_t sink_i = 0;
+
+    for (uint32_t n = 0U; n < BENCH_SAMPLES; n++)
+    {
+        g_bench_in[n] = STICK_MIN_US + (int32_t)(rand_u32(&seed) % 1001U);
+    }
+    TEST_ASSERT_EQUAL(RET_OK,
+                      su_fixed_map_init(&map, STICK_MIN_US, STICK_MAX_US, CMD_MIN, CMD_MAX));
+    memset(best, 0xFF, sizeof(best));
+
+    for (uint32_t run = 0U; run < BENCH_RUNS; run++)
+    {
+        uint64_t t[2][5];
+        float    f   = 0.0F;
+        int32_t  acc = 0;
+
+        /// Division against the precomputed slope
+        t[0][0] = host_now_ns();
+        for (uint32_t n = 0U; n < BENCH_SAMPLES; n++)
+        {
+            acc += div_map(g_bench_in[n]);
+        }
+        t[0][0] = host_now_ns() - t[0][0];
+        t[1][0] = host_now_ns();
+        for (uint32_t n = 0U; n < BENCH_SAMPLES; n++)
+        {
+            acc += su_fixed_map(&map, g_bench_in[n]);
+        }
+        t[1][0] = host_now_ns() - t[1][0];
+
+        t[0][1] = host_now_ns();
+        for (uint32_t n = 0U; n < BENCH_SAMPLES; n++)
+        {
+            f += sinf((float)g_bench_in[n] * 0.01F);
+        }
+        t[0][1] = host_now_ns() - t[0][1];
+        t[1][1] = host_now_ns();
+        for (uint32_t n = 0U; n < BENCH_SAMPLES; n++)
+        {
+            acc += su_q16_sin(g_bench_in[n] * 655);
+        }
+        t[1][1] = host_now_ns() - t[1][1];
+
+        t[0][2] = host_now_ns();
+        for (uint32_t n = 0U; n < BENCH_SAMPLES; n++)
+        {
+            f += atan2f((float)(g_bench_in[n] - 1500), (float)g_bench_in[n]);
+        }
+        t[0][2] = host_now_ns() - t[0][2];
+        t[1][2] = host_now_ns();
+        for (uint32_t n = 0U; n < BENCH_SAMPLES; n++)
+        {
+            acc += su_q16_atan2(g_bench_in[n] - 1500, g_bench_in[n]);
+        }
+        t[1][2] = host_now_ns() - t[1][2];
+
+        t[0][3] = host_now_ns();
+        for (uint32_t n = 0U; n < BENCH_SAMPLES; n++)
+        {
+            f += sqrtf((float)g_bench_in[n]);
+        }
+        t[0][3] = host_now_ns() - t[0][3];
+        t[1][3] = host_now_ns();
+        for (uint32_t n = 0U; n < BENCH_SAMPLES; n++)
+        {
+            acc += su_q16_sqrt(g_bench_in[n] << 16);
+        }
+        t[1][3] = host_now_ns() - t[1][3];
+
+        t[0][4] = host_now_ns();
+        for (uint32_t n = 0U; n < BENCH_SAMPLES; n++)
+        {
+            f += 1.0F / (float)g_bench_in[n];
+        }
+        t[0][4] = host_now_ns() - t[0][4];
+        t[1][4] = host_now_ns();
+        for (uint32_t n = 0U; n < BENCH_SAMPLES; n++)
+        {
+            acc += su_q16_recip(g_bench_in[n] << 16);
+        }
+        t[1][4] = host_now_ns() - t[1][4];
+
+        for (uint32_t i = 0U; i < 2U; i++)
+        {
+            for (uint32_t j = 0U; j < 5U; j++)
+            {
+                best[i][j] = (t[i][j] < best[i][j]) ? t[i][j] : best[i][j];
+            }
+        }
+        sink_f += f;
+        sink_i += acc;
+    }
+    (void)sink_f;
+    (void)sink_i;
+
+    report("map against the division", best[0][0], best[1][0]);
+    report("sin against sinf", best[0][1], best[1][1]);
+    report("atan2 against atan2f", best[0][2], best[1][2]);
+    report("sqrt against sqrtf", best[0][3], best[1][3]);
+    report("reciprocal against 1.0F / x", best[0][4], best[1][4]);
+
+    /// The same commands as the division, rounded instead of truncated
+    for (uint32_t n = 0U; n < BENCH_SAMPLES; n++)
+    {
+        TEST_ASSERT_INT32_WITHIN(1, div_map(g_bench_in[n]), su_fixed_map(&map, g_bench_in[n]));
+    }
+}
+
+#endif // TEST
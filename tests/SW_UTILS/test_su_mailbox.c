@@ -0,0 +1,253 @@
+#ifdef TEST
+
+#include "bench_clock.h"
+#include "su_mailbox.h"
+#include "unity.h"
+
+#include <pthread.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+/// A value of many cache lines, so a copy and a write overlap often
+#define STRESS_WORDS     (256U)
+#define STRESS_READERS   (2U)
+#define STRESS_RUN_MS    (300U)
+/// Pause of the writer between two values, as an ISR it leaves time to the readers
+#define STRESS_PERIOD_NS (2000U)
+#define BENCH_OPS        (200000U)
+#define BENCH_RUNS       (5U)
+
+typedef struct
+{
+    uint32_t word[STRESS_WORDS]; // All equal to the write count in a consistent value
+} stress_value_t;
+
+typedef struct
+{
+    uint32_t read_cnt;
+    uint32_t torn_cnt;
+    uint32_t back_cnt; // Values older than one read before
+} stress_reader_t;
+
+typedef struct
+{
+    float    acc[3];
+    uint32_t timestamp_us;
+} sample_t;
+
+static su_mailbox_t   g_mb;
+static stress_value_t g_storage;
+static volatile int   g_stop;
+static volatile int   g_unprotected;
+
+static void* writer_main(void* ppt_arg)
+{
+    uint32_t* pt_cnt = ppt_arg;
+
+    while (__atomic_load_n(&g_stop, __ATOMIC_RELAXED) == 0)
+    {
+        stress_value_t* pt_value = su_mailbox_write_begin(&g_mb);
+        const uint64_t  t0       = host_now_ns();
+
+        (*pt_cnt)++;
+        for (uint32_t i = 0U; i < STRESS_WORDS; i++)
+        {
+            __atomic_store_n(&pt_value->word[i], *pt_cnt, __ATOMIC_RELAXED);
+        }
+        su_mailbox_write_end(&g_mb);
+
+        while ((host_now_ns() - t0) < STRESS_PERIOD_NS)
+        {
+        }
+    }
+    return NULL;
+}
+
+static void* reader_main(void* ppt_arg)
+{
+    stress_reader_t* pt_rd = ppt_arg;
+    stress_value_t   value;
+    uint32_t         last = 0U;
+
+    while (__atomic_load_n(&g_stop, __ATOMIC_RELAXED) == 0)
+    {
+        if (g_unprotected != 0)
+        {
+            memcpy(&value, (const void*)&g_storage, sizeof(value));
+        }
+        else
+        {
+            (void)su_mailbox_read(&g_mb, &value);
+        }
+
+        for (uint32_t i = 1U; i < STRESS_WORDS; i++)
+        {
+            if (value.word[i] != value.word[0])
+            {
+                pt_rd->torn_cnt++;
+                break;
+            }
+        }
+        if (value.word[0] < last)
+        {
+            pt_rd->back_cnt++;
+        }
+        last = value.word[0];
+        pt_rd->read_cnt++;
+    }
+    return NULL;
+}
+
+/// One writer thread against the readers for STRESS_RUN_MS, the sum of the reader counts
+static stress_reader_t run_stress(uint32_t* ppt_write_cnt)
+{
+    pthread_t             writer;
+    pthread_t             readers[STRESS_READERS];
+    stress_reader_t       rd[STRESS_READERS];
+    stress_reader_t       sum   = { 0U };
+    const struct timespec sleep = { 0, STRESS_RUN_MS * 1000000L };
+
+    memset(rd, 0, sizeof(rd));
+    *ppt_write_cnt = 0U;
+    g_stop         = 0;
+    TEST_ASSERT_EQUAL(RET_OK, su_mailbox_init(&g_mb, &g_storage, sizeof(g_storage)));
+
+    TEST_ASSERT_EQUAL(0, pthread_create(&writer, NULL, writer_main, ppt_write_cnt));
+    for (uint32_t i = 0U; i < STRESS_READERS; i++)
+    {
+        TEST_ASSERT_EQUAL(0, pthread_create(&readers[i], NULL, reader_main, &rd[i]));
+    }
+    nanosleep(&sleep, NULL);
+    __atomic_store_n(&g_stop, 1, __ATOMIC_RELAXED);
+
+    TEST_ASSERT_EQUAL(0, pthread_join(writer, NULL));
+    for (uint32_t i = 0U; i < STRESS_READERS; i++)
+    {
+        TEST_ASSERT_EQUAL(0, pthread_join(readers[i], NULL));
+        sum.read_cnt += rd[i].read_cnt;
+        sum.torn_cnt += rd[i].torn_cnt;
+        sum.back_cnt += rd[i].back_cnt;
+    }
+    return sum;
+}
+
+void setUp(void)
+{
+    g_unprotected = 0;
+}
+
+void tearDown(void) {}
+
+void test_su_mailbox_should_give_the_latest_value_and_its_sequence(void)
+{
+    su_mailbox_t mb;
+    sample_t     storage;
+    sample_t     in  = { { 1.0F, -2.0F, 9.81F }, 1234U };
+    sample_t     out = { { 5.0F, 5.0F, 5.0F }, 5U };
+
+    TEST_ASSERT_EQUAL(RET_OK, su_mailbox_init(&mb, &storage, sizeof(storage)));
+
+    /// Cleared before the first write
+    TEST_ASSERT_EQUAL_UINT32(0U, su_mailbox_read(&mb, &out));
+    TEST_ASSERT_EQUAL_FLOAT(0.0F, out.acc[2]);
+    TEST_ASSERT_EQUAL_UINT32(0U, out.timestamp_us);
+
+    su_mailbox_write(&mb, &in);
+    TEST_ASSERT_EQUAL_UINT32(2U, su_mailbox_read(&mb, &out));
+    TEST_ASSERT_EQUAL_MEMORY(&in, &out, sizeof(in));
+
+    /// In place, the writer sees its previous value
+    sample_t* pt_value = su_mailbox_write_begin(&mb);
+
+    TEST_ASSERT_EQUAL_UINT32(3U, su_mailbox_get_seq(&mb));
+    pt_value->timestamp_us += 20000U;
+    su_mailbox_write_end(&mb);
+    TEST_ASSERT_EQUAL_UINT32(4U, su_mailbox_get_seq(&mb));
+    TEST_ASSERT_EQUAL_UINT32(4U, su_mailbox_read(&mb, &out));
+    TEST_ASSERT_EQUAL_UINT32(21234U, out.timestamp_us);
+    TEST_ASSERT_EQUAL_FLOAT(9.81F, out.acc[2]);
+}
+
+void test_su_mailbox_init_with_invalid_params_should_return_param_error(void)
+{
+    su_mailbox_t mb;
+    sample_t     storage;
+
+    TEST_ASSERT_EQUAL(RET_PARAM_ERROR, su_mailbox_init(NULL, &storage, sizeof(storage)));
+    TEST_ASSERT_EQUAL(RET_PARAM_ERROR, su_mailbox_init(&mb, NULL, sizeof(storage)));
+    TEST_ASSERT_EQUAL(RET_PARAM_ERROR, su_mailbox_init(&mb, &storage, 0U));
+}
+
+void test_su_mailbox_threads_should_never_read_a_torn_value(void)
+{
+    uint32_t        write_cnt = 0U;
+    stress_reader_t unprot    = { 0U };
+    char            msg[160];
+
+    const stress_reader_t prot = run_stress(&write_cnt);
+
+    TEST_ASSERT_TRUE(write_cnt > 1000U);
+    TEST_ASSERT_TRUE(prot.read_cnt > 1000U);
+    TEST_ASSERT_EQUAL_UINT32(0U, prot.torn_cnt);
+    TEST_ASSERT_EQUAL_UINT32(0U, prot.back_cnt);
+
+    /// The same without the sequence, for the comparison
+    g_unprotected = 1;
+    unprot        = run_stress(&write_cnt);
+
+    snprintf(msg,
+             sizeof(msg),
+             "mailbox: %u reads, 0 torn; unprotected copy: %u torn of %u reads",
+             (unsigned)prot.read_cnt,
+             (unsigned)unprot.torn_cnt,
+             (unsigned)unprot.read_cnt);
+    /// Printed only, how often a plain copy is torn depends on the cores and the scheduler
+    TEST_MESSAGE(msg);
+}
+
+void test_su_mailbox_bench_host_ns_per_call(void)
+{
+    su_mailbox_t mb;
+    sample_t     storage;
+    sample_t     value   = { { 0.0F, 0.0F, 0.0F }, 0U };
+    uint64_t     best_wr = UINT64_MAX;
+    uint64_t     best_rd = UINT64_MAX;
+    uint32_t     seq_sum = 0U;
+    char         msg[160];
+
+    TEST_ASSERT_EQUAL(RET_OK, su_mailbox_init(&mb, &storage, sizeof(storage)));
+
+    for (uint32_t run = 0U; run < BENCH_RUNS; run++)
+    {
+        uint64_t t0 = host_now_ns();
+
+        for (uint32_t n = 0U; n < BENCH_OPS; n++)
+        {
+            value.timestamp_us = n;
+            su_mailbox_write(&mb, &value);
+        }
+        t0      = host_now_ns() - t0;
+        best_wr = (t0 < best_wr) ? t0 : best_wr;
+
+        t0 = host_now_ns();
+        for (uint32_t n = 0U; n < BENCH_OPS; n++)
+        {
+            seq_sum += su_mailbox_read(&mb, &value);
+        }
+        t0      = host_now_ns() - t0;
+        best_rd = (t0 < best_rd) ? t0 : best_rd;
+    }
+    TEST_ASSERT_EQUAL_UINT32(BENCH_OPS - 1U, value.timestamp_us);
+    TEST_ASSERT_TRUE((seq_sum & 1U) == 0U);
+
+    snprintf(msg,
+             sizeof(msg),
+             "mailbox of %u bytes on the host: write %.1f ns, read %.1f ns",
+             (unsigned)sizeof(sample_t),
+             host_ns_per_op(best_wr, BENCH_OPS),
+             host_ns_per_op(best_rd, BENCH_OPS));
+    TEST_MESSAGE(msg);
+}
+
+#endif // TEST
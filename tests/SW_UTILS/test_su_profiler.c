@@ -0,0 +1,111 @@
+#ifdef TEST
+
+#include "su_profiler.h"
+#include "unity.h"
+
+/// Simulated cycle counter, starts close to the wrap around
+static uint32_t g_sim_cycles;
+
+static uint32_t sim_clock(void)
+{
+    return g_sim_cycles;
+}
+
+static void sim_probe(su_prof_probe_t p_probe, uint32_t p_cycles)
+{
+    su_prof_enter(p_probe);
+    g_sim_cycles += p_cycles;
+    su_prof_exit(p_probe);
+}
+
+void setUp(void)
+{
+    g_sim_cycles = 0xFFFFFF00U;
+    su_prof_init(sim_clock);
+}
+
+void tearDown(void) {}
+
+void test_su_prof_probe_should_record_min_avg_max(void)
+{
+    su_prof_stats_t stats = { 0U };
+
+    sim_probe(SU_PROF_ISR_TIM2, 150U);
+    sim_probe(SU_PROF_ISR_TIM2, 90U);
+    sim_probe(SU_PROF_ISR_TIM2, 1200U);
+
+    TEST_ASSERT_EQUAL(RET_OK, su_prof_get_stats(SU_PROF_ISR_TIM2, &stats));
+    TEST_ASSERT_EQUAL(3U, stats.cnt);
+    TEST_ASSERT_EQUAL(90U, stats.min_cycles);
+    TEST_ASSERT_EQUAL(1200U, stats.max_cycles);
+    TEST_ASSERT_EQUAL(1440U, stats.total_cycles);
+
+    /// Other probes are not affected
+    TEST_ASSERT_EQUAL(RET_OK, su_prof_get_stats(SU_PROF_IIC_XFER, &stats));
+    TEST_ASSERT_EQUAL(0U, stats.cnt);
+    TEST_ASSERT_EQUAL(0U, stats.min_cycles);
+}
+
+void test_su_prof_histogram_should_use_power_of_two_bins(void)
+{
+    su_prof_stats_t stats = { 0U };
+
+    sim_probe(SU_PROF_IIC_XFER, 10U);         // below the first bin
+    sim_probe(SU_PROF_IIC_XFER, 64U);         // bin 0
+    sim_probe(SU_PROF_IIC_XFER, 200U);        // bin 1
+    sim_probe(SU_PROF_IIC_XFER, 255U);        // bin 1
+    sim_probe(SU_PROF_IIC_XFER, 256U);        // bin 2
+    sim_probe(SU_PROF_IIC_XFER, 100000000U);  // beyond the last bin
+
+    TEST_ASSERT_EQUAL(RET_OK, su_prof_get_stats(SU_PROF_IIC_XFER, &stats));
+    TEST_ASSERT_EQUAL(2U, stats.hist[0]);
+    TEST_ASSERT_EQUAL(2U, stats.hist[1]);
+    TEST_ASSERT_EQUAL(1U, stats.hist[2]);
+    TEST_ASSERT_EQUAL(1U, stats.hist[SU_PROF_HIST_BINS - 1U]);
+}
+
+void test_su_prof_percentile_should_bound_the_runs(void)
+{
+    su_prof_stats_t stats = { 0U };
+
+    for (uint32_t i = 0U; i < 99U; i++)
+    {
+        sim_probe(SU_PROF_ISR_DMA2_S7, 100U);
+    }
+    sim_probe(SU_PROF_ISR_DMA2_S7, 3000U);
+
+    TEST_ASSERT_EQUAL(RET_OK, su_prof_get_stats(SU_PROF_ISR_DMA2_S7, &stats));
+    TEST_ASSERT_EQUAL(128U, su_prof_percentile(&stats, 50U));
+    TEST_ASSERT_EQUAL(128U, su_prof_percentile(&stats, 99U));
+    TEST_ASSERT_EQUAL(3000U, su_prof_percentile(&stats, 100U));
+}
+
+void test_su_prof_reset_should_clear_the_statistics(void)
+{
+    su_prof_stats_t stats = { 0U };
+
+    sim_probe(SU_PROF_IDLE, 500U);
+    su_prof_reset();
+    sim_probe(SU_PROF_IDLE, 700U);
+
+    TEST_ASSERT_EQUAL(RET_OK, su_prof_get_stats(SU_PROF_IDLE, &stats));
+    TEST_ASSERT_EQUAL(1U, stats.cnt);
+    TEST_ASSERT_EQUAL(700U, stats.min_cycles);
+    TEST_ASSERT_EQUAL(700U, stats.total_cycles);
+}
+
+void test_su_prof_without_clock_should_ignore_probes(void)
+{
+    su_prof_stats_t stats = { 0U };
+
+    su_prof_init(NULL);
+    sim_probe(SU_PROF_ISR_EXTI0, 500U);
+
+    TEST_ASSERT_EQUAL(RET_OK, su_prof_get_stats(SU_PROF_ISR_EXTI0, &stats));
+    TEST_ASSERT_EQUAL(0U, stats.cnt);
+    TEST_ASSERT_EQUAL(0U, su_prof_now());
+    TEST_ASSERT_EQUAL(RET_PARAM_ERROR, su_prof_get_stats(SU_PROF_PROBE_CNT, &stats));
+    TEST_ASSERT_EQUAL_STRING("EXTI0_IRQ", su_prof_get_name(SU_PROF_ISR_EXTI0));
+}
+
+#endif // TEST
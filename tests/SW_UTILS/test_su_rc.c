@@ -0,0 +1,150 @@
+#ifdef TEST
+
+#include "bench_clock.h"
+#include "su_fixed.h"
+#include "su_rc.h"
+#include "unity.h"
+
+#include <math.h>
+#include <stdio.h>
+
+#define BENCH_SAMPLES (20000U)
+#define BENCH_RUNS    (5U)
+
+/// An uneven channel, the neutral is off the middle of the travel
+static const su_rc_cfg_t g_cfg = {
+    .min_us      = 988U,
+    .center_us   = 1496U,
+    .max_us      = 2012U,
+    .deadband_us = 8U,
+    .expo        = 0.4F,
+};
+
+/// The calibration in double, [-1, 1]
+static double ref_normalize(const su_rc_cfg_t* ppt_cfg, double p_pulse_us)
+{
+    const double db_lo = (double)ppt_cfg->center_us - ppt_cfg->deadband_us;
+    const double db_hi = (double)ppt_cfg->center_us + ppt_cfg->deadband_us;
+    double       x     = 0.0;
+
+    if (p_pulse_us < db_lo)
+    {
+        x = -fmin(1.0, (db_lo - p_pulse_us) / (db_lo - ppt_cfg->min_us));
+    }
+    else if (p_pulse_us > db_hi)
+    {
+        x = fmin(1.0, (p_pulse_us - db_hi) / (ppt_cfg->max_us - db_hi));
+    }
+    return ((1.0 - ppt_cfg->expo) * x) + (ppt_cfg->expo * x * x * x);
+}
+
+void setUp(void) {}
+
+void tearDown(void) {}
+
+void test_su_rc_normalize_should_follow_the_calibration_for_every_pulse(void)
+{
+    static const float expos[] = { 0.0F, 0.4F, 1.0F };
+    su_rc_t            rc;
+    su_rc_cfg_t        cfg     = g_cfg;
+    double             max_err = 0.0;
+
+    for (uint32_t e = 0U; e < ARRAY_SIZE(expos); e++)
+    {
+        su_q15_t prev = SU_Q15_MIN;
+
+        cfg.expo = expos[e];
+        TEST_ASSERT_EQUAL(RET_OK, su_rc_init(&rc, &cfg));
+
+        for (uint32_t us = 0U; us <= 3000U; us++)
+        {
+            const su_q15_t y   = su_rc_normalize(&rc, us);
+            const double   err = fabs((y / (double)SU_Q15_MAX) - ref_normalize(&cfg, us));
+
+            max_err = (err > max_err) ? err : max_err;
+            TEST_ASSERT_TRUE(y >= prev);
+            prev = y;
+        }
+
+        /// Exact at the ends and over the neutral zone, the same travel on both sides
+        TEST_ASSERT_EQUAL_INT16(-SU_Q15_MAX, su_rc_normalize(&rc, cfg.min_us));
+        TEST_ASSERT_EQUAL_INT16(SU_Q15_MAX, su_rc_normalize(&rc, cfg.max_us));
+        TEST_ASSERT_EQUAL_INT16(-SU_Q15_MAX, su_rc_normalize(&rc, 0U));
+        TEST_ASSERT_EQUAL_INT16(SU_Q15_MAX, su_rc_normalize(&rc, UINT32_MAX));
+        for (uint32_t us = cfg.center_us - cfg.deadband_us; us <= (cfg.center_us + cfg.deadband_us);
+             us++)
+        {
+            TEST_ASSERT_EQUAL_INT16(0, su_rc_normalize(&rc, us));
+        }
+    }
+    TEST_ASSERT_TRUE(max_err < 1.0e-3);
+}
+
+void test_su_rc_init_without_travel_should_return_param_error(void)
+{
+    su_rc_t     rc;
+    su_rc_cfg_t cfg = g_cfg;
+
+    cfg.deadband_us = (uint16_t)(cfg.center_us - cfg.min_us);
+    TEST_ASSERT_EQUAL(RET_PARAM_ERROR, su_rc_init(&rc, &cfg));
+
+    cfg           = g_cfg;
+    cfg.center_us = cfg.max_us;
+    TEST_ASSERT_EQUAL(RET_PARAM_ERROR, su_rc_init(&rc, &cfg));
+
+    cfg      = g_cfg;
+    cfg.expo = 1.5F;
+    TEST_ASSERT_EQUAL(RET_PARAM_ERROR, su_rc_init(&rc, &cfg));
+    cfg.expo = NAN;
+    TEST_ASSERT_EQUAL(RET_PARAM_ERROR, su_rc_init(&rc, &cfg));
+
+    TEST_ASSERT_EQUAL(RET_PARAM_ERROR, su_rc_init(NULL, &g_cfg));
+    TEST_ASSERT_EQUAL(RET_PARAM_ERROR, su_rc_init(&rc, NULL));
+}
+
+void test_su_rc_bench_host_ns_per_call(void)
+{
+    static uint32_t pulse_us[BENCH_SAMPLES];
+    uint64_t        best_float = UINT64_MAX;
+    uint64_t        best_rc    = UINT64_MAX;
+    volatile double sink       = 0.0;
+    int32_t         sum        = 0;
+    su_rc_t         rc;
+    char            msg[160];
+
+    for (uint32_t n = 0U; n < BENCH_SAMPLES; n++)
+    {
+        pulse_us[n] = 950U + ((n * 7919U) % 1100U);
+    }
+    TEST_ASSERT_EQUAL(RET_OK, su_rc_init(&rc, &g_cfg));
+
+    for (uint32_t run = 0U; run < BENCH_RUNS; run++)
+    {
+        uint64_t t0 = host_now_ns();
+
+        for (uint32_t n = 0U; n < BENCH_SAMPLES; n++)
+        {
+            sink += ref_normalize(&g_cfg, pulse_us[n]);
+        }
+        t0         = host_now_ns() - t0;
+        best_float = (t0 < best_float) ? t0 : best_float;
+
+        t0 = host_now_ns();
+        for (uint32_t n = 0U; n < BENCH_SAMPLES; n++)
+        {
+            sum += su_rc_normalize(&rc, pulse_us[n]);
+        }
+        t0      = host_now_ns() - t0;
+        best_rc = (t0 < best_rc) ? t0 : best_rc;
+    }
+    TEST_ASSERT_TRUE(sum != INT32_MIN);
+
+    snprintf(msg,
+             sizeof(msg),
+             "normalize on the host: double with divisions %.1f ns, compiled %.1f ns",
+             host_ns_per_op(best_float, BENCH_SAMPLES),
+             host_ns_per_op(best_rc, BENCH_SAMPLES));
+    TEST_MESSAGE(msg);
+}
+
+#endif // TEST
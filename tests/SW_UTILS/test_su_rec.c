@@ -0,0 +1,142 @@
+#ifdef TEST
+
+#include "su_rec.h"
+#include "unity.h"
+
+#include <string.h>
+
+static uint8_t  g_rec[1024];
+static size_t   g_rec_len;
+static uint32_t g_prev_us;
+
+static void put(const su_rec_event_t* ppt_event)
+{
+    size_t len = su_rec_encode(ppt_event, g_prev_us, &g_rec[g_rec_len], sizeof(g_rec) - g_rec_len);
+
+    TEST_ASSERT_NOT_EQUAL(0U, len);
+    g_rec_len += len;
+    g_prev_us  = ppt_event->t_us;
+}
+
+void setUp(void)
+{
+    g_rec_len = su_rec_write_header(g_rec, sizeof(g_rec));
+    g_prev_us = 0U;
+}
+
+void tearDown(void) {}
+
+void test_su_rec_round_trip_should_keep_every_field(void)
+{
+    const uint8_t   fifo[6] = { 1U, 2U, 3U, 4U, 5U, 6U };
+    su_rec_event_t  iic     = { .type = SU_REC_IIC_READ, .t_us = 1000U };
+    su_rec_event_t  cap     = { .type = SU_REC_CAPTURE, .t_us = 21000U };
+    su_rec_event_t  plain   = { .type = SU_REC_IIC_READ, .t_us = 21001U };
+    su_rec_event_t  out;
+    su_rec_reader_t reader;
+
+    iic.iic.port        = 0U;
+    iic.iic.dev_addr    = 0x68U;
+    iic.iic.mem_size    = 1U;
+    iic.iic.mem_addr    = 0x72U;
+    iic.iic.len         = sizeof(fifo);
+    iic.iic.pt_data     = fifo;
+    cap.capture.channel = 1U;
+    cap.capture.value   = 1500U;
+    plain.iic.dev_addr  = 0x77U;
+    plain.iic.len       = 1U;
+    plain.iic.pt_data   = fifo;
+    put(&iic);
+    put(&cap);
+    put(&plain);
+
+    TEST_ASSERT_EQUAL(RET_OK, su_rec_reader_init(&reader, g_rec, g_rec_len));
+
+    TEST_ASSERT_EQUAL(RET_OK, su_rec_read(&reader, &out));
+    TEST_ASSERT_EQUAL(SU_REC_IIC_READ, out.type);
+    TEST_ASSERT_EQUAL(1000U, out.t_us);
+    TEST_ASSERT_EQUAL(0x68U, out.iic.dev_addr);
+    TEST_ASSERT_EQUAL(1U, out.iic.mem_size);
+    TEST_ASSERT_EQUAL(0x72U, out.iic.mem_addr);
+    TEST_ASSERT_EQUAL(sizeof(fifo), out.iic.len);
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(fifo, out.iic.pt_data, sizeof(fifo));
+
+    TEST_ASSERT_EQUAL(RET_OK, su_rec_read(&reader, &out));
+    TEST_ASSERT_EQUAL(SU_REC_CAPTURE, out.type);
+    TEST_ASSERT_EQUAL(21000U, out.t_us);
+    TEST_ASSERT_EQUAL(1U, out.capture.channel);
+    TEST_ASSERT_EQUAL(1500U, out.capture.value);
+
+    TEST_ASSERT_EQUAL(RET_OK, su_rec_read(&reader, &out));
+    TEST_ASSERT_EQUAL(21001U, out.t_us);
+    TEST_ASSERT_EQUAL(0U, out.iic.mem_size);
+
+    TEST_ASSERT_EQUAL(RET_NOT_FOUND, su_rec_read(&reader, &out));
+}
+
+void test_su_rec_capture_every_frame_should_take_7_bytes(void)
+{
+    su_rec_event_t cap = { .type = SU_REC_CAPTURE, .t_us = 20000U };
+
+    cap.capture.value = 2000U;
+    put(&cap);
+
+    /// Type, 3 bytes of time step, channel and 2 bytes of pulse width
+    TEST_ASSERT_EQUAL(SU_REC_HDR_LEN + 7U, g_rec_len);
+}
+
+void test_su_rec_time_step_should_survive_the_counter_wrap(void)
+{
+    su_rec_event_t  cap = { .type = SU_REC_CAPTURE };
+    su_rec_event_t  out;
+    su_rec_reader_t reader;
+
+    g_prev_us = 0xFFFFFF00U;
+    cap.t_us  = 0x00000100U;
+    put(&cap);
+
+    TEST_ASSERT_EQUAL(RET_OK, su_rec_reader_init(&reader, g_rec, g_rec_len));
+    reader.t_us = 0xFFFFFF00U;
+    TEST_ASSERT_EQUAL(RET_OK, su_rec_read(&reader, &out));
+    TEST_ASSERT_EQUAL_HEX32(0x00000100U, out.t_us);
+}
+
+void test_su_rec_cut_off_record_should_be_an_error(void)
+{
+    const uint8_t   data[4] = { 0U };
+    su_rec_event_t  iic     = { .type = SU_REC_IIC_READ, .t_us = 10U };
+    su_rec_event_t  out;
+    su_rec_reader_t reader;
+
+    iic.iic.mem_size = 1U;
+    iic.iic.len      = sizeof(data);
+    iic.iic.pt_data  = data;
+    put(&iic);
+
+    TEST_ASSERT_EQUAL(RET_OK, su_rec_reader_init(&reader, g_rec, g_rec_len - 1U));
+    TEST_ASSERT_EQUAL(RET_ERROR, su_rec_read(&reader, &out));
+    TEST_ASSERT_EQUAL(SU_REC_HDR_LEN, reader.pos);
+}
+
+void test_su_rec_unknown_header_should_not_be_read(void)
+{
+    su_rec_reader_t reader;
+
+    g_rec[SU_REC_HDR_LEN - 1U] = SU_REC_VERSION + 1U;
+    TEST_ASSERT_EQUAL(RET_NOT_SUPPORTED, su_rec_reader_init(&reader, g_rec, g_rec_len));
+    TEST_ASSERT_EQUAL(RET_NOT_SUPPORTED, su_rec_reader_init(&reader, g_rec, 2U));
+}
+
+void test_su_rec_record_larger_than_the_output_should_not_be_written(void)
+{
+    const uint8_t  data[8] = { 0U };
+    uint8_t        out[8];
+    su_rec_event_t iic     = { .type = SU_REC_IIC_READ };
+
+    iic.iic.len     = sizeof(data);
+    iic.iic.pt_data = data;
+
+    TEST_ASSERT_EQUAL(0U, su_rec_encode(&iic, 0U, out, sizeof(out)));
+}
+
+#endif // TEST
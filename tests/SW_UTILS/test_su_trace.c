@@ -0,0 +1,152 @@
+#ifdef TEST
+
+#include "su_trace.h"
+#include "unity.h"
+
+static uint32_t g_sim_cycles;
+
+static uint32_t sim_clock(void)
+{
+    return g_sim_cycles;
+}
+
+/// Records one event per simulated microsecond at 80 MHz
+static void record_events(uint32_t p_cnt)
+{
+    for (uint32_t i = 0U; i < p_cnt; i++)
+    {
+        g_sim_cycles += 80U;
+        su_trace_record(SU_TRACE_TIMER_FIRE, (uint16_t)i);
+    }
+}
+
+void setUp(void)
+{
+    g_sim_cycles = 0xFFFFFF00U;
+    su_trace_resume(); // a frozen trace would survive the init
+    su_trace_init(sim_clock);
+}
+
+void tearDown(void) {}
+
+void test_su_trace_read_should_return_the_records_in_order(void)
+{
+    su_trace_rec_t recs[8] = { 0 };
+
+    g_sim_cycles = 1000U;
+    su_trace_record(SU_TRACE_IIC_START, 0x76U);
+    g_sim_cycles = 1500U;
+    su_trace_record(SU_TRACE_IIC_END, RET_OK);
+    g_sim_cycles = 1600U;
+    su_trace_record(SU_TRACE_TASK_END, 2U);
+
+    TEST_ASSERT_EQUAL(3U, su_trace_read(recs, 8U));
+    TEST_ASSERT_EQUAL(1000U, recs[0].cycles);
+    TEST_ASSERT_EQUAL(SU_TRACE_IIC_START, recs[0].type);
+    TEST_ASSERT_EQUAL(0x76U, recs[0].arg);
+    TEST_ASSERT_EQUAL(1500U, recs[1].cycles);
+    TEST_ASSERT_EQUAL(SU_TRACE_IIC_END, recs[1].type);
+    TEST_ASSERT_EQUAL(SU_TRACE_TASK_END, recs[2].type);
+    TEST_ASSERT_EQUAL(2U, recs[2].arg);
+
+    /// Read records are not returned again
+    TEST_ASSERT_EQUAL(0U, su_trace_read(recs, 8U));
+}
+
+void test_su_trace_read_should_continue_where_it_stopped(void)
+{
+    su_trace_rec_t recs[4] = { 0 };
+
+    record_events(10U);
+
+    TEST_ASSERT_EQUAL(4U, su_trace_read(recs, 4U));
+    TEST_ASSERT_EQUAL(3U, recs[3].arg);
+    TEST_ASSERT_EQUAL(4U, su_trace_read(recs, 4U));
+    TEST_ASSERT_EQUAL(7U, recs[3].arg);
+    TEST_ASSERT_EQUAL(2U, su_trace_read(recs, 4U));
+    TEST_ASSERT_EQUAL(9U, recs[1].arg);
+    TEST_ASSERT_EQUAL(0U, su_trace_read(recs, 4U));
+}
+
+void test_su_trace_overwritten_records_should_be_reported_as_lost(void)
+{
+    static su_trace_rec_t recs[SU_TRACE_BUF_SZ + 1U];
+
+    record_events(SU_TRACE_BUF_SZ + 10U);
+
+    TEST_ASSERT_EQUAL(SU_TRACE_BUF_SZ + 1U, su_trace_read(recs, SU_TRACE_BUF_SZ + 1U));
+    TEST_ASSERT_EQUAL(SU_TRACE_LOST, recs[0].type);
+    TEST_ASSERT_EQUAL(10U, recs[0].arg);
+    TEST_ASSERT_EQUAL(recs[1].cycles, recs[0].cycles);
+    TEST_ASSERT_EQUAL(10U, recs[1].arg);
+    TEST_ASSERT_EQUAL(SU_TRACE_BUF_SZ + 9U, recs[SU_TRACE_BUF_SZ].arg);
+}
+
+void test_su_trace_lost_report_should_wait_for_room_of_the_next_record(void)
+{
+    su_trace_rec_t recs[2] = { 0 };
+
+    record_events(SU_TRACE_BUF_SZ + 1U);
+
+    TEST_ASSERT_EQUAL(0U, su_trace_read(recs, 1U));
+    TEST_ASSERT_EQUAL(2U, su_trace_read(recs, 2U));
+    TEST_ASSERT_EQUAL(SU_TRACE_LOST, recs[0].type);
+    TEST_ASSERT_EQUAL(1U, recs[0].arg);
+    TEST_ASSERT_EQUAL(1U, recs[1].arg);
+}
+
+void test_su_trace_freeze_should_keep_the_records(void)
+{
+    su_trace_rec_t recs[8] = { 0 };
+
+    record_events(3U);
+    su_trace_freeze();
+    record_events(3U);
+
+    TEST_ASSERT_TRUE(su_trace_is_frozen());
+    TEST_ASSERT_EQUAL(3U, su_trace_read(recs, 8U));
+
+    /// Resuming drops what was not read and records again
+    su_trace_resume();
+    TEST_ASSERT_FALSE(su_trace_is_frozen());
+    record_events(2U);
+    TEST_ASSERT_EQUAL(2U, su_trace_read(recs, 8U));
+}
+
+void test_su_trace_frozen_trace_should_survive_the_init(void)
+{
+    su_trace_rec_t recs[8] = { 0 };
+
+    record_events(2U);
+    su_trace_record(SU_TRACE_FAULT, 0U);
+    su_trace_freeze();
+
+    /// Warm reset
+    su_trace_init(sim_clock);
+
+    TEST_ASSERT_EQUAL(3U, su_trace_read(recs, 8U));
+    TEST_ASSERT_EQUAL(SU_TRACE_FAULT, recs[2].type);
+}
+
+void test_su_trace_init_should_clear_a_running_trace(void)
+{
+    su_trace_rec_t recs[8] = { 0 };
+
+    record_events(2U);
+    su_trace_init(sim_clock);
+
+    TEST_ASSERT_EQUAL(0U, su_trace_read(recs, 8U));
+}
+
+void test_su_trace_without_clock_should_ignore_records(void)
+{
+    su_trace_rec_t recs[8] = { 0 };
+
+    su_trace_init(NULL);
+    record_events(2U);
+
+    TEST_ASSERT_EQUAL(0U, su_trace_read(recs, 8U));
+    TEST_ASSERT_EQUAL(0U, su_trace_read(NULL, 8U));
+}
+
+#endif // TEST
@@ -0,0 +1,22 @@
+#ifndef BENCH_CLOCK_H
+#define BENCH_CLOCK_H
+
+#include <stdint.h>
+#include <time.h>
+
+/// Host wall clock of the benchmarks. The numbers only rank implementations on the host, the
+/// cycles on the M4 are measured on the target with ps_profiler.
+static inline uint64_t host_now_ns(void)
+{
+    struct timespec now;
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return ((uint64_t)now.tv_sec * 1000000000ULL) + (uint64_t)now.tv_nsec;
+}
+
+static inline double host_ns_per_op(uint64_t p_ns, uint32_t p_ops)
+{
+    return (double)p_ns / (double)p_ops;
+}
+
+#endif // BENCH_CLOCK_H
@@ -0,0 +1,28 @@
+#ifndef IBUS_FRAME_H
+#define IBUS_FRAME_H
+
+#include "dd_fsi6_ibus.h"
+
+#include <stdint.h>
+
+/// Builds an iBUS frame of the channel pulses in us, as the receiver sends it
+static inline void ibus_build_frame(uint8_t* ppt_frame, const uint16_t* ppt_ch_us)
+{
+    uint16_t crc = 0xFFFFU;
+
+    ppt_frame[0] = 0x20U;
+    ppt_frame[1] = 0x40U;
+    for (uint32_t i = 0U; i < FSI6_IBUS_CH_CNT; i++)
+    {
+        ppt_frame[2U + (2U * i)] = (uint8_t)ppt_ch_us[i];
+        ppt_frame[3U + (2U * i)] = (uint8_t)(ppt_ch_us[i] >> 8);
+    }
+    for (uint32_t i = 0U; i < (FSI6_IBUS_FRAME_LEN - 2U); i++)
+    {
+        crc -= ppt_frame[i];
+    }
+    ppt_frame[FSI6_IBUS_FRAME_LEN - 2U] = (uint8_t)crc;
+    ppt_frame[FSI6_IBUS_FRAME_LEN - 1U] = (uint8_t)(crc >> 8);
+}
+
+#endif // IBUS_FRAME_H
@@ -0,0 +1,120 @@
+"""Convert sensor recording dumps of the debug UART into binary recordings.
+
+The firmware (ps_recorder) sends a dump as text lines between the log messages:
+
+    #RS                     start of a dump
+    #R <hex>                up to 32 bytes of the recording
+    #RE                     end of the dump
+
+The bytes are the su_rec stream: the "SREC" header and version, then one record
+per I2C read or input capture. The binary file is the input of mp_replay_load()
+of the host port. Every complete dump is written, numbered from the output name
+when there are several.
+
+Usage: python3 rec2bin.py uart_capture.log -o drive.rec [--summary]
+"""
+
+import argparse
+import os
+import re
+import sys
+
+# Keep in sync with su_rec.h
+MAGIC = b"SREC"
+VERSION = 1
+IIC_READ, CAPTURE = 1, 2
+
+LINE_RE = re.compile(r"#R(S|E)?(?:\s+([0-9a-fA-F]+))?\s*$")
+
+
+def parse_dumps(lines):
+    """Yields the bytes of every complete dump."""
+    data = None
+    for line in lines:
+        match = LINE_RE.search(line.rstrip("\r\n"))
+        if not match:
+            continue
+        kind, payload = match.groups()
+        if kind == "S":
+            data = bytearray()
+        elif kind == "E":
+            if data is not None:
+                yield bytes(data)
+            data = None
+        elif data is not None and payload and len(payload) % 2 == 0:
+            data.extend(bytes.fromhex(payload))
+
+
+def read_varint(data, pos):
+    value = 0
+    shift = 0
+    while True:
+        byte = data[pos]
+        pos += 1
+        value |= (byte & 0x7F) << shift
+        shift += 7
+        if not byte & 0x80:
+            return value, pos
+
+
+def summarize(data):
+    """Returns (duration in us, I2C reads per device, captures per channel)."""
+    if data[:4] != MAGIC or len(data) < 5 or data[4] != VERSION:
+        raise ValueError("not a recording of version %d" % VERSION)
+    pos = 5
+    t_us = 0
+    reads = {}
+    captures = {}
+    while pos < len(data):
+        rec_type = data[pos]
+        delta, pos = read_varint(data, pos + 1)
+        t_us += delta
+        if rec_type == IIC_READ:
+            port_mem, dev_addr = data[pos], data[pos + 1]
+            pos += 2
+            if port_mem & 0x03:
+                _mem_addr, pos = read_varint(data, pos)
+            length, pos = read_varint(data, pos)
+            pos += length
+            key = (port_mem >> 2, dev_addr)
+            reads[key] = reads.get(key, 0) + 1
+        elif rec_type == CAPTURE:
+            channel = data[pos]
+            _value, pos = read_varint(data, pos + 1)
+            captures[channel] = captures.get(channel, 0) + 1
+        else:
+            raise ValueError(f"unknown record type {rec_type} at byte {pos}")
+    if pos != len(data):
+        raise ValueError("recording ends within a record")
+    return t_us, reads, captures
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("capture", nargs="?", type=argparse.FileType("r", errors="replace"),
+                        default=sys.stdin, help="UART capture, stdin if omitted")
+    parser.add_argument("-o", "--output", default="recording.rec")
+    parser.add_argument("--summary", action="store_true",
+                        help="print the duration and the inputs of every dump")
+    args = parser.parse_args()
+
+    dumps = list(parse_dumps(args.capture))
+    base, ext = os.path.splitext(args.output)
+    for index, data in enumerate(dumps, start=1):
+        path = args.output if len(dumps) == 1 else f"{base}_{index}{ext}"
+        with open(path, "wb") as output:
+            output.write(data)
+        if args.summary:
+            t_us, reads, captures = summarize(data)
+            print(f"{path}: {len(data)} bytes, {t_us / 1e6:.3f} s", file=sys.stderr)
+            for (port, dev_addr), count in sorted(reads.items()):
+                print(f"  i2c{port + 1} 0x{dev_addr:02x}: {count} reads", file=sys.stderr)
+            for channel, count in sorted(captures.items()):
+                print(f"  capture {channel + 1}: {count} values", file=sys.stderr)
+
+    print(f"{len(dumps)} dumps converted", file=sys.stderr)
+    return 0 if dumps else 1
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,157 @@
+"""Convert trace dumps of the debug UART into Chrome trace_event JSON.
+
+The firmware sends a dump as text lines between the log messages:
+
+    #TS <cycles per us>     start of a dump
+    #T <hex>                up to 4 records, 8 bytes each, little endian
+    #TE                     end of the dump
+
+A record is the memory image of su_trace_rec_t: uint32 cycles, uint16 arg,
+uint8 type, uint8 lap. Every dump becomes a process of its own, open the
+output in chrome://tracing or https://ui.perfetto.dev.
+
+Usage: python3 trace2chrome.py uart_capture.log -o trace.json
+       [--task-names imu,baro,telemetry,monitor,trace]
+"""
+
+import argparse
+import json
+import re
+import struct
+import sys
+
+# Keep in sync with su_trace_evt_t
+LOST, FAULT, ISR_ENTER, ISR_EXIT, TIMER_FIRE, DMA_START, DMA_DONE, IIC_START, IIC_END, \
+    TASK_START, TASK_END = range(11)
+
+# IRQ numbers of the STM32F411 that carry trace points
+IRQ_NAMES = {6: "EXTI0", 28: "TIM2", 70: "DMA2_Stream7"}
+
+TID_IRQ, TID_TASKS, TID_IIC, TID_DMA, TID_TIMERS = range(1, 6)
+TRACK_NAMES = {TID_IRQ: "interrupts", TID_TASKS: "tasks", TID_IIC: "i2c",
+               TID_DMA: "uart dma", TID_TIMERS: "app timers"}
+
+LINE_RE = re.compile(r"#T(S|E)?(?:\s+([0-9a-fA-F]+))?\s*$")
+RECORD = struct.Struct("<IHBB")
+
+
+def parse_dumps(lines):
+    """Yields (cycles per us, [(cycles, arg, type)]) for every complete dump."""
+    cycles_per_us = None
+    records = []
+    for line in lines:
+        match = LINE_RE.search(line.rstrip("\r\n"))
+        if not match:
+            continue
+        kind, payload = match.groups()
+        if kind == "S":
+            cycles_per_us = int(payload or "80")
+            records = []
+        elif kind == "E":
+            if cycles_per_us is not None:
+                yield cycles_per_us, records
+            cycles_per_us = None
+        elif cycles_per_us is not None and payload and len(payload) % 16 == 0:
+            data = bytes.fromhex(payload)
+            for offset in range(0, len(data), RECORD.size):
+                cycles, arg, rec_type, _lap = RECORD.unpack_from(data, offset)
+                records.append((cycles, arg, rec_type))
+
+
+def convert_dump(pid, cycles_per_us, records, task_names):
+    events = [
+        {"ph": "M", "pid": pid, "name": "process_name", "args": {"name": f"dump {pid}"}},
+    ]
+    for tid, name in TRACK_NAMES.items():
+        events.append({"ph": "M", "pid": pid, "tid": tid, "name": "thread_name",
+                       "args": {"name": name}})
+
+    open_slices = {tid: [] for tid in TRACK_NAMES}
+    dma_start_us = None
+    dma_bytes = 0
+    last_cycles = None
+    elapsed = 0
+
+    def begin(tid, name, ts, args=None):
+        open_slices[tid].append(name)
+        event = {"ph": "B", "pid": pid, "tid": tid, "name": name, "ts": ts}
+        if args:
+            event["args"] = args
+        events.append(event)
+
+    def end(tid, name, ts, args=None):
+        # Slices opened before the dump started have no begin
+        if name not in open_slices[tid]:
+            return
+        while open_slices[tid].pop() != name:
+            pass
+        event = {"ph": "E", "pid": pid, "tid": tid, "ts": ts}
+        if args:
+            event["args"] = args
+        events.append(event)
+
+    def instant(tid, name, ts, scope="t"):
+        events.append({"ph": "i", "pid": pid, "tid": tid, "name": name, "ts": ts, "s": scope})
+
+    for cycles, arg, rec_type in records:
+        # The 32 bit counter wraps, records of preempted writers may be slightly out of order
+        if last_cycles is not None:
+            delta = (cycles - last_cycles) & 0xFFFFFFFF
+            elapsed += delta - (1 << 32) if delta >= (1 << 31) else delta
+        last_cycles = cycles
+        ts = elapsed / cycles_per_us
+
+        if rec_type == ISR_ENTER:
+            begin(TID_IRQ, IRQ_NAMES.get(arg, f"IRQ {arg}"), ts)
+        elif rec_type == ISR_EXIT:
+            end(TID_IRQ, IRQ_NAMES.get(arg, f"IRQ {arg}"), ts)
+        elif rec_type == TASK_START:
+            begin(TID_TASKS, task_names[arg] if arg < len(task_names) else f"task {arg}", ts)
+        elif rec_type == TASK_END:
+            end(TID_TASKS, task_names[arg] if arg < len(task_names) else f"task {arg}", ts)
+        elif rec_type == IIC_START:
+            begin(TID_IIC, f"i2c 0x{arg:02x}", ts)
+        elif rec_type == IIC_END:
+            name = open_slices[TID_IIC][-1] if open_slices[TID_IIC] else ""
+            end(TID_IIC, name, ts, {"status": arg})
+        elif rec_type == DMA_START:
+            dma_start_us = ts
+            dma_bytes = arg
+        elif rec_type == DMA_DONE:
+            if dma_start_us is not None:
+                events.append({"ph": "X", "pid": pid, "tid": TID_DMA, "name": "tx",
+                               "ts": dma_start_us, "dur": ts - dma_start_us,
+                               "args": {"bytes": dma_bytes}})
+            dma_start_us = None
+        elif rec_type == TIMER_FIRE:
+            instant(TID_TIMERS, f"timer {arg}", ts)
+        elif rec_type == FAULT:
+            instant(TID_IRQ, "fault", ts, "g")
+        elif rec_type == LOST:
+            instant(TID_IRQ, f"lost {arg} records", ts, "p")
+
+    return events
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("capture", nargs="?", type=argparse.FileType("r", errors="replace"),
+                        default=sys.stdin, help="UART capture, stdin if omitted")
+    parser.add_argument("-o", "--output", type=argparse.FileType("w"), default=sys.stdout)
+    parser.add_argument("--task-names", default="",
+                        help="comma separated task names in creation order")
+    args = parser.parse_args()
+
+    task_names = [name for name in args.task_names.split(",") if name]
+    events = []
+    dump_cnt = 0
+    for dump_cnt, (cycles_per_us, records) in enumerate(parse_dumps(args.capture), start=1):
+        events.extend(convert_dump(dump_cnt, cycles_per_us, records, task_names))
+
+    json.dump({"traceEvents": events, "displayTimeUnit": "ns"}, args.output)
+    print(f"{dump_cnt} dumps converted", file=sys.stderr)
+    return 0 if dump_cnt else 1
+
+
+if __name__ == "__main__":
+    sys.exit(main())